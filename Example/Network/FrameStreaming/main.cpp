@@ -0,0 +1,206 @@
+/*****************************************************************************/
+/**
+ *  @file   main.cpp
+ *  @brief  Loopback benchmark of the frame streaming server and client.
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#include <iostream>
+#include <cstdlib>
+#include <kvs/CommandLine>
+#include <kvs/FrameStreamServer>
+#include <kvs/FrameStreamClient>
+#include <kvs/IPAddress>
+#include <kvs/Thread>
+#include <kvs/Timer>
+#include <kvs/ValueArray>
+#include <kvs/Math>
+#include <kvs/Message>
+
+
+namespace { const size_t MaxNumberOfFrames = 64; }
+
+/*===========================================================================*/
+/**
+ *  @brief  Argument class.
+ */
+/*===========================================================================*/
+class Argument : public kvs::CommandLine
+{
+public:
+
+    Argument( int argc, char** argv ):
+        kvs::CommandLine( argc, argv )
+    {
+        addHelpOption();
+        addOption( "port", "Port number. (default: 5100)", 1, false );
+        addOption( "width", "Frame width. (default: 1920)", 1, false );
+        addOption( "height", "Frame height. (default: 1080)", 1, false );
+        addOption( "frames", "Number of frames. (default: 120)", 1, false );
+        addOption( "tile", "Tile size. (default: 64)", 1, false );
+        addOption( "quantization", "Number of dropped bits for the lossy compression. (default: 0)", 1, false );
+        addOption( "full", "Change the whole frame instead of a moving box.", 0, false );
+    }
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Renders the frame.
+ *  @param  index [in] frame index
+ *  @param  width [in] frame width
+ *  @param  height [in] frame height
+ *  @param  full [in] if true, the whole frame is changed
+ *  @param  pixels [out] RGB pixels
+ */
+/*===========================================================================*/
+void Render( const size_t index, const size_t width, const size_t height, const bool full, kvs::ValueArray<kvs::UInt8>* pixels )
+{
+    pixels->allocate( width * height * 3 );
+
+    // Gradation background, which is scrolled in the full mode.
+    const size_t shift = full ? index : 0;
+    kvs::UInt8* pixel = pixels->data();
+    for ( size_t y = 0; y < height; y++ )
+    {
+        for ( size_t x = 0; x < width; x++, pixel += 3 )
+        {
+            pixel[0] = static_cast<kvs::UInt8>( ( x + shift ) * 255 / width );
+            pixel[1] = static_cast<kvs::UInt8>( y * 255 / height );
+            pixel[2] = 128;
+        }
+    }
+
+    // Checkered box moving from the left to the right.
+    const size_t size = height / 4;
+    const size_t x0 = ( index * 16 ) % ( width - size );
+    const size_t y0 = ( height - size ) / 2;
+    for ( size_t y = y0; y < y0 + size; y++ )
+    {
+        for ( size_t x = x0; x < x0 + size; x++ )
+        {
+            kvs::UInt8* p = pixels->data() + ( y * width + x ) * 3;
+            const bool black = ( ( x - x0 ) / 16 + ( y - y0 ) / 16 ) % 2 == 0;
+            p[0] = p[1] = p[2] = black ? 0 : 255;
+        }
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Client thread that receives and checks the frames.
+ */
+/*===========================================================================*/
+class Client : public kvs::Thread
+{
+private:
+
+    const Argument& m_argument; ///< argument
+    size_t m_nframes; ///< number of the received frames
+    kvs::UInt64 m_total_size; ///< total size of the received frames
+    int m_error; ///< max. error of the pixel values
+    double m_sec; ///< receiving time
+
+public:
+
+    Client( const Argument& argument ): m_argument( argument ), m_nframes( 0 ), m_total_size( 0 ), m_error( 0 ), m_sec( 0.0 ) {}
+
+    size_t numberOfFrames() const { return m_nframes; }
+    kvs::UInt64 totalSize() const { return m_total_size; }
+    int error() const { return m_error; }
+    double sec() const { return m_sec; }
+
+    void run()
+    {
+        const int port = m_argument.hasOption("port") ? m_argument.optionValue<int>("port") : 5100;
+        const size_t nframes = m_argument.hasOption("frames") ? m_argument.optionValue<size_t>("frames") : 120;
+        const bool full = m_argument.hasOption("full");
+
+        kvs::FrameStreamClient client;
+        if ( !client.connect( kvs::IPAddress( "127.0.0.1" ), port ) ) return;
+
+        kvs::Timer timer( kvs::Timer::Start );
+        kvs::ValueArray<kvs::UInt8> expected;
+        for ( size_t i = 0; i < nframes; i++ )
+        {
+            if ( !client.receive() ) break;
+            m_nframes++;
+            m_total_size += client.lastFrameSize();
+
+            // The frames are received from the first frame after the connection,
+            // and some of them are checked.
+            if ( i % 10 != 0 && i != nframes - 1 ) continue;
+            Render( i % ::MaxNumberOfFrames, client.width(), client.height(), full, &expected );
+            for ( size_t j = 0; j < expected.size(); j++ )
+            {
+                m_error = kvs::Math::Max( m_error, std::abs( int( expected[j] ) - int( client.frame()[j] ) ) );
+            }
+        }
+        timer.stop();
+        m_sec = timer.sec();
+    }
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Main function.
+ *  @param  argc [in] argument count
+ *  @param  argv [in] argument values
+ */
+/*===========================================================================*/
+int main( int argc, char** argv )
+{
+    Argument argument( argc, argv );
+    if ( !argument.parse() ) exit( EXIT_FAILURE );
+
+    const int port = argument.hasOption("port") ? argument.optionValue<int>("port") : 5100;
+    const size_t width = argument.hasOption("width") ? argument.optionValue<size_t>("width") : 1920;
+    const size_t height = argument.hasOption("height") ? argument.optionValue<size_t>("height") : 1080;
+    const size_t nframes = argument.hasOption("frames") ? argument.optionValue<size_t>("frames") : 120;
+    const bool full = argument.hasOption("full");
+
+    kvs::FrameStreamServer server;
+    if ( argument.hasOption("tile") ) server.setTileSize( argument.optionValue<size_t>("tile") );
+    if ( argument.hasOption("quantization") ) server.setQuantization( argument.optionValue<size_t>("quantization") );
+    if ( !server.open( port ) ) exit( EXIT_FAILURE );
+
+    Client client( argument );
+    client.start();
+    while ( server.numberOfClients() == 0 ) kvs::Thread::MilliSleep( 1 );
+
+    // The frames are rendered in advance to measure the streaming only, and
+    // repeated.
+    std::vector< kvs::ValueArray<kvs::UInt8> > frames( kvs::Math::Min( nframes, ::MaxNumberOfFrames ) );
+    for ( size_t i = 0; i < frames.size(); i++ ) Render( i, width, height, full, &frames[i] );
+
+    double encoding_sec = 0.0;
+    kvs::Timer timer( kvs::Timer::Start );
+    for ( size_t i = 0; i < nframes; i++ )
+    {
+        const kvs::ValueArray<kvs::UInt8>& pixels = frames[ i % ::MaxNumberOfFrames ];
+        kvs::Timer encoding_timer( kvs::Timer::Start );
+        server.send( pixels.data(), width, height, 3 );
+        encoding_timer.stop();
+        encoding_sec += encoding_timer.sec();
+    }
+    server.flush();
+    timer.stop();
+    client.wait();
+
+    const double raw_size = double( width ) * height * 3 * client.numberOfFrames();
+    std::cout << "Frame size        : " << width << " x " << height << std::endl;
+    std::cout << "Frames            : " << client.numberOfFrames() << " / " << nframes << std::endl;
+    std::cout << "Encoding (send)   : " << encoding_sec * 1000.0 / nframes << " msec/frame" << std::endl;
+    std::cout << "Streaming         : " << nframes / timer.sec() << " fps (server), "
+              << client.numberOfFrames() / client.sec() << " fps (client)" << std::endl;
+    std::cout << "Compression ratio : " << raw_size / double( client.totalSize() ) << std::endl;
+    std::cout << "Max. error        : " << client.error() << std::endl;
+
+    return 0;
+}
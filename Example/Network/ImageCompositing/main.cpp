@@ -0,0 +1,234 @@
+/*****************************************************************************/
+/**
+ *  @file   main.cpp
+ *  @brief  Example program for the sort-last image compositing over TCP.
+ *
+ *  Each process renders a translucent disk of its own into an RGBA+depth
+ *  image, and the images of all the processes are composited by
+ *  kvs::TCPImageCompositor. The rank 0 compares the result with the images
+ *  composited sequentially, and writes it to the file. The processes can
+ *  be run on the local host as follows:
+ *
+ *    for r in 0 1 2 3 4; do ./ImageCompositing -rank $r -nranks 5 & done
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <kvs/CommandLine>
+#include <kvs/TCPImageCompositor>
+#include <kvs/ValueArray>
+#include <kvs/ColorImage>
+#include <kvs/Timer>
+#include <kvs/Math>
+#include <kvs/Message>
+
+
+/*===========================================================================*/
+/**
+ *  @brief  Argument class.
+ */
+/*===========================================================================*/
+class Argument : public kvs::CommandLine
+{
+public:
+
+    Argument( int argc, char** argv ):
+        kvs::CommandLine( argc, argv )
+    {
+        addHelpOption();
+        addOption( "rank", "Rank of this process.", 1, true );
+        addOption( "nranks", "Number of processes.", 1, true );
+        addOption( "port", "Base port number. (default: 6000)", 1, false );
+        addOption( "size", "Image size. (default: 1024)", 1, false );
+        addOption( "frames", "Number of frames. (default: 10)", 1, false );
+        addOption( "depth", "Composite by the depth test instead of the alpha blending.", 0, false );
+        addOption( "output", "Output image file of the rank 0. (default: composited.bmp)", 1, false );
+    }
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Renders the image of the rank.
+ *  @param  rank [in] rank
+ *  @param  nranks [in] number of ranks
+ *  @param  size [in] image size
+ *  @param  color_data [out] RGBA color data with the premultiplied alpha
+ *  @param  depth_data [out] depth data
+ *
+ *  The disks of the ranks are placed from the left to the right, and the
+ *  right one is nearer to the viewer.
+ */
+/*===========================================================================*/
+void Render(
+    const size_t rank,
+    const size_t nranks,
+    const size_t size,
+    kvs::ValueArray<kvs::UInt8>* color_data,
+    kvs::ValueArray<kvs::Real32>* depth_data )
+{
+    color_data->allocate( size * size * 4 );
+    depth_data->allocate( size * size );
+
+    const float cx = size * ( rank + 1.0f ) / ( nranks + 1.0f );
+    const float cy = size * 0.5f;
+    const float radius = size * 0.3f;
+    const float alpha = 0.6f;
+    const kvs::UInt8 color[3] = {
+        static_cast<kvs::UInt8>( 255 * ( rank % 3 == 0 ) ),
+        static_cast<kvs::UInt8>( 255 * ( rank % 3 == 1 ) ),
+        static_cast<kvs::UInt8>( 255 * ( rank % 3 == 2 ) ) };
+
+    kvs::UInt8* pixel = color_data->data();
+    kvs::Real32* depth = depth_data->data();
+    for ( size_t y = 0; y < size; y++ )
+    {
+        for ( size_t x = 0; x < size; x++, pixel += 4, depth++ )
+        {
+            const float dx = x - cx;
+            const float dy = y - cy;
+            if ( dx * dx + dy * dy < radius * radius )
+            {
+                pixel[0] = static_cast<kvs::UInt8>( kvs::Math::Round( color[0] * alpha ) );
+                pixel[1] = static_cast<kvs::UInt8>( kvs::Math::Round( color[1] * alpha ) );
+                pixel[2] = static_cast<kvs::UInt8>( kvs::Math::Round( color[2] * alpha ) );
+                pixel[3] = static_cast<kvs::UInt8>( kvs::Math::Round( alpha * 255.0f ) );
+                *depth = ( nranks - rank ) / ( nranks + 1.0f );
+            }
+            else
+            {
+                pixel[0] = pixel[1] = pixel[2] = pixel[3] = 0;
+                *depth = 1.0f;
+            }
+        }
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Composites the images of all the ranks sequentially.
+ *  @param  nranks [in] number of ranks
+ *  @param  size [in] image size
+ *  @param  depth_test [in] if true, the images are composited by the depth test
+ *  @param  color_data [out] composited color data
+ */
+/*===========================================================================*/
+void CompositeSequentially(
+    const size_t nranks,
+    const size_t size,
+    const bool depth_test,
+    kvs::ValueArray<kvs::UInt8>* color_data )
+{
+    kvs::ValueArray<kvs::Real32> depth_data;
+    Render( nranks - 1, nranks, size, color_data, &depth_data );
+
+    // The rank (nranks - 1) is the nearest, and the ranks are composited from
+    // the front to the back.
+    for ( size_t r = 1; r < nranks; r++ )
+    {
+        const size_t rank = nranks - 1 - r;
+        kvs::ValueArray<kvs::UInt8> color;
+        kvs::ValueArray<kvs::Real32> depth;
+        Render( rank, nranks, size, &color, &depth );
+
+        kvs::UInt8* dst = color_data->data();
+        for ( size_t i = 0; i < depth.size(); i++, dst += 4 )
+        {
+            const kvs::UInt8* src = color.data() + i * 4;
+            if ( depth_test )
+            {
+                if ( depth[i] < depth_data[i] ) { std::copy( src, src + 4, dst ); depth_data[i] = depth[i]; }
+            }
+            else
+            {
+                const unsigned int weight = 255 - dst[3];
+                for ( size_t c = 0; c < 4; c++ )
+                {
+                    const unsigned int value = dst[c] + ( src[c] * weight + 127 ) / 255;
+                    dst[c] = static_cast<kvs::UInt8>( kvs::Math::Min( value, 255u ) );
+                }
+            }
+        }
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Main function.
+ *  @param  argc [in] argument count
+ *  @param  argv [in] argument values
+ */
+/*===========================================================================*/
+int main( int argc, char** argv )
+{
+    Argument argument( argc, argv );
+    if ( !argument.parse() ) exit( EXIT_FAILURE );
+
+    const size_t rank = argument.optionValue<size_t>("rank");
+    const size_t nranks = argument.optionValue<size_t>("nranks");
+    const int port = argument.hasOption("port") ? argument.optionValue<int>("port") : 6000;
+    const size_t size = argument.hasOption("size") ? argument.optionValue<size_t>("size") : 1024;
+    const size_t nframes = argument.hasOption("frames") ? argument.optionValue<size_t>("frames") : 10;
+    const bool depth_test = argument.hasOption("depth");
+    const std::string output = argument.hasOption("output") ? argument.optionValue<std::string>("output") : "composited.bmp";
+
+    kvs::TCPImageCompositor compositor( rank, nranks, port );
+    compositor.setCompositingMode( depth_test ? kvs::TCPImageCompositor::DepthTest : kvs::TCPImageCompositor::AlphaBlending );
+    if ( !compositor.connect() ) exit( EXIT_FAILURE );
+
+    // The images are composited in place, and rendered for each frame.
+    kvs::ValueArray<kvs::UInt8> color_data;
+    kvs::ValueArray<kvs::Real32> depth_data;
+    double msec = 0.0;
+    for ( size_t frame = 0; frame < nframes; frame++ )
+    {
+        Render( rank, nranks, size, &color_data, &depth_data );
+
+        // The visibility is the distance from the viewer to the disk.
+        const float visibility = static_cast<float>( nranks - rank );
+        kvs::Timer timer( kvs::Timer::Start );
+        if ( !compositor.composite( color_data, depth_data, visibility ) ) exit( EXIT_FAILURE );
+        timer.stop();
+        msec += timer.msec();
+    }
+
+    if ( rank == 0 )
+    {
+        kvs::ValueArray<kvs::UInt8> expected;
+        CompositeSequentially( nranks, size, depth_test, &expected );
+
+        int error = 0;
+        for ( size_t i = 0; i < expected.size(); i++ )
+        {
+            error = kvs::Math::Max( error, std::abs( int( expected[i] ) - int( color_data[i] ) ) );
+        }
+
+        std::cout << "Ranks            : " << nranks << std::endl;
+        std::cout << "Image size       : " << size << " x " << size << std::endl;
+        std::cout << "Compositing time : " << msec / nframes << " msec/frame" << std::endl;
+        std::cout << "Max. error       : " << error << " (compared with the sequential compositing)" << std::endl;
+
+        kvs::ValueArray<kvs::UInt8> pixels( size * size * 3 );
+        for ( size_t y = 0; y < size; y++ )
+        {
+            for ( size_t x = 0; x < size; x++ )
+            {
+                // The origin of the image is the upper-left corner.
+                const size_t src = ( ( size - 1 - y ) * size + x ) * 4;
+                const size_t dst = ( y * size + x ) * 3;
+                std::copy( color_data.data() + src, color_data.data() + src + 3, pixels.data() + dst );
+            }
+        }
+        kvs::ColorImage( size, size, pixels ).write( output );
+    }
+
+    return 0;
+}
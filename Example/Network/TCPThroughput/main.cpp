@@ -0,0 +1,277 @@
+/*****************************************************************************/
+/**
+ *  @file   main.cpp
+ *  @brief  Loopback throughput benchmark of the TCP socket.
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#include <iostream>
+#include <vector>
+#include <kvs/CommandLine>
+#include <kvs/TCPServer>
+#include <kvs/TCPSocket>
+#include <kvs/SocketReactor>
+#include <kvs/MessageBlock>
+#include <kvs/IPAddress>
+#include <kvs/Thread>
+#include <kvs/Timer>
+#include <kvs/ValueArray>
+#include <kvs/Message>
+
+
+/*===========================================================================*/
+/**
+ *  @brief  Argument class.
+ */
+/*===========================================================================*/
+class Argument : public kvs::CommandLine
+{
+public:
+
+    Argument( int argc, char** argv ):
+        kvs::CommandLine( argc, argv )
+    {
+        addHelpOption();
+        addOption( "port", "Port number. (default: 5000)", 1, false );
+        addOption( "size", "Message size in MB. (default: 256)", 1, false );
+        addOption( "count", "Number of messages. (default: 8)", 1, false );
+        addOption( "clients", "Number of clients. (default: 1)", 1, false );
+    }
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Receiver of the messages from a non-blocking client.
+ *
+ *  The message block is received incrementally whenever the client is
+ *  readable, so that a server thread can serve many clients.
+ */
+/*===========================================================================*/
+class Receiver : public kvs::SocketReactor::Handler
+{
+private:
+
+    kvs::SocketReactor* m_reactor; ///< reactor
+    kvs::TCPSocket* m_client; ///< client
+    kvs::MessageBlock m_message; ///< message block
+    size_t m_nmessages; ///< number of the received messages
+    kvs::UInt64 m_total_size; ///< total size of the received messages
+    bool m_closed; ///< flag for the closed connection
+
+public:
+
+    Receiver( kvs::SocketReactor* reactor, kvs::TCPSocket* client ):
+        m_reactor( reactor ),
+        m_client( client ),
+        m_nmessages( 0 ),
+        m_total_size( 0 ),
+        m_closed( false ) {}
+
+    ~Receiver() { delete m_client; }
+
+    size_t numberOfMessages() const { return m_nmessages; }
+    kvs::UInt64 totalSize() const { return m_total_size; }
+    bool isClosed() const { return m_closed; }
+
+    void handleEvent( const kvs::Socket::id_type id, const int events )
+    {
+        for ( ; ; )
+        {
+            // The rest of the message is received on the next event (0).
+            const kvs::Int64 received = m_client->receive( &m_message );
+            if ( received <= 0 )
+            {
+                if ( received < 0 ) this->close( id );
+                return;
+            }
+
+            m_nmessages++;
+            m_total_size += m_message.size();
+        }
+    }
+
+private:
+
+    void close( const kvs::Socket::id_type id )
+    {
+        m_reactor->remove( id );
+        m_closed = true;
+    }
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Server thread that accepts the clients and receives their messages.
+ */
+/*===========================================================================*/
+class Server : public kvs::Thread, public kvs::TCPServer::ConnectionHandler
+{
+private:
+
+    kvs::TCPServer m_server; ///< server
+    size_t m_nclients; ///< number of the clients
+    std::vector<Receiver*> m_receivers; ///< receivers of the clients
+
+public:
+
+    Server( const int port, const size_t nclients ):
+        m_nclients( nclients )
+    {
+        m_server.open();
+        m_server.setMaxConnections( static_cast<int>( nclients ) );
+        if ( m_server.bind( port ) < 0 || !m_server.listen() )
+        {
+            kvsMessageError( "Cannot listen to the port (%d). [%s]", port, m_server.errorString().c_str() );
+        }
+        m_server.setConnectionHandler( this );
+    }
+
+    ~Server()
+    {
+        for ( size_t i = 0; i < m_receivers.size(); i++ ) delete m_receivers[i];
+    }
+
+    void connected( kvs::TCPServer* server, kvs::TCPSocket* client )
+    {
+        Receiver* receiver = new Receiver( server->reactor(), client );
+        server->reactor()->add( client->id(), receiver, kvs::SocketReactor::Readable );
+        m_receivers.push_back( receiver );
+    }
+
+    void run()
+    {
+        const kvs::SocketTimer timeout( 10.0 );
+        for ( ; ; )
+        {
+            size_t nclosed = 0;
+            for ( size_t i = 0; i < m_receivers.size(); i++ ) { if ( m_receivers[i]->isClosed() ) nclosed++; }
+            if ( nclosed == m_nclients ) break;
+            if ( m_server.dispatch( &timeout ) <= 0 ) break;
+        }
+    }
+
+    kvs::UInt64 totalSize() const
+    {
+        kvs::UInt64 total_size = 0;
+        for ( size_t i = 0; i < m_receivers.size(); i++ ) total_size += m_receivers[i]->totalSize();
+        return total_size;
+    }
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Client thread that sends the messages.
+ */
+/*===========================================================================*/
+class Client : public kvs::Thread
+{
+private:
+
+    int m_port; ///< port number
+    const kvs::ValueArray<kvs::UInt8>* m_message; ///< message
+    size_t m_count; ///< number of messages
+    bool m_gather; ///< flag for the gather write (otherwise, the message block is used)
+
+public:
+
+    Client(): m_port( 0 ), m_message( NULL ), m_count( 0 ), m_gather( true ) {}
+
+    void init( const int port, const kvs::ValueArray<kvs::UInt8>* message, const size_t count, const bool gather )
+    {
+        m_port = port;
+        m_message = message;
+        m_count = count;
+        m_gather = gather;
+    }
+
+    void run()
+    {
+        kvs::TCPSocket client;
+        client.open();
+        if ( !client.connect( kvs::IPAddress( "127.0.0.1" ), m_port ) )
+        {
+            kvsMessageError( "Cannot connect to the server. [%s]", client.errorString().c_str() );
+            return;
+        }
+
+        for ( size_t i = 0; i < m_count; i++ )
+        {
+            if ( m_gather )
+            {
+                // The header and the message are sent without the copy.
+                client.sendMessage( m_message->data(), m_message->byteSize() );
+            }
+            else
+            {
+                // The message is copied into the message block with the header.
+                const kvs::MessageBlock block( m_message->data(), m_message->byteSize() );
+                client.send( block );
+            }
+        }
+    }
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Measures the throughput.
+ *  @param  argument [in] argument
+ *  @param  message [in] message
+ *  @param  gather [in] if true, the messages are sent with the gather write
+ *  @param  port [in] port number
+ */
+/*===========================================================================*/
+void Measure( const Argument& argument, const kvs::ValueArray<kvs::UInt8>& message, const bool gather, const int port )
+{
+    const size_t count = argument.hasOption("count") ? argument.optionValue<size_t>("count") : 8;
+    const size_t nclients = argument.hasOption("clients") ? argument.optionValue<size_t>("clients") : 1;
+
+    Server server( port, nclients );
+    server.start();
+
+    std::vector<Client> clients( nclients );
+    kvs::Timer timer( kvs::Timer::Start );
+    for ( size_t i = 0; i < nclients; i++ )
+    {
+        clients[i].init( port, &message, count, gather );
+        clients[i].start();
+    }
+    for ( size_t i = 0; i < nclients; i++ ) clients[i].wait();
+    server.wait();
+    timer.stop();
+
+    const double mbytes = static_cast<double>( server.totalSize() ) / ( 1024.0 * 1024.0 );
+    std::cout << ( gather ? "Gather write  " : "Message block " )
+              << ": " << mbytes << " MB in " << timer.sec() << " sec ("
+              << mbytes / timer.sec() << " MB/s)" << std::endl;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Main function.
+ *  @param  argc [in] argument count
+ *  @param  argv [in] argument values
+ */
+/*===========================================================================*/
+int main( int argc, char** argv )
+{
+    Argument argument( argc, argv );
+    if ( !argument.parse() ) exit( EXIT_FAILURE );
+
+    const int port = argument.hasOption("port") ? argument.optionValue<int>("port") : 5000;
+    const size_t size = argument.hasOption("size") ? argument.optionValue<size_t>("size") : 256;
+
+    kvs::ValueArray<kvs::UInt8> message( size * 1024 * 1024 );
+    for ( size_t i = 0; i < message.size(); i++ ) message[i] = static_cast<kvs::UInt8>( i );
+
+    Measure( argument, message, true, port );
+    Measure( argument, message, false, port + 1 );
+
+    return 0;
+}
@@ -46,7 +46,9 @@ $(OUTDIR)/./FileFormat/GrADS/Undef.o \
 $(OUTDIR)/./FileFormat/GrADS/Vars.o \
 $(OUTDIR)/./FileFormat/GrADS/XYZDef.o \
 $(OUTDIR)/./FileFormat/KVSML/CellTag.o \
+$(OUTDIR)/./FileFormat/KVSML/ColorIndexTag.o \
 $(OUTDIR)/./FileFormat/KVSML/ColorMapTag.o \
+$(OUTDIR)/./FileFormat/KVSML/ColorPaletteTag.o \
 $(OUTDIR)/./FileFormat/KVSML/ColorTag.o \
 $(OUTDIR)/./FileFormat/KVSML/ColumnTag.o \
 $(OUTDIR)/./FileFormat/KVSML/ConnectionTag.o \
@@ -55,6 +57,7 @@ $(OUTDIR)/./FileFormat/KVSML/DataArrayTag.o \
 $(OUTDIR)/./FileFormat/KVSML/DataReader.o \
 $(OUTDIR)/./FileFormat/KVSML/DataValueTag.o \
 $(OUTDIR)/./FileFormat/KVSML/DataWriter.o \
+$(OUTDIR)/./FileFormat/KVSML/EncodedNormalTag.o \
 $(OUTDIR)/./FileFormat/KVSML/ImageObjectTag.o \
 $(OUTDIR)/./FileFormat/KVSML/KVSMLObjectImage.o \
 $(OUTDIR)/./FileFormat/KVSML/KVSMLObjectLine.o \
@@ -76,6 +79,7 @@ $(OUTDIR)/./FileFormat/KVSML/PixelTag.o \
 $(OUTDIR)/./FileFormat/KVSML/PointObjectTag.o \
 $(OUTDIR)/./FileFormat/KVSML/PolygonObjectTag.o \
 $(OUTDIR)/./FileFormat/KVSML/PolygonTag.o \
+$(OUTDIR)/./FileFormat/KVSML/QuantizedCoordTag.o \
 $(OUTDIR)/./FileFormat/KVSML/SizeTag.o \
 $(OUTDIR)/./FileFormat/KVSML/StructuredVolumeObjectTag.o \
 $(OUTDIR)/./FileFormat/KVSML/TableObjectTag.o \
@@ -116,6 +120,7 @@ $(OUTDIR)/./Matrix/Matrix.o \
 $(OUTDIR)/./Matrix/Matrix22.o \
 $(OUTDIR)/./Matrix/Matrix33.o \
 $(OUTDIR)/./Matrix/Matrix44.o \
+$(OUTDIR)/./Matrix/MatrixKernel.o \
 $(OUTDIR)/./Matrix/OrthogonalMatrix44.o \
 $(OUTDIR)/./Matrix/PerspectiveMatrix44.o \
 $(OUTDIR)/./Matrix/RotationMatrix33.o \
@@ -127,16 +132,21 @@ $(OUTDIR)/./Matrix/Vector4.o \
 $(OUTDIR)/./Matrix/ViewingMatrix44.o \
 $(OUTDIR)/./Network/Acceptor.o \
 $(OUTDIR)/./Network/Connector.o \
+$(OUTDIR)/./Network/FrameStreamClient.o \
+$(OUTDIR)/./Network/FrameStreamCodec.o \
+$(OUTDIR)/./Network/FrameStreamServer.o \
 $(OUTDIR)/./Network/HttpConnector.o \
 $(OUTDIR)/./Network/HttpRequestHeader.o \
 $(OUTDIR)/./Network/IPAddress.o \
 $(OUTDIR)/./Network/MessageBlock.o \
 $(OUTDIR)/./Network/Socket.o \
 $(OUTDIR)/./Network/SocketAddress.o \
+$(OUTDIR)/./Network/SocketReactor.o \
 $(OUTDIR)/./Network/SocketSelector.o \
 $(OUTDIR)/./Network/SocketTimer.o \
 $(OUTDIR)/./Network/TCPBarrier.o \
 $(OUTDIR)/./Network/TCPBarrierServer.o \
+$(OUTDIR)/./Network/TCPImageCompositor.o \
 $(OUTDIR)/./Network/TCPServer.o \
 $(OUTDIR)/./Network/TCPSocket.o \
 $(OUTDIR)/./Network/Url.o \
@@ -208,6 +218,7 @@ $(OUTDIR)/./Utility/Tokenizer.o \
 $(OUTDIR)/./Utility/Type.o \
 $(OUTDIR)/./Utility/Value.o \
 $(OUTDIR)/./Utility/ValueArray.o \
+$(OUTDIR)/./Utility/ValueStatistics.o \
 $(OUTDIR)/./Utility/ValueTable.o \
 $(OUTDIR)/./Visualization/Data/HydrogenVolumeData.o \
 $(OUTDIR)/./Visualization/Data/TornadoVolumeData.o \
@@ -245,12 +256,14 @@ $(OUTDIR)/./Visualization/Filter/StructuredVectorToScalar.o \
 $(OUTDIR)/./Visualization/Filter/TetrahedraToTetrahedra.o \
 $(OUTDIR)/./Visualization/Filter/Tubeline.o \
 $(OUTDIR)/./Visualization/Filter/UnstructuredVectorToScalar.o \
+$(OUTDIR)/./Visualization/Filter/VolumePyramid.o \
 $(OUTDIR)/./Visualization/Importer/ImageImporter.o \
 $(OUTDIR)/./Visualization/Importer/LineImporter.o \
 $(OUTDIR)/./Visualization/Importer/PointImporter.o \
 $(OUTDIR)/./Visualization/Importer/PolygonImporter.o \
 $(OUTDIR)/./Visualization/Importer/StructuredVolumeImporter.o \
 $(OUTDIR)/./Visualization/Importer/TableImporter.o \
+$(OUTDIR)/./Visualization/Importer/TimeSeriesVolume.o \
 $(OUTDIR)/./Visualization/Importer/UnstructuredVolumeImporter.o \
 $(OUTDIR)/./Visualization/Mapper/Cell.o \
 $(OUTDIR)/./Visualization/Mapper/CellAdjacencyGraph.o \
@@ -295,6 +308,8 @@ $(OUTDIR)/./Visualization/Mapper/Streamline.o \
 $(OUTDIR)/./Visualization/Mapper/StreamlineBase.o \
 $(OUTDIR)/./Visualization/Mapper/TetrahedralCell.o \
 $(OUTDIR)/./Visualization/Mapper/TransferFunction.o \
+$(OUTDIR)/./Visualization/Object/BinnedTable.o \
+$(OUTDIR)/./Visualization/Object/BrickedVolume.o \
 $(OUTDIR)/./Visualization/Object/GeometryObjectBase.o \
 $(OUTDIR)/./Visualization/Object/ImageObject.o \
 $(OUTDIR)/./Visualization/Object/LineObject.o \
@@ -306,7 +321,9 @@ $(OUTDIR)/./Visualization/Object/TableObject.o \
 $(OUTDIR)/./Visualization/Object/UnstructuredVolumeObject.o \
 $(OUTDIR)/./Visualization/Object/VolumeObjectBase.o \
 $(OUTDIR)/./Visualization/Pipeline/ObjectImporter.o \
+$(OUTDIR)/./Visualization/Pipeline/PipelineCache.o \
 $(OUTDIR)/./Visualization/Pipeline/PipelineModule.o \
+$(OUTDIR)/./Visualization/Pipeline/PipelineTask.o \
 $(OUTDIR)/./Visualization/Pipeline/VisualizationPipeline.o \
 $(OUTDIR)/./Visualization/Renderer/ArrowGlyph.o \
 $(OUTDIR)/./Visualization/Renderer/Bounds.o \
@@ -314,9 +331,11 @@ $(OUTDIR)/./Visualization/Renderer/DiamondGlyph.o \
 $(OUTDIR)/./Visualization/Renderer/EnsembleAverageBuffer.o \
 $(OUTDIR)/./Visualization/Renderer/GlyphBase.o \
 $(OUTDIR)/./Visualization/Renderer/HAVSVolumeRenderer.o \
+$(OUTDIR)/./Visualization/Renderer/HostFrameBuffer.o \
 $(OUTDIR)/./Visualization/Renderer/ImageRenderer.o \
 $(OUTDIR)/./Visualization/Renderer/LineRenderer.o \
 $(OUTDIR)/./Visualization/Renderer/LineRendererGLSL.o \
+$(OUTDIR)/./Visualization/Renderer/ParallelCoordinatesDensityMap.o \
 $(OUTDIR)/./Visualization/Renderer/ParallelCoordinatesRenderer.o \
 $(OUTDIR)/./Visualization/Renderer/ParticleBasedRenderer.o \
 $(OUTDIR)/./Visualization/Renderer/ParticleBasedRendererGLSL.o \
@@ -333,6 +352,7 @@ $(OUTDIR)/./Visualization/Renderer/ProjectedTetrahedraTable.o \
 $(OUTDIR)/./Visualization/Renderer/Ray.o \
 $(OUTDIR)/./Visualization/Renderer/RayCastingRenderer.o \
 $(OUTDIR)/./Visualization/Renderer/RayCastingRendererGLSL.o \
+$(OUTDIR)/./Visualization/Renderer/ScatterPlotMatrixDensityMap.o \
 $(OUTDIR)/./Visualization/Renderer/ScatterPlotMatrixRenderer.o \
 $(OUTDIR)/./Visualization/Renderer/ScatterPlotRenderer.o \
 $(OUTDIR)/./Visualization/Renderer/Shader.o \
@@ -356,6 +376,7 @@ $(OUTDIR)/./Visualization/Viewer/Background.o \
 $(OUTDIR)/./Visualization/Viewer/Camera.o \
 $(OUTDIR)/./Visualization/Viewer/CameraCoordinate.o \
 $(OUTDIR)/./Visualization/Viewer/DisplayFormat.o \
+$(OUTDIR)/./Visualization/Viewer/HeadlessScene.o \
 $(OUTDIR)/./Visualization/Viewer/IDManager.o \
 $(OUTDIR)/./Visualization/Viewer/Light.o \
 $(OUTDIR)/./Visualization/Viewer/Material.o \
@@ -46,7 +46,9 @@ $(OUTDIR)\.\FileFormat\GrADS\Undef.obj \
 $(OUTDIR)\.\FileFormat\GrADS\Vars.obj \
 $(OUTDIR)\.\FileFormat\GrADS\XYZDef.obj \
 $(OUTDIR)\.\FileFormat\KVSML\CellTag.obj \
+$(OUTDIR)\.\FileFormat\KVSML\ColorIndexTag.obj \
 $(OUTDIR)\.\FileFormat\KVSML\ColorMapTag.obj \
+$(OUTDIR)\.\FileFormat\KVSML\ColorPaletteTag.obj \
 $(OUTDIR)\.\FileFormat\KVSML\ColorTag.obj \
 $(OUTDIR)\.\FileFormat\KVSML\ColumnTag.obj \
 $(OUTDIR)\.\FileFormat\KVSML\ConnectionTag.obj \
@@ -55,6 +57,7 @@ $(OUTDIR)\.\FileFormat\KVSML\DataArrayTag.obj \
 $(OUTDIR)\.\FileFormat\KVSML\DataReader.obj \
 $(OUTDIR)\.\FileFormat\KVSML\DataValueTag.obj \
 $(OUTDIR)\.\FileFormat\KVSML\DataWriter.obj \
+$(OUTDIR)\.\FileFormat\KVSML\EncodedNormalTag.obj \
 $(OUTDIR)\.\FileFormat\KVSML\ImageObjectTag.obj \
 $(OUTDIR)\.\FileFormat\KVSML\KVSMLObjectImage.obj \
 $(OUTDIR)\.\FileFormat\KVSML\KVSMLObjectLine.obj \
@@ -76,6 +79,7 @@ $(OUTDIR)\.\FileFormat\KVSML\PixelTag.obj \
 $(OUTDIR)\.\FileFormat\KVSML\PointObjectTag.obj \
 $(OUTDIR)\.\FileFormat\KVSML\PolygonObjectTag.obj \
 $(OUTDIR)\.\FileFormat\KVSML\PolygonTag.obj \
+$(OUTDIR)\.\FileFormat\KVSML\QuantizedCoordTag.obj \
 $(OUTDIR)\.\FileFormat\KVSML\SizeTag.obj \
 $(OUTDIR)\.\FileFormat\KVSML\StructuredVolumeObjectTag.obj \
 $(OUTDIR)\.\FileFormat\KVSML\TableObjectTag.obj \
@@ -116,6 +120,7 @@ $(OUTDIR)\.\Matrix\Matrix.obj \
 $(OUTDIR)\.\Matrix\Matrix22.obj \
 $(OUTDIR)\.\Matrix\Matrix33.obj \
 $(OUTDIR)\.\Matrix\Matrix44.obj \
+$(OUTDIR)\.\Matrix\MatrixKernel.obj \
 $(OUTDIR)\.\Matrix\OrthogonalMatrix44.obj \
 $(OUTDIR)\.\Matrix\PerspectiveMatrix44.obj \
 $(OUTDIR)\.\Matrix\RotationMatrix33.obj \
@@ -127,16 +132,21 @@ $(OUTDIR)\.\Matrix\Vector4.obj \
 $(OUTDIR)\.\Matrix\ViewingMatrix44.obj \
 $(OUTDIR)\.\Network\Acceptor.obj \
 $(OUTDIR)\.\Network\Connector.obj \
+$(OUTDIR)\.\Network\FrameStreamClient.obj \
+$(OUTDIR)\.\Network\FrameStreamCodec.obj \
+$(OUTDIR)\.\Network\FrameStreamServer.obj \
 $(OUTDIR)\.\Network\HttpConnector.obj \
 $(OUTDIR)\.\Network\HttpRequestHeader.obj \
 $(OUTDIR)\.\Network\IPAddress.obj \
 $(OUTDIR)\.\Network\MessageBlock.obj \
 $(OUTDIR)\.\Network\Socket.obj \
 $(OUTDIR)\.\Network\SocketAddress.obj \
+$(OUTDIR)\.\Network\SocketReactor.obj \
 $(OUTDIR)\.\Network\SocketSelector.obj \
 $(OUTDIR)\.\Network\SocketTimer.obj \
 $(OUTDIR)\.\Network\TCPBarrier.obj \
 $(OUTDIR)\.\Network\TCPBarrierServer.obj \
+$(OUTDIR)\.\Network\TCPImageCompositor.obj \
 $(OUTDIR)\.\Network\TCPServer.obj \
 $(OUTDIR)\.\Network\TCPSocket.obj \
 $(OUTDIR)\.\Network\Url.obj \
@@ -208,6 +218,7 @@ $(OUTDIR)\.\Utility\Tokenizer.obj \
 $(OUTDIR)\.\Utility\Type.obj \
 $(OUTDIR)\.\Utility\Value.obj \
 $(OUTDIR)\.\Utility\ValueArray.obj \
+$(OUTDIR)\.\Utility\ValueStatistics.obj \
 $(OUTDIR)\.\Utility\ValueTable.obj \
 $(OUTDIR)\.\Visualization\Data\HydrogenVolumeData.obj \
 $(OUTDIR)\.\Visualization\Data\TornadoVolumeData.obj \
@@ -245,12 +256,14 @@ $(OUTDIR)\.\Visualization\Filter\StructuredVectorToScalar.obj \
 $(OUTDIR)\.\Visualization\Filter\TetrahedraToTetrahedra.obj \
 $(OUTDIR)\.\Visualization\Filter\Tubeline.obj \
 $(OUTDIR)\.\Visualization\Filter\UnstructuredVectorToScalar.obj \
+$(OUTDIR)\.\Visualization\Filter\VolumePyramid.obj \
 $(OUTDIR)\.\Visualization\Importer\ImageImporter.obj \
 $(OUTDIR)\.\Visualization\Importer\LineImporter.obj \
 $(OUTDIR)\.\Visualization\Importer\PointImporter.obj \
 $(OUTDIR)\.\Visualization\Importer\PolygonImporter.obj \
 $(OUTDIR)\.\Visualization\Importer\StructuredVolumeImporter.obj \
 $(OUTDIR)\.\Visualization\Importer\TableImporter.obj \
+$(OUTDIR)\.\Visualization\Importer\TimeSeriesVolume.obj \
 $(OUTDIR)\.\Visualization\Importer\UnstructuredVolumeImporter.obj \
 $(OUTDIR)\.\Visualization\Mapper\Cell.obj \
 $(OUTDIR)\.\Visualization\Mapper\CellAdjacencyGraph.obj \
@@ -295,6 +308,8 @@ $(OUTDIR)\.\Visualization\Mapper\Streamline.obj \
 $(OUTDIR)\.\Visualization\Mapper\StreamlineBase.obj \
 $(OUTDIR)\.\Visualization\Mapper\TetrahedralCell.obj \
 $(OUTDIR)\.\Visualization\Mapper\TransferFunction.obj \
+$(OUTDIR)\.\Visualization\Object\BinnedTable.obj \
+$(OUTDIR)\.\Visualization\Object\BrickedVolume.obj \
 $(OUTDIR)\.\Visualization\Object\GeometryObjectBase.obj \
 $(OUTDIR)\.\Visualization\Object\ImageObject.obj \
 $(OUTDIR)\.\Visualization\Object\LineObject.obj \
@@ -306,7 +321,9 @@ $(OUTDIR)\.\Visualization\Object\TableObject.obj \
 $(OUTDIR)\.\Visualization\Object\UnstructuredVolumeObject.obj \
 $(OUTDIR)\.\Visualization\Object\VolumeObjectBase.obj \
 $(OUTDIR)\.\Visualization\Pipeline\ObjectImporter.obj \
+$(OUTDIR)\.\Visualization\Pipeline\PipelineCache.obj \
 $(OUTDIR)\.\Visualization\Pipeline\PipelineModule.obj \
+$(OUTDIR)\.\Visualization\Pipeline\PipelineTask.obj \
 $(OUTDIR)\.\Visualization\Pipeline\VisualizationPipeline.obj \
 $(OUTDIR)\.\Visualization\Renderer\ArrowGlyph.obj \
 $(OUTDIR)\.\Visualization\Renderer\Bounds.obj \
@@ -314,9 +331,11 @@ $(OUTDIR)\.\Visualization\Renderer\DiamondGlyph.obj \
 $(OUTDIR)\.\Visualization\Renderer\EnsembleAverageBuffer.obj \
 $(OUTDIR)\.\Visualization\Renderer\GlyphBase.obj \
 $(OUTDIR)\.\Visualization\Renderer\HAVSVolumeRenderer.obj \
+$(OUTDIR)\.\Visualization\Renderer\HostFrameBuffer.obj \
 $(OUTDIR)\.\Visualization\Renderer\ImageRenderer.obj \
 $(OUTDIR)\.\Visualization\Renderer\LineRenderer.obj \
 $(OUTDIR)\.\Visualization\Renderer\LineRendererGLSL.obj \
+$(OUTDIR)\.\Visualization\Renderer\ParallelCoordinatesDensityMap.obj \
 $(OUTDIR)\.\Visualization\Renderer\ParallelCoordinatesRenderer.obj \
 $(OUTDIR)\.\Visualization\Renderer\ParticleBasedRenderer.obj \
 $(OUTDIR)\.\Visualization\Renderer\ParticleBasedRendererGLSL.obj \
@@ -333,6 +352,7 @@ $(OUTDIR)\.\Visualization\Renderer\ProjectedTetrahedraTable.obj \
 $(OUTDIR)\.\Visualization\Renderer\Ray.obj \
 $(OUTDIR)\.\Visualization\Renderer\RayCastingRenderer.obj \
 $(OUTDIR)\.\Visualization\Renderer\RayCastingRendererGLSL.obj \
+$(OUTDIR)\.\Visualization\Renderer\ScatterPlotMatrixDensityMap.obj \
 $(OUTDIR)\.\Visualization\Renderer\ScatterPlotMatrixRenderer.obj \
 $(OUTDIR)\.\Visualization\Renderer\ScatterPlotRenderer.obj \
 $(OUTDIR)\.\Visualization\Renderer\Shader.obj \
@@ -356,6 +376,7 @@ $(OUTDIR)\.\Visualization\Viewer\Background.obj \
 $(OUTDIR)\.\Visualization\Viewer\Camera.obj \
 $(OUTDIR)\.\Visualization\Viewer\CameraCoordinate.obj \
 $(OUTDIR)\.\Visualization\Viewer\DisplayFormat.obj \
+$(OUTDIR)\.\Visualization\Viewer\HeadlessScene.obj \
 $(OUTDIR)\.\Visualization\Viewer\IDManager.obj \
 $(OUTDIR)\.\Visualization\Viewer\Light.obj \
 $(OUTDIR)\.\Visualization\Viewer\Material.obj \
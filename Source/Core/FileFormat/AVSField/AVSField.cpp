@@ -16,6 +16,8 @@
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
+#include <vector>
+#include <algorithm>
 #include <kvs/File>
 #include <kvs/Macro>
 #include <kvs/Platform>
@@ -27,6 +29,13 @@ namespace
 {
 
 const int MaxLineLength = 256;
+const size_t MaxChunkSize = 1 << 20; // number of values read at once
+
+#if defined ( KVS_PLATFORM_BIG_ENDIAN )
+const bool DefaultSwapBytes = true; // the data is stored in little endian
+#else
+const bool DefaultSwapBytes = false;
+#endif
 
 const std::string FieldTypeToString[kvs::AVSField::NumberOfFieldTypes] =
 {
@@ -91,6 +100,77 @@ void SkipHeader( FILE* ifs )
     }
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Reads the blocks of the components and stores them interleaved.
+ *  @param  ifs [in] input file stream
+ *  @param  nvalues [in] number of values of each component
+ *  @param  ncomponents [in] number of components
+ *  @param  swap [in] if true, the byte order is swapped
+ *  @param  data [out] pointer to the interleaved values
+ *  @return true, if the values are read successfully
+ *
+ *  The blocks are read in the large chunks instead of value by value, and
+ *  the chunks are converted to the destination type while interleaving.
+ */
+/*===========================================================================*/
+template <typename T, typename U>
+bool ReadInterleaved( FILE* ifs, const size_t nvalues, const size_t ncomponents, const bool swap, U* data )
+{
+    std::vector<T> buffer( std::min( nvalues, ::MaxChunkSize ) );
+    for ( size_t c = 0; c < ncomponents; c++ )
+    {
+        for ( size_t i = 0; i < nvalues; i += buffer.size() )
+        {
+            const size_t n = std::min( buffer.size(), nvalues - i );
+            if ( fread( &buffer[0], sizeof(T), n, ifs ) != n ) return false;
+            if ( swap ) kvs::Endian::Swap( &buffer[0], n );
+
+            U* dst = data + i * ncomponents + c;
+            for ( size_t j = 0; j < n; j++, dst += ncomponents )
+            {
+                *dst = static_cast<U>( buffer[j] );
+            }
+        }
+    }
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Reads the blocks of the axes and stores them one after another.
+ *  @param  ifs [in] input file stream
+ *  @param  dim [in] number of values of each axis
+ *  @param  ndim [in] number of axes
+ *  @param  swap [in] if true, the byte order is swapped
+ *  @param  data [out] pointer to the values (dim[0] + ... + dim[ndim-1])
+ *  @return true, if the values are read successfully
+ */
+/*===========================================================================*/
+template <typename T, typename U>
+bool ReadAxes( FILE* ifs, const kvs::Vector3ui& dim, const size_t ndim, const bool swap, U* data )
+{
+    size_t max_nvalues = 0;
+    for ( size_t axis = 0; axis < ndim; axis++ ) max_nvalues = std::max( max_nvalues, size_t( dim[ axis ] ) );
+
+    std::vector<T> buffer( std::min( max_nvalues, ::MaxChunkSize ) );
+    for ( size_t axis = 0; axis < ndim; axis++ )
+    {
+        const size_t nvalues = dim[ axis ];
+        for ( size_t i = 0; i < nvalues; i += buffer.size() )
+        {
+            const size_t n = std::min( buffer.size(), nvalues - i );
+            if ( fread( &buffer[0], sizeof(T), n, ifs ) != n ) return false;
+            if ( swap ) kvs::Endian::Swap( &buffer[0], n );
+
+            for ( size_t j = 0; j < n; j++ ) { *(data++) = static_cast<U>( buffer[j] ); }
+        }
+    }
+
+    return true;
+}
+
 }
 
 namespace kvs
@@ -123,7 +203,9 @@ AVSField::AVSField():
     m_max_ext( 1, 1, 1 ),
     m_has_min_max_ext( false ),
     m_field( Uniform ),
-    m_type( UnknownDataType )
+    m_type( UnknownDataType ),
+    m_is_native_coords( false ),
+    m_is_swap_bytes( ::DefaultSwapBytes )
 {
 }
 
@@ -144,7 +226,9 @@ AVSField::AVSField( const std::string& filename ):
     m_max_ext( 1, 1, 1 ),
     m_has_min_max_ext( false ),
     m_field( Uniform ),
-    m_type( UnknownDataType )
+    m_type( UnknownDataType ),
+    m_is_native_coords( false ),
+    m_is_swap_bytes( ::DefaultSwapBytes )
 {
     this->read( filename );
 }
@@ -334,6 +418,39 @@ const kvs::ValueArray<float>& AVSField::coords() const
     return m_coords;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Returns the coordinate value array in the data type.
+ *  @return coordinate value array (empty unless the native coords is enabled)
+ */
+/*===========================================================================*/
+const kvs::AnyValueArray& AVSField::nativeCoords() const
+{
+    return m_native_coords;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns true if the coordinates are kept in the data type.
+ *  @return true, if the native coords is enabled
+ */
+/*===========================================================================*/
+bool AVSField::isNativeCoords() const
+{
+    return m_is_native_coords;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns true if the byte order of the data is swapped in reading.
+ *  @return true, if the byte swap is enabled
+ */
+/*===========================================================================*/
+bool AVSField::isSwapBytes() const
+{
+    return m_is_swap_bytes;
+}
+
 /*==========================================================================*/
 /**
  *  Set bit depth.
@@ -483,6 +600,53 @@ void AVSField::setCoords( const kvs::ValueArray<float>& coords )
     m_coords = coords;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Keeps the coordinates in the data type instead of float.
+ *
+ *  The coordinates are stored in nativeCoords(), and coords() shares the
+ *  array only if the data type is float (otherwise, coords() is empty).
+ */
+/*===========================================================================*/
+void AVSField::enableNativeCoords()
+{
+    m_is_native_coords = true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Converts the coordinates to float (default).
+ */
+/*===========================================================================*/
+void AVSField::disableNativeCoords()
+{
+    m_is_native_coords = false;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Swaps the byte order of the values and the coordinates in reading.
+ *
+ *  The data is assumed to be stored in little endian, so that the byte swap
+ *  is enabled on the big-endian platform by default. This can be used to
+ *  read the data stored in the other byte order.
+ */
+/*===========================================================================*/
+void AVSField::enableSwapBytes()
+{
+    m_is_swap_bytes = true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Reads the data without the byte swap.
+ */
+/*===========================================================================*/
+void AVSField::disableSwapBytes()
+{
+    m_is_swap_bytes = false;
+}
+
 /*==========================================================================*/
 /**
  *  Output the information of AVSField data.
@@ -532,18 +696,23 @@ bool AVSField::read( const std::string& filename )
 
     if( !read_header( ifs ) )
     {
+        fclose( ifs );
         BaseClass::setSuccess( false );
         return false;
     }
 
     if( !read_node( ifs ) )
     {
+        kvsMessageError( "Cannot read the node data." );
+        fclose( ifs );
         BaseClass::setSuccess( false );
         return false;
     }
 
     if( !read_coord( ifs ) )
     {
+        kvsMessageError( "Cannot read the coordinate data." );
+        fclose( ifs );
         BaseClass::setSuccess( false );
         return false;
     }
@@ -737,23 +906,17 @@ bool AVSField::read_node( FILE* ifs )
         return false;
     }
 
-#if defined ( KVS_PLATFORM_BIG_ENDIAN )
-//    m_values.swapByte();
-    switch ( m_values.typeID() )
+    if ( m_is_swap_bytes )
     {
-    case kvs::Type::TypeInt8:   kvs::Endian::Swap( static_cast<kvs::Int8*  >( m_values.data() ), m_values.size() ); break;
-    case kvs::Type::TypeUInt8:  kvs::Endian::Swap( static_cast<kvs::UInt8* >( m_values.data() ), m_values.size() ); break;
-    case kvs::Type::TypeInt16:  kvs::Endian::Swap( static_cast<kvs::Int16* >( m_values.data() ), m_values.size() ); break;
-    case kvs::Type::TypeUInt16: kvs::Endian::Swap( static_cast<kvs::UInt16*>( m_values.data() ), m_values.size() ); break;
-    case kvs::Type::TypeInt32:  kvs::Endian::Swap( static_cast<kvs::Int32* >( m_values.data() ), m_values.size() ); break;
-    case kvs::Type::TypeUInt32: kvs::Endian::Swap( static_cast<kvs::UInt32*>( m_values.data() ), m_values.size() ); break;
-    case kvs::Type::TypeInt64:  kvs::Endian::Swap( static_cast<kvs::Int64* >( m_values.data() ), m_values.size() ); break;
-    case kvs::Type::TypeUInt64: kvs::Endian::Swap( static_cast<kvs::UInt64*>( m_values.data() ), m_values.size() ); break;
-    case kvs::Type::TypeReal32: kvs::Endian::Swap( static_cast<kvs::Real32*>( m_values.data() ), m_values.size() ); break;
-    case kvs::Type::TypeReal64: kvs::Endian::Swap( static_cast<kvs::Real64*>( m_values.data() ), m_values.size() ); break;
-    default: break;
+        switch ( m_values.typeID() )
+        {
+        case kvs::Type::TypeInt16:  kvs::Endian::Swap( static_cast<kvs::Int16* >( m_values.data() ), m_values.size() ); break;
+        case kvs::Type::TypeInt32:  kvs::Endian::Swap( static_cast<kvs::Int32* >( m_values.data() ), m_values.size() ); break;
+        case kvs::Type::TypeReal32: kvs::Endian::Swap( static_cast<kvs::Real32*>( m_values.data() ), m_values.size() ); break;
+        case kvs::Type::TypeReal64: kvs::Endian::Swap( static_cast<kvs::Real64*>( m_values.data() ), m_values.size() ); break;
+        default: break;
+        }
     }
-#endif
 
     return true;
 }
@@ -788,36 +951,56 @@ bool AVSField::read_coord( FILE* ifs )
 
     switch( m_type )
     {
-    case Byte:    read_coord_data<unsigned char>( ifs, nvertices ); break;
-    case Short:   read_coord_data<short>( ifs, nvertices ); break;
-    case Integer: read_coord_data<int>( ifs, nvertices ); break;
-    case Float:   read_coord_data<float>( ifs, nvertices ); break;
-    case Double:  read_coord_data<double>( ifs, nvertices ); break;
+    case Byte:    return read_coord_data<unsigned char>( ifs, nvertices );
+    case Short:   return read_coord_data<short>( ifs, nvertices );
+    case Integer: return read_coord_data<int>( ifs, nvertices );
+    case Float:   return read_coord_data<float>( ifs, nvertices );
+    case Double:  return read_coord_data<double>( ifs, nvertices );
     default: break;
     }
 
     return true;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Reads the coordinate blocks into the coordinate array.
+ *  @param  ifs [in] input file stream
+ *  @param  nvertices [in] number of vertices (sum of the dimensions for rectilinear)
+ *  @return true, if the coordinates are read successfully
+ *
+ *  The rectilinear field has a block of m_dim[i] values for each axis i, and
+ *  the blocks are stored one after another (x, y and z coordinates). The
+ *  irregular field has a block of nvertices values for each space, and the
+ *  blocks are interleaved (x, y, z, x, y, z, ...).
+ */
+/*===========================================================================*/
 template <typename T>
-bool AVSField::read_coord_data(  FILE* ifs, const size_t nvertices )
+bool AVSField::read_coord_data( FILE* ifs, const size_t nvertices )
 {
-    m_coords.allocate( nvertices * m_nspace );
-
+    const size_t ndim = static_cast<size_t>( m_ndim );
     const size_t nspace = static_cast<size_t>( m_nspace );
-    for( size_t nsp = 0; nsp < nspace; nsp++ )
+    const bool rectilinear = m_field == AVSField::Rectilinear;
+    const size_t ncoords = rectilinear ? nvertices : nvertices * nspace;
+    if ( m_is_native_coords )
     {
-        for( size_t i = 0; i < nvertices; i++ )
-        {
-            T data = T(0);
-            if ( fread( &data, sizeof(T), 1, ifs ) == 1 )
-            {
-                m_coords[ i * m_nspace + nsp ] = static_cast<float>( data );
-            }
-        }
+        m_native_coords.allocate<T>( ncoords );
+        T* coords = static_cast<T*>( m_native_coords.data() );
+        const bool success = rectilinear ?
+            ::ReadAxes<T>( ifs, m_dim, ndim, m_is_swap_bytes, coords ) :
+            ::ReadInterleaved<T>( ifs, nvertices, nspace, m_is_swap_bytes, coords );
+        if ( !success ) return false;
+
+        // The array is shared if the data type is float.
+        m_coords = ( m_type == Float ) ? m_native_coords.asValueArray<float>() : kvs::ValueArray<float>();
+        return true;
     }
 
-    return true;
+    m_native_coords.release();
+    m_coords.allocate( ncoords );
+    return rectilinear ?
+        ::ReadAxes<T>( ifs, m_dim, ndim, m_is_swap_bytes, m_coords.data() ) :
+        ::ReadInterleaved<T>( ifs, nvertices, nspace, m_is_swap_bytes, m_coords.data() );
 }
 
 /*==========================================================================*/
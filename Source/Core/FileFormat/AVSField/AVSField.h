@@ -74,6 +74,9 @@ private:
     std::vector<std::string> m_labels; ///< label
     kvs::AnyValueArray m_values; ///< field value array (shared array)
     kvs::ValueArray<float> m_coords; ///< coordinate value array (shared array)
+    kvs::AnyValueArray m_native_coords; ///< coordinate value array in the data type (shared array)
+    bool m_is_native_coords; ///< if true, the coordinates are kept in the data type
+    bool m_is_swap_bytes; ///< if true, the byte order of the data is swapped
 
 public:
 
@@ -101,6 +104,9 @@ public:
     const std::vector<std::string>& labels() const;
     const kvs::AnyValueArray& values() const;
     const kvs::ValueArray<float>& coords() const;
+    const kvs::AnyValueArray& nativeCoords() const;
+    bool isNativeCoords() const;
+    bool isSwapBytes() const;
 
     void setBits( const int bits );
     void setSigned( const bool sign );
@@ -115,6 +121,10 @@ public:
     void setLabels( const std::vector<std::string>& labels );
     void setValues( const kvs::AnyValueArray& values );
     void setCoords( const kvs::ValueArray<float>& coords );
+    void enableNativeCoords();
+    void disableNativeCoords();
+    void enableSwapBytes();
+    void disableSwapBytes();
 
     void print( std::ostream& os, const kvs::Indent& indent = kvs::Indent(0) ) const;
     bool read( const std::string& filename );
@@ -34,9 +34,37 @@
 
 namespace
 {
+
 kvs::dcm::Tag END_HEADER_TAG = kvs::dcm::Tag( 0x7FE0, 0x0010, kvs::dcm::VR_OW );
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the key of the tag specified by the group and element IDs.
+ *  @param  group_id [in] group ID
+ *  @param  element_id [in] element ID
+ *  @return tag key
+ */
+/*===========================================================================*/
+inline unsigned int Key( const unsigned short group_id, const unsigned short element_id )
+{
+    return ( static_cast<unsigned int>( group_id ) << 16 ) | element_id;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Compares the tag of the element with the given tag.
+ */
+/*===========================================================================*/
+struct ElementTagLess
+{
+    bool operator () ( const kvs::dcm::Element& element, const kvs::dcm::Tag& tag ) const
+    {
+        return element.tag().key() < tag.key();
+    }
+};
+
+} // end of namespace
+
 namespace kvs
 {
 
@@ -400,7 +428,7 @@ const dcm::Attribute& Dicom::attribute() const
  *  @brief  
  */
 /*===========================================================================*/
-const std::list<dcm::Element>& Dicom::elementList() const
+const Dicom::ElementList& Dicom::elementList() const
 {
     return m_element_list;
 }
@@ -624,12 +652,30 @@ void Dicom::setRawData( const kvs::ValueArray<char>& raw_data )
 /**
  *  @brief  Find the DICOM header element.
  *  @param  tag [in] element tag
- *  @return iterator to the element, if the given element is found
+ *  @return iterator to the element, if the given element is found (end of the list if not)
  */
 /*===========================================================================*/
-std::list<dcm::Element>::iterator Dicom::findElement( const dcm::Tag tag )
+Dicom::ElementList::iterator Dicom::findElement( const dcm::Tag& tag )
 {
-    return std::find( m_element_list.begin(), m_element_list.end(), tag );
+    ElementList::iterator element = std::lower_bound(
+        m_element_list.begin(), m_element_list.end(), tag, ::ElementTagLess() );
+    if ( element != m_element_list.end() && element->tag() == tag ) return element;
+    return m_element_list.end();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Find the DICOM header element.
+ *  @param  tag [in] element tag
+ *  @return iterator to the element, if the given element is found (end of the list if not)
+ */
+/*===========================================================================*/
+Dicom::ElementList::const_iterator Dicom::findElement( const dcm::Tag& tag ) const
+{
+    ElementList::const_iterator element = std::lower_bound(
+        m_element_list.begin(), m_element_list.end(), tag, ::ElementTagLess() );
+    if ( element != m_element_list.end() && element->tag() == tag ) return element;
+    return m_element_list.end();
 }
 
 void Dicom::print( std::ostream& os, const kvs::Indent& indent ) const
@@ -664,47 +710,75 @@ void Dicom::print( std::ostream& os, const kvs::Indent& indent ) const
 /*===========================================================================*/
 bool Dicom::read( const std::string& filename )
 {
-    BaseClass::setFilename( filename );
-    BaseClass::setSuccess( true );
+    return this->read_file( filename, true );
+}
 
-    // Open the file.
-    std::ifstream ifs( filename.c_str(), std::ios_base::binary );
-    if( ifs.fail() )
-    {
-        kvsMessageError( "Cannot open %s.", filename.c_str() );
-        BaseClass::setSuccess( false );
-        return false;
-    }
+/*===========================================================================*/
+/**
+ *  @brief  Read the header information of the given file without the pixel data.
+ *  @param  filename [i] filename
+ *  @return true, if the reading process is done successfully
+ *
+ *  The pixel data can be read later by readData(). A series can be sorted
+ *  by the header information before the pixel data is loaded.
+ */
+/*===========================================================================*/
+bool Dicom::readHeader( const std::string& filename )
+{
+    return this->read_file( filename, false );
+}
 
-    // Check attribute.
-    if( !m_attribute.check( ifs ) )
+/*===========================================================================*/
+/**
+ *  @brief  Read the pixel data of the file whose header has been read.
+ *  @return true, if the reading process is done successfully
+ */
+/*===========================================================================*/
+bool Dicom::readData()
+{
+    m_raw_data.allocate( this->size() );
+    if( !this->readRawData( m_raw_data.data() ) )
     {
-        kvsMessageError("Fail the attribute check of the DICOM file.");
-        ifs.close();
+        m_raw_data.release();
         BaseClass::setSuccess( false );
         return false;
     }
 
-    // Read the header information.
-    if( !this->read_header( ifs ) )
+    this->set_windowing_parameter();
+    this->set_min_max_window_value();
+    this->set_min_max_raw_value();
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Read the raw pixel data of the file whose header has been read.
+ *  @param  data [out] pointer to the buffer of size() bytes
+ *  @return true, if the reading process is done successfully
+ *
+ *  The raw data is read into the given buffer without being stored in this
+ *  class, so that the pixel data can be loaded directly into a volume.
+ */
+/*===========================================================================*/
+bool Dicom::readRawData( char* data ) const
+{
+    const std::string& filename = BaseClass::filename();
+    std::ifstream ifs( filename.c_str(), std::ios_base::binary );
+    if( ifs.fail() )
     {
-        kvsMessageError("Cannot read the header of the DICOM file.");
-        ifs.close();
-        BaseClass::setSuccess( false );
+        kvsMessageError( "Cannot open %s.", filename.c_str() );
         return false;
     }
 
-    // Read the pixel data.
-    if( !this->read_data( ifs ) )
+    ifs.seekg( m_position, std::ios::beg );
+    ifs.read( data, this->size() );
+    if( ifs.fail() )
     {
-        kvsMessageError("Cannot read the pixel data of the DICOM file.");
-        ifs.close();
-        BaseClass::setSuccess( false );
+        kvsMessageError( "Cannot read the pixel data of %s.", filename.c_str() );
         return false;
     }
 
-    ifs.close();
-
     return true;
 }
 
@@ -748,6 +822,62 @@ bool Dicom::write( const std::string& filename )
     return true;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Read the given file as DICOM format.
+ *  @param  filename  [in] filename
+ *  @param  with_data [in] if true, the pixel data is read as well as the header
+ *  @return true, if the reading process is done successfully
+ */
+/*===========================================================================*/
+bool Dicom::read_file( const std::string& filename, const bool with_data )
+{
+    BaseClass::setFilename( filename );
+    BaseClass::setSuccess( true );
+    m_element_list.clear();
+    m_raw_data.release();
+
+    // Open the file.
+    std::ifstream ifs( filename.c_str(), std::ios_base::binary );
+    if( ifs.fail() )
+    {
+        kvsMessageError( "Cannot open %s.", filename.c_str() );
+        BaseClass::setSuccess( false );
+        return false;
+    }
+
+    // Check attribute.
+    if( !m_attribute.check( ifs ) )
+    {
+        kvsMessageError("Fail the attribute check of the DICOM file.");
+        ifs.close();
+        BaseClass::setSuccess( false );
+        return false;
+    }
+
+    // Read the header information.
+    if( !this->read_header( ifs ) )
+    {
+        kvsMessageError("Cannot read the header of the DICOM file.");
+        ifs.close();
+        BaseClass::setSuccess( false );
+        return false;
+    }
+
+    // Read the pixel data.
+    if( with_data && !this->read_data( ifs ) )
+    {
+        kvsMessageError("Cannot read the pixel data of the DICOM file.");
+        ifs.close();
+        BaseClass::setSuccess( false );
+        return false;
+    }
+
+    ifs.close();
+
+    return true;
+}
+
 /*===========================================================================*/
 /**
  *  @brief  Read the header information of the DICOM file.
@@ -773,7 +903,7 @@ bool Dicom::read_header( std::ifstream& ifs )
 #elif DCM_DEBUG__STDOUT_ALL_ELEMENTS
         cout << element << std::endl << std::endl;
 #endif
-        if( element.isKnown() ) m_element_list.push_back( element );
+        if( element.isKnown() ) this->insert_element( element );
 
         this->parse_element( element );
 
@@ -826,7 +956,7 @@ bool Dicom::read_data( std::ifstream& ifs )
 /*===========================================================================*/
 bool Dicom::write_header( std::ofstream& ofs )
 {
-    std::list<dcm::Element>::iterator p = m_element_list.begin();
+    ElementList::const_iterator p = m_element_list.begin();
     while( p != m_element_list.end() ) ofs << *p++ << std::endl << std::endl;
 
     return true;
@@ -849,7 +979,7 @@ bool Dicom::write_header_csv( std::ofstream& ofs )
         << "Value length,"
         << "Value" << std::endl;
 
-    std::list<dcm::Element>::iterator p = m_element_list.begin();
+    ElementList::const_iterator p = m_element_list.begin();
     while( p != m_element_list.end() )
     {
         const dcm::Element& element = *p;
@@ -885,6 +1015,28 @@ bool Dicom::write_raw_data( std::ofstream& ofs )
     return true;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Insert the element into the element list sorted by tag.
+ *  @param  element [in] DICOM element
+ */
+/*===========================================================================*/
+void Dicom::insert_element( const dcm::Element& element )
+{
+    // The elements are usually stored in ascending order of the tag in the
+    // file, so that the element is appended in most cases.
+    if( m_element_list.empty() || m_element_list.back().tag() < element.tag() )
+    {
+        m_element_list.push_back( element );
+        return;
+    }
+
+    ElementList::iterator p = std::lower_bound(
+        m_element_list.begin(), m_element_list.end(), element.tag(), ::ElementTagLess() );
+    if( p != m_element_list.end() && p->tag() == element.tag() ) *p = element;
+    else m_element_list.insert( p, element );
+}
+
 void Dicom::set_windowing_parameter()
 {
     if( m_window_level == 0 && m_window_width == 0 )
@@ -1106,22 +1258,24 @@ kvs::ValueArray<kvs::UInt8> Dicom::get_pixel_data( const int level, const int wi
 /*===========================================================================*/
 void Dicom::parse_element( dcm::Element& element )
 {
+    const unsigned int key = element.tag().key();
+
     // Modality.
-    if( element.tag() == dcm::Tag( 0x0008, 0x0060 ) )
+    if( key == ::Key( 0x0008, 0x0060 ) )
     {
         m_modality = (std::string)element.value();
         return;
     }
 
     // Manufacturer.
-    if( element.tag() == dcm::Tag( 0x0008, 0x0070 ) )
+    if( key == ::Key( 0x0008, 0x0070 ) )
     {
         m_manufacturer = (std::string)element.value();
         return;
     }
 
     // Slice thickness.
-    if( element.tag() == dcm::Tag( 0x0018, 0x0050 ) )
+    if( key == ::Key( 0x0018, 0x0050 ) )
     {
         std::string temp = element.value();
         std::stringstream t( temp );
@@ -1130,7 +1284,7 @@ void Dicom::parse_element( dcm::Element& element )
     }
 
     // Slice spacing.
-    if( element.tag() == dcm::Tag( 0x0018, 0x0088 ) )
+    if( key == ::Key( 0x0018, 0x0088 ) )
     {
         std::string temp = element.value();
         std::stringstream t( temp );
@@ -1139,7 +1293,7 @@ void Dicom::parse_element( dcm::Element& element )
     }
 
     // Series number.
-    if( element.tag() == dcm::Tag( 0x0020, 0x0011 ) )
+    if( key == ::Key( 0x0020, 0x0011 ) )
     {
         std::string temp = element.value();
         std::stringstream t( temp );
@@ -1148,7 +1302,7 @@ void Dicom::parse_element( dcm::Element& element )
     }
 
     // Image number.
-    if( element.tag() == dcm::Tag( 0x0020, 0x0013 ) )
+    if( key == ::Key( 0x0020, 0x0013 ) )
     {
         std::string temp = element.value();
         std::stringstream t( temp );
@@ -1157,7 +1311,7 @@ void Dicom::parse_element( dcm::Element& element )
     }
 
     // Slice location.
-    if( element.tag() == dcm::Tag( 0x0020, 0x1041 ) )
+    if( key == ::Key( 0x0020, 0x1041 ) )
     {
         std::string temp = element.value();
         std::stringstream t( temp );
@@ -1166,42 +1320,42 @@ void Dicom::parse_element( dcm::Element& element )
     }
 
     // Column.
-    if( element.tag() == dcm::Tag( 0x0028, 0x0011 ) )
+    if( key == ::Key( 0x0028, 0x0011 ) )
     {
         m_column = element.value();
         return;
     }
 
     // Row.
-    if( element.tag() == dcm::Tag( 0x0028, 0x0010 ) )
+    if( key == ::Key( 0x0028, 0x0010 ) )
     {
         m_row = element.value();
         return;
     }
 
     // Bits allocated.
-    if( element.tag() == dcm::Tag( 0x0028, 0x0100 ) )
+    if( key == ::Key( 0x0028, 0x0100 ) )
     {
         m_bits_allocated = element.value();
         return;
     }
 
     // Bits stored.
-    if( element.tag() == dcm::Tag( 0x0028, 0x0101 ) )
+    if( key == ::Key( 0x0028, 0x0101 ) )
     {
         m_bits_stored = element.value();
         return;
     }
 
     // High bit.
-    if( element.tag() == dcm::Tag( 0x0028, 0x0102 ) )
+    if( key == ::Key( 0x0028, 0x0102 ) )
     {
         m_high_bit = element.value();
         return;
     }
 
     // Pixel representation.
-    if( element.tag() == dcm::Tag( 0x0028, 0x0103 ) )
+    if( key == ::Key( 0x0028, 0x0103 ) )
     {
         // (true: unsigned, false: signed)
         const unsigned short temp = element.value();
@@ -1210,7 +1364,7 @@ void Dicom::parse_element( dcm::Element& element )
     }
 
     // Pixel spacing.
-    if( element.tag() == dcm::Tag( 0x0028, 0x0030 ) )
+    if( key == ::Key( 0x0028, 0x0030 ) )
     {
         // Split the string by the delimiter '\': "xxx\yyy" -> xxx yyy
         std::string         temp  = element.value();
@@ -1236,7 +1390,7 @@ void Dicom::parse_element( dcm::Element& element )
     }
 
     // Window center.
-    if( element.tag() == dcm::Tag( 0x0028, 0x1050 ) )
+    if( key == ::Key( 0x0028, 0x1050 ) )
     {
         std::string temp = element.value();
         std::stringstream t( temp );
@@ -1245,7 +1399,7 @@ void Dicom::parse_element( dcm::Element& element )
     }
 
     // Window width.
-    if( element.tag() == dcm::Tag( 0x0028, 0x1051 ) )
+    if( key == ::Key( 0x0028, 0x1051 ) )
     {
         std::string temp = element.value();
         std::stringstream t( temp );
@@ -1254,7 +1408,7 @@ void Dicom::parse_element( dcm::Element& element )
     }
 
     // Rescale intersept.
-    if( element.tag() == dcm::Tag( 0x0028, 0x1052 ) )
+    if( key == ::Key( 0x0028, 0x1052 ) )
     {
         std::string temp = element.value();
         std::stringstream t( temp );
@@ -1263,7 +1417,7 @@ void Dicom::parse_element( dcm::Element& element )
     }
 
     // Rescale slope.
-    if( element.tag() == dcm::Tag( 0x0028, 0x1053 ) )
+    if( key == ::Key( 0x0028, 0x1053 ) )
     {
         std::string temp = element.value();
         std::stringstream t( temp );
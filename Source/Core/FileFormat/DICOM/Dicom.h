@@ -17,7 +17,7 @@
 #include <iostream>
 #include <fstream>
 #include <string>
-#include <list>
+#include <vector>
 #include <algorithm>
 #include <kvs/FileFormatBase>
 #include <kvs/ValueArray>
@@ -43,12 +43,12 @@ public:
 
     typedef kvs::FileFormatBase BaseClass;
     typedef dcm::Element Element;
-    typedef std::list<dcm::Element> ElementList;
+    typedef std::vector<dcm::Element> ElementList;
 
 protected:
 
     dcm::Attribute m_attribute; ///< attribute
-    std::list<dcm::Element> m_element_list; ///< element list
+    ElementList m_element_list; ///< element list (sorted by tag)
     std::string m_modality; ///< modality (0008,0060)
     std::string m_manufacturer; ///< manufacturer (0008,0070)
     double m_slice_thickness; ///< slice thickness (0018,0050)
@@ -108,7 +108,7 @@ public:
     double rescaleIntersept() const;
     double rescaleSlope() const;
     const dcm::Attribute& attribute() const;
-    const std::list<dcm::Element>& elementList() const;
+    const ElementList& elementList() const;
     const std::string& modality() const;
     const kvs::Vector2f& pixelSpacing() const;
     const std::string& manufacturer() const;
@@ -126,18 +126,24 @@ public:
     void setRawData( const kvs::ValueArray<char>& raw_data );
     void changeWindow( const int level, const int width );
     void resetWindow();
-    std::list<dcm::Element>::iterator findElement( const dcm::Tag tag );
+    ElementList::iterator findElement( const dcm::Tag& tag );
+    ElementList::const_iterator findElement( const dcm::Tag& tag ) const;
     void print( std::ostream& os, const kvs::Indent& indent = kvs::Indent(0) ) const;
     bool read( const std::string& filename );
+    bool readHeader( const std::string& filename );
+    bool readData();
+    bool readRawData( char* data ) const;
     bool write( const std::string& filename );
 
 private:
 
+    bool read_file( const std::string& filename, const bool with_data );
     bool read_header( std::ifstream& ifs );
     bool read_data( std::ifstream& ifs );
     bool write_header( std::ofstream& ofs );
     bool write_header_csv( std::ofstream& ofs );
     bool write_raw_data( std::ofstream& ofs );
+    void insert_element( const dcm::Element& element );
     void set_windowing_parameter();
     void set_min_max_window_value();
     template <typename T>
@@ -22,6 +22,105 @@
 #include <kvs/Message>
 #include <kvs/Math>
 #include <kvs/IgnoreUnusedVariable>
+#include <kvs/Thread>
+#include <kvs/SystemInformation>
+
+
+namespace
+{
+
+const size_t MinFilesPerThread = 4;
+
+/*===========================================================================*/
+/**
+ *  @brief  Loader class that reads a range of the DICOM files.
+ */
+/*===========================================================================*/
+class Loader : public kvs::Thread
+{
+private:
+
+    const std::vector<std::string>* m_filenames; ///< filenames
+    kvs::Dicom** m_list; ///< DICOM data of each file
+    size_t m_begin; ///< first file
+    size_t m_end; ///< last file + 1
+    bool m_header; ///< if true, the headers are read, otherwise the pixel data
+
+public:
+
+    Loader():
+        m_filenames( NULL ),
+        m_list( NULL ),
+        m_begin( 0 ),
+        m_end( 0 ),
+        m_header( true ) {}
+
+    void init(
+        const std::vector<std::string>* filenames,
+        kvs::Dicom** list,
+        const size_t begin,
+        const size_t end,
+        const bool header )
+    {
+        m_filenames = filenames;
+        m_list = list;
+        m_begin = begin;
+        m_end = end;
+        m_header = header;
+    }
+
+    void run()
+    {
+        for ( size_t i = m_begin; i < m_end; i++ )
+        {
+            if ( m_header )
+            {
+                m_list[i] = new kvs::Dicom();
+                m_list[i]->readHeader( (*m_filenames)[i] );
+            }
+            else
+            {
+                m_list[i]->readData();
+            }
+        }
+    }
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Reads the headers or the pixel data of the DICOM files in parallel.
+ *  @param  filenames [in] filenames (used for reading the headers)
+ *  @param  list [in/out] DICOM data of each file
+ *  @param  header [in] if true, the headers are read, otherwise the pixel data
+ *  @param  nthreads [in] number of threads (0: number of processors)
+ */
+/*===========================================================================*/
+void Load(
+    const std::vector<std::string>& filenames,
+    std::vector<kvs::Dicom*>& list,
+    const bool header,
+    size_t nthreads )
+{
+    const size_t nfiles = list.size();
+    if ( nfiles == 0 ) return;
+
+    // The first block is read by the calling thread.
+    if ( nthreads == 0 ) nthreads = kvs::SystemInformation::NumberOfProcessors();
+    nthreads = kvs::Math::Max( size_t(1), kvs::Math::Min( nthreads, nfiles / ::MinFilesPerThread ) );
+
+    std::vector< ::Loader > loaders( nthreads );
+    for ( size_t i = 0; i < nthreads; i++ )
+    {
+        const size_t begin = nfiles * i / nthreads;
+        const size_t end = nfiles * ( i + 1 ) / nthreads;
+        loaders[i].init( &filenames, &list[0], begin, end, header );
+    }
+    for ( size_t i = 1; i < nthreads; i++ ) { if ( !loaders[i].start() ) { loaders[i].run(); } }
+    loaders[0].run();
+    for ( size_t i = 1; i < nthreads; i++ ) { if ( loaders[i].isRunning() ) { loaders[i].wait(); } }
+}
+
+} // end of namespace
 
 
 namespace kvs
@@ -119,9 +218,12 @@ DicomList::DicomList():
     m_row( 0 ),
     m_column( 0 ),
     m_slice_thickness( 0.0 ),
+    m_slice_spacing( 0.0 ),
     m_min_raw_value( 0 ),
     m_max_raw_value( 0 ),
-    m_extension_check( true )
+    m_extension_check( true ),
+    m_header_only( false ),
+    m_nthreads( 0 )
 {
 }
 
@@ -136,12 +238,14 @@ DicomList::DicomList( const std::string& dirname, const bool extension_check ):
     m_row( 0 ),
     m_column( 0 ),
     m_slice_thickness( 0.0 ),
+    m_slice_spacing( 0.0 ),
     m_min_raw_value( 0 ),
     m_max_raw_value( 0 ),
-    m_extension_check( extension_check )
+    m_extension_check( extension_check ),
+    m_header_only( false ),
+    m_nthreads( 0 )
 {
-    this->read( dirname );
-    this->sort(); // Sorting by slice location. (default sorting method)
+    this->read( dirname ); // Sorted by slice location. (default sorting method)
 }
 
 /*===========================================================================*/
@@ -369,6 +473,61 @@ void DicomList::disableExtensionCheck()
     m_extension_check = false;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Enable header-only reading.
+ *
+ *  Only the headers are read by read(), and the pixel data of each slice
+ *  is read directly into the volume by StructuredVolumeImporter. The min.
+ *  and max. raw values are not available in this mode.
+ */
+/*===========================================================================*/
+void DicomList::enableHeaderOnly()
+{
+    m_header_only = true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Disable header-only reading.
+ */
+/*===========================================================================*/
+void DicomList::disableHeaderOnly()
+{
+    m_header_only = false;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Return true if header-only reading is enabled.
+ */
+/*===========================================================================*/
+bool DicomList::isHeaderOnly() const
+{
+    return m_header_only;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Set the number of threads used for reading the files.
+ *  @param  nthreads [in] number of threads (0: number of processors)
+ */
+/*===========================================================================*/
+void DicomList::setNumberOfThreads( const size_t nthreads )
+{
+    m_nthreads = nthreads;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Return the number of threads used for reading the files.
+ */
+/*===========================================================================*/
+size_t DicomList::numberOfThreads() const
+{
+    return m_nthreads;
+}
+
 void DicomList::print( std::ostream& os, const kvs::Indent& indent )
 {
     os << indent << "Filename : " << BaseClass::filename() << std::endl;
@@ -415,45 +574,92 @@ bool DicomList::read( const std::string& dirname )
         return false;
     }
 
-    // Read DICOM data file. (".dcm" only, if extension_check is true)
-    bool flag = false;
-
+    // Collect DICOM data files. (".dcm" only, if extension_check is true)
+    std::vector<std::string> filenames;
     kvs::FileList::const_iterator file = dir.fileList().begin();
     kvs::FileList::const_iterator last = dir.fileList().end();
     while ( file != last )
     {
-        if( m_extension_check )
+        if( !m_extension_check || file->extension() == "dcm" )
         {
-            if( file->extension() != "dcm" ) continue;
+            filenames.push_back( file->filePath( true ) );
         }
 
-        kvs::Dicom* dicom = new kvs::Dicom( file->filePath( true ) );
-        if( !flag )
+        ++file;
+    }
+
+    if( filenames.size() == 0 )
+    {
+        kvsMessageError( "DICOM file not found in %s.", dir.directoryPath().c_str() );
+        BaseClass::setSuccess( false );
+        return false;
+    }
+
+    this->clear();
+
+    // Scan the headers in parallel, and sort the slices by slice location
+    // so that the pixel data can be read in the order of the slices.
+    std::vector<kvs::Dicom*> list( filenames.size(), NULL );
+    ::Load( filenames, list, true, m_nthreads );
+
+    for( size_t i = 0; i < list.size(); i++ )
+    {
+        if( list[i]->isFailure() )
         {
-            m_row             = dicom->row();
-            m_column          = dicom->column();
-            m_slice_thickness = dicom->sliceThickness();
-            m_slice_spacing   = dicom->sliceSpacing();
-            m_pixel_spacing   = dicom->pixelSpacing();
-            m_min_raw_value   = dicom->minRawValue();
-            m_max_raw_value   = dicom->maxRawValue();
-            flag = true;
+            kvsMessageError( "Cannot read %s.", filenames[i].c_str() );
+            delete list[i];
+            continue;
         }
-        else
+
+        if( m_list.size() > 0 )
         {
-            if( m_row != dicom->row() || m_column != dicom->column() )
+            if( m_row != list[i]->row() || m_column != list[i]->column() )
             {
-                kvsMessageError( "Not correspond image size (%s).", file->filePath().c_str() );
+                kvsMessageError( "Not correspond image size (%s).", filenames[i].c_str() );
+                delete list[i];
                 continue;
             }
-
-            m_min_raw_value = kvs::Math::Min( m_min_raw_value, dicom->minRawValue() );
-            m_max_raw_value = kvs::Math::Max( m_max_raw_value, dicom->maxRawValue() );
+        }
+        else
+        {
+            m_row             = list[i]->row();
+            m_column          = list[i]->column();
+            m_slice_thickness = list[i]->sliceThickness();
+            m_slice_spacing   = list[i]->sliceSpacing();
+            m_pixel_spacing   = list[i]->pixelSpacing();
         }
 
-        m_list.push_back( dicom );
+        m_list.push_back( list[i] );
+    }
 
-        ++file;
+    if( m_list.size() == 0 )
+    {
+        BaseClass::setSuccess( false );
+        return false;
+    }
+
+    this->sort();
+
+    m_min_raw_value = 0;
+    m_max_raw_value = 0;
+    if( m_header_only ) return true;
+
+    // Read the pixel data in parallel.
+    ::Load( filenames, m_list, false, m_nthreads );
+
+    for( size_t i = 0; i < m_list.size(); i++ )
+    {
+        const kvs::Dicom* dicom = m_list[i];
+        if( dicom->isFailure() )
+        {
+            kvsMessageError( "Cannot read the pixel data of %s.", dicom->filename().c_str() );
+            BaseClass::setSuccess( false );
+            return false;
+        }
+
+        const bool first = ( i == 0 );
+        m_min_raw_value = first ? dicom->minRawValue() : kvs::Math::Min( m_min_raw_value, dicom->minRawValue() );
+        m_max_raw_value = first ? dicom->maxRawValue() : kvs::Math::Max( m_max_raw_value, dicom->maxRawValue() );
     }
 
     return true;
@@ -65,6 +65,8 @@ protected:
     int m_min_raw_value; ///< min. value of the raw data
     int m_max_raw_value; ///< max. value of the raw data
     bool m_extension_check; ///< check the file extension
+    bool m_header_only; ///< read the headers only (the pixel data is read by the importer)
+    size_t m_nthreads; ///< number of threads (0: number of processors)
 
 public:
 
@@ -96,6 +98,11 @@ public:
     int maxRawValue() const;
     void enableExtensionCheck();
     void disableExtensionCheck();
+    void enableHeaderOnly();
+    void disableHeaderOnly();
+    bool isHeaderOnly() const;
+    void setNumberOfThreads( const size_t nthreads );
+    size_t numberOfThreads() const;
 
     void sort()
     {
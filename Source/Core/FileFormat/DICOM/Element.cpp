@@ -110,7 +110,7 @@ std::ofstream& operator << ( std::ofstream& ofs, const Element& e )
  *  @return tag
  */
 /*===========================================================================*/
-dcm::Tag Element::tag() const
+const dcm::Tag& Element::tag() const
 {
     return m_tag;
 }
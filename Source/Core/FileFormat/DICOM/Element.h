@@ -65,7 +65,7 @@ public:
 
 public:
 
-    dcm::Tag tag() const;
+    const dcm::Tag& tag() const;
     dcm::VR vr() const;
     const dcm::Value& value() const;
     bool isKnown();
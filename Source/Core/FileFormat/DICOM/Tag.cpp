@@ -152,14 +152,12 @@ bool operator != ( const Tag& a, const Tag& b )
  *  @brief  '<' operator.
  *  @param  a [i] element tag
  *  @param  b [i] element tag
- *  @return true if the group ID and the element ID of a are less than b's
+ *  @return true if a precedes b in the order of the group ID and the element ID
  */
 /*===========================================================================*/
 bool operator < ( const Tag& a, const Tag& b )
 {
-    return
-        ( a.m_group_id   < b.m_group_id ) &&
-        ( a.m_element_id < b.m_element_id );
+    return a.key() < b.key();
 }
 
 /*===========================================================================*/
@@ -238,6 +236,16 @@ const std::string& Tag::name() const
     return m_name;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Get the key that packs the group ID and the element ID.
+ */
+/*===========================================================================*/
+unsigned int Tag::key() const
+{
+    return ( static_cast<unsigned int>( m_group_id ) << 16 ) | m_element_id;
+}
+
 /*===========================================================================*/
 /**
  *  @brief  Read the tag of the data element.
@@ -251,7 +259,9 @@ bool dcm::Tag::read( std::ifstream& ifs, const bool swap )
     const unsigned short group_id   = kvs::dcm::StreamReader::Get<unsigned short>( ifs, swap );
     const unsigned short element_id = kvs::dcm::StreamReader::Get<unsigned short>( ifs, swap );
 
-    *this = ::Dictionary[ kvs::dcm::Tag( group_id, element_id ) ];
+    const kvs::dcm::Tag* tag = ::Dictionary.find( group_id, element_id );
+    if ( tag ) { *this = *tag; }
+    else { *this = kvs::dcm::Tag( group_id, element_id ); }
 
     return true;
 }
@@ -63,6 +63,7 @@ public:
     unsigned short elementID() const;
     dcm::VRType vrType() const;
     const std::string& name() const;
+    unsigned int key() const;
 
 public:
 
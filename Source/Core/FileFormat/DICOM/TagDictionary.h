@@ -40,6 +40,10 @@ namespace dcm
 /*===========================================================================*/
 /**
  *  @brief  DICOM element tag dictionary class
+ *
+ *  The tags are indexed by an open-addressing hash table keyed on the
+ *  group and element IDs. The table is built once when the dictionary is
+ *  created, so that a tag can be looked up in constant time.
  */
 /*===========================================================================*/
 class TagDictionary
@@ -52,6 +56,8 @@ public:
 protected:
 
     Container m_container; ///< container
+    std::vector<int> m_table; ///< hash table (index to the container, or -1 for an empty slot)
+    unsigned int m_mask; ///< bit mask of the hash table size
 
 public:
 
@@ -61,11 +67,17 @@ public:
 public:
 
     dcm::Tag operator [] ( const dcm::Tag& key );
+    const dcm::Tag* find( const unsigned short group_id, const unsigned short element_id ) const;
 
 protected:
 
     void create();
     void clear();
+
+private:
+
+    void create_table();
+    unsigned int hash( const unsigned int key ) const;
 };
 
 /*===========================================================================*/
@@ -73,7 +85,8 @@ protected:
  *  @brief  Constructor.
  */
 /*===========================================================================*/
-inline TagDictionary::TagDictionary()
+inline TagDictionary::TagDictionary():
+    m_mask( 0 )
 {
     this->create();
 }
@@ -96,12 +109,35 @@ inline TagDictionary::~TagDictionary()
 /*===========================================================================*/
 inline dcm::Tag TagDictionary::operator [] ( const dcm::Tag& key )
 {
-    ContainerIterator i = std::find( m_container.begin(), m_container.end(), key );
+    const dcm::Tag* tag = this->find( key.groupID(), key.elementID() );
 
     return
-        i == m_container.end() ?
+        tag == NULL ?
         dcm::Tag( key.groupID(), key.elementID() ) :
-        *i;
+        *tag;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Find the tag.
+ *  @param  group_id   [i] group ID
+ *  @param  element_id [i] element ID
+ *  @return pointer to the tag in the dictionary (NULL if not found)
+ */
+/*===========================================================================*/
+inline const dcm::Tag* TagDictionary::find(
+    const unsigned short group_id,
+    const unsigned short element_id ) const
+{
+    if ( m_table.empty() ) return NULL;
+
+    const unsigned int key = ( static_cast<unsigned int>( group_id ) << 16 ) | element_id;
+    for ( unsigned int slot = this->hash( key ); ; slot = ( slot + 1 ) & m_mask )
+    {
+        const int index = m_table[ slot ];
+        if ( index < 0 ) return NULL;
+        if ( m_container[ index ].key() == key ) return &m_container[ index ];
+    }
 }
 
 /*===========================================================================*/
@@ -168,6 +204,48 @@ inline void TagDictionary::create()
         m_container.push_back( val );
     }
 */
+    this->create_table();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Create the hash table of the tags in the container.
+ */
+/*===========================================================================*/
+inline void TagDictionary::create_table()
+{
+    // The table size is a power of two, at least twice the number of tags,
+    // so that a probe sequence remains short.
+    unsigned int size = 16;
+    while ( size < 2 * m_container.size() ) size <<= 1;
+    m_mask = size - 1;
+    m_table.assign( size, -1 );
+
+    const int ntags = static_cast<int>( m_container.size() );
+    for ( int i = 0; i < ntags; i++ )
+    {
+        // The first entry is preferred to a duplicated one, as std::find did.
+        const unsigned int key = m_container[i].key();
+        unsigned int slot = this->hash( key );
+        while ( m_table[ slot ] >= 0 && m_container[ m_table[ slot ] ].key() != key )
+        {
+            slot = ( slot + 1 ) & m_mask;
+        }
+        if ( m_table[ slot ] < 0 ) m_table[ slot ] = i;
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Return the home slot of the key in the hash table.
+ *  @param  key [i] tag key
+ *  @return slot index
+ */
+/*===========================================================================*/
+inline unsigned int TagDictionary::hash( const unsigned int key ) const
+{
+    // Fibonacci hashing; the upper bits of the product are well mixed.
+    return ( ( key * 2654435761u ) >> 16 ) & m_mask;
 }
 
 /*===========================================================================*/
@@ -178,6 +256,7 @@ inline void TagDictionary::create()
 inline void TagDictionary::clear()
 {
     m_container.clear();
+    m_table.clear();
 }
 
 } // end of namespace dcm
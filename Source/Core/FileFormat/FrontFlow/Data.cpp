@@ -13,8 +13,50 @@
  */
 /*****************************************************************************/
 #include "Data.h"
+#include <cstdio>
 #include <cstring>
 #include <kvs/Endian>
+#include <kvs/Platform>
+
+
+namespace
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Return the 64-bit position of the file pointer.
+ *  @param  fp [in] file pointer
+ *  @return position in bytes (-1 if failed)
+ */
+/*===========================================================================*/
+kvs::Int64 Tell( FILE* fp )
+{
+#if defined( KVS_PLATFORM_WINDOWS )
+    return _ftelli64( fp );
+#else
+    return ftello( fp );
+#endif
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Move the file pointer by the 64-bit offset.
+ *  @param  fp [in] file pointer
+ *  @param  offset [in] offset in bytes
+ *  @param  origin [in] origin (SEEK_SET, SEEK_CUR or SEEK_END)
+ *  @return true, if the file pointer is moved successfully
+ */
+/*===========================================================================*/
+bool Seek( FILE* fp, const kvs::Int64 offset, const int origin )
+{
+#if defined( KVS_PLATFORM_WINDOWS )
+    return _fseeki64( fp, offset, origin ) == 0;
+#else
+    return fseeko( fp, static_cast<off_t>( offset ), origin ) == 0;
+#endif
+}
+
+} // end of namespace
 
 
 namespace kvs
@@ -28,7 +70,10 @@ namespace gf
  *  @brief  Construct a new Data class.
  */
 /*===========================================================================*/
-Data::Data()
+Data::Data():
+    m_num( 0 ),
+    m_num2( 0 ),
+    m_offset( -1 )
 {
 }
 
@@ -139,6 +184,18 @@ void Data::deallocate()
     m_num = 0;
     m_flt_array.release();
     m_int_array.release();
+    m_offset = -1;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Return offset to the data array in the file.
+ *  @return offset in bytes (-1 if the data array is not read as binary)
+ */
+/*===========================================================================*/
+kvs::Int64 Data::offset() const
+{
+    return m_offset;
 }
 
 /*===========================================================================*/
@@ -229,11 +286,12 @@ bool Data::readAscii( FILE* fp, const std::string tag )
 /**
  *  @brief  Read binary type file (Fortran unformated).
  *  @param  fp [in] file pointer
- *  @param  tag [in] header tag
+ *  @param  swap [in] flag for byte-swap
+ *  @param  header_only [in] if true, the data array is skipped and its offset is recorded
  *  @return true, if the reading process is done successfully
  */
 /*===========================================================================*/
-bool Data::readBinary( FILE* fp, const bool swap )
+bool Data::readBinary( FILE* fp, const bool swap, const bool header_only )
 {
     // Read an array-type-header (#FLT_ARY or #INT_ARY).
     char array_type_header[8];
@@ -271,6 +329,16 @@ bool Data::readBinary( FILE* fp, const bool swap )
     if ( swap ) kvs::Endian::Swap( &m_num );
     if ( swap ) kvs::Endian::Swap( &m_num2 );
 
+    // Skip 2D array. The array is read later from the offset.
+    if ( header_only )
+    {
+        const size_t size = size_t( m_num ) * m_num2;
+        fseek( fp, 4, SEEK_CUR );
+        m_offset = ::Tell( fp );
+        if ( m_offset < 0 ) return false;
+        return ::Seek( fp, kvs::Int64( size ) * 4 + 4, SEEK_CUR ); // kvs::Real32 or kvs::Int32
+    }
+
     // Read 2D array.
     if ( m_array_type_header == "#FLT_ARY" )
     {
@@ -43,6 +43,7 @@ private:
     kvs::Int32 m_num2; ///< num2 (number of elements)
     kvs::ValueArray<kvs::Real32> m_flt_array; ///< data array (float type)
     kvs::ValueArray<kvs::Int32> m_int_array; ///< data array (int type)
+    kvs::Int64 m_offset; ///< offset to the data array in the file (-1 if not recorded)
 
 public:
 
@@ -57,10 +58,11 @@ public:
     kvs::Int32 num2() const;
     const kvs::ValueArray<kvs::Real32>& fltArray() const;
     const kvs::ValueArray<kvs::Int32>& intArray() const;
+    kvs::Int64 offset() const;
     void deallocate();
 
     bool readAscii( FILE* fp, const std::string tag );
-    bool readBinary( FILE* fp, const bool swap = false );
+    bool readBinary( FILE* fp, const bool swap = false, const bool header_only = false );
 };
 
 } // end of namespace gf
@@ -172,10 +172,12 @@ bool DataSet::readAscii( FILE* fp )
 /**
  *  @brief  Read binary type file (Fortran unformated).
  *  @param  fp [in] file pointer
+ *  @param  swap [in] flag for byte-swap
+ *  @param  header_only [in] if true, the data arrays are skipped
  *  @return true, if the reading process is done successfully
  */
 /*===========================================================================*/
-bool DataSet::readBinary( FILE* fp, const bool swap )
+bool DataSet::readBinary( FILE* fp, const bool swap, const bool header_only )
 {
     // Read a number of comments.
     kvs::Int32 ncomments = 0;
@@ -213,7 +215,7 @@ bool DataSet::readBinary( FILE* fp, const bool swap )
              strncmp( buffer, "#NEW_SET", 8 ) == 0 ) { break; }
 
         kvs::gf::Data data;
-        if ( !data.readBinary( fp ) ) return false;
+        if ( !data.readBinary( fp, swap, header_only ) ) return false;
 
         m_data_list.push_back( data );
     }
@@ -52,7 +52,7 @@ public:
     void deallocate();
 
     bool readAscii( FILE* fp );
-    bool readBinary( FILE* fp, const bool swap = false );
+    bool readBinary( FILE* fp, const bool swap = false, const bool header_only = false );
 };
 
 } // end of namespace gf
@@ -30,7 +30,8 @@ namespace gf
  *  @brief  Construct a new File class.
  */
 /*===========================================================================*/
-File::File()
+File::File():
+    m_header_only( false )
 {
 }
 
@@ -40,7 +41,8 @@ File::File()
  *  @param  filename [in] filename
  */
 /*===========================================================================*/
-File::File( const std::string filename )
+File::File( const std::string filename ):
+    m_header_only( false )
 {
     this->read( filename );
 }
@@ -151,6 +153,41 @@ void File::deallocate()
     }
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Skip the data arrays of the binary file in reading.
+ *
+ *  The offsets of the data arrays in the file are recorded instead, so that
+ *  the arrays can be read later (see kvs::gf::Data::offset). The arrays of
+ *  the ascii file are always read.
+ */
+/*===========================================================================*/
+void File::enableHeaderOnly()
+{
+    m_header_only = true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Read the data arrays in reading (default).
+ */
+/*===========================================================================*/
+void File::disableHeaderOnly()
+{
+    m_header_only = false;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Return true if the data arrays are skipped in reading.
+ *  @return true, if the header only is enabled
+ */
+/*===========================================================================*/
+bool File::isHeaderOnly() const
+{
+    return m_header_only;
+}
+
 /*===========================================================================*/
 /**
  *  @brief  Read GF file.
@@ -351,7 +388,7 @@ bool File::read_binary( const std::string filename, const bool swap )
         if ( strncmp( buffer, "#NEW_SET", 8 ) == 0 )
         {
             kvs::gf::DataSet data_set;
-            if ( !data_set.readBinary( fp ) ) { fclose( fp ); return false; }
+            if ( !data_set.readBinary( fp, swap, m_header_only ) ) { fclose( fp ); return false; }
 
             m_data_set_list.push_back( data_set );
         }
@@ -38,6 +38,7 @@ private:
     std::string m_file_type_header; ///< file type header
     std::vector<std::string> m_comment_list; ///< comment list
     std::vector<kvs::gf::DataSet> m_data_set_list; ///< data set list
+    bool m_header_only; ///< if true, the data arrays of the binary file are not read
 
 public:
 
@@ -53,6 +54,10 @@ public:
     const kvs::gf::DataSet& dataSet( const size_t index ) const;
     void deallocate();
 
+    void enableHeaderOnly();
+    void disableHeaderOnly();
+    bool isHeaderOnly() const;
+
     bool read( const std::string filename );
 
 private:
@@ -14,7 +14,50 @@
 /*****************************************************************************/
 #include "FlowData.h"
 #include "File.h"
+#include <cstdio>
 #include <kvs/Assert>
+#include <kvs/Message>
+#include <kvs/Platform>
+
+
+namespace
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Move the file pointer to the 64-bit offset from the beginning.
+ *  @param  fp [in] file pointer
+ *  @param  offset [in] offset in bytes
+ *  @return true, if the file pointer is moved successfully
+ */
+/*===========================================================================*/
+bool Seek( FILE* fp, const kvs::Int64 offset )
+{
+#if defined( KVS_PLATFORM_WINDOWS )
+    return _fseeki64( fp, offset, SEEK_SET ) == 0;
+#else
+    return fseeko( fp, static_cast<off_t>( offset ), SEEK_SET ) == 0;
+#endif
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Read the data array at the offset of the file.
+ *  @param  fp [in] file pointer
+ *  @param  offset [in] offset to the data array
+ *  @param  size [in] number of values
+ *  @param  data [out] pointer to the values
+ *  @return true, if the reading process is done successfully
+ */
+/*===========================================================================*/
+template <typename T>
+bool ReadArray( FILE* fp, const kvs::Int64 offset, const size_t size, T* data )
+{
+    if ( !::Seek( fp, offset ) ) return false;
+    return fread( data, sizeof(T), size, fp ) == size;
+}
+
+} // end of namespace
 
 
 namespace kvs
@@ -36,7 +79,8 @@ FlowData::FlowData():
     m_times( NULL ),
     m_steps( NULL ),
     m_velocities( NULL ),
-    m_pressures( NULL )
+    m_pressures( NULL ),
+    m_header_only( false )
 {
 }
 
@@ -54,7 +98,8 @@ FlowData::FlowData( const std::string filename ):
     m_times( NULL ),
     m_steps( NULL ),
     m_velocities( NULL ),
-    m_pressures( NULL )
+    m_pressures( NULL ),
+    m_header_only( false )
 {
     this->read( filename );
 }
@@ -168,6 +213,57 @@ const kvs::ValueArray<kvs::Real32>& FlowData::pressures( const size_t index ) co
     return m_pressures[ index ];
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Return true if the value array of the variable has been read.
+ *  @param  index [in] index of time step
+ *  @param  variable [in] variable
+ *  @return true, if the value array has been read
+ */
+/*===========================================================================*/
+bool FlowData::isLoaded( const size_t index, const Variable variable ) const
+{
+    KVS_ASSERT( index < m_nsteps );
+    const kvs::ValueArray<kvs::Real32>& values = ( variable == Velocity ) ? m_velocities[ index ] : m_pressures[ index ];
+    return values.size() > 0;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Read only the index of the value arrays in read().
+ *
+ *  The file offsets of the velocity and pressure arrays of all the time
+ *  steps are recorded in one pass, and the arrays are read on demand by
+ *  load(). The times and the steps are read in read(). The value arrays of
+ *  the ascii file are always read.
+ */
+/*===========================================================================*/
+void FlowData::enableHeaderOnly()
+{
+    m_header_only = true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Read all the value arrays in read() (default).
+ */
+/*===========================================================================*/
+void FlowData::disableHeaderOnly()
+{
+    m_header_only = false;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Return true if only the index of the value arrays is read.
+ *  @return true, if the header only is enabled
+ */
+/*===========================================================================*/
+bool FlowData::isHeaderOnly() const
+{
+    return m_header_only;
+}
+
 void FlowData::print( std::ostream& os, const kvs::Indent& indent ) const
 {
     os << indent << "Dimensions : " << m_dimensions << std::endl;
@@ -186,6 +282,7 @@ void FlowData::print( std::ostream& os, const kvs::Indent& indent ) const
 bool FlowData::read( const std::string filename )
 {
     kvs::gf::File file;
+    if ( m_header_only ) file.enableHeaderOnly();
     if ( !file.read( filename ) )
     {
         kvsMessageError("Cannot read mesh data file.");
@@ -197,12 +294,22 @@ bool FlowData::read( const std::string filename )
     if ( m_velocities ) delete [] m_velocities;
     if ( m_pressures ) delete [] m_pressures;
 
+    m_filename = filename;
     m_nsteps = file.dataSetList().size();
     m_times = new kvs::Real32 [ m_nsteps ];
     m_steps = new kvs::Int32 [ m_nsteps ];
     m_velocities = new kvs::ValueArray<kvs::Real32> [ m_nsteps ];
     m_pressures = new kvs::ValueArray<kvs::Real32> [ m_nsteps ];
 
+    const Block empty = { -1, 0 };
+    m_velocity_blocks.assign( m_nsteps, empty );
+    m_pressure_blocks.assign( m_nsteps, empty );
+
+    // The time and step values skipped in the header only mode are read
+    // from the file.
+    FILE* fp = m_header_only ? fopen( filename.c_str(), "rb" ) : NULL;
+    bool success = !m_header_only || fp;
+
     for ( size_t i = 0; i < m_nsteps; i++ )
     {
         const kvs::gf::DataSet& data_set = file.dataSet(i);
@@ -211,13 +318,15 @@ bool FlowData::read( const std::string filename )
             const kvs::gf::Data& data = data_set.data(j);
             const std::string& keyword = data.keyword();
             const std::string& type = data.arrayTypeHeader();
+            const bool skipped = data.offset() >= 0;
 
             // Read time.
             if ( keyword == "*TIME_PS" )
             {
                 if ( type == "#FLT_ARY" )
                 {
-                    m_times[i] = data.fltArray().front();
+                    if ( !skipped ) { m_times[i] = data.fltArray().front(); }
+                    else if ( fp ) { success &= ::ReadArray( fp, data.offset(), 1, &m_times[i] ); }
                 }
             }
 
@@ -226,7 +335,8 @@ bool FlowData::read( const std::string filename )
             {
                 if ( type == "#INT_ARY" )
                 {
-                    m_steps[i] = data.intArray().front();
+                    if ( !skipped ) { m_steps[i] = data.intArray().front(); }
+                    else if ( fp ) { success &= ::ReadArray( fp, data.offset(), 1, &m_steps[i] ); }
                 }
             }
 
@@ -237,7 +347,9 @@ bool FlowData::read( const std::string filename )
                 {
                     m_dimensions = data.num();
                     m_nnodes = data.num2();
-                    m_velocities[i] = data.fltArray();
+                    m_velocity_blocks[i].offset = data.offset();
+                    m_velocity_blocks[i].size = size_t( data.num() ) * data.num2();
+                    if ( !skipped ) { m_velocities[i] = data.fltArray(); }
                 }
             }
 
@@ -247,15 +359,87 @@ bool FlowData::read( const std::string filename )
                 if ( type == "#FLT_ARY" )
                 {
                     m_nelements = data.num2();
-                    m_pressures[i] = data.fltArray();
+                    m_pressure_blocks[i].offset = data.offset();
+                    m_pressure_blocks[i].size = size_t( data.num() ) * data.num2();
+                    if ( !skipped ) { m_pressures[i] = data.fltArray(); }
                 }
             }
         }
     }
 
+    if ( fp ) fclose( fp );
+    if ( !success )
+    {
+        kvsMessageError("Cannot read the time steps of %s.", filename.c_str());
+        return false;
+    }
+
     return true;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Read the value array of the variable at the time step.
+ *  @param  index [in] index of time step
+ *  @param  variable [in] variable
+ *  @return true, if the value array is read successfully
+ *
+ *  The value array is read from the offset recorded in read() with the
+ *  header only mode. Nothing is done if the array has already been read.
+ */
+/*===========================================================================*/
+bool FlowData::load( const size_t index, const Variable variable )
+{
+    KVS_ASSERT( index < m_nsteps );
+
+    kvs::ValueArray<kvs::Real32>& values = ( variable == Velocity ) ? m_velocities[ index ] : m_pressures[ index ];
+    if ( values.size() > 0 ) return true;
+
+    const Block& block = ( variable == Velocity ) ? m_velocity_blocks[ index ] : m_pressure_blocks[ index ];
+    if ( block.offset < 0 || block.size == 0 )
+    {
+        kvsMessageError("Time step %d has no %s values.", int( index ), variable == Velocity ? "velocity" : "pressure");
+        return false;
+    }
+
+    FILE* fp = fopen( m_filename.c_str(), "rb" );
+    if ( !fp )
+    {
+        kvsMessageError("Cannot open %s.", m_filename.c_str());
+        return false;
+    }
+
+    kvs::ValueArray<kvs::Real32> array( block.size );
+    const bool success = ::ReadArray( fp, block.offset, block.size, array.data() );
+    fclose( fp );
+
+    if ( !success )
+    {
+        kvsMessageError("Cannot read the values of time step %d.", int( index ));
+        return false;
+    }
+
+    values = array;
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Release the value array of the variable at the time step.
+ *  @param  index [in] index of time step
+ *  @param  variable [in] variable
+ *
+ *  The released array can be read again by load() in the header only mode.
+ */
+/*===========================================================================*/
+void FlowData::release( const size_t index, const Variable variable )
+{
+    KVS_ASSERT( index < m_nsteps );
+
+    if ( variable == Velocity ) { m_velocities[ index ].release(); }
+    else { m_pressures[ index ].release(); }
+}
+
 } // end of namespace gf
 
 } // end of namespace kvs
@@ -16,6 +16,7 @@
 #define KVS__GF__FLOW_DATA_H_INCLUDE
 
 #include <string>
+#include <vector>
 #include <kvs/Type>
 #include <kvs/ValueArray>
 #include <kvs/Indent>
@@ -34,8 +35,22 @@ namespace gf
 /*===========================================================================*/
 class FlowData
 {
+public:
+
+    enum Variable
+    {
+        Velocity = 0, ///< velocity values
+        Pressure ///< pressure values
+    };
+
 private:
 
+    struct Block
+    {
+        kvs::Int64 offset; ///< offset to the array in the file (-1 if not recorded)
+        size_t size; ///< number of values of the array
+    };
+
     size_t m_dimensions; ///< dimensions (2 or 3)
     size_t m_nnodes; ///< number of nodes
     size_t m_nelements; ///< number of elements
@@ -44,6 +59,10 @@ private:
     kvs::Int32* m_steps; ///< step values
     kvs::ValueArray<kvs::Real32>* m_velocities; ///< velocity values
     kvs::ValueArray<kvs::Real32>* m_pressures; ///< pressure values
+    std::string m_filename; ///< filename
+    bool m_header_only; ///< if true, the value arrays are not read
+    std::vector<Block> m_velocity_blocks; ///< velocity arrays in the file
+    std::vector<Block> m_pressure_blocks; ///< pressure arrays in the file
 
 public:
 
@@ -59,9 +78,16 @@ public:
     kvs::Int32 step( const size_t index ) const;
     const kvs::ValueArray<kvs::Real32>& velocities( const size_t index ) const;
     const kvs::ValueArray<kvs::Real32>& pressures( const size_t index ) const;
+    bool isLoaded( const size_t index, const Variable variable ) const;
+
+    void enableHeaderOnly();
+    void disableHeaderOnly();
+    bool isHeaderOnly() const;
 
     void print( std::ostream& os, const kvs::Indent& indent = kvs::Indent(0) ) const;
     bool read( const std::string filename );
+    bool load( const size_t index, const Variable variable );
+    void release( const size_t index, const Variable variable );
 };
 
 } // end of namespace gf
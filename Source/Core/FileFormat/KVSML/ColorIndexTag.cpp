@@ -0,0 +1,35 @@
+/*****************************************************************************/
+/**
+ *  @file   ColorIndexTag.cpp
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#include "ColorIndexTag.h"
+
+
+namespace kvs
+{
+
+namespace kvsml
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new color index tag class.
+ */
+/*===========================================================================*/
+ColorIndexTag::ColorIndexTag():
+    kvs::kvsml::TagBase( "ColorIndex" )
+{
+}
+
+} // end of namespace kvsml
+
+} // end of namespace kvs
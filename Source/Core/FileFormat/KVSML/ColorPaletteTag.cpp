@@ -0,0 +1,119 @@
+/*****************************************************************************/
+/**
+ *  @file   ColorPaletteTag.cpp
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#include "ColorPaletteTag.h"
+#include <kvs/Message>
+#include <kvs/String>
+#include <kvs/XMLNode>
+#include <kvs/XMLElement>
+
+
+namespace kvs
+{
+
+namespace kvsml
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new color palette tag class.
+ */
+/*===========================================================================*/
+ColorPaletteTag::ColorPaletteTag():
+    kvs::kvsml::TagBase( "ColorPalette" ),
+    m_has_ncolors( false ),
+    m_ncolors( 0 )
+{
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Tests whether the color palette tag has the 'ncolors' attribute value.
+ *  @return true, if the color palette tag has the 'ncolors' attribute value
+ */
+/*===========================================================================*/
+bool ColorPaletteTag::hasNColors() const
+{
+    return m_has_ncolors;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns a number of colors.
+ *  @return number of colors
+ */
+/*===========================================================================*/
+size_t ColorPaletteTag::ncolors() const
+{
+    return m_ncolors;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sets a number of colors.
+ *  @param  ncolors [in] number of colors
+ */
+/*===========================================================================*/
+void ColorPaletteTag::setNColors( const size_t ncolors )
+{
+    m_has_ncolors = true;
+    m_ncolors = ncolors;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Reads the color palette tag.
+ *  @param  parent [in] pointer to the parent node
+ *  @return true, if the reading process is done successfully
+ */
+/*===========================================================================*/
+bool ColorPaletteTag::read( const kvs::XMLNode::SuperClass* parent )
+{
+    BaseClass::read( parent );
+
+    // Element
+    const kvs::XMLElement::SuperClass* element = kvs::XMLNode::ToElement( BaseClass::m_node );
+
+    // ncolors="xxx"
+    const std::string ncolors = kvs::XMLElement::AttributeValue( element, "ncolors" );
+    if ( ncolors != "" )
+    {
+        m_has_ncolors = true;
+        m_ncolors = static_cast<size_t>( atoi( ncolors.c_str() ) );
+    }
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Writes the color palette tag.
+ *  @param  parent [in] pointer to the parent node
+ *  @return true, if the writing process is done successfully
+ */
+/*===========================================================================*/
+bool ColorPaletteTag::write( kvs::XMLNode::SuperClass* parent )
+{
+    kvs::XMLElement element( BaseClass::name() );
+
+    if ( m_has_ncolors )
+    {
+        element.setAttribute( "ncolors", m_ncolors );
+    }
+
+    return BaseClass::write_with_element( parent, element );
+}
+
+} // end of namespace kvsml
+
+} // end of namespace kvs
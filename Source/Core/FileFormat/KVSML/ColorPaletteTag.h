@@ -0,0 +1,66 @@
+/*****************************************************************************/
+/**
+ *  @file   ColorPaletteTag.h
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#ifndef KVS__KVSML__COLOR_PALETTE_TAG_H_INCLUDE
+#define KVS__KVSML__COLOR_PALETTE_TAG_H_INCLUDE
+
+#include <kvs/XMLNode>
+#include "TagBase.h"
+
+
+namespace kvs
+{
+
+namespace kvsml
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Tag class for <ColorPalette>
+ */
+/*===========================================================================*/
+class ColorPaletteTag : public kvs::kvsml::TagBase
+{
+public:
+
+    typedef kvs::kvsml::TagBase BaseClass;
+
+private:
+
+    bool m_has_ncolors; ///< flag to check whether 'ncolors' is specified or not
+    size_t m_ncolors; ///< number of colors
+
+public:
+
+    ColorPaletteTag();
+
+public:
+
+    bool hasNColors() const;
+    size_t ncolors() const;
+
+public:
+
+    void setNColors( const size_t ncolors );
+
+public:
+
+    bool read( const kvs::XMLNode::SuperClass* parent );
+    bool write( kvs::XMLNode::SuperClass* parent );
+};
+
+} // end of namespace kvsml
+
+} // end of namespace kvs
+
+#endif // KVS__KVSML__COLOR_PALETTE_TAG_H_INCLUDE
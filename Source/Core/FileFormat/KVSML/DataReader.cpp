@@ -19,6 +19,10 @@
 #include "SizeTag.h"
 #include "ConnectionTag.h"
 #include "OpacityTag.h"
+#include "QuantizedCoordTag.h"
+#include "EncodedNormalTag.h"
+#include "ColorIndexTag.h"
+#include "ColorPaletteTag.h"
 #include "DataArrayTag.h"
 #include "DataValueTag.h"
 #include <kvs/Message>
@@ -264,6 +268,157 @@ bool ReadConnectionData(
     return true;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Reads quantized coordinate data from <QuantizedCoord>.
+ *  @param  parent  [in] pointer to the parent node
+ *  @param  ncoords [in] number of coordinates
+ *  @param  coords [out] pointer to the quantized coordinate value array
+ *  @param  min_coord [out] pointer to the coordinate of the quantized value 0
+ *  @param  max_coord [out] pointer to the coordinate of the max. quantized value
+ *  @return true, if the reading process is done successfully
+ */
+/*===========================================================================*/
+bool ReadQuantizedCoordData(
+    const kvs::XMLNode::SuperClass* parent,
+    const size_t ncoords,
+    kvs::ValueArray<kvs::UInt16>* coords,
+    kvs::Vec3* min_coord,
+    kvs::Vec3* max_coord )
+{
+    // <QuantizedCoord>
+    kvs::kvsml::QuantizedCoordTag coord_tag;
+    if ( coord_tag.isExisted( parent ) )
+    {
+        if ( !coord_tag.read( parent ) )
+        {
+            kvsMessageError( "Cannot read <%s>.", coord_tag.name().c_str() );
+            return false;
+        }
+
+        if ( !coord_tag.hasRange() )
+        {
+            kvsMessageError( "'range' is not specified in <%s>.", coord_tag.name().c_str() );
+            return false;
+        }
+
+        *min_coord = coord_tag.minCoord();
+        *max_coord = coord_tag.maxCoord();
+
+        // <DataArray>
+        const size_t dimension = 3;
+        const size_t nelements = ncoords * dimension;
+        kvs::kvsml::DataArrayTag data_tag;
+        if ( !data_tag.read( coord_tag.node(), nelements, coords ) )
+        {
+            kvsMessageError( "Cannot read <%s> for <%s>.",
+                             data_tag.name().c_str(),
+                             coord_tag.name().c_str() );
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Reads encoded normal data from <EncodedNormal>.
+ *  @param  parent  [in] pointer to the parent node
+ *  @param  nnormals [in] number of normals
+ *  @param  normals [out] pointer to the encoded normal value array
+ *  @return true, if the reading process is done successfully
+ */
+/*===========================================================================*/
+bool ReadEncodedNormalData(
+    const kvs::XMLNode::SuperClass* parent,
+    const size_t nnormals,
+    kvs::ValueArray<kvs::UInt16>* normals )
+{
+    // <EncodedNormal>
+    kvs::kvsml::EncodedNormalTag normal_tag;
+    if ( normal_tag.isExisted( parent ) )
+    {
+        if ( !normal_tag.read( parent ) )
+        {
+            kvsMessageError( "Cannot read <%s>.", normal_tag.name().c_str() );
+            return false;
+        }
+
+        // <DataArray>
+        kvs::kvsml::DataArrayTag data_tag;
+        if ( !data_tag.read( normal_tag.node(), nnormals, normals ) )
+        {
+            kvsMessageError( "Cannot read <%s> for <%s>.",
+                             data_tag.name().c_str(),
+                             normal_tag.name().c_str() );
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Reads color index data from <ColorIndex> and <ColorPalette>.
+ *  @param  parent  [in] pointer to the parent node
+ *  @param  nindices [in] number of color indices
+ *  @param  indices [out] pointer to the color index array
+ *  @param  palette [out] pointer to the color palette (r,g,b)
+ *  @return true, if the reading process is done successfully
+ */
+/*===========================================================================*/
+bool ReadColorIndexData(
+    const kvs::XMLNode::SuperClass* parent,
+    const size_t nindices,
+    kvs::ValueArray<kvs::UInt8>* indices,
+    kvs::ValueArray<kvs::UInt8>* palette )
+{
+    // <ColorIndex>
+    kvs::kvsml::ColorIndexTag index_tag;
+    if ( index_tag.isExisted( parent ) )
+    {
+        if ( !index_tag.read( parent ) )
+        {
+            kvsMessageError( "Cannot read <%s>.", index_tag.name().c_str() );
+            return false;
+        }
+
+        // <DataArray>
+        kvs::kvsml::DataArrayTag data_tag;
+        if ( !data_tag.read( index_tag.node(), nindices, indices ) )
+        {
+            kvsMessageError( "Cannot read <%s> for <%s>.",
+                             data_tag.name().c_str(),
+                             index_tag.name().c_str() );
+            return false;
+        }
+
+        // <ColorPalette ncolors="xxx">
+        kvs::kvsml::ColorPaletteTag palette_tag;
+        if ( !palette_tag.isExisted( parent ) || !palette_tag.read( parent ) || !palette_tag.hasNColors() )
+        {
+            kvsMessageError( "Cannot read <%s>.", palette_tag.name().c_str() );
+            return false;
+        }
+
+        // <DataArray>
+        const size_t nchannels = 3; // RGB
+        const size_t nelements = palette_tag.ncolors() * nchannels;
+        kvs::kvsml::DataArrayTag palette_data_tag;
+        if ( !palette_data_tag.read( palette_tag.node(), nelements, palette ) )
+        {
+            kvsMessageError( "Cannot read <%s> for <%s>.",
+                             palette_data_tag.name().c_str(),
+                             palette_tag.name().c_str() );
+            return false;
+        }
+    }
+
+    return true;
+}
+
 /*===========================================================================*/
 /**
  *  @brief  Reads opacity data from <Opacity>.
@@ -17,6 +17,7 @@
 #include <kvs/ValueArray>
 #include <kvs/XMLNode>
 #include <kvs/Type>
+#include <kvs/Vector3>
 
 
 namespace kvs
@@ -50,6 +51,24 @@ bool ReadConnectionData(
     const size_t nconnections,
     kvs::ValueArray<kvs::UInt32>* connections );
 
+bool ReadQuantizedCoordData(
+    const kvs::XMLNode::SuperClass* parent,
+    const size_t ncoords,
+    kvs::ValueArray<kvs::UInt16>* coords,
+    kvs::Vec3* min_coord,
+    kvs::Vec3* max_coord );
+
+bool ReadEncodedNormalData(
+    const kvs::XMLNode::SuperClass* parent,
+    const size_t nnormals,
+    kvs::ValueArray<kvs::UInt16>* normals );
+
+bool ReadColorIndexData(
+    const kvs::XMLNode::SuperClass* parent,
+    const size_t nindices,
+    kvs::ValueArray<kvs::UInt8>* indices,
+    kvs::ValueArray<kvs::UInt8>* palette );
+
 bool ReadOpacityData(
     const kvs::XMLNode::SuperClass* parent,
     const size_t nopacities,
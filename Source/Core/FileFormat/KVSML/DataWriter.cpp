@@ -19,6 +19,10 @@
 #include "SizeTag.h"
 #include "ConnectionTag.h"
 #include "OpacityTag.h"
+#include "QuantizedCoordTag.h"
+#include "EncodedNormalTag.h"
+#include "ColorIndexTag.h"
+#include "ColorPaletteTag.h"
 #include "DataArrayTag.h"
 #include "DataValueTag.h"
 #include <kvs/Message>
@@ -337,6 +341,203 @@ bool WriteConnectionData(
     return true;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Writes quantized coordinate data to <QuantizedCoord>.
+ *  @param  parent [out] pointer to the parent node
+ *  @param  writing_type [in] writing data type
+ *  @param  filename [in] filename
+ *  @param  coords [in] quantized coordinate value array
+ *  @param  min_coord [in] coordinate of the quantized value 0
+ *  @param  max_coord [in] coordinate of the max. quantized value
+ *  @return true, if the writing process is done successfully
+ */
+/*===========================================================================*/
+bool WriteQuantizedCoordData(
+    kvs::XMLNode::SuperClass* parent,
+    const kvs::kvsml::WritingDataType writing_type,
+    const std::string& filename,
+    const kvs::ValueArray<kvs::UInt16>& coords,
+    const kvs::Vec3& min_coord,
+    const kvs::Vec3& max_coord )
+{
+    // <QuantizedCoord range="xxx xxx xxx xxx xxx xxx">
+    if ( coords.size() > 0 )
+    {
+        kvs::kvsml::QuantizedCoordTag coord_tag;
+        coord_tag.setRange( min_coord, max_coord );
+        if ( !coord_tag.write( parent ) )
+        {
+            kvsMessageError( "Cannot write <%s>.", coord_tag.name().c_str() );
+            return false;
+        }
+
+        // <DataArray>
+        kvs::kvsml::DataArrayTag data_tag;
+        if ( writing_type == kvs::kvsml::ExternalAscii )
+        {
+            data_tag.setFile( kvs::kvsml::DataArray::GetDataFilename( filename, "coord" ) );
+            data_tag.setFormat( "ascii" );
+        }
+        else if ( writing_type == kvs::kvsml::ExternalBinary )
+        {
+            data_tag.setFile( kvs::kvsml::DataArray::GetDataFilename( filename, "coord" ) );
+            data_tag.setFormat( "binary" );
+        }
+
+        const std::string pathname = kvs::File( filename ).pathName();
+        if ( !data_tag.write( coord_tag.node(), coords, pathname ) )
+        {
+            kvsMessageError( "Cannot write <%s> for <%s>.",
+                             data_tag.name().c_str(),
+                             coord_tag.name().c_str() );
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Writes encoded normal data to <EncodedNormal>.
+ *  @param  parent [out] pointer to the parent node
+ *  @param  writing_type [in] writing data type
+ *  @param  filename [in] filename
+ *  @param  normals [in] encoded normal value array
+ *  @return true, if the writing process is done successfully
+ */
+/*===========================================================================*/
+bool WriteEncodedNormalData(
+    kvs::XMLNode::SuperClass* parent,
+    const kvs::kvsml::WritingDataType writing_type,
+    const std::string& filename,
+    const kvs::ValueArray<kvs::UInt16>& normals )
+{
+    // <EncodedNormal>
+    if ( normals.size() > 0 )
+    {
+        kvs::kvsml::EncodedNormalTag normal_tag;
+        if ( !normal_tag.write( parent ) )
+        {
+            kvsMessageError( "Cannot write <%s>.", normal_tag.name().c_str() );
+            return false;
+        }
+
+        // <DataArray>
+        kvs::kvsml::DataArrayTag data_tag;
+        if ( writing_type == kvs::kvsml::ExternalAscii )
+        {
+            data_tag.setFile( kvs::kvsml::DataArray::GetDataFilename( filename, "normal" ) );
+            data_tag.setFormat( "ascii" );
+        }
+        else if ( writing_type == kvs::kvsml::ExternalBinary )
+        {
+            data_tag.setFile( kvs::kvsml::DataArray::GetDataFilename( filename, "normal" ) );
+            data_tag.setFormat( "binary" );
+        }
+
+        const std::string pathname = kvs::File( filename ).pathName();
+        if ( !data_tag.write( normal_tag.node(), normals, pathname ) )
+        {
+            kvsMessageError( "Cannot write <%s> for <%s>.",
+                             data_tag.name().c_str(),
+                             normal_tag.name().c_str() );
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Writes color index data to <ColorIndex> and <ColorPalette>.
+ *  @param  parent [out] pointer to the parent node
+ *  @param  writing_type [in] writing data type
+ *  @param  filename [in] filename
+ *  @param  indices [in] color index array
+ *  @param  palette [in] color palette (r,g,b)
+ *  @return true, if the writing process is done successfully
+ */
+/*===========================================================================*/
+bool WriteColorIndexData(
+    kvs::XMLNode::SuperClass* parent,
+    const kvs::kvsml::WritingDataType writing_type,
+    const std::string& filename,
+    const kvs::ValueArray<kvs::UInt8>& indices,
+    const kvs::ValueArray<kvs::UInt8>& palette )
+{
+    // <ColorIndex>
+    if ( indices.size() > 0 )
+    {
+        kvs::kvsml::ColorIndexTag index_tag;
+        if ( !index_tag.write( parent ) )
+        {
+            kvsMessageError( "Cannot write <%s>.", index_tag.name().c_str() );
+            return false;
+        }
+
+        // <DataArray>
+        kvs::kvsml::DataArrayTag data_tag;
+        if ( writing_type == kvs::kvsml::ExternalAscii )
+        {
+            data_tag.setFile( kvs::kvsml::DataArray::GetDataFilename( filename, "color_index" ) );
+            data_tag.setFormat( "ascii" );
+        }
+        else if ( writing_type == kvs::kvsml::ExternalBinary )
+        {
+            data_tag.setFile( kvs::kvsml::DataArray::GetDataFilename( filename, "color_index" ) );
+            data_tag.setFormat( "binary" );
+        }
+
+        const std::string pathname = kvs::File( filename ).pathName();
+        if ( !data_tag.write( index_tag.node(), indices, pathname ) )
+        {
+            kvsMessageError( "Cannot write <%s> for <%s>.",
+                             data_tag.name().c_str(),
+                             index_tag.name().c_str() );
+            return false;
+        }
+    }
+
+    // <ColorPalette ncolors="xxx">
+    if ( palette.size() > 0 )
+    {
+        kvs::kvsml::ColorPaletteTag palette_tag;
+        palette_tag.setNColors( palette.size() / 3 );
+        if ( !palette_tag.write( parent ) )
+        {
+            kvsMessageError( "Cannot write <%s>.", palette_tag.name().c_str() );
+            return false;
+        }
+
+        // <DataArray>
+        kvs::kvsml::DataArrayTag data_tag;
+        if ( writing_type == kvs::kvsml::ExternalAscii )
+        {
+            data_tag.setFile( kvs::kvsml::DataArray::GetDataFilename( filename, "color_palette" ) );
+            data_tag.setFormat( "ascii" );
+        }
+        else if ( writing_type == kvs::kvsml::ExternalBinary )
+        {
+            data_tag.setFile( kvs::kvsml::DataArray::GetDataFilename( filename, "color_palette" ) );
+            data_tag.setFormat( "binary" );
+        }
+
+        const std::string pathname = kvs::File( filename ).pathName();
+        if ( !data_tag.write( palette_tag.node(), palette, pathname ) )
+        {
+            kvsMessageError( "Cannot write <%s> for <%s>.",
+                             data_tag.name().c_str(),
+                             palette_tag.name().c_str() );
+            return false;
+        }
+    }
+
+    return true;
+}
+
 /*===========================================================================*/
 /**
  *  @brief  Writes opacity data to <Coord>.
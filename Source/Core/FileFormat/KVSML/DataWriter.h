@@ -17,6 +17,7 @@
 #include <kvs/ValueArray>
 #include <kvs/XMLNode>
 #include <kvs/Type>
+#include <kvs/Vector3>
 
 
 namespace kvs
@@ -62,6 +63,27 @@ bool WriteConnectionData(
     const std::string& filename,
     const kvs::ValueArray<kvs::UInt32>& connections );
 
+bool WriteQuantizedCoordData(
+    kvs::XMLNode::SuperClass* parent,
+    const kvs::kvsml::WritingDataType writing_type,
+    const std::string& filename,
+    const kvs::ValueArray<kvs::UInt16>& coords,
+    const kvs::Vec3& min_coord,
+    const kvs::Vec3& max_coord );
+
+bool WriteEncodedNormalData(
+    kvs::XMLNode::SuperClass* parent,
+    const kvs::kvsml::WritingDataType writing_type,
+    const std::string& filename,
+    const kvs::ValueArray<kvs::UInt16>& normals );
+
+bool WriteColorIndexData(
+    kvs::XMLNode::SuperClass* parent,
+    const kvs::kvsml::WritingDataType writing_type,
+    const std::string& filename,
+    const kvs::ValueArray<kvs::UInt8>& indices,
+    const kvs::ValueArray<kvs::UInt8>& palette );
+
 bool WriteOpacityData(
     kvs::XMLNode::SuperClass* parent,
     const kvs::kvsml::WritingDataType writing_type,
@@ -0,0 +1,35 @@
+/*****************************************************************************/
+/**
+ *  @file   EncodedNormalTag.cpp
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#include "EncodedNormalTag.h"
+
+
+namespace kvs
+{
+
+namespace kvsml
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new encoded normal tag class.
+ */
+/*===========================================================================*/
+EncodedNormalTag::EncodedNormalTag():
+    kvs::kvsml::TagBase( "EncodedNormal" )
+{
+}
+
+} // end of namespace kvsml
+
+} // end of namespace kvs
@@ -95,7 +95,9 @@ bool KVSMLObjectPoint::CheckFormat( const std::string& filename )
  */
 /*===========================================================================*/
 KVSMLObjectPoint::KVSMLObjectPoint():
-    m_writing_type( kvs::KVSMLObjectPoint::Ascii )
+    m_writing_type( kvs::KVSMLObjectPoint::Ascii ),
+    m_min_coord( 0.0f, 0.0f, 0.0f ),
+    m_max_coord( 0.0f, 0.0f, 0.0f )
 {
 }
 
@@ -106,11 +108,46 @@ KVSMLObjectPoint::KVSMLObjectPoint():
  */
 /*===========================================================================*/
 KVSMLObjectPoint::KVSMLObjectPoint( const std::string& filename ):
-    m_writing_type( kvs::KVSMLObjectPoint::Ascii )
+    m_writing_type( kvs::KVSMLObjectPoint::Ascii ),
+    m_min_coord( 0.0f, 0.0f, 0.0f ),
+    m_max_coord( 0.0f, 0.0f, 0.0f )
 {
     this->read( filename );
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Sets the quantized coordinate array.
+ *  @param  coords [in] quantized coordinate array
+ *  @param  min_coord [in] coordinate of the quantized value 0
+ *  @param  max_coord [in] coordinate of the max. quantized value
+ */
+/*===========================================================================*/
+void KVSMLObjectPoint::setQuantizedCoords(
+    const kvs::ValueArray<kvs::UInt16>& coords,
+    const kvs::Vec3& min_coord,
+    const kvs::Vec3& max_coord )
+{
+    m_quantized_coords = coords;
+    m_min_coord = min_coord;
+    m_max_coord = max_coord;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sets the color index array and the color palette.
+ *  @param  indices [in] color index array
+ *  @param  palette [in] color palette (r,g,b)
+ */
+/*===========================================================================*/
+void KVSMLObjectPoint::setColorIndices(
+    const kvs::ValueArray<kvs::UInt8>& indices,
+    const kvs::ValueArray<kvs::UInt8>& palette )
+{
+    m_color_indices = indices;
+    m_color_palette = palette;
+}
+
 /*===========================================================================*/
 /**
  *  @brief  Prints file information.
@@ -121,7 +158,7 @@ KVSMLObjectPoint::KVSMLObjectPoint( const std::string& filename ):
 void KVSMLObjectPoint::print( std::ostream& os, const kvs::Indent& indent ) const
 {
     os << indent << "Filename : " << BaseClass::filename() << std::endl;
-    os << indent << "Number of vertices: " << m_coords.size() / 3;
+    os << indent << "Number of vertices: " << ( m_coords.size() + m_quantized_coords.size() ) / 3;
 }
 
 /*===========================================================================*/
@@ -181,7 +218,13 @@ bool KVSMLObjectPoint::read( const std::string& filename )
             return false;
         }
 
-        if ( m_coords.size() == 0 )
+        // <QuantizedCoord>
+        if ( !kvs::kvsml::ReadQuantizedCoordData( parent, ncoords, &m_quantized_coords, &m_min_coord, &m_max_coord ) )
+        {
+            return false;
+        }
+
+        if ( m_coords.size() == 0 && m_quantized_coords.size() == 0 )
         {
             kvsMessageError( "Cannot read the coord data." );
             return false;
@@ -194,7 +237,13 @@ bool KVSMLObjectPoint::read( const std::string& filename )
             return false;
         }
 
-        if ( m_colors.size() == 0 )
+        // <ColorIndex> and <ColorPalette>
+        if ( !kvs::kvsml::ReadColorIndexData( parent, ncolors, &m_color_indices, &m_color_palette ) )
+        {
+            return false;
+        }
+
+        if ( m_colors.size() == 0 && m_color_indices.size() == 0 )
         {
             // default value (black).
             m_colors.allocate(3);
@@ -210,6 +259,12 @@ bool KVSMLObjectPoint::read( const std::string& filename )
             return false;
         }
 
+        // <EncodedNormal>
+        if ( !kvs::kvsml::ReadEncodedNormalData( parent, nnormals, &m_encoded_normals ) )
+        {
+            return false;
+        }
+
         // <Size>
         const size_t nsizes = vertex_tag.nvertices();
         if ( !kvs::kvsml::ReadSizeData( parent, nsizes, &m_sizes ) )
@@ -262,7 +317,7 @@ bool KVSMLObjectPoint::write( const std::string& filename )
     // <Vertex nvertices="xxx">
     const size_t dimension = 3;
     kvs::kvsml::VertexTag vertex_tag;
-    vertex_tag.setNVertices( m_coords.size() / dimension );
+    vertex_tag.setNVertices( ( m_coords.size() + m_quantized_coords.size() ) / dimension );
     if ( !vertex_tag.write( point_tag.node() ) )
     {
         kvsMessageError( "Cannot write <%s>.", vertex_tag.name().c_str() );
@@ -280,18 +335,36 @@ bool KVSMLObjectPoint::write( const std::string& filename )
             return false;
         }
 
+        // <QuantizedCoord>
+        if ( !kvs::kvsml::WriteQuantizedCoordData( parent, type, filename, m_quantized_coords, m_min_coord, m_max_coord ) )
+        {
+            return false;
+        }
+
         // <Color>
         if ( !kvs::kvsml::WriteColorData( parent, type, filename, m_colors ) )
         {
             return false;
         }
 
+        // <ColorIndex> and <ColorPalette>
+        if ( !kvs::kvsml::WriteColorIndexData( parent, type, filename, m_color_indices, m_color_palette ) )
+        {
+            return false;
+        }
+
         // <Normal>
         if ( !kvs::kvsml::WriteNormalData( parent, type, filename, m_normals ) )
         {
             return false;
         }
 
+        // <EncodedNormal>
+        if ( !kvs::kvsml::WriteEncodedNormalData( parent, type, filename, m_encoded_normals ) )
+        {
+            return false;
+        }
+
         // <Size>
         if ( !kvs::kvsml::WriteSizeData( parent, type, filename, m_sizes ) )
         {
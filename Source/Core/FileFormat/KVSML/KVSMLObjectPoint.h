@@ -54,6 +54,12 @@ private:
     kvs::ValueArray<kvs::UInt8> m_colors; ///< color(r,g,b) array
     kvs::ValueArray<kvs::Real32> m_normals; ///< normal array
     kvs::ValueArray<kvs::Real32> m_sizes; ///< size array
+    kvs::ValueArray<kvs::UInt16> m_quantized_coords; ///< quantized coordinate array
+    kvs::Vec3 m_min_coord; ///< coordinate of the quantized value 0
+    kvs::Vec3 m_max_coord; ///< coordinate of the max. quantized value
+    kvs::ValueArray<kvs::UInt16> m_encoded_normals; ///< octahedral-encoded normal array
+    kvs::ValueArray<kvs::UInt8> m_color_indices; ///< color index array
+    kvs::ValueArray<kvs::UInt8> m_color_palette; ///< color palette (r,g,b)
 
 public:
 
@@ -71,12 +77,24 @@ public:
     const kvs::ValueArray<kvs::UInt8>& colors() const { return m_colors; }
     const kvs::ValueArray<kvs::Real32>& normals() const { return m_normals; }
     const kvs::ValueArray<kvs::Real32>& sizes() const { return m_sizes; }
+    const kvs::ValueArray<kvs::UInt16>& quantizedCoords() const { return m_quantized_coords; }
+    const kvs::Vec3& minCoord() const { return m_min_coord; }
+    const kvs::Vec3& maxCoord() const { return m_max_coord; }
+    const kvs::ValueArray<kvs::UInt16>& encodedNormals() const { return m_encoded_normals; }
+    const kvs::ValueArray<kvs::UInt8>& colorIndices() const { return m_color_indices; }
+    const kvs::ValueArray<kvs::UInt8>& colorPalette() const { return m_color_palette; }
 
     void setWritingDataType( const WritingDataType type ) { m_writing_type = type; }
     void setCoords( const kvs::ValueArray<kvs::Real32>& coords ) { m_coords = coords; }
     void setColors( const kvs::ValueArray<kvs::UInt8>& colors ) { m_colors = colors; }
     void setNormals( const kvs::ValueArray<kvs::Real32>& normals ) { m_normals = normals; }
     void setSizes( const kvs::ValueArray<kvs::Real32>& sizes ) { m_sizes = sizes; }
+    void setQuantizedCoords(
+        const kvs::ValueArray<kvs::UInt16>& coords,
+        const kvs::Vec3& min_coord,
+        const kvs::Vec3& max_coord );
+    void setEncodedNormals( const kvs::ValueArray<kvs::UInt16>& normals ) { m_encoded_normals = normals; }
+    void setColorIndices( const kvs::ValueArray<kvs::UInt8>& indices, const kvs::ValueArray<kvs::UInt8>& palette );
 
     void print( std::ostream& os, const kvs::Indent& indent = kvs::Indent(0) ) const;
     bool read( const std::string& filename );
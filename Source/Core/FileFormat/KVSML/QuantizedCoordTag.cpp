@@ -0,0 +1,129 @@
+/*****************************************************************************/
+/**
+ *  @file   QuantizedCoordTag.cpp
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#include "QuantizedCoordTag.h"
+#include <cstdlib>
+#include <sstream>
+#include <iomanip>
+#include <kvs/Message>
+#include <kvs/Tokenizer>
+#include <kvs/XMLElement>
+
+
+namespace kvs
+{
+
+namespace kvsml
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new quantized coord tag class.
+ */
+/*===========================================================================*/
+QuantizedCoordTag::QuantizedCoordTag():
+    kvs::kvsml::TagBase( "QuantizedCoord" ),
+    m_has_range( false ),
+    m_min_coord( 0.0f, 0.0f, 0.0f ),
+    m_max_coord( 0.0f, 0.0f, 0.0f )
+{
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sets the range of the quantized coordinates.
+ *  @param  min_coord [in] coordinate of the quantized value 0
+ *  @param  max_coord [in] coordinate of the max. quantized value
+ */
+/*===========================================================================*/
+void QuantizedCoordTag::setRange( const kvs::Vec3& min_coord, const kvs::Vec3& max_coord )
+{
+    m_has_range = true;
+    m_min_coord = min_coord;
+    m_max_coord = max_coord;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Reads the quantized coord tag.
+ *  @param  parent [in] pointer to the parent node
+ *  @return true, if the reading process is done successfully
+ */
+/*===========================================================================*/
+bool QuantizedCoordTag::read( const kvs::XMLNode::SuperClass* parent )
+{
+    BaseClass::read( parent );
+
+    // Element
+    const kvs::XMLElement::SuperClass* element = kvs::XMLNode::ToElement( BaseClass::m_node );
+
+    // range="xxx xxx xxx xxx xxx xxx"
+    const std::string range = kvs::XMLElement::AttributeValue( element, "range" );
+    if ( range != "" )
+    {
+        const std::string delim(" \n");
+        kvs::Tokenizer t( range, delim );
+
+        float values[6];
+        for ( size_t i = 0; i < 6; i++ )
+        {
+            if ( t.isLast() )
+            {
+                kvsMessageError( "6 components are required for 'range' in <%s>", this->name().c_str() );
+                return false;
+            }
+
+            values[i] = static_cast<float>( atof( t.token().c_str() ) );
+        }
+
+        m_has_range = true;
+        m_min_coord = kvs::Vec3( values[0], values[1], values[2] );
+        m_max_coord = kvs::Vec3( values[3], values[4], values[5] );
+    }
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Writes the quantized coord tag.
+ *  @param  parent [in] pointer to the parent node
+ *  @return true, if the writing process is done successfully
+ */
+/*===========================================================================*/
+bool QuantizedCoordTag::write( kvs::XMLNode::SuperClass* parent )
+{
+    kvs::XMLElement element( BaseClass::name() );
+
+    if ( m_has_range )
+    {
+        // The range is written with the full precision, since the quantized
+        // values are dequantized with it.
+        std::ostringstream range;
+        range << std::setprecision( 9 )
+              << m_min_coord.x() << " " << m_min_coord.y() << " " << m_min_coord.z() << " "
+              << m_max_coord.x() << " " << m_max_coord.y() << " " << m_max_coord.z();
+        element.setAttribute( "range", range.str() );
+    }
+    else
+    {
+        kvsMessageError( "'range' is not specified in <%s>.", BaseClass::name().c_str() );
+        return false;
+    }
+
+    return BaseClass::write_with_element( parent, element );
+}
+
+} // end of namespace kvsml
+
+} // end of namespace kvs
@@ -0,0 +1,66 @@
+/*****************************************************************************/
+/**
+ *  @file   QuantizedCoordTag.h
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#ifndef KVS__KVSML__QUANTIZED_COORD_TAG_H_INCLUDE
+#define KVS__KVSML__QUANTIZED_COORD_TAG_H_INCLUDE
+
+#include <kvs/XMLNode>
+#include <kvs/Vector3>
+#include "TagBase.h"
+
+
+namespace kvs
+{
+
+namespace kvsml
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Tag class for <QuantizedCoord>
+ *
+ *  The coordinates are quantized to 16 bits in the range specified by the
+ *  'range' attribute (min_x min_y min_z max_x max_y max_z).
+ */
+/*===========================================================================*/
+class QuantizedCoordTag : public kvs::kvsml::TagBase
+{
+public:
+
+    typedef kvs::kvsml::TagBase BaseClass;
+
+private:
+
+    bool m_has_range; ///< flag to check whether 'range' is specified or not
+    kvs::Vec3 m_min_coord; ///< min. coordinate of the range
+    kvs::Vec3 m_max_coord; ///< max. coordinate of the range
+
+public:
+
+    QuantizedCoordTag();
+
+    bool hasRange() const { return m_has_range; }
+    const kvs::Vec3& minCoord() const { return m_min_coord; }
+    const kvs::Vec3& maxCoord() const { return m_max_coord; }
+
+    void setRange( const kvs::Vec3& min_coord, const kvs::Vec3& max_coord );
+
+    bool read( const kvs::XMLNode::SuperClass* parent );
+    bool write( kvs::XMLNode::SuperClass* parent );
+};
+
+} // end of namespace kvsml
+
+} // end of namespace kvs
+
+#endif // KVS__KVSML__QUANTIZED_COORD_TAG_H_INCLUDE
@@ -23,9 +23,21 @@
 #include <kvs/IgnoreUnusedVariable>
 #include <kvs/File>
 #include <kvs/Assert>
+#include <kvs/Endian>
+#include <kvs/Thread>
+#include <kvs/SystemInformation>
 #include "Ply.h"
 #include "PlyFile.h"
 
+#if defined( KVS_PLATFORM_WINDOWS )
+#include <cstdio>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 
 namespace
 {
@@ -87,6 +99,435 @@ kvs::ply::PlyProperty FaceProps[1] =
 
 } // end of namespace
 
+namespace
+{
+
+const size_t MinItemsPerThread = 1 << 16;
+const size_t WriteBlockSize = 1 << 16; // number of items written at once
+
+/*===========================================================================*/
+/**
+ *  @brief  Byte size of each PLY data type (PLY_CHAR, ..., PLY_DOUBLE).
+ */
+/*===========================================================================*/
+const size_t TypeSize[] = { 0, 1, 2, 4, 1, 2, 4, 4, 8 };
+
+/*===========================================================================*/
+/**
+ *  @brief  Read-only memory image of a file.
+ *
+ *  The file is memory-mapped where available, and read into a buffer
+ *  otherwise.
+ */
+/*===========================================================================*/
+class FileImage
+{
+private:
+
+    const kvs::UInt8* m_data; ///< file image
+    size_t m_size; ///< byte size of the file
+#if defined( KVS_PLATFORM_WINDOWS )
+    kvs::ValueArray<kvs::UInt8> m_buffer; ///< file buffer
+#else
+    void* m_map; ///< mapped address
+#endif
+
+public:
+
+#if defined( KVS_PLATFORM_WINDOWS )
+    FileImage(): m_data( NULL ), m_size( 0 ) {}
+    ~FileImage() {}
+
+    bool open( const std::string& filename )
+    {
+        FILE* fp = fopen( filename.c_str(), "rb" );
+        if ( !fp ) return false;
+        fseek( fp, 0, SEEK_END );
+        const long size = ftell( fp );
+        fseek( fp, 0, SEEK_SET );
+        if ( size < 0 ) { fclose( fp ); return false; }
+        m_buffer.allocate( size_t( size ) );
+        m_size = fread( m_buffer.data(), 1, size_t( size ), fp );
+        m_data = m_buffer.data();
+        fclose( fp );
+        return m_size == size_t( size );
+    }
+#else
+    FileImage(): m_data( NULL ), m_size( 0 ), m_map( NULL ) {}
+    ~FileImage() { if ( m_map ) { munmap( m_map, m_size ); } }
+
+    bool open( const std::string& filename )
+    {
+        const int fd = ::open( filename.c_str(), O_RDONLY );
+        if ( fd < 0 ) return false;
+        struct stat st;
+        if ( fstat( fd, &st ) != 0 || st.st_size <= 0 ) { ::close( fd ); return false; }
+        m_size = size_t( st.st_size );
+        void* map = mmap( NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+        ::close( fd );
+        if ( map == MAP_FAILED ) { m_size = 0; return false; }
+        m_map = map;
+        m_data = static_cast<const kvs::UInt8*>( map );
+        return true;
+    }
+#endif
+
+    const kvs::UInt8* data() const { return m_data; }
+    size_t size() const { return m_size; }
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the value stored in the file as the given type.
+ *  @param  p [in] pointer to the value in the file image
+ *  @param  swap [in] if true, the byte order is swapped
+ */
+/*===========================================================================*/
+template <typename V>
+inline V Load( const kvs::UInt8* p, const bool swap )
+{
+    V value;
+    memcpy( &value, p, sizeof( V ) );
+    if ( swap ) kvs::Endian::Swap( &value );
+    return value;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the value of the PLY data type converted to T.
+ *  @param  p [in] pointer to the value in the file image
+ *  @param  type [in] PLY data type
+ *  @param  swap [in] if true, the byte order is swapped
+ */
+/*===========================================================================*/
+template <typename T>
+inline T GetValue( const kvs::UInt8* p, const int type, const bool swap )
+{
+    switch ( type )
+    {
+    case PLY_CHAR: return static_cast<T>( *reinterpret_cast<const kvs::Int8*>( p ) );
+    case PLY_UCHAR: return static_cast<T>( *p );
+    case PLY_SHORT: return static_cast<T>( ::Load<kvs::Int16>( p, swap ) );
+    case PLY_USHORT: return static_cast<T>( ::Load<kvs::UInt16>( p, swap ) );
+    case PLY_INT: return static_cast<T>( ::Load<kvs::Int32>( p, swap ) );
+    case PLY_UINT: return static_cast<T>( ::Load<kvs::UInt32>( p, swap ) );
+    case PLY_FLOAT: return static_cast<T>( ::Load<kvs::Real32>( p, swap ) );
+    case PLY_DOUBLE: return static_cast<T>( ::Load<kvs::Real64>( p, swap ) );
+    default: return T( 0 );
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Stores the value to the buffer as the PLY data type.
+ *  @param  p [out] pointer to the buffer
+ *  @param  value [in] value
+ *  @param  swap [in] if true, the byte order is swapped
+ *  @return pointer to the next value in the buffer
+ */
+/*===========================================================================*/
+template <typename V>
+inline kvs::UInt8* Store( kvs::UInt8* p, V value, const bool swap )
+{
+    if ( swap ) kvs::Endian::Swap( &value );
+    memcpy( p, &value, sizeof( V ) );
+    return p + sizeof( V );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Scalar property of an element with fixed-size items.
+ */
+/*===========================================================================*/
+struct Property
+{
+    int type; ///< PLY data type (0 if the property is not found)
+    size_t offset; ///< byte offset in the item
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the byte size of an item of the element.
+ *  @param  elem [in] PLY element
+ *  @return byte size (0 if the element has list properties)
+ */
+/*===========================================================================*/
+size_t FixedItemSize( const kvs::ply::PlyElement* elem )
+{
+    size_t size = 0;
+    for ( int i = 0; i < elem->nprops; i++ )
+    {
+        const kvs::ply::PlyProperty* prop = elem->props[i];
+        if ( prop->is_list ) return 0;
+        size += ::TypeSize[ prop->external_type ];
+    }
+    return size;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the scalar property of the element with fixed-size items.
+ *  @param  elem [in] PLY element
+ *  @param  name [in] property name
+ */
+/*===========================================================================*/
+::Property FindProperty( const kvs::ply::PlyElement* elem, const char* name )
+{
+    ::Property property = { 0, 0 };
+    size_t offset = 0;
+    for ( int i = 0; i < elem->nprops; i++ )
+    {
+        const kvs::ply::PlyProperty* prop = elem->props[i];
+        if ( !strcmp( prop->name, name ) )
+        {
+            property.type = prop->external_type;
+            property.offset = offset;
+            break;
+        }
+        offset += ::TypeSize[ prop->external_type ];
+    }
+    return property;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the end of an item of the element with variable-size items.
+ *  @param  p [in] pointer to the item in the file image
+ *  @param  end [in] end of the file image
+ *  @param  elem [in] PLY element
+ *  @param  swap [in] if true, the byte order is swapped
+ *  @param  list [in] index of the list property whose first three values are returned
+ *  @param  values [out] first three values of the list property (NULL if not needed)
+ *  @return pointer to the next item (NULL if the item overruns the file)
+ */
+/*===========================================================================*/
+const kvs::UInt8* NextItem(
+    const kvs::UInt8* p,
+    const kvs::UInt8* end,
+    const kvs::ply::PlyElement* elem,
+    const bool swap,
+    const int list = -1,
+    kvs::UInt32* values = NULL )
+{
+    for ( int i = 0; i < elem->nprops; i++ )
+    {
+        const kvs::ply::PlyProperty* prop = elem->props[i];
+        if ( prop->is_list )
+        {
+            const size_t count_size = ::TypeSize[ prop->count_external ];
+            if ( end - p < std::ptrdiff_t( count_size ) ) return NULL;
+            const size_t count = ::GetValue<size_t>( p, prop->count_external, swap );
+            p += count_size;
+
+            const size_t value_size = ::TypeSize[ prop->external_type ];
+            if ( size_t( end - p ) < count * value_size ) return NULL;
+            if ( i == list && values )
+            {
+                for ( size_t j = 0; j < 3; j++ )
+                {
+                    values[j] = j < count ? ::GetValue<kvs::UInt32>( p + j * value_size, prop->external_type, swap ) : 0;
+                }
+            }
+            p += count * value_size;
+        }
+        else
+        {
+            const size_t size = ::TypeSize[ prop->external_type ];
+            if ( end - p < std::ptrdiff_t( size ) ) return NULL;
+            p += size;
+        }
+    }
+    return p;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  VertexDecoder class that decodes a range of the vertices.
+ */
+/*===========================================================================*/
+class VertexDecoder : public kvs::Thread
+{
+private:
+
+    const kvs::UInt8* m_data; ///< vertex data in the file image
+    size_t m_stride; ///< byte size of a vertex
+    const ::Property* m_props; ///< x, y, z, red, green, blue, nx, ny, nz
+    bool m_swap; ///< if true, the byte order is swapped
+    kvs::Real32* m_coords; ///< coordinate values
+    kvs::UInt8* m_colors; ///< color values (NULL if not needed)
+    kvs::Real32* m_normals; ///< normal values (NULL if not needed)
+    size_t m_begin; ///< first vertex
+    size_t m_end; ///< last vertex + 1
+
+public:
+
+    VertexDecoder():
+        m_data( NULL ),
+        m_stride( 0 ),
+        m_props( NULL ),
+        m_swap( false ),
+        m_coords( NULL ),
+        m_colors( NULL ),
+        m_normals( NULL ),
+        m_begin( 0 ),
+        m_end( 0 ) {}
+
+    void init(
+        const kvs::UInt8* data,
+        const size_t stride,
+        const ::Property* props,
+        const bool swap,
+        kvs::Real32* coords,
+        kvs::UInt8* colors,
+        kvs::Real32* normals,
+        const size_t begin,
+        const size_t end )
+    {
+        m_data = data;
+        m_stride = stride;
+        m_props = props;
+        m_swap = swap;
+        m_coords = coords;
+        m_colors = colors;
+        m_normals = normals;
+        m_begin = begin;
+        m_end = end;
+    }
+
+    void run()
+    {
+        for ( size_t i = m_begin; i < m_end; i++ )
+        {
+            const kvs::UInt8* p = m_data + i * m_stride;
+            for ( size_t j = 0; j < 3; j++ )
+            {
+                m_coords[ 3 * i + j ] = ::GetValue<kvs::Real32>( p + m_props[j].offset, m_props[j].type, m_swap );
+            }
+            if ( m_colors )
+            {
+                for ( size_t j = 0; j < 3; j++ )
+                {
+                    m_colors[ 3 * i + j ] = ::GetValue<kvs::UInt8>( p + m_props[3+j].offset, m_props[3+j].type, m_swap );
+                }
+            }
+            if ( m_normals )
+            {
+                for ( size_t j = 0; j < 3; j++ )
+                {
+                    m_normals[ 3 * i + j ] = ::GetValue<kvs::Real32>( p + m_props[6+j].offset, m_props[6+j].type, m_swap );
+                }
+            }
+        }
+    }
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  FaceDecoder class that decodes a range of the triangle faces.
+ *
+ *  The faces are assumed to be triangles stored with a fixed stride. The
+ *  decoding fails if a face that is not a triangle is found.
+ */
+/*===========================================================================*/
+class FaceDecoder : public kvs::Thread
+{
+private:
+
+    const kvs::UInt8* m_data; ///< face data in the file image
+    size_t m_stride; ///< byte size of a face
+    size_t m_offset; ///< byte offset of the vertex indices in a face
+    int m_count_type; ///< PLY data type of the number of vertex indices
+    int m_index_type; ///< PLY data type of the vertex indices
+    bool m_swap; ///< if true, the byte order is swapped
+    kvs::UInt32* m_connections; ///< connections
+    size_t m_begin; ///< first face
+    size_t m_end; ///< last face + 1
+    bool m_success; ///< false, if a face that is not a triangle is found
+
+public:
+
+    FaceDecoder():
+        m_data( NULL ),
+        m_stride( 0 ),
+        m_offset( 0 ),
+        m_count_type( 0 ),
+        m_index_type( 0 ),
+        m_swap( false ),
+        m_connections( NULL ),
+        m_begin( 0 ),
+        m_end( 0 ),
+        m_success( true ) {}
+
+    void init(
+        const kvs::UInt8* data,
+        const size_t stride,
+        const size_t offset,
+        const int count_type,
+        const int index_type,
+        const bool swap,
+        kvs::UInt32* connections,
+        const size_t begin,
+        const size_t end )
+    {
+        m_data = data;
+        m_stride = stride;
+        m_offset = offset;
+        m_count_type = count_type;
+        m_index_type = index_type;
+        m_swap = swap;
+        m_connections = connections;
+        m_begin = begin;
+        m_end = end;
+    }
+
+    bool isSuccess() const { return m_success; }
+
+    void run()
+    {
+        const size_t count_size = ::TypeSize[ m_count_type ];
+        const size_t index_size = ::TypeSize[ m_index_type ];
+        for ( size_t i = m_begin; i < m_end; i++ )
+        {
+            const kvs::UInt8* p = m_data + i * m_stride + m_offset;
+            if ( ::GetValue<size_t>( p, m_count_type, m_swap ) != 3 ) { m_success = false; return; }
+            p += count_size;
+            for ( size_t j = 0; j < 3; j++ )
+            {
+                m_connections[ 3 * i + j ] = ::GetValue<kvs::UInt32>( p + j * index_size, m_index_type, m_swap );
+            }
+        }
+    }
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the number of threads for decoding the items.
+ *  @param  nitems [in] number of items
+ */
+/*===========================================================================*/
+size_t NumberOfThreads( const size_t nitems )
+{
+    const size_t nthreads = kvs::SystemInformation::NumberOfProcessors();
+    return kvs::Math::Max( size_t(1), kvs::Math::Min( nthreads, nitems / ::MinItemsPerThread ) );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Runs the decoders. The first block is decoded by the calling thread.
+ *  @param  decoders [in] decoders
+ */
+/*===========================================================================*/
+template <typename Decoder>
+void Run( std::vector<Decoder>& decoders )
+{
+    const size_t nthreads = decoders.size();
+    for ( size_t i = 1; i < nthreads; i++ ) { if ( !decoders[i].start() ) { decoders[i].run(); } }
+    decoders[0].run();
+    for ( size_t i = 1; i < nthreads; i++ ) { if ( decoders[i].isRunning() ) { decoders[i].wait(); } }
+}
+
+} // end of namespace
+
 namespace kvs
 {
 
@@ -287,102 +728,120 @@ bool Ply::read( const std::string& filename )
         m_has_normals = true;
     }
 
-    // Read the data.
-    for ( int i = 0; i < nelems; i++ )
+    // Decode the binary data directly from the file image, if the vertices
+    // have a fixed size. Otherwise, the data is read element by element.
+    elem = kvs::ply::find_element( ply, "vertex" );
+    if ( file_type != PLY_ASCII && ::FixedItemSize( elem ) > 0 )
     {
-        char* elem_name = elist[i];
-        int elem_count;
-        int elem_nprops;
-        kvs::ply::ply_get_element_description( ply, elem_name, &elem_count, &elem_nprops);
-
-        // Read vertex information.
-        if ( elem_name && !strcmp( "vertex", elem_name ) )
+        if ( !this->read_binary_data( ply ) )
         {
-            // Create a vertex list to hold all the vertices.
-            m_nverts = elem_count;
-
-            // Set up for getting vertex elements.
-            kvs::ply::ply_get_property( ply, elem_name, &::VertProps[0] );
-            kvs::ply::ply_get_property( ply, elem_name, &::VertProps[1] );
-            kvs::ply::ply_get_property( ply, elem_name, &::VertProps[2] );
-            m_coords.allocate( m_nverts * 3 );
-
-            if ( m_has_colors )
-            {
-                kvs::ply::ply_get_property( ply, elem_name, &::VertProps[3] );
-                kvs::ply::ply_get_property( ply, elem_name, &::VertProps[4] );
-                kvs::ply::ply_get_property( ply, elem_name, &::VertProps[5] );
-                m_colors.allocate( m_nverts * 3 );
-            }
-
-            if ( m_has_normals )
-            {
-                kvs::ply::ply_get_property( ply, elem_name, &::VertProps[6] );
-                kvs::ply::ply_get_property( ply, elem_name, &::VertProps[7] );
-                kvs::ply::ply_get_property( ply, elem_name, &::VertProps[8] );
-                m_normals.allocate( m_nverts * 3 );
-            }
+            kvsMessageError( "Cannot read the binary data." );
+            for ( int i = 0; i < nelems; i++ ) free( elist[i] );
+            free( elist );
+            kvs::ply::ply_close( ply );
+            BaseClass::setSuccess( false );
+            return false;
+        }
+    }
+    else
+    {
+        // Read the data.
+        for ( int i = 0; i < nelems; i++ )
+        {
+            char* elem_name = elist[i];
+            int elem_count;
+            int elem_nprops;
+            kvs::ply::ply_get_element_description( ply, elem_name, &elem_count, &elem_nprops);
 
-            kvs::Real32* pcoords = m_coords.data();
-            kvs::UInt8* pcolors = m_colors.data();
-            kvs::Real32* pnormals = m_normals.data();
-            for ( int j = 0; j < elem_count; j++ )
+            // Read vertex information.
+            if ( elem_name && !strcmp( "vertex", elem_name ) )
             {
-                ::Vertex* vertex = (::Vertex*)malloc( sizeof(::Vertex) );
-                if ( vertex ) memset( vertex, 0, sizeof(::Vertex) );
-                kvs::ply::ply_get_element( ply, (void*)vertex );
+                // Create a vertex list to hold all the vertices.
+                m_nverts = elem_count;
 
-                *(pcoords++) = vertex->x;
-                *(pcoords++) = vertex->y;
-                *(pcoords++) = vertex->z;
+                // Set up for getting vertex elements.
+                kvs::ply::ply_get_property( ply, elem_name, &::VertProps[0] );
+                kvs::ply::ply_get_property( ply, elem_name, &::VertProps[1] );
+                kvs::ply::ply_get_property( ply, elem_name, &::VertProps[2] );
+                m_coords.allocate( m_nverts * 3 );
 
                 if ( m_has_colors )
                 {
-                    *(pcolors++) = vertex->r;
-                    *(pcolors++) = vertex->g;
-                    *(pcolors++) = vertex->b;
+                    kvs::ply::ply_get_property( ply, elem_name, &::VertProps[3] );
+                    kvs::ply::ply_get_property( ply, elem_name, &::VertProps[4] );
+                    kvs::ply::ply_get_property( ply, elem_name, &::VertProps[5] );
+                    m_colors.allocate( m_nverts * 3 );
                 }
 
                 if ( m_has_normals )
                 {
-                    *(pnormals++) = vertex->nx;
-                    *(pnormals++) = vertex->ny;
-                    *(pnormals++) = vertex->nz;
+                    kvs::ply::ply_get_property( ply, elem_name, &::VertProps[6] );
+                    kvs::ply::ply_get_property( ply, elem_name, &::VertProps[7] );
+                    kvs::ply::ply_get_property( ply, elem_name, &::VertProps[8] );
+                    m_normals.allocate( m_nverts * 3 );
+                }
+
+                kvs::Real32* pcoords = m_coords.data();
+                kvs::UInt8* pcolors = m_colors.data();
+                kvs::Real32* pnormals = m_normals.data();
+                for ( int j = 0; j < elem_count; j++ )
+                {
+                    ::Vertex* vertex = (::Vertex*)malloc( sizeof(::Vertex) );
+                    if ( vertex ) memset( vertex, 0, sizeof(::Vertex) );
+                    kvs::ply::ply_get_element( ply, (void*)vertex );
+
+                    *(pcoords++) = vertex->x;
+                    *(pcoords++) = vertex->y;
+                    *(pcoords++) = vertex->z;
+
+                    if ( m_has_colors )
+                    {
+                        *(pcolors++) = vertex->r;
+                        *(pcolors++) = vertex->g;
+                        *(pcolors++) = vertex->b;
+                    }
+
+                    if ( m_has_normals )
+                    {
+                        *(pnormals++) = vertex->nx;
+                        *(pnormals++) = vertex->ny;
+                        *(pnormals++) = vertex->nz;
+                    }
+                    free( vertex );
                 }
-                free( vertex );
             }
-        }
 
-        // Read face information.
-        if ( m_has_connections )
-        {
-            if ( elem_name && !strcmp( "face", elem_name ) )
+            // Read face information.
+            if ( m_has_connections )
             {
-                // Create a list to hold all the face elements.
-                m_nfaces = elem_count;
-
-                // Set up for getting face elements.
-                kvs::ply::ply_get_property( ply, elem_name, &::FaceProps[0] );
-                m_connections.allocate( m_nfaces * 3 );
-
-                // Grab all the face elements.
-                kvs::UInt32* pconnections = m_connections.data();
-                for ( int j = 0; j < elem_count; j++ )
+                if ( elem_name && !strcmp( "face", elem_name ) )
                 {
-                    ::Face* face = (::Face*)malloc( sizeof(::Face) );
-                    if ( face ) memset( face, 0, sizeof(::Face) );
-                    kvs::ply::ply_get_element( ply, (void*)face );
-
-                    *(pconnections++) = face->verts[0];
-                    *(pconnections++) = face->verts[1];
-                    *(pconnections++) = face->verts[2];
-                    free( face );
+                    // Create a list to hold all the face elements.
+                    m_nfaces = elem_count;
+
+                    // Set up for getting face elements.
+                    kvs::ply::ply_get_property( ply, elem_name, &::FaceProps[0] );
+                    m_connections.allocate( m_nfaces * 3 );
+
+                    // Grab all the face elements.
+                    kvs::UInt32* pconnections = m_connections.data();
+                    for ( int j = 0; j < elem_count; j++ )
+                    {
+                        ::Face* face = (::Face*)malloc( sizeof(::Face) );
+                        if ( face ) memset( face, 0, sizeof(::Face) );
+                        kvs::ply::ply_get_element( ply, (void*)face );
+
+                        *(pconnections++) = face->verts[0];
+                        *(pconnections++) = face->verts[1];
+                        *(pconnections++) = face->verts[2];
+                        free( face );
+                    }
                 }
             }
         }
-
-        free( elist[i] );
     }
+
+    for ( int i = 0; i < nelems; i++ ) free( elist[i] );
     free( elist );
 
     this->calculate_min_max_coord();
@@ -432,7 +891,7 @@ bool Ply::write( const std::string& filename )
         kvs::ply::ply_describe_property( ply, "vertex", &::VertProps[8] );
     }
 
-    if ( m_nfaces > 0 )
+    if ( m_has_connections && m_nfaces > 0 )
     {
         const size_t nfaces = m_nfaces;
         kvs::ply::ply_element_count( ply, "face", int( nfaces ) );
@@ -441,6 +900,21 @@ bool Ply::write( const std::string& filename )
 
     kvs::ply::ply_header_complete( ply );
 
+    // Write the binary data in bulk.
+    if ( file_type != PLY_ASCII )
+    {
+        const bool success = this->write_binary_data( ply );
+        kvs::ply::ply_close( ply );
+        if ( !success )
+        {
+            kvsMessageError( "Cannot write the binary data." );
+            BaseClass::setSuccess( false );
+            return false;
+        }
+
+        return true;
+    }
+
     const kvs::Real32* pcoords = m_coords.data();
     const kvs::UInt8* pcolors = m_colors.data();
     const kvs::Real32* pnormals = m_normals.data();
@@ -480,18 +954,223 @@ bool Ply::write( const std::string& filename )
         kvs::ply::ply_put_element_setup( ply, "face" );
         for ( size_t i = 0; i < nfaces; i++ )
         {
-            ::Face* face = (::Face*)malloc( sizeof(::Face) );
-            if ( face ) memset( face, 0, sizeof(::Face) );
+            int verts[3];
+            verts[0] = *(pconnections++);
+            verts[1] = *(pconnections++);
+            verts[2] = *(pconnections++);
+
+            ::Face face;
+            face.nverts = 3;
+            face.verts = verts;
+            kvs::ply::ply_put_element( ply, (void*)&face );
+        }
+    }
+
+    kvs::ply::ply_close( ply );
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Decodes the binary data from the memory image of the file.
+ *  @param  ply [in] PLY file whose header has been read
+ *  @return true, if the reading process is done successfully
+ *
+ *  The vertices, whose size is fixed, and the triangle faces are decoded
+ *  into the value arrays in parallel blocks. The other elements are skipped.
+ */
+/*===========================================================================*/
+bool Ply::read_binary_data( kvs::ply::PlyFile* ply )
+{
+    const long offset = ftell( ply->fp );
+    ::FileImage image;
+    if ( offset < 0 || !image.open( BaseClass::filename() ) || size_t( offset ) > image.size() )
+    {
+        kvsMessageError( "Cannot map %s.", BaseClass::filename().c_str() );
+        return false;
+    }
+
+    const bool swap = ( ply->file_type == PLY_BINARY_LE ) == kvs::Endian::IsBig();
+    const kvs::UInt8* data = image.data() + offset;
+    const kvs::UInt8* const last = image.data() + image.size();
+    for ( int e = 0; e < ply->nelems; e++ )
+    {
+        const kvs::ply::PlyElement* elem = ply->elems[e];
+        const size_t nitems = size_t( elem->num );
+        const size_t item_size = ::FixedItemSize( elem );
+
+        // Read vertex information.
+        if ( !strcmp( "vertex", elem->name ) )
+        {
+            if ( size_t( last - data ) < nitems * item_size ) return false;
+
+            ::Property props[9];
+            const char* names[9] = { "x", "y", "z", "red", "green", "blue", "nx", "ny", "nz" };
+            for ( size_t i = 0; i < 9; i++ ) { props[i] = ::FindProperty( elem, names[i] ); }
+
+            m_nverts = nitems;
+            m_coords.allocate( m_nverts * 3 );
+            if ( m_has_colors ) m_colors.allocate( m_nverts * 3 );
+            if ( m_has_normals ) m_normals.allocate( m_nverts * 3 );
 
-            face->verts[0] = *(pconnections++);
-            face->verts[1] = *(pconnections++);
-            face->verts[2] = *(pconnections++);
+            const size_t nthreads = ::NumberOfThreads( nitems );
+            std::vector< ::VertexDecoder > decoders( nthreads );
+            for ( size_t i = 0; i < nthreads; i++ )
+            {
+                const size_t begin = nitems * i / nthreads;
+                const size_t end = nitems * ( i + 1 ) / nthreads;
+                decoders[i].init(
+                    data, item_size, props, swap,
+                    m_coords.data(),
+                    m_has_colors ? m_colors.data() : NULL,
+                    m_has_normals ? m_normals.data() : NULL,
+                    begin, end );
+            }
+            ::Run( decoders );
 
-            kvs::ply::ply_put_element( ply, (void*)face );
+            data += nitems * item_size;
+            continue;
+        }
+
+        // Read face information.
+        if ( m_has_connections && !strcmp( "face", elem->name ) )
+        {
+            m_nfaces = nitems;
+            m_connections.allocate( m_nfaces * 3 );
+
+            // Find the vertex indices, and the byte size of a triangle face
+            // if the face has no other lists.
+            int list = -1;
+            size_t list_offset = 0;
+            size_t stride = 0;
+            for ( int i = 0; i < elem->nprops; i++ )
+            {
+                const kvs::ply::PlyProperty* prop = elem->props[i];
+                if ( !strcmp( "vertex_indices", prop->name ) )
+                {
+                    list = i;
+                    list_offset = stride;
+                    stride += ::TypeSize[ prop->count_external ] + 3 * ::TypeSize[ prop->external_type ];
+                }
+                else if ( prop->is_list ) { stride = 0; break; }
+                else { stride += ::TypeSize[ prop->external_type ]; }
+            }
+
+            // Decode the faces in parallel, assuming that all of them are triangles.
+            bool success = false;
+            if ( stride > 0 && size_t( last - data ) >= nitems * stride )
+            {
+                const kvs::ply::PlyProperty* prop = elem->props[ list ];
+                const size_t nthreads = ::NumberOfThreads( nitems );
+                std::vector< ::FaceDecoder > decoders( nthreads );
+                for ( size_t i = 0; i < nthreads; i++ )
+                {
+                    const size_t begin = nitems * i / nthreads;
+                    const size_t end = nitems * ( i + 1 ) / nthreads;
+                    decoders[i].init(
+                        data, stride, list_offset, prop->count_external, prop->external_type, swap,
+                        m_connections.data(), begin, end );
+                }
+                ::Run( decoders );
+
+                success = true;
+                for ( size_t i = 0; i < nthreads; i++ ) { success = success && decoders[i].isSuccess(); }
+                if ( success ) data += nitems * stride;
+            }
+
+            // Otherwise, the faces are decoded one by one. The first three
+            // vertex indices of each face are stored.
+            if ( !success )
+            {
+                kvs::UInt32* pconnections = m_connections.data();
+                for ( size_t i = 0; i < nitems; i++, pconnections += 3 )
+                {
+                    data = ::NextItem( data, last, elem, swap, list, pconnections );
+                    if ( !data ) return false;
+                }
+            }
+            continue;
+        }
+
+        // Skip the other elements.
+        if ( item_size > 0 )
+        {
+            if ( size_t( last - data ) < nitems * item_size ) return false;
+            data += nitems * item_size;
+        }
+        else
+        {
+            for ( size_t i = 0; i < nitems; i++ )
+            {
+                data = ::NextItem( data, last, elem, swap );
+                if ( !data ) return false;
+            }
         }
     }
 
-    kvs::ply::ply_close( ply );
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Writes the binary data in blocks of the vertices and faces.
+ *  @param  ply [in] PLY file whose header has been written
+ *  @return true, if the writing process is done successfully
+ */
+/*===========================================================================*/
+bool Ply::write_binary_data( kvs::ply::PlyFile* ply ) const
+{
+    const bool swap = ( ply->file_type == PLY_BINARY_LE ) == kvs::Endian::IsBig();
+
+    // Vertices: x, y, z (float), [red, green, blue (uchar)], [nx, ny, nz (float)]
+    const size_t vertex_size =
+        3 * sizeof( kvs::Real32 ) +
+        ( m_has_colors ? 3 * sizeof( kvs::UInt8 ) : 0 ) +
+        ( m_has_normals ? 3 * sizeof( kvs::Real32 ) : 0 );
+    kvs::ValueArray<kvs::UInt8> buffer( ::WriteBlockSize * vertex_size );
+    for ( size_t begin = 0; begin < m_nverts; begin += ::WriteBlockSize )
+    {
+        const size_t end = kvs::Math::Min( begin + ::WriteBlockSize, m_nverts );
+        kvs::UInt8* p = buffer.data();
+        for ( size_t i = begin; i < end; i++ )
+        {
+            for ( size_t j = 0; j < 3; j++ ) { p = ::Store( p, m_coords[ 3 * i + j ], swap ); }
+            if ( m_has_colors )
+            {
+                for ( size_t j = 0; j < 3; j++ ) { *(p++) = m_colors[ 3 * i + j ]; }
+            }
+            if ( m_has_normals )
+            {
+                for ( size_t j = 0; j < 3; j++ ) { p = ::Store( p, m_normals[ 3 * i + j ], swap ); }
+            }
+        }
+
+        const size_t size = size_t( p - buffer.data() );
+        if ( fwrite( buffer.data(), 1, size, ply->fp ) != size ) return false;
+    }
+
+    if ( !m_has_connections ) return true;
+
+    // Faces: number of vertex indices (uchar), vertex indices (int)
+    const size_t face_size = sizeof( kvs::UInt8 ) + 3 * sizeof( kvs::Int32 );
+    buffer.allocate( ::WriteBlockSize * face_size );
+    for ( size_t begin = 0; begin < m_nfaces; begin += ::WriteBlockSize )
+    {
+        const size_t end = kvs::Math::Min( begin + ::WriteBlockSize, m_nfaces );
+        kvs::UInt8* p = buffer.data();
+        for ( size_t i = begin; i < end; i++ )
+        {
+            *(p++) = 3;
+            for ( size_t j = 0; j < 3; j++ )
+            {
+                p = ::Store( p, static_cast<kvs::Int32>( m_connections[ 3 * i + j ] ), swap );
+            }
+        }
+
+        const size_t size = size_t( p - buffer.data() );
+        if ( fwrite( buffer.data(), 1, size, ply->fp ) != size ) return false;
+    }
 
     return true;
 }
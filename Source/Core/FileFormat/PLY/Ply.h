@@ -101,6 +101,8 @@ public:
 
 private:
 
+    bool read_binary_data( kvs::ply::PlyFile* ply );
+    bool write_binary_data( kvs::ply::PlyFile* ply ) const;
     void calculate_min_max_coord();
     void calculate_normals();
 };
@@ -71,6 +71,14 @@ const char *type_names[] = {
     "float", "double",
 };
 
+/* sized type names used by the recent PLY files */
+const char *sized_type_names[] = {
+    "invalid",
+    "int8", "int16", "int32",
+    "uint8", "uint16", "uint32",
+    "float32", "float64",
+};
+
 int ply_type_size[] = {
     0, 1, 2, 4, 1, 2, 4, 4, 8
 };
@@ -121,7 +129,9 @@ PlyFile *ply_write(
 
     plyfile = (PlyFile *) myalloc (sizeof (PlyFile));
     plyfile->file_type = file_type;
+    plyfile->comments = NULL;
     plyfile->num_comments = 0;
+    plyfile->obj_info = NULL;
     plyfile->num_obj_info = 0;
     plyfile->nelems = nelems;
     plyfile->version = 1.0;
@@ -2393,7 +2403,8 @@ int get_prop_type(char *type_name)
     int i;
 
     for (i = PLY_START_TYPE + 1; i < PLY_END_TYPE; i++)
-        if (equal_strings (type_name, type_names[i]))
+        if (equal_strings (type_name, type_names[i]) ||
+            equal_strings (type_name, sized_type_names[i]))
             return (i);
 
     /* if we get here, we didn't find the type */
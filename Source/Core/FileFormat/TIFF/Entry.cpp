@@ -57,10 +57,12 @@ std::ostream& operator << ( std::ostream& os, const Entry& entry )
     else
     {
         os << "Value: ";
-        kvs::ValueArray<kvs::UInt32> values = entry.values().asValueArray<kvs::UInt32>();
-        for ( size_t i = 0; i < entry.count(); i++ )
+        // The values are stored with the type of the entry (the rationals
+        // are stored as the pairs of the numerator and the denominator).
+        for ( size_t i = 0; i < entry.values().size(); i++ )
         {
-            os << values[i];
+            if ( i > 0 ) os << " ";
+            os << entry.values()[i].to<kvs::Real64>();
         }
     }
 
@@ -115,10 +117,10 @@ void Entry::print( std::ostream& os, const kvs::Indent& indent ) const
     else
     {
         os << indent << "Value : ";
-        kvs::ValueArray<kvs::UInt32> values = this->values().asValueArray<kvs::UInt32>();
-        for ( size_t i = 0; i < this->count(); i++ )
+        for ( size_t i = 0; i < this->values().size(); i++ )
         {
-            os << values[i];
+            if ( i > 0 ) os << " ";
+            os << this->values()[i].to<kvs::Real64>();
         }
     }
     os << std::endl;
@@ -140,7 +142,8 @@ bool Entry::read( std::ifstream& ifs )
     this->allocate_values( m_count, m_type );
 
     // Read values.
-    const size_t byte_size = kvs::tiff::ValueTypeSize[m_type] * m_count;
+    const size_t type_size = m_type < kvs::tiff::NumberOfValueTypes ? kvs::tiff::ValueTypeSize[m_type] : 0;
+    const size_t byte_size = type_size * m_count;
     if ( byte_size > 4 )
     {
         const std::ifstream::pos_type end_of_entry = ifs.tellg();
@@ -159,7 +162,7 @@ bool Entry::read( std::ifstream& ifs )
     else
     {
         // Read values of the entry from the buffer to m_values.
-        if ( !memcpy( m_values.data(), buffer + 8, 4 ) ) return false; // offset 8, byte 4
+        if ( !memcpy( m_values.data(), buffer + 8, byte_size ) ) return false; // offset 8, byte_size <= 4
     }
 
     return true;
@@ -169,19 +172,19 @@ void* Entry::allocate_values( const size_t nvalues, const size_t value_type )
 {
     switch( value_type )
     {
-    case kvs::tiff::Byte:      m_values.allocate<kvs::UInt8>( nvalues );
-    case kvs::tiff::Ascii:     m_values.allocate<char>( nvalues );
-    case kvs::tiff::Short:     m_values.allocate<kvs::UInt16>( nvalues );
-    case kvs::tiff::Long:      m_values.allocate<kvs::UInt32>( nvalues );
-    case kvs::tiff::Rational:  m_values.allocate<kvs::Real64>( nvalues );
-    case kvs::tiff::SByte:     m_values.allocate<kvs::Int8>( nvalues );
-    case kvs::tiff::Undefined: m_values.allocate<char>( nvalues );
-    case kvs::tiff::SShort:    m_values.allocate<kvs::Int16>( nvalues );
-    case kvs::tiff::SLong:     m_values.allocate<kvs::Int32>( nvalues );
-    case kvs::tiff::SRational: m_values.allocate<kvs::Real64>( nvalues );
-    case kvs::tiff::Float:     m_values.allocate<kvs::Real32>( nvalues );
-    case kvs::tiff::Double:    m_values.allocate<kvs::Real64>( nvalues );
-    default: kvsMessageError("Unknown entry value type.");
+    case kvs::tiff::Byte:      m_values.allocate<kvs::UInt8>( nvalues ); break;
+    case kvs::tiff::Ascii:     m_values.allocate<kvs::Int8>( nvalues ); break;
+    case kvs::tiff::Short:     m_values.allocate<kvs::UInt16>( nvalues ); break;
+    case kvs::tiff::Long:      m_values.allocate<kvs::UInt32>( nvalues ); break;
+    case kvs::tiff::Rational:  m_values.allocate<kvs::UInt32>( nvalues * 2 ); break;
+    case kvs::tiff::SByte:     m_values.allocate<kvs::Int8>( nvalues ); break;
+    case kvs::tiff::Undefined: m_values.allocate<kvs::UInt8>( nvalues ); break;
+    case kvs::tiff::SShort:    m_values.allocate<kvs::Int16>( nvalues ); break;
+    case kvs::tiff::SLong:     m_values.allocate<kvs::Int32>( nvalues ); break;
+    case kvs::tiff::SRational: m_values.allocate<kvs::Int32>( nvalues * 2 ); break;
+    case kvs::tiff::Float:     m_values.allocate<kvs::Real32>( nvalues ); break;
+    case kvs::tiff::Double:    m_values.allocate<kvs::Real64>( nvalues ); break;
+    default: kvsMessageError("Unknown entry value type."); break;
     }
     return m_values.data();
 }
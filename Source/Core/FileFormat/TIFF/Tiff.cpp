@@ -15,7 +15,252 @@
 #include "ValueType.h"
 #include <kvs/IgnoreUnusedVariable>
 #include <kvs/File>
+#include <kvs/Thread>
+#include <kvs/Math>
+#include <kvs/SystemInformation>
 #include <algorithm>
+#include <fstream>
+#include <set>
+#include <utility>
+
+
+namespace
+{
+
+const kvs::UInt16 LittleEndian = 0x4949; // 'II'
+const size_t NoCompression = 1;
+const size_t PackBitsCompression = 32773;
+
+/*===========================================================================*/
+/**
+ *  @brief  Layout of the strips of a page.
+ */
+/*===========================================================================*/
+struct PageLayout
+{
+    size_t width; ///< width
+    size_t height; ///< height
+    size_t bits_per_pixel; ///< bits per pixel (sum of the bits per sample)
+    size_t compression; ///< compression mode
+    size_t rows_per_strip; ///< rows per strip
+    std::vector<size_t> offsets; ///< offsets to the strips
+    std::vector<size_t> bytes; ///< byte counts of the strips
+
+    size_t rowBytes() const { return ( width * bits_per_pixel + 7 ) / 8; }
+    size_t pageBytes() const { return height * this->rowBytes(); }
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the entry of the given tag in the IFD.
+ *  @param  ifd [in] IFD
+ *  @param  tag [in] tag
+ *  @return pointer to the entry (NULL if not found)
+ */
+/*===========================================================================*/
+const kvs::tiff::Entry* FindEntry( const kvs::tiff::ImageFileDirectory& ifd, const kvs::UInt16 tag )
+{
+    kvs::tiff::ImageFileDirectory::EntryList::const_iterator entry;
+    entry = std::find( ifd.entryList().begin(), ifd.entryList().end(), kvs::tiff::Entry( tag ) );
+    return entry != ifd.entryList().end() ? &(*entry) : NULL;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the layout of the strips of the page.
+ *  @param  ifd [in] IFD of the page
+ *  @param  layout [out] layout of the strips
+ *  @return true, if the layout is obtained successfully
+ */
+/*===========================================================================*/
+bool GetPageLayout( const kvs::tiff::ImageFileDirectory& ifd, PageLayout* layout )
+{
+    const kvs::tiff::Entry* width = FindEntry( ifd, 256 ); // ImageWidth
+    const kvs::tiff::Entry* height = FindEntry( ifd, 257 ); // ImageLength
+    const kvs::tiff::Entry* bits = FindEntry( ifd, 258 ); // BitsPerSample
+    const kvs::tiff::Entry* compression = FindEntry( ifd, 259 ); // Compression
+    const kvs::tiff::Entry* offsets = FindEntry( ifd, 273 ); // StripOffsets
+    const kvs::tiff::Entry* rows_per_strip = FindEntry( ifd, 278 ); // RowsPerStrip
+    const kvs::tiff::Entry* bytes = FindEntry( ifd, 279 ); // StripByteCounts
+    if ( !width || !height || !offsets || !bytes ) return false;
+    if ( offsets->values().size() != bytes->values().size() ) return false;
+
+    layout->width = width->values()[0].to<size_t>();
+    layout->height = height->values()[0].to<size_t>();
+    layout->bits_per_pixel = bits ? 0 : 1;
+    for ( size_t i = 0; bits && i < bits->values().size(); i++ )
+    {
+        layout->bits_per_pixel += bits->values()[i].to<size_t>();
+    }
+    layout->compression = compression ? compression->values()[0].to<size_t>() : ::NoCompression;
+    layout->rows_per_strip = rows_per_strip ? rows_per_strip->values()[0].to<size_t>() : layout->height;
+    layout->rows_per_strip = kvs::Math::Max( size_t(1), kvs::Math::Min( layout->rows_per_strip, layout->height ) );
+
+    // The offsets and the byte counts are stored as Short or Long.
+    const size_t nstrips = offsets->values().size();
+    layout->offsets.resize( nstrips );
+    layout->bytes.resize( nstrips );
+    for ( size_t i = 0; i < nstrips; i++ )
+    {
+        layout->offsets[i] = offsets->values()[i].to<size_t>();
+        layout->bytes[i] = bytes->values()[i].to<size_t>();
+    }
+
+    return nstrips * layout->rows_per_strip >= layout->height;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Decodes the PackBits compressed data.
+ *  @param  src [in] pointer to the compressed data
+ *  @param  src_size [in] size of the compressed data in bytes
+ *  @param  dst [out] pointer to the decoded data
+ *  @param  dst_size [in] size of the decoded data in bytes
+ *  @return true, if the data is decoded to dst_size bytes
+ */
+/*===========================================================================*/
+bool DecodePackBits( const kvs::UInt8* src, const size_t src_size, kvs::UInt8* dst, const size_t dst_size )
+{
+    size_t i = 0;
+    size_t j = 0;
+    while ( i < src_size && j < dst_size )
+    {
+        const int n = static_cast<signed char>( src[ i++ ] );
+        if ( n >= 0 )
+        {
+            // Literal run of n+1 bytes.
+            const size_t length = kvs::Math::Min( size_t( n + 1 ), kvs::Math::Min( src_size - i, dst_size - j ) );
+            std::copy( src + i, src + i + length, dst + j );
+            i += length;
+            j += length;
+        }
+        else if ( n != -128 && i < src_size )
+        {
+            // Replicate run of 1-n bytes (-128 is a no-op).
+            const size_t length = kvs::Math::Min( size_t( 1 - n ), dst_size - j );
+            std::fill( dst + j, dst + j + length, src[ i++ ] );
+            j += length;
+        }
+    }
+
+    return j == dst_size;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Reads the strip of the page.
+ *  @param  ifs [in] input file stream
+ *  @param  layout [in] layout of the strips of the page
+ *  @param  strip [in] strip index
+ *  @param  page [out] pointer to the page data
+ *  @param  buffer [in,out] buffer for the compressed data
+ *  @return true, if the strip is read successfully
+ */
+/*===========================================================================*/
+bool ReadStrip(
+    std::ifstream& ifs,
+    const PageLayout& layout,
+    const size_t strip,
+    kvs::UInt8* page,
+    std::vector<kvs::UInt8>* buffer )
+{
+    const size_t row = strip * layout.rows_per_strip;
+    if ( row >= layout.height ) return true;
+
+    const size_t nrows = kvs::Math::Min( layout.rows_per_strip, layout.height - row );
+    const size_t size = nrows * layout.rowBytes();
+    kvs::UInt8* data = page + row * layout.rowBytes();
+
+    ifs.clear();
+    ifs.seekg( layout.offsets[ strip ], std::ios::beg );
+    if ( layout.compression == ::PackBitsCompression )
+    {
+        buffer->resize( kvs::Math::Max( layout.bytes[ strip ], size_t(1) ) );
+        ifs.read( reinterpret_cast<char*>( &(*buffer)[0] ), layout.bytes[ strip ] );
+        if ( size_t( ifs.gcount() ) != layout.bytes[ strip ] ) return false;
+        return ::DecodePackBits( &(*buffer)[0], layout.bytes[ strip ], data, size );
+    }
+
+    // The strip is read directly into the page. The byte count might be
+    // larger than the size of the strip because of the padding.
+    const size_t bytes = kvs::Math::Min( layout.bytes[ strip ], size );
+    ifs.read( reinterpret_cast<char*>( data ), bytes );
+    if ( size_t( ifs.gcount() ) != bytes ) return false;
+    std::fill( data + bytes, data + size, kvs::UInt8(0) );
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  PageReader class that reads a range of the strips of the pages.
+ *
+ *  Each reader has its own file stream, and reads the strips directly into
+ *  the pages of the destination.
+ */
+/*===========================================================================*/
+class PageReader : public kvs::Thread
+{
+public:
+
+    typedef std::pair<size_t,size_t> Strip; ///< pair of the page index and the strip index
+
+private:
+
+    std::string m_filename; ///< filename
+    const std::vector<PageLayout>* m_layouts; ///< layouts of the pages
+    const std::vector<Strip>* m_strips; ///< strips of all the pages
+    kvs::UInt8* m_data; ///< destination
+    size_t m_begin; ///< first strip
+    size_t m_end; ///< last strip + 1
+    bool m_success; ///< true, if the strips are read successfully
+
+public:
+
+    PageReader():
+        m_layouts( NULL ),
+        m_strips( NULL ),
+        m_data( NULL ),
+        m_begin( 0 ),
+        m_end( 0 ),
+        m_success( true ) {}
+
+    void init(
+        const std::string& filename,
+        const std::vector<PageLayout>* layouts,
+        const std::vector<Strip>* strips,
+        kvs::UInt8* data,
+        const size_t begin,
+        const size_t end )
+    {
+        m_filename = filename;
+        m_layouts = layouts;
+        m_strips = strips;
+        m_data = data;
+        m_begin = begin;
+        m_end = end;
+    }
+
+    bool isSuccess() const { return m_success; }
+
+    void run()
+    {
+        std::ifstream ifs( m_filename.c_str(), std::ios::binary | std::ios::in );
+        if ( !ifs.is_open() ) { m_success = false; return; }
+
+        std::vector<kvs::UInt8> buffer;
+        for ( size_t i = m_begin; i < m_end; i++ )
+        {
+            const size_t page = (*m_strips)[i].first;
+            const size_t strip = (*m_strips)[i].second;
+            const PageLayout& layout = (*m_layouts)[ page ];
+            kvs::UInt8* data = m_data + page * layout.pageBytes();
+            if ( !::ReadStrip( ifs, layout, strip, data, &buffer ) ) { m_success = false; }
+        }
+    }
+};
+
+} // end of namespace
 
 
 namespace kvs
@@ -33,7 +278,13 @@ bool Tiff::CheckExtension( const std::string& filename )
     return false;
 }
 
-Tiff::Tiff()
+Tiff::Tiff():
+    m_width( 0 ),
+    m_height( 0 ),
+    m_bits_per_sample( 0 ),
+    m_color_mode( Tiff::UnknownColorMode ),
+    m_header_only( false ),
+    m_nthreads( 0 )
 {
 }
 
@@ -41,7 +292,9 @@ Tiff::Tiff( const std::string& filename ):
     m_width( 0 ),
     m_height( 0 ),
     m_bits_per_sample( 0 ),
-    m_color_mode( Tiff::UnknownColorMode )
+    m_color_mode( Tiff::UnknownColorMode ),
+    m_header_only( false ),
+    m_nthreads( 0 )
 {
     this->read( filename );
 }
@@ -61,6 +314,16 @@ const Tiff::IFD& Tiff::ifd() const
     return m_ifd;
 }
 
+const Tiff::IFD& Tiff::ifd( const size_t page ) const
+{
+    return m_ifd_list[ page ];
+}
+
+size_t Tiff::numberOfPages() const
+{
+    return m_ifd_list.size();
+}
+
 size_t Tiff::width() const
 {
     return m_width;
@@ -90,7 +353,14 @@ bool Tiff::isSupported() const
 {
     bool ret = true;
 
-    if ( this->get_compression_mode() != 1 )
+    if ( m_header.magic() != ::LittleEndian )
+    {
+        kvsMessageError("Not supported big-endian TIFF image.");
+        ret = false;
+    }
+
+    const size_t compression = this->get_compression_mode();
+    if ( compression != ::NoCompression && compression != ::PackBitsCompression )
     {
         kvsMessageError("Not supported compressed TIFF image.");
         ret = false;
@@ -99,12 +369,59 @@ bool Tiff::isSupported() const
     return ret;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Checks whether the pages can be stacked as a volume.
+ *  @return true, if all the pages are the gray images of the same size
+ */
+/*===========================================================================*/
+bool Tiff::isStack() const
+{
+    if ( !( m_color_mode == Tiff::Gray8 || m_color_mode == Tiff::Gray16 ) ) return false;
+
+    for ( size_t i = 0; i < m_ifd_list.size(); i++ )
+    {
+        ::PageLayout layout;
+        if ( !::GetPageLayout( m_ifd_list[i], &layout ) ) return false;
+        if ( layout.width != m_width || layout.height != m_height ) return false;
+        if ( layout.bits_per_pixel != m_bits_per_sample ) return false;
+    }
+
+    return true;
+}
+
+void Tiff::enableHeaderOnly()
+{
+    m_header_only = true;
+}
+
+void Tiff::disableHeaderOnly()
+{
+    m_header_only = false;
+}
+
+bool Tiff::isHeaderOnly() const
+{
+    return m_header_only;
+}
+
+void Tiff::setNumberOfThreads( const size_t nthreads )
+{
+    m_nthreads = nthreads;
+}
+
+size_t Tiff::numberOfThreads() const
+{
+    return m_nthreads;
+}
+
 void Tiff::print( std::ostream& os, const kvs::Indent& indent ) const
 {
     os << indent << "Filename : " << BaseClass::filename() << std::endl;
     os << indent << "Width : " << m_width << std::endl;
     os << indent << "Height : " << m_height << std::endl;
     os << indent << "Bits per sample : " << m_bits_per_sample << std::endl;
+    os << indent << "Number of pages : " << m_ifd_list.size() << std::endl;
 
     m_header.print( os, indent );
     m_ifd.print( os, indent );
@@ -134,6 +451,7 @@ bool Tiff::read( const std::string& filename )
         return false;
     }
 
+    m_ifd = Tiff::IFD();
     if ( !m_ifd.read( ifs ) )
     {
         kvsMessageError( "Cannot read IFD." );
@@ -142,6 +460,28 @@ bool Tiff::read( const std::string& filename )
         return false;
     }
 
+    // Follow the offsets to the next IFDs for the multi-page file. The
+    // visited offsets are recorded to stop at the cyclic link.
+    m_ifd_list.clear();
+    m_ifd_list.push_back( m_ifd );
+    std::set<kvs::UInt32> visited;
+    visited.insert( m_header.offset() );
+    kvs::UInt32 offset = m_ifd.offset();
+    while ( offset != 0 && visited.insert( offset ).second )
+    {
+        Tiff::IFD ifd;
+        ifs.clear();
+        ifs.seekg( offset, std::ios::beg );
+        if ( !ifd.read( ifs ) )
+        {
+            kvsMessageError( "Cannot read IFD of the page %d.", int( m_ifd_list.size() ) );
+            break;
+        }
+
+        m_ifd_list.push_back( ifd );
+        offset = ifd.offset();
+    }
+
     // Chech whether this file is supported or not.
     if ( !this->isSupported() )
     {
@@ -155,13 +495,83 @@ bool Tiff::read( const std::string& filename )
     m_height          = this->get_height();
     m_bits_per_sample = this->get_bits_per_sample();
     m_color_mode      = this->get_color_mode();
-    m_raw_data        = this->get_raw_data( ifs );
+    if ( !m_header_only ) { m_raw_data = this->get_raw_data( ifs ); }
 
     ifs.close();
 
     return true;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Reads the raw data of all the pages.
+ *  @param  data [out] pointer to the data (width x height x number of pages)
+ *  @return true, if the pages are read successfully
+ *
+ *  The strips of all the pages are divided into the ranges, and read in
+ *  parallel by the threads directly into the pages of the data. Only the
+ *  pages that have the same size as the 0-th page can be read.
+ */
+/*===========================================================================*/
+bool Tiff::readPages( void* data ) const
+{
+    const size_t npages = m_ifd_list.size();
+    std::vector< ::PageLayout > layouts( npages );
+    std::vector< ::PageReader::Strip > strips;
+    for ( size_t i = 0; i < npages; i++ )
+    {
+        ::PageLayout& layout = layouts[i];
+        if ( !::GetPageLayout( m_ifd_list[i], &layout ) )
+        {
+            kvsMessageError( "Cannot find the strips of the page %d.", int(i) );
+            return false;
+        }
+
+        if ( layout.width != m_width || layout.height != m_height || layout.bits_per_pixel != m_bits_per_sample )
+        {
+            kvsMessageError( "The size of the page %d is different from the 0-th page.", int(i) );
+            return false;
+        }
+
+        if ( layout.compression != ::NoCompression && layout.compression != ::PackBitsCompression )
+        {
+            kvsMessageError( "Not supported compressed TIFF image (page %d).", int(i) );
+            return false;
+        }
+
+        const size_t nstrips = ( layout.height + layout.rows_per_strip - 1 ) / layout.rows_per_strip;
+        for ( size_t j = 0; j < nstrips; j++ ) { strips.push_back( ::PageReader::Strip( i, j ) ); }
+    }
+
+    // Read the strips in parallel. The first range is read by the calling thread.
+    size_t nthreads = m_nthreads;
+    if ( nthreads == 0 ) nthreads = kvs::SystemInformation::NumberOfProcessors();
+    nthreads = kvs::Math::Max( size_t(1), kvs::Math::Min( nthreads, strips.size() ) );
+
+    kvs::UInt8* pdata = static_cast<kvs::UInt8*>( data );
+    std::vector< ::PageReader > readers( nthreads );
+    for ( size_t i = 0; i < nthreads; i++ )
+    {
+        const size_t begin = strips.size() * i / nthreads;
+        const size_t end = strips.size() * ( i + 1 ) / nthreads;
+        readers[i].init( BaseClass::filename(), &layouts, &strips, pdata, begin, end );
+    }
+    for ( size_t i = 1; i < nthreads; i++ ) { if ( !readers[i].start() ) { readers[i].run(); } }
+    readers[0].run();
+    for ( size_t i = 1; i < nthreads; i++ ) { if ( readers[i].isRunning() ) { readers[i].wait(); } }
+
+    for ( size_t i = 0; i < nthreads; i++ )
+    {
+        if ( !readers[i].isSuccess() )
+        {
+            kvsMessageError( "Cannot read the strips of %s.", BaseClass::filename().c_str() );
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool Tiff::write( const std::string& filename )
 {
     kvs::IgnoreUnusedVariable( filename );
@@ -464,46 +874,38 @@ kvs::AnyValueArray Tiff::get_raw_data( std::ifstream& ifs ) const
 {
     kvs::AnyValueArray raw_data;
 
-    const kvs::AnyValueArray offsets = this->get_strip_offsets();
-    const kvs::AnyValueArray bytes   = this->get_strip_bytes();
-    const size_t             count   = offsets.size();
-
-    kvs::ValueArray<kvs::UInt32> offset = offsets.asValueArray<kvs::UInt32>();
-    kvs::ValueArray<kvs::UInt32> byte = bytes.asValueArray<kvs::UInt32>();
+    ::PageLayout layout;
+    if ( !::GetPageLayout( m_ifd, &layout ) )
+    {
+        kvsMessageError("Cannot find the strips in 0th-IFD.");
+        return raw_data;
+    }
 
     if ( m_color_mode == Tiff::Gray8 )
     {
         raw_data.allocate<kvs::UInt8>( m_width * m_height );
-        kvs::UInt8* data = reinterpret_cast<kvs::UInt8*>( raw_data.data() );
-        for ( size_t i = 0; i < count; i++ )
-        {
-            ifs.seekg( offset[i], std::ios::beg );
-            ifs.read( reinterpret_cast<char*>( data ), byte[i] );
-            data += byte[i] / sizeof( kvs::UInt8 );
-        }
     }
 
     else if ( m_color_mode == Tiff::Gray16 )
     {
         raw_data.allocate<kvs::UInt16>( m_width * m_height );
-        kvs::UInt16* data = reinterpret_cast<kvs::UInt16*>( raw_data.data() );
-        for ( size_t i = 0; i < count; i++ )
-        {
-            ifs.seekg( offset[i], std::ios::beg );
-            ifs.read( reinterpret_cast<char*>( data ), byte[i] );
-            data += byte[i] / sizeof( kvs::UInt16 );
-        }
     }
 
     else if ( m_color_mode == Tiff::Color24 )
     {
         raw_data.allocate<kvs::UInt8>( m_width * m_height * 3 );
-        kvs::UInt8* data = reinterpret_cast<kvs::UInt8*>( raw_data.data() );
-        for ( size_t i = 0; i < count; i++ )
+    }
+
+    if ( raw_data.byteSize() < layout.pageBytes() ) return kvs::AnyValueArray();
+
+    std::vector<kvs::UInt8> buffer;
+    kvs::UInt8* data = static_cast<kvs::UInt8*>( raw_data.data() );
+    for ( size_t i = 0; i < layout.offsets.size(); i++ )
+    {
+        if ( !::ReadStrip( ifs, layout, i, data, &buffer ) )
         {
-            ifs.seekg( offset[i], std::ios::beg );
-            ifs.read( reinterpret_cast<char*>( data ), byte[i] );
-            data += byte[i] / sizeof( kvs::UInt8 );
+            kvsMessageError("Cannot read the strip %d in 0th-IFD.", int(i) );
+            break;
         }
     }
 
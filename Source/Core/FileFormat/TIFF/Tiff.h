@@ -20,6 +20,7 @@
 #include <kvs/AnyValueArray>
 #include <kvs/Indent>
 #include <iostream>
+#include <vector>
 #include "Header.h"
 #include "ImageFileDirectory.h"
 
@@ -49,11 +50,14 @@ private:
 
     Tiff::Header m_header; ///< header information
     Tiff::IFD m_ifd; ///< 0-th IFD
+    std::vector<Tiff::IFD> m_ifd_list; ///< IFDs of all the pages
     size_t m_width; ///< width
     size_t m_height; ///< height
     size_t m_bits_per_sample; ///< bits per channel (sample)
     ColorMode m_color_mode; ///< color mode
-    kvs::AnyValueArray m_raw_data; ///< raw data
+    kvs::AnyValueArray m_raw_data; ///< raw data of the 0-th page
+    bool m_header_only; ///< if true, the raw data is not read
+    size_t m_nthreads; ///< number of threads for reading the pages (0: number of processors)
 
 public:
 
@@ -67,15 +71,25 @@ public:
 
     const Tiff::Header& header() const;
     const Tiff::IFD& ifd() const;
+    const Tiff::IFD& ifd( const size_t page ) const;
+    size_t numberOfPages() const;
     size_t width() const;
     size_t height() const;
     size_t bitsPerSample() const;
     ColorMode colorMode() const;
     const kvs::AnyValueArray& rawData() const;
     bool isSupported() const;
+    bool isStack() const;
+
+    void enableHeaderOnly();
+    void disableHeaderOnly();
+    bool isHeaderOnly() const;
+    void setNumberOfThreads( const size_t nthreads );
+    size_t numberOfThreads() const;
 
     void print( std::ostream& os, const kvs::Indent& indent = kvs::Indent(0) ) const;
     bool read( const std::string& filename );
+    bool readPages( void* data ) const;
 
 private:
 
@@ -15,10 +15,12 @@
 #define KVS__MATRIX_H_INCLUDE
 
 #include <iostream>
+#include <algorithm>
 #include <kvs/DebugNew>
 #include <kvs/Assert>
 #include <kvs/Math>
 #include <kvs/Vector>
+#include <kvs/MatrixKernel>
 #include <kvs/Deprecated>
 
 
@@ -28,6 +30,9 @@ namespace kvs
 /*==========================================================================*/
 /**
  *  mxn matrix class.
+ *
+ *  The elements are stored in a contiguous array in row-major order, and
+ *  the row vectors returned by operator [] refer to the rows of the array.
  */
 /*==========================================================================*/
 template<typename T>
@@ -36,7 +41,8 @@ class Matrix
 private:
     size_t          m_nrows;    ///< Number of rows.
     size_t          m_ncolumns; ///< Number of columns.
-    kvs::Vector<T>* m_rows;     ///< Row vectors.
+    T*              m_elements; ///< Elements in row-major order.
+    kvs::Vector<T>* m_rows;     ///< Row vectors referring to the elements.
 
 public:
     Matrix();
@@ -53,6 +59,8 @@ public:
 
     size_t rowSize() const;
     size_t columnSize() const;
+    T* data() { return m_elements; }
+    const T* data() const { return m_elements; }
 
     void zero();
     void identity();
@@ -83,7 +91,7 @@ public:
     friend bool operator ==( const Matrix& lhs, const Matrix& rhs )
     {
         const size_t nrows = lhs.rowSize();
-        if ( nrows != lhs.rowSize() )
+        if ( nrows != rhs.rowSize() || lhs.columnSize() != rhs.columnSize() )
             return false;
 
         for ( size_t r = 0; r < nrows; ++r )
@@ -118,18 +126,13 @@ public:
         const size_t N = rhs.columnSize();
 
         Matrix result( L, N );
+        if ( L == 0 || M == 0 || N == 0 ) return result;
 
-        for ( size_t r = 0; r < L; ++r )
-        {
-            for ( size_t c = 0; c < N; ++c )
-            {
-                result[r][c] = T( 0 );
-                for ( size_t k = 0; k < M; ++k )
-                {
-                    result[r][c] += lhs[r][k] * rhs[k][c];
-                }
-            }
-        }
+        kvs::MatrixKernel::Multiply(
+            L, N, M,
+            T( 1 ), lhs.data(), M,
+            rhs.data(), N,
+            T( 0 ), result.data(), N );
 
         return result;
     }
@@ -142,15 +145,12 @@ public:
         const size_t ncolumns = lhs.columnSize();
 
         kvs::Vector<T> result( nrows );
+        if ( nrows == 0 || ncolumns == 0 ) return result;
 
-        for ( size_t r = 0; r < nrows; ++r )
-        {
-            result[r] = T( 0 );
-            for ( size_t c = 0; c < ncolumns; ++c )
-            {
-                result[r] += lhs[r][c] * rhs[c];
-            }
-        }
+        kvs::MatrixKernel::MultiplyVector(
+            nrows, ncolumns,
+            lhs.data(), ncolumns,
+            &rhs[0], &result[0] );
 
         return result;
     }
@@ -163,15 +163,14 @@ public:
         const size_t ncolumns = rhs.columnSize();
 
         kvs::Vector<T> result( ncolumns );
+        if ( nrows == 0 || ncolumns == 0 ) return result;
 
-        for ( size_t c = 0; c < ncolumns; ++c )
-        {
-            result[c] = T( 0 );
-            for ( size_t r = 0; r < nrows; ++r )
-            {
-                result[c] += lhs[r] * rhs[r][c];
-            }
-        }
+        // Accumulate the rows with unit stride. ( result = lhs^t rhs )
+        kvs::MatrixKernel::Multiply(
+            1, ncolumns, nrows,
+            T( 1 ), &lhs[0], nrows,
+            rhs.data(), ncolumns,
+            T( 0 ), &result[0], ncolumns );
 
         return result;
     }
@@ -219,6 +218,7 @@ template <typename T>
 inline Matrix<T>::Matrix():
     m_nrows( 0 ),
     m_ncolumns( 0 ),
+    m_elements( 0 ),
     m_rows( 0 )
 {
 }
@@ -234,6 +234,7 @@ template<typename T>
 inline Matrix<T>::Matrix( const size_t nrows, const size_t ncolumns ):
     m_nrows( 0 ),
     m_ncolumns( 0 ),
+    m_elements( 0 ),
     m_rows( 0 )
 {
     this->setSize( nrows, ncolumns );
@@ -252,21 +253,11 @@ template<typename T>
 inline Matrix<T>::Matrix( const size_t nrows, const size_t ncolumns, const T* const elements ):
     m_nrows( 0 ),
     m_ncolumns( 0 ),
+    m_elements( 0 ),
     m_rows( 0 )
 {
     this->setSize( nrows, ncolumns );
-
-    Vector<T>* const m = m_rows;
-
-    size_t index = 0;
-    for ( size_t r = 0; r < nrows; ++r )
-    {
-        for ( size_t c = 0; c < ncolumns; ++c )
-        {
-            m[r][c]= elements[ index ];
-            ++index;
-        }
-    }
+    std::copy( elements, elements + nrows * ncolumns, m_elements );
 }
 
 /*==========================================================================*/
@@ -279,16 +270,11 @@ template <typename T>
 inline Matrix<T>::Matrix( const Matrix& other ):
     m_nrows( 0 ),
     m_ncolumns( 0 ),
+    m_elements( 0 ),
     m_rows( 0 )
 {
     this->setSize( other.rowSize(), other.columnSize() );
-
-    const size_t          nrows = this->rowSize();
-    kvs::Vector<T>* const m     = m_rows;
-    for ( size_t r = 0; r < nrows; ++r )
-    {
-        m[r] = other[r];
-    }
+    std::copy( other.m_elements, other.m_elements + m_nrows * m_ncolumns, m_elements );
 }
 
 /*==========================================================================*/
@@ -300,14 +286,10 @@ inline Matrix<T>::Matrix( const Matrix& other ):
 template <typename T>
 inline Matrix<T>& Matrix<T>::operator =( const Matrix& rhs )
 {
-    this->setSize( rhs.rowSize(), rhs.columnSize() );
+    if ( this == &rhs ) return *this;
 
-    const size_t          nrows = this->rowSize();
-    kvs::Vector<T>* const m     = m_rows;
-    for ( size_t r = 0; r < nrows; ++r )
-    {
-        m[r] = rhs[r];
-    }
+    this->setSize( rhs.rowSize(), rhs.columnSize() );
+    std::copy( rhs.m_elements, rhs.m_elements + m_nrows * m_ncolumns, m_elements );
     return *this;
 }
 
@@ -320,6 +302,7 @@ template<typename T>
 inline Matrix<T>::~Matrix()
 {
     delete [] m_rows;
+    delete [] m_elements;
 }
 
 /*==========================================================================*/
@@ -338,15 +321,18 @@ inline void Matrix<T>::setSize( const size_t nrows, const size_t ncolumns )
         m_ncolumns = ncolumns;
 
         delete [] m_rows;
+        delete [] m_elements;
         m_rows = NULL;
+        m_elements = NULL;
 
         if ( nrows != 0 && ncolumns != 0 )
         {
+            m_elements = new T[ nrows * ncolumns ];
             m_rows = new kvs::Vector<T>[ nrows ];
 
             for ( size_t r = 0; r < nrows; ++r )
             {
-                m_rows[r].setSize( ncolumns );
+                m_rows[r].attach( ncolumns, m_elements + r * ncolumns );
             }
         }
     }
@@ -386,12 +372,7 @@ inline size_t Matrix<T>::columnSize() const
 template<typename T>
 inline void Matrix<T>::zero()
 {
-    const size_t          nrows = this->rowSize();
-    kvs::Vector<T>* const m     = m_rows;
-    for ( size_t r = 0; r < nrows; ++r )
-    {
-        m[r].zero();
-    }
+    std::fill( m_elements, m_elements + m_nrows * m_ncolumns, T( 0 ) );
 }
 
 /*==========================================================================*/
@@ -426,6 +407,7 @@ inline void Matrix<T>::swap( Matrix& other )
 {
     std::swap( m_nrows, other.m_nrows );
     std::swap( m_ncolumns, other.m_ncolumns );
+    std::swap( m_elements, other.m_elements );
     std::swap( m_rows, other.m_rows );
 }
 
@@ -464,7 +446,7 @@ inline void Matrix<T>::transpose()
             }
         }
 
-        *this = result;
+        this->swap( result );
     }
 }
 
@@ -502,12 +484,14 @@ inline void Matrix<T>::invert()
         }
 
         // Forward elimination
-        const T diagonal_element = m[k][k];
+        T* const mk = m_elements + k * ncolumns;
+        T* const rk = result.m_elements + k * ncolumns;
+        const T diagonal_element = mk[k];
 
         for ( size_t c = 0; c < ncolumns; ++c )
         {
-            m[k][c]      /= diagonal_element;
-            result[k][c] /= diagonal_element;
+            mk[c] /= diagonal_element;
+            rk[c] /= diagonal_element;
         }
 
         for ( size_t r = 0; r < nrows; ++r )
@@ -515,15 +499,23 @@ inline void Matrix<T>::invert()
             // Skip the pivot_row.
             if ( r != k )
             {
-                const T value = m[r][k];
+                T* const mr = m_elements + r * ncolumns;
+                T* const rr = result.m_elements + r * ncolumns;
+                const T value = mr[k];
+                if ( value == T( 0 ) ) continue;
+                for( size_t c = k; c < ncolumns; ++c )
+                {
+                    mr[c] -= value * mk[c];
+                }
                 for( size_t c = 0; c < ncolumns; ++c )
                 {
-                    m[r][c]      -= value * m[k][c];
-                    result[r][c] -= value * result[k][c];
+                    rr[c] -= value * rk[c];
                 }
             }
         }
     }
+
+    this->swap( result );
 }
 
 /*==========================================================================*/
@@ -680,11 +672,11 @@ inline Matrix<T>& Matrix<T>::operator +=( const Matrix& rhs )
     KVS_ASSERT( this->rowSize() == rhs.rowSize() );
     KVS_ASSERT( this->columnSize() == rhs.columnSize() );
 
-    const size_t          nrows = this->rowSize();
-    kvs::Vector<T>* const m     = m_rows;
-    for ( size_t r = 0; r < nrows; ++r )
+    const size_t size = m_nrows * m_ncolumns;
+    const T* const r = rhs.m_elements;
+    for ( size_t i = 0; i < size; ++i )
     {
-        m[r] += rhs[r];
+        m_elements[i] += r[i];
     }
     return *this;
 }
@@ -695,11 +687,11 @@ inline Matrix<T>& Matrix<T>::operator -=( const Matrix& rhs )
     KVS_ASSERT( this->rowSize() == rhs.rowSize() );
     KVS_ASSERT( this->columnSize() == rhs.columnSize() );
 
-    const size_t          nrows = this->rowSize();
-    kvs::Vector<T>* const m     = m_rows;
-    for ( size_t r = 0; r < nrows; ++r )
+    const size_t size = m_nrows * m_ncolumns;
+    const T* const r = rhs.m_elements;
+    for ( size_t i = 0; i < size; ++i )
     {
-        m[r] -= rhs[r];
+        m_elements[i] -= r[i];
     }
     return *this;
 }
@@ -708,17 +700,17 @@ template<typename T>
 inline Matrix<T>& Matrix<T>::operator *=( const Matrix& rhs )
 {
     Matrix result( ( *this ) * rhs );
-    return *this = result;
+    this->swap( result );
+    return *this;
 }
 
 template<typename T>
 inline Matrix<T>& Matrix<T>::operator *=( const T rhs )
 {
-    const size_t          nrows = this->rowSize();
-    kvs::Vector<T>* const m     = m_rows;
-    for ( size_t r = 0; r < nrows; ++r )
+    const size_t size = m_nrows * m_ncolumns;
+    for ( size_t i = 0; i < size; ++i )
     {
-        m[r] *= rhs;
+        m_elements[i] *= rhs;
     }
     return *this;
 }
@@ -726,11 +718,10 @@ inline Matrix<T>& Matrix<T>::operator *=( const T rhs )
 template<typename T>
 inline Matrix<T>& Matrix<T>::operator /=( const T rhs )
 {
-    const size_t          nrows = this->rowSize();
-    kvs::Vector<T>* const m     = m_rows;
-    for ( size_t r = 0; r < nrows; ++r )
+    const size_t size = m_nrows * m_ncolumns;
+    for ( size_t i = 0; i < size; ++i )
     {
-        m[r] /= rhs;
+        m_elements[i] /= rhs;
     }
     return *this;
 }
@@ -0,0 +1,229 @@
+/*****************************************************************************/
+/**
+ *  @file   MatrixKernel.cpp
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#include "MatrixKernel.h"
+#include <vector>
+#include <kvs/Thread>
+#include <kvs/SystemInformation>
+
+
+namespace
+{
+
+const size_t MinOperationsPerThread = 1 << 20;
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the number of threads for the product.
+ *  @param  nrows [in] number of rows to be divided
+ *  @param  noperations [in] number of multiply-add operations
+ *  @return number of threads
+ */
+/*===========================================================================*/
+size_t NumberOfThreads( const size_t nrows, const size_t noperations )
+{
+    size_t nthreads = kvs::SystemInformation::NumberOfProcessors();
+    nthreads = kvs::Math::Min( nthreads, noperations / ::MinOperationsPerThread );
+    nthreads = kvs::Math::Min( nthreads, nrows );
+    return kvs::Math::Max( nthreads, size_t(1) );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Multiplier class that calculates a range of the rows of the product.
+ */
+/*===========================================================================*/
+template <typename T>
+class Multiplier : public kvs::Thread
+{
+private:
+
+    size_t m_begin; ///< first row
+    size_t m_end; ///< last row + 1
+    size_t m_n; ///< number of columns of the product
+    size_t m_k; ///< inner dimension
+    T m_alpha; ///< scale factor of A B
+    const T* m_a; ///< matrix A
+    size_t m_lda; ///< leading dimension of A
+    const T* m_b; ///< matrix B (NULL: matrix-vector product)
+    size_t m_ldb; ///< leading dimension of B
+    T m_beta; ///< scale factor of C
+    T* m_c; ///< matrix C or vector y
+    size_t m_ldc; ///< leading dimension of C
+    const T* m_x; ///< vector x
+
+public:
+
+    Multiplier():
+        m_begin( 0 ),
+        m_end( 0 ),
+        m_n( 0 ),
+        m_k( 0 ),
+        m_alpha( T(1) ),
+        m_a( NULL ),
+        m_lda( 0 ),
+        m_b( NULL ),
+        m_ldb( 0 ),
+        m_beta( T(0) ),
+        m_c( NULL ),
+        m_ldc( 0 ),
+        m_x( NULL ) {}
+
+    void initMatrix(
+        const size_t begin, const size_t end, const size_t n, const size_t k,
+        const T alpha, const T* a, const size_t lda, const T* b, const size_t ldb,
+        const T beta, T* c, const size_t ldc )
+    {
+        m_begin = begin; m_end = end; m_n = n; m_k = k;
+        m_alpha = alpha; m_a = a; m_lda = lda; m_b = b; m_ldb = ldb;
+        m_beta = beta; m_c = c; m_ldc = ldc;
+    }
+
+    void initVector(
+        const size_t begin, const size_t end, const size_t n,
+        const T* a, const size_t lda, const T* x, T* y )
+    {
+        m_begin = begin; m_end = end; m_n = n;
+        m_a = a; m_lda = lda; m_x = x; m_c = y;
+    }
+
+    void run()
+    {
+        if ( m_b )
+        {
+            kvs::MatrixKernel::MultiplyRows(
+                m_begin, m_end, m_n, m_k, m_alpha, m_a, m_lda, m_b, m_ldb, m_beta, m_c, m_ldc );
+        }
+        else
+        {
+            kvs::MatrixKernel::MultiplyVectorRows( m_begin, m_end, m_n, m_a, m_lda, m_x, m_c );
+        }
+    }
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Runs the multipliers. The first one is run by the calling thread.
+ *  @param  multipliers [in] multipliers
+ */
+/*===========================================================================*/
+template <typename T>
+void Run( std::vector< ::Multiplier<T> >& multipliers )
+{
+    const size_t nthreads = multipliers.size();
+    for ( size_t i = 1; i < nthreads; i++ ) { if ( !multipliers[i].start() ) { multipliers[i].run(); } }
+    multipliers[0].run();
+    for ( size_t i = 1; i < nthreads; i++ ) { if ( multipliers[i].isRunning() ) { multipliers[i].wait(); } }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Calculates C = alpha A B + beta C with multiple threads.
+ */
+/*===========================================================================*/
+template <typename T>
+void ParallelMultiply(
+    const size_t m, const size_t n, const size_t k,
+    const T alpha, const T* a, const size_t lda, const T* b, const size_t ldb,
+    const T beta, T* c, const size_t ldc )
+{
+    const size_t nthreads = ::NumberOfThreads( m, m * n * k );
+    if ( nthreads == 1 )
+    {
+        kvs::MatrixKernel::MultiplyRows( 0, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc );
+        return;
+    }
+
+    std::vector< ::Multiplier<T> > multipliers( nthreads );
+    for ( size_t i = 0; i < nthreads; i++ )
+    {
+        const size_t begin = m * i / nthreads;
+        const size_t end = m * ( i + 1 ) / nthreads;
+        multipliers[i].initMatrix( begin, end, n, k, alpha, a, lda, b, ldb, beta, c, ldc );
+    }
+    ::Run( multipliers );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Calculates y = A x with multiple threads.
+ */
+/*===========================================================================*/
+template <typename T>
+void ParallelMultiplyVector(
+    const size_t m, const size_t n,
+    const T* a, const size_t lda, const T* x, T* y )
+{
+    const size_t nthreads = ::NumberOfThreads( m, m * n );
+    if ( nthreads == 1 )
+    {
+        kvs::MatrixKernel::MultiplyVectorRows( 0, m, n, a, lda, x, y );
+        return;
+    }
+
+    std::vector< ::Multiplier<T> > multipliers( nthreads );
+    for ( size_t i = 0; i < nthreads; i++ )
+    {
+        const size_t begin = m * i / nthreads;
+        const size_t end = m * ( i + 1 ) / nthreads;
+        multipliers[i].initVector( begin, end, n, a, lda, x, y );
+    }
+    ::Run( multipliers );
+}
+
+} // end of namespace
+
+
+namespace kvs
+{
+
+namespace MatrixKernel
+{
+
+template <>
+void Multiply<float>(
+    const size_t m, const size_t n, const size_t k,
+    const float alpha, const float* a, const size_t lda, const float* b, const size_t ldb,
+    const float beta, float* c, const size_t ldc )
+{
+    ::ParallelMultiply( m, n, k, alpha, a, lda, b, ldb, beta, c, ldc );
+}
+
+template <>
+void Multiply<double>(
+    const size_t m, const size_t n, const size_t k,
+    const double alpha, const double* a, const size_t lda, const double* b, const size_t ldb,
+    const double beta, double* c, const size_t ldc )
+{
+    ::ParallelMultiply( m, n, k, alpha, a, lda, b, ldb, beta, c, ldc );
+}
+
+template <>
+void MultiplyVector<float>(
+    const size_t m, const size_t n,
+    const float* a, const size_t lda, const float* x, float* y )
+{
+    ::ParallelMultiplyVector( m, n, a, lda, x, y );
+}
+
+template <>
+void MultiplyVector<double>(
+    const size_t m, const size_t n,
+    const double* a, const size_t lda, const double* x, double* y )
+{
+    ::ParallelMultiplyVector( m, n, a, lda, x, y );
+}
+
+} // end of namespace MatrixKernel
+
+} // end of namespace kvs
@@ -0,0 +1,209 @@
+/*****************************************************************************/
+/**
+ *  @file   MatrixKernel.h
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#ifndef KVS__MATRIX_KERNEL_H_INCLUDE
+#define KVS__MATRIX_KERNEL_H_INCLUDE
+
+#include <cstddef>
+#include <kvs/Math>
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Kernels of the products of the row-major matrices.
+ *
+ *  A matrix is given by the pointer to the first element and the leading
+ *  dimension (the distance between the first elements of the adjacent rows),
+ *  so that a sub-matrix can be passed without copying. The products are
+ *  blocked so that a block of the right-hand side matrix stays in the cache,
+ *  and the innermost loops run along the rows with unit stride so that the
+ *  compiler can vectorize them. The float and double versions are computed
+ *  by multiple threads for the large matrices.
+ */
+/*===========================================================================*/
+namespace MatrixKernel
+{
+
+const size_t RowBlockSize = 128; ///< number of rows of a block of the right-hand side matrix
+const size_t ColumnBlockSize = 256; ///< number of columns of a block of the right-hand side matrix
+
+/*===========================================================================*/
+/**
+ *  @brief  Calculates C = alpha A B + beta C for the specified rows of C.
+ *  @param  begin [in] first row of C
+ *  @param  end [in] last row of C + 1
+ *  @param  n [in] number of columns of B and C
+ *  @param  k [in] number of columns of A (rows of B)
+ *  @param  alpha [in] scale factor of A B
+ *  @param  a [in] matrix A (m x k)
+ *  @param  lda [in] leading dimension of A
+ *  @param  b [in] matrix B (k x n)
+ *  @param  ldb [in] leading dimension of B
+ *  @param  beta [in] scale factor of C
+ *  @param  c [in,out] matrix C (m x n)
+ *  @param  ldc [in] leading dimension of C
+ */
+/*===========================================================================*/
+template <typename T>
+inline void MultiplyRows(
+    const size_t begin,
+    const size_t end,
+    const size_t n,
+    const size_t k,
+    const T alpha,
+    const T* a,
+    const size_t lda,
+    const T* b,
+    const size_t ldb,
+    const T beta,
+    T* c,
+    const size_t ldc )
+{
+    for ( size_t i = begin; i < end; i++ )
+    {
+        T* ci = c + i * ldc;
+        if ( beta == T(0) ) { for ( size_t j = 0; j < n; j++ ) { ci[j] = T(0); } }
+        else if ( beta != T(1) ) { for ( size_t j = 0; j < n; j++ ) { ci[j] *= beta; } }
+    }
+
+    for ( size_t kk = 0; kk < k; kk += RowBlockSize )
+    {
+        const size_t kend = kvs::Math::Min( kk + RowBlockSize, k );
+        for ( size_t jj = 0; jj < n; jj += ColumnBlockSize )
+        {
+            const size_t nj = kvs::Math::Min( jj + ColumnBlockSize, n ) - jj;
+            for ( size_t i = begin; i < end; i++ )
+            {
+                const T* ai = a + i * lda;
+                T* ci = c + i * ldc + jj;
+                for ( size_t l = kk; l < kend; l++ )
+                {
+                    const T ail = alpha * ai[l];
+                    if ( ail == T(0) ) { continue; }
+                    const T* bl = b + l * ldb + jj;
+                    for ( size_t j = 0; j < nj; j++ ) { ci[j] += ail * bl[j]; }
+                }
+            }
+        }
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Calculates y = A x for the specified rows of A.
+ *  @param  begin [in] first row of A
+ *  @param  end [in] last row of A + 1
+ *  @param  n [in] number of columns of A
+ *  @param  a [in] matrix A (m x n)
+ *  @param  lda [in] leading dimension of A
+ *  @param  x [in] vector x (n)
+ *  @param  y [out] vector y (m)
+ */
+/*===========================================================================*/
+template <typename T>
+inline void MultiplyVectorRows(
+    const size_t begin,
+    const size_t end,
+    const size_t n,
+    const T* a,
+    const size_t lda,
+    const T* x,
+    T* y )
+{
+    for ( size_t i = begin; i < end; i++ )
+    {
+        // Four partial sums break the dependency chain of the accumulation.
+        const T* ai = a + i * lda;
+        T sum[4] = { T(0), T(0), T(0), T(0) };
+        size_t j = 0;
+        for ( ; j + 4 <= n; j += 4 )
+        {
+            sum[0] += ai[j+0] * x[j+0];
+            sum[1] += ai[j+1] * x[j+1];
+            sum[2] += ai[j+2] * x[j+2];
+            sum[3] += ai[j+3] * x[j+3];
+        }
+        for ( ; j < n; j++ ) { sum[0] += ai[j] * x[j]; }
+        y[i] = ( sum[0] + sum[1] ) + ( sum[2] + sum[3] );
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Calculates C = alpha A B + beta C.
+ *  @param  m [in] number of rows of A and C
+ *  @param  n [in] number of columns of B and C
+ *  @param  k [in] number of columns of A (rows of B)
+ *  @param  alpha [in] scale factor of A B
+ *  @param  a [in] matrix A (m x k)
+ *  @param  lda [in] leading dimension of A
+ *  @param  b [in] matrix B (k x n)
+ *  @param  ldb [in] leading dimension of B
+ *  @param  beta [in] scale factor of C
+ *  @param  c [in,out] matrix C (m x n), which must not overlap A and B
+ *  @param  ldc [in] leading dimension of C
+ */
+/*===========================================================================*/
+template <typename T>
+inline void Multiply(
+    const size_t m,
+    const size_t n,
+    const size_t k,
+    const T alpha,
+    const T* a,
+    const size_t lda,
+    const T* b,
+    const size_t ldb,
+    const T beta,
+    T* c,
+    const size_t ldc )
+{
+    MultiplyRows( 0, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Calculates y = A x.
+ *  @param  m [in] number of rows of A
+ *  @param  n [in] number of columns of A
+ *  @param  a [in] matrix A (m x n)
+ *  @param  lda [in] leading dimension of A
+ *  @param  x [in] vector x (n)
+ *  @param  y [out] vector y (m), which must not overlap A and x
+ */
+/*===========================================================================*/
+template <typename T>
+inline void MultiplyVector(
+    const size_t m,
+    const size_t n,
+    const T* a,
+    const size_t lda,
+    const T* x,
+    T* y )
+{
+    MultiplyVectorRows( 0, m, n, a, lda, x, y );
+}
+
+template <> void Multiply<float>( const size_t, const size_t, const size_t, const float, const float*, const size_t, const float*, const size_t, const float, float*, const size_t );
+template <> void Multiply<double>( const size_t, const size_t, const size_t, const double, const double*, const size_t, const double*, const size_t, const double, double*, const size_t );
+template <> void MultiplyVector<float>( const size_t, const size_t, const float*, const size_t, const float*, float* );
+template <> void MultiplyVector<double>( const size_t, const size_t, const double*, const size_t, const double*, double* );
+
+} // end of namespace MatrixKernel
+
+} // end of namespace kvs
+
+#endif // KVS__MATRIX_KERNEL_H_INCLUDE
@@ -17,14 +17,18 @@
 #include <iostream>
 #include <vector>
 #include <cstring>
+#include <algorithm>
 #include <kvs/DebugNew>
 #include <kvs/Assert>
+#include <kvs/Message>
 #include <kvs/Math>
 
 
 namespace kvs
 {
 
+template <typename T> class Matrix;
+
 /*==========================================================================*/
 /**
  *  n-D vector class.
@@ -36,6 +40,9 @@ class Vector
 private:
     size_t m_size;     ///< Vector size( dimension ).
     T*     m_elements; ///< Array of elements.
+    bool   m_owner;    ///< true if this vector owns the elements.
+
+    template <typename U> friend class kvs::Matrix;
 
 public:
     explicit Vector( const size_t size = 0 );
@@ -73,6 +80,10 @@ public:
 
     const Vector operator -() const;
 
+private:
+    void attach( const size_t size, T* elements );
+    bool is_resizable( const size_t size ) const;
+
 public:
     friend bool operator ==( const Vector& lhs, const Vector& rhs )
     {
@@ -148,7 +159,8 @@ public:
 template <typename T>
 inline Vector<T>::Vector( const size_t size ):
     m_size( 0 ),
-    m_elements( 0 )
+    m_elements( 0 ),
+    m_owner( true )
 {
     this->setSize( size );
     this->zero();
@@ -164,7 +176,8 @@ inline Vector<T>::Vector( const size_t size ):
 template <typename T>
 inline Vector<T>::Vector( const size_t size, const T* elements ):
     m_size( 0 ),
-    m_elements( 0 )
+    m_elements( 0 ),
+    m_owner( true )
 {
     this->setSize( size );
     memcpy( m_elements, elements, sizeof( T ) * this->size() );
@@ -179,7 +192,8 @@ inline Vector<T>::Vector( const size_t size, const T* elements ):
 template <typename T>
 inline Vector<T>::Vector( const std::vector<T>& std_vector ):
     m_size( 0 ),
-    m_elements( 0 )
+    m_elements( 0 ),
+    m_owner( true )
 {
     this->setSize( std_vector.size() );
     memcpy( m_elements, &std_vector[0], sizeof( T ) * this->size() );
@@ -193,7 +207,7 @@ inline Vector<T>::Vector( const std::vector<T>& std_vector ):
 template <typename T>
 inline Vector<T>::~Vector()
 {
-    delete [] m_elements;
+    if ( m_owner ) { delete [] m_elements; }
 }
 
 /*==========================================================================*/
@@ -205,7 +219,8 @@ inline Vector<T>::~Vector()
 template <typename T>
 inline Vector<T>::Vector( const Vector& other ):
     m_size( 0 ),
-    m_elements( 0 )
+    m_elements( 0 ),
+    m_owner( true )
 {
     this->setSize( other.size() );
     memcpy( m_elements, other.m_elements, sizeof( T ) * this->size() );
@@ -220,6 +235,8 @@ inline Vector<T>::Vector( const Vector& other ):
 template <typename T>
 inline Vector<T>& Vector<T>::operator =( const Vector& rhs )
 {
+    if ( !this->is_resizable( rhs.size() ) ) { return *this; }
+
     this->setSize( rhs.size() );
     memcpy( m_elements, rhs.m_elements, sizeof( T ) * this->size() );
     return *this;
@@ -234,6 +251,8 @@ inline Vector<T>& Vector<T>::operator =( const Vector& rhs )
 template <typename T>
 inline void Vector<T>::setSize( const size_t size )
 {
+    if ( !this->is_resizable( size ) ) { return; }
+
     if ( this->size() != size )
     {
         m_size = size;
@@ -287,8 +306,22 @@ inline void Vector<T>::zero()
 template<typename T>
 inline void Vector<T>::swap( Vector& other )
 {
-    std::swap( m_size, other.m_size );
-    std::swap( m_elements, other.m_elements );
+    if ( m_owner && other.m_owner )
+    {
+        std::swap( m_size, other.m_size );
+        std::swap( m_elements, other.m_elements );
+    }
+    else
+    {
+        // The elements of a row of a matrix are swapped in place.
+        if ( this->size() != other.size() )
+        {
+            kvsMessageError( "Cannot swap the vectors of the different sizes (%d and %d).",
+                             int( this->size() ), int( other.size() ) );
+            return;
+        }
+        std::swap_ranges( m_elements, m_elements + m_size, other.m_elements );
+    }
 }
 
 /*==========================================================================*/
@@ -471,6 +504,41 @@ inline const Vector<T> Vector<T>::operator -() const
     return Vector( *this ) *= T( -1 );
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Refers to the elements owned by others (e.g. a row of a matrix).
+ *  @param  size [in] Size of vector.
+ *  @param  elements [in] Array of elements.
+ */
+/*===========================================================================*/
+template <typename T>
+inline void Vector<T>::attach( const size_t size, T* elements )
+{
+    if ( m_owner ) { delete [] m_elements; }
+    m_size = size;
+    m_elements = elements;
+    m_owner = false;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Checks whether the vector can be resized.
+ *  @param  size [in] new size of vector
+ *  @return true, if the vector owns the elements or the size is not changed
+ *
+ *  A row of a matrix refers to the elements of the matrix and cannot be
+ *  resized (the elements must not be deleted).
+ */
+/*===========================================================================*/
+template <typename T>
+inline bool Vector<T>::is_resizable( const size_t size ) const
+{
+    if ( m_owner || this->size() == size ) { return true; }
+
+    kvsMessageError( "Cannot resize a row of a matrix (%d to %d).", int( this->size() ), int( size ) );
+    return false;
+}
+
 } // end of namespace kvs
 
 #endif // KVS__VECTOR_H_INCLUDE
@@ -136,7 +136,7 @@ kvs::TCPSocket* Acceptor::newConnection()
  *  @return received message size
  */
 /*===========================================================================*/
-int Acceptor::receive( kvs::MessageBlock* block, kvs::SocketAddress* client_address )
+kvs::Int64 Acceptor::receive( kvs::MessageBlock* block, kvs::SocketAddress* client_address )
 {
     return( m_handler->receive( block, client_address ) );
 }
@@ -43,7 +43,7 @@ public:
     void close();
     bool bind( const int port, const size_t ntrials );
     kvs::TCPSocket* newConnection();
-    int receive( kvs::MessageBlock* block, kvs::SocketAddress* client_address = 0 );
+    kvs::Int64 receive( kvs::MessageBlock* block, kvs::SocketAddress* client_address = 0 );
 
 private:
 
@@ -155,11 +155,12 @@ bool Connector::reconnect()
 /**
  *  @brief  Send the message block.
  *  @param  block [in] message block
+ *  @return sent message size
  */
 /*===========================================================================*/
-void Connector::send( const kvs::MessageBlock& block )
+kvs::Int64 Connector::send( const kvs::MessageBlock& block )
 {
-    m_handler->send( block );
+    return( m_handler->send( block ) );
 }
 
 /*===========================================================================*/
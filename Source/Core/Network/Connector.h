@@ -47,7 +47,7 @@ public:
     void close();
     bool connect( const kvs::IPAddress& ip, const int port, const size_t ntrials );
     bool reconnect();
-    void send( const kvs::MessageBlock& block );
+    kvs::Int64 send( const kvs::MessageBlock& block );
 
 private:
 
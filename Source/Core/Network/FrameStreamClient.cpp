@@ -0,0 +1,157 @@
+/*****************************************************************************/
+/**
+ *  @file   FrameStreamClient.cpp
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#include "FrameStreamClient.h"
+#include "FrameStreamCodec.h"
+#include <kvs/Message>
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new FrameStreamClient class.
+ */
+/*===========================================================================*/
+FrameStreamClient::FrameStreamClient():
+    m_width( 0 ),
+    m_height( 0 ),
+    m_has_key_frame( false ),
+    m_frame_size( 0 ),
+    m_nchanged_tiles( 0 )
+{
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Destroys the FrameStreamClient class.
+ */
+/*===========================================================================*/
+FrameStreamClient::~FrameStreamClient()
+{
+    this->disconnect();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Connects to the frame stream server.
+ *  @param  ip [in] IP address of the server
+ *  @param  port [in] port number
+ *  @param  timeout [in] timeout of the connection (NULL for blocking)
+ *  @return true if the connection is established
+ */
+/*===========================================================================*/
+bool FrameStreamClient::connect( const kvs::IPAddress& ip, const int port, const kvs::SocketTimer* timeout )
+{
+    this->disconnect();
+
+    m_socket.open();
+    if ( !m_socket.connect( ip, port, timeout ) )
+    {
+        kvsMessageError( "Cannot connect to the frame stream server. [%s]", m_socket.errorString().c_str() );
+        m_socket.close();
+        return false;
+    }
+
+    // The socket is non-blocking after the timed connection.
+    m_socket.enableBlocking();
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Closes the connection.
+ */
+/*===========================================================================*/
+void FrameStreamClient::disconnect()
+{
+    m_socket.close();
+    m_has_key_frame = false;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Receives a frame and reconstructs it.
+ *  @return true if the frame is reconstructed
+ */
+/*===========================================================================*/
+bool FrameStreamClient::receive()
+{
+    if ( m_socket.receive( &m_message ) <= 0 )
+    {
+        kvsMessageError( "Cannot receive the frame." );
+        return false;
+    }
+
+    const kvs::UInt8* data = static_cast<const kvs::UInt8*>( m_message.data() );
+    const kvs::UInt8* data_end = data + m_message.size();
+
+    kvs::FrameStreamCodec::FrameHeader header;
+    if ( !kvs::FrameStreamCodec::ReadFrameHeader( data, m_message.size(), &header ) )
+    {
+        kvsMessageError( "The received frame is broken." );
+        return false;
+    }
+
+    const bool key_frame = ( header.flags & kvs::FrameStreamCodec::KeyFrame ) != 0;
+    if ( key_frame )
+    {
+        if ( header.width != m_width || header.height != m_height )
+        {
+            m_frame.allocate( header.width * header.height * 3 );
+            m_width = header.width;
+            m_height = header.height;
+        }
+        m_has_key_frame = true;
+    }
+    else if ( !m_has_key_frame || header.width != m_width || header.height != m_height )
+    {
+        kvsMessageError( "The delta frame is received without the key frame." );
+        return false;
+    }
+
+    data += kvs::FrameStreamCodec::FrameHeaderSize;
+    for ( size_t i = 0; i < header.ntiles; i++ )
+    {
+        data = kvs::FrameStreamCodec::DecodeTile( data, data_end, header, &m_buffer, m_frame.data() );
+        if ( !data )
+        {
+            kvsMessageError( "The received tile is broken." );
+            m_has_key_frame = false;
+            return false;
+        }
+    }
+
+    m_frame_size = m_message.size();
+    m_nchanged_tiles = header.ntiles;
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Receives a frame and returns it as the color image.
+ *  @param  image [out] pointer to the color image
+ *  @return true if the frame is reconstructed
+ */
+/*===========================================================================*/
+bool FrameStreamClient::receive( kvs::ColorImage* image )
+{
+    if ( !this->receive() ) return false;
+
+    // The image has a copy of the frame, which is updated by the next frame.
+    *image = kvs::ColorImage( m_width, m_height, m_frame.clone() );
+    return true;
+}
+
+} // end of namespace kvs
@@ -0,0 +1,74 @@
+/*****************************************************************************/
+/**
+ *  @file   FrameStreamClient.h
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#ifndef KVS__FRAME_STREAM_CLIENT_H_INCLUDE
+#define KVS__FRAME_STREAM_CLIENT_H_INCLUDE
+
+#include <vector>
+#include <kvs/Type>
+#include <kvs/ValueArray>
+#include <kvs/ColorImage>
+#include <kvs/Noncopyable>
+#include <kvs/IPAddress>
+#include <kvs/SocketTimer>
+#include <kvs/TCPSocket>
+#include <kvs/MessageBlock>
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Client class that receives the frames from kvs::FrameStreamServer.
+ *
+ *  The frame is reconstructed by decoding the changed tiles into the previous
+ *  frame. The frames before the first key frame are not received, since the
+ *  server sends the frames to the new client from the key frame.
+ */
+/*===========================================================================*/
+class FrameStreamClient : private kvs::Noncopyable
+{
+private:
+
+    kvs::TCPSocket m_socket; ///< socket
+    kvs::MessageBlock m_message; ///< received frame
+    kvs::ValueArray<kvs::UInt8> m_frame; ///< reconstructed RGB frame
+    size_t m_width; ///< frame width
+    size_t m_height; ///< frame height
+    bool m_has_key_frame; ///< flag for the received key frame
+    size_t m_frame_size; ///< size of the last received frame [byte]
+    size_t m_nchanged_tiles; ///< number of the changed tiles of the last frame
+    std::vector<kvs::UInt8> m_buffer; ///< work buffer
+
+public:
+
+    FrameStreamClient();
+    ~FrameStreamClient();
+
+    size_t width() const { return m_width; }
+    size_t height() const { return m_height; }
+    const kvs::ValueArray<kvs::UInt8>& frame() const { return m_frame; }
+    size_t lastFrameSize() const { return m_frame_size; }
+    size_t lastNumberOfChangedTiles() const { return m_nchanged_tiles; }
+    bool isConnected() { return m_socket.isConnected(); }
+
+    bool connect( const kvs::IPAddress& ip, const int port, const kvs::SocketTimer* timeout = 0 );
+    void disconnect();
+    bool receive();
+    bool receive( kvs::ColorImage* image );
+};
+
+} // end of namespace kvs
+
+#endif // KVS__FRAME_STREAM_CLIENT_H_INCLUDE
@@ -0,0 +1,389 @@
+/*****************************************************************************/
+/**
+ *  @file   FrameStreamCodec.cpp
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#include "FrameStreamCodec.h"
+#include <cstddef>
+#include <cstring>
+#include <kvs/Math>
+
+
+namespace
+{
+
+const size_t MaxLiteralLength = 128; ///< max. length of the literal bytes
+const size_t MinRunLength = 3; ///< min. length of the repeated bytes
+const size_t MaxRunLength = 130; ///< max. length of the repeated bytes
+
+/*===========================================================================*/
+/**
+ *  @brief  Tile rectangle in the frame.
+ */
+/*===========================================================================*/
+struct Tile
+{
+    size_t x; ///< left of the tile
+    size_t y; ///< top of the tile
+    size_t width; ///< width of the tile
+    size_t height; ///< height of the tile
+
+    Tile( const size_t index, const size_t frame_width, const size_t frame_height, const size_t tile_size )
+    {
+        const size_t ntiles_x = ( frame_width + tile_size - 1 ) / tile_size;
+        x = ( index % ntiles_x ) * tile_size;
+        y = ( index / ntiles_x ) * tile_size;
+        width = kvs::Math::Min( tile_size, frame_width - x );
+        height = kvs::Math::Min( tile_size, frame_height - y );
+    }
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the pixel value reconstructed from the quantized level.
+ *  @param  level [in] quantized level
+ *  @param  bits [in] number of dropped bits
+ *  @return pixel value
+ */
+/*===========================================================================*/
+inline kvs::UInt8 Reconstruct( const kvs::UInt8 level, const size_t bits )
+{
+    return static_cast<kvs::UInt8>( bits == 0 ? level : ( level << bits ) | ( 1 << ( bits - 1 ) ) );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Compresses the bytes by run-length encoding.
+ *  @param  bytes [in] bytes
+ *  @param  size [in] number of bytes
+ *  @param  data [out] encoded data (appended)
+ *
+ *  A control byte c < 128 is followed by (c + 1) literal bytes, and c >= 128
+ *  is followed by a byte repeated (c - 125) times.
+ */
+/*===========================================================================*/
+void EncodeRunLength( const kvs::UInt8* bytes, const size_t size, std::vector<kvs::UInt8>* data )
+{
+    size_t i = 0;
+    size_t literal = 0; // start of the pending literal bytes
+    while ( i < size )
+    {
+        size_t run = 1;
+        while ( i + run < size && run < ::MaxRunLength && bytes[ i + run ] == bytes[i] ) run++;
+
+        if ( run >= ::MinRunLength || i + run == size )
+        {
+            const size_t end = run >= ::MinRunLength ? i : size;
+            while ( literal < end )
+            {
+                const size_t length = kvs::Math::Min( end - literal, ::MaxLiteralLength );
+                data->push_back( static_cast<kvs::UInt8>( length - 1 ) );
+                data->insert( data->end(), bytes + literal, bytes + literal + length );
+                literal += length;
+            }
+            if ( run >= ::MinRunLength )
+            {
+                data->push_back( static_cast<kvs::UInt8>( run + 125 ) );
+                data->push_back( bytes[i] );
+                literal = i + run;
+            }
+        }
+        i += run;
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Decompresses the run-length encoded bytes.
+ *  @param  data [in] encoded data
+ *  @param  size [in] size of the encoded data
+ *  @param  bytes [out] decoded bytes
+ *  @param  nbytes [in] number of the decoded bytes
+ *  @return true if the bytes are decoded
+ */
+/*===========================================================================*/
+bool DecodeRunLength( const kvs::UInt8* data, const size_t size, kvs::UInt8* bytes, const size_t nbytes )
+{
+    size_t i = 0;
+    size_t n = 0;
+    while ( i < size )
+    {
+        const size_t control = data[ i++ ];
+        if ( control < 128 )
+        {
+            const size_t length = control + 1;
+            if ( i + length > size || n + length > nbytes ) return false;
+            std::memcpy( bytes + n, data + i, length );
+            i += length;
+            n += length;
+        }
+        else
+        {
+            const size_t length = control - 125;
+            if ( i >= size || n + length > nbytes ) return false;
+            std::memset( bytes + n, data[ i++ ], length );
+            n += length;
+        }
+    }
+
+    return n == nbytes;
+}
+
+} // end of namespace
+
+
+namespace kvs
+{
+
+const kvs::UInt32 FrameStreamCodec::Magic;
+const size_t FrameStreamCodec::FrameHeaderSize;
+const size_t FrameStreamCodec::TileHeaderSize;
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the number of tiles of the frame.
+ *  @param  width [in] frame width
+ *  @param  height [in] frame height
+ *  @param  tile_size [in] tile size
+ *  @return number of tiles
+ */
+/*===========================================================================*/
+size_t FrameStreamCodec::NumberOfTiles( const size_t width, const size_t height, const size_t tile_size )
+{
+    return ( ( width + tile_size - 1 ) / tile_size ) * ( ( height + tile_size - 1 ) / tile_size );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Writes the 32-bit value in big-endian.
+ *  @param  data [out] pointer to the data
+ *  @param  value [in] value
+ */
+/*===========================================================================*/
+void FrameStreamCodec::WriteUInt32( kvs::UInt8* data, const kvs::UInt32 value )
+{
+    data[0] = static_cast<kvs::UInt8>( value >> 24 );
+    data[1] = static_cast<kvs::UInt8>( value >> 16 );
+    data[2] = static_cast<kvs::UInt8>( value >> 8 );
+    data[3] = static_cast<kvs::UInt8>( value );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Reads the 32-bit value in big-endian.
+ *  @param  data [in] pointer to the data
+ *  @return value
+ */
+/*===========================================================================*/
+kvs::UInt32 FrameStreamCodec::ReadUInt32( const kvs::UInt8* data )
+{
+    return
+        ( kvs::UInt32( data[0] ) << 24 ) | ( kvs::UInt32( data[1] ) << 16 ) |
+        ( kvs::UInt32( data[2] ) << 8 ) | kvs::UInt32( data[3] );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Writes the frame header.
+ *  @param  data [out] pointer to the data (FrameHeaderSize bytes)
+ *  @param  header [in] frame header
+ */
+/*===========================================================================*/
+void FrameStreamCodec::WriteFrameHeader( kvs::UInt8* data, const FrameHeader& header )
+{
+    WriteUInt32( data, Magic );
+    WriteUInt32( data + 4, static_cast<kvs::UInt32>( header.width ) );
+    WriteUInt32( data + 8, static_cast<kvs::UInt32>( header.height ) );
+    WriteUInt32( data + 12, static_cast<kvs::UInt32>( header.tile_size ) );
+    WriteUInt32( data + 16, static_cast<kvs::UInt32>( header.quantization ) );
+    WriteUInt32( data + 20, static_cast<kvs::UInt32>( header.flags ) );
+    WriteUInt32( data + 24, static_cast<kvs::UInt32>( header.ntiles ) );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Reads the frame header.
+ *  @param  data [in] pointer to the data
+ *  @param  size [in] size of the data
+ *  @param  header [out] frame header
+ *  @return true if the header is valid
+ */
+/*===========================================================================*/
+bool FrameStreamCodec::ReadFrameHeader( const kvs::UInt8* data, const size_t size, FrameHeader* header )
+{
+    if ( size < FrameHeaderSize || ReadUInt32( data ) != Magic ) return false;
+
+    header->width = ReadUInt32( data + 4 );
+    header->height = ReadUInt32( data + 8 );
+    header->tile_size = ReadUInt32( data + 12 );
+    header->quantization = ReadUInt32( data + 16 );
+    header->flags = static_cast<int>( ReadUInt32( data + 20 ) );
+    header->ntiles = ReadUInt32( data + 24 );
+
+    return header->tile_size > 0 && header->quantization < 8;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Encodes the tile of the frame.
+ *  @param  index [in] tile index
+ *  @param  header [in] frame header
+ *  @param  pixels [in] pixels of the frame
+ *  @param  nchannels [in] number of channels of the pixels (3: RGB, 4: RGBA)
+ *  @param  reference [in/out] RGB frame reconstructed by the decoder
+ *  @param  buffer [in] work buffer
+ *  @param  data [out] encoded tile (appended)
+ *  @return true if the tile is encoded, false if the tile is not changed
+ */
+/*===========================================================================*/
+bool FrameStreamCodec::EncodeTile(
+    const size_t index,
+    const FrameHeader& header,
+    const kvs::UInt8* pixels,
+    const size_t nchannels,
+    kvs::UInt8* reference,
+    std::vector<kvs::UInt8>* buffer,
+    std::vector<kvs::UInt8>* data )
+{
+    const ::Tile tile( index, header.width, header.height, header.tile_size );
+    const size_t bits = header.quantization;
+    const bool key_frame = ( header.flags & KeyFrame ) != 0;
+    const size_t row_size = tile.width * 3;
+
+    // Quantized levels of the tile.
+    buffer->resize( row_size * tile.height * 2 );
+    kvs::UInt8* levels = &(*buffer)[0];
+    kvs::UInt8* residuals = levels + row_size * tile.height;
+
+    bool changed = key_frame;
+    for ( size_t j = 0; j < tile.height; j++ )
+    {
+        const size_t offset = ( tile.y + j ) * header.width + tile.x;
+        const kvs::UInt8* src = pixels + offset * nchannels;
+        const kvs::UInt8* ref = reference + offset * 3;
+        kvs::UInt8* level = levels + j * row_size;
+        kvs::UInt8* residual = residuals + j * row_size;
+        for ( size_t i = 0; i < tile.width; i++, src += nchannels, ref += 3, level += 3, residual += 3 )
+        {
+            for ( size_t c = 0; c < 3; c++ )
+            {
+                level[c] = static_cast<kvs::UInt8>( src[c] >> bits );
+                const kvs::UInt8 predicted = key_frame ? ( i > 0 ? level[ c - 3 ] : 0 ) : static_cast<kvs::UInt8>( ref[c] >> bits );
+                residual[c] = static_cast<kvs::UInt8>( level[c] - predicted );
+                if ( residual[c] != 0 ) changed = true;
+            }
+        }
+    }
+
+    if ( !changed ) return false;
+
+    // Tile header, and the smaller of the run-length encoded residuals and
+    // the raw levels.
+    const size_t nbytes = row_size * tile.height;
+    const size_t start = data->size();
+    data->resize( start + TileHeaderSize );
+    EncodeRunLength( residuals, nbytes, data );
+
+    kvs::UInt8 method = RunLength;
+    if ( data->size() - start - TileHeaderSize >= nbytes )
+    {
+        method = Raw;
+        data->resize( start + TileHeaderSize );
+        data->insert( data->end(), levels, levels + nbytes );
+    }
+
+    kvs::UInt8* tile_header = &(*data)[ start ];
+    WriteUInt32( tile_header, static_cast<kvs::UInt32>( index ) );
+    WriteUInt32( tile_header + 4, static_cast<kvs::UInt32>( data->size() - start - TileHeaderSize ) );
+    tile_header[8] = method;
+
+    // Update the reference with the reconstructed pixels.
+    for ( size_t j = 0; j < tile.height; j++ )
+    {
+        kvs::UInt8* ref = reference + ( ( tile.y + j ) * header.width + tile.x ) * 3;
+        const kvs::UInt8* level = levels + j * row_size;
+        for ( size_t i = 0; i < row_size; i++ ) ref[i] = ::Reconstruct( level[i], bits );
+    }
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Decodes the tile into the frame.
+ *  @param  data [in] pointer to the encoded tile
+ *  @param  data_end [in] end of the encoded data
+ *  @param  header [in] frame header
+ *  @param  buffer [in] work buffer
+ *  @param  frame [in/out] RGB frame (the previous frame for the delta frame)
+ *  @return pointer to the next tile, or NULL if the tile is broken
+ */
+/*===========================================================================*/
+const kvs::UInt8* FrameStreamCodec::DecodeTile(
+    const kvs::UInt8* data,
+    const kvs::UInt8* data_end,
+    const FrameHeader& header,
+    std::vector<kvs::UInt8>* buffer,
+    kvs::UInt8* frame )
+{
+    if ( data_end - data < static_cast<ptrdiff_t>( TileHeaderSize ) ) return NULL;
+
+    const size_t index = ReadUInt32( data );
+    const size_t size = ReadUInt32( data + 4 );
+    const kvs::UInt8 method = data[8];
+    data += TileHeaderSize;
+    if ( index >= NumberOfTiles( header.width, header.height, header.tile_size ) ) return NULL;
+    if ( static_cast<size_t>( data_end - data ) < size ) return NULL;
+
+    const ::Tile tile( index, header.width, header.height, header.tile_size );
+    const size_t bits = header.quantization;
+    const bool key_frame = ( header.flags & KeyFrame ) != 0;
+    const size_t row_size = tile.width * 3;
+    const size_t nbytes = row_size * tile.height;
+
+    buffer->resize( nbytes );
+    kvs::UInt8* values = &(*buffer)[0];
+    if ( method == Raw )
+    {
+        if ( size != nbytes ) return NULL;
+        std::memcpy( values, data, nbytes );
+    }
+    else if ( method == RunLength )
+    {
+        if ( !DecodeRunLength( data, size, values, nbytes ) ) return NULL;
+    }
+    else
+    {
+        return NULL;
+    }
+
+    for ( size_t j = 0; j < tile.height; j++ )
+    {
+        kvs::UInt8* dst = frame + ( ( tile.y + j ) * header.width + tile.x ) * 3;
+        kvs::UInt8* value = values + j * row_size;
+        for ( size_t i = 0; i < row_size; i++ )
+        {
+            // The raw values are the levels, and the others are the residuals.
+            kvs::UInt8 level = value[i];
+            if ( method == RunLength )
+            {
+                const kvs::UInt8 predicted = key_frame ? ( i >= 3 ? value[ i - 3 ] : 0 ) : static_cast<kvs::UInt8>( dst[i] >> bits );
+                level = static_cast<kvs::UInt8>( level + predicted );
+                value[i] = level;
+            }
+            dst[i] = ::Reconstruct( level, bits );
+        }
+    }
+
+    return data + size;
+}
+
+} // end of namespace kvs
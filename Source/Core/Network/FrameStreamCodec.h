@@ -0,0 +1,103 @@
+/*****************************************************************************/
+/**
+ *  @file   FrameStreamCodec.h
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#ifndef KVS__FRAME_STREAM_CODEC_H_INCLUDE
+#define KVS__FRAME_STREAM_CODEC_H_INCLUDE
+
+#include <vector>
+#include <cstddef>
+#include <kvs/Type>
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Tile codec of the frames for kvs::FrameStreamServer and kvs::FrameStreamClient.
+ *
+ *  The frame is an RGB image divided into square tiles. A changed tile is
+ *  encoded as the residual from the previous frame (delta frame) or from
+ *  the left pixel (key frame), and the residual is compressed by run-length
+ *  encoding. For the lossy compression, the lower bits of the pixel values
+ *  are dropped (quantized) before the prediction, and the encoder predicts
+ *  from the frame reconstructed by the decoder so that the errors are not
+ *  accumulated over the frames.
+ *
+ *  Frame:
+ *    UInt32 magic, width, height, tile size, quantization bits, flags,
+ *    number of tiles, and the tiles (big-endian)
+ *  Tile:
+ *    UInt32 tile index, UInt32 data size, UInt8 method, and the data
+ */
+/*===========================================================================*/
+class FrameStreamCodec
+{
+public:
+
+    enum TileMethod
+    {
+        Raw = 0, ///< quantized pixel values
+        RunLength = 1 ///< run-length encoded residuals
+    };
+
+    enum FrameFlag
+    {
+        KeyFrame = 1 ///< all the tiles are predicted from the left pixels
+    };
+
+    struct FrameHeader
+    {
+        size_t width; ///< frame width
+        size_t height; ///< frame height
+        size_t tile_size; ///< tile size
+        size_t quantization; ///< number of dropped bits
+        int flags; ///< frame flags
+        size_t ntiles; ///< number of encoded tiles
+    };
+
+    static const kvs::UInt32 Magic = 0x4b565346; ///< 'KVSF'
+    static const size_t FrameHeaderSize = 28; ///< size of the frame header [byte]
+    static const size_t TileHeaderSize = 9; ///< size of the tile header [byte]
+
+public:
+
+    static size_t NumberOfTiles( const size_t width, const size_t height, const size_t tile_size );
+    static void WriteUInt32( kvs::UInt8* data, const kvs::UInt32 value );
+    static kvs::UInt32 ReadUInt32( const kvs::UInt8* data );
+    static void WriteFrameHeader( kvs::UInt8* data, const FrameHeader& header );
+    static bool ReadFrameHeader( const kvs::UInt8* data, const size_t size, FrameHeader* header );
+
+    static bool EncodeTile(
+        const size_t index,
+        const FrameHeader& header,
+        const kvs::UInt8* pixels,
+        const size_t nchannels,
+        kvs::UInt8* reference,
+        std::vector<kvs::UInt8>* buffer,
+        std::vector<kvs::UInt8>* data );
+    static const kvs::UInt8* DecodeTile(
+        const kvs::UInt8* data,
+        const kvs::UInt8* data_end,
+        const FrameHeader& header,
+        std::vector<kvs::UInt8>* buffer,
+        kvs::UInt8* frame );
+
+private:
+
+    FrameStreamCodec();
+};
+
+} // end of namespace kvs
+
+#endif // KVS__FRAME_STREAM_CODEC_H_INCLUDE
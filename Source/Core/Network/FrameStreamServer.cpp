@@ -0,0 +1,408 @@
+/*****************************************************************************/
+/**
+ *  @file   FrameStreamServer.cpp
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#include "FrameStreamServer.h"
+#include "FrameStreamCodec.h"
+#include <algorithm>
+#include <cstring>
+#include <kvs/MessageBlock>
+#include <kvs/Thread>
+#include <kvs/MutexLocker>
+#include <kvs/SocketTimer>
+#include <kvs/SystemInformation>
+#include <kvs/Message>
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Sender thread that accepts the clients and sends the frames.
+ */
+/*===========================================================================*/
+class FrameStreamServer::Sender : public kvs::Thread, public kvs::TCPServer::ConnectionHandler
+{
+private:
+
+    FrameStreamServer* m_owner; ///< frame stream server
+
+public:
+
+    Sender( FrameStreamServer* owner ): m_owner( owner ) {}
+
+    void connected( kvs::TCPServer*, kvs::TCPSocket* client )
+    {
+        // The frames are sent by the blocking socket in order.
+        client->enableBlocking();
+
+        kvs::MutexLocker locker( &m_owner->m_mutex );
+        m_owner->m_pending_clients.push_back( client );
+        m_owner->m_key_frame_requested = true;
+    }
+
+    void run()
+    {
+        for ( ; ; )
+        {
+            m_owner->accept_clients();
+            {
+                kvs::MutexLocker locker( &m_owner->m_mutex );
+                if ( m_owner->m_frames.empty() )
+                {
+                    if ( m_owner->m_is_closing ) return;
+
+                    // The new clients are also accepted while waiting.
+                    m_owner->m_condition.wait( &m_owner->m_mutex, 100 );
+                    continue;
+                }
+            }
+            m_owner->send_frame();
+        }
+    }
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Encoder thread of the tiles.
+ */
+/*===========================================================================*/
+class FrameStreamServer::Encoder : public kvs::Thread
+{
+private:
+
+    FrameStreamServer* m_owner; ///< frame stream server
+    const kvs::FrameStreamCodec::FrameHeader* m_header; ///< frame header
+    const kvs::UInt8* m_pixels; ///< pixels of the frame
+    size_t m_nchannels; ///< number of channels
+    size_t m_first; ///< first tile
+    size_t m_stride; ///< stride of the tiles
+    std::vector<kvs::UInt8> m_buffer; ///< work buffer
+
+public:
+
+    Encoder(): m_owner( NULL ), m_header( NULL ), m_pixels( NULL ), m_nchannels( 0 ), m_first( 0 ), m_stride( 1 ) {}
+
+    void init(
+        FrameStreamServer* owner,
+        const kvs::FrameStreamCodec::FrameHeader* header,
+        const kvs::UInt8* pixels,
+        const size_t nchannels,
+        const size_t first,
+        const size_t stride )
+    {
+        m_owner = owner;
+        m_header = header;
+        m_pixels = pixels;
+        m_nchannels = nchannels;
+        m_first = first;
+        m_stride = stride;
+    }
+
+    void run()
+    {
+        // The tiles are interleaved among the encoders to balance the load
+        // of the changed regions, and each tile updates its own region of
+        // the reference frame.
+        const size_t ntiles = m_owner->m_tiles.size();
+        kvs::UInt8* reference = m_owner->m_reference.data();
+        for ( size_t i = m_first; i < ntiles; i += m_stride )
+        {
+            std::vector<kvs::UInt8>& tile = m_owner->m_tiles[i];
+            tile.clear();
+            kvs::FrameStreamCodec::EncodeTile( i, *m_header, m_pixels, m_nchannels, reference, &m_buffer, &tile );
+        }
+    }
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new FrameStreamServer class.
+ */
+/*===========================================================================*/
+FrameStreamServer::FrameStreamServer():
+    m_tile_size( 64 ),
+    m_quantization( 0 ),
+    m_nthreads( kvs::Math::Max( kvs::SystemInformation::NumberOfProcessors(), size_t( 1 ) ) ),
+    m_max_nframes( 2 ),
+    m_width( 0 ),
+    m_height( 0 ),
+    m_frame_size( 0 ),
+    m_nchanged_tiles( 0 ),
+    m_key_frame_requested( true ),
+    m_is_closing( false ),
+    m_sender( NULL )
+{
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Destroys the FrameStreamServer class.
+ */
+/*===========================================================================*/
+FrameStreamServer::~FrameStreamServer()
+{
+    this->close();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the number of the connected clients.
+ *  @return number of the clients
+ */
+/*===========================================================================*/
+size_t FrameStreamServer::numberOfClients() const
+{
+    kvs::MutexLocker locker( &m_mutex );
+    return m_clients.size() + m_pending_clients.size();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Opens the server and starts the sender thread.
+ *  @param  port [in] port number
+ *  @return true if the server is opened
+ */
+/*===========================================================================*/
+bool FrameStreamServer::open( const int port )
+{
+    this->close();
+
+    m_server.open();
+    if ( m_server.bind( port ) < 0 || !m_server.listen() )
+    {
+        kvsMessageError( "Cannot listen to the port (%d). [%s]", port, m_server.errorString().c_str() );
+        m_server.close();
+        return false;
+    }
+
+    m_is_closing = false;
+    m_key_frame_requested = true;
+    m_sender = new Sender( this );
+    m_server.setConnectionHandler( m_sender );
+    if ( !m_sender->start() )
+    {
+        kvsMessageError( "Cannot start the sender thread." );
+        delete m_sender;
+        m_sender = NULL;
+        m_server.close();
+        return false;
+    }
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sends the queued frames, and closes the server and the clients.
+ */
+/*===========================================================================*/
+void FrameStreamServer::close()
+{
+    if ( !m_sender ) return;
+
+    {
+        kvs::MutexLocker locker( &m_mutex );
+        m_is_closing = true;
+        m_condition.wakeUpAll();
+    }
+    m_sender->wait();
+    m_server.setConnectionHandler( NULL );
+    delete m_sender;
+    m_sender = NULL;
+
+    for ( size_t i = 0; i < m_clients.size(); i++ ) delete m_clients[i];
+    for ( size_t i = 0; i < m_pending_clients.size(); i++ ) delete m_pending_clients[i];
+    m_clients.clear();
+    m_pending_clients.clear();
+    m_server.close();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sends the color image.
+ *  @param  image [in] color image
+ *  @return true if the frame is queued
+ */
+/*===========================================================================*/
+bool FrameStreamServer::send( const kvs::ColorImage& image )
+{
+    return this->send( image.pixels().data(), image.width(), image.height(), 3 );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Encodes the frame and queues it to be sent.
+ *  @param  pixels [in] RGB or RGBA pixels of the frame
+ *  @param  width [in] frame width
+ *  @param  height [in] frame height
+ *  @param  nchannels [in] number of channels (3: RGB, 4: RGBA; the alpha is not sent)
+ *  @return true if the frame is queued
+ *
+ *  The method returns after encoding the frame, and blocks while the max.
+ *  number of frames are waiting to be sent.
+ */
+/*===========================================================================*/
+bool FrameStreamServer::send( const kvs::UInt8* pixels, const size_t width, const size_t height, const size_t nchannels )
+{
+    if ( !m_sender )
+    {
+        kvsMessageError( "The server is not opened." );
+        return false;
+    }
+
+    if ( nchannels != 3 && nchannels != 4 )
+    {
+        kvsMessageError( "The number of channels (%d) is not supported.", int( nchannels ) );
+        return false;
+    }
+
+    bool key_frame = false;
+    bool has_clients = false;
+    {
+        kvs::MutexLocker locker( &m_mutex );
+        key_frame = m_key_frame_requested;
+        m_key_frame_requested = false;
+        has_clients = !m_clients.empty() || !m_pending_clients.empty();
+    }
+
+    if ( width != m_width || height != m_height )
+    {
+        m_reference.allocate( width * height * 3 );
+        m_reference.fill( 0 );
+        m_width = width;
+        m_height = height;
+        key_frame = true;
+    }
+
+    kvs::FrameStreamCodec::FrameHeader header;
+    header.width = width;
+    header.height = height;
+    header.tile_size = m_tile_size;
+    header.quantization = m_quantization;
+    header.flags = key_frame ? kvs::FrameStreamCodec::KeyFrame : 0;
+    header.ntiles = 0;
+
+    // Encode the tiles by the encoders. The first encoder runs on this thread.
+    const size_t ntiles = kvs::FrameStreamCodec::NumberOfTiles( width, height, m_tile_size );
+    m_tiles.resize( ntiles );
+    const size_t nencoders = kvs::Math::Min( m_nthreads, ntiles );
+    std::vector<Encoder> encoders( nencoders );
+    for ( size_t i = 0; i < nencoders; i++ )
+    {
+        encoders[i].init( this, &header, pixels, nchannels, i, nencoders );
+        if ( i == 0 || !encoders[i].start() ) encoders[i].run();
+    }
+    for ( size_t i = 1; i < nencoders; i++ ) encoders[i].wait();
+
+    size_t size = kvs::FrameStreamCodec::FrameHeaderSize;
+    for ( size_t i = 0; i < ntiles; i++ )
+    {
+        if ( m_tiles[i].empty() ) continue;
+        size += m_tiles[i].size();
+        header.ntiles++;
+    }
+
+    m_frame_size = size;
+    m_nchanged_tiles = header.ntiles;
+
+    // The encoded frame is not queued without the clients, but the reference
+    // has been updated for the next frame.
+    if ( !has_clients ) return true;
+
+    Frame frame;
+    frame.key_frame = key_frame;
+    frame.data.allocate( size );
+    kvs::UInt8* data = frame.data.data();
+    kvs::FrameStreamCodec::WriteFrameHeader( data, header );
+    data += kvs::FrameStreamCodec::FrameHeaderSize;
+    for ( size_t i = 0; i < ntiles; i++ )
+    {
+        if ( m_tiles[i].empty() ) continue;
+        std::memcpy( data, &m_tiles[i][0], m_tiles[i].size() );
+        data += m_tiles[i].size();
+    }
+
+    kvs::MutexLocker locker( &m_mutex );
+    while ( m_frames.size() >= m_max_nframes ) m_condition.wait( &m_mutex );
+    m_frames.push_back( frame );
+    m_condition.wakeUpAll();
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Waits until the queued frames are sent.
+ */
+/*===========================================================================*/
+void FrameStreamServer::flush()
+{
+    kvs::MutexLocker locker( &m_mutex );
+    while ( m_sender && !m_frames.empty() ) m_condition.wait( &m_mutex );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Accepts the new clients (called by the sender thread).
+ */
+/*===========================================================================*/
+void FrameStreamServer::accept_clients()
+{
+    const kvs::SocketTimer no_wait( 0.0 );
+    m_server.dispatch( &no_wait );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sends the first queued frame to the clients (called by the sender thread).
+ */
+/*===========================================================================*/
+void FrameStreamServer::send_frame()
+{
+    Frame frame;
+    std::vector<kvs::TCPSocket*> clients;
+    {
+        kvs::MutexLocker locker( &m_mutex );
+        frame = m_frames.front();
+
+        // The pending clients start to receive the frames from the key frame.
+        if ( frame.key_frame )
+        {
+            m_clients.insert( m_clients.end(), m_pending_clients.begin(), m_pending_clients.end() );
+            m_pending_clients.clear();
+        }
+        clients = m_clients;
+    }
+
+    std::vector<kvs::TCPSocket*> disconnected;
+    for ( size_t i = 0; i < clients.size(); i++ )
+    {
+        const kvs::Int64 size = clients[i]->sendMessage( frame.data.data(), frame.data.size() );
+        if ( size != kvs::Int64( frame.data.size() + kvs::MessageBlock::HeaderSize() ) )
+        {
+            disconnected.push_back( clients[i] );
+        }
+    }
+
+    kvs::MutexLocker locker( &m_mutex );
+    for ( size_t i = 0; i < disconnected.size(); i++ )
+    {
+        m_clients.erase( std::find( m_clients.begin(), m_clients.end(), disconnected[i] ) );
+        delete disconnected[i];
+    }
+    m_frames.pop_front();
+    m_condition.wakeUpAll();
+}
+
+} // end of namespace kvs
@@ -0,0 +1,117 @@
+/*****************************************************************************/
+/**
+ *  @file   FrameStreamServer.h
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#ifndef KVS__FRAME_STREAM_SERVER_H_INCLUDE
+#define KVS__FRAME_STREAM_SERVER_H_INCLUDE
+
+#include <vector>
+#include <deque>
+#include <kvs/Type>
+#include <kvs/ValueArray>
+#include <kvs/Math>
+#include <kvs/ColorImage>
+#include <kvs/Noncopyable>
+#include <kvs/Mutex>
+#include <kvs/Condition>
+#include <kvs/TCPServer>
+#include <kvs/TCPSocket>
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Server class that streams the rendered frames to the clients.
+ *
+ *  The frame is divided into tiles, and only the tiles changed from the
+ *  previous frame are sent as the compressed residuals (see
+ *  kvs::FrameStreamClient for the receiver). The tiles are encoded by the
+ *  worker threads in send(), and the encoded frame is sent to the clients
+ *  by the sender thread, so that the encoding of the next frame overlaps
+ *  with the sending of the previous one. The lossy compression is enabled
+ *  by dropping the lower bits of the pixel values (setQuantization).
+ *
+ *  A new client is accepted by the sender thread, and receives the frames
+ *  from the next key frame, which has all the tiles and is encoded after
+ *  the connection.
+ */
+/*===========================================================================*/
+class FrameStreamServer : private kvs::Noncopyable
+{
+private:
+
+    class Sender;
+    class Encoder;
+    friend class Sender;
+    friend class Encoder;
+
+    struct Frame
+    {
+        kvs::ValueArray<kvs::UInt8> data; ///< encoded frame
+        bool key_frame; ///< flag for the key frame
+    };
+
+    kvs::TCPServer m_server; ///< server
+    size_t m_tile_size; ///< tile size
+    size_t m_quantization; ///< number of the dropped bits (0: lossless)
+    size_t m_nthreads; ///< number of the encoding threads
+    size_t m_max_nframes; ///< max. number of the frames waiting to be sent
+    size_t m_width; ///< width of the previous frame
+    size_t m_height; ///< height of the previous frame
+    kvs::ValueArray<kvs::UInt8> m_reference; ///< previous frame reconstructed by the clients
+    std::vector< std::vector<kvs::UInt8> > m_tiles; ///< encoded tiles of the current frame (empty if not changed)
+    size_t m_frame_size; ///< size of the last encoded frame [byte]
+    size_t m_nchanged_tiles; ///< number of the changed tiles of the last frame
+
+    mutable kvs::Mutex m_mutex; ///< mutex for the following members
+    kvs::Condition m_condition; ///< condition for the frame queue
+    std::deque<Frame> m_frames; ///< frames waiting to be sent
+    std::vector<kvs::TCPSocket*> m_clients; ///< clients receiving the frames
+    std::vector<kvs::TCPSocket*> m_pending_clients; ///< clients waiting for the key frame
+    bool m_key_frame_requested; ///< flag for the key frame request
+    bool m_is_closing; ///< flag for closing the server
+    Sender* m_sender; ///< sender thread
+
+public:
+
+    FrameStreamServer();
+    ~FrameStreamServer();
+
+    size_t tileSize() const { return m_tile_size; }
+    size_t quantization() const { return m_quantization; }
+    size_t numberOfThreads() const { return m_nthreads; }
+    size_t lastFrameSize() const { return m_frame_size; }
+    size_t lastNumberOfChangedTiles() const { return m_nchanged_tiles; }
+    size_t numberOfClients() const;
+
+    void setTileSize( const size_t tile_size ) { m_tile_size = kvs::Math::Max( tile_size, size_t( 8 ) ); }
+    void setQuantization( const size_t bits ) { m_quantization = kvs::Math::Min( bits, size_t( 7 ) ); }
+    void setNumberOfThreads( const size_t nthreads ) { m_nthreads = kvs::Math::Max( nthreads, size_t( 1 ) ); }
+    void setMaxNumberOfFrames( const size_t nframes ) { m_max_nframes = kvs::Math::Max( nframes, size_t( 1 ) ); }
+
+    bool open( const int port );
+    void close();
+    bool send( const kvs::ColorImage& image );
+    bool send( const kvs::UInt8* pixels, const size_t width, const size_t height, const size_t nchannels );
+    void flush();
+
+private:
+
+    void accept_clients();
+    void send_frame();
+};
+
+} // end of namespace kvs
+
+#endif // KVS__FRAME_STREAM_SERVER_H_INCLUDE
@@ -19,12 +19,58 @@
 
 namespace
 {
-const size_t SizeOfHeader = sizeof( kvs::UInt32 ); // 32 bits = 4 bytes
+const size_t SizeOfHeader = sizeof( kvs::UInt64 ); // 64 bits = 8 bytes
 }
 
 namespace kvs
 {
 
+/*==========================================================================*/
+/**
+ *  Returns the size of the message header.
+ *  @return header size [byte]
+ */
+/*==========================================================================*/
+size_t MessageBlock::HeaderSize()
+{
+    return( SizeOfHeader );
+}
+
+/*==========================================================================*/
+/**
+ *  Writes the message header, which is the message size in network byte-order.
+ *  @param header [out] pointer to the header (HeaderSize() bytes)
+ *  @param message_size [in] size of message
+ */
+/*==========================================================================*/
+void MessageBlock::WriteHeader( void* header, const kvs::UInt64 message_size )
+{
+    unsigned char* p = static_cast<unsigned char*>( header );
+    for( size_t i = 0; i < SizeOfHeader; i++ )
+    {
+        p[i] = static_cast<unsigned char>( message_size >> ( 8 * ( SizeOfHeader - 1 - i ) ) );
+    }
+}
+
+/*==========================================================================*/
+/**
+ *  Reads the message size from the message header.
+ *  @param header [in] pointer to the header (HeaderSize() bytes)
+ *  @return size of message
+ */
+/*==========================================================================*/
+kvs::UInt64 MessageBlock::ReadHeader( const void* header )
+{
+    const unsigned char* p = static_cast<const unsigned char*>( header );
+    kvs::UInt64 message_size = 0;
+    for( size_t i = 0; i < SizeOfHeader; i++ )
+    {
+        message_size = ( message_size << 8 ) | p[i];
+    }
+
+    return( message_size );
+}
+
 /*==========================================================================*/
 /**
  *  Constructor.
@@ -172,13 +218,8 @@ void MessageBlock::copy( const void* message, size_t message_size )
 {
     if( this->allocate( message_size ) )
     {
-        // Convert host byte-order to network byte-order.
-        kvs::UInt32 size = htonl( static_cast<kvs::UInt32>( message_size ) );
-//        unsigned int size = htonl( static_cast<unsigned int>( message_size ) );
-//        u_long size = htonl( static_cast<u_long>( message_size ) );
-
         unsigned char* p = m_block.data();
-        memcpy( p,                &size,   SizeOfHeader );
+        MessageBlock::WriteHeader( p, message_size );
         memcpy( p + SizeOfHeader, message, message_size );
     }
 }
@@ -15,6 +15,7 @@
 #define KVS__MESSAGE_BLOCK_H_INCLUDE
 
 #include <kvs/ValueArray>
+#include <kvs/Type>
 #include <kvs/Deprecated>
 
 
@@ -24,6 +25,9 @@ namespace kvs
 /*==========================================================================*/
 /**
  *  Message block class.
+ *
+ *  The message is preceded by the header of the message size, which is a
+ *  64-bit unsigned integer in network byte-order.
  */
 /*==========================================================================*/
 class MessageBlock
@@ -45,6 +49,12 @@ protected:
 
     kvs::ValueArray<unsigned char> m_block; ///< message block
 
+public:
+
+    static size_t HeaderSize();
+    static void WriteHeader( void* header, const kvs::UInt64 message_size );
+    static kvs::UInt64 ReadHeader( const void* header );
+
 public:
 
     MessageBlock();
@@ -16,6 +16,68 @@
 #include "SocketSelector.h"
 #include "SocketTimer.h"
 #include <kvs/Platform>
+#include <kvs/Math>
+#include <vector>
+#include <cstring>
+#if !defined( KVS_PLATFORM_WINDOWS )
+#include <sys/uio.h>
+#include <limits.h>
+#endif
+
+
+namespace
+{
+
+// Maximum size of a buffer passed to a system call, since the size is given
+// as int on some platforms.
+const size_t MaxChunkSize = size_t( 1 ) << 30;
+
+#if defined( MSG_NOSIGNAL )
+// SIGPIPE is not raised when the peer has closed the connection.
+const int SendFlags = MSG_NOSIGNAL;
+#else
+const int SendFlags = 0;
+#endif
+
+#if !defined( KVS_PLATFORM_WINDOWS )
+#if defined( IOV_MAX )
+const size_t MaxIOVectors = IOV_MAX;
+#else
+const size_t MaxIOVectors = 16;
+#endif
+#endif
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns true if the last socket call was interrupted by a signal.
+ *  @return true if interrupted
+ */
+/*===========================================================================*/
+inline bool IsInterrupted()
+{
+#if defined( KVS_PLATFORM_WINDOWS )
+    return WSAGetLastError() == WSAEINTR;
+#else
+    return errno == EINTR;
+#endif
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns true if the last socket call would block the non-blocking socket.
+ *  @return true if the call would block
+ */
+/*===========================================================================*/
+inline bool WouldBlock()
+{
+#if defined( KVS_PLATFORM_WINDOWS )
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+} // end of namespace
 
 
 namespace kvs
@@ -72,7 +134,10 @@ Socket::Socket( const Socket& other ):
  */
 /*==========================================================================*/
 Socket::Socket( const Socket::id_type& id, const kvs::SocketAddress& address ):
-    m_id( id )
+    m_id( id ),
+    m_is_open( id != Socket::InvalidID ),
+    m_is_bound( false ),
+    m_is_blocking( true )
 {
     this->setAddress( address );
 }
@@ -396,6 +461,17 @@ int Socket::set_option( id_type id, int level, int name, void* value, int length
     return( ::setsockopt( id, level, name, (option_type*)( value ), length ) );
 }
 
+/*==========================================================================*/
+/**
+ *  Check whether the last call would block the non-blocking socket.
+ *  @return true, if the call would block
+ */
+/*==========================================================================*/
+bool Socket::would_block() const
+{
+    return( ::WouldBlock() );
+}
+
 /*==========================================================================*/
 /**
  *  Receive buffer at once.
@@ -416,25 +492,188 @@ int Socket::receive_once( id_type id, char* buffer, int length )
  *  @param id [in] socket ID
  *  @param  buffer [out] pointer to buffer
  *  @param length [in] buffer length [byte]
- *  @return received buffer size [byte]
+ *  @return received buffer size [byte], or ErrorValue if nothing is received
+ *
+ *  The buffer is received until it is filled, the connection is closed, or
+ *  the non-blocking socket has no more data.
  */
 /*==========================================================================*/
-int Socket::receive_exact( id_type id, char* buffer, int length )
+kvs::Int64 Socket::receive_exact( id_type id, char* buffer, size_t length )
 {
-    int received_size = 0;
+    size_t received_size = 0;
 
-    for (;;)
+    while( received_size < length )
     {
-        int actual_size = ::recv( id, buffer, length - received_size, 0 );
-        if( actual_size <= 0 ) break;
+        const size_t size = kvs::Math::Min( length - received_size, ::MaxChunkSize );
+        const int actual_size = ::recv( id, buffer + received_size, static_cast<int>( size ), 0 );
+        if( actual_size > 0 ) { received_size += actual_size; continue; }
+        if( actual_size == 0 ) break; // Closed.
+        if( ::IsInterrupted() ) continue;
+        if( received_size == 0 ) return( Socket::ErrorValue );
+        break;
+    }
 
-        received_size += actual_size;
-        buffer += actual_size;
+    return( static_cast<kvs::Int64>( received_size ) );
+}
 
-        if( received_size >= length ) break;
+/*==========================================================================*/
+/**
+ *  Receive buffers exactly with a scatter read.
+ *  @param id [in] socket ID
+ *  @param buffers [out] pointers to buffers
+ *  @param lengths [in] buffer lengths [byte]
+ *  @param nbuffers [in] number of buffers
+ *  @return received size [byte], or ErrorValue if nothing is received
+ */
+/*==========================================================================*/
+kvs::Int64 Socket::receive_vector( id_type id, void* const* buffers, const size_t* lengths, size_t nbuffers )
+{
+#if defined( KVS_PLATFORM_WINDOWS )
+    kvs::Int64 received_size = 0;
+    for( size_t i = 0; i < nbuffers; i++ )
+    {
+        const kvs::Int64 size = this->receive_exact( id, static_cast<char*>( buffers[i] ), lengths[i] );
+        if( size < 0 ) return( received_size > 0 ? received_size : size );
+        received_size += size;
+        if( static_cast<size_t>( size ) < lengths[i] ) break;
     }
 
     return( received_size );
+#else
+    std::vector<struct iovec> vectors( nbuffers );
+    for( size_t i = 0; i < nbuffers; i++ )
+    {
+        vectors[i].iov_base = buffers[i];
+        vectors[i].iov_len = lengths[i];
+    }
+
+    size_t received_size = 0;
+    size_t first = 0;
+    while( first < nbuffers )
+    {
+        if( vectors[first].iov_len == 0 ) { first++; continue; }
+
+        const int count = static_cast<int>( kvs::Math::Min( nbuffers - first, ::MaxIOVectors ) );
+        const ssize_t actual_size = ::readv( id, &vectors[first], count );
+        if( actual_size == 0 ) break; // Closed.
+        if( actual_size < 0 )
+        {
+            if( ::IsInterrupted() ) continue;
+            if( received_size == 0 ) return( Socket::ErrorValue );
+            break;
+        }
+
+        // Skip the filled buffers and advance the partially filled one.
+        received_size += actual_size;
+        size_t rest = static_cast<size_t>( actual_size );
+        while( first < nbuffers && rest >= vectors[first].iov_len ) { rest -= vectors[first].iov_len; first++; }
+        if( first < nbuffers )
+        {
+            vectors[first].iov_base = static_cast<char*>( vectors[first].iov_base ) + rest;
+            vectors[first].iov_len -= rest;
+        }
+    }
+
+    return( static_cast<kvs::Int64>( received_size ) );
+#endif
+}
+
+/*==========================================================================*/
+/**
+ *  Send buffer exactly.
+ *  @param id [in] socket ID
+ *  @param buffer [in] pointer to buffer
+ *  @param length [in] buffer length [byte]
+ *  @return sent size [byte], or ErrorValue if an error occurs
+ *
+ *  The partial writes are repeated until the whole buffer is sent. For the
+ *  non-blocking socket, the size sent before the socket would block is
+ *  returned, and the rest has to be sent when the socket is writable.
+ */
+/*==========================================================================*/
+kvs::Int64 Socket::send_exact( id_type id, const char* buffer, size_t length )
+{
+    size_t sent_size = 0;
+
+    while( sent_size < length )
+    {
+        const size_t size = kvs::Math::Min( length - sent_size, ::MaxChunkSize );
+        const int actual_size = ::send( id, buffer + sent_size, static_cast<int>( size ), ::SendFlags );
+        if( actual_size >= 0 ) { sent_size += actual_size; continue; }
+        if( ::IsInterrupted() ) continue;
+        if( ::WouldBlock() && sent_size > 0 ) break;
+        return( Socket::ErrorValue );
+    }
+
+    return( static_cast<kvs::Int64>( sent_size ) );
+}
+
+/*==========================================================================*/
+/**
+ *  Send buffers exactly with a gather write.
+ *  @param id [in] socket ID
+ *  @param buffers [in] pointers to buffers
+ *  @param lengths [in] buffer lengths [byte]
+ *  @param nbuffers [in] number of buffers
+ *  @return sent size [byte], or ErrorValue if an error occurs
+ *
+ *  The buffers (e.g. a header and a payload) are sent without being copied
+ *  into a single buffer.
+ */
+/*==========================================================================*/
+kvs::Int64 Socket::send_vector( id_type id, const void* const* buffers, const size_t* lengths, size_t nbuffers )
+{
+#if defined( KVS_PLATFORM_WINDOWS )
+    kvs::Int64 sent_size = 0;
+    for( size_t i = 0; i < nbuffers; i++ )
+    {
+        const kvs::Int64 size = this->send_exact( id, static_cast<const char*>( buffers[i] ), lengths[i] );
+        if( size < 0 ) return( sent_size > 0 && ::WouldBlock() ? sent_size : size );
+        sent_size += size;
+        if( static_cast<size_t>( size ) < lengths[i] ) break;
+    }
+
+    return( sent_size );
+#else
+    std::vector<struct iovec> vectors( nbuffers );
+    for( size_t i = 0; i < nbuffers; i++ )
+    {
+        vectors[i].iov_base = const_cast<void*>( buffers[i] );
+        vectors[i].iov_len = lengths[i];
+    }
+
+    size_t sent_size = 0;
+    size_t first = 0;
+    while( first < nbuffers )
+    {
+        if( vectors[first].iov_len == 0 ) { first++; continue; }
+
+        // sendmsg is used as writev with the flags.
+        struct msghdr message;
+        memset( &message, 0, sizeof( message ) );
+        message.msg_iov = &vectors[first];
+        message.msg_iovlen = kvs::Math::Min( nbuffers - first, ::MaxIOVectors );
+        const ssize_t actual_size = ::sendmsg( id, &message, ::SendFlags );
+        if( actual_size < 0 )
+        {
+            if( ::IsInterrupted() ) continue;
+            if( ::WouldBlock() && sent_size > 0 ) break;
+            return( Socket::ErrorValue );
+        }
+
+        // Skip the sent buffers and advance the partially sent one.
+        sent_size += actual_size;
+        size_t rest = static_cast<size_t>( actual_size );
+        while( first < nbuffers && rest >= vectors[first].iov_len ) { rest -= vectors[first].iov_len; first++; }
+        if( first < nbuffers )
+        {
+            vectors[first].iov_base = static_cast<char*>( vectors[first].iov_base ) + rest;
+            vectors[first].iov_len -= rest;
+        }
+    }
+
+    return( static_cast<kvs::Int64>( sent_size ) );
+#endif
 }
 
 /*==========================================================================*/
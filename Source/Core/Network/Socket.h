@@ -19,6 +19,7 @@
 #include "SocketTimer.h"
 #include "IPAddress.h"
 #include <kvs/Platform>
+#include <kvs/Type>
 #include <string>
 
 
@@ -93,8 +94,12 @@ public:
 protected:
 
     int set_option( id_type id, int level, int name, void* value, int length );
+    bool would_block() const;
     int receive_once( id_type id, char* buffer, int length );
-    int receive_exact( id_type id, char* buffer, int length );
+    kvs::Int64 receive_exact( id_type id, char* buffer, size_t length );
+    kvs::Int64 receive_vector( id_type id, void* const* buffers, const size_t* lengths, size_t nbuffers );
+    kvs::Int64 send_exact( id_type id, const char* buffer, size_t length );
+    kvs::Int64 send_vector( id_type id, const void* const* buffers, const size_t* lengths, size_t nbuffers );
     int receive_peek( id_type id, char* buffer, int length );
     int receive_line( id_type id, std::string& line );
     int connect_to_host( const kvs::SocketAddress& socket_address, const kvs::SocketTimer* timeout = 0 );
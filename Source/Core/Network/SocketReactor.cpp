@@ -0,0 +1,360 @@
+/*****************************************************************************/
+/**
+ *  @file   SocketReactor.cpp
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#include "SocketReactor.h"
+#include <vector>
+#include <cstring>
+#include <kvs/Math>
+#include <kvs/Message>
+#if defined( KVS_PLATFORM_LINUX )
+#include <sys/epoll.h>
+#endif
+#if !defined( KVS_PLATFORM_WINDOWS )
+#include <poll.h>
+#endif
+
+
+namespace
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the timeout in milliseconds.
+ *  @param  timeout [in] timeout (NULL for infinite)
+ *  @return timeout in milliseconds (-1 for infinite)
+ */
+/*===========================================================================*/
+int TimeoutMilliseconds( const kvs::SocketTimer* timeout )
+{
+    if ( !timeout ) return -1;
+    const struct timeval& value = timeout->value();
+    return static_cast<int>( value.tv_sec * 1000 + value.tv_usec / 1000 );
+}
+
+#if defined( KVS_PLATFORM_LINUX )
+/*===========================================================================*/
+/**
+ *  @brief  Converts the events to the epoll events.
+ *  @param  events [in] events of kvs::SocketReactor
+ *  @return epoll events
+ */
+/*===========================================================================*/
+kvs::UInt32 ToEpollEvents( const int events )
+{
+    kvs::UInt32 epoll_events = 0;
+    if ( events & kvs::SocketReactor::Readable ) epoll_events |= EPOLLIN;
+    if ( events & kvs::SocketReactor::Writable ) epoll_events |= EPOLLOUT;
+    return epoll_events;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Converts the epoll events to the events.
+ *  @param  epoll_events [in] epoll events
+ *  @return events of kvs::SocketReactor
+ */
+/*===========================================================================*/
+int FromEpollEvents( const kvs::UInt32 epoll_events )
+{
+    int events = 0;
+    if ( epoll_events & EPOLLIN ) events |= kvs::SocketReactor::Readable;
+    if ( epoll_events & EPOLLOUT ) events |= kvs::SocketReactor::Writable;
+    if ( epoll_events & ( EPOLLHUP | EPOLLERR ) ) events |= kvs::SocketReactor::Closed;
+    return events;
+}
+#endif
+
+#if !defined( KVS_PLATFORM_WINDOWS )
+/*===========================================================================*/
+/**
+ *  @brief  Converts the events to the poll events.
+ *  @param  events [in] events of kvs::SocketReactor
+ *  @return poll events
+ */
+/*===========================================================================*/
+short ToPollEvents( const int events )
+{
+    short poll_events = 0;
+    if ( events & kvs::SocketReactor::Readable ) poll_events |= POLLIN;
+    if ( events & kvs::SocketReactor::Writable ) poll_events |= POLLOUT;
+    return poll_events;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Converts the poll events to the events.
+ *  @param  poll_events [in] poll events
+ *  @return events of kvs::SocketReactor
+ */
+/*===========================================================================*/
+int FromPollEvents( const short poll_events )
+{
+    int events = 0;
+    if ( poll_events & POLLIN ) events |= kvs::SocketReactor::Readable;
+    if ( poll_events & POLLOUT ) events |= kvs::SocketReactor::Writable;
+    if ( poll_events & ( POLLHUP | POLLERR | POLLNVAL ) ) events |= kvs::SocketReactor::Closed;
+    return events;
+}
+#endif
+
+} // end of namespace
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Waits for the events of a socket.
+ *  @param  id [in] socket ID
+ *  @param  events [in] events to be waited (Readable and/or Writable)
+ *  @param  timeout [in] timeout (NULL for infinite)
+ *  @return occurred events, 0 if timeout, or -1 if an error occurs
+ */
+/*===========================================================================*/
+int SocketReactor::Wait( const kvs::Socket::id_type id, const int events, const kvs::SocketTimer* timeout )
+{
+#if defined( KVS_PLATFORM_WINDOWS )
+    fd_set readable; FD_ZERO( &readable );
+    fd_set writable; FD_ZERO( &writable );
+    fd_set error; FD_ZERO( &error );
+    if ( events & Readable ) FD_SET( id, &readable );
+    if ( events & Writable ) FD_SET( id, &writable );
+    FD_SET( id, &error );
+
+    struct timeval value;
+    if ( timeout ) value = timeout->value();
+    const int status = ::select( 0, &readable, &writable, &error, timeout ? &value : NULL );
+    if ( status <= 0 ) return status;
+
+    int occurred = 0;
+    if ( FD_ISSET( id, &readable ) ) occurred |= Readable;
+    if ( FD_ISSET( id, &writable ) ) occurred |= Writable;
+    if ( FD_ISSET( id, &error ) ) occurred |= Closed;
+    return occurred;
+#else
+    struct pollfd fd;
+    fd.fd = id;
+    fd.events = ::ToPollEvents( events );
+    fd.revents = 0;
+
+    int status = 0;
+    do { status = ::poll( &fd, 1, ::TimeoutMilliseconds( timeout ) ); } while ( status < 0 && errno == EINTR );
+    if ( status <= 0 ) return status;
+
+    return ::FromPollEvents( fd.revents );
+#endif
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new SocketReactor class.
+ */
+/*===========================================================================*/
+SocketReactor::SocketReactor()
+{
+#if defined( KVS_PLATFORM_LINUX )
+    m_epoll_id = ::epoll_create( 64 );
+    if ( m_epoll_id < 0 ) { kvsMessageError( "Cannot create an epoll instance." ); }
+#endif
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Destroys the SocketReactor class.
+ */
+/*===========================================================================*/
+SocketReactor::~SocketReactor()
+{
+#if defined( KVS_PLATFORM_LINUX )
+    if ( m_epoll_id >= 0 ) ::close( m_epoll_id );
+#endif
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Registers a socket with the handler.
+ *  @param  id [in] socket ID
+ *  @param  handler [in] pointer to the handler (not deleted by the reactor)
+ *  @param  events [in] events to be waited (Readable and/or Writable)
+ *  @return true if the socket is registered
+ */
+/*===========================================================================*/
+bool SocketReactor::add( const kvs::Socket::id_type id, Handler* handler, const int events )
+{
+    if ( this->contains( id ) )
+    {
+        kvsMessageError( "The socket has already been registered." );
+        return false;
+    }
+
+#if defined( KVS_PLATFORM_LINUX )
+    struct epoll_event event;
+    event.events = ::ToEpollEvents( events );
+    event.data.u64 = 0;
+    event.data.fd = id;
+    if ( ::epoll_ctl( m_epoll_id, EPOLL_CTL_ADD, id, &event ) < 0 )
+    {
+        kvsMessageError( "Cannot register the socket. [%s]", strerror( errno ) );
+        return false;
+    }
+#elif defined( KVS_PLATFORM_WINDOWS )
+    if ( m_entries.size() >= FD_SETSIZE )
+    {
+        kvsMessageError( "Cannot register more than %d sockets.", int( FD_SETSIZE ) );
+        return false;
+    }
+#endif
+
+    Entry entry;
+    entry.handler = handler;
+    entry.events = events;
+    m_entries[ id ] = entry;
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Modifies the events to be waited for the socket.
+ *  @param  id [in] socket ID
+ *  @param  events [in] events to be waited (Readable and/or Writable)
+ *  @return true if the events are modified
+ */
+/*===========================================================================*/
+bool SocketReactor::modify( const kvs::Socket::id_type id, const int events )
+{
+    EntryMap::iterator entry = m_entries.find( id );
+    if ( entry == m_entries.end() ) return false;
+
+#if defined( KVS_PLATFORM_LINUX )
+    struct epoll_event event;
+    event.events = ::ToEpollEvents( events );
+    event.data.u64 = 0;
+    event.data.fd = id;
+    if ( ::epoll_ctl( m_epoll_id, EPOLL_CTL_MOD, id, &event ) < 0 ) return false;
+#endif
+
+    entry->second.events = events;
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Removes the socket.
+ *  @param  id [in] socket ID
+ *  @return true if the socket is removed
+ */
+/*===========================================================================*/
+bool SocketReactor::remove( const kvs::Socket::id_type id )
+{
+    EntryMap::iterator entry = m_entries.find( id );
+    if ( entry == m_entries.end() ) return false;
+
+#if defined( KVS_PLATFORM_LINUX )
+    // The socket may have been closed, in which case it has been removed from
+    // the epoll instance automatically.
+    struct epoll_event event;
+    ::epoll_ctl( m_epoll_id, EPOLL_CTL_DEL, id, &event );
+#endif
+
+    m_entries.erase( entry );
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Waits for the events of the registered sockets and calls the handlers.
+ *  @param  timeout [in] timeout (NULL for infinite)
+ *  @return number of the sockets with the events, 0 if timeout, or -1 if an error occurs
+ */
+/*===========================================================================*/
+int SocketReactor::dispatch( const kvs::SocketTimer* timeout )
+{
+    if ( m_entries.empty() ) return 0;
+
+    // The occurred events are collected first, since the handlers may modify
+    // the registered sockets.
+    std::vector<kvs::Socket::id_type> ids;
+    std::vector<int> occurred;
+
+#if defined( KVS_PLATFORM_LINUX )
+    std::vector<struct epoll_event> events( kvs::Math::Min( m_entries.size(), size_t( 1024 ) ) );
+    int nevents = 0;
+    do { nevents = ::epoll_wait( m_epoll_id, &events[0], int( events.size() ), ::TimeoutMilliseconds( timeout ) ); }
+    while ( nevents < 0 && errno == EINTR );
+    if ( nevents <= 0 ) return nevents;
+
+    for ( int i = 0; i < nevents; i++ )
+    {
+        ids.push_back( events[i].data.fd );
+        occurred.push_back( ::FromEpollEvents( events[i].events ) );
+    }
+#elif defined( KVS_PLATFORM_WINDOWS )
+    fd_set readable; FD_ZERO( &readable );
+    fd_set writable; FD_ZERO( &writable );
+    fd_set error; FD_ZERO( &error );
+    for ( EntryMap::const_iterator entry = m_entries.begin(); entry != m_entries.end(); ++entry )
+    {
+        if ( entry->second.events & Readable ) FD_SET( entry->first, &readable );
+        if ( entry->second.events & Writable ) FD_SET( entry->first, &writable );
+        FD_SET( entry->first, &error );
+    }
+
+    struct timeval value;
+    if ( timeout ) value = timeout->value();
+    const int status = ::select( 0, &readable, &writable, &error, timeout ? &value : NULL );
+    if ( status <= 0 ) return status;
+
+    for ( EntryMap::const_iterator entry = m_entries.begin(); entry != m_entries.end(); ++entry )
+    {
+        int events = 0;
+        if ( FD_ISSET( entry->first, &readable ) ) events |= Readable;
+        if ( FD_ISSET( entry->first, &writable ) ) events |= Writable;
+        if ( FD_ISSET( entry->first, &error ) ) events |= Closed;
+        if ( events ) { ids.push_back( entry->first ); occurred.push_back( events ); }
+    }
+#else
+    std::vector<struct pollfd> fds;
+    for ( EntryMap::const_iterator entry = m_entries.begin(); entry != m_entries.end(); ++entry )
+    {
+        struct pollfd fd;
+        fd.fd = entry->first;
+        fd.events = ::ToPollEvents( entry->second.events );
+        fd.revents = 0;
+        fds.push_back( fd );
+    }
+
+    int status = 0;
+    do { status = ::poll( &fds[0], fds.size(), ::TimeoutMilliseconds( timeout ) ); } while ( status < 0 && errno == EINTR );
+    if ( status <= 0 ) return status;
+
+    for ( size_t i = 0; i < fds.size(); i++ )
+    {
+        if ( fds[i].revents ) { ids.push_back( fds[i].fd ); occurred.push_back( ::FromPollEvents( fds[i].revents ) ); }
+    }
+#endif
+
+    for ( size_t i = 0; i < ids.size(); i++ )
+    {
+        // The socket may have been removed by the previous handler.
+        EntryMap::iterator entry = m_entries.find( ids[i] );
+        if ( entry == m_entries.end() ) continue;
+
+        const int events = occurred[i] & ( entry->second.events | Closed );
+        if ( events ) entry->second.handler->handleEvent( ids[i], events );
+    }
+
+    return static_cast<int>( ids.size() );
+}
+
+} // end of namespace kvs
@@ -0,0 +1,100 @@
+/*****************************************************************************/
+/**
+ *  @file   SocketReactor.h
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#ifndef KVS__SOCKET_REACTOR_H_INCLUDE
+#define KVS__SOCKET_REACTOR_H_INCLUDE
+
+#include <map>
+#include <kvs/Platform>
+#include <kvs/Noncopyable>
+#include "Socket.h"
+#include "SocketTimer.h"
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Reactor class that dispatches the events of the sockets.
+ *
+ *  The sockets are registered with the handlers, and dispatch() waits for
+ *  the events of the sockets and calls the handlers. The events are waited
+ *  by epoll on Linux and by poll on the other POSIX platforms, so that the
+ *  number of the sockets and the values of the descriptors are not limited
+ *  by FD_SETSIZE as kvs::SocketSelector. On Windows, select is used.
+ */
+/*===========================================================================*/
+class SocketReactor : private kvs::Noncopyable
+{
+public:
+
+    enum EventType
+    {
+        Readable = 1, ///< data can be received (or a connection can be accepted)
+        Writable = 2, ///< data can be sent
+        Closed = 4 ///< the connection is closed or an error occurs
+    };
+
+    /*=======================================================================*/
+    /**
+     *  @brief  Handler class for the events of a socket.
+     *
+     *  The handler can add and remove the sockets (including its own) in
+     *  handleEvent().
+     */
+    /*=======================================================================*/
+    class Handler
+    {
+    public:
+
+        virtual ~Handler() {}
+        virtual void handleEvent( const kvs::Socket::id_type id, const int events ) = 0;
+    };
+
+private:
+
+    struct Entry
+    {
+        Handler* handler; ///< event handler (not deleted by the reactor)
+        int events; ///< events to be waited
+    };
+
+    typedef std::map<kvs::Socket::id_type,Entry> EntryMap;
+
+    EntryMap m_entries; ///< registered sockets
+#if defined( KVS_PLATFORM_LINUX )
+    int m_epoll_id; ///< descriptor of the epoll instance
+#endif
+
+public:
+
+    static int Wait( const kvs::Socket::id_type id, const int events, const kvs::SocketTimer* timeout = 0 );
+
+public:
+
+    SocketReactor();
+    ~SocketReactor();
+
+    size_t numberOfSockets() const { return m_entries.size(); }
+    bool contains( const kvs::Socket::id_type id ) const { return m_entries.find( id ) != m_entries.end(); }
+
+    bool add( const kvs::Socket::id_type id, Handler* handler, const int events = Readable );
+    bool modify( const kvs::Socket::id_type id, const int events );
+    bool remove( const kvs::Socket::id_type id );
+    int dispatch( const kvs::SocketTimer* timeout = 0 );
+};
+
+} // end of namespace kvs
+
+#endif // KVS__SOCKET_REACTOR_H_INCLUDE
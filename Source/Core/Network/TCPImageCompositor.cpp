@@ -0,0 +1,626 @@
+/*****************************************************************************/
+/**
+ *  @file   TCPImageCompositor.cpp
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#include "TCPImageCompositor.h"
+#include <algorithm>
+#include <utility>
+#include <cstring>
+#include <cerrno>
+#include <kvs/TCPServer>
+#include <kvs/SocketReactor>
+#include <kvs/SocketTimer>
+#include <kvs/MessageBlock>
+#include <kvs/Thread>
+#include <kvs/Timer>
+#include <kvs/Math>
+#include <kvs/Message>
+
+
+namespace
+{
+
+const size_t HandshakeSize = 8; ///< rank of the connecting process
+const size_t OrderSize = 16; ///< number of pixels and visibility
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns true if the last socket call would block the non-blocking socket.
+ *  @return true if the call would block
+ */
+/*===========================================================================*/
+inline bool WouldBlock()
+{
+#if defined( KVS_PLATFORM_WINDOWS )
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the largest power of two that is not greater than the value.
+ *  @param  value [in] value (> 0)
+ *  @return power of two
+ */
+/*===========================================================================*/
+inline size_t FloorPowerOfTwo( const size_t value )
+{
+    size_t power = 1;
+    while ( power * 2 <= value ) power *= 2;
+    return power;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the pixel range owned by the rank after the binary swap.
+ *  @param  index [in] index of the rank in the binary swap
+ *  @param  nranks [in] number of the ranks in the binary swap (power of two)
+ *  @param  npixels [in] number of pixels
+ *  @param  begin [out] first pixel
+ *  @param  end [out] pixel next to the last one
+ */
+/*===========================================================================*/
+inline void SwapRange( const size_t index, const size_t nranks, const size_t npixels, size_t* begin, size_t* end )
+{
+    *begin = 0;
+    *end = npixels;
+    for ( size_t bit = 1; bit < nranks; bit *= 2 )
+    {
+        const size_t middle = *begin + ( *end - *begin ) / 2;
+        if ( index & bit ) { *begin = middle; } else { *end = middle; }
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Buffers transferred through the non-blocking socket.
+ */
+/*===========================================================================*/
+class Transfer
+{
+private:
+
+    kvs::UInt8* m_data[2]; ///< buffers
+    size_t m_size[2]; ///< sizes of the buffers [byte]
+    size_t m_nbuffers; ///< number of the buffers
+    size_t m_index; ///< index of the current buffer
+    size_t m_offset; ///< transferred size of the current buffer [byte]
+
+public:
+
+    Transfer(): m_nbuffers( 0 ), m_index( 0 ), m_offset( 0 ) {}
+
+    void add( const void* data, const size_t size )
+    {
+        if ( size == 0 ) return;
+        m_data[ m_nbuffers ] = static_cast<kvs::UInt8*>( const_cast<void*>( data ) );
+        m_size[ m_nbuffers ] = size;
+        m_nbuffers++;
+    }
+
+    bool isDone() const { return m_index >= m_nbuffers; }
+    kvs::UInt8* data() const { return m_data[ m_index ] + m_offset; }
+    size_t size() const { return m_size[ m_index ] - m_offset; }
+
+    void advance( const size_t size )
+    {
+        m_offset += size;
+        if ( m_offset == m_size[ m_index ] ) { m_index++; m_offset = 0; }
+    }
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Sends and receives the buffers at the same time.
+ *  @param  socket [in] non-blocking socket
+ *  @param  send [in] buffers to be sent
+ *  @param  receive [in] buffers to be received
+ *  @param  timeout [in] timeout for waiting the socket
+ *  @return true if all the buffers are transferred
+ *
+ *  Both sides of the connection can send large images without deadlock,
+ *  since the socket is waited for both reading and writing.
+ */
+/*===========================================================================*/
+bool Exchange( kvs::TCPSocket* socket, Transfer& send, Transfer& receive, const kvs::SocketTimer& timeout )
+{
+    while ( !send.isDone() || !receive.isDone() )
+    {
+        int events = 0;
+        if ( !send.isDone() ) events |= kvs::SocketReactor::Writable;
+        if ( !receive.isDone() ) events |= kvs::SocketReactor::Readable;
+
+        const int occurred = kvs::SocketReactor::Wait( socket->id(), events, &timeout );
+        if ( occurred <= 0 ) return false;
+
+        if ( !send.isDone() && ( occurred & ( kvs::SocketReactor::Writable | kvs::SocketReactor::Closed ) ) )
+        {
+            const kvs::Int64 size = socket->send( send.data(), send.size() );
+            if ( size > 0 ) { send.advance( static_cast<size_t>( size ) ); }
+            else if ( !::WouldBlock() ) { return false; }
+        }
+
+        if ( !receive.isDone() && ( occurred & ( kvs::SocketReactor::Readable | kvs::SocketReactor::Closed ) ) )
+        {
+            const kvs::Int64 size = socket->receive( receive.data(), receive.size() );
+            if ( size > 0 ) { receive.advance( static_cast<size_t>( size ) ); }
+            else if ( size == 0 || !::WouldBlock() ) { return false; }
+        }
+    }
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Deletes the sockets.
+ *  @param  sockets [in] sockets
+ */
+/*===========================================================================*/
+inline void DeleteSockets( std::vector<kvs::TCPSocket*>& sockets )
+{
+    for ( size_t i = 0; i < sockets.size(); i++ ) delete sockets[i];
+    sockets.clear();
+}
+
+} // end of namespace
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new TCPImageCompositor class for the local processes.
+ *  @param  rank [in] rank of this process
+ *  @param  nranks [in] number of the ranks
+ *  @param  port [in] base port number
+ */
+/*===========================================================================*/
+TCPImageCompositor::TCPImageCompositor( const size_t rank, const size_t nranks, const int port ):
+    m_rank( rank ),
+    m_addresses( nranks, kvs::IPAddress( "127.0.0.1" ) ),
+    m_port( port ),
+    m_mode( AlphaBlending ),
+    m_timeout( 30.0 )
+{
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new TCPImageCompositor class.
+ *  @param  rank [in] rank of this process
+ *  @param  addresses [in] addresses of the ranks
+ *  @param  port [in] base port number
+ */
+/*===========================================================================*/
+TCPImageCompositor::TCPImageCompositor( const size_t rank, const std::vector<kvs::IPAddress>& addresses, const int port ):
+    m_rank( rank ),
+    m_addresses( addresses ),
+    m_port( port ),
+    m_mode( AlphaBlending ),
+    m_timeout( 30.0 )
+{
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Destroys the TCPImageCompositor class.
+ */
+/*===========================================================================*/
+TCPImageCompositor::~TCPImageCompositor()
+{
+    this->disconnect();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Connects all the ranks each other.
+ *  @return true if the connections are established
+ *
+ *  All the ranks have to call this method. The rank connects to the higher
+ *  ranks, and accepts the connections from the lower ranks, retrying until
+ *  the higher ranks are listening or the timeout is expired.
+ */
+/*===========================================================================*/
+bool TCPImageCompositor::connect()
+{
+    this->disconnect();
+
+    const size_t nranks = m_addresses.size();
+    if ( m_rank >= nranks )
+    {
+        kvsMessageError( "Rank %d is out of the number of ranks (%d).", int( m_rank ), int( nranks ) );
+        return false;
+    }
+
+    std::vector<kvs::TCPSocket*> sockets( nranks, static_cast<kvs::TCPSocket*>( NULL ) );
+    if ( nranks == 1 ) { m_sockets = sockets; return true; }
+
+    kvs::TCPServer server;
+    server.open();
+    server.setMaxConnections( static_cast<int>( nranks ) );
+    const int port = m_port + static_cast<int>( m_rank );
+    if ( server.bind( port ) < 0 || !server.listen() )
+    {
+        kvsMessageError( "Cannot listen to the port (%d). [%s]", port, server.errorString().c_str() );
+        return false;
+    }
+
+    kvs::Timer timer( kvs::Timer::Start );
+    kvs::UInt8 handshake[ ::HandshakeSize ];
+
+    // Connect to the higher ranks.
+    for ( size_t rank = m_rank + 1; rank < nranks; rank++ )
+    {
+        const int rank_port = m_port + static_cast<int>( rank );
+        for ( ; ; )
+        {
+            kvs::TCPSocket* socket = new kvs::TCPSocket();
+            socket->open();
+            if ( socket->connect( m_addresses[ rank ], rank_port ) ) { sockets[ rank ] = socket; break; }
+            delete socket;
+
+            timer.stop();
+            if ( timer.sec() > m_timeout )
+            {
+                kvsMessageError( "Cannot connect to the rank %d (port %d).", int( rank ), rank_port );
+                ::DeleteSockets( sockets );
+                return false;
+            }
+            kvs::Thread::MilliSleep( 10 );
+        }
+
+        kvs::MessageBlock::WriteHeader( handshake, m_rank );
+        if ( sockets[ rank ]->send( handshake, ::HandshakeSize ) != kvs::Int64( ::HandshakeSize ) )
+        {
+            kvsMessageError( "Cannot send the rank to the rank %d.", int( rank ) );
+            ::DeleteSockets( sockets );
+            return false;
+        }
+    }
+
+    // Accept the lower ranks.
+    for ( size_t i = 0; i < m_rank; i++ )
+    {
+        timer.stop();
+        const kvs::SocketTimer wait( kvs::Math::Max( m_timeout - timer.sec(), 0.001 ) );
+        kvs::TCPSocket* socket = server.checkForNewConnection( &wait );
+        if ( !socket )
+        {
+            kvsMessageError( "Cannot accept the lower ranks of the rank %d.", int( m_rank ) );
+            ::DeleteSockets( sockets );
+            return false;
+        }
+
+        const bool received = socket->receive( handshake, ::HandshakeSize ) == kvs::Int64( ::HandshakeSize );
+        const size_t rank = received ? static_cast<size_t>( kvs::MessageBlock::ReadHeader( handshake ) ) : nranks;
+        if ( rank >= m_rank || sockets[ rank ] )
+        {
+            kvsMessageError( "Unexpected connection to the rank %d.", int( m_rank ) );
+            delete socket;
+            ::DeleteSockets( sockets );
+            return false;
+        }
+        sockets[ rank ] = socket;
+    }
+
+    for ( size_t rank = 0; rank < nranks; rank++ )
+    {
+        if ( sockets[ rank ] ) sockets[ rank ]->disableBlocking();
+    }
+
+    m_sockets = sockets;
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Closes the connections to the ranks.
+ */
+/*===========================================================================*/
+void TCPImageCompositor::disconnect()
+{
+    ::DeleteSockets( m_sockets );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Composites the images of all the ranks.
+ *  @param  color_data [in/out] RGBA color data with the premultiplied alpha
+ *  @param  depth_data [in/out] depth data
+ *  @param  visibility [in] visibility of this rank in the AlphaBlending mode (smaller is nearer)
+ *  @return true if the images are composited
+ *
+ *  All the ranks have to call this method with the images of the same size.
+ *  The images are composited in place. The rank 0 has the composited image
+ *  after the call, and the images of the other ranks are undefined.
+ */
+/*===========================================================================*/
+bool TCPImageCompositor::composite(
+    kvs::ValueArray<kvs::UInt8>& color_data,
+    kvs::ValueArray<kvs::Real32>& depth_data,
+    const float visibility )
+{
+    if ( !this->isConnected() )
+    {
+        kvsMessageError( "The ranks are not connected." );
+        return false;
+    }
+
+    const size_t npixels = depth_data.size();
+    if ( color_data.size() != npixels * 4 )
+    {
+        kvsMessageError( "The sizes of the color and the depth data are mismatched." );
+        return false;
+    }
+
+    const size_t nranks = m_addresses.size();
+    if ( nranks == 1 ) return true;
+
+    std::vector<size_t> order;
+    if ( !this->exchange_order( npixels, visibility, &order ) ) return false;
+
+    if ( m_color_buffer.size() != npixels * 4 ) m_color_buffer.allocate( npixels * 4 );
+    if ( m_depth_buffer.size() != npixels ) m_depth_buffer.allocate( npixels );
+
+    kvs::UInt8* color = color_data.data();
+    kvs::Real32* depth = depth_data.data();
+    const size_t position = static_cast<size_t>( std::find( order.begin(), order.end(), m_rank ) - order.begin() );
+
+    // Fold the excess ranks into the binary swap of the power-of-two ranks.
+    // The pairs of the neighbors in the compositing order are merged, and
+    // the front one of each pair joins the binary swap.
+    const size_t nswaps = ::FloorPowerOfTwo( nranks );
+    const size_t nfolds = nranks - nswaps;
+    std::vector<size_t> swaps; // ranks in the binary swap in the compositing order
+    for ( size_t i = 0; i < nranks; i++ )
+    {
+        if ( i < nfolds * 2 && i % 2 == 1 ) continue;
+        swaps.push_back( order[i] );
+    }
+
+    if ( position < nfolds * 2 )
+    {
+        const bool front = position % 2 == 0;
+        const size_t partner = order[ front ? position + 1 : position - 1 ];
+        if ( front )
+        {
+            if ( !this->exchange( partner, NULL, NULL, 0, m_color_buffer.data(), m_depth_buffer.data(), npixels ) ) return false;
+            this->blend( color, depth, 0, npixels, true );
+        }
+        else
+        {
+            if ( !this->exchange( partner, color, depth, npixels, NULL, NULL, 0 ) ) return false;
+        }
+    }
+
+    // Binary swap.
+    const size_t index = static_cast<size_t>( std::find( swaps.begin(), swaps.end(), m_rank ) - swaps.begin() );
+    const bool swapping = index < nswaps;
+    if ( swapping )
+    {
+        size_t begin = 0;
+        size_t end = npixels;
+        for ( size_t bit = 1; bit < nswaps; bit *= 2 )
+        {
+            const size_t middle = begin + ( end - begin ) / 2;
+            const size_t partner = swaps[ index ^ bit ];
+            const bool lower = ( index & bit ) == 0;
+            const size_t keep_begin = lower ? begin : middle;
+            const size_t keep_end = lower ? middle : end;
+            const size_t send_begin = lower ? middle : begin;
+            const size_t send_end = lower ? end : middle;
+
+            if ( !this->exchange(
+                     partner,
+                     color + send_begin * 4, depth + send_begin, send_end - send_begin,
+                     m_color_buffer.data(), m_depth_buffer.data(), keep_end - keep_begin ) ) return false;
+
+            // The lower index is in front of the partner in the compositing order.
+            this->blend( color, depth, keep_begin, keep_end, lower );
+            begin = keep_begin;
+            end = keep_end;
+        }
+    }
+
+    // Gather the pieces to the rank 0.
+    if ( m_rank == 0 )
+    {
+        for ( size_t i = 0; i < nswaps; i++ )
+        {
+            if ( swaps[i] == 0 ) continue;
+
+            size_t begin = 0;
+            size_t end = 0;
+            ::SwapRange( i, nswaps, npixels, &begin, &end );
+            if ( !this->exchange( swaps[i], NULL, NULL, 0, color + begin * 4, depth + begin, end - begin ) ) return false;
+        }
+    }
+    else if ( swapping )
+    {
+        size_t begin = 0;
+        size_t end = 0;
+        ::SwapRange( index, nswaps, npixels, &begin, &end );
+        if ( !this->exchange( 0, color + begin * 4, depth + begin, end - begin, NULL, NULL, 0 ) ) return false;
+    }
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Exchanges the number of pixels and the visibilities of all the ranks.
+ *  @param  npixels [in] number of pixels of this rank
+ *  @param  visibility [in] visibility of this rank
+ *  @param  order [out] ranks in the compositing order (front to back)
+ *  @return true if the all the ranks have the same number of pixels
+ */
+/*===========================================================================*/
+bool TCPImageCompositor::exchange_order( const size_t npixels, const float visibility, std::vector<size_t>* order )
+{
+    const size_t nranks = m_addresses.size();
+
+    kvs::UInt32 bits = 0;
+    std::memcpy( &bits, &visibility, sizeof( bits ) );
+    kvs::UInt8 data[ ::OrderSize ];
+    kvs::MessageBlock::WriteHeader( data, npixels );
+    kvs::MessageBlock::WriteHeader( data + 8, bits );
+
+    std::vector< std::pair<float,size_t> > visibilities( nranks );
+    visibilities[ m_rank ] = std::make_pair( visibility, m_rank );
+
+    // The small data are sent to all the ranks before receiving, since the
+    // socket buffers are empty between the compositions.
+    for ( size_t rank = 0; rank < nranks; rank++ )
+    {
+        if ( rank == m_rank ) continue;
+        if ( m_sockets[ rank ]->send( data, ::OrderSize ) != kvs::Int64( ::OrderSize ) )
+        {
+            kvsMessageError( "Cannot send the compositing order to the rank %d.", int( rank ) );
+            return false;
+        }
+    }
+
+    bool matched = true;
+    for ( size_t rank = 0; rank < nranks; rank++ )
+    {
+        if ( rank == m_rank ) continue;
+
+        kvs::UInt8 received[ ::OrderSize ];
+        ::Transfer send;
+        ::Transfer receive; receive.add( received, ::OrderSize );
+        if ( !::Exchange( m_sockets[ rank ], send, receive, kvs::SocketTimer( m_timeout ) ) )
+        {
+            kvsMessageError( "Cannot receive the compositing order from the rank %d.", int( rank ) );
+            return false;
+        }
+
+        const kvs::UInt32 rank_bits = static_cast<kvs::UInt32>( kvs::MessageBlock::ReadHeader( received + 8 ) );
+        float rank_visibility = 0.0f;
+        std::memcpy( &rank_visibility, &rank_bits, sizeof( rank_visibility ) );
+        visibilities[ rank ] = std::make_pair( rank_visibility, rank );
+
+        if ( kvs::MessageBlock::ReadHeader( received ) != npixels ) matched = false;
+    }
+
+    if ( !matched )
+    {
+        kvsMessageError( "The image sizes of the ranks are mismatched." );
+        return false;
+    }
+
+    // The z-buffer compositing does not depend on the order.
+    if ( m_mode == AlphaBlending ) std::sort( visibilities.begin(), visibilities.end() );
+
+    order->resize( nranks );
+    for ( size_t i = 0; i < nranks; i++ ) (*order)[i] = visibilities[i].second;
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sends and receives the pixels to/from the rank.
+ *  @param  rank [in] partner rank
+ *  @param  send_color [in] color data to be sent
+ *  @param  send_depth [in] depth data to be sent
+ *  @param  send_npixels [in] number of pixels to be sent
+ *  @param  receive_color [out] buffer for the received color data
+ *  @param  receive_depth [out] buffer for the received depth data
+ *  @param  receive_npixels [in] number of pixels to be received
+ *  @return true if the pixels are transferred
+ */
+/*===========================================================================*/
+bool TCPImageCompositor::exchange(
+    const size_t rank,
+    const kvs::UInt8* send_color,
+    const kvs::Real32* send_depth,
+    const size_t send_npixels,
+    kvs::UInt8* receive_color,
+    kvs::Real32* receive_depth,
+    const size_t receive_npixels )
+{
+    ::Transfer send;
+    send.add( send_color, send_npixels * 4 * sizeof( kvs::UInt8 ) );
+    send.add( send_depth, send_npixels * sizeof( kvs::Real32 ) );
+
+    ::Transfer receive;
+    receive.add( receive_color, receive_npixels * 4 * sizeof( kvs::UInt8 ) );
+    receive.add( receive_depth, receive_npixels * sizeof( kvs::Real32 ) );
+
+    if ( !::Exchange( m_sockets[ rank ], send, receive, kvs::SocketTimer( m_timeout ) ) )
+    {
+        kvsMessageError( "Cannot exchange the image with the rank %d.", int( rank ) );
+        return false;
+    }
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Composites the received pixels with the pixels of this rank.
+ *  @param  color_data [in/out] color data of this rank
+ *  @param  depth_data [in/out] depth data of this rank
+ *  @param  begin [in] first pixel
+ *  @param  end [in] pixel next to the last one
+ *  @param  front [in] true if this rank is in front of the received pixels
+ */
+/*===========================================================================*/
+void TCPImageCompositor::blend(
+    kvs::UInt8* color_data,
+    kvs::Real32* depth_data,
+    const size_t begin,
+    const size_t end,
+    const bool front )
+{
+    const kvs::UInt8* received_color = m_color_buffer.data();
+    const kvs::Real32* received_depth = m_depth_buffer.data();
+    kvs::UInt8* color = color_data + begin * 4;
+    kvs::Real32* depth = depth_data + begin;
+    const size_t npixels = end - begin;
+
+    if ( m_mode == DepthTest )
+    {
+        for ( size_t i = 0, i4 = 0; i < npixels; i++, i4 += 4 )
+        {
+            if ( received_depth[i] < depth[i] || ( received_depth[i] == depth[i] && !front ) )
+            {
+                depth[i] = received_depth[i];
+                std::memcpy( color + i4, received_color + i4, 4 );
+            }
+        }
+        return;
+    }
+
+    // Over operator with the premultiplied alpha.
+    for ( size_t i = 0, i4 = 0; i < npixels; i++, i4 += 4 )
+    {
+        const kvs::UInt8* src = front ? color + i4 : received_color + i4;
+        const kvs::UInt8* dst = front ? received_color + i4 : color + i4;
+        const unsigned int weight = 255 - src[3];
+
+        kvs::UInt8 result[4];
+        for ( size_t c = 0; c < 4; c++ )
+        {
+            const unsigned int value = src[c] + ( dst[c] * weight + 127 ) / 255;
+            result[c] = static_cast<kvs::UInt8>( kvs::Math::Min( value, 255u ) );
+        }
+        std::memcpy( color + i4, result, 4 );
+        depth[i] = kvs::Math::Min( depth[i], received_depth[i] );
+    }
+}
+
+} // end of namespace kvs
@@ -0,0 +1,117 @@
+/*****************************************************************************/
+/**
+ *  @file   TCPImageCompositor.h
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#ifndef KVS__TCP_IMAGE_COMPOSITOR_H_INCLUDE
+#define KVS__TCP_IMAGE_COMPOSITOR_H_INCLUDE
+
+#include <vector>
+#include <kvs/Type>
+#include <kvs/ValueArray>
+#include <kvs/Noncopyable>
+#include <kvs/IPAddress>
+#include <kvs/TCPSocket>
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Sort-last image compositor over TCP.
+ *
+ *  Each of the N processes (ranks) renders a part of the data into an image
+ *  of the same size, and composite() merges the RGBA color and the depth of
+ *  all the ranks by the binary-swap algorithm. The image is divided into
+ *  halves at each stage and exchanged with the partner rank, so that every
+ *  rank composites only 1/N of the image at the end, and the pieces are
+ *  gathered to the rank 0. When N is not a power of two, the excess ranks
+ *  first send their whole images to their neighbors in the compositing
+ *  order (folding).
+ *
+ *  The color is RGBA with the premultiplied alpha, as colorData() and
+ *  depthData() of kvs::VolumeRendererBase and kvs::HostFrameBuffer. In the
+ *  AlphaBlending mode, the images are blended by the over operator in the
+ *  order of the visibility values given by the ranks (smaller is nearer),
+ *  which must be a front-to-back order of the sub-domains such as the slabs
+ *  or the k-d tree blocks seen from the camera. In the DepthTest mode, the
+ *  nearest pixel is chosen by the depth as the z-buffer.
+ *
+ *  The rank r listens to the port (base port + r). connect() connects all the
+ *  ranks each other, since the partners change with the compositing order.
+ */
+/*===========================================================================*/
+class TCPImageCompositor : private kvs::Noncopyable
+{
+public:
+
+    enum CompositingMode
+    {
+        AlphaBlending, ///< over operator in the order of the visibility
+        DepthTest ///< nearest pixel by the depth
+    };
+
+private:
+
+    size_t m_rank; ///< rank of this process
+    std::vector<kvs::IPAddress> m_addresses; ///< addresses of the ranks
+    int m_port; ///< base port number
+    CompositingMode m_mode; ///< compositing mode
+    double m_timeout; ///< timeout for the connection and the transfer [sec]
+    std::vector<kvs::TCPSocket*> m_sockets; ///< sockets to the ranks (NULL for this rank)
+    kvs::ValueArray<kvs::UInt8> m_color_buffer; ///< buffer for the received color
+    kvs::ValueArray<kvs::Real32> m_depth_buffer; ///< buffer for the received depth
+
+public:
+
+    TCPImageCompositor( const size_t rank, const size_t nranks, const int port );
+    TCPImageCompositor( const size_t rank, const std::vector<kvs::IPAddress>& addresses, const int port );
+    ~TCPImageCompositor();
+
+    size_t rank() const { return m_rank; }
+    size_t numberOfRanks() const { return m_addresses.size(); }
+    CompositingMode compositingMode() const { return m_mode; }
+    double timeout() const { return m_timeout; }
+    bool isConnected() const { return !m_sockets.empty(); }
+
+    void setCompositingMode( const CompositingMode mode ) { m_mode = mode; }
+    void setTimeout( const double seconds ) { m_timeout = seconds; }
+
+    bool connect();
+    void disconnect();
+    bool composite(
+        kvs::ValueArray<kvs::UInt8>& color_data,
+        kvs::ValueArray<kvs::Real32>& depth_data,
+        const float visibility = 0.0f );
+
+private:
+
+    bool exchange_order( const size_t npixels, const float visibility, std::vector<size_t>* order );
+    bool exchange(
+        const size_t rank,
+        const kvs::UInt8* send_color,
+        const kvs::Real32* send_depth,
+        const size_t send_npixels,
+        kvs::UInt8* receive_color,
+        kvs::Real32* receive_depth,
+        const size_t receive_npixels );
+    void blend(
+        kvs::UInt8* color_data,
+        kvs::Real32* depth_data,
+        const size_t begin,
+        const size_t end,
+        const bool front );
+};
+
+} // end of namespace kvs
+
+#endif // KVS__TCP_IMAGE_COMPOSITOR_H_INCLUDE
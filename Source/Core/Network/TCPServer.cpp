@@ -16,7 +16,6 @@
 #include "TCPSocket.h"
 #include "SocketAddress.h"
 #include "SocketTimer.h"
-#include "SocketSelector.h"
 #include "IPAddress.h"
 #include "MessageBlock.h"
 
@@ -24,13 +23,45 @@
 namespace kvs
 {
 
+/*==========================================================================*/
+/**
+ *  Handler class that accepts the new connections on the listening socket.
+ */
+/*==========================================================================*/
+class TCPServer::AcceptHandler : public kvs::SocketReactor::Handler
+{
+private:
+
+    kvs::TCPServer* m_server; ///< server
+    kvs::TCPServer::ConnectionHandler* m_handler; ///< handler of the new connections
+
+public:
+
+    AcceptHandler( kvs::TCPServer* server, kvs::TCPServer::ConnectionHandler* handler ):
+        m_server( server ),
+        m_handler( handler ) {}
+
+    void handleEvent( const kvs::Socket::id_type, const int events )
+    {
+        if( !( events & kvs::SocketReactor::Readable ) ) return;
+
+        kvs::TCPSocket* client = m_server->checkForNewConnection();
+        if( !client ) return;
+
+        client->disableBlocking();
+        m_handler->connected( m_server, client );
+    }
+};
+
 /*==========================================================================*/
 /**
  *  Constructor.
  */
 /*==========================================================================*/
 TCPServer::TCPServer():
-    m_max_nconnections( 5 )
+    m_max_nconnections( 5 ),
+    m_reactor( NULL ),
+    m_accept_handler( NULL )
 {
 }
 
@@ -42,7 +73,9 @@ TCPServer::TCPServer():
  */
 /*==========================================================================*/
 TCPServer::TCPServer( const int port, const int max_nconnections ):
-    m_max_nconnections( max_nconnections )
+    m_max_nconnections( max_nconnections ),
+    m_reactor( NULL ),
+    m_accept_handler( NULL )
 {
     this->open();
     this->bind( port );
@@ -55,6 +88,8 @@ TCPServer::TCPServer( const int port, const int max_nconnections ):
 /*==========================================================================*/
 TCPServer::~TCPServer()
 {
+    if( m_accept_handler ) delete m_accept_handler;
+    if( m_reactor ) delete m_reactor;
 }
 
 /*==========================================================================*/
@@ -163,37 +198,86 @@ kvs::TCPSocket* TCPServer::checkForNewConnection( const kvs::SocketTimer* blocki
 {
     if( blocking_time )
     {
-        kvs::SocketSelector selector;
-        selector.setReadable( this->id() );
-
-        if( selector.select( *blocking_time ) <= 0 ) return( NULL );
-        if( !selector.isReadable( this->id() ) ) return( NULL );
+        const int events = kvs::SocketReactor::Wait( this->id(), kvs::SocketReactor::Readable, blocking_time );
+        if( events <= 0 ) return( NULL );
+        if( !( events & kvs::SocketReactor::Readable ) ) return( NULL );
     }
 
     kvs::SocketAddress address;
     kvs::Socket::id_type id = this->accept( &address );
+    if( id == kvs::Socket::InvalidID ) return( NULL );
 
     kvs::TCPSocket* connector = new kvs::TCPSocket( id, address );
     if( connector )
     {
         int nodelay = 0; // 0 = no-buffering, 1 = buffering
-        kvs::Socket::set_option( m_id, IPPROTO_TCP, TCP_NODELAY,
+        kvs::Socket::set_option( id, IPPROTO_TCP, TCP_NODELAY,
                                  &nodelay, sizeof(nodelay) );
 
         int reuse = 1;
-        kvs::Socket::set_option( m_id, SOL_SOCKET, SO_REUSEADDR,
+        kvs::Socket::set_option( id, SOL_SOCKET, SO_REUSEADDR,
                                  &reuse, sizeof(reuse) );
 
         struct linger linger_opt;
         linger_opt.l_onoff  = 1; // 0 = off, 1 = on
         linger_opt.l_linger = 1000;
-        kvs::Socket::set_option( m_id, SOL_SOCKET, SO_LINGER,
+        kvs::Socket::set_option( id, SOL_SOCKET, SO_LINGER,
                                  &linger_opt, sizeof(linger_opt) );
     }
 
     return( connector );
 }
 
+/*==========================================================================*/
+/**
+ *  Returns the reactor of the server.
+ *  @return pointer to the reactor
+ */
+/*==========================================================================*/
+kvs::SocketReactor* TCPServer::reactor()
+{
+    if( !m_reactor ) m_reactor = new kvs::SocketReactor();
+
+    return( m_reactor );
+}
+
+/*==========================================================================*/
+/**
+ *  Sets the handler for the new connections.
+ *  @param handler [in] pointer to the handler (not deleted by the server)
+ *  @return true, if the listening socket is registered to the reactor
+ *
+ *  The server has to be listening. The accepted clients are non-blocking,
+ *  and they are owned by the handler.
+ */
+/*==========================================================================*/
+bool TCPServer::setConnectionHandler( ConnectionHandler* handler )
+{
+    if( m_accept_handler )
+    {
+        this->reactor()->remove( kvs::Socket::id() );
+        delete m_accept_handler;
+        m_accept_handler = NULL;
+    }
+
+    if( !handler ) return( true );
+
+    m_accept_handler = new AcceptHandler( this, handler );
+    return( this->reactor()->add( kvs::Socket::id(), m_accept_handler, kvs::SocketReactor::Readable ) );
+}
+
+/*==========================================================================*/
+/**
+ *  Waits for the new connections and the messages, and calls the handlers.
+ *  @param timeout [in] timeout (NULL for infinite)
+ *  @return number of the sockets with the events, 0 if timeout, or -1 if an error occurs
+ */
+/*==========================================================================*/
+int TCPServer::dispatch( const kvs::SocketTimer* timeout )
+{
+    return( this->reactor()->dispatch( timeout ) );
+}
+
 /*==========================================================================*/
 /**
  *  Send message.
@@ -203,14 +287,14 @@ kvs::TCPSocket* TCPServer::checkForNewConnection( const kvs::SocketTimer* blocki
  *  @return send message size
  */
 /*==========================================================================*/
-int TCPServer::send( const void* buffer, int byte_size, kvs::SocketAddress* client_address )
+kvs::Int64 TCPServer::send( const void* buffer, size_t byte_size, kvs::SocketAddress* client_address )
 {
-    int size = -1;
+    kvs::Int64 size = -1;
 
     kvs::Socket::id_type id = this->accept( client_address );
     if( id != kvs::Socket::InvalidID )
     {
-        size = ::send( id, (const char*)buffer, byte_size, 0 );
+        size = kvs::Socket::send_exact( id, (const char*)buffer, byte_size );
         kvs::Socket::close_socket( id );
     }
 
@@ -225,21 +309,9 @@ int TCPServer::send( const void* buffer, int byte_size, kvs::SocketAddress* clie
  *  @return send message size
  */
 /*==========================================================================*/
-int TCPServer::send( const kvs::MessageBlock& message, kvs::SocketAddress* client_address )
+kvs::Int64 TCPServer::send( const kvs::MessageBlock& message, kvs::SocketAddress* client_address )
 {
-    int size = -1;
-
-    kvs::Socket::id_type id = this->accept( client_address );
-    if( id != kvs::Socket::InvalidID )
-    {
-        size = ::send( id,
-                       (const char*)message.blockData(),
-                       message.blockSize(), 0 );
-
-        kvs::Socket::close_socket( id );
-    }
-
-    return( size );
+    return( this->send( message.blockData(), message.blockSize(), client_address ) );
 }
 
 /*==========================================================================*/
@@ -251,9 +323,9 @@ int TCPServer::send( const kvs::MessageBlock& message, kvs::SocketAddress* clien
  *  @return received message size
  */
 /*==========================================================================*/
-int TCPServer::receive( void* buffer, int byte_size, kvs::SocketAddress* client_address )
+kvs::Int64 TCPServer::receive( void* buffer, size_t byte_size, kvs::SocketAddress* client_address )
 {
-    int size = -1;
+    kvs::Int64 size = -1;
 
     kvs::Socket::id_type id = this->accept( client_address );
     if( id != kvs::Socket::InvalidID )
@@ -273,24 +345,16 @@ int TCPServer::receive( void* buffer, int byte_size, kvs::SocketAddress* client_
  *  @return received message size
  */
 /*==========================================================================*/
-int TCPServer::receive( kvs::MessageBlock* message, kvs::SocketAddress* client_address )
+kvs::Int64 TCPServer::receive( kvs::MessageBlock* message, kvs::SocketAddress* client_address )
 {
-    int size = -1;
+    kvs::Int64 size = -1;
 
     kvs::Socket::id_type id = this->accept( client_address );
     if( id != kvs::Socket::InvalidID )
     {
-        size_t data_size = 0;
-        int status = kvs::Socket::receive_peek( id, (char*)&data_size, sizeof( size_t ) );
-        if( status == -1 ) return( status );
-
-        message->allocate( ntohl( data_size ) );
-
-        size = kvs::Socket::receive_exact( id,
-                                           (char*)message->blockData(),
-                                           message->blockSize() );
-
-        kvs::Socket::close_socket( id );
+        // The accepted socket is closed by the client socket.
+        kvs::TCPSocket client( id, client_address ? *client_address : kvs::SocketAddress() );
+        size = client.receive( message );
     }
 
     return( size );
@@ -19,6 +19,7 @@
 #include "SocketAddress.h"
 #include "MessageBlock.h"
 #include "TCPSocket.h"
+#include "SocketReactor.h"
 
 
 namespace kvs
@@ -27,13 +28,39 @@ namespace kvs
 /*==========================================================================*/
 /**
  *  TCP server class.
+ *
+ *  Many clients are served by the reactor (kvs::SocketReactor) of the server.
+ *  When the connection handler is set, the new connections are accepted in
+ *  dispatch() and passed to the handler, which registers the clients to the
+ *  reactor to receive their messages in dispatch().
  */
 /*==========================================================================*/
 class TCPServer : public kvs::Socket
 {
+public:
+
+    /*======================================================================*/
+    /**
+     *  Handler class for the new connections.
+     */
+    /*======================================================================*/
+    class ConnectionHandler
+    {
+    public:
+
+        virtual ~ConnectionHandler() {}
+        virtual void connected( kvs::TCPServer* server, kvs::TCPSocket* client ) = 0;
+    };
+
+private:
+
+    class AcceptHandler;
+
 protected:
 
     int m_max_nconnections; ///< max. number of connection client
+    kvs::SocketReactor* m_reactor; ///< reactor (created on demand)
+    AcceptHandler* m_accept_handler; ///< handler of the listening socket
 
 public:
 
@@ -49,10 +76,19 @@ public:
     void setMaxConnections( const int max_nconnections );
     kvs::TCPSocket* checkForNewConnection( const kvs::SocketTimer* blocking_time = 0 );
 
-    int send( const void* buffer, int byte_size, kvs::SocketAddress* client_address = 0 );
-    int send( const kvs::MessageBlock& message, kvs::SocketAddress* client_address = 0 );
-    int receive( void* buffer, int byte_size, kvs::SocketAddress* client_address = 0 );
-    int receive( kvs::MessageBlock* message, kvs::SocketAddress* client_address = 0 );
+    kvs::SocketReactor* reactor();
+    bool setConnectionHandler( ConnectionHandler* handler );
+    int dispatch( const kvs::SocketTimer* timeout = 0 );
+
+    kvs::Int64 send( const void* buffer, size_t byte_size, kvs::SocketAddress* client_address = 0 );
+    kvs::Int64 send( const kvs::MessageBlock& message, kvs::SocketAddress* client_address = 0 );
+    kvs::Int64 receive( void* buffer, size_t byte_size, kvs::SocketAddress* client_address = 0 );
+    kvs::Int64 receive( kvs::MessageBlock* message, kvs::SocketAddress* client_address = 0 );
+
+private:
+
+    TCPServer( const TCPServer& );
+    TCPServer& operator = ( const TCPServer& );
 };
 
 } // end of namespace kvs
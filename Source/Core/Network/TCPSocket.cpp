@@ -16,6 +16,8 @@
 #include "SocketAddress.h"
 #include "SocketTimer.h"
 #include "MessageBlock.h"
+#include <cstring>
+#include <kvs/Assert>
 
 
 namespace kvs
@@ -27,7 +29,8 @@ namespace kvs
  */
 /*==========================================================================*/
 TCPSocket::TCPSocket():
-    m_is_connected( false )
+    m_is_connected( false ),
+    m_received_size( 0 )
 {
 }
 
@@ -40,7 +43,8 @@ TCPSocket::TCPSocket():
  */
 /*==========================================================================*/
 TCPSocket::TCPSocket( const kvs::IPAddress& ip, const int port , const kvs::SocketTimer* timeout ):
-    m_is_connected( false )
+    m_is_connected( false ),
+    m_received_size( 0 )
 {
     this->open();
     this->connect( ip, port, timeout );
@@ -54,7 +58,8 @@ TCPSocket::TCPSocket( const kvs::IPAddress& ip, const int port , const kvs::Sock
  */
 /*==========================================================================*/
 TCPSocket::TCPSocket( const kvs::SocketAddress& socket_address, const kvs::SocketTimer* timeout ):
-    m_is_connected( false )
+    m_is_connected( false ),
+    m_received_size( 0 )
 {
     this->open();
     this->connect( socket_address, timeout );
@@ -69,7 +74,8 @@ TCPSocket::TCPSocket( const kvs::SocketAddress& socket_address, const kvs::Socke
 /*==========================================================================*/
 TCPSocket::TCPSocket( const kvs::Socket::id_type& id, const kvs::SocketAddress& address ):
     kvs::Socket( id, address ),
-    m_is_connected( false )
+    m_is_connected( false ),
+    m_received_size( 0 )
 {
 }
 
@@ -198,9 +204,9 @@ bool TCPSocket::complete( const kvs::SocketTimer* timeout )
  *  @return size of sent messages
  */
 /*==========================================================================*/
-int TCPSocket::send( const void* message, const int message_size )
+kvs::Int64 TCPSocket::send( const void* message, const size_t message_size )
 {
-    return( ::send( kvs::Socket::id(), (const char*)message, message_size, 0 ) );
+    return( kvs::Socket::send_exact( kvs::Socket::id(), (const char*)message, message_size ) );
 }
 
 /*==========================================================================*/
@@ -210,11 +216,51 @@ int TCPSocket::send( const void* message, const int message_size )
  *  @return size of sent message
  */
 /*==========================================================================*/
-int TCPSocket::send( const kvs::MessageBlock& message )
+kvs::Int64 TCPSocket::send( const kvs::MessageBlock& message )
 {
     return( this->send( message.blockData(), message.blockSize() ) );
 }
 
+/*==========================================================================*/
+/**
+ *  Send buffers with a gather write.
+ *  @param buffers [in] pointers to buffers
+ *  @param buffer_sizes [in] sizes of buffers [byte]
+ *  @param nbuffers [in] number of buffers
+ *  @return size of sent buffers
+ */
+/*==========================================================================*/
+kvs::Int64 TCPSocket::send(
+    const void* const* buffers,
+    const size_t*      buffer_sizes,
+    const size_t       nbuffers )
+{
+    return( kvs::Socket::send_vector( kvs::Socket::id(), buffers, buffer_sizes, nbuffers ) );
+}
+
+/*==========================================================================*/
+/**
+ *  Send message in the format of the message block.
+ *  @param message [in] pointer to message
+ *  @param message_size [in] size of message [byte]
+ *  @return size of sent message including the header
+ *
+ *  The header and the message are sent by a gather write, so that the
+ *  message is not copied into a message block. The message can be received
+ *  by receive( kvs::MessageBlock* ).
+ */
+/*==========================================================================*/
+kvs::Int64 TCPSocket::sendMessage( const void* message, const size_t message_size )
+{
+    kvs::UInt8 header[8];
+    KVS_ASSERT( sizeof( header ) == kvs::MessageBlock::HeaderSize() );
+    kvs::MessageBlock::WriteHeader( header, message_size );
+
+    const void* buffers[2] = { header, message };
+    const size_t buffer_sizes[2] = { sizeof( header ), message_size };
+    return( this->send( buffers, buffer_sizes, 2 ) );
+}
+
 /*==========================================================================*/
 /**
  *  Receive messages.
@@ -223,7 +269,7 @@ int TCPSocket::send( const kvs::MessageBlock& message )
  *  @return size of received message
  */
 /*==========================================================================*/
-int TCPSocket::receive( void* message, const int message_size )
+kvs::Int64 TCPSocket::receive( void* message, const size_t message_size )
 {
     return( kvs::Socket::receive_exact( kvs::Socket::id(), (char*)message, message_size ) );
 }
@@ -232,20 +278,64 @@ int TCPSocket::receive( void* message, const int message_size )
 /**
  *  Receive message exactly.
  *  @param  message [out] pointer to received message
- *  @return size of received message
+ *  @return size of received message including the header, 0 if the message
+ *          is not completed yet, or ErrorValue
+ *
+ *  The header is received first, and the message is received directly into
+ *  the allocated message block. If the non-blocking socket would block before
+ *  the message is completed, 0 is returned and the received size is kept in
+ *  the socket, so that the next call with the same message block resumes
+ *  receiving it when the socket becomes readable.
  */
 /*==========================================================================*/
-int TCPSocket::receive( MessageBlock* message )
+kvs::Int64 TCPSocket::receive( MessageBlock* message )
 {
-    size_t message_size = 0;
-    int status = kvs::Socket::receive_peek( kvs::Socket::id(),
-                                            (char*)&message_size,
-                                            sizeof( size_t ) );
-    if( status == -1 ) return( status );
+    const size_t header_size = sizeof( m_receive_header );
+    KVS_ASSERT( header_size == kvs::MessageBlock::HeaderSize() );
+
+    while( m_received_size < header_size )
+    {
+        const kvs::Int64 size = this->receive( m_receive_header + m_received_size, header_size - m_received_size );
+        if( size <= 0 ) return( this->suspend_receive( size ) );
 
-    message->allocate( ntohl( message_size ) );
+        m_received_size += static_cast<size_t>( size );
+        if( m_received_size == header_size )
+        {
+            const size_t message_size = static_cast<size_t>( kvs::MessageBlock::ReadHeader( m_receive_header ) );
+            if( !message->allocate( message_size ) ) { m_received_size = 0; return( Socket::ErrorValue ); }
+            memcpy( message->blockData(), m_receive_header, header_size );
+        }
+    }
 
-    return( this->receive( message->blockData(), message->blockSize() ) );
+    const size_t block_size = message->blockSize();
+    kvs::UInt8* block = static_cast<kvs::UInt8*>( message->blockData() );
+    while( m_received_size < block_size )
+    {
+        const kvs::Int64 size = this->receive( block + m_received_size, block_size - m_received_size );
+        if( size <= 0 ) return( this->suspend_receive( size ) );
+
+        m_received_size += static_cast<size_t>( size );
+    }
+
+    m_received_size = 0;
+    return( static_cast<kvs::Int64>( block_size ) );
+}
+
+/*==========================================================================*/
+/**
+ *  Receive buffers with a scatter read.
+ *  @param buffers [out] pointers to buffers
+ *  @param buffer_sizes [in] sizes of buffers [byte]
+ *  @param nbuffers [in] number of buffers
+ *  @return size of received buffers
+ */
+/*==========================================================================*/
+kvs::Int64 TCPSocket::receive(
+    void* const*  buffers,
+    const size_t* buffer_sizes,
+    const size_t  nbuffers )
+{
+    return( kvs::Socket::receive_vector( kvs::Socket::id(), buffers, buffer_sizes, nbuffers ) );
 }
 
 /*==========================================================================*/
@@ -273,4 +363,20 @@ int TCPSocket::receiveLine( std::string& line )
     return( kvs::Socket::receive_line( kvs::Socket::id(), line ) );
 }
 
+/*==========================================================================*/
+/**
+ *  Suspend or stop receiving the message block.
+ *  @param status [in] status of the last receive
+ *  @return 0 if the non-blocking socket would block, or ErrorValue
+ */
+/*==========================================================================*/
+kvs::Int64 TCPSocket::suspend_receive( const kvs::Int64 status )
+{
+    if( status < 0 && kvs::Socket::would_block() ) return( 0 );
+
+    // The connection is closed or broken, and the partial message is discarded.
+    m_received_size = 0;
+    return( Socket::ErrorValue );
+}
+
 } // end of namespace kvs
@@ -27,6 +27,14 @@ namespace kvs
 /*==========================================================================*/
 /**
  *  TCP socket class.
+ *
+ *  The sizes of the messages are 64-bit, and the partial writes and reads
+ *  are repeated until the whole message is transferred. For the non-blocking
+ *  socket (disableBlocking), send and receive return the size transferred
+ *  before the socket would block, so that the rest is transferred when the
+ *  socket becomes writable or readable (see kvs::SocketReactor). The message
+ *  block being received is kept in the socket, and receive( MessageBlock* )
+ *  resumes it.
  */
 /*==========================================================================*/
 class TCPSocket : public kvs::Socket
@@ -34,6 +42,8 @@ class TCPSocket : public kvs::Socket
 protected:
 
     bool m_is_connected; ///< check flag for connection
+    kvs::UInt8 m_receive_header[8]; ///< header of the message block being received
+    size_t m_received_size; ///< received size of the message block including the header
 
 public:
 
@@ -48,12 +58,19 @@ public:
     bool connect( const kvs::IPAddress& ip, const int port, const kvs::SocketTimer* timeout = 0 );
     bool connect( const kvs::SocketAddress& socket_address, const kvs::SocketTimer* timeout = 0 );
     bool complete( const kvs::SocketTimer* timer = 0 );
-    int send( const void* message, const int message_size );
-    int send( const kvs::MessageBlock& message );
-    int receive( void* message, const int message_size );
-    int receive( kvs::MessageBlock* message );
+    kvs::Int64 send( const void* message, const size_t message_size );
+    kvs::Int64 send( const kvs::MessageBlock& message );
+    kvs::Int64 send( const void* const* buffers, const size_t* buffer_sizes, const size_t nbuffers );
+    kvs::Int64 sendMessage( const void* message, const size_t message_size );
+    kvs::Int64 receive( void* message, const size_t message_size );
+    kvs::Int64 receive( kvs::MessageBlock* message );
+    kvs::Int64 receive( void* const* buffers, const size_t* buffer_sizes, const size_t nbuffers );
     int receiveOnce( void* message, const int message_size );
     int receiveLine( std::string& line );
+
+private:
+
+    kvs::Int64 suspend_receive( const kvs::Int64 status );
 };
 
 } // end of namespace kvs
@@ -15,6 +15,14 @@
 #include "LUDecomposer.h"
 #include <kvs/Macro>
 #include <kvs/Math>
+#include <kvs/MatrixKernel>
+#include <algorithm>
+
+
+namespace
+{
+const size_t PanelSize = 64; ///< number of columns of a panel
+}
 
 
 namespace kvs
@@ -218,15 +226,18 @@ void LUDecomposer<T>::decompose()
     KVS_ASSERT( m_lu.rowSize() == m_lu.columnSize() );
 
     const int row = static_cast<int>(m_lu.rowSize());
+    const size_t n = m_lu.rowSize();
+    T* const a = m_lu.data();
 
     // Loop over rows for implicit scaling info.
     kvs::Vector<T> scaling( row );
     for ( int i = 0; i < row; i++ )
     {
         T max = T(0);
+        const T* const ai = a + i * n;
         for ( int j = 0; j < row; j++ )
         {
-            T temp = kvs::Math::Abs( m_lu[i][j] );
+            T temp = kvs::Math::Abs( ai[j] );
             if ( temp > max ) max = temp;
         }
 
@@ -237,62 +248,72 @@ void LUDecomposer<T>::decompose()
         scaling[i] = T(1) / max;
     }
 
-    // Loop over columns of Crout's method.
-    for ( int j = 0; j < row; j++ )
+    // Right-looking decomposition blocked by the panels of columns. The
+    // columns in a panel are eliminated one by one, and the rows on the right
+    // of the panel are updated by a matrix product once per panel.
+    for ( size_t j0 = 0; j0 < n; j0 += ::PanelSize )
     {
-        // Eq. (2.3.12) in the Numetical Recipes in C.
-        for ( int i = 0; i < j; i++ )
+        const size_t j1 = kvs::Math::Min( j0 + ::PanelSize, n );
+        for ( size_t j = j0; j < j1; j++ )
         {
-            T sum = m_lu[i][j];
-            for ( int k = 0; k < i; k++ )
+            // Search for largest pivot (implicit pivotting)
+            size_t pivot = j;
+            T      max   = T(0);
+            for ( size_t i = j; i < n; i++ )
             {
-                sum -= m_lu[i][k] * m_lu[k][j];
+                T temp = scaling[i] * kvs::Math::Abs( a[ i * n + j ] );
+                if ( temp >= max )
+                {
+                    max = temp;
+                    pivot = i;
+                }
             }
-            m_lu[i][j] = sum;
-        }
 
-        // Initialize for search for largest pivot (implicit pivotting)
-        int pivot = j;
-        T   max   = T(0);
-        for ( int i = j; i < row; i++ )
-        {
-            T sum = m_lu[i][j];
-            for ( int k = 0; k < j; k++ )
+            // Interchange rows.
+            if ( j != pivot )
             {
-                sum -= m_lu[i][k] * m_lu[k][j];
+                std::swap_ranges( a + pivot * n, a + pivot * n + n, a + j * n );
+                scaling[pivot] = scaling[j];
             }
-            m_lu[i][j] = sum;
 
-            T temp = scaling[i] * kvs::Math::Abs( sum );
-            if ( temp >= max )
+            m_pivots[j] = static_cast<int>( pivot );
+
+            // Singular.
+            KVS_ASSERT( !kvs::Math::IsZero( a[ j * n + j ] ) );
+
+            // Divide by the pivot element, and eliminate the column from the
+            // rest of the panel.
+            const T* const aj = a + j * n;
+            const T temp = T(1) / aj[j];
+            for ( size_t i = j + 1; i < n; i++ )
             {
-                max = temp;
-                pivot = i;
+                T* const ai = a + i * n;
+                ai[j] *= temp;
+                const T l = ai[j];
+                for ( size_t k = j + 1; k < j1; k++ ) ai[k] -= l * aj[k];
             }
         }
 
-        // Interchange rows.
-        if ( j != pivot )
+        if ( j1 < n )
         {
-            for ( int k = 0; k < row; k++ )
+            // U12 = L11^{-1} A12 by the forward substitution.
+            for ( size_t j = j0; j < j1; j++ )
             {
-                T temp         = m_lu[pivot][k];
-                m_lu[pivot][k] = m_lu[j][k];
-                m_lu[j][k]     = temp;
+                const T* const aj = a + j * n;
+                for ( size_t i = j + 1; i < j1; i++ )
+                {
+                    T* const ai = a + i * n;
+                    const T l = ai[j];
+                    for ( size_t k = j1; k < n; k++ ) ai[k] -= l * aj[k];
+                }
             }
-            scaling[pivot] = scaling[j];
-        }
-
-        m_pivots[j] = pivot;
 
-        // Singular.
-        KVS_ASSERT( !kvs::Math::IsZero( m_lu[j][j] ) );
-
-        // Now, finally, divide by the pivot element.
-        if ( j != row - 1 )
-        {
-            T temp = T(1) / m_lu[j][j];
-            for ( int i = j + 1; i < row; i++ ) m_lu[i][j] *= temp;
+            // A22 = A22 - L21 U12
+            kvs::MatrixKernel::Multiply(
+                n - j1, n - j1, j1 - j0,
+                T(-1), a + j1 * n + j0, n,
+                a + j0 * n + j1, n,
+                T(1), a + j1 * n + j1, n );
         }
     }
 
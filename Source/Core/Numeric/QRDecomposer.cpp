@@ -173,7 +173,7 @@ void QRDecomposer<T>::setMatrix( const kvs::Matrix44<T>& m )
 template <typename T>
 void QRDecomposer<T>::setMatrix( const kvs::Matrix<T>& m )
 {
-    m_qt.setSize( m.rowSize(), m.columnSize() ); m_qt.identity();
+    m_qt.setSize( m.rowSize(), m.rowSize() ); m_qt.identity();
     m_r = m;
     m_m = m;
 }
@@ -186,17 +186,19 @@ void QRDecomposer<T>::setMatrix( const kvs::Matrix<T>& m )
 template <typename T>
 void QRDecomposer<T>::decompose()
 {
-    int row = m_m.rowSize();
-    int column = m_m.columnSize();
-    int size = row != column ? column : column - 1;
+    const size_t row = m_m.rowSize();
+    const size_t column = m_m.columnSize();
+    const size_t size = row != column ? column : column - 1;
 
+    // The Householder reflection H = I - u u^t / a is applied to R and Qt as
+    // a rank-one update, A = A - u ( u^t A ) / a, instead of multiplying the
+    // reflection matrix. The rows are accessed with unit stride.
     kvs::Vector<T> u( row );
-    kvs::Matrix<T> w( row, row );
-    kvs::Matrix<T> q( row, row );
-    for( int i = 0; i < size; i++ )
+    kvs::Vector<T> w( kvs::Math::Max( row, column ) );
+    for( size_t i = 0; i < size; i++ )
     {
         T sig2 = T(0);
-        for( int j = i; j < row; j++ )
+        for( size_t j = i; j < row; j++ )
         {
             sig2 += m_r[j][i] * m_r[j][i];
         }
@@ -204,54 +206,66 @@ void QRDecomposer<T>::decompose()
         T temp = static_cast<T>(std::sqrt((double)sig2));
         T sig  = m_r[i][i] < T(0) ? -temp : temp;
         T a    = sig2 + m_r[i][i] * sig;
+        if ( kvs::Math::IsZero( a ) ) continue;
 
         u[i] = m_r[i][i] + sig;
-        for( int j = i + 1; j < row; j++ )
+        for( size_t j = i + 1; j < row; j++ )
         {
             u[j] = m_r[j][i];
         }
 
-        // Calculate Householder matrix for solving Q matrix.
-        for( int k = 0; k < row; k++ )
-        {
-            for( int j = 0; j < row; j++ )
-            {
-                q[k][j] = ((k==j)? T(1) : T(0)) - u[k] * u[j] / a;
-            }
-        }
-
         // Calculate Q matrix.
-        for( int k = 0; k < row; k++ )
-        {
-            for( int j = 0; j < row; j++ )
-            {
-                w[k][j] = T(0);
-                for( int n = 0; n < row; n++ )
-                {
-                    w[k][j] += q[k][n] * m_qt[n][j];
-                }
-            }
-        }
-        m_qt = w;
+        this->reflect( u, a, i, &m_qt, &w );
 
         // Calculate R matrix.
-        for( int k = 0; k < row; k++ )
-        {
-            for( int j = 0; j < column; j++ )
-            {
-                w[k][j] = T(0);
-                for( int n = 0; n < row; n++ )
-                {
-                    w[k][j] += q[k][n] * m_r[n][j];
-                }
-            }
-        }
-        m_r = w;
+        this->reflect( u, a, i, &m_r, &w );
 
         u[i] = T(0);
     }
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Applies the Householder reflection to the matrix.
+ *  @param  u [in] Householder vector (the elements before the offset are zero)
+ *  @param  a [in] scaling factor of the reflection
+ *  @param  offset [in] index of the first non-zero element of u
+ *  @param  m [in,out] matrix
+ *  @param  w [in] work vector
+ */
+/*===========================================================================*/
+template <typename T>
+void QRDecomposer<T>::reflect(
+    const kvs::Vector<T>& u,
+    const T a,
+    const size_t offset,
+    kvs::Matrix<T>* m,
+    kvs::Vector<T>* w ) const
+{
+    const size_t row = m->rowSize();
+    const size_t column = m->columnSize();
+    T* const data = m->data();
+    T* const v = &(*w)[0];
+
+    // v = u^t M / a
+    for ( size_t j = 0; j < column; j++ ) v[j] = T(0);
+    for ( size_t k = offset; k < row; k++ )
+    {
+        const T uk = u[k];
+        const T* const mk = data + k * column;
+        for ( size_t j = 0; j < column; j++ ) v[j] += uk * mk[j];
+    }
+    for ( size_t j = 0; j < column; j++ ) v[j] /= a;
+
+    // M = M - u v
+    for ( size_t k = offset; k < row; k++ )
+    {
+        const T uk = u[k];
+        T* const mk = data + k * column;
+        for ( size_t j = 0; j < column; j++ ) mk[j] -= uk * v[j];
+    }
+}
+
 // template instantiation
 template class QRDecomposer<float>;
 template class QRDecomposer<double>;
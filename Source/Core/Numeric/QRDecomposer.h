@@ -55,6 +55,15 @@ public:
     void setMatrix( const kvs::Matrix44<T>& m );
     void setMatrix( const kvs::Matrix<T>& m );
     void decompose();
+
+private:
+
+    void reflect(
+        const kvs::Vector<T>& u,
+        const T a,
+        const size_t offset,
+        kvs::Matrix<T>* m,
+        kvs::Vector<T>* w ) const;
 };
 
 } // end of namespace kvs
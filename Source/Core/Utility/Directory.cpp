@@ -96,6 +96,13 @@ inline std::string GetAbsolutePath( const std::string& path )
 #endif
     if ( !realpath( path.c_str(), absolute_path ) )
     {
+        // The directory which is not existed yet (ex. the directory to be
+        // made by Directory::Make) is given as the uncanonical absolute path.
+        if ( errno == ENOENT )
+        {
+            return path[0] == '/' ? path : GetCurrentPath() + "/" + path;
+        }
+
         kvsMessageError( "%s", strerror( errno ) );
         return "";
     }
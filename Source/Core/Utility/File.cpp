@@ -199,6 +199,28 @@ size_t File::byteSize() const
     return 0;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Returns the last modification time of the file.
+ *  @return modification time in seconds since the epoch (0 if not exists)
+ */
+/*===========================================================================*/
+kvs::Int64 File::modificationTime() const
+{
+#if defined ( KVS_PLATFORM_WINDOWS )
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if ( !GetFileAttributesExA( m_file_path.c_str(), GetFileExInfoStandard, &data ) ) { return 0; }
+    // FILETIME is in 100-nanosecond intervals since January 1, 1601.
+    const kvs::Int64 high = static_cast<kvs::Int64>( data.ftLastWriteTime.dwHighDateTime );
+    const kvs::Int64 low = static_cast<kvs::Int64>( data.ftLastWriteTime.dwLowDateTime );
+    return ( ( high << 32 ) | low ) / 10000000 - 11644473600LL;
+#else
+    struct stat filestat;
+    if ( stat( m_file_path.c_str(), &filestat ) ) { return 0; }
+    return static_cast<kvs::Int64>( filestat.st_mtime );
+#endif
+}
+
 /*==========================================================================*/
 /**
  *  Test to determine whether given file is a file.
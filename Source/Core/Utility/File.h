@@ -15,6 +15,7 @@
 #define KVS__FILE_H_INCLUDE
 
 #include <string>
+#include <kvs/Type>
 #if KVS_ENABLE_DEPRECATED
 #include <cstdio>
 #include <cstdlib>
@@ -60,6 +61,7 @@ public:
     std::string extension( bool complete = false ) const;
 
     size_t byteSize() const;
+    kvs::Int64 modificationTime() const;
     bool isFile() const;
     bool exists() const;
     bool parse( const std::string& file_path );
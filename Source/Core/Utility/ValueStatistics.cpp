@@ -0,0 +1,531 @@
+/****************************************************************************/
+/**
+ *  @file ValueStatistics.cpp
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/****************************************************************************/
+#include "ValueStatistics.h"
+#include <vector>
+#include <cmath>
+#include <kvs/Assert>
+#include <kvs/Math>
+#include <kvs/Value>
+#include <kvs/Thread>
+#include <kvs/SystemInformation>
+
+
+namespace
+{
+
+/// Minimum number of tuples assigned to a thread.
+const size_t MinTuplesPerThread = 1 << 16;
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the number of entries of the counting table for the type.
+ *  @return number of entries (0: the type is not counted by the table)
+ */
+/*===========================================================================*/
+template <typename T> inline size_t CountingTableSize() { return 0; }
+template <> inline size_t CountingTableSize<kvs::Int8>() { return 1 << 8; }
+template <> inline size_t CountingTableSize<kvs::UInt8>() { return 1 << 8; }
+template <> inline size_t CountingTableSize<kvs::Int16>() { return 1 << 16; }
+template <> inline size_t CountingTableSize<kvs::UInt16>() { return 1 << 16; }
+
+/*===========================================================================*/
+/**
+ *  @brief  Histogram binning parameters.
+ */
+/*===========================================================================*/
+struct Binning
+{
+    size_t nbins; ///< number of bins (0: no histogram)
+    kvs::Real64 lower; ///< lower bound of the range
+    kvs::Real64 scale; ///< number of bins per unit
+
+    size_t index( const kvs::Real64 value ) const
+    {
+        const kvs::Real64 position = ( value - lower ) * scale;
+        if ( !( position > 0.0 ) ) { return 0; }
+        const size_t index = static_cast<size_t>( position );
+        return index < nbins ? index : nbins - 1;
+    }
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Partial result calculated by a thread.
+ */
+/*===========================================================================*/
+struct Partial
+{
+    size_t count; ///< number of counted values
+    kvs::Real64 min_value; ///< min. value
+    kvs::Real64 max_value; ///< max. value
+    kvs::Real64 sum; ///< sum of the shifted values
+    kvs::Real64 sum2; ///< sum of the squared shifted values
+    std::vector<size_t> bin; ///< histogram bins or counting table
+
+    Partial():
+        count( 0 ),
+        min_value( kvs::Value<kvs::Real64>::Max() ),
+        max_value( -kvs::Value<kvs::Real64>::Max() ),
+        sum( 0.0 ),
+        sum2( 0.0 ) {}
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Reducer class that calculates the partial result for a block.
+ */
+/*===========================================================================*/
+template <typename T>
+class Reducer : public kvs::Thread
+{
+private:
+
+    const T* m_values; ///< pointer to the first tuple of the block
+    size_t m_ntuples; ///< number of tuples in the block
+    size_t m_veclen; ///< vector length
+    kvs::Real64 m_shift; ///< shift value for numerically stable sums
+    const Binning* m_binning; ///< histogram binning
+    const kvs::ValueStatistics::IgnoreValues* m_ignore_values; ///< ignore values
+    Partial m_partial; ///< partial result
+
+public:
+
+    Reducer():
+        m_values( NULL ),
+        m_ntuples( 0 ),
+        m_veclen( 1 ),
+        m_shift( 0.0 ),
+        m_binning( NULL ),
+        m_ignore_values( NULL ) {}
+
+    void init(
+        const T* values,
+        const size_t ntuples,
+        const size_t veclen,
+        const kvs::Real64 shift,
+        const Binning* binning,
+        const kvs::ValueStatistics::IgnoreValues* ignore_values )
+    {
+        m_values = values;
+        m_ntuples = ntuples;
+        m_veclen = veclen;
+        m_shift = shift;
+        m_binning = binning;
+        m_ignore_values = ignore_values;
+        m_partial = Partial();
+    }
+
+    const Partial& partial() const { return m_partial; }
+
+    void run()
+    {
+        if ( m_ntuples == 0 ) { return; }
+
+        if ( m_veclen == 1 && ::CountingTableSize<T>() > 0 ) { this->count_values(); }
+        else if ( m_veclen == 1 && m_ignore_values->empty() && m_binning->nbins == 0 ) { this->reduce_values(); }
+        else { this->reduce_tuples(); }
+    }
+
+private:
+
+    /*=======================================================================*/
+    /**
+     *  @brief  Counts the values into the counting table (8/16-bit integers).
+     */
+    /*=======================================================================*/
+    void count_values()
+    {
+        const size_t offset = static_cast<size_t>( -static_cast<kvs::Int64>( kvs::Value<T>::Min() ) );
+        m_partial.bin.assign( ::CountingTableSize<T>(), 0 );
+        size_t* counts = &m_partial.bin[0];
+
+        const T* value = m_values;
+        const T* const end = m_values + m_ntuples;
+        while ( value < end )
+        {
+            counts[ static_cast<size_t>( static_cast<kvs::Int64>( *value ) ) + offset ]++;
+            ++value;
+        }
+    }
+
+    /*=======================================================================*/
+    /**
+     *  @brief  Reduces the scalar values without histogram and ignore values.
+     */
+    /*=======================================================================*/
+    void reduce_values()
+    {
+        // Four independent accumulators break the dependency chains so that
+        // the compiler can keep the loop in vector registers.
+        const T* const p = m_values;
+        const size_t n = m_ntuples;
+        T min_value[4] = { p[0], p[0], p[0], p[0] };
+        T max_value[4] = { p[0], p[0], p[0], p[0] };
+        kvs::Real64 sum[4] = { 0.0, 0.0, 0.0, 0.0 };
+        kvs::Real64 sum2[4] = { 0.0, 0.0, 0.0, 0.0 };
+
+        size_t i = 0;
+        for ( ; i + 4 <= n; i += 4 )
+        {
+            for ( size_t j = 0; j < 4; j++ )
+            {
+                const T v = p[ i + j ];
+                min_value[j] = v < min_value[j] ? v : min_value[j];
+                max_value[j] = v > max_value[j] ? v : max_value[j];
+                const kvs::Real64 d = static_cast<kvs::Real64>( v ) - m_shift;
+                sum[j] += d;
+                sum2[j] += d * d;
+            }
+        }
+
+        for ( ; i < n; i++ )
+        {
+            const T v = p[i];
+            min_value[0] = v < min_value[0] ? v : min_value[0];
+            max_value[0] = v > max_value[0] ? v : max_value[0];
+            const kvs::Real64 d = static_cast<kvs::Real64>( v ) - m_shift;
+            sum[0] += d;
+            sum2[0] += d * d;
+        }
+
+        for ( size_t j = 0; j < 4; j++ )
+        {
+            m_partial.min_value = kvs::Math::Min( m_partial.min_value, static_cast<kvs::Real64>( min_value[j] ) );
+            m_partial.max_value = kvs::Math::Max( m_partial.max_value, static_cast<kvs::Real64>( max_value[j] ) );
+            m_partial.sum += sum[j];
+            m_partial.sum2 += sum2[j];
+        }
+        m_partial.count = n;
+    }
+
+    /*=======================================================================*/
+    /**
+     *  @brief  Reduces the tuples (general case).
+     */
+    /*=======================================================================*/
+    void reduce_tuples()
+    {
+        const bool has_ignore_values = !m_ignore_values->empty();
+        const size_t nbins = m_binning->nbins;
+        if ( nbins > 0 ) { m_partial.bin.assign( nbins, 0 ); }
+
+        const T* value = m_values;
+        const T* const end = m_values + m_ntuples * m_veclen;
+        while ( value < end )
+        {
+            kvs::Real64 v = 0.0;
+            if ( m_veclen == 1 )
+            {
+                v = static_cast<kvs::Real64>( *value );
+                ++value;
+            }
+            else
+            {
+                for ( size_t i = 0; i < m_veclen; i++ )
+                {
+                    const kvs::Real64 e = static_cast<kvs::Real64>( *value );
+                    v += e * e;
+                    ++value;
+                }
+                v = std::sqrt( v );
+            }
+
+            if ( has_ignore_values && this->is_ignore_value( v ) ) { continue; }
+
+            m_partial.count++;
+            m_partial.min_value = kvs::Math::Min( m_partial.min_value, v );
+            m_partial.max_value = kvs::Math::Max( m_partial.max_value, v );
+            const kvs::Real64 d = v - m_shift;
+            m_partial.sum += d;
+            m_partial.sum2 += d * d;
+
+            if ( nbins > 0 ) { m_partial.bin[ m_binning->index( v ) ]++; }
+        }
+    }
+
+    bool is_ignore_value( const kvs::Real64 value ) const
+    {
+        kvs::ValueStatistics::IgnoreValues::const_iterator ignore_value = m_ignore_values->begin();
+        kvs::ValueStatistics::IgnoreValues::const_iterator end = m_ignore_values->end();
+        while ( ignore_value != end )
+        {
+            if ( kvs::Math::Equal( value, *ignore_value ) ) { return true; }
+            ++ignore_value;
+        }
+
+        return false;
+    }
+};
+
+} // end of namespace
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new ValueStatistics class.
+ */
+/*===========================================================================*/
+ValueStatistics::ValueStatistics():
+    m_nthreads( 0 ),
+    m_nbins( 0 ),
+    m_has_range( false ),
+    m_min_range( 0.0 ),
+    m_max_range( 0.0 ),
+    m_count( 0 ),
+    m_min_value( 0.0 ),
+    m_max_value( 0.0 ),
+    m_mean( 0.0 ),
+    m_variance( 0.0 )
+{
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sets the histogram range.
+ *  @param  min_range [in] lower bound of the range
+ *  @param  max_range [in] upper bound of the range
+ *
+ *  If the range is not specified, the histogram is created in the range of
+ *  the min/max values.
+ */
+/*===========================================================================*/
+void ValueStatistics::setRange( const kvs::Real64 min_range, const kvs::Real64 max_range )
+{
+    m_has_range = true;
+    m_min_range = min_range;
+    m_max_range = max_range;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the standard deviation.
+ *  @return standard deviation
+ */
+/*===========================================================================*/
+kvs::Real64 ValueStatistics::standardDeviation() const
+{
+    return std::sqrt( m_variance );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Calculates the statistics of the value array.
+ *  @param  values [in] value array
+ *  @param  veclen [in] vector length
+ *  @return true, if the calculation is done successfully
+ */
+/*===========================================================================*/
+bool ValueStatistics::calculate( const kvs::AnyValueArray& values, const size_t veclen )
+{
+    switch ( values.typeID() )
+    {
+    case kvs::Type::TypeInt8:   return this->calculate( values.asValueArray<kvs::Int8  >(), veclen );
+    case kvs::Type::TypeInt16:  return this->calculate( values.asValueArray<kvs::Int16 >(), veclen );
+    case kvs::Type::TypeInt32:  return this->calculate( values.asValueArray<kvs::Int32 >(), veclen );
+    case kvs::Type::TypeInt64:  return this->calculate( values.asValueArray<kvs::Int64 >(), veclen );
+    case kvs::Type::TypeUInt8:  return this->calculate( values.asValueArray<kvs::UInt8 >(), veclen );
+    case kvs::Type::TypeUInt16: return this->calculate( values.asValueArray<kvs::UInt16>(), veclen );
+    case kvs::Type::TypeUInt32: return this->calculate( values.asValueArray<kvs::UInt32>(), veclen );
+    case kvs::Type::TypeUInt64: return this->calculate( values.asValueArray<kvs::UInt64>(), veclen );
+    case kvs::Type::TypeReal32: return this->calculate( values.asValueArray<kvs::Real32>(), veclen );
+    case kvs::Type::TypeReal64: return this->calculate( values.asValueArray<kvs::Real64>(), veclen );
+    default: break;
+    }
+
+    return false;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Calculates the statistics of the value array.
+ *  @param  values [in] value array
+ *  @param  veclen [in] vector length
+ *  @return true, if the calculation is done successfully
+ */
+/*===========================================================================*/
+template <typename T>
+bool ValueStatistics::calculate( const kvs::ValueArray<T>& values, const size_t veclen )
+{
+    return this->calculate( values.data(), values.size(), veclen );
+}
+
+template bool ValueStatistics::calculate<kvs::Int8  >( const kvs::ValueArray<kvs::Int8  >& values, const size_t veclen );
+template bool ValueStatistics::calculate<kvs::Int16 >( const kvs::ValueArray<kvs::Int16 >& values, const size_t veclen );
+template bool ValueStatistics::calculate<kvs::Int32 >( const kvs::ValueArray<kvs::Int32 >& values, const size_t veclen );
+template bool ValueStatistics::calculate<kvs::Int64 >( const kvs::ValueArray<kvs::Int64 >& values, const size_t veclen );
+template bool ValueStatistics::calculate<kvs::UInt8 >( const kvs::ValueArray<kvs::UInt8 >& values, const size_t veclen );
+template bool ValueStatistics::calculate<kvs::UInt16>( const kvs::ValueArray<kvs::UInt16>& values, const size_t veclen );
+template bool ValueStatistics::calculate<kvs::UInt32>( const kvs::ValueArray<kvs::UInt32>& values, const size_t veclen );
+template bool ValueStatistics::calculate<kvs::UInt64>( const kvs::ValueArray<kvs::UInt64>& values, const size_t veclen );
+template bool ValueStatistics::calculate<kvs::Real32>( const kvs::ValueArray<kvs::Real32>& values, const size_t veclen );
+template bool ValueStatistics::calculate<kvs::Real64>( const kvs::ValueArray<kvs::Real64>& values, const size_t veclen );
+
+/*===========================================================================*/
+/**
+ *  @brief  Calculates the statistics of the values.
+ *  @param  values [in] pointer to the values
+ *  @param  nvalues [in] number of values (number of tuples x veclen)
+ *  @param  veclen [in] vector length
+ *  @return true, if the calculation is done successfully
+ *
+ *  The values are split into contiguous blocks that are reduced in parallel.
+ *  8/16-bit integer scalars are counted into a full-range table, so that the
+ *  min/max values, the moments and the histogram are all derived from a single
+ *  pass. For the other types, the histogram needs a second pass only if its
+ *  range is not given by setRange().
+ */
+/*===========================================================================*/
+template <typename T>
+bool ValueStatistics::calculate( const T* values, const size_t nvalues, const size_t veclen )
+{
+    m_count = 0;
+    m_min_value = 0.0;
+    m_max_value = 0.0;
+    m_mean = 0.0;
+    m_variance = 0.0;
+    m_bin.release();
+
+    if ( veclen == 0 || nvalues == 0 ) { return false; }
+    KVS_ASSERT( nvalues % veclen == 0 );
+
+    const size_t ntuples = nvalues / veclen;
+    size_t nthreads = m_nthreads > 0 ? m_nthreads : kvs::SystemInformation::NumberOfProcessors();
+    nthreads = kvs::Math::Max( size_t(1), kvs::Math::Min( nthreads, ntuples / ::MinTuplesPerThread ) );
+
+    // The sums are accumulated relative to the first value.
+    kvs::Real64 shift = 0.0;
+    for ( size_t i = 0; i < veclen; i++ ) { shift += static_cast<kvs::Real64>( values[i] ) * static_cast<kvs::Real64>( values[i] ); }
+    shift = veclen == 1 ? static_cast<kvs::Real64>( values[0] ) : std::sqrt( shift );
+
+    const bool counting = veclen == 1 && ::CountingTableSize<T>() > 0;
+    const bool binning = m_nbins > 0 && !counting;
+    const int npasses = ( binning && !m_has_range ) ? 2 : 1;
+
+    ::Binning bin_params = { 0, 0.0, 0.0 };
+    std::vector< ::Reducer<T> > reducers( nthreads );
+    for ( int pass = 0; pass < npasses; pass++ )
+    {
+        if ( binning && pass == npasses - 1 )
+        {
+            const kvs::Real64 lower = m_has_range ? m_min_range : m_min_value;
+            const kvs::Real64 upper = m_has_range ? m_max_range : m_max_value;
+            bin_params.nbins = m_nbins;
+            bin_params.lower = lower;
+            bin_params.scale = upper > lower ? m_nbins / ( upper - lower ) : 0.0;
+        }
+
+        // Reduce the blocks. The first block is reduced by the calling thread.
+        const size_t block = ntuples / nthreads;
+        for ( size_t i = 0; i < nthreads; i++ )
+        {
+            const size_t begin = i * block;
+            const size_t size = ( i == nthreads - 1 ) ? ntuples - begin : block;
+            reducers[i].init( values + begin * veclen, size, veclen, shift, &bin_params, &m_ignore_values );
+        }
+        for ( size_t i = 1; i < nthreads; i++ ) { if ( !reducers[i].start() ) { reducers[i].run(); } }
+        reducers[0].run();
+        for ( size_t i = 1; i < nthreads; i++ ) { if ( reducers[i].isRunning() ) { reducers[i].wait(); } }
+
+        // Merge the partial results.
+        ::Partial result;
+        if ( counting )
+        {
+            result.bin.assign( ::CountingTableSize<T>(), 0 );
+            for ( size_t i = 0; i < nthreads; i++ )
+            {
+                const std::vector<size_t>& counts = reducers[i].partial().bin;
+                if ( counts.empty() ) { continue; }
+                for ( size_t j = 0; j < counts.size(); j++ ) { result.bin[j] += counts[j]; }
+            }
+
+            const kvs::Real64 min_type_value = static_cast<kvs::Real64>( kvs::Value<T>::Min() );
+            for ( size_t j = 0; j < result.bin.size(); j++ )
+            {
+                const kvs::Real64 v = min_type_value + j;
+                if ( result.bin[j] == 0 ) { continue; }
+
+                bool ignored = false;
+                IgnoreValues::const_iterator ignore_value = m_ignore_values.begin();
+                while ( ignore_value != m_ignore_values.end() )
+                {
+                    if ( kvs::Math::Equal( v, *ignore_value ) ) { ignored = true; break; }
+                    ++ignore_value;
+                }
+                if ( ignored ) { result.bin[j] = 0; continue; }
+
+                const kvs::Real64 n = static_cast<kvs::Real64>( result.bin[j] );
+                const kvs::Real64 d = v - shift;
+                result.count += result.bin[j];
+                result.min_value = kvs::Math::Min( result.min_value, v );
+                result.max_value = kvs::Math::Max( result.max_value, v );
+                result.sum += n * d;
+                result.sum2 += n * d * d;
+            }
+        }
+        else
+        {
+            if ( binning && pass == npasses - 1 ) { result.bin.assign( m_nbins, 0 ); }
+            for ( size_t i = 0; i < nthreads; i++ )
+            {
+                const ::Partial& partial = reducers[i].partial();
+                result.count += partial.count;
+                result.min_value = kvs::Math::Min( result.min_value, partial.min_value );
+                result.max_value = kvs::Math::Max( result.max_value, partial.max_value );
+                result.sum += partial.sum;
+                result.sum2 += partial.sum2;
+                for ( size_t j = 0; j < partial.bin.size(); j++ ) { result.bin[j] += partial.bin[j]; }
+            }
+        }
+
+        if ( result.count == 0 ) { return false; }
+
+        const kvs::Real64 n = static_cast<kvs::Real64>( result.count );
+        m_count = result.count;
+        m_min_value = result.min_value;
+        m_max_value = result.max_value;
+        m_mean = shift + result.sum / n;
+        m_variance = kvs::Math::Max( 0.0, ( result.sum2 - result.sum * result.sum / n ) / n );
+
+        if ( binning && pass == npasses - 1 )
+        {
+            m_bin.allocate( m_nbins );
+            for ( size_t j = 0; j < m_nbins; j++ ) { m_bin[j] = result.bin[j]; }
+        }
+        else if ( counting && m_nbins > 0 )
+        {
+            // Rebin the counting table into the histogram.
+            const kvs::Real64 lower = m_has_range ? m_min_range : m_min_value;
+            const kvs::Real64 upper = m_has_range ? m_max_range : m_max_value;
+            bin_params.nbins = m_nbins;
+            bin_params.lower = lower;
+            bin_params.scale = upper > lower ? m_nbins / ( upper - lower ) : 0.0;
+
+            const kvs::Real64 min_type_value = static_cast<kvs::Real64>( kvs::Value<T>::Min() );
+            m_bin.allocate( m_nbins );
+            m_bin.fill( 0 );
+            for ( size_t j = 0; j < result.bin.size(); j++ )
+            {
+                if ( result.bin[j] == 0 ) { continue; }
+                m_bin[ bin_params.index( min_type_value + j ) ] += result.bin[j];
+            }
+        }
+    }
+
+    return true;
+}
+
+} // end of namespace kvs
@@ -0,0 +1,90 @@
+/****************************************************************************/
+/**
+ *  @file ValueStatistics.h
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/****************************************************************************/
+#ifndef KVS__VALUE_STATISTICS_H_INCLUDE
+#define KVS__VALUE_STATISTICS_H_INCLUDE
+
+#include <list>
+#include <kvs/Type>
+#include <kvs/ValueArray>
+#include <kvs/AnyValueArray>
+
+
+namespace kvs
+{
+
+/*==========================================================================*/
+/**
+ *  @brief  Value statistics class.
+ *
+ *  Calculates the min/max values, the mean, the variance and (optionally)
+ *  the histogram of a value array in a single multithreaded pass. For vector
+ *  data (veclen > 1), the statistics are calculated for the magnitudes.
+ */
+/*==========================================================================*/
+class ValueStatistics
+{
+public:
+
+    typedef std::list<kvs::Real64> IgnoreValues;
+
+private:
+
+    size_t m_nthreads; ///< number of threads (0: number of processors)
+    size_t m_nbins; ///< number of histogram bins (0: no histogram)
+    bool m_has_range; ///< true if the histogram range is specified
+    kvs::Real64 m_min_range; ///< lower bound of the histogram range
+    kvs::Real64 m_max_range; ///< upper bound of the histogram range
+    IgnoreValues m_ignore_values; ///< values excluded from the statistics
+    size_t m_count; ///< number of counted values
+    kvs::Real64 m_min_value; ///< min. value
+    kvs::Real64 m_max_value; ///< max. value
+    kvs::Real64 m_mean; ///< mean value
+    kvs::Real64 m_variance; ///< variance
+    kvs::ValueArray<size_t> m_bin; ///< histogram bins
+
+public:
+
+    ValueStatistics();
+
+    void setNumberOfThreads( const size_t nthreads ) { m_nthreads = nthreads; }
+    void setNumberOfBins( const size_t nbins ) { m_nbins = nbins; }
+    void setRange( const kvs::Real64 min_range, const kvs::Real64 max_range );
+    void setIgnoreValue( const kvs::Real64 value ) { m_ignore_values.push_back( value ); }
+    void setIgnoreValues( const IgnoreValues& values ) { m_ignore_values = values; }
+
+    size_t numberOfThreads() const { return m_nthreads; }
+    size_t numberOfBins() const { return m_nbins; }
+    kvs::Real64 minRange() const { return m_min_range; }
+    kvs::Real64 maxRange() const { return m_max_range; }
+    size_t count() const { return m_count; }
+    kvs::Real64 minValue() const { return m_min_value; }
+    kvs::Real64 maxValue() const { return m_max_value; }
+    kvs::Real64 mean() const { return m_mean; }
+    kvs::Real64 variance() const { return m_variance; }
+    kvs::Real64 standardDeviation() const;
+    const kvs::ValueArray<size_t>& bin() const { return m_bin; }
+
+    bool calculate( const kvs::AnyValueArray& values, const size_t veclen = 1 );
+    template <typename T>
+    bool calculate( const kvs::ValueArray<T>& values, const size_t veclen = 1 );
+
+private:
+
+    template <typename T>
+    bool calculate( const T* values, const size_t nvalues, const size_t veclen );
+};
+
+} // end of namespace kvs
+
+#endif // KVS__VALUE_STATISTICS_H_INCLUDE
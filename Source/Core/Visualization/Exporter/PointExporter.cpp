@@ -61,6 +61,16 @@ kvs::KVSMLObjectPoint* PointExporter<kvs::KVSMLObjectPoint>::exec( const kvs::Ob
     this->setNormals( point->normals() );
     this->setSizes( point->sizes() );
 
+    // The compact arrays are written as they are.
+    if ( point->hasQuantizedCoords() )
+    {
+        const kvs::Vec3 min_coord = point->coordOffset();
+        const kvs::Vec3 max_coord = point->coordOffset() + point->coordScale() * 65535.0f; // 16 bits
+        this->setQuantizedCoords( point->quantizedCoords(), min_coord, max_coord );
+    }
+    this->setEncodedNormals( point->encodedNormals() );
+    this->setColorIndices( point->colorIndices(), point->colorPalette() );
+
     return this;
 }
 
@@ -302,13 +302,6 @@ void TetrahedraToTetrahedra::subdivide_8_tetrahedra( const kvs::UnstructuredVolu
         SuperClass::setMinMaxObjectCoords( min_coord, max_coord );
     }
 
-    if ( volume->hasMinMaxValues() )
-    {
-        const kvs::Real64 min_value( volume->minValue() );
-        const kvs::Real64 max_value( volume->maxValue() );
-        SuperClass::setMinMaxValues( min_value, max_value );
-    }
-
     SuperClass::setVeclen( volume->veclen() );
     SuperClass::setNumberOfNodes( volume->numberOfNodes() );
     SuperClass::setNumberOfCells( tet_ncells );
@@ -316,6 +309,13 @@ void TetrahedraToTetrahedra::subdivide_8_tetrahedra( const kvs::UnstructuredVolu
     SuperClass::setCoords( volume->coords() );
     SuperClass::setConnections( tet_connections );
     SuperClass::setValues( volume->values() );
+
+    if ( volume->hasMinMaxValues() )
+    {
+        const kvs::Real64 min_value( volume->minValue() );
+        const kvs::Real64 max_value( volume->maxValue() );
+        SuperClass::setMinMaxValues( min_value, max_value );
+    }
 }
 
 /*===========================================================================*/
@@ -399,13 +399,6 @@ void TetrahedraToTetrahedra::remove_quadratic_nodes( const kvs::UnstructuredVolu
         SuperClass::setMinMaxObjectCoords( min_coord, max_coord );
     }
 
-    if ( volume->hasMinMaxValues() )
-    {
-        const kvs::Real64 min_value( volume->minValue() );
-        const kvs::Real64 max_value( volume->maxValue() );
-        SuperClass::setMinMaxValues( min_value, max_value );
-    }
-
     SuperClass::setVeclen( volume->veclen() );
     SuperClass::setNumberOfNodes( tet_nnodes );
     SuperClass::setNumberOfCells( tet_ncells );
@@ -413,6 +406,13 @@ void TetrahedraToTetrahedra::remove_quadratic_nodes( const kvs::UnstructuredVolu
     SuperClass::setCoords( tet_coords );
     SuperClass::setConnections( tet_connections );
     SuperClass::setValues( kvs::AnyValueArray( tet_values ) );
+
+    if ( volume->hasMinMaxValues() )
+    {
+        const kvs::Real64 min_value( volume->minValue() );
+        const kvs::Real64 max_value( volume->maxValue() );
+        SuperClass::setMinMaxValues( min_value, max_value );
+    }
 }
 
 } // end of namespace kvs
@@ -0,0 +1,449 @@
+/*****************************************************************************/
+/**
+ *  @file   VolumePyramid.cpp
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#include "VolumePyramid.h"
+#include <limits>
+#include <cmath>
+#include <kvs/Math>
+#include <kvs/Message>
+#include <kvs/Thread>
+#include <kvs/Assert>
+#include <kvs/SystemInformation>
+
+
+namespace
+{
+
+const size_t MinNodesPerThread = 1 << 15;
+
+/*===========================================================================*/
+/**
+ *  @brief  Filter taps of a coarse node along an axis.
+ */
+/*===========================================================================*/
+struct Taps
+{
+    size_t ntaps; ///< number of taps
+    size_t index[3]; ///< fine node index of each tap
+    kvs::Real64 weight[3]; ///< weight of each tap
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Calculates the filter taps along an axis.
+ *  @param  fine [in] number of fine nodes
+ *  @param  coarse [in] number of coarse nodes
+ *  @return filter taps for each coarse node
+ */
+/*===========================================================================*/
+std::vector<Taps> CalculateTaps( const size_t fine, const size_t coarse )
+{
+    std::vector<Taps> taps( coarse );
+    for ( size_t i = 0; i < coarse; i++ )
+    {
+        if ( fine == coarse )
+        {
+            // The axis is not downsampled.
+            taps[i].ntaps = 1;
+            taps[i].index[0] = i;
+            taps[i].weight[0] = 1.0;
+        }
+        else
+        {
+            // 1-2-1 tent centered at the fine node nearest to i * (fine-1) / (coarse-1),
+            // which is 2i for an odd number of fine nodes (clamped at the boundary).
+            const long center = static_cast<long>( ( 2 * i * ( fine - 1 ) + ( coarse - 1 ) ) / ( 2 * ( coarse - 1 ) ) );
+            const long last = static_cast<long>( fine - 1 );
+            taps[i].ntaps = 3;
+            for ( long d = -1; d <= 1; d++ )
+            {
+                const long index = kvs::Math::Max( 0L, kvs::Math::Min( center + d, last ) );
+                taps[i].index[d+1] = static_cast<size_t>( index );
+                taps[i].weight[d+1] = d == 0 ? 0.5 : 0.25;
+            }
+        }
+    }
+
+    return taps;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Converts the filtered value to the value type.
+ */
+/*===========================================================================*/
+template <typename T>
+inline T ToValue( const kvs::Real64 value )
+{
+    if ( std::numeric_limits<T>::is_integer ) { return static_cast<T>( std::floor( value + 0.5 ) ); }
+    return static_cast<T>( value );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Downsampler class that filters a range of the coarse slices.
+ */
+/*===========================================================================*/
+template <typename T>
+class Downsampler : public kvs::Thread
+{
+private:
+
+    const T* m_src; ///< fine values
+    T* m_dst; ///< coarse values
+    kvs::Vec3ui m_src_resolution; ///< fine resolution
+    kvs::Vec3ui m_dst_resolution; ///< coarse resolution
+    size_t m_veclen; ///< vector length
+    kvs::VolumePyramid::FilterType m_filter_type; ///< filter type
+    const std::vector< ::Taps >* m_taps; ///< filter taps along each axis
+    size_t m_begin; ///< first coarse slice
+    size_t m_end; ///< last coarse slice + 1
+
+public:
+
+    Downsampler():
+        m_src( NULL ),
+        m_dst( NULL ),
+        m_veclen( 1 ),
+        m_filter_type( kvs::VolumePyramid::Average ),
+        m_taps( NULL ),
+        m_begin( 0 ),
+        m_end( 0 ) {}
+
+    void init(
+        const T* src,
+        T* dst,
+        const kvs::Vec3ui& src_resolution,
+        const kvs::Vec3ui& dst_resolution,
+        const size_t veclen,
+        const kvs::VolumePyramid::FilterType filter_type,
+        const std::vector< ::Taps >* taps,
+        const size_t begin,
+        const size_t end )
+    {
+        m_src = src;
+        m_dst = dst;
+        m_src_resolution = src_resolution;
+        m_dst_resolution = dst_resolution;
+        m_veclen = veclen;
+        m_filter_type = filter_type;
+        m_taps = taps;
+        m_begin = begin;
+        m_end = end;
+    }
+
+    void run()
+    {
+        const size_t src_line = m_src_resolution.x();
+        const size_t src_slice = src_line * m_src_resolution.y();
+        const size_t dst_line = m_dst_resolution.x();
+        const size_t dst_slice = dst_line * m_dst_resolution.y();
+        const std::vector< ::Taps >& tx = m_taps[0];
+        const std::vector< ::Taps >& ty = m_taps[1];
+        const std::vector< ::Taps >& tz = m_taps[2];
+
+        for ( size_t k = m_begin; k < m_end; k++ )
+        {
+            for ( size_t j = 0; j < m_dst_resolution.y(); j++ )
+            {
+                for ( size_t i = 0; i < m_dst_resolution.x(); i++ )
+                {
+                    T* dst = m_dst + ( k * dst_slice + j * dst_line + i ) * m_veclen;
+                    for ( size_t c = 0; c < m_veclen; c++ )
+                    {
+                        dst[c] = this->filter( tx[i], ty[j], tz[k], src_line, src_slice, c );
+                    }
+                }
+            }
+        }
+    }
+
+private:
+
+    T filter(
+        const ::Taps& tx,
+        const ::Taps& ty,
+        const ::Taps& tz,
+        const size_t src_line,
+        const size_t src_slice,
+        const size_t c ) const
+    {
+        kvs::Real64 sum = 0.0;
+        kvs::Real64 wsum = 0.0;
+        T min_value = m_src[ ( tz.index[0] * src_slice + ty.index[0] * src_line + tx.index[0] ) * m_veclen + c ];
+        T max_value = min_value;
+        for ( size_t z = 0; z < tz.ntaps; z++ )
+        {
+            for ( size_t y = 0; y < ty.ntaps; y++ )
+            {
+                const T* line = m_src + ( tz.index[z] * src_slice + ty.index[y] * src_line ) * m_veclen + c;
+                const kvs::Real64 wyz = tz.weight[z] * ty.weight[y];
+                for ( size_t x = 0; x < tx.ntaps; x++ )
+                {
+                    const T value = line[ tx.index[x] * m_veclen ];
+                    switch ( m_filter_type )
+                    {
+                    case kvs::VolumePyramid::Minimum: min_value = kvs::Math::Min( min_value, value ); break;
+                    case kvs::VolumePyramid::Maximum: max_value = kvs::Math::Max( max_value, value ); break;
+                    default:
+                    {
+                        const kvs::Real64 w = wyz * tx.weight[x];
+                        sum += w * static_cast<kvs::Real64>( value );
+                        wsum += w;
+                        break;
+                    }
+                    }
+                }
+            }
+        }
+
+        switch ( m_filter_type )
+        {
+        case kvs::VolumePyramid::Minimum: return min_value;
+        case kvs::VolumePyramid::Maximum: return max_value;
+        default: return ::ToValue<T>( sum / wsum );
+        }
+    }
+};
+
+} // end of namespace
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new VolumePyramid class.
+ */
+/*===========================================================================*/
+VolumePyramid::VolumePyramid():
+    m_filter_type( Average ),
+    m_nthreads( 0 ),
+    m_source( NULL )
+{
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new VolumePyramid class and builds the levels.
+ *  @param  volume [in] pointer to the source volume
+ *  @param  nlevels [in] max. number of levels including the source (0: unlimited)
+ *  @param  filter_type [in] downsampling filter
+ */
+/*===========================================================================*/
+VolumePyramid::VolumePyramid(
+    const kvs::StructuredVolumeObject* volume,
+    const size_t nlevels,
+    const FilterType filter_type ):
+    m_filter_type( filter_type ),
+    m_nthreads( 0 ),
+    m_source( NULL )
+{
+    this->build( volume, nlevels );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Destroys the VolumePyramid class.
+ */
+/*===========================================================================*/
+VolumePyramid::~VolumePyramid()
+{
+    this->release();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the volume of the specified level.
+ *  @param  level [in] level (0: source volume)
+ *  @return pointer to the volume
+ */
+/*===========================================================================*/
+const kvs::StructuredVolumeObject* VolumePyramid::level( const size_t level ) const
+{
+    KVS_ASSERT( level < this->numberOfLevels() );
+    return level == 0 ? m_source : m_levels[ level - 1 ];
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Selects the finest level within the specified number of nodes.
+ *  @param  max_nnodes [in] max. number of nodes
+ *  @return level (the coarsest level if no level is small enough)
+ */
+/*===========================================================================*/
+size_t VolumePyramid::selectLevel( const size_t max_nnodes ) const
+{
+    const size_t nlevels = this->numberOfLevels();
+    for ( size_t i = 0; i < nlevels; i++ )
+    {
+        if ( this->level(i)->numberOfNodes() <= max_nnodes ) { return i; }
+    }
+
+    return nlevels > 0 ? nlevels - 1 : 0;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns true if the pyramid can be built for the volume.
+ *  @param  volume [in] pointer to the source volume
+ *  @return true, if the volume is a uniform grid with the in-core values
+ */
+/*===========================================================================*/
+bool VolumePyramid::IsSupported( const kvs::StructuredVolumeObject* volume )
+{
+    return volume->gridType() == kvs::StructuredVolumeObject::Uniform && !volume->values().empty();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Builds the levels of the pyramid.
+ *  @param  volume [in] pointer to the source volume
+ *  @param  nlevels [in] max. number of levels including the source (0: unlimited)
+ *  @return true, if the levels are built successfully
+ */
+/*===========================================================================*/
+bool VolumePyramid::build( const kvs::StructuredVolumeObject* volume, const size_t nlevels )
+{
+    this->release();
+
+    if ( volume->gridType() != kvs::StructuredVolumeObject::Uniform )
+    {
+        kvsMessageError( "Not supported grid type." );
+        return false;
+    }
+
+    if ( volume->values().empty() )
+    {
+        kvsMessageError( "The volume has no in-core values." );
+        return false;
+    }
+
+    if ( !volume->hasMinMaxValues() ) { volume->updateMinMaxValues(); }
+
+    m_source = volume;
+    m_scales.push_back( kvs::Vec3( 1.0f, 1.0f, 1.0f ) );
+
+    const kvs::StructuredVolumeObject* fine = volume;
+    while ( nlevels == 0 || this->numberOfLevels() < nlevels )
+    {
+        const kvs::Vec3ui& r = fine->resolution();
+        if ( r.x() <= 2 && r.y() <= 2 && r.z() <= 2 ) { break; }
+
+        kvs::StructuredVolumeObject* coarse = NULL;
+        switch ( volume->values().typeID() )
+        {
+        case kvs::Type::TypeInt8:   coarse = this->downsample<kvs::Int8  >( fine ); break;
+        case kvs::Type::TypeInt16:  coarse = this->downsample<kvs::Int16 >( fine ); break;
+        case kvs::Type::TypeInt32:  coarse = this->downsample<kvs::Int32 >( fine ); break;
+        case kvs::Type::TypeInt64:  coarse = this->downsample<kvs::Int64 >( fine ); break;
+        case kvs::Type::TypeUInt8:  coarse = this->downsample<kvs::UInt8 >( fine ); break;
+        case kvs::Type::TypeUInt16: coarse = this->downsample<kvs::UInt16>( fine ); break;
+        case kvs::Type::TypeUInt32: coarse = this->downsample<kvs::UInt32>( fine ); break;
+        case kvs::Type::TypeUInt64: coarse = this->downsample<kvs::UInt64>( fine ); break;
+        case kvs::Type::TypeReal32: coarse = this->downsample<kvs::Real32>( fine ); break;
+        case kvs::Type::TypeReal64: coarse = this->downsample<kvs::Real64>( fine ); break;
+        default:
+        {
+            kvsMessageError( "Unsupported data type '%s'.", volume->values().typeInfo()->typeName() );
+            this->release();
+            return false;
+        }
+        }
+
+        const kvs::Vec3ui& c = coarse->resolution();
+        const kvs::Vec3& s = m_scales.back();
+        m_levels.push_back( coarse );
+        m_scales.push_back( kvs::Vec3(
+            c.x() == r.x() ? s.x() : s.x() * ( c.x() - 1 ) / ( r.x() - 1 ),
+            c.y() == r.y() ? s.y() : s.y() * ( c.y() - 1 ) / ( r.y() - 1 ),
+            c.z() == r.z() ? s.z() : s.z() * ( c.z() - 1 ) / ( r.z() - 1 ) ) );
+        fine = coarse;
+    }
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Releases the levels.
+ */
+/*===========================================================================*/
+void VolumePyramid::release()
+{
+    for ( size_t i = 0; i < m_levels.size(); i++ ) { delete m_levels[i]; }
+    m_levels.clear();
+    m_scales.clear();
+    m_source = NULL;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Downsamples the volume by half along each axis.
+ *  @param  volume [in] pointer to the fine volume
+ *  @return pointer to the coarse volume
+ */
+/*===========================================================================*/
+template <typename T>
+kvs::StructuredVolumeObject* VolumePyramid::downsample( const kvs::StructuredVolumeObject* volume ) const
+{
+    const kvs::Vec3ui& r = volume->resolution();
+    const kvs::Vec3ui resolution(
+        r.x() > 2 ? r.x() / 2 + 1 : r.x(),
+        r.y() > 2 ? r.y() / 2 + 1 : r.y(),
+        r.z() > 2 ? r.z() / 2 + 1 : r.z() );
+    const size_t veclen = volume->veclen();
+    const size_t nnodes = size_t( resolution.x() ) * resolution.y() * resolution.z();
+
+    std::vector< ::Taps > taps[3];
+    for ( size_t i = 0; i < 3; i++ ) { taps[i] = ::CalculateTaps( r[i], resolution[i] ); }
+
+    kvs::ValueArray<T> values( nnodes * veclen );
+    const T* src = static_cast<const T*>( volume->values().data() );
+
+    // Filter the coarse slices. The first block is filtered by the calling thread.
+    const size_t nslices = resolution.z();
+    size_t nthreads = m_nthreads > 0 ? m_nthreads : kvs::SystemInformation::NumberOfProcessors();
+    nthreads = kvs::Math::Max( size_t(1), kvs::Math::Min( nthreads, nnodes / ::MinNodesPerThread ) );
+    nthreads = kvs::Math::Min( nthreads, nslices );
+
+    std::vector< ::Downsampler<T> > samplers( nthreads );
+    for ( size_t i = 0; i < nthreads; i++ )
+    {
+        const size_t begin = nslices * i / nthreads;
+        const size_t end = nslices * ( i + 1 ) / nthreads;
+        samplers[i].init( src, values.data(), r, resolution, veclen, m_filter_type, taps, begin, end );
+    }
+    for ( size_t i = 1; i < nthreads; i++ ) { if ( !samplers[i].start() ) { samplers[i].run(); } }
+    samplers[0].run();
+    for ( size_t i = 1; i < nthreads; i++ ) { if ( samplers[i].isRunning() ) { samplers[i].wait(); } }
+
+    kvs::StructuredVolumeObject* level = new kvs::StructuredVolumeObject();
+    level->setGridTypeToUniform();
+    level->setResolution( resolution );
+    level->setVeclen( veclen );
+    level->setValues( kvs::AnyValueArray( values ) );
+    level->setLabel( volume->label() );
+    level->setUnit( volume->unit() );
+    level->updateMinMaxCoords();
+    if ( m_source->hasMinMaxExternalCoords() )
+    {
+        level->setMinMaxExternalCoords( m_source->minExternalCoord(), m_source->maxExternalCoord() );
+    }
+    level->setMinMaxValues( m_source->minValue(), m_source->maxValue() );
+
+    return level;
+}
+
+} // end of namespace kvs
@@ -0,0 +1,93 @@
+/*****************************************************************************/
+/**
+ *  @file   VolumePyramid.h
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#ifndef KVS__VOLUME_PYRAMID_H_INCLUDE
+#define KVS__VOLUME_PYRAMID_H_INCLUDE
+
+#include <vector>
+#include <kvs/StructuredVolumeObject>
+#include <kvs/Vector3>
+#include <kvs/Noncopyable>
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Multiresolution pyramid of a uniform structured volume.
+ *
+ *  Level 0 is the source volume, and each coarser level halves the
+ *  resolution along every axis that has more than two nodes. Every level
+ *  spans the bounding box of the source volume, so a point p in the index
+ *  space of the source volume is located at p * scale(level) in the index
+ *  space of the level. Every level has the min/max values of
+ *  the source volume so that the levels are classified in the same way by
+ *  a transfer function. The levels are built in parallel.
+ */
+/*===========================================================================*/
+class VolumePyramid : private kvs::Noncopyable
+{
+public:
+
+    enum FilterType
+    {
+        Average, ///< weighted average of the 3x3x3 neighbours (1-2-1 tent)
+        Minimum, ///< minimum of the 3x3x3 neighbours
+        Maximum  ///< maximum of the 3x3x3 neighbours
+    };
+
+private:
+
+    FilterType m_filter_type; ///< downsampling filter
+    size_t m_nthreads; ///< number of threads (0: number of processors)
+    const kvs::StructuredVolumeObject* m_source; ///< source volume (level 0)
+    std::vector<kvs::StructuredVolumeObject*> m_levels; ///< coarser levels (level 1, 2, ...)
+    std::vector<kvs::Vec3> m_scales; ///< index scale of each level
+
+public:
+
+    static bool IsSupported( const kvs::StructuredVolumeObject* volume );
+
+public:
+
+    VolumePyramid();
+    VolumePyramid(
+        const kvs::StructuredVolumeObject* volume,
+        const size_t nlevels = 0,
+        const FilterType filter_type = Average );
+    ~VolumePyramid();
+
+    void setFilterType( const FilterType filter_type ) { m_filter_type = filter_type; }
+    void setNumberOfThreads( const size_t nthreads ) { m_nthreads = nthreads; }
+
+    FilterType filterType() const { return m_filter_type; }
+    size_t numberOfThreads() const { return m_nthreads; }
+    const kvs::StructuredVolumeObject* sourceVolume() const { return m_source; }
+    size_t numberOfLevels() const { return m_source ? m_levels.size() + 1 : 0; }
+    const kvs::StructuredVolumeObject* level( const size_t level ) const;
+    const kvs::Vec3& scale( const size_t level ) const { return m_scales[ level ]; }
+    size_t selectLevel( const size_t max_nnodes ) const;
+
+    bool build( const kvs::StructuredVolumeObject* volume, const size_t nlevels = 0 );
+    void release();
+
+private:
+
+    template <typename T>
+    kvs::StructuredVolumeObject* downsample( const kvs::StructuredVolumeObject* volume ) const;
+};
+
+} // end of namespace kvs
+
+#endif // KVS__VOLUME_PYRAMID_H_INCLUDE
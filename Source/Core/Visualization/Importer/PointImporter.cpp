@@ -145,6 +145,18 @@ void PointImporter::import( const kvs::KVSMLObjectPoint* kvsml )
     SuperClass::setColors( kvsml->colors() );
     SuperClass::setNormals( kvsml->normals() );
     SuperClass::setSizes( kvsml->sizes() );
+    if ( kvsml->quantizedCoords().size() > 0 )
+    {
+        SuperClass::setQuantizedCoords( kvsml->quantizedCoords(), kvsml->minCoord(), kvsml->maxCoord() );
+    }
+    if ( kvsml->encodedNormals().size() > 0 )
+    {
+        SuperClass::setEncodedNormals( kvsml->encodedNormals() );
+    }
+    if ( kvsml->colorIndices().size() > 0 )
+    {
+        SuperClass::setColorIndices( kvsml->colorIndices(), kvsml->colorPalette() );
+    }
 //    SuperClass::updateMinMaxCoords();
     this->set_min_max_coord();
 
@@ -158,27 +170,21 @@ void PointImporter::import( const kvs::KVSMLObjectPoint* kvsml )
 /*==========================================================================*/
 void PointImporter::set_min_max_coord()
 {
-    const float min_x = SuperClass::coords()[0];
-    const float min_y = SuperClass::coords()[1];
-    const float min_z = SuperClass::coords()[2];
-    kvs::Vector3f min_coord( min_x, min_y, min_z );
+    // The coordinates are accessed by coord(), since they may be quantized.
+    kvs::Vector3f min_coord( SuperClass::coord( 0 ) );
     kvs::Vector3f max_coord( min_coord );
-    const size_t dimension = 3;
-    const size_t nvertices = SuperClass::coords().size() / dimension;
-    size_t index3 = 3;
-    for ( size_t i = 1; i < nvertices; i++, index3 += 3 )
+    const size_t nvertices = SuperClass::numberOfVertices();
+    for ( size_t i = 1; i < nvertices; i++ )
     {
-        const float x = SuperClass::coords()[index3];
-        const float y = SuperClass::coords()[index3+1];
-        const float z = SuperClass::coords()[index3+2];
+        const kvs::Vector3f coord( SuperClass::coord( i ) );
 
-        min_coord.x() = kvs::Math::Min( min_coord.x(), x );
-        min_coord.y() = kvs::Math::Min( min_coord.y(), y );
-        min_coord.z() = kvs::Math::Min( min_coord.z(), z );
+        min_coord.x() = kvs::Math::Min( min_coord.x(), coord.x() );
+        min_coord.y() = kvs::Math::Min( min_coord.y(), coord.y() );
+        min_coord.z() = kvs::Math::Min( min_coord.z(), coord.z() );
 
-        max_coord.x() = kvs::Math::Max( max_coord.x(), x );
-        max_coord.y() = kvs::Math::Max( max_coord.y(), y );
-        max_coord.z() = kvs::Math::Max( max_coord.z(), z );
+        max_coord.x() = kvs::Math::Max( max_coord.x(), coord.x() );
+        max_coord.y() = kvs::Math::Max( max_coord.y(), coord.y() );
+        max_coord.z() = kvs::Math::Max( max_coord.z(), coord.z() );
     }
 
     this->setMinMaxObjectCoords( min_coord, max_coord );
@@ -20,11 +20,15 @@
 #include <kvs/Vector3>
 #include <kvs/Directory>
 #include <kvs/Value>
+#include <kvs/Thread>
+#include <kvs/SystemInformation>
 
 
 namespace
 {
 
+const size_t MinNodesPerThread = 1 << 16;
+
 /*==========================================================================*/
 /**
  *  @brief  Converts to the grid type from the given string.
@@ -44,6 +48,133 @@ const kvs::StructuredVolumeObject::GridType StringToGridType( const std::string&
     }
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Returns the min. raw value of the DICOM pixel data.
+ *  @param  dicom [in] pointer to the DICOM data
+ *  @param  data [in] pointer to the raw data of the DICOM data
+ *  @return min. raw value (same as kvs::Dicom::minRawValue)
+ */
+/*===========================================================================*/
+template <typename T>
+int MinRawValue( const kvs::Dicom* dicom, const void* data )
+{
+    const T* raw_data = static_cast<const T*>( data );
+    const size_t npixels = size_t( dicom->row() ) * dicom->column();
+    T min_value = raw_data[0];
+    for ( size_t i = 1; i < npixels; i++ ) { min_value = kvs::Math::Min( min_value, raw_data[i] ); }
+    return static_cast<int>( min_value );
+}
+
+int MinRawValue( const kvs::Dicom* dicom, const void* data )
+{
+    const bool is_unsigned = dicom->pixelRepresentation();
+    switch ( dicom->bitsAllocated() )
+    {
+    case 8: return is_unsigned ? MinRawValue<kvs::UInt8>( dicom, data ) : MinRawValue<kvs::Int8>( dicom, data );
+    case 16: return is_unsigned ? MinRawValue<kvs::UInt16>( dicom, data ) : MinRawValue<kvs::Int16>( dicom, data );
+    default: return 0;
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  SliceLoader class that stores a range of the DICOM slices into the volume.
+ *
+ *  The pixel data of a slice that has not been read by the DICOM list is
+ *  read directly into the volume at the slice offset, and converted there.
+ */
+/*===========================================================================*/
+template <typename T>
+class SliceLoader : public kvs::Thread
+{
+private:
+
+    const kvs::DicomList* m_list; ///< DICOM list
+    T* m_values; ///< volume values
+    bool m_shift; ///< check flag for value shift
+    size_t m_begin; ///< first slice
+    size_t m_end; ///< last slice + 1
+    bool m_success; ///< true, if the slices are stored successfully
+
+public:
+
+    SliceLoader():
+        m_list( NULL ),
+        m_values( NULL ),
+        m_shift( false ),
+        m_begin( 0 ),
+        m_end( 0 ),
+        m_success( true ) {}
+
+    void init(
+        const kvs::DicomList* list,
+        T* values,
+        const bool shift,
+        const size_t begin,
+        const size_t end )
+    {
+        m_list = list;
+        m_values = values;
+        m_shift = shift;
+        m_begin = begin;
+        m_end = end;
+    }
+
+    bool isSuccess() const { return m_success; }
+
+    void run()
+    {
+        const size_t width = m_list->width();
+        const size_t height = m_list->height();
+        for ( size_t k = m_begin; k < m_end; k++ )
+        {
+            const kvs::Dicom* dicom = (*m_list)[k];
+            T* const slice = m_values + k * width * height;
+
+            const T* raw_data = reinterpret_cast<const T*>( dicom->rawData().data() );
+            int min_raw_value = dicom->minRawValue();
+            if ( dicom->rawData().size() == 0 )
+            {
+                if ( !dicom->readRawData( reinterpret_cast<char*>( slice ) ) )
+                {
+                    m_success = false;
+                    continue;
+                }
+
+                raw_data = slice;
+                min_raw_value = m_shift ? ::MinRawValue( dicom, slice ) : 0;
+            }
+
+            this->store( raw_data, slice, width, height, m_shift ? min_raw_value : 0 );
+        }
+    }
+
+private:
+
+    void store( const T* src, T* dst, const size_t width, const size_t height, const int shift_value )
+    {
+        // The rows are flipped vertically. A pair of the rows is processed at
+        // once so that the slice can be converted in place (src == dst).
+        const double min_range = static_cast<double>( kvs::Value<T>::Min() );
+        const double max_range = static_cast<double>( kvs::Value<T>::Max() );
+        for ( size_t j = 0; j < ( height + 1 ) / 2; j++ )
+        {
+            const T* src0 = src + ( height - j - 1 ) * width;
+            const T* src1 = src + j * width;
+            T* dst0 = dst + j * width;
+            T* dst1 = dst + ( height - j - 1 ) * width;
+            for ( size_t i = 0; i < width; i++ )
+            {
+                const double value0 = static_cast<double>( src0[i] ) - shift_value;
+                const double value1 = static_cast<double>( src1[i] ) - shift_value;
+                dst0[i] = static_cast<T>( kvs::Math::Clamp( value0, min_range, max_range ) );
+                dst1[i] = static_cast<T>( kvs::Math::Clamp( value1, min_range, max_range ) );
+            }
+        }
+    }
+};
+
 } // end of namespace
 
 
@@ -67,6 +198,7 @@ StructuredVolumeImporter::StructuredVolumeImporter()
 /*===========================================================================*/
 StructuredVolumeImporter::StructuredVolumeImporter( const std::string& filename )
 {
+    BaseClass::setSuccess( true );
     if ( kvs::KVSMLObjectStructuredVolume::CheckExtension( filename ) )
     {
         kvs::KVSMLObjectStructuredVolume* file_format = new kvs::KVSMLObjectStructuredVolume( filename );
@@ -109,9 +241,35 @@ StructuredVolumeImporter::StructuredVolumeImporter( const std::string& filename
         this->import( file_format );
         delete file_format;
     }
+    else if ( kvs::Tiff::CheckExtension( filename ) )
+    {
+        // The pages are read directly into the volume in import().
+        kvs::Tiff* file_format = new kvs::Tiff();
+        if( !file_format )
+        {
+            BaseClass::setSuccess( false );
+            kvsMessageError("Cannot read '%s'.",filename.c_str());
+            return;
+        }
+
+        file_format->enableHeaderOnly();
+        file_format->read( filename );
+
+        if( file_format->isFailure() )
+        {
+            BaseClass::setSuccess( false );
+            kvsMessageError("Cannot read '%s'.",filename.c_str());
+            delete file_format;
+            return;
+        }
+
+        this->import( file_format );
+        delete file_format;
+    }
     else if ( kvs::DicomList::CheckDirectory( filename ) )
     {
-        kvs::DicomList* file_format = new kvs::DicomList( filename );
+        // The pixel data is read directly into the volume in import().
+        kvs::DicomList* file_format = new kvs::DicomList();
         if( !file_format )
         {
             BaseClass::setSuccess( false );
@@ -119,6 +277,9 @@ StructuredVolumeImporter::StructuredVolumeImporter( const std::string& filename
             return;
         }
 
+        file_format->enableHeaderOnly();
+        file_format->read( filename );
+
         if( file_format->isFailure() )
         {
             BaseClass::setSuccess( false );
@@ -186,6 +347,10 @@ StructuredVolumeImporter::SuperClass* StructuredVolumeImporter::exec( const kvs:
     {
         this->import( volume );
     }
+    else if ( const kvs::Tiff* volume = dynamic_cast<const kvs::Tiff*>( file_format ) )
+    {
+        this->import( volume );
+    }
     else
     {
         BaseClass::setSuccess( false );
@@ -364,6 +529,53 @@ void StructuredVolumeImporter::import( const kvs::DicomList* dicom_list )
     SuperClass::updateMinMaxValues();
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Imports the pages of the multi-page TIFF file as the slices.
+ *  @param  tiff [in] pointer to the TIFF file
+ *
+ *  The strips of the pages are read in parallel directly into the volume.
+ *  The rows of the slices are stored in the order of the file (top to bottom).
+ */
+/*===========================================================================*/
+void StructuredVolumeImporter::import( const kvs::Tiff* tiff )
+{
+    if ( !tiff->isStack() )
+    {
+        BaseClass::setSuccess( false );
+        kvsMessageError("The pages of the TIFF file are not 8/16-bit gray images of the same size.");
+        return;
+    }
+
+    const size_t x_size = tiff->width();
+    const size_t y_size = tiff->height();
+    const size_t z_size = tiff->numberOfPages();
+    const size_t nnodes = x_size * y_size * z_size;
+
+    kvs::AnyValueArray values;
+    if ( tiff->colorMode() == kvs::Tiff::Gray8 ) { values.allocate<kvs::UInt8>( nnodes ); }
+    else { values.allocate<kvs::UInt16>( nnodes ); }
+
+    if ( !tiff->readPages( values.data() ) )
+    {
+        BaseClass::setSuccess( false );
+        kvsMessageError("Cannot read the pages of the TIFF file.");
+        return;
+    }
+
+    const kvs::Vector3f min_coord( 0.0f, 0.0f, 0.0f );
+    const kvs::Vector3f max_coord( x_size - 1.0f, y_size - 1.0f, z_size - 1.0f );
+    SuperClass::setMinMaxObjectCoords( min_coord, max_coord );
+    SuperClass::setMinMaxExternalCoords( min_coord, max_coord );
+
+    const kvs::Vector3ui resolution( x_size, y_size, z_size );
+    SuperClass::setGridType( kvs::StructuredVolumeObject::Uniform );
+    SuperClass::setResolution( resolution );
+    SuperClass::setVeclen( 1 );
+    SuperClass::setValues( values );
+    SuperClass::updateMinMaxValues();
+}
+
 /*===========================================================================*/
 /**
  *  @brief  Returns the data values of the DICOM list.
@@ -382,30 +594,34 @@ const kvs::AnyValueArray StructuredVolumeImporter::get_dicom_data(
     const size_t nslices = dicom_list->nslices();
     const size_t nnodes = width * height * nslices;
 
-    const double min_range = static_cast<double>( kvs::Value<T>::Min() );
-    const double max_range = static_cast<double>( kvs::Value<T>::Max() );
-
     kvs::AnyValueArray values;
     values.template allocate<T>( nnodes );
 
+    // Store the slices in parallel. The first block is stored by the calling thread.
+    size_t nthreads = dicom_list->numberOfThreads();
+    if ( nthreads == 0 ) nthreads = kvs::SystemInformation::NumberOfProcessors();
+    nthreads = kvs::Math::Max( size_t(1), kvs::Math::Min( nthreads, nnodes / ::MinNodesPerThread ) );
+    nthreads = kvs::Math::Min( nthreads, nslices );
+
     T* pvalues = static_cast<T*>( values.data() );
-    for ( size_t k = 0; k < nslices; k++ )
+    std::vector< ::SliceLoader<T> > loaders( nthreads );
+    for ( size_t i = 0; i < nthreads; i++ )
     {
-        const kvs::Dicom* dicom = (*dicom_list)[k];
-        const T* const raw_data = reinterpret_cast<const T*>( dicom->rawData().data() );
-        const int shift_value = shift ? dicom->minRawValue() : 0;
+        const size_t begin = nslices * i / nthreads;
+        const size_t end = nslices * ( i + 1 ) / nthreads;
+        loaders[i].init( dicom_list, pvalues, shift, begin, end );
+    }
+    for ( size_t i = 1; i < nthreads; i++ ) { if ( !loaders[i].start() ) { loaders[i].run(); } }
+    loaders[0].run();
+    for ( size_t i = 1; i < nthreads; i++ ) { if ( loaders[i].isRunning() ) { loaders[i].wait(); } }
 
-        for ( size_t j = 0; j < height; j++ )
+    for ( size_t i = 0; i < nthreads; i++ )
+    {
+        if ( !loaders[i].isSuccess() )
         {
-            for ( size_t i = 0; i < width; i++ )
-            {
-                const size_t pixel_index = ( height - j - 1 ) * width + i;
-                double value = static_cast<double>( raw_data[ pixel_index ] );
-                value = value - shift_value;
-                value = kvs::Math::Clamp( value, min_range, max_range );
-
-                *(pvalues++) = static_cast<T>( value );
-            }
+            BaseClass::setSuccess( false );
+            kvsMessageError("Cannot read the pixel data of the DICOM list.");
+            break;
         }
     }
 
@@ -21,6 +21,7 @@
 #include <kvs/KVSMLObjectStructuredVolume>
 #include <kvs/AVSField>
 #include <kvs/DicomList>
+#include <kvs/Tiff>
 
 
 namespace kvs
@@ -51,6 +52,7 @@ private:
     void import( const kvs::KVSMLObjectStructuredVolume* kvsml );
     void import( const kvs::AVSField* field );
     void import( const kvs::DicomList* dicom_list );
+    void import( const kvs::Tiff* tiff );
     template <typename T>
     const kvs::AnyValueArray get_dicom_data( const kvs::DicomList* dicom_list, const bool shift );
 };
@@ -0,0 +1,554 @@
+/*****************************************************************************/
+/**
+ *  @file   TimeSeriesVolume.cpp
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#include "TimeSeriesVolume.h"
+#include <kvs/Message>
+#include <kvs/Math>
+#include <kvs/Thread>
+#include <kvs/MutexLocker>
+#include <kvs/SystemInformation>
+#include <kvs/Directory>
+#include <kvs/File>
+#include <kvs/StructuredVolumeImporter>
+#include <kvs/UnstructuredVolumeImporter>
+
+
+namespace
+{
+
+const size_t DefaultCacheSize = size_t( 1 ) << 30;
+const size_t DefaultNumberOfPrefetches = 8;
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the byte size of the arrays of the volume object.
+ *  @param  object [in] pointer to the volume object
+ *  @return byte size
+ */
+/*===========================================================================*/
+size_t ByteSize( const kvs::VolumeObjectBase* object )
+{
+    if ( !object ) return 0;
+
+    size_t bytes = object->values().byteSize() + object->coords().byteSize();
+    if ( const kvs::UnstructuredVolumeObject* volume = dynamic_cast<const kvs::UnstructuredVolumeObject*>( object ) )
+    {
+        bytes += volume->connections().byteSize();
+    }
+
+    return bytes;
+}
+
+} // end of namespace
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Prefetch thread that loads the requested steps.
+ */
+/*===========================================================================*/
+class TimeSeriesVolume::Prefetcher : public kvs::Thread
+{
+private:
+
+    kvs::TimeSeriesVolume* m_volume; ///< time-series volume
+
+public:
+
+    Prefetcher( kvs::TimeSeriesVolume* volume ): m_volume( volume ) {}
+
+    void run()
+    {
+        while ( m_volume->prefetch() ) {}
+    }
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new FileLoader class.
+ *  @param  filenames [in] filenames of the steps
+ *  @param  volume_type [in] volume type of the files
+ */
+/*===========================================================================*/
+TimeSeriesVolume::FileLoader::FileLoader(
+    const std::vector<std::string>& filenames,
+    const kvs::VolumeObjectBase::VolumeType volume_type ):
+    m_filenames( filenames ),
+    m_volume_type( volume_type )
+{
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new FileLoader class for the numbered files.
+ *  @param  directory [in] directory including the files of the steps
+ *  @param  extension [in] extension of the files (ex. "kvsml")
+ *  @param  volume_type [in] volume type of the files
+ *
+ *  The files with the extension in the directory are sorted by the name,
+ *  so that the numbers of the steps must be padded with zeros.
+ */
+/*===========================================================================*/
+TimeSeriesVolume::FileLoader::FileLoader(
+    const std::string& directory,
+    const std::string& extension,
+    const kvs::VolumeObjectBase::VolumeType volume_type ):
+    m_volume_type( volume_type )
+{
+    kvs::Directory dir( directory );
+    if ( !dir.exists() || !dir.isDirectory() )
+    {
+        kvsMessageError( "%s is not a directory.", directory.c_str() );
+        return;
+    }
+
+    dir.sort();
+    kvs::FileList::const_iterator file = dir.fileList().begin();
+    kvs::FileList::const_iterator last = dir.fileList().end();
+    while ( file != last )
+    {
+        if ( file->extension() == extension )
+        {
+            m_filenames.push_back( dir.directoryPath() + kvs::Directory::Separator() + file->fileName() );
+        }
+        ++file;
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Loads the volume object of the step.
+ *  @param  step [in] step index
+ *  @return pointer to the volume object (NULL if failed)
+ */
+/*===========================================================================*/
+kvs::VolumeObjectBase* TimeSeriesVolume::FileLoader::load( const size_t step ) const
+{
+    const std::string& filename = m_filenames[ step ];
+    if ( m_volume_type == kvs::VolumeObjectBase::Unstructured )
+    {
+        kvs::UnstructuredVolumeImporter* volume = new kvs::UnstructuredVolumeImporter( filename );
+        if ( volume->isFailure() )
+        {
+            kvsMessageError( "Cannot import %s.", filename.c_str() );
+            delete volume;
+            return NULL;
+        }
+        return volume;
+    }
+    else
+    {
+        kvs::StructuredVolumeImporter* volume = new kvs::StructuredVolumeImporter( filename );
+        if ( volume->isFailure() )
+        {
+            kvsMessageError( "Cannot import %s.", filename.c_str() );
+            delete volume;
+            return NULL;
+        }
+        return volume;
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new TimeSeriesVolume class.
+ *  @param  loader [in] pointer to the loader (deleted by this class)
+ */
+/*===========================================================================*/
+TimeSeriesVolume::TimeSeriesVolume( Loader* loader ):
+    m_loader( loader ),
+    m_nsteps( loader ? loader->numberOfSteps() : 0 ),
+    m_cache_size( ::DefaultCacheSize ),
+    m_nprefetches( ::DefaultNumberOfPrefetches ),
+    m_nthreads( 0 ),
+    m_current_step( 0 ),
+    m_backward( false ),
+    m_cached_bytes( 0 ),
+    m_step_bytes( 0 ),
+    m_nloads( 0 ),
+    m_nstalls( 0 ),
+    m_terminated( false )
+{
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Destroys the TimeSeriesVolume class.
+ */
+/*===========================================================================*/
+TimeSeriesVolume::~TimeSeriesVolume()
+{
+    this->stop_prefetchers();
+
+    StepMap::iterator step = m_steps.begin();
+    while ( step != m_steps.end() )
+    {
+        delete step->second.object;
+        ++step;
+    }
+
+    delete m_loader;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the number of the steps loaded by the loader.
+ *  @return number of the loaded steps
+ */
+/*===========================================================================*/
+size_t TimeSeriesVolume::numberOfLoads()
+{
+    kvs::MutexLocker locker( &m_mutex );
+    return m_nloads;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the number of the requests waited for the loading.
+ *  @return number of the stalled requests
+ */
+/*===========================================================================*/
+size_t TimeSeriesVolume::numberOfStalls()
+{
+    kvs::MutexLocker locker( &m_mutex );
+    return m_nstalls;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the number of the decoded steps in the cache.
+ *  @return number of the decoded steps
+ */
+/*===========================================================================*/
+size_t TimeSeriesVolume::numberOfCachedSteps()
+{
+    kvs::MutexLocker locker( &m_mutex );
+
+    size_t nsteps = 0;
+    for ( StepMap::const_iterator step = m_steps.begin(); step != m_steps.end(); ++step )
+    {
+        if ( step->second.object ) nsteps++;
+    }
+
+    return nsteps;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the total byte size of the decoded steps in the cache.
+ *  @return byte size
+ */
+/*===========================================================================*/
+size_t TimeSeriesVolume::cachedBytes()
+{
+    kvs::MutexLocker locker( &m_mutex );
+    return m_cached_bytes;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sets the memory budget of the decoded steps.
+ *  @param  cache_size [in] memory budget in bytes
+ *
+ *  The number of the prefetched steps is limited so that the steps fit in
+ *  the budget. The budget might be exceeded by the steps being loaded.
+ */
+/*===========================================================================*/
+void TimeSeriesVolume::setCacheSize( const size_t cache_size )
+{
+    kvs::MutexLocker locker( &m_mutex );
+    m_cache_size = cache_size;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sets the max. number of the steps prefetched ahead of the requested step.
+ *  @param  nprefetches [in] number of the prefetched steps (0: no prefetch)
+ */
+/*===========================================================================*/
+void TimeSeriesVolume::setNumberOfPrefetches( const size_t nprefetches )
+{
+    kvs::MutexLocker locker( &m_mutex );
+    m_nprefetches = nprefetches;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sets the number of the prefetch threads.
+ *  @param  nthreads [in] number of threads (0: number of processors)
+ */
+/*===========================================================================*/
+void TimeSeriesVolume::setNumberOfThreads( const size_t nthreads )
+{
+    this->stop_prefetchers();
+    m_nthreads = nthreads;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the volume object of the step.
+ *  @param  step [in] step index
+ *  @return pointer to the volume object (NULL if failed)
+ *
+ *  The returned object is owned by this class, and is valid until the next
+ *  call of this method. To register the step to the scene, a shallow copy of
+ *  the object can be used, which shares the arrays with the cached step.
+ */
+/*===========================================================================*/
+const kvs::VolumeObjectBase* TimeSeriesVolume::object( const size_t step )
+{
+    if ( step >= m_nsteps )
+    {
+        kvsMessageError( "Step %d is out of range.", int( step ) );
+        return NULL;
+    }
+
+    this->start_prefetchers();
+
+    kvs::MutexLocker locker( &m_mutex );
+    if ( step != m_current_step ) { m_backward = step < m_current_step && m_current_step - step < m_nsteps / 2; }
+    m_current_step = step;
+
+    // The failed step is loaded again.
+    StepMap::iterator s = m_steps.find( step );
+    if ( s != m_steps.end() && !s->second.loading && !s->second.object )
+    {
+        m_steps.erase( s );
+        s = m_steps.end();
+    }
+
+    if ( s == m_steps.end() )
+    {
+        // The step is loaded by the calling thread while the following steps
+        // are prefetched by the threads.
+        Step& loading = m_steps[ step ];
+        loading.object = NULL;
+        loading.bytes = 0;
+        loading.loading = true;
+        this->request_prefetches();
+
+        m_mutex.unlock();
+        kvs::VolumeObjectBase* object = m_loader->load( step );
+        m_mutex.lock();
+
+        this->store( step, object );
+    }
+    else
+    {
+        this->request_prefetches();
+        if ( s->second.loading )
+        {
+            m_nstalls++;
+            while ( s->second.loading ) { m_loaded.wait( &m_mutex ); }
+        }
+    }
+
+    this->evict();
+    return m_steps[ step ].object;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Deletes the decoded steps in the cache.
+ */
+/*===========================================================================*/
+void TimeSeriesVolume::clearCache()
+{
+    kvs::MutexLocker locker( &m_mutex );
+
+    m_requests.clear();
+    StepMap::iterator step = m_steps.begin();
+    while ( step != m_steps.end() )
+    {
+        if ( step->second.loading ) { ++step; continue; }
+
+        m_cached_bytes -= step->second.bytes;
+        delete step->second.object;
+        m_steps.erase( step++ );
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Starts the prefetch threads if not started.
+ */
+/*===========================================================================*/
+void TimeSeriesVolume::start_prefetchers()
+{
+    if ( !m_prefetchers.empty() || m_nprefetches == 0 ) return;
+
+    size_t nthreads = m_nthreads;
+    if ( nthreads == 0 ) nthreads = kvs::SystemInformation::NumberOfProcessors();
+    nthreads = kvs::Math::Max( nthreads, size_t(1) );
+
+    m_terminated = false;
+    for ( size_t i = 0; i < nthreads; i++ )
+    {
+        Prefetcher* prefetcher = new Prefetcher( this );
+        const bool started = prefetcher->start();
+        kvsMessageWarning( started, "Cannot start the prefetch thread." );
+        if ( !started )
+        {
+            delete prefetcher;
+            break;
+        }
+        m_prefetchers.push_back( prefetcher );
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Stops the prefetch threads after the loading steps are stored.
+ */
+/*===========================================================================*/
+void TimeSeriesVolume::stop_prefetchers()
+{
+    m_mutex.lock();
+    m_terminated = true;
+    m_requests.clear();
+    m_requested.wakeUpAll();
+    m_mutex.unlock();
+
+    for ( size_t i = 0; i < m_prefetchers.size(); i++ )
+    {
+        m_prefetchers[i]->wait();
+        delete m_prefetchers[i];
+    }
+    m_prefetchers.clear();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Requests the steps following the current step in the playback order.
+ *
+ *  The previous requests are discarded. The steps are wrapped around at the
+ *  end for the loop playback. The mutex must be locked.
+ */
+/*===========================================================================*/
+void TimeSeriesVolume::request_prefetches()
+{
+    m_requests.clear();
+    if ( m_prefetchers.empty() ) return;
+
+    size_t nprefetches = kvs::Math::Min( m_nprefetches, m_nsteps - 1 );
+    if ( m_step_bytes > 0 )
+    {
+        const size_t nsteps = kvs::Math::Max( m_cache_size / m_step_bytes, size_t(1) );
+        nprefetches = kvs::Math::Min( nprefetches, nsteps - 1 );
+    }
+
+    for ( size_t i = 1; i <= nprefetches; i++ )
+    {
+        const size_t step = m_backward ?
+            ( m_current_step + m_nsteps - i ) % m_nsteps :
+            ( m_current_step + i ) % m_nsteps;
+        if ( m_steps.find( step ) == m_steps.end() ) { m_requests.push_back( step ); }
+    }
+
+    if ( !m_requests.empty() ) { m_requested.wakeUpAll(); }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Evicts the decoded steps until the cache fits in the budget.
+ *
+ *  The step farthest from the current step in the playback order, that is
+ *  the most recently passed step, is evicted first. The current step and
+ *  the loading steps are not evicted. The mutex must be locked.
+ */
+/*===========================================================================*/
+void TimeSeriesVolume::evict()
+{
+    while ( m_cached_bytes > m_cache_size )
+    {
+        StepMap::iterator victim = m_steps.end();
+        size_t max_distance = 0;
+        for ( StepMap::iterator s = m_steps.begin(); s != m_steps.end(); ++s )
+        {
+            if ( s->second.loading || s->first == m_current_step ) continue;
+
+            const size_t distance = m_backward ?
+                ( m_current_step + m_nsteps - s->first ) % m_nsteps :
+                ( s->first + m_nsteps - m_current_step ) % m_nsteps;
+            if ( distance > max_distance )
+            {
+                max_distance = distance;
+                victim = s;
+            }
+        }
+
+        if ( victim == m_steps.end() ) break;
+
+        m_cached_bytes -= victim->second.bytes;
+        delete victim->second.object;
+        m_steps.erase( victim );
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Stores the loaded step to the cache. The mutex must be locked.
+ *  @param  step [in] step index
+ *  @param  object [in] pointer to the loaded volume object (NULL if failed)
+ */
+/*===========================================================================*/
+void TimeSeriesVolume::store( const size_t step, kvs::VolumeObjectBase* object )
+{
+    Step& loaded = m_steps[ step ];
+    loaded.object = object;
+    loaded.bytes = ::ByteSize( object );
+    loaded.loading = false;
+
+    if ( object )
+    {
+        m_cached_bytes += loaded.bytes;
+        m_step_bytes = loaded.bytes;
+        m_nloads++;
+    }
+
+    m_loaded.wakeUpAll();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Loads a requested step (called by the prefetch threads).
+ *  @return false, if the prefetch threads are terminated
+ */
+/*===========================================================================*/
+bool TimeSeriesVolume::prefetch()
+{
+    kvs::MutexLocker locker( &m_mutex );
+    while ( !m_terminated && m_requests.empty() ) { m_requested.wait( &m_mutex ); }
+    if ( m_terminated ) return false;
+
+    const size_t step = m_requests.front();
+    m_requests.pop_front();
+    if ( m_steps.find( step ) != m_steps.end() ) return true;
+
+    Step& loading = m_steps[ step ];
+    loading.object = NULL;
+    loading.bytes = 0;
+    loading.loading = true;
+
+    m_mutex.unlock();
+    kvs::VolumeObjectBase* object = m_loader->load( step );
+    m_mutex.lock();
+
+    this->store( step, object );
+    return true;
+}
+
+} // end of namespace kvs
@@ -0,0 +1,149 @@
+/*****************************************************************************/
+/**
+ *  @file   TimeSeriesVolume.h
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#ifndef KVS__TIME_SERIES_VOLUME_H_INCLUDE
+#define KVS__TIME_SERIES_VOLUME_H_INCLUDE
+
+#include <map>
+#include <deque>
+#include <vector>
+#include <string>
+#include <kvs/Noncopyable>
+#include <kvs/Mutex>
+#include <kvs/Condition>
+#include <kvs/VolumeObjectBase>
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Time-series volume with the asynchronous prefetch of the steps.
+ *
+ *  The volume objects of the steps are decoded by the loader and kept in a
+ *  cache bounded by a memory budget. When a step is requested, the following
+ *  steps in the playback direction are prefetched by the background threads,
+ *  so that the next request is returned without waiting for the loading.
+ *  The steps far from the requested step are evicted when the budget is
+ *  exceeded. The steps must be requested from a single thread.
+ */
+/*===========================================================================*/
+class TimeSeriesVolume : private kvs::Noncopyable
+{
+public:
+
+    /*=======================================================================*/
+    /**
+     *  @brief  Loader of the steps, which is called from the several threads
+     *          for the different steps at the same time.
+     */
+    /*=======================================================================*/
+    class Loader
+    {
+    public:
+        virtual ~Loader() {}
+        virtual size_t numberOfSteps() const = 0;
+        virtual kvs::VolumeObjectBase* load( const size_t step ) const = 0;
+    };
+
+    /*=======================================================================*/
+    /**
+     *  @brief  Loader of the steps stored in the files (one file per step),
+     *          which are imported by the structured or unstructured volume
+     *          importer.
+     */
+    /*=======================================================================*/
+    class FileLoader : public Loader
+    {
+    private:
+        std::vector<std::string> m_filenames; ///< filenames of the steps
+        kvs::VolumeObjectBase::VolumeType m_volume_type; ///< volume type
+    public:
+        FileLoader(
+            const std::vector<std::string>& filenames,
+            const kvs::VolumeObjectBase::VolumeType volume_type = kvs::VolumeObjectBase::Structured );
+        FileLoader(
+            const std::string& directory,
+            const std::string& extension,
+            const kvs::VolumeObjectBase::VolumeType volume_type = kvs::VolumeObjectBase::Structured );
+        const std::vector<std::string>& filenames() const { return m_filenames; }
+        size_t numberOfSteps() const { return m_filenames.size(); }
+        kvs::VolumeObjectBase* load( const size_t step ) const;
+    };
+
+private:
+
+    struct Step
+    {
+        kvs::VolumeObjectBase* object; ///< decoded volume object (NULL while loading)
+        size_t bytes; ///< byte size of the values
+        bool loading; ///< true, if the step is being loaded
+    };
+
+    class Prefetcher;
+    typedef std::map<size_t,Step> StepMap;
+
+    Loader* m_loader; ///< loader of the steps
+    size_t m_nsteps; ///< number of steps
+    size_t m_cache_size; ///< memory budget of the decoded steps in bytes
+    size_t m_nprefetches; ///< max. number of the steps prefetched ahead
+    size_t m_nthreads; ///< number of prefetch threads (0: number of processors)
+    size_t m_current_step; ///< last requested step
+    bool m_backward; ///< true, if the steps are requested in the backward order
+    StepMap m_steps; ///< decoded and loading steps
+    std::deque<size_t> m_requests; ///< steps to be prefetched
+    size_t m_cached_bytes; ///< total byte size of the decoded steps
+    size_t m_step_bytes; ///< byte size of the last decoded step
+    size_t m_nloads; ///< number of the loaded steps
+    size_t m_nstalls; ///< number of the requests waited for the loading
+    bool m_terminated; ///< true, if the prefetch threads are terminated
+    kvs::Mutex m_mutex; ///< mutex for the steps and the requests
+    kvs::Condition m_requested; ///< condition signaled when the steps are requested
+    kvs::Condition m_loaded; ///< condition signaled when a step is loaded
+    std::vector<Prefetcher*> m_prefetchers; ///< prefetch threads
+
+public:
+
+    TimeSeriesVolume( Loader* loader );
+    ~TimeSeriesVolume();
+
+    size_t numberOfSteps() const { return m_nsteps; }
+    size_t cacheSize() const { return m_cache_size; }
+    size_t numberOfPrefetches() const { return m_nprefetches; }
+    size_t numberOfThreads() const { return m_nthreads; }
+    size_t numberOfLoads();
+    size_t numberOfStalls();
+    size_t numberOfCachedSteps();
+    size_t cachedBytes();
+
+    void setCacheSize( const size_t cache_size );
+    void setNumberOfPrefetches( const size_t nprefetches );
+    void setNumberOfThreads( const size_t nthreads );
+
+    const kvs::VolumeObjectBase* object( const size_t step );
+    void clearCache();
+
+private:
+
+    void start_prefetchers();
+    void stop_prefetchers();
+    void request_prefetches();
+    void evict();
+    void store( const size_t step, kvs::VolumeObjectBase* object );
+    bool prefetch();
+};
+
+} // end of namespace kvs
+
+#endif // KVS__TIME_SERIES_VOLUME_H_INCLUDE
@@ -113,6 +113,7 @@ UnstructuredVolumeImporter::UnstructuredVolumeImporter()
 /*===========================================================================*/
 UnstructuredVolumeImporter::UnstructuredVolumeImporter( const std::string& filename )
 {
+    BaseClass::setSuccess( true );
     if ( kvs::KVSMLObjectUnstructuredVolume::CheckExtension( filename ) )
     {
         kvs::KVSMLObjectUnstructuredVolume* file_format = new kvs::KVSMLObjectUnstructuredVolume( filename );
@@ -368,11 +369,20 @@ void UnstructuredVolumeImporter::import( const kvs::AVSField* field )
         vertex_index += line_size;
     }
 
+    // The coordinates kept in the data type are converted to float.
+    SuperClass::Coords coords = field->coords();
+    if ( coords.size() == 0 && field->nativeCoords().size() > 0 )
+    {
+        const kvs::AnyValueArray& native_coords = field->nativeCoords();
+        coords.allocate( native_coords.size() );
+        for ( size_t i = 0; i < coords.size(); i++ ) { coords[i] = native_coords[i].to<kvs::Real32>(); }
+    }
+
     SuperClass::setVeclen( field->veclen() );
     SuperClass::setNumberOfNodes( field->values().size() );
     SuperClass::setNumberOfCells( ncells.x() * ncells.y() * ncells.z() );
     SuperClass::setCellType( Hexahedra );
-    SuperClass::setCoords( field->coords() );
+    SuperClass::setCoords( coords );
     SuperClass::setConnections( connections );
     SuperClass::setValues( field->values() );
     SuperClass::updateMinMaxCoords();
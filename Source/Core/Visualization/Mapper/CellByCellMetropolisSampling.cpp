@@ -13,6 +13,7 @@
 /****************************************************************************/
 #include "CellByCellMetropolisSampling.h"
 #include <vector>
+#include <limits>
 #include <kvs/DebugNew>
 #include <kvs/Camera>
 #include <kvs/TrilinearInterpolator>
@@ -242,6 +243,56 @@ CellByCellMetropolisSampling::SuperClass* CellByCellMetropolisSampling::exec( co
     return this;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Updates the particles for the edited transfer function.
+ *  @param  transfer_function [in] edited transfer function
+ *  @return pointer to the point object
+ *
+ *  For the structured volume object, the particles are regenerated only in
+ *  the cells whose scalar range intersects the interval changed from the
+ *  current transfer function, and the other cells keep their particles. The
+ *  volume object given to exec() must be still alive, and the camera and the
+ *  sampling parameters should be the same as the ones used in exec(). The
+ *  unstructured volume object is mapped again as a whole.
+ */
+/*===========================================================================*/
+CellByCellMetropolisSampling::SuperClass* CellByCellMetropolisSampling::update( const kvs::TransferFunction& transfer_function )
+{
+    const kvs::VolumeObjectBase* volume = BaseClass::volume();
+    if ( !volume )
+    {
+        BaseClass::setSuccess( false );
+        kvsMessageError("Volume object is not attached.");
+        return NULL;
+    }
+
+    const kvs::TransferFunction previous( BaseClass::transferFunction() );
+    BaseClass::setTransferFunction( transfer_function );
+    BaseClass::setRange( volume );
+
+    float lower = 0.0f;
+    float upper = 0.0f;
+    if ( !BaseClass::transferFunction().changedRange( previous, &lower, &upper ) ) return this;
+
+    if ( volume->volumeType() != kvs::VolumeObjectBase::Structured ) return this->exec( volume );
+
+    // Calculate the density map for the edited opacity map.
+    const kvs::Camera* camera = m_camera ? m_camera : new kvs::Camera();
+    m_density_map = Generator::CalculateDensityMap(
+        camera,
+        volume,
+        static_cast<float>( m_subpixel_level ),
+        m_sampling_step,
+        BaseClass::transferFunction().opacityMap() );
+    if ( camera != m_camera ) delete camera;
+
+    // Regenerate the particles in the affected cells.
+    this->generate_particles( static_cast<const kvs::StructuredVolumeObject*>( volume ), kvs::Vec2( lower, upper ) );
+
+    return this;
+}
+
 /*===========================================================================*/
 /**
  *  @brief  Mapping for the structured volume object.
@@ -264,21 +315,10 @@ void CellByCellMetropolisSampling::mapping(const kvs::Camera* camera, const kvs:
         m_sampling_step,
         BaseClass::transferFunction().opacityMap() );
 
-    // Generate the particles.
-    const std::type_info& type = volume->values().typeInfo()->type();
-    if (      type == typeid( kvs::UInt8  ) ) this->generate_particles<kvs::UInt8>( volume );
-    else if ( type == typeid( kvs::UInt16 ) ) this->generate_particles<kvs::UInt16>( volume );
-    else if ( type == typeid( kvs::UInt32 ) ) this->generate_particles<kvs::UInt32>( volume );
-    else if ( type == typeid( kvs::Int8   ) ) this->generate_particles<kvs::Int8>( volume );
-    else if ( type == typeid( kvs::Int16  ) ) this->generate_particles<kvs::Int16>( volume );
-    else if ( type == typeid( kvs::Int32  ) ) this->generate_particles<kvs::Int32>( volume );
-    else if ( type == typeid( kvs::Real32 ) ) this->generate_particles<kvs::Real32>( volume );
-    else if ( type == typeid( kvs::Real64 ) ) this->generate_particles<kvs::Real64>( volume );
-    else
-    {
-        BaseClass::setSuccess( false );
-        kvsMessageError("Unsupported data type '%s'.", volume->values().typeInfo()->typeName() );
-    }
+    // Generate the particles in all of the cells.
+    m_cell_offsets.release();
+    const float max_value = std::numeric_limits<float>::max();
+    this->generate_particles( volume, kvs::Vec2( -max_value, max_value ) );
 }
 
 /*===========================================================================*/
@@ -311,16 +351,64 @@ void CellByCellMetropolisSampling::mapping( const kvs::Camera* camera, const kvs
 /**
  *  @brief  Generates particles for the structured volume object.
  *  @param  volume [in] pointer to the input volume object
+ *  @param  changed_range [in] scalar interval changed in the transfer function
+ */
+/*===========================================================================*/
+void CellByCellMetropolisSampling::generate_particles(
+    const kvs::StructuredVolumeObject* volume,
+    const kvs::Vec2& changed_range )
+{
+    const std::type_info& type = volume->values().typeInfo()->type();
+    if (      type == typeid( kvs::UInt8  ) ) this->generate_particles<kvs::UInt8>( volume, changed_range );
+    else if ( type == typeid( kvs::UInt16 ) ) this->generate_particles<kvs::UInt16>( volume, changed_range );
+    else if ( type == typeid( kvs::UInt32 ) ) this->generate_particles<kvs::UInt32>( volume, changed_range );
+    else if ( type == typeid( kvs::Int8   ) ) this->generate_particles<kvs::Int8>( volume, changed_range );
+    else if ( type == typeid( kvs::Int16  ) ) this->generate_particles<kvs::Int16>( volume, changed_range );
+    else if ( type == typeid( kvs::Int32  ) ) this->generate_particles<kvs::Int32>( volume, changed_range );
+    else if ( type == typeid( kvs::Real32 ) ) this->generate_particles<kvs::Real32>( volume, changed_range );
+    else if ( type == typeid( kvs::Real64 ) ) this->generate_particles<kvs::Real64>( volume, changed_range );
+    else
+    {
+        BaseClass::setSuccess( false );
+        kvsMessageError("Unsupported data type '%s'.", volume->values().typeInfo()->typeName() );
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Generates particles for the structured volume object.
+ *  @param  volume [in] pointer to the input volume object
+ *  @param  changed_range [in] scalar interval changed in the transfer function
+ *
+ *  The cells whose scalar range does not intersect the changed interval keep
+ *  the particles generated previously, if any.
  */
 /*===========================================================================*/
 template <typename T>
-void CellByCellMetropolisSampling::generate_particles( const kvs::StructuredVolumeObject* volume )
+void CellByCellMetropolisSampling::generate_particles(
+    const kvs::StructuredVolumeObject* volume,
+    const kvs::Vec2& changed_range )
 {
     // Vertex data arrays. (output)
     std::vector<kvs::Real32> vertex_coords;
     std::vector<kvs::UInt8>  vertex_colors;
     std::vector<kvs::Real32> vertex_normals;
 
+    // Previous particles, which are kept in the cells out of the changed range.
+    const kvs::Vector3ui ncells( volume->resolution() - kvs::Vector3ui::All(1) );
+    const size_t number_of_cells = ncells.x() * ncells.y() * ncells.z();
+    const kvs::ValueArray<kvs::Real32> previous_coords( SuperClass::coords() );
+    const kvs::ValueArray<kvs::UInt8> previous_colors( SuperClass::colors() );
+    const kvs::ValueArray<kvs::Real32> previous_normals( SuperClass::normals() );
+    const kvs::ValueArray<kvs::UInt32> previous_offsets( m_cell_offsets );
+    const bool reusable =
+        previous_offsets.size() == number_of_cells + 1 &&
+        previous_offsets[ number_of_cells ] * 3 == previous_coords.size() &&
+        previous_colors.size() == previous_coords.size() &&
+        previous_normals.size() == previous_coords.size();
+    if ( reusable && m_cell_min_values.size() != number_of_cells ) this->calculate_cell_ranges<T>( volume );
+    kvs::ValueArray<kvs::UInt32> cell_offsets( number_of_cells + 1 );
+
     // Set a trilinear interpolator.
     kvs::TrilinearInterpolator interpolator( volume );
 
@@ -334,13 +422,29 @@ void CellByCellMetropolisSampling::generate_particles( const kvs::StructuredVolu
     const kvs::ColorMap color_map( BaseClass::transferFunction().colorMap() );
 
     // Generate particles for each cell.
-    const kvs::Vector3ui ncells( volume->resolution() - kvs::Vector3ui::All(1) );
+    size_t cell_index = 0;
     for ( kvs::UInt32 z = 0; z < ncells.z(); ++z )
     {
         for ( kvs::UInt32 y = 0; y < ncells.y(); ++y )
         {
             for ( kvs::UInt32 x = 0; x < ncells.x(); ++x )
             {
+                const size_t index = cell_index++;
+                cell_offsets[ index ] = static_cast<kvs::UInt32>( vertex_coords.size() / 3 );
+
+                // Keep the previous particles if the cell is not affected.
+                if ( reusable &&
+                     ( m_cell_max_values[ index ] < changed_range[0] ||
+                       m_cell_min_values[ index ] > changed_range[1] ) )
+                {
+                    const size_t begin = previous_offsets[ index ] * 3;
+                    const size_t end = previous_offsets[ index + 1 ] * 3;
+                    vertex_coords.insert( vertex_coords.end(), previous_coords.data() + begin, previous_coords.data() + end );
+                    vertex_colors.insert( vertex_colors.end(), previous_colors.data() + begin, previous_colors.data() + end );
+                    vertex_normals.insert( vertex_normals.end(), previous_normals.data() + begin, previous_normals.data() + end );
+                    continue;
+                }
+
                 // Calculate a volume of cell.
                 const float volume_of_cell = 1.0f;
 
@@ -499,6 +603,8 @@ void CellByCellMetropolisSampling::generate_particles( const kvs::StructuredVolu
             } // end of 'x' loop
         } // end of 'y' loop
     } // end of 'z' loop
+    cell_offsets[ number_of_cells ] = static_cast<kvs::UInt32>( vertex_coords.size() / 3 );
+    m_cell_offsets = cell_offsets;
 
     SuperClass::setCoords( kvs::ValueArray<kvs::Real32>( vertex_coords ) );
     SuperClass::setColors( kvs::ValueArray<kvs::UInt8>( vertex_colors ) );
@@ -506,6 +612,62 @@ void CellByCellMetropolisSampling::generate_particles( const kvs::StructuredVolu
     SuperClass::setSize( 1.0f );
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Calculates the scalar range of each cell for the structured volume object.
+ *  @param  volume [in] pointer to the input volume object
+ *
+ *  Since the scalar value is trilinearly interpolated in the cell, the values
+ *  of the particles in the cell are in the range of the values at its eight
+ *  vertices.
+ */
+/*===========================================================================*/
+template <typename T>
+void CellByCellMetropolisSampling::calculate_cell_ranges( const kvs::StructuredVolumeObject* volume )
+{
+    const T* const values = static_cast<const T*>( volume->values().data() );
+    const kvs::Vector3ui resolution( volume->resolution() );
+    const kvs::Vector3ui ncells( resolution - kvs::Vector3ui::All(1) );
+    const size_t line_size = resolution.x();
+    const size_t slice_size = resolution.x() * resolution.y();
+
+    m_cell_min_values.allocate( ncells.x() * ncells.y() * ncells.z() );
+    m_cell_max_values.allocate( ncells.x() * ncells.y() * ncells.z() );
+
+    size_t cell_index = 0;
+    for ( kvs::UInt32 z = 0; z < ncells.z(); ++z )
+    {
+        for ( kvs::UInt32 y = 0; y < ncells.y(); ++y )
+        {
+            for ( kvs::UInt32 x = 0; x < ncells.x(); ++x, ++cell_index )
+            {
+                const size_t index0 = x + y * line_size + z * slice_size;
+                const size_t indices[8] = {
+                    index0,
+                    index0 + 1,
+                    index0 + line_size,
+                    index0 + line_size + 1,
+                    index0 + slice_size,
+                    index0 + slice_size + 1,
+                    index0 + slice_size + line_size,
+                    index0 + slice_size + line_size + 1 };
+
+                kvs::Real32 min_value = static_cast<kvs::Real32>( values[ indices[0] ] );
+                kvs::Real32 max_value = min_value;
+                for ( size_t i = 1; i < 8; i++ )
+                {
+                    const kvs::Real32 value = static_cast<kvs::Real32>( values[ indices[i] ] );
+                    min_value = kvs::Math::Min( min_value, value );
+                    max_value = kvs::Math::Max( max_value, value );
+                }
+
+                m_cell_min_values[ cell_index ] = min_value;
+                m_cell_max_values[ cell_index ] = max_value;
+            }
+        }
+    }
+}
+
 /*===========================================================================*/
 /**
  *  @brief  Generates particles for the unstructured volume object.
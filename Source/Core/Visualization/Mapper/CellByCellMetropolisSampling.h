@@ -21,6 +21,7 @@
 #include <kvs/VolumeObjectBase>
 #include <kvs/StructuredVolumeObject>
 #include <kvs/UnstructuredVolumeObject>
+#include <kvs/Vector2>
 #include <kvs/Module>
 #include "CellByCellParticleGenerator.h"
 
@@ -46,6 +47,9 @@ private:
     float m_sampling_step; ///< sampling step in the object coordinate
     float m_object_depth; ///< object depth
     kvs::ValueArray<float> m_density_map; ///< density map
+    kvs::ValueArray<kvs::UInt32> m_cell_offsets; ///< index of the first particle in each cell
+    kvs::ValueArray<kvs::Real32> m_cell_min_values; ///< min. scalar value in each cell
+    kvs::ValueArray<kvs::Real32> m_cell_max_values; ///< max. scalar value in each cell
 
 public:
 
@@ -66,6 +70,7 @@ public:
     virtual ~CellByCellMetropolisSampling();
 
     SuperClass* exec( const kvs::ObjectBase* object );
+    SuperClass* update( const kvs::TransferFunction& transfer_function );
 
     size_t subpixelLevel() const;
     float samplingStep() const;
@@ -80,7 +85,9 @@ private:
 
     void mapping( const kvs::Camera* camera, const kvs::StructuredVolumeObject* volume );
     void mapping( const kvs::Camera* camera, const kvs::UnstructuredVolumeObject* volume );
-    template <typename T> void generate_particles( const kvs::StructuredVolumeObject* volume );
+    void generate_particles( const kvs::StructuredVolumeObject* volume, const kvs::Vec2& changed_range );
+    template <typename T> void generate_particles( const kvs::StructuredVolumeObject* volume, const kvs::Vec2& changed_range );
+    template <typename T> void calculate_cell_ranges( const kvs::StructuredVolumeObject* volume );
     void generate_particles( const kvs::UnstructuredVolumeObject* volume );
 };
 
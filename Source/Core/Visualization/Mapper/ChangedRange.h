@@ -0,0 +1,57 @@
+/*****************************************************************************/
+/**
+ *  @file   ChangedRange.h
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#ifndef KVS__CHANGED_RANGE_H_INCLUDE
+#define KVS__CHANGED_RANGE_H_INCLUDE
+
+#include <cstddef>
+#include <limits>
+
+
+namespace
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Calculates the scalar interval affected by the changed entries.
+ *  @param  first [in] first changed entry
+ *  @param  last [in] last changed entry
+ *  @param  resolution [in] table resolution
+ *  @param  min_value [in] min. value
+ *  @param  max_value [in] max. value
+ *  @param  lower [out] lower bound of the interval
+ *  @param  upper [out] upper bound of the interval
+ *
+ *  The entries of the color map and the opacity map are placed in the same
+ *  way, so that both of the maps report the changed interval with this.
+ */
+/*===========================================================================*/
+inline void ChangedRange(
+    const size_t first,
+    const size_t last,
+    const size_t resolution,
+    const float min_value,
+    const float max_value,
+    float* lower,
+    float* upper )
+{
+    // The values between two entries are linearly interpolated, and the
+    // values outside the range are mapped to the end entries.
+    const float d = resolution > 1 ? ( max_value - min_value ) / ( resolution - 1 ) : 0.0f;
+    *lower = first == 0 ? -std::numeric_limits<float>::max() : min_value + ( first - 1 ) * d;
+    *upper = last + 1 >= resolution ? std::numeric_limits<float>::max() : min_value + ( last + 1 ) * d;
+}
+
+} // end of namespace
+
+#endif // KVS__CHANGED_RANGE_H_INCLUDE
@@ -84,6 +84,7 @@ public:
 
     const kvs::RGBColor operator []( const size_t index ) const;
     const kvs::RGBColor at( const float value ) const;
+    bool changedRange( const ColorMap& other, float* lower, float* upper ) const;
 
     ColorMap& operator =( const ColorMap& rhs );
 };
@@ -15,6 +15,7 @@
 #include "FrequencyTable.h"
 #include <kvs/Type>
 #include <kvs/Value>
+#include <kvs/ValueStatistics>
 
 
 namespace kvs
@@ -249,6 +250,7 @@ void FrequencyTable::calculate_range( const kvs::VolumeObjectBase* volume )
     {
         if ( kvs::Math::IsZero( m_min_range ) && kvs::Math::IsZero( m_max_range ) )
         {
+            if ( !volume->hasMinMaxValues() ) { volume->updateMinMaxValues(); }
             m_min_range = volume->minValue();
             m_max_range = volume->maxValue();
         }
@@ -293,15 +295,27 @@ void FrequencyTable::calculate_range( const kvs::ImageObject* image )
 /*==========================================================================*/
 void FrequencyTable::count_bin( const kvs::VolumeObjectBase* volume )
 {
-    const std::type_info& type = volume->values().typeInfo()->type();
-    if (      type == typeid( kvs::Int8 )   ) this->binning<kvs::Int8>( volume );
-    else if ( type == typeid( kvs::UInt8 )  ) this->binning<kvs::UInt8>( volume );
-    else if ( type == typeid( kvs::Int16 )  ) this->binning<kvs::Int16>( volume );
-    else if ( type == typeid( kvs::UInt16 ) ) this->binning<kvs::UInt16>( volume );
-    else if ( type == typeid( kvs::Int32 )  ) this->binning<kvs::Int32>( volume );
-    else if ( type == typeid( kvs::UInt32 ) ) this->binning<kvs::UInt32>( volume );
-    else if ( type == typeid( kvs::Real32 ) ) this->binning<kvs::Real32>( volume );
-    else if ( type == typeid( kvs::Real64 ) ) this->binning<kvs::Real64>( volume );
+    // The bin width is defined so that the max. range value falls into the
+    // last bin.
+    const kvs::Real64 width = ( m_max_range - m_min_range ) / kvs::Real64( m_nbins - 1 );
+
+    kvs::ValueStatistics statistics;
+    statistics.setNumberOfBins( static_cast<size_t>( m_nbins ) );
+    statistics.setRange( m_min_range, m_min_range + width * m_nbins );
+    statistics.setIgnoreValues( m_ignore_values );
+    if ( !statistics.calculate( volume->values(), volume->veclen() ) ) { return; }
+
+    m_bin = statistics.bin();
+    m_max_count = 0;
+    for ( size_t i = 0; i < m_nbins; i++ ) m_max_count = kvs::Math::Max( m_max_count, m_bin[i] );
+
+    m_mean = static_cast<kvs::Real64>( statistics.count() ) / m_nbins;
+
+    kvs::Real64 sum = 0;
+    for ( size_t i = 0; i < m_nbins; i++ ) sum += kvs::Math::Square( m_bin[i] - m_mean );
+    m_variance = sum / m_nbins;
+
+    m_standard_deviation = std::sqrt( m_variance );
 }
 
 /*==========================================================================*/
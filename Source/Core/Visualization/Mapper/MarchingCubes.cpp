@@ -352,7 +352,8 @@ void MarchingCubes::extract_surfaces_without_duplication(
 template <typename T>
 size_t MarchingCubes::calculate_table_index( const size_t* local_index ) const
 {
-    const T* const values = static_cast<const T*>( BaseClass::volume()->values().data() );
+    const kvs::StructuredVolumeObject::ValueAccessor<T> values(
+        reinterpret_cast<const kvs::StructuredVolumeObject*>( BaseClass::volume() ) );
     const double isolevel = m_isolevel;
 
     size_t table_index = 0;
@@ -381,9 +382,9 @@ const kvs::Vector3f MarchingCubes::interpolate_vertex(
     const kvs::Vector3f& vertex0,
     const kvs::Vector3f& vertex1 ) const
 {
-    const T* const values = static_cast<const T*>( BaseClass::volume()->values().data() );
     const kvs::StructuredVolumeObject* volume =
         reinterpret_cast<const kvs::StructuredVolumeObject*>( BaseClass::volume() );
+    const kvs::StructuredVolumeObject::ValueAccessor<T> values( volume );
 
     const double x0 = vertex0.x();
     const double y0 = vertex0.y();
@@ -442,9 +443,9 @@ void MarchingCubes::calculate_isopoints(
     kvs::UInt32*&             vertex_map,
     std::vector<kvs::Real32>& coords )
 {
-    const T* const values = static_cast<const T*>( BaseClass::volume()->values().data() );
     const kvs::StructuredVolumeObject* volume =
         reinterpret_cast<const kvs::StructuredVolumeObject*>( BaseClass::volume() );
+    const kvs::StructuredVolumeObject::ValueAccessor<T> values( volume );
 
     const kvs::Vector3ui resolution( volume->resolution() );
     const kvs::Vector3ui ncells( resolution - kvs::Vector3ui::All(1) );
@@ -13,6 +13,8 @@
  */
 /****************************************************************************/
 #include "OpacityMap.h"
+#include "ChangedRange.h"
+#include <limits>
 #include <kvs/Assert>
 #include <kvs/Math>
 
@@ -390,6 +392,51 @@ kvs::Real32 OpacityMap::at( const float value ) const
     return ( a1 - a0 ) * v + a0 * s1 - a1 * s0;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Returns the scalar interval where the opacity map differs from the other.
+ *  @param  other [in] opacity map to be compared (e.g. the previous one)
+ *  @param  lower [out] lower bound of the changed interval
+ *  @param  upper [out] upper bound of the changed interval
+ *  @return true if the opacity maps differ
+ *
+ *  The interval covers the scalar values whose interpolated opacities may be
+ *  changed, in the scalar range of the opacity map (or in [0, 1] if the range
+ *  is not specified). The interval is unbounded if the resolution or the
+ *  range differ, or if the end entries are changed.
+ */
+/*===========================================================================*/
+bool OpacityMap::changedRange( const OpacityMap& other, float* lower, float* upper ) const
+{
+    if ( m_resolution != other.m_resolution ||
+         m_table.size() != other.m_table.size() ||
+         !kvs::Math::Equal( m_min_value, other.m_min_value ) ||
+         !kvs::Math::Equal( m_max_value, other.m_max_value ) )
+    {
+        *lower = -std::numeric_limits<float>::max();
+        *upper = std::numeric_limits<float>::max();
+        return true;
+    }
+
+    const size_t nentries = m_table.size();
+    size_t first = nentries;
+    size_t last = 0;
+    for ( size_t i = 0; i < nentries; i++ )
+    {
+        if ( !kvs::Math::Equal( m_table[i], other.m_table[i] ) )
+        {
+            if ( first == nentries ) first = i;
+            last = i;
+        }
+    }
+    if ( first == nentries ) return false;
+
+    const float min_value = this->hasRange() ? m_min_value : 0.0f;
+    const float max_value = this->hasRange() ? m_max_value : 1.0f;
+    ::ChangedRange( first, last, nentries, min_value, max_value, lower, upper );
+    return true;
+}
+
 /*==========================================================================*/
 /**
  *  Substitution operator =.
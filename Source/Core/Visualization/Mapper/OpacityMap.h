@@ -70,6 +70,7 @@ public:
 
     kvs::Real32 operator []( const size_t index ) const;
     kvs::Real32 at( const float value ) const;
+    bool changedRange( const OpacityMap& other, float* lower, float* upper ) const;
     OpacityMap& operator =( const OpacityMap& rhs );
 };
 
@@ -17,6 +17,17 @@
 #include <kvs/MarchingTetrahedraTable>
 #include <kvs/MarchingHexahedraTable>
 #include <kvs/MarchingPyramidTable>
+#include <kvs/Thread>
+#include <kvs/SystemInformation>
+#include <algorithm>
+#include <cmath>
+
+
+namespace
+{
+const size_t DefaultLODNumberOfNodes = 64 * 64 * 64;
+const size_t MinCellsPerThread = 1 << 14;
+}
 
 namespace kvs
 {
@@ -28,7 +39,11 @@ namespace kvs
 /*==========================================================================*/
 SlicePlane::SlicePlane():
     kvs::MapperBase(),
-    kvs::PolygonObject()
+    kvs::PolygonObject(),
+    m_enable_lod( false ),
+    m_lod_nnodes( ::DefaultLODNumberOfNodes ),
+    m_nthreads( 0 ),
+    m_sliced_volume( NULL )
 {
 }
 
@@ -45,7 +60,11 @@ SlicePlane::SlicePlane(
     const kvs::Vector4f&         coefficients,
     const kvs::TransferFunction& transfer_function ):
     kvs::MapperBase( transfer_function ),
-    kvs::PolygonObject()
+    kvs::PolygonObject(),
+    m_enable_lod( false ),
+    m_lod_nnodes( ::DefaultLODNumberOfNodes ),
+    m_nthreads( 0 ),
+    m_sliced_volume( NULL )
 {
     this->setPlane( coefficients );
     this->exec( volume );
@@ -66,7 +85,11 @@ SlicePlane::SlicePlane(
     const kvs::Vector3f&         normal,
     const kvs::TransferFunction& transfer_function ):
     kvs::MapperBase( transfer_function ),
-    kvs::PolygonObject()
+    kvs::PolygonObject(),
+    m_enable_lod( false ),
+    m_lod_nnodes( ::DefaultLODNumberOfNodes ),
+    m_nthreads( 0 ),
+    m_sliced_volume( NULL )
 {
     this->setPlane( point, normal );
     this->exec( volume );
@@ -156,8 +179,18 @@ void SlicePlane::mapping( const kvs::VolumeObjectBase* volume )
 
     if ( volume->volumeType() == kvs::VolumeObjectBase::Structured )
     {
+        // Slice a coarse level of the volume pyramid instead of the volume
+        // with LOD control. The plane is transformed into the index space of
+        // the level, and the extracted plane is transformed back.
+        kvs::Vec3 scale( 1.0f, 1.0f, 1.0f );
+        const kvs::Vector4f coefficients( m_coefficients );
         const kvs::StructuredVolumeObject* structured_volume =
-            kvs::StructuredVolumeObject::DownCast( volume );
+            this->select_level( kvs::StructuredVolumeObject::DownCast( volume ), &scale );
+        m_coefficients.set(
+            coefficients.x() / scale.x(),
+            coefficients.y() / scale.y(),
+            coefficients.z() / scale.z(),
+            coefficients.w() );
 
         const std::type_info& type = structured_volume->values().typeInfo()->type();
         if (      type == typeid( kvs::Int8   ) ) this->extract_plane<kvs::Int8>( structured_volume );
@@ -175,6 +208,9 @@ void SlicePlane::mapping( const kvs::VolumeObjectBase* volume )
             BaseClass::setSuccess( false );
             kvsMessageError("Unsupported data type '%s'.", structured_volume->values().typeInfo()->typeName() );
         }
+
+        m_coefficients = coefficients;
+        if ( structured_volume != volume ) { this->scale_plane( scale ); }
     }
     else // volume->volumeType() == kvs::VolumeObjectBase::Unstructured
     {
@@ -200,178 +236,153 @@ void SlicePlane::mapping( const kvs::VolumeObjectBase* volume )
     }
 }
 
-/*==========================================================================*/
+/*===========================================================================*/
 /**
- *  @brief  Extract a slice plane for a structured volume.
+ *  @brief  Selects the level of the volume pyramid to be sliced.
  *  @param  volume [in] pointer to the structured volume object
+ *  @param  scale [out] index scale of the selected level
+ *  @return pointer to the selected level (the volume without LOD control)
  */
-/*==========================================================================*/
-template <typename T>
-void SlicePlane::extract_plane(
-    const kvs::StructuredVolumeObject* volume )
+/*===========================================================================*/
+const kvs::StructuredVolumeObject* SlicePlane::select_level(
+    const kvs::StructuredVolumeObject* volume,
+    kvs::Vec3* scale )
 {
-    // Calculated the coordinate data array and the normal vector array.
-    std::vector<kvs::Real32> coords;
-    std::vector<kvs::Real32> normals;
-    std::vector<kvs::UInt8>  colors;
+    if ( !m_enable_lod ) { return volume; }
+    if ( volume->numberOfNodes() <= m_lod_nnodes ) { return volume; }
+    if ( volume->gridType() != kvs::StructuredVolumeObject::Uniform ) { return volume; }
+    if ( volume->values().empty() ) { return volume; }
 
-    // Calculate min/max values of the node data.
-    if ( !volume->hasMinMaxValues() )
+    // The pyramid is built only once for the same volume.
+    if ( m_pyramid.sourceVolume() != volume )
     {
-        volume->updateMinMaxValues();
+        if ( !m_pyramid.build( volume ) ) { return volume; }
     }
 
-    // Calculate a normalize_factor.
-    const kvs::Real64 min_value( volume->minValue() );
-    const kvs::Real64 max_value( volume->maxValue() );
-    const kvs::Real64 normalize_factor( 255.0 / ( max_value - min_value ) );
+    const size_t level = m_pyramid.selectLevel( m_lod_nnodes );
+    *scale = m_pyramid.scale( level );
+    return m_pyramid.level( level );
+}
 
-    const kvs::Vector3ui ncells( volume->resolution() - kvs::Vector3ui::All(1) );
-    const kvs::UInt32    line_size( volume->numberOfNodesPerLine() );
-    const kvs::ColorMap& color_map( BaseClass::transferFunction().colorMap() );
+/*===========================================================================*/
+/**
+ *  @brief  Transforms the extracted plane from the index space of a level.
+ *  @param  scale [in] index scale of the level
+ */
+/*===========================================================================*/
+void SlicePlane::scale_plane( const kvs::Vec3& scale )
+{
+    kvs::ValueArray<kvs::Real32> coords = SuperClass::coords().clone();
+    for ( size_t i = 0; i < coords.size(); i += 3 )
+    {
+        coords[i]   /= scale.x();
+        coords[i+1] /= scale.y();
+        coords[i+2] /= scale.z();
+    }
 
-    // Extract surfaces.
-    size_t index = 0;
-    for ( kvs::UInt32 z = 0; z < ncells.z(); ++z )
+    kvs::ValueArray<kvs::Real32> normals = SuperClass::normals().clone();
+    for ( size_t i = 0; i < normals.size(); i += 3 )
     {
-        for ( kvs::UInt32 y = 0; y < ncells.y(); ++y )
-        {
-            for ( kvs::UInt32 x = 0; x < ncells.x(); ++x )
-            {
-                // Calculate the index of the reference table.
-                const size_t table_index = this->calculate_table_index( x, y, z );
-                if ( table_index == 0 ) continue;
-                if ( table_index == 255 ) continue;
-
-                // Calculate the triangle polygons.
-                for ( size_t i = 0; MarchingCubesTable::TriangleID[ table_index ][i] != -1; i += 3 )
-                {
-                    // Refer the edge IDs from the TriangleTable by using the table_index.
-                    const int e0 = MarchingCubesTable::TriangleID[table_index][i];
-                    const int e1 = MarchingCubesTable::TriangleID[table_index][i+2];
-                    const int e2 = MarchingCubesTable::TriangleID[table_index][i+1];
-
-                    // Determine vertices for each edge.
-                    const kvs::Vector3f v0(
-                        static_cast<float>( x + MarchingCubesTable::VertexID[e0][0][0] ),
-                        static_cast<float>( y + MarchingCubesTable::VertexID[e0][0][1] ),
-                        static_cast<float>( z + MarchingCubesTable::VertexID[e0][0][2] ) );
-
-                    const kvs::Vector3f v1(
-                        static_cast<float>( x + MarchingCubesTable::VertexID[e0][1][0] ),
-                        static_cast<float>( y + MarchingCubesTable::VertexID[e0][1][1] ),
-                        static_cast<float>( z + MarchingCubesTable::VertexID[e0][1][2] ) );
-
-                    const kvs::Vector3f v2(
-                        static_cast<float>( x + MarchingCubesTable::VertexID[e1][0][0] ),
-                        static_cast<float>( y + MarchingCubesTable::VertexID[e1][0][1] ),
-                        static_cast<float>( z + MarchingCubesTable::VertexID[e1][0][2] ) );
-
-                    const kvs::Vector3f v3(
-                        static_cast<float>( x + MarchingCubesTable::VertexID[e1][1][0] ),
-                        static_cast<float>( y + MarchingCubesTable::VertexID[e1][1][1] ),
-                        static_cast<float>( z + MarchingCubesTable::VertexID[e1][1][2] ) );
-
-                    const kvs::Vector3f v4(
-                        static_cast<float>( x + MarchingCubesTable::VertexID[e2][0][0] ),
-                        static_cast<float>( y + MarchingCubesTable::VertexID[e2][0][1] ),
-                        static_cast<float>( z + MarchingCubesTable::VertexID[e2][0][2] ) );
-
-                    const kvs::Vector3f v5(
-                        static_cast<float>( x + MarchingCubesTable::VertexID[e2][1][0] ),
-                        static_cast<float>( y + MarchingCubesTable::VertexID[e2][1][1] ),
-                        static_cast<float>( z + MarchingCubesTable::VertexID[e2][1][2] ) );
-
-                    // Calculate coordinates of the vertices which are composed
-                    // of the triangle polygon.
-                    const kvs::Vector3f vertex0( this->interpolate_vertex( v0, v1 ) );
-                    coords.push_back( vertex0.x() );
-                    coords.push_back( vertex0.y() );
-                    coords.push_back( vertex0.z() );
-
-                    const kvs::Vector3f vertex1( this->interpolate_vertex( v2, v3 ) );
-                    coords.push_back( vertex1.x() );
-                    coords.push_back( vertex1.y() );
-                    coords.push_back( vertex1.z() );
-
-                    const kvs::Vector3f vertex2( this->interpolate_vertex( v4, v5 ) );
-                    coords.push_back( vertex2.x() );
-                    coords.push_back( vertex2.y() );
-                    coords.push_back( vertex2.z() );
-
-                    const double value0 = this->interpolate_value<T>( volume, v0, v1 );
-                    const double value1 = this->interpolate_value<T>( volume, v2, v3 );
-                    const double value2 = this->interpolate_value<T>( volume, v4, v5 );
-
-                    const kvs::UInt8 color0 =
-                        static_cast<kvs::UInt8>( normalize_factor * ( value0 - min_value ) );
-                    colors.push_back( color_map[ color0 ].r() );
-                    colors.push_back( color_map[ color0 ].g() );
-                    colors.push_back( color_map[ color0 ].b() );
-
-                    const kvs::UInt8 color1 =
-                        static_cast<kvs::UInt8>( normalize_factor * ( value1 - min_value ) );
-                    colors.push_back( color_map[ color1 ].r() );
-                    colors.push_back( color_map[ color1 ].g() );
-                    colors.push_back( color_map[ color1 ].b() );
-
-                    const kvs::UInt8 color2 =
-                        static_cast<kvs::UInt8>( normalize_factor * ( value2 - min_value ) );
-                    colors.push_back( color_map[ color2 ].r() );
-                    colors.push_back( color_map[ color2 ].g() );
-                    colors.push_back( color_map[ color2 ].b() );
-
-                    // Calculate a normal vector for the triangle polygon.
-                    const kvs::Vector3f normal( -( vertex2 - vertex0 ).cross( vertex1 - vertex0 ) );
-                    normals.push_back( normal.x() );
-                    normals.push_back( normal.y() );
-                    normals.push_back( normal.z() );
-                } // end of loop-triangle
-            } // end of loop-x
-            ++index;
-        } // end of loop-y
-        index += line_size;
-    } // end of loop-z
-
-    SuperClass::setCoords( kvs::ValueArray<kvs::Real32>( coords ) );
-    SuperClass::setColors( kvs::ValueArray<kvs::UInt8>( colors ) );
-    SuperClass::setNormals( kvs::ValueArray<kvs::Real32>( normals ) );
-    SuperClass::setOpacity( 255 );
-    SuperClass::setPolygonType( kvs::PolygonObject::Triangle );
-    SuperClass::setColorType( kvs::PolygonObject::VertexColor );
-    SuperClass::setNormalType( kvs::PolygonObject::PolygonNormal );
+        normals[i]   *= scale.x();
+        normals[i+1] *= scale.y();
+        normals[i+2] *= scale.z();
+    }
+
+    SuperClass::setCoords( coords );
+    SuperClass::setNormals( normals );
 }
 
-/*==========================================================================*/
+/*===========================================================================*/
 /**
- *  @brief  Extract a slice plane for a unstructured volume.
- *  @param  volume [in] pointer to the unstructured volume object
+ *  @brief  Extractor class that extracts the plane from a range of cells.
  */
-/*==========================================================================*/
+/*===========================================================================*/
 template <typename T>
-void SlicePlane::extract_plane(
-    const kvs::UnstructuredVolumeObject* volume )
+class SlicePlane::Extractor : public kvs::Thread
 {
-    switch ( volume->cellType() )
+private:
+
+    const kvs::SlicePlane* m_mapper; ///< pointer to the mapper
+    const kvs::VolumeObjectBase* m_volume; ///< pointer to the volume object
+    const kvs::UInt32* m_cells; ///< candidate cells (NULL: all cells)
+    size_t m_begin; ///< first row (structured) or candidate cell (unstructured)
+    size_t m_end; ///< last row or candidate cell + 1
+    Polygons m_polygons; ///< extracted polygons
+
+public:
+
+    Extractor():
+        m_mapper( NULL ),
+        m_volume( NULL ),
+        m_cells( NULL ),
+        m_begin( 0 ),
+        m_end( 0 ) {}
+
+    void init(
+        const kvs::SlicePlane* mapper,
+        const kvs::VolumeObjectBase* volume,
+        const kvs::UInt32* cells,
+        const size_t begin,
+        const size_t end,
+        const kvs::Real64 min_value,
+        const kvs::Real64 normalize_factor )
     {
-        case kvs::UnstructuredVolumeObject::Tetrahedra:
-        {
-            this->extract_tetrahedra_plane<T>( volume );
-            break;
-        }
-        case kvs::UnstructuredVolumeObject::Hexahedra:
+        m_mapper = mapper;
+        m_volume = volume;
+        m_cells = cells;
+        m_begin = begin;
+        m_end = end;
+        m_polygons.min_value = min_value;
+        m_polygons.normalize_factor = normalize_factor;
+    }
+
+    const Polygons& polygons() const { return m_polygons; }
+
+    void run()
+    {
+        if ( m_volume->volumeType() == kvs::VolumeObjectBase::Structured )
         {
-            this->extract_hexahedra_plane<T>( volume );
-            break;
+            const kvs::StructuredVolumeObject* volume = kvs::StructuredVolumeObject::DownCast( m_volume );
+            m_mapper->template extract_cells<T>( volume, m_begin, m_end, &m_polygons );
         }
-        case kvs::UnstructuredVolumeObject::Pyramid:
+        else
         {
-            this->extract_pyramid_plane<T>( volume );
-            break;
+            const kvs::UnstructuredVolumeObject* volume = kvs::UnstructuredVolumeObject::DownCast( m_volume );
+            m_mapper->template extract_cells<T>( volume, m_cells, m_begin, m_end, &m_polygons );
         }
-        default: break;
     }
+};
+
+/*==========================================================================*/
+/**
+ *  @brief  Extract a slice plane for a structured volume.
+ *  @param  volume [in] pointer to the structured volume object
+ */
+/*==========================================================================*/
+template <typename T>
+void SlicePlane::extract_plane(
+    const kvs::StructuredVolumeObject* volume )
+{
+    // Calculate min/max values of the node data.
+    if ( !volume->hasMinMaxValues() )
+    {
+        volume->updateMinMaxValues();
+    }
+
+    // The cells are visited along the plane. The footprint of the plane is
+    // scanned over the rows of the cell columns that run along the axis
+    // closest to the plane normal, and only the cells of each column that
+    // the plane can cross are visited. The rows are extracted in parallel
+    // except for the bricked volume, whose brick cache is not thread-safe.
+    const size_t axis = this->traversal_axis();
+    const kvs::Vector3ui ncells( volume->resolution() - kvs::Vector3ui::All(1) );
+    const size_t nrows = ncells[ ( axis + 2 ) % 3 ];
+    const size_t ncolumns = nrows * ncells[ ( axis + 1 ) % 3 ];
+    const size_t nthreads = volume->isBricked() ? 1 : this->number_of_threads( ncolumns, nrows );
+
+    this->extract<T>( volume, NULL, nrows, nthreads );
 }
+
 /*==========================================================================*/
 /**
  *  @brief  Extract a slice plane for a unstructured volume.
@@ -379,13 +390,17 @@ void SlicePlane::extract_plane(
  */
 /*==========================================================================*/
 template <typename T>
-void SlicePlane::extract_tetrahedra_plane(
+void SlicePlane::extract_plane(
     const kvs::UnstructuredVolumeObject* volume )
 {
-    // Calculated the coordinate data array and the normal vector array.
-    std::vector<kvs::Real32> coords;
-    std::vector<kvs::Real32> normals;
-    std::vector<kvs::UInt8>  colors;
+    switch ( volume->cellType() )
+    {
+    case kvs::UnstructuredVolumeObject::Tetrahedra:
+    case kvs::UnstructuredVolumeObject::Hexahedra:
+    case kvs::UnstructuredVolumeObject::Pyramid:
+        break;
+    default: return;
+    }
 
     // Calculate min/max values of the node data.
     if ( !volume->hasMinMaxValues() )
@@ -393,381 +408,603 @@ void SlicePlane::extract_tetrahedra_plane(
         volume->updateMinMaxValues();
     }
 
+    // Only the cells in the leaves of the cell tree that the plane crosses
+    // are visited if the cell tree is available. Otherwise all of the cells
+    // are visited.
+    std::vector<kvs::UInt32> cells;
+    const bool has_cell_tree = this->update_cell_tree( volume );
+    if ( has_cell_tree ) { this->collect_cells( &cells ); }
+
+    const size_t ncandidates = has_cell_tree ? cells.size() : volume->numberOfCells();
+    const kvs::UInt32* candidates = has_cell_tree && !cells.empty() ? &cells[0] : NULL;
+    const size_t nthreads = this->number_of_threads( ncandidates, ncandidates );
+
+    this->extract<T>( volume, candidates, ncandidates, nthreads );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Extracts the plane with the threads and merges the polygons.
+ *  @param  volume [in] pointer to the volume object
+ *  @param  cells [in] candidate cells (NULL: all cells)
+ *  @param  n [in] number of rows (structured) or candidate cells (unstructured)
+ *  @param  nthreads [in] number of threads
+ */
+/*===========================================================================*/
+template <typename T>
+void SlicePlane::extract(
+    const kvs::VolumeObjectBase* volume,
+    const kvs::UInt32* cells,
+    const size_t n,
+    const size_t nthreads )
+{
     // Calculate a normalize factor.
     const kvs::Real64 min_value( volume->minValue() );
     const kvs::Real64 max_value( volume->maxValue() );
     const kvs::Real64 normalize_factor( 255.0 / ( max_value - min_value ) );
 
-    // Refer the parameters of the unstructured volume object.
-    const kvs::Real32* volume_coords      = volume->coords().data();
-    const kvs::UInt32* volume_connections = volume->connections().data();
-    const size_t       ncells             = volume->numberOfCells();
-
-    const kvs::ColorMap& color_map( BaseClass::transferFunction().colorMap() );
-
-    // Extract surfaces.
-    size_t index = 0;
-    size_t local_index[4];
-    for ( kvs::UInt32 cell = 0; cell < ncells; ++cell, index += 4 )
+    // The first block is extracted by the calling thread.
+    std::vector< Extractor<T> > extractors( nthreads );
+    for ( size_t i = 0; i < nthreads; i++ )
     {
-        // Calculate the indices of the target cell.
-        local_index[0] = volume_connections[ index ];
-        local_index[1] = volume_connections[ index + 1 ];
-        local_index[2] = volume_connections[ index + 2 ];
-        local_index[3] = volume_connections[ index + 3 ];
-
-        // Calculate the index of the reference table.
-        const size_t table_index = this->calculate_tetrahedra_table_index( local_index );
-        if ( table_index == 0 ) continue;
-        if ( table_index == 15 ) continue;
-
-        // Calculate the triangle polygons.
-        for ( size_t i = 0; MarchingTetrahedraTable::TriangleID[ table_index ][i] != -1; i += 3 )
-        {
-            // Refer the edge IDs from the TriangleTable using the table_index.
-            const int e0 = MarchingTetrahedraTable::TriangleID[table_index][i];
-            const int e1 = MarchingTetrahedraTable::TriangleID[table_index][i+1];
-            const int e2 = MarchingTetrahedraTable::TriangleID[table_index][i+2];
-
-            // Refer indices of the coordinate array from the VertexTable using the edgeIDs.
-            const size_t c0 = local_index[ MarchingTetrahedraTable::VertexID[e0][0] ];
-            const size_t c1 = local_index[ MarchingTetrahedraTable::VertexID[e0][1] ];
-            const size_t c2 = local_index[ MarchingTetrahedraTable::VertexID[e1][0] ];
-            const size_t c3 = local_index[ MarchingTetrahedraTable::VertexID[e1][1] ];
-            const size_t c4 = local_index[ MarchingTetrahedraTable::VertexID[e2][0] ];
-            const size_t c5 = local_index[ MarchingTetrahedraTable::VertexID[e2][1] ];
-
-            // Determine vertices for each edge.
-            const kvs::Vector3f v0( volume_coords + 3 * c0 );
-            const kvs::Vector3f v1( volume_coords + 3 * c1 );
-
-            const kvs::Vector3f v2( volume_coords + 3 * c2 );
-            const kvs::Vector3f v3( volume_coords + 3 * c3 );
-
-            const kvs::Vector3f v4( volume_coords + 3 * c4 );
-            const kvs::Vector3f v5( volume_coords + 3 * c5 );
-
-            // Calculate coordinates of the vertices which are composed
-            // of the triangle polygon.
-            const kvs::Vector3f vertex0( this->interpolate_vertex( v0, v1 ) );
-            coords.push_back( vertex0.x() );
-            coords.push_back( vertex0.y() );
-            coords.push_back( vertex0.z() );
-
-            const kvs::Vector3f vertex1( this->interpolate_vertex( v2, v3 ) );
-            coords.push_back( vertex1.x() );
-            coords.push_back( vertex1.y() );
-            coords.push_back( vertex1.z() );
-
-            const kvs::Vector3f vertex2( this->interpolate_vertex( v4, v5 ) );
-            coords.push_back( vertex2.x() );
-            coords.push_back( vertex2.y() );
-            coords.push_back( vertex2.z() );
-
-            const double value0 = this->interpolate_value<T>( volume, c0, c1 );
-            const double value1 = this->interpolate_value<T>( volume, c2, c3 );
-            const double value2 = this->interpolate_value<T>( volume, c4, c5 );
-
-            const kvs::UInt8 color0 =
-                static_cast<kvs::UInt8>( normalize_factor * ( value0 - min_value ) );
-            colors.push_back( color_map[ color0 ].r() );
-            colors.push_back( color_map[ color0 ].g() );
-            colors.push_back( color_map[ color0 ].b() );
-
-            const kvs::UInt8 color1 =
-                static_cast<kvs::UInt8>( normalize_factor * ( value1 - min_value ) );
-            colors.push_back( color_map[ color1 ].r() );
-            colors.push_back( color_map[ color1 ].g() );
-            colors.push_back( color_map[ color1 ].b() );
-
-            const kvs::UInt8 color2 =
-                static_cast<kvs::UInt8>( normalize_factor * ( value2 - min_value ) );
-            colors.push_back( color_map[ color2 ].r() );
-            colors.push_back( color_map[ color2 ].g() );
-            colors.push_back( color_map[ color2 ].b() );
-
-            // Calculate a normal vector for the triangle polygon.
-            const kvs::Vector3f normal( -( vertex2 - vertex0 ).cross( vertex1 - vertex0 ) );
-            normals.push_back( normal.x() );
-            normals.push_back( normal.y() );
-            normals.push_back( normal.z() );
-        } // end of loop-triangle
-    } // end of loop-cell
-
-    SuperClass::setCoords( kvs::ValueArray<kvs::Real32>( coords ) );
-    SuperClass::setColors( kvs::ValueArray<kvs::UInt8>( colors ) );
-    SuperClass::setNormals( kvs::ValueArray<kvs::Real32>( normals ) );
+        const size_t begin = n * i / nthreads;
+        const size_t end = n * ( i + 1 ) / nthreads;
+        extractors[i].init( this, volume, cells, begin, end, min_value, normalize_factor );
+    }
+    for ( size_t i = 1; i < nthreads; i++ ) { if ( !extractors[i].start() ) { extractors[i].run(); } }
+    extractors[0].run();
+    for ( size_t i = 1; i < nthreads; i++ ) { if ( extractors[i].isRunning() ) { extractors[i].wait(); } }
+
+    // Merge the polygons in the order of the blocks.
+    size_t ncoords = 0;
+    for ( size_t i = 0; i < nthreads; i++ ) { ncoords += extractors[i].polygons().coords.size(); }
+
+    kvs::ValueArray<kvs::Real32> coords( ncoords );
+    kvs::ValueArray<kvs::UInt8> colors( ncoords );
+    kvs::ValueArray<kvs::Real32> normals( ncoords / 3 );
+    size_t offset = 0;
+    for ( size_t i = 0; i < nthreads; i++ )
+    {
+        const Polygons& polygons = extractors[i].polygons();
+        const size_t size = polygons.coords.size();
+        if ( size == 0 ) { continue; }
+        std::copy( polygons.coords.begin(), polygons.coords.end(), coords.begin() + offset );
+        std::copy( polygons.colors.begin(), polygons.colors.end(), colors.begin() + offset );
+        std::copy( polygons.normals.begin(), polygons.normals.end(), normals.begin() + offset / 3 );
+        offset += size;
+    }
+
+    SuperClass::setCoords( coords );
+    SuperClass::setColors( colors );
+    SuperClass::setNormals( normals );
     SuperClass::setOpacity( 255 );
     SuperClass::setPolygonType( kvs::PolygonObject::Triangle );
     SuperClass::setColorType( kvs::PolygonObject::VertexColor );
     SuperClass::setNormalType( kvs::PolygonObject::PolygonNormal );
 }
 
-/*==========================================================================*/
+/*===========================================================================*/
 /**
- *  @brief  Extract a slice plane for a unstructured volume.
- *  @param  volume [in] pointer to the unstructured volume object
+ *  @brief  Extracts the plane from the cells on the specified rows of the footprint.
+ *  @param  volume [in] pointer to the structured volume object
+ *  @param  begin [in] first row
+ *  @param  end [in] last row + 1
+ *  @param  polygons [out] extracted polygons
  */
-/*==========================================================================*/
+/*===========================================================================*/
 template <typename T>
-void SlicePlane::extract_hexahedra_plane(
-    const kvs::UnstructuredVolumeObject* volume )
+void SlicePlane::extract_cells(
+    const kvs::StructuredVolumeObject* volume,
+    const size_t begin,
+    const size_t end,
+    Polygons* polygons ) const
 {
-    // Calculated the coordinate data array and the normal vector array.
-    std::vector<kvs::Real32> coords;
-    std::vector<kvs::Real32> normals;
-    std::vector<kvs::UInt8>  colors;
+    const kvs::Vector3ui ncells( volume->resolution() - kvs::Vector3ui::All(1) );
+    const size_t d = this->traversal_axis(); // column axis
+    const size_t a = ( d + 1 ) % 3; // axis along a row
+    const size_t b = ( d + 2 ) % 3; // axis across the rows
+    const double nd = m_coefficients[d];
+    const double na = m_coefficients[a];
+    const double nb = m_coefficients[b];
+    const double w = m_coefficients.w();
+    if ( kvs::Math::IsZero( nd ) ) { return; }
+
+    const double last = static_cast<double>( ncells[d] ) - 1.0;
+    kvs::UInt32 cell[3];
+    for ( size_t j = begin; j < end; j++ )
+    {
+        cell[b] = static_cast<kvs::UInt32>( j );
+        for ( kvs::UInt32 i = 0; i < ncells[a]; i++ )
+        {
+            cell[a] = i;
 
-    // Calculate min/max values of the node data.
-    if ( !volume->hasMinMaxValues() )
+            // Range of the plane along the column axis over the cell column.
+            double tmin = 0.0;
+            double tmax = 0.0;
+            for ( size_t c = 0; c < 4; c++ )
+            {
+                const double u = static_cast<double>( i + ( c & 1 ) );
+                const double v = static_cast<double>( j + ( c >> 1 ) );
+                const double t = -( na * u + nb * v + w ) / nd;
+                tmin = c == 0 ? t : kvs::Math::Min( tmin, t );
+                tmax = c == 0 ? t : kvs::Math::Max( tmax, t );
+            }
+
+            // Visit the cells touching the range with a margin of a cell.
+            tmin = std::floor( tmin ) - 1.0;
+            tmax = std::floor( tmax ) + 1.0;
+            if ( tmax < 0.0 || tmin > last ) { continue; }
+            const kvs::UInt32 kmin = static_cast<kvs::UInt32>( kvs::Math::Max( tmin, 0.0 ) );
+            const kvs::UInt32 kmax = static_cast<kvs::UInt32>( kvs::Math::Min( tmax, last ) );
+            for ( kvs::UInt32 k = kmin; k <= kmax; k++ )
+            {
+                cell[d] = k;
+                this->extract_cell<T>( volume, cell[0], cell[1], cell[2], polygons );
+            }
+        }
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Extracts the plane from the specified cells.
+ *  @param  volume [in] pointer to the unstructured volume object
+ *  @param  cells [in] candidate cells (NULL: all cells)
+ *  @param  begin [in] first candidate cell
+ *  @param  end [in] last candidate cell + 1
+ *  @param  polygons [out] extracted polygons
+ */
+/*===========================================================================*/
+template <typename T>
+void SlicePlane::extract_cells(
+    const kvs::UnstructuredVolumeObject* volume,
+    const kvs::UInt32* cells,
+    const size_t begin,
+    const size_t end,
+    Polygons* polygons ) const
+{
+    for ( size_t i = begin; i < end; i++ )
     {
-        volume->updateMinMaxValues();
+        const size_t cell = cells ? cells[i] : i;
+        switch ( volume->cellType() )
+        {
+        case kvs::UnstructuredVolumeObject::Tetrahedra: this->extract_tetrahedra_plane<T>( volume, cell, polygons ); break;
+        case kvs::UnstructuredVolumeObject::Hexahedra: this->extract_hexahedra_plane<T>( volume, cell, polygons ); break;
+        case kvs::UnstructuredVolumeObject::Pyramid: this->extract_pyramid_plane<T>( volume, cell, polygons ); break;
+        default: break;
+        }
     }
+}
 
-    // Calculate a normalize factor.
-    const kvs::Real64 min_value( volume->minValue() );
-    const kvs::Real64 max_value( volume->maxValue() );
-    const kvs::Real64 normalize_factor( 255.0 / ( max_value - min_value ) );
+/*===========================================================================*/
+/**
+ *  @brief  Extracts the plane from a cell of a structured volume.
+ *  @param  volume [in] pointer to the structured volume object
+ *  @param  x [in] cell index along the x-axis
+ *  @param  y [in] cell index along the y-axis
+ *  @param  z [in] cell index along the z-axis
+ *  @param  polygons [out] extracted polygons
+ */
+/*===========================================================================*/
+template <typename T>
+void SlicePlane::extract_cell(
+    const kvs::StructuredVolumeObject* volume,
+    const kvs::UInt32 x,
+    const kvs::UInt32 y,
+    const kvs::UInt32 z,
+    Polygons* polygons ) const
+{
+    // Calculate the index of the reference table.
+    const size_t table_index = this->calculate_table_index( x, y, z );
+    if ( table_index == 0 ) return;
+    if ( table_index == 255 ) return;
 
-    // Refer the parameters of the unstructured volume object.
-    const kvs::Real32* volume_coords      = volume->coords().data();
-    const kvs::UInt32* volume_connections = volume->connections().data();
-    const size_t       ncells             = volume->numberOfCells();
+    // Calculate the triangle polygons.
+    for ( size_t i = 0; MarchingCubesTable::TriangleID[ table_index ][i] != -1; i += 3 )
+    {
+        // Refer the edge IDs from the TriangleTable by using the table_index.
+        const int e0 = MarchingCubesTable::TriangleID[table_index][i];
+        const int e1 = MarchingCubesTable::TriangleID[table_index][i+2];
+        const int e2 = MarchingCubesTable::TriangleID[table_index][i+1];
+
+        // Determine vertices for each edge.
+        const kvs::Vector3f v0(
+            static_cast<float>( x + MarchingCubesTable::VertexID[e0][0][0] ),
+            static_cast<float>( y + MarchingCubesTable::VertexID[e0][0][1] ),
+            static_cast<float>( z + MarchingCubesTable::VertexID[e0][0][2] ) );
+
+        const kvs::Vector3f v1(
+            static_cast<float>( x + MarchingCubesTable::VertexID[e0][1][0] ),
+            static_cast<float>( y + MarchingCubesTable::VertexID[e0][1][1] ),
+            static_cast<float>( z + MarchingCubesTable::VertexID[e0][1][2] ) );
+
+        const kvs::Vector3f v2(
+            static_cast<float>( x + MarchingCubesTable::VertexID[e1][0][0] ),
+            static_cast<float>( y + MarchingCubesTable::VertexID[e1][0][1] ),
+            static_cast<float>( z + MarchingCubesTable::VertexID[e1][0][2] ) );
+
+        const kvs::Vector3f v3(
+            static_cast<float>( x + MarchingCubesTable::VertexID[e1][1][0] ),
+            static_cast<float>( y + MarchingCubesTable::VertexID[e1][1][1] ),
+            static_cast<float>( z + MarchingCubesTable::VertexID[e1][1][2] ) );
+
+        const kvs::Vector3f v4(
+            static_cast<float>( x + MarchingCubesTable::VertexID[e2][0][0] ),
+            static_cast<float>( y + MarchingCubesTable::VertexID[e2][0][1] ),
+            static_cast<float>( z + MarchingCubesTable::VertexID[e2][0][2] ) );
+
+        const kvs::Vector3f v5(
+            static_cast<float>( x + MarchingCubesTable::VertexID[e2][1][0] ),
+            static_cast<float>( y + MarchingCubesTable::VertexID[e2][1][1] ),
+            static_cast<float>( z + MarchingCubesTable::VertexID[e2][1][2] ) );
+
+        // Calculate coordinates of the vertices which are composed
+        // of the triangle polygon.
+        const kvs::Vector3f vertices[3] = {
+            this->interpolate_vertex( v0, v1 ),
+            this->interpolate_vertex( v2, v3 ),
+            this->interpolate_vertex( v4, v5 ) };
+
+        const double values[3] = {
+            this->interpolate_value<T>( volume, v0, v1 ),
+            this->interpolate_value<T>( volume, v2, v3 ),
+            this->interpolate_value<T>( volume, v4, v5 ) };
+
+        this->append_triangle( vertices, values, polygons );
+    } // end of loop-triangle
+}
 
-    const kvs::ColorMap& color_map( BaseClass::transferFunction().colorMap() );
+/*==========================================================================*/
+/**
+ *  @brief  Extract a slice plane from a tetrahedral cell.
+ *  @param  volume [in] pointer to the unstructured volume object
+ *  @param  cell [in] cell index
+ *  @param  polygons [out] extracted polygons
+ */
+/*==========================================================================*/
+template <typename T>
+void SlicePlane::extract_tetrahedra_plane(
+    const kvs::UnstructuredVolumeObject* volume,
+    const size_t cell,
+    Polygons* polygons ) const
+{
+    // Calculate the indices of the target cell.
+    const kvs::UInt32* connections = volume->connections().data() + 4 * cell;
+    size_t local_index[4];
+    local_index[0] = connections[0];
+    local_index[1] = connections[1];
+    local_index[2] = connections[2];
+    local_index[3] = connections[3];
+
+    // Calculate the index of the reference table.
+    const size_t table_index = this->calculate_tetrahedra_table_index( local_index );
+    if ( table_index == 0 ) return;
+    if ( table_index == 15 ) return;
+
+    // Calculate the triangle polygons.
+    for ( size_t i = 0; MarchingTetrahedraTable::TriangleID[ table_index ][i] != -1; i += 3 )
+    {
+        // Refer the edge IDs from the TriangleTable using the table_index.
+        const int e0 = MarchingTetrahedraTable::TriangleID[table_index][i];
+        const int e1 = MarchingTetrahedraTable::TriangleID[table_index][i+1];
+        const int e2 = MarchingTetrahedraTable::TriangleID[table_index][i+2];
+
+        // Refer indices of the coordinate array from the VertexTable using the edgeIDs.
+        const size_t c[6] = {
+            local_index[ MarchingTetrahedraTable::VertexID[e0][0] ],
+            local_index[ MarchingTetrahedraTable::VertexID[e0][1] ],
+            local_index[ MarchingTetrahedraTable::VertexID[e1][0] ],
+            local_index[ MarchingTetrahedraTable::VertexID[e1][1] ],
+            local_index[ MarchingTetrahedraTable::VertexID[e2][0] ],
+            local_index[ MarchingTetrahedraTable::VertexID[e2][1] ] };
+
+        this->append_triangle<T>( volume, c, polygons );
+    } // end of loop-triangle
+}
 
-    // Extract surfaces.
-    size_t index = 0;
+/*==========================================================================*/
+/**
+ *  @brief  Extract a slice plane from a hexahedral cell.
+ *  @param  volume [in] pointer to the unstructured volume object
+ *  @param  cell [in] cell index
+ *  @param  polygons [out] extracted polygons
+ */
+/*==========================================================================*/
+template <typename T>
+void SlicePlane::extract_hexahedra_plane(
+    const kvs::UnstructuredVolumeObject* volume,
+    const size_t cell,
+    Polygons* polygons ) const
+{
+    // Calculate the indices of the target cell.
+    const kvs::UInt32* connections = volume->connections().data() + 8 * cell;
     size_t local_index[8];
-    for ( kvs::UInt32 cell = 0; cell < ncells; ++cell, index += 8 )
+    local_index[4] = connections[0];
+    local_index[5] = connections[1];
+    local_index[6] = connections[2];
+    local_index[7] = connections[3];
+    local_index[0] = connections[4];
+    local_index[1] = connections[5];
+    local_index[2] = connections[6];
+    local_index[3] = connections[7];
+
+    // Calculate the index of the reference table.
+    const size_t table_index = this->calculate_hexahedra_table_index( local_index );
+    if ( table_index == 0 ) return;
+    if ( table_index == 255 ) return;
+
+    // Calculate the triangle polygons.
+    for ( size_t i = 0; MarchingHexahedraTable::TriangleID[ table_index ][i] != -1; i += 3 )
     {
-        // Calculate the indices of the target cell.
-        local_index[4] = volume_connections[ index ];
-        local_index[5] = volume_connections[ index + 1 ];
-        local_index[6] = volume_connections[ index + 2 ];
-        local_index[7] = volume_connections[ index + 3 ];
-        local_index[0] = volume_connections[ index + 4 ];
-        local_index[1] = volume_connections[ index + 5 ];
-        local_index[2] = volume_connections[ index + 6 ];
-        local_index[3] = volume_connections[ index + 7 ];
-
-        // Calculate the index of the reference table.
-        const size_t table_index = this->calculate_hexahedra_table_index( local_index );
-        if ( table_index == 0 ) continue;
-        if ( table_index == 255 ) continue;
-
-        // Calculate the triangle polygons.
-        for ( size_t i = 0; MarchingHexahedraTable::TriangleID[ table_index ][i] != -1; i += 3 )
-        {
-            // Refer the edge IDs from the TriangleTable using the table_index.
-            const int e0 = MarchingHexahedraTable::TriangleID[table_index][i];
-            const int e1 = MarchingHexahedraTable::TriangleID[table_index][i+1];
-            const int e2 = MarchingHexahedraTable::TriangleID[table_index][i+2];
-
-            // Refer indices of the coordinate array from the VertexTable using the edgeIDs.
-            const size_t c0 = local_index[ MarchingHexahedraTable::VertexID[e0][0] ];
-            const size_t c1 = local_index[ MarchingHexahedraTable::VertexID[e0][1] ];
-            const size_t c2 = local_index[ MarchingHexahedraTable::VertexID[e1][0] ];
-            const size_t c3 = local_index[ MarchingHexahedraTable::VertexID[e1][1] ];
-            const size_t c4 = local_index[ MarchingHexahedraTable::VertexID[e2][0] ];
-            const size_t c5 = local_index[ MarchingHexahedraTable::VertexID[e2][1] ];
-
-            // Determine vertices for each edge.
-            const kvs::Vector3f v0( volume_coords + 3 * c0 );
-            const kvs::Vector3f v1( volume_coords + 3 * c1 );
-
-            const kvs::Vector3f v2( volume_coords + 3 * c2 );
-            const kvs::Vector3f v3( volume_coords + 3 * c3 );
-
-            const kvs::Vector3f v4( volume_coords + 3 * c4 );
-            const kvs::Vector3f v5( volume_coords + 3 * c5 );
-
-            // Calculate coordinates of the vertices which are composed
-            // of the triangle polygon.
-            const kvs::Vector3f vertex0( this->interpolate_vertex( v0, v1 ) );
-            coords.push_back( vertex0.x() );
-            coords.push_back( vertex0.y() );
-            coords.push_back( vertex0.z() );
-
-            const kvs::Vector3f vertex1( this->interpolate_vertex( v2, v3 ) );
-            coords.push_back( vertex1.x() );
-            coords.push_back( vertex1.y() );
-            coords.push_back( vertex1.z() );
-
-            const kvs::Vector3f vertex2( this->interpolate_vertex( v4, v5 ) );
-            coords.push_back( vertex2.x() );
-            coords.push_back( vertex2.y() );
-            coords.push_back( vertex2.z() );
-
-            const double value0 = this->interpolate_value<T>( volume, c0, c1 );
-            const double value1 = this->interpolate_value<T>( volume, c2, c3 );
-            const double value2 = this->interpolate_value<T>( volume, c4, c5 );
-
-            const kvs::UInt8 color0 =
-                static_cast<kvs::UInt8>( normalize_factor * ( value0 - min_value ) );
-            colors.push_back( color_map[ color0 ].r() );
-            colors.push_back( color_map[ color0 ].g() );
-            colors.push_back( color_map[ color0 ].b() );
-
-            const kvs::UInt8 color1 =
-                static_cast<kvs::UInt8>( normalize_factor * ( value1 - min_value ) );
-            colors.push_back( color_map[ color1 ].r() );
-            colors.push_back( color_map[ color1 ].g() );
-            colors.push_back( color_map[ color1 ].b() );
-
-            const kvs::UInt8 color2 =
-                static_cast<kvs::UInt8>( normalize_factor * ( value2 - min_value ) );
-            colors.push_back( color_map[ color2 ].r() );
-            colors.push_back( color_map[ color2 ].g() );
-            colors.push_back( color_map[ color2 ].b() );
-
-            // Calculate a normal vector for the triangle polygon.
-            const kvs::Vector3f normal( -( vertex2 - vertex0 ).cross( vertex1 - vertex0 ) );
-            normals.push_back( normal.x() );
-            normals.push_back( normal.y() );
-            normals.push_back( normal.z() );
-        } // end of loop-triangle
-    } // end of loop-cell
-
-    SuperClass::setCoords( kvs::ValueArray<kvs::Real32>( coords ) );
-    SuperClass::setColors( kvs::ValueArray<kvs::UInt8>( colors ) );
-    SuperClass::setNormals( kvs::ValueArray<kvs::Real32>( normals ) );
-    SuperClass::setOpacity( 255 );
-    SuperClass::setPolygonType( kvs::PolygonObject::Triangle );
-    SuperClass::setColorType( kvs::PolygonObject::VertexColor );
-    SuperClass::setNormalType( kvs::PolygonObject::PolygonNormal );
+        // Refer the edge IDs from the TriangleTable using the table_index.
+        const int e0 = MarchingHexahedraTable::TriangleID[table_index][i];
+        const int e1 = MarchingHexahedraTable::TriangleID[table_index][i+1];
+        const int e2 = MarchingHexahedraTable::TriangleID[table_index][i+2];
+
+        // Refer indices of the coordinate array from the VertexTable using the edgeIDs.
+        const size_t c[6] = {
+            local_index[ MarchingHexahedraTable::VertexID[e0][0] ],
+            local_index[ MarchingHexahedraTable::VertexID[e0][1] ],
+            local_index[ MarchingHexahedraTable::VertexID[e1][0] ],
+            local_index[ MarchingHexahedraTable::VertexID[e1][1] ],
+            local_index[ MarchingHexahedraTable::VertexID[e2][0] ],
+            local_index[ MarchingHexahedraTable::VertexID[e2][1] ] };
+
+        this->append_triangle<T>( volume, c, polygons );
+    } // end of loop-triangle
 }
 
 /*==========================================================================*/
 /**
- *  @brief  Extract a slice plane for a unstructured volume.
+ *  @brief  Extract a slice plane from a pyramidal cell.
  *  @param  volume [in] pointer to the unstructured volume object
+ *  @param  cell [in] cell index
+ *  @param  polygons [out] extracted polygons
  */
 /*==========================================================================*/
 template <typename T>
 void SlicePlane::extract_pyramid_plane(
-    const kvs::UnstructuredVolumeObject* volume )
+    const kvs::UnstructuredVolumeObject* volume,
+    const size_t cell,
+    Polygons* polygons ) const
 {
-    // Calculated the coordinate data array and the normal vector array.
-    std::vector<kvs::Real32> coords;
-    std::vector<kvs::Real32> normals;
-    std::vector<kvs::UInt8>  colors;
+    // Calculate the indices of the target cell.
+    const kvs::UInt32* connections = volume->connections().data() + 5 * cell;
+    size_t local_index[5];
+    local_index[0] = connections[0];
+    local_index[1] = connections[1];
+    local_index[2] = connections[2];
+    local_index[3] = connections[3];
+    local_index[4] = connections[4];
+
+    // Calculate the index of the reference table.
+    const size_t table_index = this->calculate_pyramid_table_index( local_index );
+    if ( table_index == 0 ) return;
+    if ( table_index == 31 ) return;
+
+    // Calculate the triangle polygons.
+    for ( size_t i = 0; MarchingPyramidTable::TriangleID[ table_index ][i] != -1; i += 3 )
+    {
+        // Refer the edge IDs from the TriangleTable using the table_index.
+        const int e0 = MarchingPyramidTable::TriangleID[table_index][i];
+        const int e1 = MarchingPyramidTable::TriangleID[table_index][i+1];
+        const int e2 = MarchingPyramidTable::TriangleID[table_index][i+2];
+
+        // Refer indices of the coordinate array from the VertexTable using the edgeIDs.
+        const size_t c[6] = {
+            local_index[ MarchingPyramidTable::VertexID[e0][0] ],
+            local_index[ MarchingPyramidTable::VertexID[e0][1] ],
+            local_index[ MarchingPyramidTable::VertexID[e1][0] ],
+            local_index[ MarchingPyramidTable::VertexID[e1][1] ],
+            local_index[ MarchingPyramidTable::VertexID[e2][0] ],
+            local_index[ MarchingPyramidTable::VertexID[e2][1] ] };
+
+        this->append_triangle<T>( volume, c, polygons );
+    } // end of loop-triangle
+}
 
-    // Calculate min/max values of the node data.
-    if ( !volume->hasMinMaxValues() )
+/*===========================================================================*/
+/**
+ *  @brief  Appends a triangle crossing the edges of a unstructured volume.
+ *  @param  volume [in] pointer to the unstructured volume object
+ *  @param  c [in] node indices of the three edges
+ *  @param  polygons [out] extracted polygons
+ */
+/*===========================================================================*/
+template <typename T>
+void SlicePlane::append_triangle(
+    const kvs::UnstructuredVolumeObject* volume,
+    const size_t c[6],
+    Polygons* polygons ) const
+{
+    const kvs::Real32* volume_coords = volume->coords().data();
+
+    // Determine vertices for each edge.
+    const kvs::Vector3f v0( volume_coords + 3 * c[0] );
+    const kvs::Vector3f v1( volume_coords + 3 * c[1] );
+
+    const kvs::Vector3f v2( volume_coords + 3 * c[2] );
+    const kvs::Vector3f v3( volume_coords + 3 * c[3] );
+
+    const kvs::Vector3f v4( volume_coords + 3 * c[4] );
+    const kvs::Vector3f v5( volume_coords + 3 * c[5] );
+
+    // Calculate coordinates of the vertices which are composed
+    // of the triangle polygon.
+    const kvs::Vector3f vertices[3] = {
+        this->interpolate_vertex( v0, v1 ),
+        this->interpolate_vertex( v2, v3 ),
+        this->interpolate_vertex( v4, v5 ) };
+
+    const double values[3] = {
+        this->interpolate_value<T>( volume, c[0], c[1] ),
+        this->interpolate_value<T>( volume, c[2], c[3] ),
+        this->interpolate_value<T>( volume, c[4], c[5] ) };
+
+    this->append_triangle( vertices, values, polygons );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Appends a triangle polygon.
+ *  @param  vertices [in] vertex coordinates of the triangle
+ *  @param  values [in] values at the vertices
+ *  @param  polygons [out] extracted polygons
+ */
+/*===========================================================================*/
+void SlicePlane::append_triangle(
+    const kvs::Vector3f vertices[3],
+    const double values[3],
+    Polygons* polygons ) const
+{
+    const kvs::ColorMap& color_map( BaseClass::transferFunction().colorMap() );
+    for ( size_t i = 0; i < 3; i++ )
     {
-        volume->updateMinMaxValues();
+        polygons->coords.push_back( vertices[i].x() );
+        polygons->coords.push_back( vertices[i].y() );
+        polygons->coords.push_back( vertices[i].z() );
+
+        const kvs::UInt8 color =
+            static_cast<kvs::UInt8>( polygons->normalize_factor * ( values[i] - polygons->min_value ) );
+        polygons->colors.push_back( color_map[ color ].r() );
+        polygons->colors.push_back( color_map[ color ].g() );
+        polygons->colors.push_back( color_map[ color ].b() );
     }
 
-    // Calculate a normalize factor.
-    const kvs::Real64 min_value( volume->minValue() );
-    const kvs::Real64 max_value( volume->maxValue() );
-    const kvs::Real64 normalize_factor( 255.0 / ( max_value - min_value ) );
+    // Calculate a normal vector for the triangle polygon.
+    const kvs::Vector3f normal( -( vertices[2] - vertices[0] ).cross( vertices[1] - vertices[0] ) );
+    polygons->normals.push_back( normal.x() );
+    polygons->normals.push_back( normal.y() );
+    polygons->normals.push_back( normal.z() );
+}
 
-    // Refer the parameters of the unstructured volume object.
-    const kvs::Real32* volume_coords      = volume->coords().data();
-    const kvs::UInt32* volume_connections = volume->connections().data();
-    const size_t       ncells             = volume->numberOfCells();
+/*===========================================================================*/
+/**
+ *  @brief  Returns the axis closest to the plane normal.
+ *  @return axis (0: x, 1: y, 2: z)
+ */
+/*===========================================================================*/
+size_t SlicePlane::traversal_axis() const
+{
+    const float nx = kvs::Math::Abs( m_coefficients.x() );
+    const float ny = kvs::Math::Abs( m_coefficients.y() );
+    const float nz = kvs::Math::Abs( m_coefficients.z() );
+    if ( nx >= ny && nx >= nz ) { return 0; }
+    return ny >= nz ? 1 : 2;
+}
 
-    const kvs::ColorMap& color_map( BaseClass::transferFunction().colorMap() );
+/*===========================================================================*/
+/**
+ *  @brief  Returns the number of threads for the extraction.
+ *  @param  ncells [in] number of cells to be visited
+ *  @param  nblocks [in] max. number of blocks
+ *  @return number of threads
+ */
+/*===========================================================================*/
+size_t SlicePlane::number_of_threads( const size_t ncells, const size_t nblocks ) const
+{
+    size_t nthreads = m_nthreads > 0 ? m_nthreads : kvs::SystemInformation::NumberOfProcessors();
+    nthreads = kvs::Math::Min( nthreads, ncells / ::MinCellsPerThread );
+    nthreads = kvs::Math::Min( nthreads, nblocks );
+    return kvs::Math::Max( nthreads, size_t(1) );
+}
 
-    // Extract surfaces.
-    size_t index = 0;
-    size_t local_index[5];
-    for ( kvs::UInt32 cell = 0; cell < ncells; ++cell, index += 5 )
+/*===========================================================================*/
+/**
+ *  @brief  Updates the cell tree of the unstructured volume.
+ *  @param  volume [in] pointer to the unstructured volume object
+ *  @return true, if the cell tree of the volume is available
+ */
+/*===========================================================================*/
+bool SlicePlane::update_cell_tree( const kvs::UnstructuredVolumeObject* volume )
+{
+    // The cell tree is built when the same volume is sliced again, such as
+    // dragging the plane, since a single slice does not pay for building it.
+    if ( m_sliced_volume != volume ||
+         ( !m_cell_tree.nodes.empty() && m_cell_tree.leaves.size() != volume->numberOfCells() ) )
+    {
+        m_sliced_volume = volume;
+        m_cell_tree.nodes.clear();
+        m_cell_tree.leaves.clear();
+        return false;
+    }
+
+    if ( m_cell_tree.nodes.empty() )
     {
-        // Calculate the indices of the target cell.
-        local_index[0] = volume_connections[ index ];
-        local_index[1] = volume_connections[ index + 1 ];
-        local_index[2] = volume_connections[ index + 2 ];
-        local_index[3] = volume_connections[ index + 3 ];
-        local_index[4] = volume_connections[ index + 4 ];
-
-        // Calculate the index of the reference table.
-        const size_t table_index = this->calculate_pyramid_table_index( local_index );
-        if ( table_index == 0 ) continue;
-        if ( table_index == 31 ) continue;
-
-        // Calculate the triangle polygons.
-        for ( size_t i = 0; MarchingPyramidTable::TriangleID[ table_index ][i] != -1; i += 3 )
+        m_cell_tree.build( volume, m_nthreads != 1 );
+
+        const kvs::Real32* coords = volume->coords().data();
+        const size_t nnodes = volume->numberOfNodes();
+        m_cell_tree_min = m_cell_tree_max = kvs::Vec3( coords );
+        for ( size_t i = 1; i < nnodes; i++ )
         {
-            // Refer the edge IDs from the TriangleTable using the table_index.
-            const int e0 = MarchingPyramidTable::TriangleID[table_index][i];
-            const int e1 = MarchingPyramidTable::TriangleID[table_index][i+1];
-            const int e2 = MarchingPyramidTable::TriangleID[table_index][i+2];
-
-            // Refer indices of the coordinate array from the VertexTable using the edgeIDs.
-            const size_t c0 = local_index[ MarchingPyramidTable::VertexID[e0][0] ];
-            const size_t c1 = local_index[ MarchingPyramidTable::VertexID[e0][1] ];
-            const size_t c2 = local_index[ MarchingPyramidTable::VertexID[e1][0] ];
-            const size_t c3 = local_index[ MarchingPyramidTable::VertexID[e1][1] ];
-            const size_t c4 = local_index[ MarchingPyramidTable::VertexID[e2][0] ];
-            const size_t c5 = local_index[ MarchingPyramidTable::VertexID[e2][1] ];
-
-            // Determine vertices for each edge.
-            const kvs::Vector3f v0( volume_coords + 3 * c0 );
-            const kvs::Vector3f v1( volume_coords + 3 * c1 );
-
-            const kvs::Vector3f v2( volume_coords + 3 * c2 );
-            const kvs::Vector3f v3( volume_coords + 3 * c3 );
-
-            const kvs::Vector3f v4( volume_coords + 3 * c4 );
-            const kvs::Vector3f v5( volume_coords + 3 * c5 );
-
-            // Calculate coordinates of the vertices which are composed
-            // of the triangle polygon.
-            const kvs::Vector3f vertex0( this->interpolate_vertex( v0, v1 ) );
-            coords.push_back( vertex0.x() );
-            coords.push_back( vertex0.y() );
-            coords.push_back( vertex0.z() );
-
-            const kvs::Vector3f vertex1( this->interpolate_vertex( v2, v3 ) );
-            coords.push_back( vertex1.x() );
-            coords.push_back( vertex1.y() );
-            coords.push_back( vertex1.z() );
-
-            const kvs::Vector3f vertex2( this->interpolate_vertex( v4, v5 ) );
-            coords.push_back( vertex2.x() );
-            coords.push_back( vertex2.y() );
-            coords.push_back( vertex2.z() );
-
-            const double value0 = this->interpolate_value<T>( volume, c0, c1 );
-            const double value1 = this->interpolate_value<T>( volume, c2, c3 );
-            const double value2 = this->interpolate_value<T>( volume, c4, c5 );
-
-            const kvs::UInt8 color0 =
-                static_cast<kvs::UInt8>( normalize_factor * ( value0 - min_value ) );
-            colors.push_back( color_map[ color0 ].r() );
-            colors.push_back( color_map[ color0 ].g() );
-            colors.push_back( color_map[ color0 ].b() );
-
-            const kvs::UInt8 color1 =
-                static_cast<kvs::UInt8>( normalize_factor * ( value1 - min_value ) );
-            colors.push_back( color_map[ color1 ].r() );
-            colors.push_back( color_map[ color1 ].g() );
-            colors.push_back( color_map[ color1 ].b() );
-
-            const kvs::UInt8 color2 =
-                static_cast<kvs::UInt8>( normalize_factor * ( value2 - min_value ) );
-            colors.push_back( color_map[ color2 ].r() );
-            colors.push_back( color_map[ color2 ].g() );
-            colors.push_back( color_map[ color2 ].b() );
-
-            // Calculate a normal vector for the triangle polygon.
-            const kvs::Vector3f normal( -( vertex2 - vertex0 ).cross( vertex1 - vertex0 ) );
-            normals.push_back( normal.x() );
-            normals.push_back( normal.y() );
-            normals.push_back( normal.z() );
-        } // end of loop-triangle
-    } // end of loop-cell
-
-    SuperClass::setCoords( kvs::ValueArray<kvs::Real32>( coords ) );
-    SuperClass::setColors( kvs::ValueArray<kvs::UInt8>( colors ) );
-    SuperClass::setNormals( kvs::ValueArray<kvs::Real32>( normals ) );
-    SuperClass::setOpacity( 255 );
-    SuperClass::setPolygonType( kvs::PolygonObject::Triangle );
-    SuperClass::setColorType( kvs::PolygonObject::VertexColor );
-    SuperClass::setNormalType( kvs::PolygonObject::PolygonNormal );
+            const kvs::Vec3 coord( coords + 3 * i );
+            for ( size_t j = 0; j < 3; j++ )
+            {
+                m_cell_tree_min[j] = kvs::Math::Min( m_cell_tree_min[j], coord[j] );
+                m_cell_tree_max[j] = kvs::Math::Max( m_cell_tree_max[j], coord[j] );
+            }
+        }
+    }
+
+    return !m_cell_tree.nodes.empty();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Collects the cells in the leaves of the cell tree crossed by the plane.
+ *  @param  cells [out] candidate cells
+ */
+/*===========================================================================*/
+void SlicePlane::collect_cells( std::vector<kvs::UInt32>* cells ) const
+{
+    // Each node of the cell tree bounds its children along the split axis
+    // only, so the bounding box of a node is narrowed down from the root.
+    struct Entry
+    {
+        kvs::UInt32 node; ///< node index
+        kvs::Vec3 min; ///< min. corner of the bounding box
+        kvs::Vec3 max; ///< max. corner of the bounding box
+    };
+
+    std::vector<Entry> stack( 1 );
+    stack[0].node = 0;
+    stack[0].min = m_cell_tree_min;
+    stack[0].max = m_cell_tree_max;
+    while ( !stack.empty() )
+    {
+        const Entry entry = stack.back();
+        stack.pop_back();
+
+        // Skip the node if its bounding box is on one side of the plane.
+        float fmin = m_coefficients.w();
+        float fmax = m_coefficients.w();
+        for ( size_t i = 0; i < 3; i++ )
+        {
+            const float c = m_coefficients[i];
+            fmin += c * ( c > 0.0f ? entry.min[i] : entry.max[i] );
+            fmax += c * ( c > 0.0f ? entry.max[i] : entry.min[i] );
+        }
+        if ( fmin > 0.0f || fmax < 0.0f ) { continue; }
+
+        const kvs::CellTree::Node& node = m_cell_tree.nodes[ entry.node ];
+        if ( node.isLeaf() )
+        {
+            const kvs::UInt32* leaves = &m_cell_tree.leaves[ node.start ];
+            cells->insert( cells->end(), leaves, leaves + node.size );
+            continue;
+        }
+
+        Entry right = entry;
+        right.node = node.right();
+        right.min[ node.dim() ] = node.rmin;
+        stack.push_back( right );
+
+        Entry left = entry;
+        left.node = node.left();
+        left.max[ node.dim() ] = node.lmax;
+        stack.push_back( left );
+    }
 }
 
 /*===========================================================================*/
@@ -958,7 +1195,7 @@ double SlicePlane::interpolate_value(
     const kvs::Vector3f&               vertex0,
     const kvs::Vector3f&               vertex1 ) const
 {
-    const T* const values = static_cast<const T*>( volume->values().data() );
+    const kvs::StructuredVolumeObject::ValueAccessor<T> values( volume );
 
     const size_t line_size  = volume->numberOfNodesPerLine();
     const size_t slice_size = volume->numberOfNodesPerSlice();
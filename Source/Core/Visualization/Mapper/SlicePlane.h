@@ -15,6 +15,7 @@
 #ifndef KVS__SLICE_PLANE_H_INCLUDE
 #define KVS__SLICE_PLANE_H_INCLUDE
 
+#include <vector>
 #include <kvs/PolygonObject>
 #include <kvs/VolumeObjectBase>
 #include <kvs/StructuredVolumeObject>
@@ -22,6 +23,8 @@
 #include <kvs/Vector3>
 #include <kvs/Vector4>
 #include <kvs/MapperBase>
+#include <kvs/VolumePyramid>
+#include <kvs/CellTree>
 #include <kvs/Module>
 
 
@@ -42,6 +45,14 @@ class SlicePlane : public kvs::MapperBase, public kvs::PolygonObject
 private:
 
     kvs::Vector4f m_coefficients; ///< coeficients of a slice plane
+    bool m_enable_lod; ///< flag for LOD control
+    size_t m_lod_nnodes; ///< max. number of nodes of the volume sliced with LOD control
+    kvs::VolumePyramid m_pyramid; ///< volume pyramid for LOD control
+    size_t m_nthreads; ///< number of threads (0: number of processors)
+    const kvs::UnstructuredVolumeObject* m_sliced_volume; ///< unstructured volume sliced last
+    kvs::CellTree m_cell_tree; ///< cell tree of the sliced volume
+    kvs::Vec3 m_cell_tree_min; ///< min. corner of the bounding box of the cell tree
+    kvs::Vec3 m_cell_tree_max; ///< max. corner of the bounding box of the cell tree
 
 public:
 
@@ -59,17 +70,79 @@ public:
 
     void setPlane( const kvs::Vector4f& coefficients );
     void setPlane( const kvs::Vector3f& point, const kvs::Vector3f& normal );
+    void setNumberOfThreads( const size_t nthreads ) { m_nthreads = nthreads; }
+    void setLODNumberOfNodes( const size_t nnodes ) { m_lod_nnodes = nnodes; }
+    void setEnabledLODControl( const bool enable ) { m_enable_lod = enable; }
+    void enableLODControl() { this->setEnabledLODControl( true ); }
+    void disableLODControl() { this->setEnabledLODControl( false ); }
+    bool isEnabledLODControl() const { return m_enable_lod; }
+    size_t numberOfThreads() const { return m_nthreads; }
+    size_t lodNumberOfNodes() const { return m_lod_nnodes; }
+    const kvs::VolumePyramid& pyramid() const { return m_pyramid; }
 
     SuperClass* exec( const kvs::ObjectBase* object );
 
 protected:
 
+    struct Polygons
+    {
+        kvs::Real64 min_value; ///< min. value for the color normalization
+        kvs::Real64 normalize_factor; ///< factor for the color normalization
+        std::vector<kvs::Real32> coords; ///< vertex coordinates
+        std::vector<kvs::UInt8> colors; ///< vertex colors
+        std::vector<kvs::Real32> normals; ///< polygon normals
+    };
+
+    template <typename T> class Extractor;
+
     void mapping( const kvs::VolumeObjectBase* volume );
+    const kvs::StructuredVolumeObject* select_level( const kvs::StructuredVolumeObject* volume, kvs::Vec3* scale );
+    void scale_plane( const kvs::Vec3& scale );
     template <typename T> void extract_plane( const kvs::StructuredVolumeObject* volume );
     template <typename T> void extract_plane( const kvs::UnstructuredVolumeObject* volume );
-    template <typename T> void extract_tetrahedra_plane( const kvs::UnstructuredVolumeObject* volume );
-    template <typename T> void extract_hexahedra_plane( const kvs::UnstructuredVolumeObject* volume );
-    template <typename T> void extract_pyramid_plane( const kvs::UnstructuredVolumeObject* volume );
+    template <typename T> void extract(
+        const kvs::VolumeObjectBase* volume,
+        const kvs::UInt32* cells,
+        const size_t n,
+        const size_t nthreads );
+    template <typename T> void extract_cells(
+        const kvs::StructuredVolumeObject* volume,
+        const size_t begin,
+        const size_t end,
+        Polygons* polygons ) const;
+    template <typename T> void extract_cells(
+        const kvs::UnstructuredVolumeObject* volume,
+        const kvs::UInt32* cells,
+        const size_t begin,
+        const size_t end,
+        Polygons* polygons ) const;
+    template <typename T> void extract_cell(
+        const kvs::StructuredVolumeObject* volume,
+        const kvs::UInt32 x,
+        const kvs::UInt32 y,
+        const kvs::UInt32 z,
+        Polygons* polygons ) const;
+    template <typename T> void extract_tetrahedra_plane(
+        const kvs::UnstructuredVolumeObject* volume,
+        const size_t cell,
+        Polygons* polygons ) const;
+    template <typename T> void extract_hexahedra_plane(
+        const kvs::UnstructuredVolumeObject* volume,
+        const size_t cell,
+        Polygons* polygons ) const;
+    template <typename T> void extract_pyramid_plane(
+        const kvs::UnstructuredVolumeObject* volume,
+        const size_t cell,
+        Polygons* polygons ) const;
+    template <typename T> void append_triangle(
+        const kvs::UnstructuredVolumeObject* volume,
+        const size_t c[6],
+        Polygons* polygons ) const;
+    void append_triangle( const kvs::Vector3f vertices[3], const double values[3], Polygons* polygons ) const;
+    size_t traversal_axis() const;
+    size_t number_of_threads( const size_t ncells, const size_t nblocks ) const;
+    bool update_cell_tree( const kvs::UnstructuredVolumeObject* volume );
+    void collect_cells( std::vector<kvs::UInt32>* cells ) const;
     size_t calculate_table_index( const size_t x, const size_t y, const size_t z ) const;
     size_t calculate_tetrahedra_table_index( const size_t* local_index ) const;
     size_t calculate_hexahedra_table_index( const size_t* local_index ) const;
@@ -337,6 +337,43 @@ kvs::ValueArray<kvs::Real32> TransferFunction::table() const
     return table;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Returns the scalar interval where the transfer function differs from the other.
+ *  @param  other [in] transfer function to be compared (e.g. the previous one)
+ *  @param  lower [out] lower bound of the changed interval
+ *  @param  upper [out] upper bound of the changed interval
+ *  @return true if the transfer functions differ
+ *
+ *  The interval is the union of the changed intervals of the color map and
+ *  the opacity map. See kvs::ColorMap::changedRange for the details.
+ */
+/*===========================================================================*/
+bool TransferFunction::changedRange( const TransferFunction& other, float* lower, float* upper ) const
+{
+    float color_lower = 0.0f, color_upper = 0.0f;
+    float opacity_lower = 0.0f, opacity_upper = 0.0f;
+    const bool color_changed = m_color_map.changedRange( other.m_color_map, &color_lower, &color_upper );
+    const bool opacity_changed = m_opacity_map.changedRange( other.m_opacity_map, &opacity_lower, &opacity_upper );
+    if ( color_changed && opacity_changed )
+    {
+        *lower = kvs::Math::Min( color_lower, opacity_lower );
+        *upper = kvs::Math::Max( color_upper, opacity_upper );
+    }
+    else if ( color_changed )
+    {
+        *lower = color_lower;
+        *upper = color_upper;
+    }
+    else if ( opacity_changed )
+    {
+        *lower = opacity_lower;
+        *upper = opacity_upper;
+    }
+
+    return color_changed || opacity_changed;
+}
+
 /*==========================================================================*/
 /**
  *  @brief  Create the alpha map.
@@ -60,6 +60,7 @@ public:
     const kvs::OpacityMap& opacityMap() const;
     size_t resolution() const;
     kvs::ValueArray<kvs::Real32> table() const;
+    bool changedRange( const TransferFunction& other, float* lower, float* upper ) const;
 
     void create( const size_t resolution );
     bool read( const std::string& filename );
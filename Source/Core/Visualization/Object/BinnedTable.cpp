@@ -0,0 +1,304 @@
+/*****************************************************************************/
+/**
+ *  @file   BinnedTable.cpp
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#include "BinnedTable.h"
+#include <kvs/Math>
+#include <kvs/Thread>
+#include <kvs/SystemInformation>
+#include <kvs/Message>
+
+
+namespace
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Worker thread of the task.
+ */
+/*===========================================================================*/
+class Worker : public kvs::Thread
+{
+private:
+
+    kvs::BinnedTable::Task* m_task; ///< task
+    size_t m_index; ///< thread index
+    size_t m_nthreads; ///< number of threads
+
+public:
+
+    Worker(): m_task( NULL ), m_index( 0 ), m_nthreads( 1 ) {}
+
+    void init( kvs::BinnedTable::Task* task, const size_t index, const size_t nthreads )
+    {
+        m_task = task;
+        m_index = index;
+        m_nthreads = nthreads;
+    }
+
+    void run()
+    {
+        m_task->run( m_index, m_nthreads );
+    }
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Quantizes the values into the bins.
+ *  @param  values [in] pointer to the values
+ *  @param  nvalues [in] number of values
+ *  @param  min_value [in] min. value (the first bin)
+ *  @param  max_value [in] max. value (the last bin)
+ *  @param  nbins [in] number of bins
+ *  @param  bins [out] bin indices
+ */
+/*===========================================================================*/
+template <typename T>
+void Quantize(
+    const T* values,
+    const size_t nvalues,
+    const kvs::Real64 min_value,
+    const kvs::Real64 max_value,
+    const size_t nbins,
+    kvs::UInt8* bins )
+{
+    const kvs::Real64 scale = max_value > min_value ? nbins / ( max_value - min_value ) : 0.0;
+    const kvs::Real64 last = static_cast<kvs::Real64>( nbins - 1 );
+    for ( size_t i = 0; i < nvalues; i++ )
+    {
+        const kvs::Real64 bin = ( static_cast<kvs::Real64>( values[i] ) - min_value ) * scale;
+        bins[i] = static_cast<kvs::UInt8>( kvs::Math::Clamp( bin, 0.0, last ) );
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Task that quantizes the column values.
+ */
+/*===========================================================================*/
+class QuantizeTask : public kvs::BinnedTable::Task
+{
+private:
+
+    const kvs::TableObject* m_table; ///< table object
+    size_t m_nbins; ///< number of bins
+    std::vector<kvs::BinnedTable::Bins>* m_bins; ///< bin indices for each column
+
+public:
+
+    QuantizeTask( const kvs::TableObject* table, const size_t nbins, std::vector<kvs::BinnedTable::Bins>* bins ):
+        m_table( table ),
+        m_nbins( nbins ),
+        m_bins( bins ) {}
+
+    void run( const size_t thread_index, const size_t nthreads )
+    {
+        for ( size_t i = thread_index; i < m_bins->size(); i += nthreads ) this->quantize( i );
+    }
+
+private:
+
+    void quantize( const size_t index )
+    {
+        const kvs::AnyValueArray& column = m_table->column( index );
+        const kvs::Real64 min_value = m_table->minValue( index );
+        const kvs::Real64 max_value = m_table->maxValue( index );
+        const size_t n = column.size();
+        kvs::UInt8* bins = (*m_bins)[ index ].data();
+        switch ( column.typeID() )
+        {
+        case kvs::Type::TypeInt8:   ::Quantize( static_cast<const kvs::Int8*  >( column.data() ), n, min_value, max_value, m_nbins, bins ); break;
+        case kvs::Type::TypeInt16:  ::Quantize( static_cast<const kvs::Int16* >( column.data() ), n, min_value, max_value, m_nbins, bins ); break;
+        case kvs::Type::TypeInt32:  ::Quantize( static_cast<const kvs::Int32* >( column.data() ), n, min_value, max_value, m_nbins, bins ); break;
+        case kvs::Type::TypeInt64:  ::Quantize( static_cast<const kvs::Int64* >( column.data() ), n, min_value, max_value, m_nbins, bins ); break;
+        case kvs::Type::TypeUInt8:  ::Quantize( static_cast<const kvs::UInt8* >( column.data() ), n, min_value, max_value, m_nbins, bins ); break;
+        case kvs::Type::TypeUInt16: ::Quantize( static_cast<const kvs::UInt16*>( column.data() ), n, min_value, max_value, m_nbins, bins ); break;
+        case kvs::Type::TypeUInt32: ::Quantize( static_cast<const kvs::UInt32*>( column.data() ), n, min_value, max_value, m_nbins, bins ); break;
+        case kvs::Type::TypeUInt64: ::Quantize( static_cast<const kvs::UInt64*>( column.data() ), n, min_value, max_value, m_nbins, bins ); break;
+        case kvs::Type::TypeReal32: ::Quantize( static_cast<const kvs::Real32*>( column.data() ), n, min_value, max_value, m_nbins, bins ); break;
+        case kvs::Type::TypeReal64: ::Quantize( static_cast<const kvs::Real64*>( column.data() ), n, min_value, max_value, m_nbins, bins ); break;
+        default: (*m_bins)[ index ].fill( 0 ); break;
+        }
+    }
+};
+
+} // end of namespace
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new BinnedTable class.
+ *  @param  resolution [in] number of bins on each axis (2 - 256)
+ */
+/*===========================================================================*/
+BinnedTable::BinnedTable( const size_t resolution ):
+    m_resolution( kvs::Math::Clamp( resolution, size_t(2), size_t(256) ) ),
+    m_nthreads( 0 ),
+    m_table( NULL ),
+    m_nrows( 0 )
+{
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sets the number of bins on each axis.
+ *  @param  resolution [in] number of bins (2 - 256)
+ */
+/*===========================================================================*/
+void BinnedTable::setResolution( const size_t resolution )
+{
+    const size_t r = kvs::Math::Clamp( resolution, size_t(2), size_t(256) );
+    if ( r != m_resolution ) this->release();
+    m_resolution = r;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Updates the bins and the flags with the table object.
+ *  @param  table [in] pointer to the table object
+ *  @return update type
+ *
+ *  The values are quantized only when the table or its value ranges are
+ *  changed. Otherwise, the rows whose inside range flags are changed since
+ *  the last update are listed in changedRows(), unless so many rows are
+ *  changed that counting all the rows again is faster.
+ */
+/*===========================================================================*/
+BinnedTable::UpdateType BinnedTable::update( const kvs::TableObject* table )
+{
+    m_changed_rows.clear();
+
+    if ( !table || table->numberOfColumns() < 2 || table->numberOfRows() == 0 )
+    {
+        kvsMessageError( "The table object must have two or more columns." );
+        this->release();
+        return Failed;
+    }
+
+    if ( table->insideRangeFlags().size() != table->numberOfRows() )
+    {
+        kvsMessageError( "The inside range flags are not allocated." );
+        this->release();
+        return Failed;
+    }
+
+    if ( !this->is_binned( table ) )
+    {
+        this->quantize( table );
+        return Rebinned;
+    }
+
+    const kvs::TableObject::InsideRangeFlags& flags = table->insideRangeFlags();
+    size_t nchanged_rows = 0;
+    for ( size_t i = 0; i < m_nrows; i++ ) nchanged_rows += ( flags[i] != m_flags[i] );
+    if ( nchanged_rows == 0 ) return Unchanged;
+
+    // Counting all the rows again is faster than adding and removing many rows.
+    if ( nchanged_rows > m_nrows / 4 )
+    {
+        m_flags = flags;
+        return AllRowsChanged;
+    }
+
+    m_changed_rows.reserve( nchanged_rows );
+    for ( size_t i = 0; i < m_nrows; i++ )
+    {
+        if ( flags[i] != m_flags[i] )
+        {
+            m_changed_rows.push_back( i );
+            m_flags[i] = flags[i];
+        }
+    }
+
+    return RowsChanged;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Executes the task by the threads.
+ *  @param  task [in] task
+ *  @param  max_nthreads [in] max. number of threads (e.g. number of histograms)
+ */
+/*===========================================================================*/
+void BinnedTable::execute( Task* task, const size_t max_nthreads ) const
+{
+    size_t nworkers = m_nthreads > 0 ? m_nthreads : kvs::SystemInformation::NumberOfProcessors();
+    nworkers = kvs::Math::Max( size_t(1), kvs::Math::Min( nworkers, max_nthreads ) );
+
+    // The first worker runs on the calling thread.
+    std::vector< ::Worker > workers( nworkers );
+    for ( size_t i = 0; i < nworkers; i++ )
+    {
+        workers[i].init( task, i, nworkers );
+        if ( i == 0 || !workers[i].start() ) workers[i].run();
+    }
+    for ( size_t i = 1; i < nworkers; i++ ) { if ( workers[i].isRunning() ) workers[i].wait(); }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Releases the bins and the flags.
+ */
+/*===========================================================================*/
+void BinnedTable::release()
+{
+    m_table = NULL;
+    m_nrows = 0;
+    m_min_values.clear();
+    m_max_values.clear();
+    m_bins.clear();
+    m_flags.clear();
+    m_changed_rows.clear();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Checks whether the values of the table have been quantized.
+ *  @param  table [in] pointer to the table object
+ *  @return true if the bins can be reused
+ */
+/*===========================================================================*/
+bool BinnedTable::is_binned( const kvs::TableObject* table ) const
+{
+    return m_table == table &&
+        m_nrows == table->numberOfRows() &&
+        m_bins.size() == table->numberOfColumns() &&
+        m_min_values == table->minValues() &&
+        m_max_values == table->maxValues();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Quantizes the values of the columns into the bins in parallel.
+ *  @param  table [in] pointer to the table object
+ */
+/*===========================================================================*/
+void BinnedTable::quantize( const kvs::TableObject* table )
+{
+    const size_t ncolumns = table->numberOfColumns();
+    m_table = table;
+    m_nrows = table->numberOfRows();
+    m_min_values = table->minValues();
+    m_max_values = table->maxValues();
+    m_bins.resize( ncolumns );
+    for ( size_t i = 0; i < ncolumns; i++ ) m_bins[i].allocate( m_nrows );
+
+    ::QuantizeTask task( table, m_resolution, &m_bins );
+    this->execute( &task, ncolumns );
+
+    m_flags = table->insideRangeFlags();
+}
+
+} // end of namespace kvs
@@ -0,0 +1,103 @@
+/*****************************************************************************/
+/**
+ *  @file   BinnedTable.h
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#ifndef KVS__BINNED_TABLE_H_INCLUDE
+#define KVS__BINNED_TABLE_H_INCLUDE
+
+#include <vector>
+#include <kvs/Type>
+#include <kvs/ValueArray>
+#include <kvs/TableObject>
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Bin indices of the table values.
+ *
+ *  The values of each column are quantized into the bins once, and are
+ *  quantized again only when the table or its value ranges (min. and max.
+ *  values) are changed. The inside range flags of the rows are kept, so
+ *  that the rows whose flags are changed since the last update can be
+ *  added to or removed from the histograms counted with the bins.
+ */
+/*===========================================================================*/
+class BinnedTable
+{
+public:
+
+    typedef kvs::ValueArray<kvs::UInt8> Bins;
+
+    enum UpdateType
+    {
+        Failed = 0, ///< the table cannot be binned
+        Unchanged, ///< neither the bins nor the flags are changed
+        Rebinned, ///< the values are quantized again
+        AllRowsChanged, ///< many flags are changed (all the rows should be counted again)
+        RowsChanged ///< the flags of the rows in changedRows() are changed
+    };
+
+    /*=======================================================================*/
+    /**
+     *  @brief  Task executed by the threads.
+     */
+    /*=======================================================================*/
+    class Task
+    {
+    public:
+        virtual ~Task() {}
+        virtual void run( const size_t thread_index, const size_t nthreads ) = 0;
+    };
+
+private:
+
+    size_t m_resolution; ///< number of bins on each axis (<= 256)
+    size_t m_nthreads; ///< number of threads (0: number of processors)
+    const kvs::TableObject* m_table; ///< table of the quantized bins
+    size_t m_nrows; ///< number of rows of the table
+    kvs::TableObject::Values m_min_values; ///< min. values used for the bins
+    kvs::TableObject::Values m_max_values; ///< max. values used for the bins
+    std::vector<Bins> m_bins; ///< bin indices of the values for each column
+    kvs::TableObject::InsideRangeFlags m_flags; ///< inside range flags at the last update
+    std::vector<size_t> m_changed_rows; ///< rows whose flags are changed at the last update
+
+public:
+
+    BinnedTable( const size_t resolution = 256 );
+
+    size_t resolution() const { return m_resolution; }
+    size_t numberOfThreads() const { return m_nthreads; }
+    size_t numberOfColumns() const { return m_bins.size(); }
+    size_t numberOfRows() const { return m_nrows; }
+    const std::vector<Bins>& bins() const { return m_bins; }
+    const kvs::TableObject::InsideRangeFlags& flags() const { return m_flags; }
+    const std::vector<size_t>& changedRows() const { return m_changed_rows; }
+
+    void setResolution( const size_t resolution );
+    void setNumberOfThreads( const size_t nthreads ) { m_nthreads = nthreads; }
+
+    UpdateType update( const kvs::TableObject* table );
+    void execute( Task* task, const size_t max_nthreads ) const;
+    void release();
+
+private:
+
+    bool is_binned( const kvs::TableObject* table ) const;
+    void quantize( const kvs::TableObject* table );
+};
+
+} // end of namespace kvs
+
+#endif // KVS__BINNED_TABLE_H_INCLUDE
@@ -0,0 +1,596 @@
+/*****************************************************************************/
+/**
+ *  @file   BrickedVolume.cpp
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#include "BrickedVolume.h"
+#include <cstring>
+#include <algorithm>
+#include <kvs/Message>
+#include <kvs/Math>
+#include <kvs/ValueStatistics>
+#include <kvs/StructuredVolumeObject>
+
+
+namespace
+{
+
+const char Magic[8] = { 'K', 'V', 'S', 'B', 'R', 'I', 'C', 'K' };
+const kvs::UInt32 Version = 1;
+const kvs::UInt32 ByteOrderMark = 0x01020304;
+const size_t DefaultCacheSize = 256 * 1024 * 1024;
+
+/*===========================================================================*/
+/**
+ *  @brief  Header of the brick file (64 bytes).
+ */
+/*===========================================================================*/
+struct Header
+{
+    kvs::UInt32 type_id; ///< value type
+    kvs::UInt32 veclen; ///< vector length
+    kvs::UInt32 resolution[3]; ///< node resolution
+    kvs::UInt32 brick_size[3]; ///< brick size
+    kvs::Real64 min_value; ///< min. value
+    kvs::Real64 max_value; ///< max. value
+};
+
+const std::streamoff HeaderSize = 64;
+
+template <typename T>
+void WriteField( std::ostream& os, const T& value )
+{
+    os.write( reinterpret_cast<const char*>( &value ), sizeof( T ) );
+}
+
+template <typename T>
+void ReadField( std::istream& is, T& value )
+{
+    is.read( reinterpret_cast<char*>( &value ), sizeof( T ) );
+}
+
+void WriteHeader( std::ostream& os, const Header& header )
+{
+    os.write( Magic, sizeof( Magic ) );
+    WriteField( os, Version );
+    WriteField( os, ByteOrderMark );
+    WriteField( os, header.type_id );
+    WriteField( os, header.veclen );
+    for ( size_t i = 0; i < 3; i++ ) WriteField( os, header.resolution[i] );
+    for ( size_t i = 0; i < 3; i++ ) WriteField( os, header.brick_size[i] );
+    WriteField( os, header.min_value );
+    WriteField( os, header.max_value );
+}
+
+bool ReadHeader( std::istream& is, Header& header )
+{
+    char magic[8];
+    kvs::UInt32 version = 0;
+    kvs::UInt32 bom = 0;
+    is.read( magic, sizeof( magic ) );
+    ReadField( is, version );
+    ReadField( is, bom );
+    if ( !is || std::memcmp( magic, Magic, sizeof( Magic ) ) != 0 )
+    {
+        kvsMessageError( "Not a brick file." );
+        return false;
+    }
+
+    if ( version != Version )
+    {
+        kvsMessageError( "Unsupported brick file version %u.", version );
+        return false;
+    }
+
+    if ( bom != ByteOrderMark )
+    {
+        kvsMessageError( "The byte order of the brick file differs from this machine." );
+        return false;
+    }
+
+    ReadField( is, header.type_id );
+    ReadField( is, header.veclen );
+    for ( size_t i = 0; i < 3; i++ ) ReadField( is, header.resolution[i] );
+    for ( size_t i = 0; i < 3; i++ ) ReadField( is, header.brick_size[i] );
+    ReadField( is, header.min_value );
+    ReadField( is, header.max_value );
+    if ( !is )
+    {
+        kvsMessageError( "Cannot read the header of the brick file." );
+        return false;
+    }
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Allocates a value array of the specified type.
+ *  @param  type_id [in] value type
+ *  @param  size [in] number of values
+ *  @return value array
+ */
+/*===========================================================================*/
+kvs::AnyValueArray AllocateValues( const kvs::Type::TypeID type_id, const size_t size )
+{
+    switch ( type_id )
+    {
+    case kvs::Type::TypeInt8:   return kvs::AnyValueArray( kvs::ValueArray<kvs::Int8  >( size ) );
+    case kvs::Type::TypeInt16:  return kvs::AnyValueArray( kvs::ValueArray<kvs::Int16 >( size ) );
+    case kvs::Type::TypeInt32:  return kvs::AnyValueArray( kvs::ValueArray<kvs::Int32 >( size ) );
+    case kvs::Type::TypeInt64:  return kvs::AnyValueArray( kvs::ValueArray<kvs::Int64 >( size ) );
+    case kvs::Type::TypeUInt8:  return kvs::AnyValueArray( kvs::ValueArray<kvs::UInt8 >( size ) );
+    case kvs::Type::TypeUInt16: return kvs::AnyValueArray( kvs::ValueArray<kvs::UInt16>( size ) );
+    case kvs::Type::TypeUInt32: return kvs::AnyValueArray( kvs::ValueArray<kvs::UInt32>( size ) );
+    case kvs::Type::TypeUInt64: return kvs::AnyValueArray( kvs::ValueArray<kvs::UInt64>( size ) );
+    case kvs::Type::TypeReal32: return kvs::AnyValueArray( kvs::ValueArray<kvs::Real32>( size ) );
+    case kvs::Type::TypeReal64: return kvs::AnyValueArray( kvs::ValueArray<kvs::Real64>( size ) );
+    default: break;
+    }
+
+    return kvs::AnyValueArray();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Writes the bricks which intersect a slab of slices.
+ *  @param  os [in] output stream
+ *  @param  slab [in] pointer to the node values of the slab
+ *  @param  nslices [in] number of slices of the slab
+ *  @param  header [in] header of the brick file
+ *  @param  node_bytes [in] byte size of a node
+ *  @param  brick [in/out] buffer for a brick
+ */
+/*===========================================================================*/
+void WriteSlab(
+    std::ostream& os,
+    const kvs::UInt8* slab,
+    const size_t nslices,
+    const Header& header,
+    const size_t node_bytes,
+    kvs::ValueArray<kvs::UInt8>& brick )
+{
+    const size_t nx = header.resolution[0];
+    const size_t ny = header.resolution[1];
+    const size_t bx = header.brick_size[0];
+    const size_t by = header.brick_size[1];
+    const size_t bz = header.brick_size[2];
+
+    for ( size_t j0 = 0; j0 < ny; j0 += by )
+    {
+        const size_t nj = kvs::Math::Min( by, ny - j0 );
+        for ( size_t i0 = 0; i0 < nx; i0 += bx )
+        {
+            const size_t ni = kvs::Math::Min( bx, nx - i0 );
+            const size_t row_bytes = ni * node_bytes;
+
+            brick.fill( 0 );
+            for ( size_t k = 0; k < nslices; k++ )
+            {
+                for ( size_t j = 0; j < nj; j++ )
+                {
+                    const kvs::UInt8* src = slab + ( ( k * ny + j0 + j ) * nx + i0 ) * node_bytes;
+                    kvs::UInt8* dst = brick.data() + ( k * by + j ) * bx * node_bytes;
+                    std::memcpy( dst, src, row_bytes );
+                }
+            }
+
+            os.write( reinterpret_cast<const char*>( brick.data() ), bz * by * bx * node_bytes );
+        }
+    }
+}
+
+bool IsValidBrickSize( const kvs::Vec3ui& brick_size )
+{
+    if ( brick_size.x() == 0 || brick_size.y() == 0 || brick_size.z() == 0 )
+    {
+        kvsMessageError( "Brick size must be positive." );
+        return false;
+    }
+
+    return true;
+}
+
+} // end of namespace
+
+
+namespace kvs
+{
+
+const std::string BrickedVolume::Extension = "kvsbrick";
+
+/*===========================================================================*/
+/**
+ *  @brief  Writes the node values of the structured volume to a brick file.
+ *  @param  filename [in] brick filename
+ *  @param  volume [in] pointer to the structured volume object
+ *  @param  brick_size [in] number of nodes of a brick along each axis
+ *  @return true, if the writing process is done successfully
+ */
+/*===========================================================================*/
+bool BrickedVolume::Write(
+    const std::string& filename,
+    const kvs::StructuredVolumeObject* volume,
+    const kvs::Vec3ui& brick_size )
+{
+    if ( !::IsValidBrickSize( brick_size ) ) return false;
+    if ( volume->values().empty() )
+    {
+        kvsMessageError( "The volume has no in-core values." );
+        return false;
+    }
+
+    std::ofstream ofs( filename.c_str(), std::ios::out | std::ios::binary );
+    if ( !ofs )
+    {
+        kvsMessageError( "Cannot open %s.", filename.c_str() );
+        return false;
+    }
+
+    if ( !volume->hasMinMaxValues() ) volume->updateMinMaxValues();
+
+    ::Header header;
+    header.type_id = volume->values().typeID();
+    header.veclen = volume->veclen();
+    for ( size_t i = 0; i < 3; i++ ) header.resolution[i] = volume->resolution()[i];
+    for ( size_t i = 0; i < 3; i++ ) header.brick_size[i] = brick_size[i];
+    header.min_value = volume->minValue();
+    header.max_value = volume->maxValue();
+    ::WriteHeader( ofs, header );
+
+    const size_t value_size = volume->values().byteSize() / volume->values().size();
+    const size_t node_bytes = value_size * volume->veclen();
+    const size_t slice_bytes = volume->numberOfNodesPerSlice() * node_bytes;
+    const size_t nz = volume->resolution().z();
+    const kvs::UInt8* values = static_cast<const kvs::UInt8*>( volume->values().data() );
+    kvs::ValueArray<kvs::UInt8> brick( brick_size.x() * brick_size.y() * brick_size.z() * node_bytes );
+    for ( size_t k0 = 0; k0 < nz; k0 += brick_size.z() )
+    {
+        const size_t nslices = kvs::Math::Min( size_t( brick_size.z() ), nz - k0 );
+        ::WriteSlab( ofs, values + k0 * slice_bytes, nslices, header, node_bytes, brick );
+    }
+
+    if ( !ofs )
+    {
+        kvsMessageError( "Cannot write %s.", filename.c_str() );
+        return false;
+    }
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Converts a raw volume file to a brick file.
+ *  @param  raw_filename [in] raw filename (x-fastest node values without header)
+ *  @param  type_id [in] value type
+ *  @param  veclen [in] vector length
+ *  @param  resolution [in] node resolution
+ *  @param  filename [in] brick filename
+ *  @param  brick_size [in] number of nodes of a brick along each axis
+ *  @return true, if the conversion is done successfully
+ *
+ *  The raw file is read one slab of brick_size.z() slices at a time, so that
+ *  volumes larger than the main memory can be converted.
+ */
+/*===========================================================================*/
+bool BrickedVolume::Convert(
+    const std::string& raw_filename,
+    const kvs::Type::TypeID type_id,
+    const size_t veclen,
+    const kvs::Vec3ui& resolution,
+    const std::string& filename,
+    const kvs::Vec3ui& brick_size )
+{
+    if ( !::IsValidBrickSize( brick_size ) ) return false;
+
+    std::ifstream ifs( raw_filename.c_str(), std::ios::in | std::ios::binary );
+    if ( !ifs )
+    {
+        kvsMessageError( "Cannot open %s.", raw_filename.c_str() );
+        return false;
+    }
+
+    std::ofstream ofs( filename.c_str(), std::ios::out | std::ios::binary );
+    if ( !ofs )
+    {
+        kvsMessageError( "Cannot open %s.", filename.c_str() );
+        return false;
+    }
+
+    ::Header header;
+    header.type_id = type_id;
+    header.veclen = veclen;
+    for ( size_t i = 0; i < 3; i++ ) header.resolution[i] = resolution[i];
+    for ( size_t i = 0; i < 3; i++ ) header.brick_size[i] = brick_size[i];
+    header.min_value = 0.0;
+    header.max_value = 0.0;
+    ::WriteHeader( ofs, header );
+
+    const size_t nslice_nodes = size_t( resolution.x() ) * resolution.y();
+    const size_t nz = resolution.z();
+    kvs::AnyValueArray slab = ::AllocateValues( type_id, nslice_nodes * brick_size.z() * veclen );
+    if ( slab.empty() )
+    {
+        kvsMessageError( "Unsupported data type." );
+        return false;
+    }
+
+    const size_t node_bytes = slab.byteSize() / slab.size() * veclen;
+    kvs::ValueArray<kvs::UInt8> brick( brick_size.x() * brick_size.y() * brick_size.z() * node_bytes );
+    for ( size_t k0 = 0; k0 < nz; k0 += brick_size.z() )
+    {
+        const size_t nslices = kvs::Math::Min( size_t( brick_size.z() ), nz - k0 );
+        ifs.read( static_cast<char*>( slab.data() ), nslices * nslice_nodes * node_bytes );
+        if ( !ifs )
+        {
+            kvsMessageError( "Cannot read %s.", raw_filename.c_str() );
+            return false;
+        }
+
+        kvs::ValueStatistics statistics;
+        statistics.calculate( slab, veclen );
+        if ( k0 == 0 )
+        {
+            header.min_value = statistics.minValue();
+            header.max_value = statistics.maxValue();
+        }
+        else
+        {
+            header.min_value = kvs::Math::Min( header.min_value, statistics.minValue() );
+            header.max_value = kvs::Math::Max( header.max_value, statistics.maxValue() );
+        }
+
+        ::WriteSlab( ofs, static_cast<const kvs::UInt8*>( slab.data() ), nslices, header, node_bytes, brick );
+    }
+
+    // Rewrite the header with the min/max values.
+    ofs.seekp( 0, std::ios::beg );
+    ::WriteHeader( ofs, header );
+    if ( !ofs )
+    {
+        kvsMessageError( "Cannot write %s.", filename.c_str() );
+        return false;
+    }
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new BrickedVolume class.
+ */
+/*===========================================================================*/
+BrickedVolume::BrickedVolume():
+    m_type_id( kvs::Type::UnknownType ),
+    m_value_size( 0 ),
+    m_veclen( 0 ),
+    m_resolution( 0, 0, 0 ),
+    m_brick_size( 0, 0, 0 ),
+    m_nbricks( 0, 0, 0 ),
+    m_brick_bytes( 0 ),
+    m_min_value( 0.0 ),
+    m_max_value( 0.0 ),
+    m_cache_size( ::DefaultCacheSize ),
+    m_last_id( size_t(-1) ),
+    m_last_data( NULL ),
+    m_nloads( 0 )
+{
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new BrickedVolume class and opens the brick file.
+ *  @param  filename [in] brick filename
+ */
+/*===========================================================================*/
+BrickedVolume::BrickedVolume( const std::string& filename ):
+    m_type_id( kvs::Type::UnknownType ),
+    m_value_size( 0 ),
+    m_veclen( 0 ),
+    m_resolution( 0, 0, 0 ),
+    m_brick_size( 0, 0, 0 ),
+    m_nbricks( 0, 0, 0 ),
+    m_brick_bytes( 0 ),
+    m_min_value( 0.0 ),
+    m_max_value( 0.0 ),
+    m_cache_size( ::DefaultCacheSize ),
+    m_last_id( size_t(-1) ),
+    m_last_data( NULL ),
+    m_nloads( 0 )
+{
+    this->open( filename );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Destroys the BrickedVolume class.
+ */
+/*===========================================================================*/
+BrickedVolume::~BrickedVolume()
+{
+    this->close();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Opens a brick file.
+ *  @param  filename [in] brick filename
+ *  @return true, if the brick file is opened successfully
+ */
+/*===========================================================================*/
+bool BrickedVolume::open( const std::string& filename )
+{
+    this->close();
+
+    m_stream.open( filename.c_str(), std::ios::in | std::ios::binary );
+    if ( !m_stream )
+    {
+        kvsMessageError( "Cannot open %s.", filename.c_str() );
+        return false;
+    }
+
+    ::Header header;
+    if ( !::ReadHeader( m_stream, header ) )
+    {
+        m_stream.close();
+        return false;
+    }
+
+    m_value_size = ::AllocateValues( kvs::Type::TypeID( header.type_id ), 1 ).byteSize();
+    if ( m_value_size == 0 )
+    {
+        kvsMessageError( "Unsupported data type." );
+        m_stream.close();
+        return false;
+    }
+
+    m_filename = filename;
+    m_type_id = kvs::Type::TypeID( header.type_id );
+    m_veclen = header.veclen;
+    m_resolution.set( header.resolution[0], header.resolution[1], header.resolution[2] );
+    m_brick_size.set( header.brick_size[0], header.brick_size[1], header.brick_size[2] );
+    m_nbricks.set(
+        ( m_resolution.x() + m_brick_size.x() - 1 ) / m_brick_size.x(),
+        ( m_resolution.y() + m_brick_size.y() - 1 ) / m_brick_size.y(),
+        ( m_resolution.z() + m_brick_size.z() - 1 ) / m_brick_size.z() );
+    m_brick_bytes = size_t( m_brick_size.x() ) * m_brick_size.y() * m_brick_size.z() * m_veclen * m_value_size;
+    m_min_value = header.min_value;
+    m_max_value = header.max_value;
+    m_table.assign( size_t( m_nbricks.x() ) * m_nbricks.y() * m_nbricks.z(), m_cache.end() );
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Closes the brick file and releases the cached bricks.
+ */
+/*===========================================================================*/
+void BrickedVolume::close()
+{
+    this->clearCache();
+    m_table.clear();
+    if ( m_stream.is_open() ) m_stream.close();
+    m_stream.clear();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sets the memory budget of the brick cache.
+ *  @param  cache_size [in] memory budget in bytes
+ *
+ *  At least one brick is always cached regardless of the budget.
+ */
+/*===========================================================================*/
+void BrickedVolume::setCacheSize( const size_t cache_size )
+{
+    m_cache_size = cache_size;
+
+    const size_t max_bricks = this->max_cached_bricks();
+    while ( m_cache.size() > max_bricks )
+    {
+        m_table[ m_cache.back().id ] = m_cache.end();
+        m_cache.pop_back();
+    }
+
+    m_last_id = size_t(-1);
+    m_last_data = NULL;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Releases the cached bricks.
+ */
+/*===========================================================================*/
+void BrickedVolume::clearCache() const
+{
+    m_cache.clear();
+    std::fill( m_table.begin(), m_table.end(), m_cache.end() );
+    m_last_id = size_t(-1);
+    m_last_data = NULL;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns an empty value array of the value type.
+ *  @return empty value array
+ */
+/*===========================================================================*/
+kvs::AnyValueArray BrickedVolume::emptyValues() const
+{
+    return ::AllocateValues( m_type_id, 0 );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the max. number of the cached bricks.
+ *  @return number of bricks
+ */
+/*===========================================================================*/
+size_t BrickedVolume::max_cached_bricks() const
+{
+    return m_brick_bytes > 0 ? kvs::Math::Max( size_t(1), m_cache_size / m_brick_bytes ) : 1;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the values of the brick, loading it if necessary.
+ *  @param  id [in] brick index
+ *  @return pointer to the brick values
+ */
+/*===========================================================================*/
+const kvs::UInt8* BrickedVolume::load_brick( const size_t id ) const
+{
+    KVS_ASSERT( id < m_table.size() );
+
+    BrickList::iterator brick = m_table[ id ];
+    if ( brick != m_cache.end() )
+    {
+        // Cache hit: move the brick to the front of the list.
+        m_cache.splice( m_cache.begin(), m_cache, brick );
+    }
+    else
+    {
+        if ( m_cache.size() < this->max_cached_bricks() )
+        {
+            m_cache.push_front( Brick() );
+            m_cache.front().data.allocate( m_brick_bytes );
+        }
+        else
+        {
+            // Reuse the buffer of the least recently used brick.
+            m_table[ m_cache.back().id ] = m_cache.end();
+            m_cache.splice( m_cache.begin(), m_cache, --m_cache.end() );
+        }
+
+        brick = m_cache.begin();
+        brick->id = id;
+        m_table[ id ] = brick;
+
+        m_stream.clear();
+        m_stream.seekg( ::HeaderSize + std::streamoff( id ) * std::streamoff( m_brick_bytes ), std::ios::beg );
+        m_stream.read( reinterpret_cast<char*>( brick->data.data() ), m_brick_bytes );
+        if ( !m_stream )
+        {
+            kvsMessageError( "Cannot read the brick #%lu from %s.", static_cast<unsigned long>( id ), m_filename.c_str() );
+            brick->data.fill( 0 );
+        }
+
+        m_nloads++;
+    }
+
+    m_last_id = id;
+    m_last_data = brick->data.data();
+    return m_last_data;
+}
+
+} // end of namespace kvs
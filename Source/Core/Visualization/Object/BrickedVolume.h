@@ -0,0 +1,177 @@
+/*****************************************************************************/
+/**
+ *  @file   BrickedVolume.h
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#ifndef KVS__BRICKED_VOLUME_H_INCLUDE
+#define KVS__BRICKED_VOLUME_H_INCLUDE
+
+#include <list>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <kvs/Type>
+#include <kvs/ValueArray>
+#include <kvs/Vector3>
+#include <kvs/Noncopyable>
+#include <kvs/AnyValueArray>
+#include <kvs/Assert>
+
+
+namespace kvs
+{
+
+class StructuredVolumeObject;
+
+/*===========================================================================*/
+/**
+ *  @brief  Out-of-core node values of a structured volume.
+ *
+ *  The node values are stored in a brick file (*.kvsbrick) as fixed-size
+ *  bricks, each of which is padded to the full brick size so that a brick
+ *  can be located by its index alone. The bricks are read on demand and
+ *  kept in a LRU cache bounded by a memory budget. The cache is not
+ *  thread-safe; a bricked volume must be accessed by a single thread.
+ */
+/*===========================================================================*/
+class BrickedVolume : private kvs::Noncopyable
+{
+private:
+
+    struct Brick
+    {
+        size_t id; ///< brick index
+        kvs::ValueArray<kvs::UInt8> data; ///< brick values
+    };
+
+    typedef std::list<Brick> BrickList;
+
+    std::string m_filename; ///< brick filename
+    mutable std::ifstream m_stream; ///< input stream of the brick file
+    kvs::Type::TypeID m_type_id; ///< value type
+    size_t m_value_size; ///< byte size of a value
+    size_t m_veclen; ///< vector length
+    kvs::Vec3ui m_resolution; ///< node resolution
+    kvs::Vec3ui m_brick_size; ///< number of nodes of a brick along each axis
+    kvs::Vec3ui m_nbricks; ///< number of bricks along each axis
+    size_t m_brick_bytes; ///< byte size of a brick
+    kvs::Real64 m_min_value; ///< min. value
+    kvs::Real64 m_max_value; ///< max. value
+    size_t m_cache_size; ///< memory budget of the brick cache in bytes
+    mutable BrickList m_cache; ///< cached bricks (most recently used first)
+    mutable std::vector<BrickList::iterator> m_table; ///< cached brick for each brick index
+    mutable size_t m_last_id; ///< index of the last accessed brick
+    mutable const kvs::UInt8* m_last_data; ///< values of the last accessed brick
+    mutable size_t m_nloads; ///< number of brick loads
+
+public:
+
+    static const std::string Extension;
+    static bool Write(
+        const std::string& filename,
+        const kvs::StructuredVolumeObject* volume,
+        const kvs::Vec3ui& brick_size = kvs::Vec3ui::All( 32 ) );
+    static bool Convert(
+        const std::string& raw_filename,
+        const kvs::Type::TypeID type_id,
+        const size_t veclen,
+        const kvs::Vec3ui& resolution,
+        const std::string& filename,
+        const kvs::Vec3ui& brick_size = kvs::Vec3ui::All( 32 ) );
+
+public:
+
+    BrickedVolume();
+    BrickedVolume( const std::string& filename );
+    ~BrickedVolume();
+
+    bool open( const std::string& filename );
+    void close();
+    bool isOpen() const { return m_stream.is_open(); }
+
+    void setCacheSize( const size_t cache_size );
+    void clearCache() const;
+
+    const std::string& filename() const { return m_filename; }
+    kvs::Type::TypeID typeID() const { return m_type_id; }
+    size_t veclen() const { return m_veclen; }
+    const kvs::Vec3ui& resolution() const { return m_resolution; }
+    const kvs::Vec3ui& brickSize() const { return m_brick_size; }
+    const kvs::Vec3ui& numberOfBricks() const { return m_nbricks; }
+    size_t brickByteSize() const { return m_brick_bytes; }
+    kvs::Real64 minValue() const { return m_min_value; }
+    kvs::Real64 maxValue() const { return m_max_value; }
+    size_t cacheSize() const { return m_cache_size; }
+    size_t numberOfCachedBricks() const { return m_cache.size(); }
+    size_t numberOfLoads() const { return m_nloads; }
+    kvs::AnyValueArray emptyValues() const;
+
+    template <typename T>
+    T value( const size_t i, const size_t j, const size_t k, const size_t c = 0 ) const;
+    template <typename T>
+    T value( const size_t index ) const;
+
+private:
+
+    size_t max_cached_bricks() const;
+    const kvs::UInt8* load_brick( const size_t id ) const;
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the node value at the specified grid point.
+ *  @param  i [in] grid index along the x-axis
+ *  @param  j [in] grid index along the y-axis
+ *  @param  k [in] grid index along the z-axis
+ *  @param  c [in] vector component
+ *  @return node value
+ */
+/*===========================================================================*/
+template <typename T>
+inline T BrickedVolume::value( const size_t i, const size_t j, const size_t k, const size_t c ) const
+{
+    KVS_ASSERT( kvs::Type::GetID<T>() == m_type_id );
+
+    const size_t bi = i / m_brick_size.x();
+    const size_t bj = j / m_brick_size.y();
+    const size_t bk = k / m_brick_size.z();
+    const size_t id = bi + m_nbricks.x() * ( bj + m_nbricks.y() * bk );
+    const kvs::UInt8* data = ( id == m_last_id ) ? m_last_data : this->load_brick( id );
+
+    const size_t li = i - bi * m_brick_size.x();
+    const size_t lj = j - bj * m_brick_size.y();
+    const size_t lk = k - bk * m_brick_size.z();
+    const size_t offset = ( ( lk * m_brick_size.y() + lj ) * m_brick_size.x() + li ) * m_veclen + c;
+    return reinterpret_cast<const T*>( data )[ offset ];
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the value at the specified index of the value array.
+ *  @param  index [in] index of the (in-core) value array
+ *  @return value
+ */
+/*===========================================================================*/
+template <typename T>
+inline T BrickedVolume::value( const size_t index ) const
+{
+    const size_t node = index / m_veclen;
+    const size_t line = node / m_resolution.x();
+    return this->value<T>(
+        node - line * m_resolution.x(),
+        line % m_resolution.y(),
+        line / m_resolution.y(),
+        index - node * m_veclen );
+}
+
+} // end of namespace kvs
+
+#endif // KVS__BRICKED_VOLUME_H_INCLUDE
@@ -72,9 +72,9 @@ public:
     void setColor( const kvs::RGBColor& color );
 
     GeometryType geometryType() const { return m_geometry_type; }
-    size_t numberOfVertices() const;
-    size_t numberOfColors() const;
-    size_t numberOfNormals() const;
+    virtual size_t numberOfVertices() const;
+    virtual size_t numberOfColors() const;
+    virtual size_t numberOfNormals() const;
 
     const kvs::ValueArray<kvs::Real32>& coords() const { return m_coords; }
     const kvs::ValueArray<kvs::UInt8>& colors() const { return m_colors; }
@@ -17,6 +17,112 @@
 #include <kvs/LineObject>
 #include <kvs/PolygonObject>
 #include <kvs/Assert>
+#include <kvs/Math>
+
+
+namespace
+{
+
+const kvs::UInt32 MaxQuantizedValue = 65535;
+const size_t MaxPaletteSize = 256;
+const size_t PaletteTableSize = 1024;
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the sign of the value (zero is regarded as positive).
+ *  @param  value [in] value
+ *  @return 1 or -1
+ */
+/*===========================================================================*/
+inline float SignNotZero( const float value )
+{
+    return value < 0.0f ? -1.0f : 1.0f;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the scale from the quantized value to the coordinate.
+ *  @param  min_coord [in] min. coordinate
+ *  @param  max_coord [in] max. coordinate
+ *  @return coordinate step of the quantized value along each axis
+ */
+/*===========================================================================*/
+kvs::Vec3 QuantizationScale( const kvs::Vec3& min_coord, const kvs::Vec3& max_coord )
+{
+    const float inv = 1.0f / ::MaxQuantizedValue;
+    return kvs::Vec3(
+        ( max_coord.x() - min_coord.x() ) * inv,
+        ( max_coord.y() - min_coord.y() ) * inv,
+        ( max_coord.z() - min_coord.z() ) * inv );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Quantizes a coordinate value.
+ *  @param  value [in] coordinate value
+ *  @param  offset [in] coordinate of the quantized value 0
+ *  @param  scale [in] coordinate step of the quantized value
+ *  @return quantized value
+ */
+/*===========================================================================*/
+inline kvs::UInt16 Quantize( const float value, const float offset, const float scale )
+{
+    if ( !( scale > 0.0f ) ) return 0;
+    const float q = ( value - offset ) / scale + 0.5f;
+    return static_cast<kvs::UInt16>( kvs::Math::Clamp( q, 0.0f, static_cast<float>( ::MaxQuantizedValue ) ) );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Creates the color palette and the color indices.
+ *  @param  colors [in] color (r,g,b) array
+ *  @param  indices [out] color index array
+ *  @param  palette [out] color palette
+ *  @return true if the number of the distinct colors is not more than 256
+ */
+/*===========================================================================*/
+bool CreatePalette(
+    const kvs::ValueArray<kvs::UInt8>& colors,
+    kvs::ValueArray<kvs::UInt8>* indices,
+    kvs::ValueArray<kvs::UInt8>* palette )
+{
+    // Open-addressing table from the 24-bit color to the palette index.
+    kvs::UInt32 keys[ ::PaletteTableSize ];
+    int values[ ::PaletteTableSize ];
+    for ( size_t i = 0; i < ::PaletteTableSize; i++ ) { values[i] = -1; }
+
+    const size_t ncolors = colors.size() / 3;
+    kvs::ValueArray<kvs::UInt8> color_indices( ncolors );
+    kvs::UInt8 color_palette[ ::MaxPaletteSize * 3 ];
+    size_t npalettes = 0;
+
+    const kvs::UInt8* rgb = colors.data();
+    for ( size_t i = 0; i < ncolors; i++, rgb += 3 )
+    {
+        const kvs::UInt32 key = ( rgb[0] << 16 ) | ( rgb[1] << 8 ) | rgb[2];
+        size_t slot = ( ( key * 2654435761u ) >> 16 ) & ( ::PaletteTableSize - 1 );
+        while ( values[ slot ] >= 0 && keys[ slot ] != key ) { slot = ( slot + 1 ) & ( ::PaletteTableSize - 1 ); }
+
+        if ( values[ slot ] < 0 )
+        {
+            if ( npalettes == ::MaxPaletteSize ) return false;
+            keys[ slot ] = key;
+            values[ slot ] = static_cast<int>( npalettes );
+            color_palette[ npalettes * 3 + 0 ] = rgb[0];
+            color_palette[ npalettes * 3 + 1 ] = rgb[1];
+            color_palette[ npalettes * 3 + 2 ] = rgb[2];
+            npalettes++;
+        }
+
+        color_indices[i] = static_cast<kvs::UInt8>( values[ slot ] );
+    }
+
+    *indices = color_indices;
+    *palette = kvs::ValueArray<kvs::UInt8>( color_palette, npalettes * 3 );
+    return true;
+}
+
+} // end of namespace
 
 
 namespace kvs
@@ -108,6 +214,20 @@ PointObject::PointObject( const kvs::PolygonObject& polygon )
 /*===========================================================================*/
 void PointObject::add( const PointObject& other )
 {
+    if ( this->isCompact() || other.isCompact() )
+    {
+        // The compact objects are integrated in the expanded representation.
+        kvs::PointObject expanded;
+        expanded.shallowCopy( other );
+        expanded.expand();
+
+        const bool compact = this->isCompact();
+        this->expand();
+        this->add( expanded );
+        if ( compact ) { this->compact(); }
+        return;
+    }
+
     if ( this->coords().size() == 0 )
     {
         // Copy the object.
@@ -362,6 +482,12 @@ void PointObject::shallowCopy( const PointObject& other )
 {
     BaseClass::shallowCopy( other );
     m_sizes = other.sizes();
+    m_quantized_coords = other.quantizedCoords();
+    m_encoded_normals = other.encodedNormals();
+    m_color_indices = other.colorIndices();
+    m_color_palette = other.colorPalette();
+    m_coord_offset = other.coordOffset();
+    m_coord_scale = other.coordScale();
 }
 
 /*===========================================================================*/
@@ -374,6 +500,12 @@ void PointObject::deepCopy( const PointObject& other )
 {
     BaseClass::deepCopy( other );
     m_sizes = other.sizes().clone();
+    m_quantized_coords = other.quantizedCoords().clone();
+    m_encoded_normals = other.encodedNormals().clone();
+    m_color_indices = other.colorIndices().clone();
+    m_color_palette = other.colorPalette().clone();
+    m_coord_offset = other.coordOffset();
+    m_coord_scale = other.coordScale();
 }
 
 /*===========================================================================*/
@@ -385,6 +517,10 @@ void PointObject::clear()
 {
     BaseClass::clear();
     m_sizes.release();
+    m_quantized_coords.release();
+    m_encoded_normals.release();
+    m_color_indices.release();
+    m_color_palette.release();
 }
 
 /*===========================================================================*/
@@ -399,6 +535,12 @@ void PointObject::print( std::ostream& os, const kvs::Indent& indent ) const
     os << indent << "Object type : " << "point object" << std::endl;
     BaseClass::print( os, indent );
     os << indent << "Number of sizes : " << this->numberOfSizes() << std::endl;
+    if ( this->isCompact() )
+    {
+        os << indent << "Number of quantized vertices : " << this->numberOfVertices() << std::endl;
+        os << indent << "Number of encoded normals : " << m_encoded_normals.size() << std::endl;
+        os << indent << "Number of palette colors : " << m_color_palette.size() / 3 << std::endl;
+    }
 }
 
 /*===========================================================================*/
@@ -413,6 +555,201 @@ void PointObject::setSize( const kvs::Real32 size )
     m_sizes[0] = size;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Sets the quantized coordinate array.
+ *  @param  coords [in] quantized coordinate array
+ *  @param  min_coord [in] coordinate of the quantized value 0
+ *  @param  max_coord [in] coordinate of the quantized value 65535
+ */
+/*===========================================================================*/
+void PointObject::setQuantizedCoords(
+    const kvs::ValueArray<kvs::UInt16>& coords,
+    const kvs::Vec3& min_coord,
+    const kvs::Vec3& max_coord )
+{
+    m_quantized_coords = coords;
+    m_coord_offset = min_coord;
+    m_coord_scale = ::QuantizationScale( min_coord, max_coord );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sets the color index array and the color palette.
+ *  @param  indices [in] color index array
+ *  @param  palette [in] color palette (r,g,b)
+ */
+/*===========================================================================*/
+void PointObject::setColorIndices(
+    const kvs::ValueArray<kvs::UInt8>& indices,
+    const kvs::ValueArray<kvs::UInt8>& palette )
+{
+    m_color_indices = indices;
+    m_color_palette = palette;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Encodes the normal vector to 16 bits by the octahedral mapping.
+ *  @param  normal [in] normal vector
+ *  @return encoded normal vector (u in the lower 8 bits, v in the upper 8 bits)
+ */
+/*===========================================================================*/
+kvs::UInt16 PointObject::EncodeNormal( const kvs::Vec3& normal )
+{
+    const float l1 = kvs::Math::Abs( normal.x() ) + kvs::Math::Abs( normal.y() ) + kvs::Math::Abs( normal.z() );
+    if ( !( l1 > 0.0f ) ) return PointObject::EncodeNormal( kvs::Vec3( 0.0f, 0.0f, 1.0f ) );
+
+    float u = normal.x() / l1;
+    float v = normal.y() / l1;
+    if ( normal.z() < 0.0f )
+    {
+        const float x = u;
+        u = ( 1.0f - kvs::Math::Abs( v ) ) * ::SignNotZero( x );
+        v = ( 1.0f - kvs::Math::Abs( x ) ) * ::SignNotZero( v );
+    }
+
+    const kvs::UInt16 qu = static_cast<kvs::UInt16>( ( u * 0.5f + 0.5f ) * 255.0f + 0.5f );
+    const kvs::UInt16 qv = static_cast<kvs::UInt16>( ( v * 0.5f + 0.5f ) * 255.0f + 0.5f );
+    return static_cast<kvs::UInt16>( qu | ( qv << 8 ) );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Decodes the normal vector encoded by EncodeNormal().
+ *  @param  code [in] encoded normal vector
+ *  @return normal vector (unit length)
+ */
+/*===========================================================================*/
+kvs::Vec3 PointObject::DecodeNormal( const kvs::UInt16 code )
+{
+    float x = ( code & 0xff ) * ( 2.0f / 255.0f ) - 1.0f;
+    float y = ( code >> 8 ) * ( 2.0f / 255.0f ) - 1.0f;
+    const float z = 1.0f - kvs::Math::Abs( x ) - kvs::Math::Abs( y );
+    if ( z < 0.0f )
+    {
+        const float u = x;
+        x = ( 1.0f - kvs::Math::Abs( y ) ) * ::SignNotZero( u );
+        y = ( 1.0f - kvs::Math::Abs( u ) ) * ::SignNotZero( y );
+    }
+
+    return kvs::Vec3( x, y, z ).normalized();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Converts the point object to the compact representation.
+ *
+ *  The coordinates are quantized in the bounding box (min/max object
+ *  coordinates), and the normal vectors are encoded. The per-vertex colors
+ *  are converted to the palette indices if the number of the distinct
+ *  colors is 256 or less; otherwise they are kept as they are. The float
+ *  arrays are released.
+ */
+/*===========================================================================*/
+void PointObject::compact()
+{
+    const size_t nvertices = BaseClass::numberOfVertices();
+    if ( nvertices == 0 ) return;
+
+    if ( !BaseClass::hasMinMaxObjectCoords() ) BaseClass::updateMinMaxCoords();
+    const kvs::Vec3 min_coord = BaseClass::minObjectCoord();
+    const kvs::Vec3 max_coord = BaseClass::maxObjectCoord();
+    const kvs::Vec3 scale = ::QuantizationScale( min_coord, max_coord );
+
+    // Coordinates.
+    kvs::ValueArray<kvs::UInt16> quantized_coords( nvertices * 3 );
+    const kvs::Real32* coord = BaseClass::coords().data();
+    kvs::UInt16* q = quantized_coords.data();
+    for ( size_t i = 0; i < nvertices; i++, coord += 3, q += 3 )
+    {
+        q[0] = ::Quantize( coord[0], min_coord.x(), scale.x() );
+        q[1] = ::Quantize( coord[1], min_coord.y(), scale.y() );
+        q[2] = ::Quantize( coord[2], min_coord.z(), scale.z() );
+    }
+    this->setQuantizedCoords( quantized_coords, min_coord, max_coord );
+    BaseClass::setCoords( kvs::ValueArray<kvs::Real32>() );
+
+    // Normal vectors.
+    if ( BaseClass::numberOfNormals() == nvertices )
+    {
+        kvs::ValueArray<kvs::UInt16> encoded_normals( nvertices );
+        const kvs::Real32* normal = BaseClass::normals().data();
+        for ( size_t i = 0; i < nvertices; i++, normal += 3 )
+        {
+            encoded_normals[i] = EncodeNormal( kvs::Vec3( normal ) );
+        }
+        m_encoded_normals = encoded_normals;
+        BaseClass::setNormals( kvs::ValueArray<kvs::Real32>() );
+    }
+
+    // Colors.
+    if ( BaseClass::numberOfColors() == nvertices && nvertices > 1 )
+    {
+        kvs::ValueArray<kvs::UInt8> indices;
+        kvs::ValueArray<kvs::UInt8> palette;
+        if ( ::CreatePalette( BaseClass::colors(), &indices, &palette ) )
+        {
+            this->setColorIndices( indices, palette );
+            BaseClass::setColors( kvs::ValueArray<kvs::UInt8>() );
+        }
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Converts the compact point object to the float coordinates,
+ *          the float normal vectors and the RGB colors.
+ */
+/*===========================================================================*/
+void PointObject::expand()
+{
+    const size_t nvertices = this->numberOfVertices();
+
+    if ( m_quantized_coords.size() > 0 )
+    {
+        kvs::ValueArray<kvs::Real32> coords( nvertices * 3 );
+        for ( size_t i = 0; i < nvertices; i++ )
+        {
+            const kvs::Vec3 coord = this->coord( i );
+            coords[ 3 * i + 0 ] = coord.x();
+            coords[ 3 * i + 1 ] = coord.y();
+            coords[ 3 * i + 2 ] = coord.z();
+        }
+        BaseClass::setCoords( coords );
+        m_quantized_coords.release();
+    }
+
+    if ( m_encoded_normals.size() > 0 )
+    {
+        kvs::ValueArray<kvs::Real32> normals( m_encoded_normals.size() * 3 );
+        for ( size_t i = 0; i < m_encoded_normals.size(); i++ )
+        {
+            const kvs::Vec3 normal = DecodeNormal( m_encoded_normals[i] );
+            normals[ 3 * i + 0 ] = normal.x();
+            normals[ 3 * i + 1 ] = normal.y();
+            normals[ 3 * i + 2 ] = normal.z();
+        }
+        BaseClass::setNormals( normals );
+        m_encoded_normals.release();
+    }
+
+    if ( m_color_indices.size() > 0 )
+    {
+        kvs::ValueArray<kvs::UInt8> colors( m_color_indices.size() * 3 );
+        for ( size_t i = 0; i < m_color_indices.size(); i++ )
+        {
+            const kvs::UInt8* rgb = m_color_palette.data() + 3 * m_color_indices[i];
+            colors[ 3 * i + 0 ] = rgb[0];
+            colors[ 3 * i + 1 ] = rgb[1];
+            colors[ 3 * i + 2 ] = rgb[2];
+        }
+        BaseClass::setColors( colors );
+        m_color_indices.release();
+        m_color_palette.release();
+    }
+}
+
 /*===========================================================================*/
 /**
  *  @brief  '<<' operator
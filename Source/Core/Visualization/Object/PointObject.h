@@ -35,6 +35,14 @@ class PolygonObject;
 /*==========================================================================*/
 /**
  *  Point object class.
+ *
+ *  The point object can be compacted for a large number of particles. The
+ *  compact point object has the coordinates quantized to 16 bits in the
+ *  bounding box, the normal vectors encoded to 16 bits by the octahedral
+ *  mapping and the colors as 8-bit indices to a palette (if the number of
+ *  distinct colors is 256 or less), instead of the float coordinates, the
+ *  float normal vectors and the RGB colors. coord(), normal() and color()
+ *  return the decoded values in either representation.
  */
 /*==========================================================================*/
 class PointObject : public kvs::GeometryObjectBase
@@ -45,6 +53,17 @@ class PointObject : public kvs::GeometryObjectBase
 private:
 
     kvs::ValueArray<kvs::Real32> m_sizes; ///< size array
+    kvs::ValueArray<kvs::UInt16> m_quantized_coords; ///< quantized coordinate array
+    kvs::ValueArray<kvs::UInt16> m_encoded_normals; ///< octahedral-encoded normal array
+    kvs::ValueArray<kvs::UInt8> m_color_indices; ///< color index array
+    kvs::ValueArray<kvs::UInt8> m_color_palette; ///< color palette (r,g,b)
+    kvs::Vec3 m_coord_offset; ///< coordinate of the quantized value 0
+    kvs::Vec3 m_coord_scale; ///< coordinate step of the quantized value
+
+public:
+
+    static kvs::UInt16 EncodeNormal( const kvs::Vec3& normal );
+    static kvs::Vec3 DecodeNormal( const kvs::UInt16 code );
 
 public:
 
@@ -60,11 +79,36 @@ public:
 
     void setSizes( const kvs::ValueArray<kvs::Real32>& sizes ) { m_sizes = sizes; }
     void setSize( const kvs::Real32 size );
+    void setQuantizedCoords(
+        const kvs::ValueArray<kvs::UInt16>& coords,
+        const kvs::Vec3& min_coord,
+        const kvs::Vec3& max_coord );
+    void setEncodedNormals( const kvs::ValueArray<kvs::UInt16>& normals ) { m_encoded_normals = normals; }
+    void setColorIndices( const kvs::ValueArray<kvs::UInt8>& indices, const kvs::ValueArray<kvs::UInt8>& palette );
+
+    void compact();
+    void expand();
+    bool isCompact() const;
+    bool hasQuantizedCoords() const { return m_quantized_coords.size() > 0; }
+    bool hasEncodedNormals() const { return m_encoded_normals.size() > 0; }
+    bool hasColorIndices() const { return m_color_indices.size() > 0; }
 
+    size_t numberOfVertices() const;
+    size_t numberOfColors() const;
+    size_t numberOfNormals() const;
     size_t numberOfSizes() const { return m_sizes.size(); }
 
+    const kvs::Vec3 coord( const size_t index = 0 ) const;
+    const kvs::Vec3 normal( const size_t index = 0 ) const;
+    const kvs::RGBColor color( const size_t index = 0 ) const;
     kvs::Real32 size( const size_t index = 0 ) const { return m_sizes[index]; }
     const kvs::ValueArray<kvs::Real32>& sizes() const { return m_sizes; }
+    const kvs::ValueArray<kvs::UInt16>& quantizedCoords() const { return m_quantized_coords; }
+    const kvs::ValueArray<kvs::UInt16>& encodedNormals() const { return m_encoded_normals; }
+    const kvs::ValueArray<kvs::UInt8>& colorIndices() const { return m_color_indices; }
+    const kvs::ValueArray<kvs::UInt8>& colorPalette() const { return m_color_palette; }
+    const kvs::Vec3& coordOffset() const { return m_coord_offset; }
+    const kvs::Vec3& coordScale() const { return m_coord_scale; }
 
 public:
     KVS_DEPRECATED( PointObject(
@@ -193,6 +237,100 @@ public:
     KVS_DEPRECATED( friend std::ostream& operator << ( std::ostream& os, const PointObject& object ) );
 };
 
+/*===========================================================================*/
+/**
+ *  @brief  Checks whether the point object has any compact array.
+ *  @return true if the coordinates, the normal vectors or the colors are compact
+ *
+ *  The renderers that read the float arrays directly have to draw an
+ *  expanded copy of the compact point object.
+ */
+/*===========================================================================*/
+inline bool PointObject::isCompact() const
+{
+    return m_quantized_coords.size() > 0 || m_encoded_normals.size() > 0 || m_color_indices.size() > 0;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the number of the vertices.
+ *  @return number of the vertices
+ */
+/*===========================================================================*/
+inline size_t PointObject::numberOfVertices() const
+{
+    if ( m_quantized_coords.size() > 0 ) return m_quantized_coords.size() / 3;
+    return BaseClass::numberOfVertices();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the number of the colors.
+ *  @return number of the colors
+ */
+/*===========================================================================*/
+inline size_t PointObject::numberOfColors() const
+{
+    if ( m_color_indices.size() > 0 ) return m_color_indices.size();
+    return BaseClass::numberOfColors();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the number of the normal vectors.
+ *  @return number of the normal vectors
+ */
+/*===========================================================================*/
+inline size_t PointObject::numberOfNormals() const
+{
+    if ( m_encoded_normals.size() > 0 ) return m_encoded_normals.size();
+    return BaseClass::numberOfNormals();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the coordinate value.
+ *  @param  index [in] index of the coordinate value
+ *  @return coordinate value
+ */
+/*===========================================================================*/
+inline const kvs::Vec3 PointObject::coord( const size_t index ) const
+{
+    if ( m_quantized_coords.size() == 0 ) return BaseClass::coord( index );
+
+    const kvs::UInt16* q = m_quantized_coords.data() + 3 * index;
+    return kvs::Vec3(
+        m_coord_offset.x() + m_coord_scale.x() * q[0],
+        m_coord_offset.y() + m_coord_scale.y() * q[1],
+        m_coord_offset.z() + m_coord_scale.z() * q[2] );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the normal vector.
+ *  @param  index [in] index of the normal vector
+ *  @return normal vector (unit length if encoded)
+ */
+/*===========================================================================*/
+inline const kvs::Vec3 PointObject::normal( const size_t index ) const
+{
+    if ( m_encoded_normals.size() == 0 ) return BaseClass::normal( index );
+    return DecodeNormal( m_encoded_normals[ index ] );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the color value.
+ *  @param  index [in] index of the color value
+ *  @return color value
+ */
+/*===========================================================================*/
+inline const kvs::RGBColor PointObject::color( const size_t index ) const
+{
+    if ( m_color_indices.size() == 0 ) return BaseClass::color( index );
+    return kvs::RGBColor( m_color_palette.data() + 3 * m_color_indices[ index ] );
+}
+
 } // end of namespace kvs
 
 #endif // KVS__POINT_OBJECT_H_INCLUDE
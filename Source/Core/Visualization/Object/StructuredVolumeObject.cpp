@@ -13,6 +13,7 @@
  */
 /****************************************************************************/
 #include "StructuredVolumeObject.h"
+#include <kvs/Message>
 
 
 namespace
@@ -59,6 +60,7 @@ void StructuredVolumeObject::shallowCopy( const StructuredVolumeObject& object )
     BaseClass::shallowCopy( object );
     this->m_grid_type = object.gridType();
     this->m_resolution = object.resolution();
+    this->m_bricked_values = object.brickedValues();
 }
 
 /*===========================================================================*/
@@ -72,6 +74,7 @@ void StructuredVolumeObject::deepCopy( const StructuredVolumeObject& object )
     BaseClass::deepCopy( object );
     this->m_grid_type = object.gridType();
     this->m_resolution = object.resolution();
+    this->m_bricked_values = object.brickedValues();
 }
 
 /*===========================================================================*/
@@ -93,6 +96,39 @@ void StructuredVolumeObject::print( std::ostream& os, const kvs::Indent& indent
     os << indent << "Max. value : " << this->maxValue() << std::endl;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Sets the out-of-core node values.
+ *  @param  bricked_values [in] bricked values (NULL to detach)
+ *  @return true, if the bricked values are attached successfully
+ *
+ *  The resolution, the vector length and the min/max values are taken from
+ *  the brick file, and the in-core value array is replaced with an empty
+ *  array of the same value type. The values can then be read with
+ *  ValueAccessor. Since the bricks are shared, deepCopy() shares them, too.
+ */
+/*===========================================================================*/
+bool StructuredVolumeObject::setBrickedValues( const BrickedValues& bricked_values )
+{
+    m_bricked_values = bricked_values;
+    if ( !bricked_values.get() ) return true;
+
+    if ( !bricked_values->isOpen() )
+    {
+        kvsMessageError( "The brick file is not opened." );
+        m_bricked_values.reset();
+        return false;
+    }
+
+    if ( m_grid_type == UnknownGridType ) this->setGridType( Uniform );
+    this->setResolution( bricked_values->resolution() );
+    this->setVeclen( bricked_values->veclen() );
+    this->setValues( bricked_values->emptyValues() );
+    this->setMinMaxValues( bricked_values->minValue(), bricked_values->maxValue() );
+
+    return true;
+}
+
 /*==========================================================================*/
 /**
  *  @brief  Returns the number of nodes per line.
@@ -20,6 +20,8 @@
 #include <kvs/VolumeObjectBase>
 #include <kvs/Indent>
 #include <kvs/Deprecated>
+#include <kvs/SharedPointer>
+#include <kvs/BrickedVolume>
 
 
 namespace kvs
@@ -45,10 +47,16 @@ public:
         Curvilinear,         ///< Curvilinear grid.
     };
 
+    typedef kvs::SharedPointer<kvs::BrickedVolume> BrickedValues;
+
+    template <typename T>
+    class ValueAccessor;
+
 private:
 
     GridType m_grid_type; ///< grid type
     kvs::Vec3ui m_resolution; ///< Node resolution.
+    BrickedValues m_bricked_values; ///< out-of-core node values
 
 public:
 
@@ -63,9 +71,12 @@ public:
     void setGridTypeToRectilinear() { this->setGridType( Rectilinear ); }
     void setGridTypeToCurvilinear() { this->setGridType( Curvilinear ); }
     void setResolution( const kvs::Vec3ui& resolution ) { m_resolution = resolution; }
+    bool setBrickedValues( const BrickedValues& bricked_values );
 
     GridType gridType() const { return m_grid_type; }
     const kvs::Vec3ui& resolution() const { return m_resolution; }
+    bool isBricked() const { return m_bricked_values.get() != NULL; }
+    const BrickedValues& brickedValues() const { return m_bricked_values; }
     size_t numberOfNodesPerLine() const;
     size_t numberOfNodesPerSlice() const;
     size_t numberOfNodes() const;
@@ -111,6 +122,34 @@ public:
     KVS_DEPRECATED( friend std::ostream& operator << ( std::ostream& os, const StructuredVolumeObject& object ) );
 };
 
+/*===========================================================================*/
+/**
+ *  @brief  Read-only access to the node values of the structured volume.
+ *
+ *  The values are read from the in-core value array, or through the brick
+ *  cache if the volume is bricked. T must be the value type of the volume.
+ */
+/*===========================================================================*/
+template <typename T>
+class StructuredVolumeObject::ValueAccessor
+{
+private:
+
+    const T* m_values; ///< in-core values (NULL if bricked)
+    const kvs::BrickedVolume* m_bricked_values; ///< out-of-core values
+
+public:
+
+    ValueAccessor( const kvs::StructuredVolumeObject* volume ):
+        m_values( volume->isBricked() ? NULL : static_cast<const T*>( volume->values().data() ) ),
+        m_bricked_values( volume->brickedValues().get() ) {}
+
+    T operator []( const size_t index ) const
+    {
+        return m_values ? m_values[ index ] : m_bricked_values->value<T>( index );
+    }
+};
+
 } // end of namespace kvs
 
 #endif // KVS__STRUCTURED_VOLUME_OBJECT_H_INCLUDE
@@ -15,6 +15,130 @@
 #include "TableObject.h"
 #include <kvs/Value>
 #include <kvs/Math>
+#include <kvs/ValueStatistics>
+#include <algorithm>
+#include <utility>
+
+
+namespace
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Sorts the row indices by the values.
+ *  @param  values [in] pointer to the values
+ *  @param  nvalues [in] number of values
+ *  @param  rows [out] sorted row indices
+ *
+ *  The pairs of the value and the row index are sorted, which is faster
+ *  than sorting the row indices by referring to the values.
+ */
+/*===========================================================================*/
+template <typename T>
+void SortRows( const T* values, const size_t nvalues, kvs::UInt32* rows )
+{
+    std::vector< std::pair<T,kvs::UInt32> > pairs( nvalues );
+    for ( size_t i = 0; i < nvalues; i++ ) pairs[i] = std::make_pair( values[i], static_cast<kvs::UInt32>( i ) );
+    std::sort( pairs.begin(), pairs.end() );
+    for ( size_t i = 0; i < nvalues; i++ ) rows[i] = pairs[i].second;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Finds the sorted rows whose values are inside the range.
+ *  @param  values [in] pointer to the values
+ *  @param  rows [in] sorted row indices
+ *  @param  nrows [in] number of rows
+ *  @param  min_range [in] min. range
+ *  @param  max_range [in] max. range
+ *  @param  begin [out] first position of the rows inside the range
+ *  @param  end [out] position after the last row inside the range
+ */
+/*===========================================================================*/
+template <typename T>
+void FindRows(
+    const T* values,
+    const kvs::UInt32* rows,
+    const size_t nrows,
+    const kvs::Real64 min_range,
+    const kvs::Real64 max_range,
+    size_t* begin,
+    size_t* end )
+{
+    // First position of value >= min_range.
+    size_t lower = 0;
+    size_t upper = nrows;
+    while ( lower < upper )
+    {
+        const size_t middle = lower + ( upper - lower ) / 2;
+        if ( static_cast<kvs::Real64>( values[ rows[ middle ] ] ) < min_range ) lower = middle + 1;
+        else upper = middle;
+    }
+    *begin = lower;
+
+    // First position of value > max_range.
+    upper = nrows;
+    while ( lower < upper )
+    {
+        const size_t middle = lower + ( upper - lower ) / 2;
+        if ( static_cast<kvs::Real64>( values[ rows[ middle ] ] ) <= max_range ) lower = middle + 1;
+        else upper = middle;
+    }
+    *end = lower;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Finds the sorted rows whose values are inside the range.
+ *  @param  column [in] column values
+ *  @param  rows [in] sorted row indices
+ *  @param  min_range [in] min. range
+ *  @param  max_range [in] max. range
+ *  @param  begin [out] first position of the rows inside the range
+ *  @param  end [out] position after the last row inside the range
+ */
+/*===========================================================================*/
+void FindRows(
+    const kvs::AnyValueArray& column,
+    const kvs::ValueArray<kvs::UInt32>& rows,
+    const kvs::Real64 min_range,
+    const kvs::Real64 max_range,
+    size_t* begin,
+    size_t* end )
+{
+    const kvs::UInt32* r = rows.data();
+    const size_t n = rows.size();
+    switch ( column.typeID() )
+    {
+    case kvs::Type::TypeInt8:   FindRows( static_cast<const kvs::Int8*  >( column.data() ), r, n, min_range, max_range, begin, end ); break;
+    case kvs::Type::TypeInt16:  FindRows( static_cast<const kvs::Int16* >( column.data() ), r, n, min_range, max_range, begin, end ); break;
+    case kvs::Type::TypeInt32:  FindRows( static_cast<const kvs::Int32* >( column.data() ), r, n, min_range, max_range, begin, end ); break;
+    case kvs::Type::TypeInt64:  FindRows( static_cast<const kvs::Int64* >( column.data() ), r, n, min_range, max_range, begin, end ); break;
+    case kvs::Type::TypeUInt8:  FindRows( static_cast<const kvs::UInt8* >( column.data() ), r, n, min_range, max_range, begin, end ); break;
+    case kvs::Type::TypeUInt16: FindRows( static_cast<const kvs::UInt16*>( column.data() ), r, n, min_range, max_range, begin, end ); break;
+    case kvs::Type::TypeUInt32: FindRows( static_cast<const kvs::UInt32*>( column.data() ), r, n, min_range, max_range, begin, end ); break;
+    case kvs::Type::TypeUInt64: FindRows( static_cast<const kvs::UInt64*>( column.data() ), r, n, min_range, max_range, begin, end ); break;
+    case kvs::Type::TypeReal32: FindRows( static_cast<const kvs::Real32*>( column.data() ), r, n, min_range, max_range, begin, end ); break;
+    case kvs::Type::TypeReal64: FindRows( static_cast<const kvs::Real64*>( column.data() ), r, n, min_range, max_range, begin, end ); break;
+    default: *begin = 0; *end = 0; break;
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns true if the range is narrower than the value range.
+ */
+/*===========================================================================*/
+inline bool IsNarrowed(
+    const kvs::Real64 min_range,
+    const kvs::Real64 max_range,
+    const kvs::Real64 min_value,
+    const kvs::Real64 max_value )
+{
+    return min_range > min_value || max_range < max_value;
+}
+
+} // end of namespace
 
 
 namespace kvs
@@ -50,6 +174,9 @@ void TableObject::shallowCopy( const TableObject& other )
     this->m_min_ranges = other.minRanges();
     this->m_max_ranges = other.maxRanges();
     this->m_inside_range_flags = other.insideRangeFlags();
+    this->m_sorted_rows.assign( m_ncolumns, kvs::ValueArray<kvs::UInt32>() );
+    this->m_outside_counts.release();
+    this->update_inside_range_mask();
 }
 
 /*===========================================================================*/
@@ -71,13 +198,16 @@ void TableObject::deepCopy( const TableObject& other )
     BaseClass::operator=( other );
     this->m_nrows = other.numberOfRows();
     this->m_ncolumns = other.numberOfColumns();
-    for ( size_t i = 0; i < m_table.columnSize(); i++ ) this->m_table.pushBackColumn( other.column(i).clone() );
-    for ( size_t i = 0; i < m_labels.size(); i++ ) this->m_labels.push_back( other.label(i) );
-    for ( size_t i = 0; i < m_min_values.size(); i++ ) this->m_min_values.push_back( other.minValue(i) );
-    for ( size_t i = 0; i < m_max_values.size(); i++ ) this->m_max_values.push_back( other.maxValue(i) );
-    for ( size_t i = 0; i < m_min_ranges.size(); i++ ) this->m_min_ranges.push_back( other.minRange(i) );
-    for ( size_t i = 0; i < m_max_ranges.size(); i++ ) this->m_max_ranges.push_back( other.maxRange(i) );
-    for ( size_t i = 0; i < m_inside_range_flags.size(); i++ ) this->m_inside_range_flags.push_back( other.insideRange(i) );
+    for ( size_t i = 0; i < other.table().columnSize(); i++ ) this->m_table.pushBackColumn( other.column(i).clone() );
+    for ( size_t i = 0; i < other.labels().size(); i++ ) this->m_labels.push_back( other.label(i) );
+    for ( size_t i = 0; i < other.minValues().size(); i++ ) this->m_min_values.push_back( other.minValue(i) );
+    for ( size_t i = 0; i < other.maxValues().size(); i++ ) this->m_max_values.push_back( other.maxValue(i) );
+    for ( size_t i = 0; i < other.minRanges().size(); i++ ) this->m_min_ranges.push_back( other.minRange(i) );
+    for ( size_t i = 0; i < other.maxRanges().size(); i++ ) this->m_max_ranges.push_back( other.maxRange(i) );
+    for ( size_t i = 0; i < other.insideRangeFlags().size(); i++ ) this->m_inside_range_flags.push_back( other.insideRange(i) );
+    this->m_sorted_rows.assign( m_ncolumns, kvs::ValueArray<kvs::UInt32>() );
+    this->m_outside_counts.release();
+    this->update_inside_range_mask();
 }
 
 /*===========================================================================*/
@@ -119,103 +249,14 @@ void TableObject::addColumn( const kvs::AnyValueArray& array, const std::string&
     m_table.pushBackColumn( array );
     m_labels.push_back( label );
 
-    kvs::Real64 min_value = kvs::Value<kvs::Real64>::Max();
-    kvs::Real64 max_value = kvs::Value<kvs::Real64>::Min();
-    const std::type_info& type = array.typeInfo()->type();
-    if ( type == typeid( kvs::Int8 ) )
+    // Non-numeric columns have no value range.
+    kvs::Real64 min_value = 0.0;
+    kvs::Real64 max_value = 0.0;
+    kvs::ValueStatistics statistics;
+    if ( statistics.calculate( array ) )
     {
-        const kvs::Int8* value = static_cast<const kvs::Int8*>( array.data() );
-        for( size_t i = 0; i < array.size(); i++ )
-        {
-            min_value = kvs::Math::Min( min_value, kvs::Real64( value[i] ) );
-            max_value = kvs::Math::Max( max_value, kvs::Real64( value[i] ) );
-        }
-    }
-    else if ( type == typeid( kvs::UInt8 ) )
-    {
-        const kvs::UInt8* value = static_cast<const kvs::UInt8*>( array.data() );
-        for( size_t i = 0; i < array.size(); i++ )
-        {
-            min_value = kvs::Math::Min( min_value, kvs::Real64( value[i] ) );
-            max_value = kvs::Math::Max( max_value, kvs::Real64( value[i] ) );
-        }
-    }
-    else if ( type == typeid( kvs::Int16 ) )
-    {
-        const kvs::Int16* value = static_cast<const kvs::Int16*>( array.data() );
-        for( size_t i = 0; i < array.size(); i++ )
-        {
-            min_value = kvs::Math::Min( min_value, kvs::Real64( value[i] ) );
-            max_value = kvs::Math::Max( max_value, kvs::Real64( value[i] ) );
-        }
-    }
-    else if ( type == typeid( kvs::UInt16 ) )
-    {
-        const kvs::UInt16* value = static_cast<const kvs::UInt16*>( array.data() );
-        for( size_t i = 0; i < array.size(); i++ )
-        {
-            min_value = kvs::Math::Min( min_value, kvs::Real64( value[i] ) );
-            max_value = kvs::Math::Max( max_value, kvs::Real64( value[i] ) );
-        }
-    }
-    else if ( type == typeid( kvs::Int32 ) )
-    {
-        const kvs::Int32* value = static_cast<const kvs::Int32*>( array.data() );
-        for( size_t i = 0; i < array.size(); i++ )
-        {
-            min_value = kvs::Math::Min( min_value, kvs::Real64( value[i] ) );
-            max_value = kvs::Math::Max( max_value, kvs::Real64( value[i] ) );
-        }
-    }
-    else if ( type == typeid( kvs::UInt32 ) )
-    {
-        const kvs::UInt32* value = static_cast<const kvs::UInt32*>( array.data() );
-        for( size_t i = 0; i < array.size(); i++ )
-        {
-            min_value = kvs::Math::Min( min_value, kvs::Real64( value[i] ) );
-            max_value = kvs::Math::Max( max_value, kvs::Real64( value[i] ) );
-        }
-    }
-    else if ( type == typeid( kvs::Int64 ) )
-    {
-        const kvs::Int64* value = static_cast<const kvs::Int64*>( array.data() );
-        for( size_t i = 0; i < array.size(); i++ )
-        {
-            min_value = kvs::Math::Min( min_value, kvs::Real64( value[i] ) );
-            max_value = kvs::Math::Max( max_value, kvs::Real64( value[i] ) );
-        }
-    }
-    else if ( type == typeid( kvs::UInt64 ) )
-    {
-        const kvs::UInt64* value = static_cast<const kvs::UInt64*>( array.data() );
-        for( size_t i = 0; i < array.size(); i++ )
-        {
-            min_value = kvs::Math::Min( min_value, kvs::Real64( value[i] ) );
-            max_value = kvs::Math::Max( max_value, kvs::Real64( value[i] ) );
-        }
-    }
-    else if ( type == typeid( kvs::Real32 ) )
-    {
-        const kvs::Real32* value = static_cast<const kvs::Real32*>( array.data() );
-        for( size_t i = 0; i < array.size(); i++ )
-        {
-            min_value = kvs::Math::Min( min_value, kvs::Real64( value[i] ) );
-            max_value = kvs::Math::Max( max_value, kvs::Real64( value[i] ) );
-        }
-    }
-    else if ( type == typeid( kvs::Real64 ) )
-    {
-        const kvs::Real64* value = static_cast<const kvs::Real64*>( array.data() );
-        for( size_t i = 0; i < array.size(); i++ )
-        {
-            min_value = kvs::Math::Min( min_value, kvs::Real64( value[i] ) );
-            max_value = kvs::Math::Max( max_value, kvs::Real64( value[i] ) );
-        }
-    }
-    else if ( type == typeid( std::string ) )
-    {
-        min_value = 0.0;
-        max_value = 0.0;
+        min_value = statistics.minValue();
+        max_value = statistics.maxValue();
     }
 
     m_min_values.push_back( min_value );
@@ -223,6 +264,11 @@ void TableObject::addColumn( const kvs::AnyValueArray& array, const std::string&
     m_min_ranges.push_back( min_value );
     m_max_ranges.push_back( max_value );
     m_inside_range_flags.resize( m_nrows, 1 );
+
+    // The range index is created again when a range is changed.
+    m_sorted_rows.assign( m_ncolumns, kvs::ValueArray<kvs::UInt32>() );
+    m_outside_counts.release();
+    this->update_inside_range_mask();
 }
 
 /*===========================================================================*/
@@ -241,6 +287,8 @@ void TableObject::setTable( const kvs::AnyValueTable& table, const Labels& label
     { m_min_ranges.clear(); Values().swap( m_min_ranges ); }
     { m_max_ranges.clear(); Values().swap( m_max_ranges ); }
     { m_inside_range_flags.clear(); InsideRangeFlags().swap( m_inside_range_flags ); }
+    m_nrows = 0;
+    m_ncolumns = 0;
 
     for ( size_t i = 0; i < table.columnSize(); i++ )
     {
@@ -291,53 +339,7 @@ void TableObject::setMinRange( const size_t column_index, const kvs::Real64 rang
     const kvs::Real64 min_range_new = kvs::Math::Clamp( range, min_value, max_range );
 
     if ( kvs::Math::Equal( min_range_old, min_range_new ) ) return;
-    m_min_ranges[column_index] = min_range_new;
-
-    const size_t nrows = this->numberOfRows();
-    const size_t ncolumns = this->numberOfColumns();
-    if ( m_table.columns().size() > 0 )
-    {
-        if ( min_range_new > min_range_old )
-        {
-            /* In case of flags turned off, you just have to check whether the value
-             * in the specified column is included in the range.
-             *
-             *  (before) |xxx+oooooooo*xxxxxx|  o: on, x: off, +: min_range, *: max_range
-             *  (after)  |xxxAxxxxBooo*xxxxxx|  A: min_range_old, B: min_range_new
-             */
-            const kvs::AnyValueArray& column = this->column( column_index );
-            for ( size_t i = 0; i < nrows; i++ )
-            {
-                const kvs::Real64 value = column[i].to<kvs::Real64>();
-                if (  min_range_old <= value && value <= min_range_new )
-                {
-                    m_inside_range_flags[i] = 0;
-                }
-            }
-        }
-        else
-        {
-            /* In case of flags turned on, you have to check the all of colums.
-             *
-             *  (before) |xxxxxxxx+ooo*xxxxxx|  o: on, x: off, +: min_range, *: max_range
-             *  (after)  |xxxAooooBooo*xxxxxx|  A: min_range, B: min_range_old
-             */
-            for ( size_t i = 0; i < nrows; i++ )
-            {
-                m_inside_range_flags[i] = 1;
-                for ( size_t j = 0; j < ncolumns; j++ )
-                {
-                    const kvs::AnyValueArray& column = this->column( j );
-                    const kvs::Real64 value = column[i].to<kvs::Real64>();
-                    if (  !( m_min_ranges[j] <= value && value <= m_max_ranges[j] ) )
-                    {
-                        m_inside_range_flags[i] = 0;
-                        break;
-                    }
-                }
-            }
-        }
-    }
+    this->update_range( column_index, min_range_new, max_range );
 }
 
 /*===========================================================================*/
@@ -356,53 +358,7 @@ void TableObject::setMaxRange( const size_t column_index, const kvs::Real64 rang
     const kvs::Real64 max_range_new = kvs::Math::Clamp( range, min_range, max_value );
 
     if ( kvs::Math::Equal( max_range_old, max_range_new ) ) return;
-    m_max_ranges[column_index] = max_range_new;
-
-    const size_t nrows = this->numberOfRows();
-    const size_t ncolumns = this->numberOfColumns();
-    if ( m_table.columns().size() > 0 )
-    {
-        if ( max_range_new > max_range_old )
-        {
-            /* In case of flags turned on, you have to check the all of colums.
-             *
-             *  (before) |xxx*oooooooo+xxxxxx|  o: on, x: off, *: min_range, +: max_range
-             *  (after)  |xxx*ooooooooAoooBxx|  A: max_range_old, B: max_range_new
-             */
-            for ( size_t i = 0; i < nrows; i++ )
-            {
-                m_inside_range_flags[i] = 1;
-                for ( size_t j = 0; j < ncolumns; j++ )
-                {
-                    const kvs::AnyValueArray& column = this->column( j );
-                    const kvs::Real64 value = column[i].to<kvs::Real64>();
-                    if (  !( m_min_ranges[j] <= value && value <= m_max_ranges[j] ) )
-                    {
-                        m_inside_range_flags[i] = 0;
-                        break;
-                    }
-                }
-            }
-        }
-        else
-        {
-            /* In case of flags turned off, you just have to check whether the value
-             * in the specified column is included in the range.
-             *
-             *  (before) |xxx*oooooooo+xxxxxx|  o: on, x: off, *: min_range, +: max_range
-             *  (after)  |xxx*ooooBxxxAxxxxxx|  A: max_range_old, B: max_range_new
-             */
-            const kvs::AnyValueArray& column = this->column( column_index );
-            for ( size_t i = 0; i < nrows; i++ )
-            {
-                const kvs::Real64 value = column[i].to<kvs::Real64>();
-                if (  max_range_new <= value && value <= max_range_old )
-                {
-                    m_inside_range_flags[i] = 0;
-                }
-            }
-        }
-    }
+    this->update_range( column_index, min_range, max_range_new );
 }
 
 /*===========================================================================*/
@@ -504,6 +460,196 @@ void TableObject::resetRange()
     }
 
     std::fill( m_inside_range_flags.begin(), m_inside_range_flags.end(), 1 );
+    if ( m_outside_counts.size() > 0 ) m_outside_counts.fill( 0 );
+    this->update_inside_range_mask();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sets the inside range flags.
+ *  @param  inside_range_flags [in] inside range flags
+ *
+ *  The flags are recalculated from the ranges when a range is changed.
+ */
+/*===========================================================================*/
+void TableObject::setInsideRangeFlags( const InsideRangeFlags& inside_range_flags )
+{
+    m_inside_range_flags = inside_range_flags;
+    m_outside_counts.release();
+    this->update_inside_range_mask();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Updates the range of the column and the rows inside the ranges.
+ *  @param  column_index [in] column index
+ *  @param  min_range [in] new min. range
+ *  @param  max_range [in] new max. range
+ *
+ *  The rows whose values are between the old and new bounds are found in
+ *  the row indices sorted by the values of the column, and only these rows
+ *  are excluded or included. The columns of the non-numeric types are
+ *  scanned instead.
+ */
+/*===========================================================================*/
+void TableObject::update_range( const size_t column_index, const kvs::Real64 min_range, const kvs::Real64 max_range )
+{
+    const kvs::Real64 min_range_old = m_min_ranges[column_index];
+    const kvs::Real64 max_range_old = m_max_ranges[column_index];
+    if ( m_table.columns().size() == 0 )
+    {
+        m_min_ranges[column_index] = min_range;
+        m_max_ranges[column_index] = max_range;
+        return;
+    }
+
+    // The counts are created with the old ranges.
+    if ( m_outside_counts.size() != m_nrows ) this->create_outside_counts();
+    m_min_ranges[column_index] = min_range;
+    m_max_ranges[column_index] = max_range;
+
+    const kvs::AnyValueArray& column = this->column( column_index );
+    if ( !this->create_sorted_rows( column_index ) )
+    {
+        const size_t nrows = column.size();
+        for ( size_t i = 0; i < nrows; i++ )
+        {
+            const kvs::Real64 value = column[i].to<kvs::Real64>();
+            const bool inside_old = min_range_old <= value && value <= max_range_old;
+            const bool inside_new = min_range <= value && value <= max_range;
+            if ( inside_old && !inside_new ) this->exclude_row( i );
+            else if ( !inside_old && inside_new ) this->include_row( i );
+        }
+        return;
+    }
+
+    // Rows of [begin_old,end_old) and [begin_new,end_new) in the sorted rows
+    // are inside the old and new ranges respectively.
+    const kvs::ValueArray<kvs::UInt32>& rows = m_sorted_rows[column_index];
+    size_t begin_old = 0, end_old = 0;
+    size_t begin_new = 0, end_new = 0;
+    ::FindRows( column, rows, min_range_old, max_range_old, &begin_old, &end_old );
+    ::FindRows( column, rows, min_range, max_range, &begin_new, &end_new );
+
+    // The rows below or above the new range are excluded.
+    for ( size_t k = begin_old; k < kvs::Math::Min( end_old, begin_new ); k++ ) this->exclude_row( rows[k] );
+    for ( size_t k = kvs::Math::Max( begin_old, end_new ); k < end_old; k++ ) this->exclude_row( rows[k] );
+
+    // The rows below or above the old range are included.
+    for ( size_t k = begin_new; k < kvs::Math::Min( end_new, begin_old ); k++ ) this->include_row( rows[k] );
+    for ( size_t k = kvs::Math::Max( begin_new, end_old ); k < end_new; k++ ) this->include_row( rows[k] );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Counts the columns whose ranges exclude each row.
+ */
+/*===========================================================================*/
+void TableObject::create_outside_counts()
+{
+    m_outside_counts.allocate( m_nrows );
+    m_outside_counts.fill( 0 );
+
+    const size_t ncolumns = m_table.columns().size();
+    for ( size_t j = 0; j < ncolumns; j++ )
+    {
+        const kvs::Real64 min_range = m_min_ranges[j];
+        const kvs::Real64 max_range = m_max_ranges[j];
+        if ( !::IsNarrowed( min_range, max_range, m_min_values[j], m_max_values[j] ) ) continue;
+
+        const kvs::AnyValueArray& column = this->column( j );
+        const size_t nrows = column.size();
+        for ( size_t i = 0; i < nrows; i++ )
+        {
+            const kvs::Real64 value = column[i].to<kvs::Real64>();
+            if ( !( min_range <= value && value <= max_range ) ) m_outside_counts[i]++;
+        }
+    }
+
+    for ( size_t i = 0; i < m_nrows; i++ ) m_inside_range_flags[i] = m_outside_counts[i] == 0 ? 1 : 0;
+    this->update_inside_range_mask();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sorts the row indices by the values of the column if not sorted.
+ *  @param  column_index [in] column index
+ *  @return true if the sorted row indices are available
+ */
+/*===========================================================================*/
+bool TableObject::create_sorted_rows( const size_t column_index )
+{
+    const kvs::AnyValueArray& column = this->column( column_index );
+    kvs::ValueArray<kvs::UInt32>& rows = m_sorted_rows[column_index];
+    if ( rows.size() == column.size() && rows.size() > 0 ) return true;
+
+    // The row indices are stored as 32-bit integers.
+    const size_t n = column.size();
+    if ( n == 0 || n > size_t( kvs::Value<kvs::UInt32>::Max() ) ) return false;
+
+    rows.allocate( n );
+    switch ( column.typeID() )
+    {
+    case kvs::Type::TypeInt8:   ::SortRows( static_cast<const kvs::Int8*  >( column.data() ), n, rows.data() ); break;
+    case kvs::Type::TypeInt16:  ::SortRows( static_cast<const kvs::Int16* >( column.data() ), n, rows.data() ); break;
+    case kvs::Type::TypeInt32:  ::SortRows( static_cast<const kvs::Int32* >( column.data() ), n, rows.data() ); break;
+    case kvs::Type::TypeInt64:  ::SortRows( static_cast<const kvs::Int64* >( column.data() ), n, rows.data() ); break;
+    case kvs::Type::TypeUInt8:  ::SortRows( static_cast<const kvs::UInt8* >( column.data() ), n, rows.data() ); break;
+    case kvs::Type::TypeUInt16: ::SortRows( static_cast<const kvs::UInt16*>( column.data() ), n, rows.data() ); break;
+    case kvs::Type::TypeUInt32: ::SortRows( static_cast<const kvs::UInt32*>( column.data() ), n, rows.data() ); break;
+    case kvs::Type::TypeUInt64: ::SortRows( static_cast<const kvs::UInt64*>( column.data() ), n, rows.data() ); break;
+    case kvs::Type::TypeReal32: ::SortRows( static_cast<const kvs::Real32*>( column.data() ), n, rows.data() ); break;
+    case kvs::Type::TypeReal64: ::SortRows( static_cast<const kvs::Real64*>( column.data() ), n, rows.data() ); break;
+    default: rows.release(); return false;
+    }
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Excludes the row by a column.
+ *  @param  row_index [in] row index
+ */
+/*===========================================================================*/
+void TableObject::exclude_row( const size_t row_index )
+{
+    if ( m_outside_counts[row_index]++ == 0 )
+    {
+        m_inside_range_flags[row_index] = 0;
+        m_inside_range_mask.reset( row_index );
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Includes the row by a column.
+ *  @param  row_index [in] row index
+ */
+/*===========================================================================*/
+void TableObject::include_row( const size_t row_index )
+{
+    if ( --m_outside_counts[row_index] == 0 )
+    {
+        m_inside_range_flags[row_index] = 1;
+        m_inside_range_mask.set( row_index );
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Updates the bit mask with the inside range flags.
+ */
+/*===========================================================================*/
+void TableObject::update_inside_range_mask()
+{
+    const size_t nrows = m_inside_range_flags.size();
+    m_inside_range_mask.allocate( nrows );
+    m_inside_range_mask.reset();
+    for ( size_t i = 0; i < nrows; i++ )
+    {
+        if ( m_inside_range_flags[i] ) m_inside_range_mask.set( i );
+    }
 }
 
 template<> void TableObject::addColumn<kvs::Int8>( const kvs::ValueArray<kvs::Int8>& array, const std::string& label );
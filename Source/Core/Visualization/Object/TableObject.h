@@ -22,6 +22,8 @@
 #include <kvs/Type>
 #include <kvs/AnyValueArray>
 #include <kvs/AnyValueTable>
+#include <kvs/ValueArray>
+#include <kvs/BitArray>
 #include <kvs/Indent>
 #include <kvs/Deprecated>
 
@@ -32,6 +34,14 @@ namespace kvs
 /*===========================================================================*/
 /**
  *  TableObject class.
+ *
+ *  The rows inside the value ranges of all the columns are selected by the
+ *  range index. The row indices of a column are sorted by the values when
+ *  the range of the column is changed first, and the number of columns
+ *  whose ranges exclude each row is counted. When a range is changed, only
+ *  the rows between the old and new range bounds are found by the binary
+ *  search and updated, so that the cost is proportional to the number of
+ *  changed rows rather than the table size.
  */
 /*===========================================================================*/
 class TableObject : public kvs::ObjectBase
@@ -57,6 +67,9 @@ private:
     Values m_min_ranges; ///< min. value range
     Values m_max_ranges; ///< max. value range
     InsideRangeFlags m_inside_range_flags; ///< check flags for value range
+    kvs::BitArray m_inside_range_mask; ///< bit mask of the rows inside the ranges
+    std::vector< kvs::ValueArray<kvs::UInt32> > m_sorted_rows; ///< row indices sorted by the values for each column (range index)
+    kvs::ValueArray<kvs::UInt16> m_outside_counts; ///< number of columns whose ranges exclude each row (range index)
 
 public:
 
@@ -88,6 +101,7 @@ public:
     const Values& minRanges() const { return m_min_ranges; }
     const Values& maxRanges() const { return m_max_ranges; }
     const InsideRangeFlags& insideRangeFlags() const { return m_inside_range_flags; }
+    const kvs::BitArray& insideRangeMask() const { return m_inside_range_mask; }
     const std::string& label( const size_t index ) const { return m_labels[index];  }
     const kvs::AnyValueArray& column( const size_t index ) const { return m_table.column(index); }
     kvs::Real64 minValue( const size_t index ) const { return m_min_values[index]; }
@@ -104,9 +118,18 @@ protected:
     void setLabels( const Labels& labels ) { m_labels = labels; }
     void setMinValues( const Values& min_values ) { m_min_values = min_values; }
     void setMaxValues( const Values& max_values ) { m_max_values = max_values; }
-    void setMinRanges( const Values& min_ranges ) { m_min_ranges = min_ranges; }
-    void setMaxRanges( const Values& max_ranges ) { m_max_ranges = max_ranges; }
-    void setInsideRangeFlags( const InsideRangeFlags& inside_range_flags ) { m_inside_range_flags = inside_range_flags; }
+    void setMinRanges( const Values& min_ranges ) { m_min_ranges = min_ranges; m_outside_counts.release(); }
+    void setMaxRanges( const Values& max_ranges ) { m_max_ranges = max_ranges; m_outside_counts.release(); }
+    void setInsideRangeFlags( const InsideRangeFlags& inside_range_flags );
+
+private:
+
+    void update_range( const size_t column_index, const kvs::Real64 min_range, const kvs::Real64 max_range );
+    void create_outside_counts();
+    bool create_sorted_rows( const size_t column_index );
+    void exclude_row( const size_t row_index );
+    void include_row( const size_t row_index );
+    void update_inside_range_mask();
 
 public:
     typedef KVS_DEPRECATED( std::vector<std::string> LabelList );
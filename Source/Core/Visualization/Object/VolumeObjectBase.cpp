@@ -13,61 +13,9 @@
  */
 /****************************************************************************/
 #include "VolumeObjectBase.h"
-#include <kvs/Range>
+#include <kvs/ValueStatistics>
 
 
-namespace
-{
-
-template<typename T>
-kvs::Range GetMinMaxValues( const kvs::VolumeObjectBase* volume )
-{
-    KVS_ASSERT( volume->values().size() != 0 );
-    KVS_ASSERT( volume->values().size() == volume->veclen() * volume->numberOfNodes() );
-
-    const T* value = reinterpret_cast<const T*>( volume->values().data() );
-    const T* const end = value + volume->numberOfNodes() * volume->veclen();
-
-    if ( volume->veclen() == 1 )
-    {
-        T min_value = *value;
-        T max_value = *value;
-
-        while ( value < end )
-        {
-            min_value = kvs::Math::Min( *value, min_value );
-            max_value = kvs::Math::Max( *value, max_value );
-            ++value;
-        }
-
-        return kvs::Range( static_cast<double>( min_value ), static_cast<double>( max_value ) );
-    }
-    else
-    {
-        kvs::Real64 min_value = kvs::Value<kvs::Real64>::Max();
-        kvs::Real64 max_value = kvs::Value<kvs::Real64>::Min();
-
-        const size_t veclen = volume->veclen();
-
-        while ( value < end )
-        {
-            kvs::Real64 magnitude = 0.0;
-            for ( size_t i = 0; i < veclen; ++i )
-            {
-                magnitude += static_cast<kvs::Real64>( ( *value ) * ( *value ) );
-                ++value;
-            }
-
-            min_value = kvs::Math::Min( magnitude, min_value );
-            max_value = kvs::Math::Max( magnitude, max_value );
-        }
-
-        return kvs::Range( std::sqrt( min_value ), std::sqrt( max_value ) );
-    }
-}
-
-}
-
 namespace kvs
 {
 
@@ -83,7 +31,10 @@ VolumeObjectBase::VolumeObjectBase():
     m_veclen( 0 ),
     m_has_min_max_values( false ),
     m_min_value( 0.0 ),
-    m_max_value( 0.0 )
+    m_max_value( 0.0 ),
+    m_has_statistics( false ),
+    m_mean_value( 0.0 ),
+    m_variance_value( 0.0 )
 {
     BaseClass::setObjectType( Volume );
 }
@@ -104,30 +55,50 @@ void VolumeObjectBase::setMinMaxValues(
     m_has_min_max_values = true;
 }
 
+/*==========================================================================*/
+/**
+ *  @brief  Sets the value array.
+ *  @param  values [in] value array
+ *
+ *  The cached min/max values and statistics are invalidated.
+ */
+/*==========================================================================*/
+void VolumeObjectBase::setValues( const Values& values )
+{
+    m_values = values;
+    m_has_min_max_values = false;
+    m_has_statistics = false;
+}
+
 /*==========================================================================*/
 /**
  *  @brief  Updates the min/max node value.
+ *
+ *  The mean and the variance are calculated in the same pass and cached too.
  */
 /*==========================================================================*/
 void VolumeObjectBase::updateMinMaxValues() const
 {
-    kvs::Range range;
-    switch ( m_values.typeID() )
-    {
-    case kvs::Type::TypeInt8:   { range = ::GetMinMaxValues<kvs::Int8  >( this ); break; }
-    case kvs::Type::TypeInt16:  { range = ::GetMinMaxValues<kvs::Int16 >( this ); break; }
-    case kvs::Type::TypeInt32:  { range = ::GetMinMaxValues<kvs::Int32 >( this ); break; }
-    case kvs::Type::TypeInt64:  { range = ::GetMinMaxValues<kvs::Int64 >( this ); break; }
-    case kvs::Type::TypeUInt8:  { range = ::GetMinMaxValues<kvs::UInt8 >( this ); break; }
-    case kvs::Type::TypeUInt16: { range = ::GetMinMaxValues<kvs::UInt16>( this ); break; }
-    case kvs::Type::TypeUInt32: { range = ::GetMinMaxValues<kvs::UInt32>( this ); break; }
-    case kvs::Type::TypeUInt64: { range = ::GetMinMaxValues<kvs::UInt64>( this ); break; }
-    case kvs::Type::TypeReal32: { range = ::GetMinMaxValues<kvs::Real32>( this ); break; }
-    case kvs::Type::TypeReal64: { range = ::GetMinMaxValues<kvs::Real64>( this ); break; }
-    default: break;
-    }
-
-    this->setMinMaxValues( range.lower(), range.upper() );
+    this->updateStatistics();
+}
+
+/*==========================================================================*/
+/**
+ *  @brief  Updates the min/max, mean and variance of the node values.
+ */
+/*==========================================================================*/
+void VolumeObjectBase::updateStatistics() const
+{
+    KVS_ASSERT( m_values.size() != 0 );
+    KVS_ASSERT( m_values.size() == m_veclen * this->numberOfNodes() );
+
+    kvs::ValueStatistics statistics;
+    if ( !statistics.calculate( m_values, m_veclen ) ) { return; }
+
+    this->setMinMaxValues( statistics.minValue(), statistics.maxValue() );
+    m_mean_value = statistics.mean();
+    m_variance_value = statistics.variance();
+    m_has_statistics = true;
 }
 
 /*===========================================================================*/
@@ -143,6 +114,9 @@ void VolumeObjectBase::shallowCopy( const VolumeObjectBase& object )
     m_has_min_max_values = object.hasMinMaxValues();
     m_min_value = object.minValue();
     m_max_value = object.maxValue();
+    m_has_statistics = object.hasStatistics();
+    m_mean_value = object.meanValue();
+    m_variance_value = object.varianceValue();
     m_label = object.label();
     m_veclen = object.veclen();
     m_coords = object.coords();
@@ -162,6 +136,9 @@ void VolumeObjectBase::deepCopy( const VolumeObjectBase& object )
     m_has_min_max_values = object.hasMinMaxValues();
     m_min_value = object.minValue();
     m_max_value = object.maxValue();
+    m_has_statistics = object.hasStatistics();
+    m_mean_value = object.meanValue();
+    m_variance_value = object.varianceValue();
     m_label = object.label();
     m_veclen = object.veclen();
     m_coords = object.coords().clone();
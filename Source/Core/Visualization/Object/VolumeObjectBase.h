@@ -64,6 +64,9 @@ private:
     mutable bool m_has_min_max_values; ///< Whether includes min/max values or not
     mutable kvs::Real64 m_min_value; ///< Minimum field value
     mutable kvs::Real64 m_max_value; ///< Maximum field value
+    mutable bool m_has_statistics; ///< Whether includes mean/variance values or not
+    mutable kvs::Real64 m_mean_value; ///< Mean field value
+    mutable kvs::Real64 m_variance_value; ///< Variance of field values
 
 public:
 
@@ -77,7 +80,7 @@ public:
     void setUnit( const std::string& unit ) { m_unit = unit; }
     void setVeclen( const size_t veclen ) { m_veclen = veclen; }
     void setCoords( const Coords& coords ) { m_coords = coords; }
-    void setValues( const Values& values ) { m_values = values; }
+    void setValues( const Values& values );
     void setMinMaxValues( const kvs::Real64 min_value, const kvs::Real64 max_value ) const;
 
     const std::string& label() const { return m_label; }
@@ -88,11 +91,15 @@ public:
     bool hasMinMaxValues() const { return m_has_min_max_values; }
     kvs::Real64 minValue() const { return m_min_value; }
     kvs::Real64 maxValue() const { return m_max_value; }
+    bool hasStatistics() const { return m_has_statistics; }
+    kvs::Real64 meanValue() const { return m_mean_value; }
+    kvs::Real64 varianceValue() const { return m_variance_value; }
 
     VolumeType volumeType() const { return m_volume_type; }
     virtual size_t numberOfNodes() const = 0;
     virtual size_t numberOfCells() const = 0;
     void updateMinMaxValues() const;
+    void updateStatistics() const;
 
 protected:
 
@@ -107,6 +114,9 @@ public:
         m_has_min_max_values = false;
         m_min_value = 0.0;
         m_max_value = 0.0;
+        m_has_statistics = false;
+        m_mean_value = 0.0;
+        m_variance_value = 0.0;
         this->setVeclen( veclen );
         this->setCoords( coords );
         this->setValues( values );
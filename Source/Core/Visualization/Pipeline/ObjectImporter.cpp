@@ -225,7 +225,9 @@ bool ObjectImporter::estimate_file_format()
     else if ( kvs::DicomList::CheckDirectory( file.filePath() ) )
     {
         m_importer_type = ObjectImporter::StructuredVolume;
-        m_file_format = new kvs::DicomList;
+        kvs::DicomList* dicom_list = new kvs::DicomList;
+        dicom_list->enableHeaderOnly(); // the pixel data is read by the importer
+        m_file_format = dicom_list;
     }
 
     return m_file_format != NULL;
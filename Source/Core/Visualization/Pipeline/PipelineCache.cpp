@@ -0,0 +1,568 @@
+/*****************************************************************************/
+/**
+ *  @file   PipelineCache.cpp
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#include "PipelineCache.h"
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+#include <kvs/MutexLocker>
+#include <kvs/Message>
+#include <kvs/File>
+#include <kvs/Directory>
+#include <kvs/ObjectImporter>
+#include <kvs/GeometryObjectBase>
+#include <kvs/VolumeObjectBase>
+#include <kvs/PointObject>
+#include <kvs/LineObject>
+#include <kvs/PolygonObject>
+#include <kvs/StructuredVolumeObject>
+#include <kvs/UnstructuredVolumeObject>
+#include <kvs/ImageObject>
+#include <kvs/PointExporter>
+#include <kvs/LineExporter>
+#include <kvs/PolygonExporter>
+#include <kvs/StructuredVolumeExporter>
+#include <kvs/UnstructuredVolumeExporter>
+
+
+namespace
+{
+
+kvs::PipelineCache SharedCache;
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the hash value of the string (64-bit FNV-1a).
+ *  @param  key [in] string
+ *  @return hash value
+ */
+/*===========================================================================*/
+kvs::UInt64 Hash( const std::string& key )
+{
+    kvs::UInt64 hash = 14695981039346656037ULL;
+    for ( size_t i = 0; i < key.size(); i++ )
+    {
+        hash ^= static_cast<kvs::UInt8>( key[i] );
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Writes the object in the KVSML format with the external binary data.
+ *  @param  object [in] pointer to the object
+ *  @param  filename [in] filename
+ *  @return true if the object is written successfully
+ */
+/*===========================================================================*/
+bool WriteKVSML( const kvs::ObjectBase* object, const std::string& filename )
+{
+    switch ( object->objectType() )
+    {
+    case kvs::ObjectBase::Geometry:
+    {
+        const kvs::GeometryObjectBase* geometry = kvs::GeometryObjectBase::DownCast( object );
+        switch ( geometry->geometryType() )
+        {
+        case kvs::GeometryObjectBase::Point:
+        {
+            kvs::PointExporter<kvs::KVSMLObjectPoint> exporter( kvs::PointObject::DownCast( object ) );
+            exporter.setWritingDataType( kvs::KVSMLObjectPoint::ExternalBinary );
+            return exporter.write( filename );
+        }
+        case kvs::GeometryObjectBase::Line:
+        {
+            kvs::LineExporter<kvs::KVSMLObjectLine> exporter( kvs::LineObject::DownCast( object ) );
+            exporter.setWritingDataType( kvs::KVSMLObjectLine::ExternalBinary );
+            return exporter.write( filename );
+        }
+        case kvs::GeometryObjectBase::Polygon:
+        {
+            kvs::PolygonExporter<kvs::KVSMLObjectPolygon> exporter( kvs::PolygonObject::DownCast( object ) );
+            exporter.setWritingDataType( kvs::KVSMLObjectPolygon::ExternalBinary );
+            return exporter.write( filename );
+        }
+        default: break;
+        }
+        break;
+    }
+    case kvs::ObjectBase::Volume:
+    {
+        const kvs::VolumeObjectBase* volume = kvs::VolumeObjectBase::DownCast( object );
+        switch ( volume->volumeType() )
+        {
+        case kvs::VolumeObjectBase::Structured:
+        {
+            kvs::StructuredVolumeExporter<kvs::KVSMLObjectStructuredVolume> exporter( kvs::StructuredVolumeObject::DownCast( object ) );
+            exporter.setWritingDataType( kvs::KVSMLObjectStructuredVolume::ExternalBinary );
+            return exporter.write( filename );
+        }
+        case kvs::VolumeObjectBase::Unstructured:
+        {
+            kvs::UnstructuredVolumeExporter<kvs::KVSMLObjectUnstructuredVolume> exporter( kvs::UnstructuredVolumeObject::DownCast( object ) );
+            exporter.setWritingDataType( kvs::KVSMLObjectUnstructuredVolume::ExternalBinary );
+            return exporter.write( filename );
+        }
+        default: break;
+        }
+        break;
+    }
+    default: break;
+    }
+
+    return false;
+}
+
+} // end of namespace
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the cache shared by the visualization pipelines.
+ *  @return shared cache
+ */
+/*===========================================================================*/
+PipelineCache& PipelineCache::Shared()
+{
+    return ::SharedCache;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the byte size of the data arrays of the object.
+ *  @param  object [in] pointer to the object
+ *  @return byte size
+ */
+/*===========================================================================*/
+size_t PipelineCache::ByteSize( const kvs::ObjectBase* object )
+{
+    size_t byte_size = 0;
+    switch ( object->objectType() )
+    {
+    case kvs::ObjectBase::Geometry:
+    {
+        const kvs::GeometryObjectBase* geometry = kvs::GeometryObjectBase::DownCast( object );
+        byte_size += geometry->coords().byteSize();
+        byte_size += geometry->colors().byteSize();
+        byte_size += geometry->normals().byteSize();
+        switch ( geometry->geometryType() )
+        {
+        case kvs::GeometryObjectBase::Point:
+        {
+            const kvs::PointObject* point = kvs::PointObject::DownCast( object );
+            byte_size += point->sizes().byteSize();
+            byte_size += point->quantizedCoords().byteSize();
+            byte_size += point->encodedNormals().byteSize();
+            byte_size += point->colorIndices().byteSize();
+            byte_size += point->colorPalette().byteSize();
+            break;
+        }
+        case kvs::GeometryObjectBase::Line:
+        {
+            const kvs::LineObject* line = kvs::LineObject::DownCast( object );
+            byte_size += line->connections().byteSize();
+            byte_size += line->sizes().byteSize();
+            break;
+        }
+        case kvs::GeometryObjectBase::Polygon:
+        {
+            const kvs::PolygonObject* polygon = kvs::PolygonObject::DownCast( object );
+            byte_size += polygon->connections().byteSize();
+            byte_size += polygon->opacities().byteSize();
+            break;
+        }
+        default: break;
+        }
+        break;
+    }
+    case kvs::ObjectBase::Volume:
+    {
+        const kvs::VolumeObjectBase* volume = kvs::VolumeObjectBase::DownCast( object );
+        byte_size += volume->coords().byteSize();
+        byte_size += volume->values().byteSize();
+        if ( volume->volumeType() == kvs::VolumeObjectBase::Unstructured )
+        {
+            const kvs::UnstructuredVolumeObject* unstructured = kvs::UnstructuredVolumeObject::DownCast( object );
+            byte_size += unstructured->connections().byteSize();
+        }
+        break;
+    }
+    case kvs::ObjectBase::Image:
+    {
+        const kvs::ImageObject* image = kvs::ImageObject::DownCast( object );
+        byte_size += image->pixels().byteSize();
+        break;
+    }
+    default: break;
+    }
+
+    return byte_size;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns a shallow copy of the object.
+ *  @param  object [in] pointer to the object
+ *  @return pointer to the copied object (NULL if the object type is not supported)
+ */
+/*===========================================================================*/
+kvs::ObjectBase* PipelineCache::ShallowCopy( const kvs::ObjectBase* object )
+{
+    switch ( object->objectType() )
+    {
+    case kvs::ObjectBase::Geometry:
+    {
+        const kvs::GeometryObjectBase* geometry = kvs::GeometryObjectBase::DownCast( object );
+        switch ( geometry->geometryType() )
+        {
+        case kvs::GeometryObjectBase::Point:
+        {
+            kvs::PointObject* copy = new kvs::PointObject();
+            copy->shallowCopy( *kvs::PointObject::DownCast( object ) );
+            return copy;
+        }
+        case kvs::GeometryObjectBase::Line:
+        {
+            kvs::LineObject* copy = new kvs::LineObject();
+            copy->shallowCopy( *kvs::LineObject::DownCast( object ) );
+            return copy;
+        }
+        case kvs::GeometryObjectBase::Polygon:
+        {
+            kvs::PolygonObject* copy = new kvs::PolygonObject();
+            copy->shallowCopy( *kvs::PolygonObject::DownCast( object ) );
+            return copy;
+        }
+        default: break;
+        }
+        break;
+    }
+    case kvs::ObjectBase::Volume:
+    {
+        const kvs::VolumeObjectBase* volume = kvs::VolumeObjectBase::DownCast( object );
+        switch ( volume->volumeType() )
+        {
+        case kvs::VolumeObjectBase::Structured:
+        {
+            kvs::StructuredVolumeObject* copy = new kvs::StructuredVolumeObject();
+            copy->shallowCopy( *kvs::StructuredVolumeObject::DownCast( object ) );
+            return copy;
+        }
+        case kvs::VolumeObjectBase::Unstructured:
+        {
+            kvs::UnstructuredVolumeObject* copy = new kvs::UnstructuredVolumeObject();
+            copy->shallowCopy( *kvs::UnstructuredVolumeObject::DownCast( object ) );
+            return copy;
+        }
+        default: break;
+        }
+        break;
+    }
+    case kvs::ObjectBase::Image:
+    {
+        kvs::ImageObject* copy = new kvs::ImageObject();
+        copy->shallowCopy( *kvs::ImageObject::DownCast( object ) );
+        return copy;
+    }
+    default: break;
+    }
+
+    return NULL;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new PipelineCache class.
+ *  @param  max_byte_size [in] memory budget in bytes
+ */
+/*===========================================================================*/
+PipelineCache::PipelineCache( const size_t max_byte_size ):
+    m_max_byte_size( max_byte_size ),
+    m_byte_size( 0 )
+{
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Destroys the PipelineCache class.
+ */
+/*===========================================================================*/
+PipelineCache::~PipelineCache()
+{
+    this->clear();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sets the memory budget.
+ *  @param  max_byte_size [in] memory budget in bytes
+ */
+/*===========================================================================*/
+void PipelineCache::setMaxByteSize( const size_t max_byte_size )
+{
+    kvs::MutexLocker locker( &m_mutex );
+    m_max_byte_size = max_byte_size;
+    this->evict();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sets the directory where the evicted objects are written.
+ *  @param  directory [in] directory path (the objects are not written if empty)
+ */
+/*===========================================================================*/
+void PipelineCache::setSpillDirectory( const std::string& directory )
+{
+    kvs::MutexLocker locker( &m_mutex );
+    if ( !directory.empty() && !kvs::Directory( directory ).exists() )
+    {
+        if ( !kvs::Directory::Make( directory ) )
+        {
+            kvsMessageError( "Cannot create the directory: %s.", directory.c_str() );
+            return;
+        }
+    }
+    m_spill_directory = directory;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns true if the object for the key is cached.
+ *  @param  key [in] cache key
+ *  @return true if the object is cached in memory or in the spill directory
+ */
+/*===========================================================================*/
+bool PipelineCache::contains( const std::string& key ) const
+{
+    kvs::MutexLocker locker( &m_mutex );
+    return m_entry_map.find( key ) != m_entry_map.end() || this->is_spilled( key );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Finds the object for the key.
+ *  @param  key [in] cache key
+ *  @return pointer to a shallow copy of the cached object (NULL if not found)
+ *
+ *  The returned object is owned by the caller.
+ */
+/*===========================================================================*/
+kvs::ObjectBase* PipelineCache::find( const std::string& key )
+{
+    kvs::MutexLocker locker( &m_mutex );
+
+    EntryMap::iterator entry = m_entry_map.find( key );
+    if ( entry != m_entry_map.end() )
+    {
+        // Mark the entry as the most recently used one.
+        m_entries.splice( m_entries.begin(), m_entries, entry->second );
+        return ShallowCopy( entry->second->object );
+    }
+
+    if ( this->is_spilled( key ) )
+    {
+        kvs::ObjectBase* object = this->restore( key );
+        if ( object )
+        {
+            kvs::ObjectBase* copy = ShallowCopy( object );
+            this->insert_entry( key, object );
+            this->evict();
+            return copy;
+        }
+    }
+
+    return NULL;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Inserts the object with the key.
+ *  @param  key [in] cache key
+ *  @param  object [in] pointer to the object (a shallow copy is cached)
+ *  @return true if the object is cached
+ */
+/*===========================================================================*/
+bool PipelineCache::insert( const std::string& key, const kvs::ObjectBase* object )
+{
+    kvs::MutexLocker locker( &m_mutex );
+
+    kvs::ObjectBase* copy = ShallowCopy( object );
+    if ( !copy ) return false;
+
+    EntryMap::iterator entry = m_entry_map.find( key );
+    if ( entry != m_entry_map.end() ) this->erase_entry( entry );
+
+    this->insert_entry( key, copy );
+    this->evict();
+
+    return m_entry_map.find( key ) != m_entry_map.end() || this->is_spilled( key );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Erases the object for the key from the memory.
+ *  @param  key [in] cache key
+ */
+/*===========================================================================*/
+void PipelineCache::erase( const std::string& key )
+{
+    kvs::MutexLocker locker( &m_mutex );
+
+    EntryMap::iterator entry = m_entry_map.find( key );
+    if ( entry != m_entry_map.end() ) this->erase_entry( entry );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Erases all of the objects from the memory.
+ */
+/*===========================================================================*/
+void PipelineCache::clear()
+{
+    kvs::MutexLocker locker( &m_mutex );
+
+    for ( EntryList::iterator entry = m_entries.begin(); entry != m_entries.end(); ++entry )
+    {
+        delete entry->object;
+    }
+    m_entries.clear();
+    m_entry_map.clear();
+    m_byte_size = 0;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Inserts the object as the most recently used one.
+ *  @param  key [in] cache key
+ *  @param  object [in] pointer to the object (owned by the cache)
+ */
+/*===========================================================================*/
+void PipelineCache::insert_entry( const std::string& key, kvs::ObjectBase* object )
+{
+    Entry entry;
+    entry.key = key;
+    entry.object = object;
+    entry.byte_size = ByteSize( object );
+    m_entries.push_front( entry );
+    m_entry_map[ key ] = m_entries.begin();
+    m_byte_size += entry.byte_size;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Erases the entry from the memory.
+ *  @param  entry [in] entry in the map
+ */
+/*===========================================================================*/
+void PipelineCache::erase_entry( EntryMap::iterator entry )
+{
+    m_byte_size -= entry->second->byte_size;
+    delete entry->second->object;
+    m_entries.erase( entry->second );
+    m_entry_map.erase( entry );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Evicts the least recently used objects until the budget is met.
+ */
+/*===========================================================================*/
+void PipelineCache::evict()
+{
+    while ( m_byte_size > m_max_byte_size && !m_entries.empty() )
+    {
+        const Entry& entry = m_entries.back();
+        if ( !m_spill_directory.empty() && !this->is_spilled( entry.key ) )
+        {
+            if ( !this->spill( entry.key, entry.object ) )
+            {
+                kvsMessageError( "Cannot write the evicted object to %s.", m_spill_directory.c_str() );
+            }
+        }
+
+        this->erase_entry( m_entry_map.find( entry.key ) );
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Writes the object to the spill directory.
+ *  @param  key [in] cache key
+ *  @param  object [in] pointer to the object
+ *  @return true if the object is written successfully
+ */
+/*===========================================================================*/
+bool PipelineCache::spill( const std::string& key, const kvs::ObjectBase* object ) const
+{
+    if ( !::WriteKVSML( object, this->spill_filename( key, "kvsml" ) ) ) return false;
+
+    // The key is written after the object, so that an incomplete object is
+    // not read back.
+    std::ofstream file( this->spill_filename( key, "key" ).c_str(), std::ios::out | std::ios::binary );
+    if ( !file ) return false;
+    file << key;
+    return file.good();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns true if the object for the key is in the spill directory.
+ *  @param  key [in] cache key
+ *  @return true if the object is spilled
+ */
+/*===========================================================================*/
+bool PipelineCache::is_spilled( const std::string& key ) const
+{
+    if ( m_spill_directory.empty() ) return false;
+
+    // The key file is compared with the key to avoid the hash collision.
+    std::ifstream file( this->spill_filename( key, "key" ).c_str(), std::ios::in | std::ios::binary );
+    if ( !file ) return false;
+
+    std::string spilled_key( ( std::istreambuf_iterator<char>( file ) ), std::istreambuf_iterator<char>() );
+    return spilled_key == key && kvs::File( this->spill_filename( key, "kvsml" ) ).exists();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Reads the object for the key from the spill directory.
+ *  @param  key [in] cache key
+ *  @return pointer to the object (NULL if failed)
+ */
+/*===========================================================================*/
+kvs::ObjectBase* PipelineCache::restore( const std::string& key ) const
+{
+    kvs::ObjectImporter importer( this->spill_filename( key, "kvsml" ) );
+    return importer.import();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the filename of the spilled object.
+ *  @param  key [in] cache key
+ *  @param  extension [in] file extension
+ *  @return filename
+ */
+/*===========================================================================*/
+std::string PipelineCache::spill_filename( const std::string& key, const std::string& extension ) const
+{
+    char hash[17];
+    sprintf( hash, "%016llx", static_cast<unsigned long long>( ::Hash( key ) ) );
+    return m_spill_directory + kvs::File::Separator() + "kvs_pipeline_" + hash + "." + extension;
+}
+
+} // end of namespace kvs
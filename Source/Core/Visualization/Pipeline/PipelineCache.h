@@ -0,0 +1,105 @@
+/*****************************************************************************/
+/**
+ *  @file   PipelineCache.h
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#ifndef KVS__PIPELINE_CACHE_H_INCLUDE
+#define KVS__PIPELINE_CACHE_H_INCLUDE
+
+#include <string>
+#include <list>
+#include <map>
+#include <kvs/ObjectBase>
+#include <kvs/Mutex>
+#include <kvs/Noncopyable>
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Result cache class for the visualization pipeline.
+ *
+ *  The cache keeps the objects resulting from the stages of the visualization
+ *  pipeline with the keys, which are built from the identity of the input
+ *  file and the parameters of the modules by kvs::VisualizationPipeline. The
+ *  objects are kept as shallow copies, so that the data arrays are shared
+ *  with the original objects.
+ *
+ *  When the total byte size of the cached objects exceeds the memory budget,
+ *  the least recently used objects are evicted. If the spill directory is
+ *  specified, the evicted objects are written to the directory in the KVSML
+ *  format with the external binary data, and read back when they are found
+ *  again. The spilled files are named after the hash of the key and left in
+ *  the directory, so that they can be reused by the later processes.
+ */
+/*===========================================================================*/
+class PipelineCache : private kvs::Noncopyable
+{
+private:
+
+    struct Entry
+    {
+        std::string key; ///< cache key
+        kvs::ObjectBase* object; ///< cached object
+        size_t byte_size; ///< byte size of the object data
+    };
+
+    typedef std::list<Entry> EntryList;
+    typedef std::map<std::string,EntryList::iterator> EntryMap;
+
+    size_t m_max_byte_size; ///< memory budget in bytes
+    size_t m_byte_size; ///< total byte size of the cached objects
+    std::string m_spill_directory; ///< directory for the evicted objects (not spilled if empty)
+    EntryList m_entries; ///< cached objects in the order of the recent use
+    EntryMap m_entry_map; ///< map from the key to the cached object
+    mutable kvs::Mutex m_mutex; ///< mutex for the access from the threads
+
+public:
+
+    static PipelineCache& Shared();
+    static size_t ByteSize( const kvs::ObjectBase* object );
+    static kvs::ObjectBase* ShallowCopy( const kvs::ObjectBase* object );
+
+public:
+
+    explicit PipelineCache( const size_t max_byte_size = 1024 * 1024 * 1024 );
+    ~PipelineCache();
+
+    size_t maxByteSize() const { return m_max_byte_size; }
+    size_t byteSize() const { return m_byte_size; }
+    size_t numberOfObjects() const { return m_entries.size(); }
+    const std::string& spillDirectory() const { return m_spill_directory; }
+
+    void setMaxByteSize( const size_t max_byte_size );
+    void setSpillDirectory( const std::string& directory );
+
+    bool contains( const std::string& key ) const;
+    kvs::ObjectBase* find( const std::string& key );
+    bool insert( const std::string& key, const kvs::ObjectBase* object );
+    void erase( const std::string& key );
+    void clear();
+
+private:
+
+    void insert_entry( const std::string& key, kvs::ObjectBase* object );
+    void erase_entry( EntryMap::iterator entry );
+    void evict();
+    bool spill( const std::string& key, const kvs::ObjectBase* object ) const;
+    bool is_spilled( const std::string& key ) const;
+    kvs::ObjectBase* restore( const std::string& key ) const;
+    std::string spill_filename( const std::string& key, const std::string& extension ) const;
+};
+
+} // end of namespace kvs
+
+#endif // KVS__PIPELINE_CACHE_H_INCLUDE
@@ -27,7 +27,8 @@ namespace kvs
 PipelineModule::PipelineModule():
     m_auto_delete( true ),
     m_counter( 0 ),
-    m_category( Empty )
+    m_category( Empty ),
+    m_has_parameters( false )
 {
     memset( &m_module, 0, sizeof( Module ) );
 }
@@ -41,7 +42,8 @@ PipelineModule::PipelineModule():
 PipelineModule::PipelineModule( const PipelineModule& module ):
     m_auto_delete( true ),
     m_counter( 0 ),
-    m_category( Empty )
+    m_category( Empty ),
+    m_has_parameters( false )
 {
     memset( &m_module, 0, sizeof( Module ) );
     this->shallow_copy( module );
@@ -177,6 +179,8 @@ void PipelineModule::shallow_copy( const PipelineModule& module )
     m_counter = module.m_counter;
     m_category = module.m_category;
     m_module = module.m_module;
+    m_has_parameters = module.m_has_parameters;
+    m_parameters = module.m_parameters;
     this->ref();
 }
 
@@ -192,6 +196,8 @@ void PipelineModule::deep_copy( const PipelineModule& module )
     this->create_counter();
     m_category = module.m_category;
     m_module = module.m_module;
+    m_has_parameters = module.m_has_parameters;
+    m_parameters = module.m_parameters;
 }
 
 /*===========================================================================*/
@@ -16,6 +16,7 @@
 #define KVS__PIPELINE_MODULE_H_INCLUDE
 
 #include <cstring>
+#include <string>
 #include <kvs/FilterBase>
 #include <kvs/MapperBase>
 #include <kvs/ObjectBase>
@@ -62,6 +63,8 @@ protected:
     kvs::ReferenceCounter* m_counter;  ///< Reference counter.
     Category m_category; ///< module category
     Module m_module; ///< pointer to the module (SHARED)
+    bool m_has_parameters; ///< flag whether the parameters are specified or not
+    std::string m_parameters; ///< module parameters used as the cache key
 
 public:
 
@@ -70,7 +73,8 @@ public:
     explicit PipelineModule( T* module ):
         m_auto_delete( true ),
         m_counter( 0 ),
-        m_category( Empty )
+        m_category( Empty ),
+        m_has_parameters( false )
     {
         memset( &m_module, 0, sizeof( Module ) );
         this->create_counter( 1 );
@@ -96,6 +100,9 @@ public:
     const kvs::RendererBase* renderer() const { return m_module.renderer; }
     const char* name() const;
     bool unique() const;
+    bool hasParameters() const { return m_has_parameters; }
+    const std::string& parameters() const { return m_parameters; }
+    void setParameters( const std::string& parameters ) { m_parameters = parameters; m_has_parameters = true; }
 
 private:
 
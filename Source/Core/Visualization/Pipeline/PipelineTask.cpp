@@ -0,0 +1,527 @@
+/*****************************************************************************/
+/**
+ *  @file   PipelineTask.cpp
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#include "PipelineTask.h"
+#include <deque>
+#include <algorithm>
+#include <kvs/ObjectImporter>
+#include <kvs/PipelineCache>
+#include <kvs/VolumeObjectBase>
+#include <kvs/SystemInformation>
+#include <kvs/Thread>
+#include <kvs/MutexLocker>
+#include <kvs/Math>
+#include <kvs/Message>
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Worker pool class that executes the pipeline tasks.
+ *
+ *  The worker threads are started on demand up to the specified number, and
+ *  they wait for the tasks in the queue until the application is terminated.
+ */
+/*===========================================================================*/
+class PipelineTask::WorkerPool
+{
+private:
+
+    class Worker : public kvs::Thread
+    {
+    private:
+
+        WorkerPool* m_pool; ///< worker pool
+
+    public:
+
+        Worker( WorkerPool* pool ): m_pool( pool ) {}
+        void run() { m_pool->work(); }
+    };
+
+    size_t m_nworkers; ///< maximum number of the worker threads
+    size_t m_nidles; ///< number of the worker threads waiting for the tasks
+    bool m_quit; ///< flag for terminating the worker threads
+    std::deque<kvs::PipelineTask*> m_queue; ///< waiting tasks
+    std::vector<Worker*> m_workers; ///< worker threads
+    kvs::Mutex m_mutex; ///< mutex for the queue
+    kvs::Condition m_condition; ///< condition for waiting the tasks
+
+public:
+
+    static WorkerPool& Shared()
+    {
+        static WorkerPool pool;
+        return pool;
+    }
+
+    WorkerPool():
+        m_nworkers( kvs::Math::Max( kvs::SystemInformation::NumberOfProcessors(), size_t( 1 ) ) ),
+        m_nidles( 0 ),
+        m_quit( false )
+    {
+    }
+
+    ~WorkerPool()
+    {
+        m_mutex.lock();
+        m_quit = true;
+        m_mutex.unlock();
+        m_condition.wakeUpAll();
+
+        for ( size_t i = 0; i < m_workers.size(); i++ )
+        {
+            m_workers[i]->wait();
+            delete m_workers[i];
+        }
+    }
+
+    void setNumberOfWorkers( const size_t nworkers )
+    {
+        kvs::MutexLocker locker( &m_mutex );
+        m_nworkers = kvs::Math::Max( nworkers, size_t( 1 ) );
+    }
+
+    void push( kvs::PipelineTask* task )
+    {
+        m_mutex.lock();
+        m_queue.push_back( task );
+
+        // A new thread is started if the idle threads are not enough.
+        if ( m_nidles < m_queue.size() && m_workers.size() < m_nworkers )
+        {
+            Worker* worker = new Worker( this );
+            if ( worker->start() ) { m_workers.push_back( worker ); }
+            else { delete worker; }
+        }
+        const bool has_worker = !m_workers.empty();
+        m_mutex.unlock();
+
+        // The task is executed in the calling thread if no thread is available.
+        if ( !has_worker )
+        {
+            if ( this->remove( task ) ) task->run();
+            return;
+        }
+
+        m_condition.wakeUpOne();
+    }
+
+    bool remove( kvs::PipelineTask* task )
+    {
+        kvs::MutexLocker locker( &m_mutex );
+        std::deque<kvs::PipelineTask*>::iterator found = std::find( m_queue.begin(), m_queue.end(), task );
+        if ( found == m_queue.end() ) return false;
+
+        m_queue.erase( found );
+        return true;
+    }
+
+private:
+
+    void work()
+    {
+        for ( ; ; )
+        {
+            kvs::PipelineTask* task = NULL;
+            {
+                kvs::MutexLocker locker( &m_mutex );
+                m_nidles++;
+                while ( m_queue.empty() && !m_quit ) { m_condition.wait( &m_mutex ); }
+                m_nidles--;
+                if ( m_quit ) return;
+
+                task = m_queue.front();
+                m_queue.pop_front();
+            }
+
+            task->run();
+        }
+    }
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Sets the maximum number of the worker threads.
+ *  @param  nworkers [in] number of the worker threads (number of the processors by default)
+ */
+/*===========================================================================*/
+void PipelineTask::SetNumberOfWorkers( const size_t nworkers )
+{
+    WorkerPool::Shared().setNumberOfWorkers( nworkers );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new PipelineTask class for the input data file.
+ *  @param  filename [in] input data filename
+ */
+/*===========================================================================*/
+PipelineTask::PipelineTask( const std::string& filename ):
+    m_filename( filename ),
+    m_input( NULL ),
+    m_levels( 1 ),
+    m_listener( NULL ),
+    m_started( false ),
+    m_state( Waiting ),
+    m_cancel( false ),
+    m_nstages( 0 ),
+    m_stage( 0 ),
+    m_result( NULL ),
+    m_result_level( 0 )
+{
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new PipelineTask class for the input object.
+ *  @param  object [in] pointer to the input object (not deleted by the task)
+ */
+/*===========================================================================*/
+PipelineTask::PipelineTask( const kvs::ObjectBase* object ):
+    m_filename(""),
+    m_input( object ),
+    m_levels( 1 ),
+    m_listener( NULL ),
+    m_started( false ),
+    m_state( Waiting ),
+    m_cancel( false ),
+    m_nstages( 0 ),
+    m_stage( 0 ),
+    m_result( NULL ),
+    m_result_level( 0 )
+{
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Destroys the PipelineTask class.
+ *
+ *  The task is canceled, and the destructor waits for the worker thread if
+ *  the task is running.
+ */
+/*===========================================================================*/
+PipelineTask::~PipelineTask()
+{
+    this->cancel();
+    this->wait();
+    if ( m_result ) delete m_result;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Connects a module to the current level.
+ *  @param  module [in] pipeline module
+ *  @return reference to the task
+ */
+/*===========================================================================*/
+PipelineTask& PipelineTask::connect( kvs::PipelineModule& module )
+{
+    m_levels.back().push_back( module );
+    return *this;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Adds a level executed after the current one.
+ *  @return reference to the task
+ *
+ *  The modules connected after this method are applied to the imported object
+ *  after the modules of the current level, and their result replaces the one
+ *  of the current level.
+ */
+/*===========================================================================*/
+PipelineTask& PipelineTask::addLevel()
+{
+    m_levels.push_back( ModuleList() );
+    return *this;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sets a listener for the progress of the task.
+ *  @param  listener [in] pointer to the listener (not deleted by the task)
+ */
+/*===========================================================================*/
+void PipelineTask::setListener( Listener* listener )
+{
+    m_listener = listener;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the execution state.
+ *  @return execution state
+ */
+/*===========================================================================*/
+PipelineTask::State PipelineTask::state() const
+{
+    kvs::MutexLocker locker( &m_mutex );
+    return m_state;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns true if the task has been finished, canceled or failed.
+ *  @return true if the task is done
+ */
+/*===========================================================================*/
+bool PipelineTask::isDone() const
+{
+    const State state = this->state();
+    return state == Finished || state == Canceled || state == Failed;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the progress of the task.
+ *  @return ratio of the finished stages in [0,1]
+ */
+/*===========================================================================*/
+float PipelineTask::progress() const
+{
+    kvs::MutexLocker locker( &m_mutex );
+    return m_nstages > 0 ? static_cast<float>( m_stage ) / m_nstages : 0.0f;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Starts the task on a worker thread.
+ *  @return true if the task is started
+ */
+/*===========================================================================*/
+bool PipelineTask::start()
+{
+    {
+        kvs::MutexLocker locker( &m_mutex );
+        if ( m_started )
+        {
+            kvsMessageError( "The task has already been started." );
+            return false;
+        }
+
+        // The stages are the import (or the input object) and the modules.
+        m_nstages = 1;
+        for ( size_t i = 0; i < m_levels.size(); i++ ) { m_nstages += m_levels[i].size(); }
+        m_started = true;
+    }
+
+    WorkerPool::Shared().push( this );
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Cancels the task.
+ *
+ *  The running task stops before the next stage, and its results after the
+ *  cancellation are discarded. The result which has already been arrived can
+ *  be taken after the cancellation.
+ */
+/*===========================================================================*/
+void PipelineTask::cancel()
+{
+    m_mutex.lock();
+    m_cancel = true;
+    const bool started = m_started;
+    m_mutex.unlock();
+
+    // The task which is not executed yet is removed from the queue.
+    if ( started && WorkerPool::Shared().remove( this ) ) this->set_state( Canceled );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Waits for the task to be done.
+ *  @return true if the task has been finished successfully
+ */
+/*===========================================================================*/
+bool PipelineTask::wait()
+{
+    kvs::MutexLocker locker( &m_mutex );
+    if ( !m_started ) return false;
+
+    while ( m_state == Waiting || m_state == Running ) { m_condition.wait( &m_mutex ); }
+    return m_state == Finished;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns true if the result which has not been taken is available.
+ *  @return true if the result is available
+ */
+/*===========================================================================*/
+bool PipelineTask::hasResult() const
+{
+    kvs::MutexLocker locker( &m_mutex );
+    return m_result != NULL;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Takes the latest result.
+ *  @param  level [out] level of the result (optional)
+ *  @return pointer to the result object (owned by the caller), or NULL if not available
+ *
+ *  The result is a shallow copy of the output of the last module in the
+ *  level, so that it can be registered to the scene independently of the
+ *  lifetime of the task and the modules. The results which have not been
+ *  taken before a later result arrives are deleted.
+ */
+/*===========================================================================*/
+kvs::ObjectBase* PipelineTask::takeResult( size_t* level )
+{
+    kvs::MutexLocker locker( &m_mutex );
+    kvs::ObjectBase* result = m_result;
+    if ( level ) *level = m_result_level;
+    m_result = NULL;
+    return result;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Executes the stages of the task (called from the worker thread).
+ */
+/*===========================================================================*/
+void PipelineTask::run()
+{
+    if ( this->is_canceled() ) { this->set_state( Canceled ); return; }
+    this->set_state( Running );
+
+    // Import the input object.
+    kvs::ObjectBase* imported = NULL;
+    const kvs::ObjectBase* input = m_input;
+    if ( !input )
+    {
+        kvs::ObjectImporter importer( m_filename );
+        imported = importer.import();
+        if ( !imported )
+        {
+            kvsMessageError( "Cannot import '%s'.", m_filename.c_str() );
+            this->set_state( Failed );
+            return;
+        }
+        input = imported;
+    }
+    this->finish_stage();
+
+    State state = Finished;
+    for ( size_t level = 0; level < m_levels.size() && state == Finished; level++ )
+    {
+        const kvs::ObjectBase* object = input;
+        for ( size_t i = 0; i < m_levels[level].size(); i++ )
+        {
+            if ( this->is_canceled() ) { state = Canceled; break; }
+
+            object = m_levels[level][i].exec( object );
+            if ( !object )
+            {
+                kvsMessageError( "Cannot execute '%s'.", m_levels[level][i].name() );
+                state = Failed;
+                break;
+            }
+            this->finish_stage();
+        }
+        if ( state != Finished ) break;
+        if ( this->is_canceled() ) { state = Canceled; break; }
+
+        // The level without the modules results in the input object.
+        kvs::ObjectBase* result = kvs::PipelineCache::ShallowCopy( object );
+        if ( !result )
+        {
+            kvsMessageError( "Cannot copy the result of the level %d.", int( level ) );
+            state = Failed;
+            break;
+        }
+
+        // The min/max values are calculated here rather than in the scene, so
+        // that the calling thread is not blocked.
+        if ( !result->hasMinMaxObjectCoords() ) result->updateMinMaxCoords();
+        if ( result->objectType() == kvs::ObjectBase::Volume )
+        {
+            const kvs::VolumeObjectBase* volume = kvs::VolumeObjectBase::DownCast( result );
+            if ( !volume->hasMinMaxValues() ) volume->updateMinMaxValues();
+        }
+
+        this->set_result( result, level );
+    }
+
+    if ( imported ) delete imported;
+
+    if ( m_listener ) m_listener->finished( this, state );
+    this->set_state( state );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns true if the task is canceled.
+ *  @return true if canceled
+ */
+/*===========================================================================*/
+bool PipelineTask::is_canceled() const
+{
+    kvs::MutexLocker locker( &m_mutex );
+    return m_cancel;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Counts up the finished stages and reports the progress.
+ */
+/*===========================================================================*/
+void PipelineTask::finish_stage()
+{
+    m_mutex.lock();
+    m_stage++;
+    const float progress = static_cast<float>( m_stage ) / m_nstages;
+    m_mutex.unlock();
+
+    if ( m_listener ) m_listener->progress( this, progress );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sets the result of the level.
+ *  @param  object [in] pointer to the result object
+ *  @param  level [in] level
+ */
+/*===========================================================================*/
+void PipelineTask::set_result( kvs::ObjectBase* object, const size_t level )
+{
+    m_mutex.lock();
+    if ( m_result ) delete m_result;
+    m_result = object;
+    m_result_level = level;
+    m_mutex.unlock();
+
+    if ( m_listener ) m_listener->resultArrived( this, level );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sets the execution state, and wakes up the waiting threads if done.
+ *  @param  state [in] execution state
+ */
+/*===========================================================================*/
+void PipelineTask::set_state( const State state )
+{
+    // The waiting threads are woken up with the mutex locked, since the task
+    // may be deleted by them as soon as the mutex is unlocked.
+    kvs::MutexLocker locker( &m_mutex );
+    m_state = state;
+    if ( state != Waiting && state != Running ) m_condition.wakeUpAll();
+}
+
+} // end of namespace kvs
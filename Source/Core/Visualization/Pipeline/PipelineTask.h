@@ -0,0 +1,139 @@
+/*****************************************************************************/
+/**
+ *  @file   PipelineTask.h
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#ifndef KVS__PIPELINE_TASK_H_INCLUDE
+#define KVS__PIPELINE_TASK_H_INCLUDE
+
+#include <string>
+#include <vector>
+#include <kvs/ObjectBase>
+#include <kvs/PipelineModule>
+#include <kvs/Mutex>
+#include <kvs/Condition>
+#include <kvs/Noncopyable>
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Pipeline task class executed in the background.
+ *
+ *  The task imports the input data and executes the modules on a worker
+ *  thread of the shared pool, so that the calling thread (e.g. the event loop
+ *  of the viewer) is not blocked. The task is used as a handle to the result:
+ *  the state and the progress are queried, the execution is canceled, and the
+ *  result is taken when it is available.
+ *
+ *  The modules are grouped into the levels, each of which is applied to the
+ *  imported object in order. By connecting a coarse (fast) mapper to the first
+ *  level and the full-resolution one to the next level, the coarse result can
+ *  be shown first and replaced with the full result by
+ *  kvs::Scene::replaceObject() when it arrives.
+ *
+ *  The progress is reported per stage (the import and the modules), and the
+ *  cancellation takes effect between the stages, since the importers and the
+ *  modules cannot be interrupted.
+ */
+/*===========================================================================*/
+class PipelineTask : private kvs::Noncopyable
+{
+public:
+
+    enum State
+    {
+        Waiting, ///< waiting for a worker thread
+        Running, ///< running on a worker thread
+        Finished, ///< finished successfully
+        Canceled, ///< canceled
+        Failed ///< failed to import or execute
+    };
+
+    /*=======================================================================*/
+    /**
+     *  @brief  Listener class for the progress of the task.
+     *
+     *  The methods are called from the worker thread, so that the objects
+     *  shared with the other threads (e.g. the scene) must not be accessed.
+     */
+    /*=======================================================================*/
+    class Listener
+    {
+    public:
+
+        virtual ~Listener() {}
+        virtual void progress( kvs::PipelineTask* task, const float progress ) {}
+        virtual void resultArrived( kvs::PipelineTask* task, const size_t level ) {}
+        virtual void finished( kvs::PipelineTask* task, const State state ) {}
+    };
+
+private:
+
+    class WorkerPool;
+    friend class WorkerPool;
+
+    typedef std::vector<kvs::PipelineModule> ModuleList;
+
+    std::string m_filename; ///< input data filename
+    const kvs::ObjectBase* m_input; ///< input object (not deleted by the task)
+    std::vector<ModuleList> m_levels; ///< modules of the levels
+    Listener* m_listener; ///< listener (not deleted by the task)
+    bool m_started; ///< flag whether the task has been started
+    State m_state; ///< execution state
+    bool m_cancel; ///< flag for canceling the task
+    size_t m_nstages; ///< number of the stages
+    size_t m_stage; ///< number of the finished stages
+    kvs::ObjectBase* m_result; ///< latest result (NULL if taken)
+    size_t m_result_level; ///< level of the latest result
+    mutable kvs::Mutex m_mutex; ///< mutex for the state and the result
+    kvs::Condition m_condition; ///< condition for waiting the task
+
+public:
+
+    static void SetNumberOfWorkers( const size_t nworkers );
+
+public:
+
+    explicit PipelineTask( const std::string& filename );
+    explicit PipelineTask( const kvs::ObjectBase* object );
+    ~PipelineTask();
+
+    PipelineTask& connect( kvs::PipelineModule& module );
+    PipelineTask& addLevel();
+    void setListener( Listener* listener );
+
+    size_t numberOfLevels() const { return m_levels.size(); }
+    State state() const;
+    bool isDone() const;
+    float progress() const;
+
+    bool start();
+    void cancel();
+    bool wait();
+
+    bool hasResult() const;
+    kvs::ObjectBase* takeResult( size_t* level = NULL );
+
+private:
+
+    void run();
+    bool is_canceled() const;
+    void finish_stage();
+    void set_result( kvs::ObjectBase* object, const size_t level );
+    void set_state( const State state );
+};
+
+} // end of namespace kvs
+
+#endif // KVS__PIPELINE_TASK_H_INCLUDE
@@ -13,6 +13,8 @@
  */
 /****************************************************************************/
 #include "VisualizationPipeline.h"
+#include <sstream>
+#include <iomanip>
 #include <kvs/DebugNew>
 #include <kvs/ObjectImporter>
 #include <kvs/File>
@@ -21,6 +23,8 @@
 #include <kvs/LineRenderer>
 #include <kvs/PolygonRenderer>
 #include <kvs/RayCastingRenderer>
+#include <kvs/MapperBase>
+#include <kvs/TransferFunction>
 
 
 // Static parameters.
@@ -47,6 +51,57 @@ void ExitFunction()
     ::context.clear();
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Returns the cache key for the input file.
+ *  @param  filename [in] input data filename
+ *  @return cache key (empty if the file does not exist)
+ */
+/*===========================================================================*/
+std::string FileKey( const std::string& filename )
+{
+    const kvs::File file( filename );
+    if ( !file.exists() ) return "";
+
+    std::ostringstream key;
+    key << file.filePath( true ) << ":" << file.byteSize() << ":" << file.modificationTime();
+    return key.str();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the cache key for the pipeline module.
+ *  @param  module [in] pipeline module
+ *  @return cache key (empty if the module parameters are not specified)
+ */
+/*===========================================================================*/
+std::string ModuleKey( const kvs::PipelineModule& module )
+{
+    if ( !module.hasParameters() ) return "";
+
+    std::ostringstream key;
+    key << module.name() << "(" << module.parameters() << ")";
+
+    // The transfer function, which is common to the mappers, is included in
+    // the key as the FNV-1a hash of the table and the value range.
+    if ( module.category() == kvs::PipelineModule::Mapper )
+    {
+        const kvs::TransferFunction& tfunc = module.mapper()->transferFunction();
+        const kvs::ValueArray<kvs::Real32> table = tfunc.table();
+        const float range[2] = { tfunc.minValue(), tfunc.maxValue() };
+
+        kvs::UInt64 hash = 14695981039346656037ULL;
+        const kvs::UInt8* data = reinterpret_cast<const kvs::UInt8*>( table.data() );
+        for ( size_t i = 0; i < table.byteSize(); i++ ) { hash = ( hash ^ data[i] ) * 1099511628211ULL; }
+        data = reinterpret_cast<const kvs::UInt8*>( range );
+        for ( size_t i = 0; i < sizeof( range ); i++ ) { hash = ( hash ^ data[i] ) * 1099511628211ULL; }
+
+        key << "[" << std::hex << std::setw( 16 ) << std::setfill( '0' ) << hash << "]";
+    }
+
+    return key.str();
+}
+
 } // end of namespace
 
 
@@ -61,7 +116,8 @@ namespace kvs
 VisualizationPipeline::VisualizationPipeline():
     m_id( ::Counter++ ),
     m_filename(""),
-    m_cache( true ),
+    m_cache( false ),
+    m_result_cache( &kvs::PipelineCache::Shared() ),
     m_object( NULL ),
     m_renderer( NULL )
 {
@@ -78,7 +134,8 @@ VisualizationPipeline::VisualizationPipeline():
 VisualizationPipeline::VisualizationPipeline( const std::string& filename ):
     m_id( ::Counter++ ),
     m_filename( filename ),
-    m_cache( true ),
+    m_cache( false ),
+    m_result_cache( &kvs::PipelineCache::Shared() ),
     m_object( NULL ),
     m_renderer( NULL )
 {
@@ -95,7 +152,8 @@ VisualizationPipeline::VisualizationPipeline( const std::string& filename ):
 VisualizationPipeline::VisualizationPipeline( kvs::ObjectBase* object ):
     m_id( ::Counter++ ),
     m_filename(""),
-    m_cache( true ),
+    m_cache( false ),
+    m_result_cache( &kvs::PipelineCache::Shared() ),
     m_object( object ),
     m_renderer( NULL )
 {
@@ -111,6 +169,8 @@ VisualizationPipeline::VisualizationPipeline( kvs::ObjectBase* object ):
 VisualizationPipeline::~VisualizationPipeline()
 {
     m_module_list.clear();
+    for ( size_t i = 0; i < m_cached_objects.size(); i++ ) delete m_cached_objects[i];
+    m_cached_objects.clear();
     ::context[ m_id ] = 0;
 }
 
@@ -169,20 +229,48 @@ bool VisualizationPipeline::import()
 /*===========================================================================*/
 bool VisualizationPipeline::exec()
 {
+    // Cache keys of the stages, where the stage 0 is the import and the stage
+    // i is the i-th module.
+    std::vector<std::string> keys;
+    if ( m_cache && m_result_cache ) this->build_cache_keys( &keys );
+
+    // Find the last stage whose result is cached.
+    size_t stage = keys.size();
+    kvs::ObjectBase* cached_object = NULL;
+    while ( stage > 0 && !cached_object ) { cached_object = m_result_cache->find( keys[ --stage ] ); }
+
     // Setup object.
-    if ( !this->import() )
+    const kvs::ObjectBase* object = NULL;
+    if ( cached_object )
+    {
+        object = cached_object;
+    }
+    else
     {
-        kvsMessageError( "Cannot import the object." );
-        return false;
+        if ( !this->import() )
+        {
+            kvsMessageError( "Cannot import the object." );
+            return false;
+        }
+
+        object = m_object;
+        stage = 0;
+        if ( !keys.empty() ) m_result_cache->insert( keys[0], object );
     }
 
-    const kvs::ObjectBase* object = m_object;
     ModuleList::iterator module = m_module_list.begin();
     ModuleList::iterator last   = m_module_list.end();
 
     // Skip the renderer module since the renderer is executed in the display function.
     if ( this->hasRenderer() ) --last;
 
+    // Skip the modules whose results are restored from the cache.
+    std::advance( module, stage );
+
+    // The cached object is deleted with the pipeline unless it is passed to
+    // the renderer as the final result.
+    if ( cached_object && module != last ) m_cached_objects.push_back( cached_object );
+
     // Execute the filter or the mapper module.
     while ( module != last )
     {
@@ -194,6 +282,8 @@ bool VisualizationPipeline::exec()
         }
 
         ++module;
+        ++stage;
+        if ( stage < keys.size() ) m_result_cache->insert( keys[ stage ], object );
     }
 
     // Attache the pointer to the object that is registered in the object manager.
@@ -227,7 +317,7 @@ bool VisualizationPipeline::exec()
 
 /*===========================================================================*/
 /**
- *  @brief  Check whether the cache mechanism is enable or disable. (currently N/A)
+ *  @brief  Check whether the cache mechanism is enable or disable.
  *  @return true, if the cache is enable.
  */
 /*===========================================================================*/
@@ -256,6 +346,28 @@ void VisualizationPipeline::disableCache()
     m_cache = false;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Returns the pointer to the result cache.
+ *  @return pointer to the result cache
+ */
+/*===========================================================================*/
+kvs::PipelineCache* VisualizationPipeline::resultCache() const
+{
+    return m_result_cache;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sets the result cache used instead of the shared one.
+ *  @param  cache [in] pointer to the result cache (not deleted by the pipeline)
+ */
+/*===========================================================================*/
+void VisualizationPipeline::setResultCache( kvs::PipelineCache* cache )
+{
+    m_result_cache = cache;
+}
+
 /*===========================================================================*/
 /**
  *  @brief  Check whether the object module is included in the pipeline.
@@ -343,6 +455,35 @@ std::ostream& operator << ( std::ostream& os, const VisualizationPipeline& pipel
     return os;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Builds the cache keys of the stages.
+ *  @param  keys [out] cache keys, where keys[0] is for the import
+ *
+ *  The key of a stage is made by appending the module key to the key of the
+ *  previous stage, so that a change of the parameters invalidates the results
+ *  of the following stages. The keys are built until the module without the
+ *  parameters.
+ */
+/*===========================================================================*/
+void VisualizationPipeline::build_cache_keys( std::vector<std::string>* keys ) const
+{
+    if ( m_filename.empty() ) return;
+
+    std::string key = ::FileKey( m_filename );
+    ModuleList::const_iterator module = m_module_list.begin();
+    ModuleList::const_iterator end = m_module_list.end();
+    while ( !key.empty() )
+    {
+        keys->push_back( key );
+        if ( module == end || module->category() == kvs::PipelineModule::Renderer ) break;
+
+        const std::string module_key = ::ModuleKey( *module );
+        key = module_key.empty() ? "" : key + " >> " + module_key;
+        ++module;
+    }
+}
+
 /*===========================================================================*/
 /**
  *  @brief  Create a renderer module according to the rendering object.
@@ -18,12 +18,14 @@
 #include <iostream>
 #include <string>
 #include <list>
+#include <vector>
 #include <kvs/ObjectBase>
 #include <kvs/GeometryObjectBase>
 #include <kvs/VolumeObjectBase>
 #include <kvs/RendererBase>
 #include <kvs/Module>
 #include <kvs/PipelineModule>
+#include <kvs/PipelineCache>
 
 
 namespace kvs
@@ -32,6 +34,15 @@ namespace kvs
 /*==========================================================================*/
 /**
  *  Visualization pipeline class.
+ *
+ *  If the cache is enabled, the results of the import and the modules are
+ *  kept in the result cache (kvs::PipelineCache::Shared() by default) with
+ *  the keys built from the identity of the input file (path, size and
+ *  modification time) and the parameters of the modules, and exec() starts
+ *  from the result of the last stage found in the cache. The parameters of
+ *  a module are given by kvs::PipelineModule::setParameters, together with
+ *  the transfer function for the mapper; the module without the parameters
+ *  and the following modules are always executed.
  */
 /*==========================================================================*/
 class VisualizationPipeline
@@ -44,7 +55,9 @@ private:
 
     size_t m_id; ///< pipeline ID
     std::string m_filename; ///< filename
-    bool m_cache; ///< cache mode (DISABLE NOW)
+    bool m_cache; ///< cache mode
+    kvs::PipelineCache* m_result_cache; ///< result cache
+    std::vector<kvs::ObjectBase*> m_cached_objects; ///< objects restored from the cache (owned by the pipeline)
     ModuleList m_module_list; ///< pipeline module list
 
     const kvs::ObjectBase* m_object; ///< pointer to the object inserted to the manager
@@ -67,6 +80,8 @@ public:
     bool cache() const;
     void enableCache();
     void disableCache();
+    kvs::PipelineCache* resultCache() const;
+    void setResultCache( kvs::PipelineCache* cache );
     bool hasObject() const;
     bool hasRenderer() const;
     const kvs::ObjectBase* object() const;
@@ -78,6 +93,7 @@ public:
 
 private:
 
+    void build_cache_keys( std::vector<std::string>* keys ) const;
     bool create_renderer_module( const kvs::ObjectBase* object );
     bool create_renderer_module( const kvs::GeometryObjectBase* geometry );
     bool create_renderer_module( const kvs::VolumeObjectBase* volume );
@@ -0,0 +1,224 @@
+/*****************************************************************************/
+/**
+ *  @file   HostFrameBuffer.cpp
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#include "HostFrameBuffer.h"
+#include <cstring>
+#include <kvs/Camera>
+#include <kvs/ObjectBase>
+#include <kvs/Xform>
+#include <kvs/Math>
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new HostFrameBuffer class.
+ */
+/*===========================================================================*/
+HostFrameBuffer::HostFrameBuffer():
+    m_width( 0 ),
+    m_height( 0 )
+{
+    kvs::Xform().toArray( m_modelview );
+    kvs::Xform().toArray( m_projection );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new HostFrameBuffer class.
+ *  @param  width [in] width of the frame buffer
+ *  @param  height [in] height of the frame buffer
+ */
+/*===========================================================================*/
+HostFrameBuffer::HostFrameBuffer( const size_t width, const size_t height ):
+    m_width( 0 ),
+    m_height( 0 )
+{
+    kvs::Xform().toArray( m_modelview );
+    kvs::Xform().toArray( m_projection );
+    this->create( width, height );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the viewport that covers the whole frame buffer.
+ *  @param  viewport [out] viewport (x, y, width, height)
+ */
+/*===========================================================================*/
+void HostFrameBuffer::getViewport( int viewport[4] ) const
+{
+    viewport[0] = 0;
+    viewport[1] = 0;
+    viewport[2] = static_cast<int>( m_width );
+    viewport[3] = static_cast<int>( m_height );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Allocates the color and depth data.
+ *  @param  width [in] width of the frame buffer
+ *  @param  height [in] height of the frame buffer
+ */
+/*===========================================================================*/
+void HostFrameBuffer::create( const size_t width, const size_t height )
+{
+    if ( m_width == width && m_height == height && m_color_data.size() > 0 ) return;
+
+    m_width = width;
+    m_height = height;
+    m_color_data.allocate( width * height * 4 );
+    m_depth_data.allocate( width * height );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Clears the frame buffer in the same way as glClear.
+ *  @param  color [in] background color
+ */
+/*===========================================================================*/
+void HostFrameBuffer::clear( const kvs::RGBColor& color )
+{
+    const size_t npixels = m_width * m_height;
+    kvs::UInt8* pixel = m_color_data.data();
+    for ( size_t i = 0; i < npixels; i++, pixel += 4 )
+    {
+        pixel[0] = color.r();
+        pixel[1] = color.g();
+        pixel[2] = color.b();
+        pixel[3] = 255;
+    }
+    m_depth_data.fill( 1.0f );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Clears the frame buffer with the translucent color.
+ *  @param  color [in] clear color
+ *
+ *  The color is stored with the premultiplied alpha, in the same way as the
+ *  images of the volume renderers, so that the frame buffer cleared with
+ *  the transparent color keeps only the rendered objects.
+ */
+/*===========================================================================*/
+void HostFrameBuffer::clear( const kvs::RGBAColor& color )
+{
+    const float opacity = kvs::Math::Clamp( color.a(), 0.0f, 1.0f );
+    const kvs::UInt8 r = static_cast<kvs::UInt8>( kvs::Math::Round( color.r() * opacity ) );
+    const kvs::UInt8 g = static_cast<kvs::UInt8>( kvs::Math::Round( color.g() * opacity ) );
+    const kvs::UInt8 b = static_cast<kvs::UInt8>( kvs::Math::Round( color.b() * opacity ) );
+    const kvs::UInt8 a = static_cast<kvs::UInt8>( kvs::Math::Round( opacity * 255.0f ) );
+
+    const size_t npixels = m_width * m_height;
+    kvs::UInt8* pixel = m_color_data.data();
+    for ( size_t i = 0; i < npixels; i++, pixel += 4 )
+    {
+        pixel[0] = r;
+        pixel[1] = g;
+        pixel[2] = b;
+        pixel[3] = a;
+    }
+    m_depth_data.fill( 1.0f );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sets the matrices for rendering the object.
+ *  @param  camera [in] pointer to the camera
+ *  @param  object [in] pointer to the object
+ *
+ *  The matrices are the same as the ones loaded by kvs::Scene::paintFunction,
+ *  that is, the modelview matrix is the viewing matrix of the camera
+ *  multiplied by the object xform.
+ */
+/*===========================================================================*/
+void HostFrameBuffer::setMatrices( const kvs::Camera* camera, const kvs::ObjectBase* object )
+{
+    const kvs::Xform modelview( camera->viewingMatrix() * object->xform().toMatrix() );
+    const kvs::Xform projection( camera->projectionMatrix() );
+    modelview.toArray( m_modelview );
+    projection.toArray( m_projection );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Reads the color and depth data in the same way as glReadPixels.
+ *  @param  color_data [out] color (RGBA) data
+ *  @param  depth_data [out] depth data
+ */
+/*===========================================================================*/
+void HostFrameBuffer::readPixels( kvs::UInt8* color_data, kvs::Real32* depth_data ) const
+{
+    memcpy( color_data, m_color_data.data(), m_color_data.byteSize() );
+    memcpy( depth_data, m_depth_data.data(), m_depth_data.byteSize() );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Draws the color and depth data into the frame buffer.
+ *  @param  color_data [in] color (RGBA) data (premultiplied by alpha)
+ *  @param  depth_data [in] depth data
+ *
+ *  The pixels are composited as kvs::VolumeRendererBase::drawImage does
+ *  with OpenGL: the depth is written with GL_LEQUAL depth test and then the
+ *  color is blended with (GL_ONE, GL_ONE_MINUS_SRC_ALPHA) without the depth
+ *  test.
+ */
+/*===========================================================================*/
+void HostFrameBuffer::drawPixels( const kvs::UInt8* color_data, const kvs::Real32* depth_data )
+{
+    const size_t npixels = m_width * m_height;
+    kvs::UInt8* dst_color = m_color_data.data();
+    kvs::Real32* dst_depth = m_depth_data.data();
+    for ( size_t i = 0, i4 = 0; i < npixels; i++, i4 += 4 )
+    {
+        if ( depth_data[i] <= dst_depth[i] ) { dst_depth[i] = depth_data[i]; }
+
+        const unsigned int src_alpha = color_data[ i4 + 3 ];
+        if ( src_alpha == 0 && color_data[i4] == 0 && color_data[ i4 + 1 ] == 0 && color_data[ i4 + 2 ] == 0 ) continue;
+
+        const unsigned int dst_weight = 255 - src_alpha;
+        for ( size_t c = 0; c < 4; c++ )
+        {
+            const unsigned int value = color_data[ i4 + c ] + ( dst_color[ i4 + c ] * dst_weight + 127 ) / 255;
+            dst_color[ i4 + c ] = static_cast<kvs::UInt8>( kvs::Math::Min( value, 255u ) );
+        }
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the color image of the frame buffer.
+ *  @return color image (the origin is the upper-left corner)
+ */
+/*===========================================================================*/
+kvs::ColorImage HostFrameBuffer::colorImage() const
+{
+    const size_t npixels = m_width * m_height;
+    kvs::ValueArray<kvs::UInt8> pixels( npixels * 3 );
+    const kvs::UInt8* src = m_color_data.data();
+    kvs::UInt8* dst = pixels.data();
+    for ( size_t i = 0; i < npixels; i++, src += 4, dst += 3 )
+    {
+        dst[0] = src[0];
+        dst[1] = src[1];
+        dst[2] = src[2];
+    }
+
+    kvs::ColorImage image( m_width, m_height, pixels );
+    image.flip();
+    return image;
+}
+
+} // end of namespace kvs
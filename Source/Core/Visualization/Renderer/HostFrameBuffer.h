@@ -0,0 +1,78 @@
+/*****************************************************************************/
+/**
+ *  @file   HostFrameBuffer.h
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#ifndef KVS__HOST_FRAME_BUFFER_H_INCLUDE
+#define KVS__HOST_FRAME_BUFFER_H_INCLUDE
+
+#include <kvs/Type>
+#include <kvs/ValueArray>
+#include <kvs/RGBColor>
+#include <kvs/RGBAColor>
+#include <kvs/ColorImage>
+#include <kvs/Noncopyable>
+
+
+namespace kvs
+{
+
+class Camera;
+class ObjectBase;
+
+/*===========================================================================*/
+/**
+ *  @brief  Frame buffer in the host memory for the rendering without OpenGL.
+ *
+ *  The frame buffer has the RGBA color and the depth of each pixel in the
+ *  same layout as the OpenGL frame buffer (the origin is the lower-left
+ *  corner), and the modelview and projection matrices, which are calculated
+ *  from the camera and the object xform instead of the OpenGL matrix stack.
+ *  The CPU volume renderers attached to the frame buffer read and draw
+ *  their images from/to the frame buffer in the same way as the OpenGL path.
+ */
+/*===========================================================================*/
+class HostFrameBuffer : private kvs::Noncopyable
+{
+private:
+
+    size_t m_width; ///< width of the frame buffer
+    size_t m_height; ///< height of the frame buffer
+    kvs::ValueArray<kvs::UInt8> m_color_data; ///< color (RGBA) data
+    kvs::ValueArray<kvs::Real32> m_depth_data; ///< depth data
+    float m_modelview[16]; ///< modelview matrix
+    float m_projection[16]; ///< projection matrix
+
+public:
+
+    HostFrameBuffer();
+    HostFrameBuffer( const size_t width, const size_t height );
+
+    size_t width() const { return m_width; }
+    size_t height() const { return m_height; }
+    const kvs::ValueArray<kvs::UInt8>& colorData() const { return m_color_data; }
+    const kvs::ValueArray<kvs::Real32>& depthData() const { return m_depth_data; }
+    const float* modelViewMatrix() const { return m_modelview; }
+    const float* projectionMatrix() const { return m_projection; }
+    void getViewport( int viewport[4] ) const;
+
+    void create( const size_t width, const size_t height );
+    void clear( const kvs::RGBColor& color );
+    void clear( const kvs::RGBAColor& color );
+    void setMatrices( const kvs::Camera* camera, const kvs::ObjectBase* object );
+    void readPixels( kvs::UInt8* color_data, kvs::Real32* depth_data ) const;
+    void drawPixels( const kvs::UInt8* color_data, const kvs::Real32* depth_data );
+    kvs::ColorImage colorImage() const;
+};
+
+} // end of namespace kvs
+
+#endif // KVS__HOST_FRAME_BUFFER_H_INCLUDE
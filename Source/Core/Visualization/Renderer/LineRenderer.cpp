@@ -14,6 +14,7 @@
 /****************************************************************************/
 #include "LineRenderer.h"
 #include "LineRenderingFunction.h"
+#include "SameArray.h"
 #include <kvs/OpenGL>
 #include <kvs/Camera>
 #include <kvs/Light>
@@ -22,6 +23,37 @@
 #include <kvs/IgnoreUnusedVariable>
 
 
+namespace
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns vertex-color (RGB) array.
+ *  @param  line [in] pointer to the line object
+ */
+/*===========================================================================*/
+kvs::ValueArray<kvs::UInt8> VertexColors( const kvs::LineObject* line )
+{
+    if ( line->numberOfColors() != 1 ) { return line->colors(); }
+
+    const size_t nvertices = line->numberOfVertices();
+    const kvs::UInt8* pcolors = line->colors().data();
+
+    kvs::ValueArray<kvs::UInt8> colors( nvertices * 3 );
+    kvs::UInt8* pdst = colors.data();
+    for ( size_t i = 0; i < nvertices; i++ )
+    {
+        *(pdst++) = pcolors[0];
+        *(pdst++) = pcolors[1];
+        *(pdst++) = pcolors[2];
+    }
+
+    return colors;
+}
+
+} // end of namespace
+
+
 namespace kvs
 {
 
@@ -32,7 +64,9 @@ namespace kvs
 /*==========================================================================*/
 LineRenderer::LineRenderer():
     m_enable_anti_aliasing( false ),
-    m_enable_multisample_anti_aliasing( false )
+    m_enable_multisample_anti_aliasing( false ),
+    m_enable_vertex_buffer_object( true ),
+    m_object( NULL )
 {
     // Disable shading since the line object don't have the normal vectors.
     this->disableShading();
@@ -69,7 +103,15 @@ void LineRenderer::exec( kvs::ObjectBase* object, kvs::Camera* camera, kvs::Ligh
     this->initialize();
 
     glEnable( GL_DEPTH_TEST );
-    ::LineRenderingFunction( line );
+    if ( m_enable_vertex_buffer_object && this->is_buffer_object_supported( line ) )
+    {
+        if ( this->is_buffer_object_updated( line ) ) { this->create_buffer_object( line ); }
+        this->draw_buffer_object( line );
+    }
+    else
+    {
+        ::LineRenderingFunction( line );
+    }
     glDisable( GL_DEPTH_TEST );
 
     glPopAttrib();
@@ -99,6 +141,41 @@ void LineRenderer::disableAntiAliasing() const
     m_enable_multisample_anti_aliasing = false;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Enables the vertex buffer object based rendering.
+ *
+ *  The lines with a single line width and vertex colors (or a single color)
+ *  are uploaded to the GPU only once; the others are rendered in immediate
+ *  mode.
+ */
+/*===========================================================================*/
+void LineRenderer::enableVertexBufferObject() const
+{
+    m_enable_vertex_buffer_object = true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Disables the vertex buffer object based rendering.
+ */
+/*===========================================================================*/
+void LineRenderer::disableVertexBufferObject() const
+{
+    m_enable_vertex_buffer_object = false;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns true if the vertex buffer object based rendering is enabled.
+ *  @return true, if the vertex buffer object is enabled
+ */
+/*===========================================================================*/
+bool LineRenderer::isEnabledVertexBufferObject() const
+{
+    return m_enable_vertex_buffer_object;
+}
+
 /*===========================================================================*/
 /**
  *  @brief  Initializes the OpenGL properties.
@@ -140,4 +217,147 @@ void LineRenderer::initialize()
     }
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Returns true if the line object can be drawn with the buffer objects.
+ *  @param  line [in] pointer to the line object
+ *  @return true, if the line object can be stored as per-vertex arrays
+ */
+/*===========================================================================*/
+bool LineRenderer::is_buffer_object_supported( const kvs::LineObject* line ) const
+{
+    const size_t nvertices = line->numberOfVertices();
+    const size_t ncolors = line->numberOfColors();
+    const bool is_vertex_color =
+        line->colorType() == kvs::LineObject::VertexColor && ncolors == nvertices;
+
+    // Single line width, and single color or vertex colors.
+    return line->numberOfSizes() == 1 && ( ncolors == 1 || is_vertex_color );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns true if the buffer objects need to be (re-)created.
+ *  @param  line [in] pointer to the line object
+ *  @return true, if the object or its arrays have been changed
+ */
+/*===========================================================================*/
+bool LineRenderer::is_buffer_object_updated( const kvs::LineObject* line ) const
+{
+    return m_object != line ||
+        !::IsSameArray( m_coords, line->coords() ) ||
+        !::IsSameArray( m_colors, line->colors() ) ||
+        !::IsSameArray( m_connections, line->connections() );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Creates the vertex and index buffer objects.
+ *  @param  line [in] pointer to the line object
+ */
+/*===========================================================================*/
+void LineRenderer::create_buffer_object( const kvs::LineObject* line )
+{
+    m_object = line;
+    m_coords = line->coords();
+    m_colors = line->colors();
+    m_connections = line->connections();
+
+    kvs::ValueArray<kvs::UInt8> colors = ::VertexColors( line );
+
+    const size_t coord_size = m_coords.byteSize();
+    const size_t color_size = colors.byteSize();
+
+    m_vbo.release();
+    m_vbo.create( coord_size + color_size );
+    m_vbo.bind();
+    m_vbo.load( coord_size, m_coords.data(), 0 );
+    m_vbo.load( color_size, colors.data(), coord_size );
+    m_vbo.unbind();
+
+    m_ibo.release();
+    m_first_array.release();
+    m_count_array.release();
+    switch ( line->lineType() )
+    {
+    case kvs::LineObject::Uniline:
+    case kvs::LineObject::Segment:
+    {
+        const size_t connection_size = m_connections.byteSize();
+        m_ibo.create( connection_size );
+        m_ibo.bind();
+        m_ibo.load( connection_size, m_connections.data(), 0 );
+        m_ibo.unbind();
+        break;
+    }
+    case kvs::LineObject::Polyline:
+    {
+        const size_t npolylines = line->numberOfConnections();
+        const kvs::UInt32* pconnections = m_connections.data();
+        m_first_array.allocate( npolylines );
+        m_count_array.allocate( npolylines );
+        for ( size_t i = 0; i < npolylines; i++ )
+        {
+            m_first_array[i] = pconnections[ 2 * i ];
+            m_count_array[i] = pconnections[ 2 * i + 1 ] - pconnections[ 2 * i ] + 1;
+        }
+        break;
+    }
+    default: break;
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Draws the line object stored in the buffer objects.
+ *  @param  line [in] pointer to the line object
+ */
+/*===========================================================================*/
+void LineRenderer::draw_buffer_object( const kvs::LineObject* line )
+{
+    const size_t nvertices = line->numberOfVertices();
+    const size_t coord_size = nvertices * 3 * sizeof( kvs::Real32 );
+
+    kvs::OpenGL::WithPushedClientAttrib attrib( GL_CLIENT_VERTEX_ARRAY_BIT );
+    kvs::VertexBufferObject::Binder bind1( m_vbo );
+
+    KVS_GL_CALL( glLineWidth( line->size() ) );
+
+    // Enable coords.
+    KVS_GL_CALL( glEnableClientState( GL_VERTEX_ARRAY ) );
+    KVS_GL_CALL( glVertexPointer( 3, GL_FLOAT, 0, (GLbyte*)NULL + 0 ) );
+
+    // Enable colors.
+    KVS_GL_CALL( glEnableClientState( GL_COLOR_ARRAY ) );
+    KVS_GL_CALL( glColorPointer( 3, GL_UNSIGNED_BYTE, 0, (GLbyte*)NULL + coord_size ) );
+
+    // Draw lines.
+    switch ( line->lineType() )
+    {
+    case kvs::LineObject::Strip:
+    {
+        KVS_GL_CALL( glDrawArrays( GL_LINE_STRIP, 0, nvertices ) );
+        break;
+    }
+    case kvs::LineObject::Uniline:
+    {
+        kvs::IndexBufferObject::Binder bind2( m_ibo );
+        KVS_GL_CALL( glDrawElements( GL_LINE_STRIP, m_connections.size(), GL_UNSIGNED_INT, 0 ) );
+        break;
+    }
+    case kvs::LineObject::Polyline:
+    {
+        KVS_GL_CALL( glMultiDrawArrays( GL_LINE_STRIP, m_first_array.data(), m_count_array.data(), m_first_array.size() ) );
+        break;
+    }
+    case kvs::LineObject::Segment:
+    {
+        kvs::IndexBufferObject::Binder bind2( m_ibo );
+        KVS_GL_CALL( glDrawElements( GL_LINES, m_connections.size(), GL_UNSIGNED_INT, 0 ) );
+        break;
+    }
+    default: break;
+    }
+}
+
 } // end of namespace kvs
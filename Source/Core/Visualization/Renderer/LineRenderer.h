@@ -17,6 +17,9 @@
 
 #include <kvs/RendererBase>
 #include <kvs/Module>
+#include <kvs/ValueArray>
+#include <kvs/VertexBufferObject>
+#include <kvs/IndexBufferObject>
 
 
 namespace kvs
@@ -25,6 +28,7 @@ namespace kvs
 class ObjectBase;
 class Camera;
 class Light;
+class LineObject;
 
 /*==========================================================================*/
 /**
@@ -40,6 +44,15 @@ private:
 
     mutable bool m_enable_anti_aliasing; ///< flag for anti-aliasing (AA)
     mutable bool m_enable_multisample_anti_aliasing; ///< flag for multisample anti-aliasing (MSAA)
+    mutable bool m_enable_vertex_buffer_object; ///< flag for the vertex buffer object (VBO)
+    const kvs::ObjectBase* m_object; ///< pointer to the object stored in the buffer objects
+    kvs::ValueArray<kvs::Real32> m_coords; ///< coordinate array stored in the VBO
+    kvs::ValueArray<kvs::UInt8> m_colors; ///< color array stored in the VBO
+    kvs::ValueArray<kvs::UInt32> m_connections; ///< connection array stored in the IBO
+    kvs::ValueArray<GLint> m_first_array; ///< array of starting indices for the polyline
+    kvs::ValueArray<GLsizei> m_count_array; ///< array of the number of indices for the polyline
+    kvs::VertexBufferObject m_vbo; ///< vertex buffer object
+    kvs::IndexBufferObject m_ibo; ///< index buffer object
 
 public:
 
@@ -48,12 +61,19 @@ public:
 
     void enableAntiAliasing( const bool multisample = false ) const;
     void disableAntiAliasing() const;
+    void enableVertexBufferObject() const;
+    void disableVertexBufferObject() const;
+    bool isEnabledVertexBufferObject() const;
 
     void exec( kvs::ObjectBase* object, kvs::Camera* camera, kvs::Light* light );
 
 private:
 
     void initialize();
+    bool is_buffer_object_supported( const kvs::LineObject* line ) const;
+    bool is_buffer_object_updated( const kvs::LineObject* line ) const;
+    void create_buffer_object( const kvs::LineObject* line );
+    void draw_buffer_object( const kvs::LineObject* line );
 };
 
 } // end of namespace kvs
@@ -0,0 +1,340 @@
+/*****************************************************************************/
+/**
+ *  @file   ParallelCoordinatesDensityMap.cpp
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#include "ParallelCoordinatesDensityMap.h"
+#include <cmath>
+#include <kvs/Math>
+
+
+namespace
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Task that counts the rows into the histogram of each gap.
+ */
+/*===========================================================================*/
+class CountTask : public kvs::BinnedTable::Task
+{
+private:
+
+    const std::vector<kvs::BinnedTable::Bins>* m_bins; ///< bin indices for each column
+    const kvs::TableObject::InsideRangeFlags* m_flags; ///< inside range flags
+    const std::vector<size_t>* m_rows; ///< changed rows (NULL: all the rows are counted)
+    size_t m_nbins; ///< number of bins
+    std::vector<kvs::ParallelCoordinatesDensityMap::Histogram>* m_histograms; ///< histograms for each gap
+
+public:
+
+    CountTask(
+        const std::vector<kvs::BinnedTable::Bins>* bins,
+        const kvs::TableObject::InsideRangeFlags* flags,
+        const std::vector<size_t>* rows,
+        const size_t nbins,
+        std::vector<kvs::ParallelCoordinatesDensityMap::Histogram>* histograms ):
+        m_bins( bins ),
+        m_flags( flags ),
+        m_rows( rows ),
+        m_nbins( nbins ),
+        m_histograms( histograms ) {}
+
+    void run( const size_t thread_index, const size_t nthreads )
+    {
+        for ( size_t i = thread_index; i < m_histograms->size(); i += nthreads ) this->count( i );
+    }
+
+private:
+
+    void count( const size_t index )
+    {
+        const kvs::UInt8* a = (*m_bins)[ index ].data();
+        const kvs::UInt8* b = (*m_bins)[ index + 1 ].data();
+        const kvs::UInt8* flags = &(*m_flags)[0];
+        kvs::UInt32* histogram = (*m_histograms)[ index ].data();
+
+        if ( !m_rows )
+        {
+            (*m_histograms)[ index ].fill( 0 );
+            const size_t nrows = m_flags->size();
+            for ( size_t i = 0; i < nrows; i++ )
+            {
+                if ( flags[i] ) histogram[ a[i] * m_nbins + b[i] ]++;
+            }
+        }
+        else
+        {
+            // The flags have been changed for the listed rows.
+            const size_t nrows = m_rows->size();
+            for ( size_t k = 0; k < nrows; k++ )
+            {
+                const size_t i = (*m_rows)[k];
+                if ( flags[i] ) histogram[ a[i] * m_nbins + b[i] ]++;
+                else histogram[ a[i] * m_nbins + b[i] ]--;
+            }
+        }
+    }
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Task that rasterizes the histogram of each gap into the density image.
+ */
+/*===========================================================================*/
+class RasterizeTask : public kvs::BinnedTable::Task
+{
+private:
+
+    const std::vector<kvs::ParallelCoordinatesDensityMap::Histogram>* m_histograms; ///< histograms for each gap
+    size_t m_nbins; ///< number of bins
+    size_t m_width; ///< image width
+    size_t m_height; ///< image height
+    kvs::Real32* m_density; ///< density image
+
+public:
+
+    RasterizeTask(
+        const std::vector<kvs::ParallelCoordinatesDensityMap::Histogram>* histograms,
+        const size_t nbins,
+        const size_t width,
+        const size_t height,
+        kvs::Real32* density ):
+        m_histograms( histograms ),
+        m_nbins( nbins ),
+        m_width( width ),
+        m_height( height ),
+        m_density( density ) {}
+
+    void run( const size_t thread_index, const size_t nthreads )
+    {
+        for ( size_t i = thread_index; i < m_histograms->size(); i += nthreads ) this->rasterize( i );
+    }
+
+private:
+
+    void rasterize( const size_t index )
+    {
+        // Each gap writes its own pixel columns, from the left axis to the
+        // column before the right axis (the last gap includes the right axis).
+        const size_t ngaps = m_histograms->size();
+        const double stride = double( m_width - 1 ) / ngaps;
+        const long x0 = static_cast<long>( kvs::Math::Round( stride * index ) );
+        const long x1 = static_cast<long>( kvs::Math::Round( stride * ( index + 1 ) ) );
+        const long xend = ( index == ngaps - 1 ) ? x1 + 1 : x1;
+        const double dx = x1 > x0 ? 1.0 / ( x1 - x0 ) : 0.0;
+        const double scale = double( m_height - 1 ) / ( m_nbins - 1 );
+
+        const kvs::UInt32* histogram = (*m_histograms)[ index ].data();
+        for ( size_t a = 0; a < m_nbins; a++ )
+        {
+            const double ya = a * scale + 0.5;
+            for ( size_t b = 0; b < m_nbins; b++ )
+            {
+                const kvs::UInt32 count = histogram[ a * m_nbins + b ];
+                if ( count == 0 ) continue;
+
+                // The line is drawn by the vertical spans between the
+                // neighboring pixel columns so that steep lines are continuous.
+                const double yb = b * scale + 0.5;
+                const kvs::Real32 value = static_cast<kvs::Real32>( count );
+                long y = static_cast<long>( ya );
+                for ( long x = x0; x < xend; x++ )
+                {
+                    const long ynext = static_cast<long>( ya + ( yb - ya ) * kvs::Math::Min( ( x - x0 + 1 ) * dx, 1.0 ) );
+                    const long ymin = kvs::Math::Min( y, ynext );
+                    const long ymax = kvs::Math::Max( y, ynext );
+                    kvs::Real32* pixel = m_density + ymin * m_width + x;
+                    for ( long k = ymin; k <= ymax; k++, pixel += m_width ) *pixel += value;
+                    y = ynext;
+                }
+            }
+        }
+    }
+};
+
+} // end of namespace
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new ParallelCoordinatesDensityMap class.
+ */
+/*===========================================================================*/
+ParallelCoordinatesDensityMap::ParallelCoordinatesDensityMap():
+    m_table( 256 ),
+    m_width( 0 ),
+    m_height( 0 )
+{
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sets the number of bins on each axis.
+ *  @param  resolution [in] number of bins (2 - 256)
+ */
+/*===========================================================================*/
+void ParallelCoordinatesDensityMap::setResolution( const size_t resolution )
+{
+    const size_t old_resolution = m_table.resolution();
+    m_table.setResolution( resolution );
+    if ( m_table.resolution() != old_resolution ) this->release();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Updates the histograms with the table object.
+ *  @param  table [in] pointer to the table object
+ *  @return true if the histograms are changed
+ *
+ *  Only the rows whose inside range flags are changed since the last update
+ *  are added to or removed from the histograms, unless the bins are changed
+ *  or many rows are changed (see kvs::BinnedTable::update).
+ */
+/*===========================================================================*/
+bool ParallelCoordinatesDensityMap::update( const kvs::TableObject* table )
+{
+    switch ( m_table.update( table ) )
+    {
+    case kvs::BinnedTable::Rebinned:
+    {
+        const size_t size = m_table.resolution() * m_table.resolution();
+        m_histograms.resize( m_table.numberOfColumns() - 1 );
+        for ( size_t i = 0; i < m_histograms.size(); i++ ) m_histograms[i].allocate( size );
+        this->count();
+        return true;
+    }
+    case kvs::BinnedTable::AllRowsChanged:
+        this->count();
+        return true;
+    case kvs::BinnedTable::RowsChanged:
+        this->count( m_table.changedRows() );
+        return true;
+    case kvs::BinnedTable::Unchanged:
+        return false;
+    default:
+        this->release();
+        return false;
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Rasterizes the histograms into the density image.
+ *  @param  width [in] image width (from the first axis to the last axis)
+ *  @param  height [in] image height (from the min. values to the max. values)
+ *  @return true if the density image is created
+ *
+ *  The density of a pixel is the number of lines passing through it. The
+ *  time is proportional to the number of the non-empty histogram bins and
+ *  the image size, but independent of the number of rows.
+ */
+/*===========================================================================*/
+bool ParallelCoordinatesDensityMap::rasterize( const size_t width, const size_t height )
+{
+    if ( m_histograms.empty() || width < 2 || height < 2 ) return false;
+
+    m_width = width;
+    m_height = height;
+    m_density_data.allocate( width * height );
+    m_density_data.fill( 0 );
+
+    ::RasterizeTask task( &m_histograms, m_table.resolution(), width, height, m_density_data.data() );
+    m_table.execute( &task, m_histograms.size() );
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the RGBA image of the density colored by the color map.
+ *  @param  color_map [in] color map
+ *  @param  opacity [in] opacity of the pixels with the lines
+ *  @return RGBA pixels (the first row is the bottom)
+ *
+ *  The density is normalized logarithmically to [0,1] by the max. density,
+ *  which is mapped to the whole range of the color map. The pixels without
+ *  the lines are transparent.
+ */
+/*===========================================================================*/
+kvs::ValueArray<kvs::UInt8> ParallelCoordinatesDensityMap::colorData(
+    const kvs::ColorMap& color_map,
+    const kvs::UInt8 opacity ) const
+{
+    const size_t npixels = m_density_data.size();
+    kvs::ValueArray<kvs::UInt8> pixels( npixels * 4 );
+    pixels.fill( 0 );
+
+    kvs::Real32 max_density = 0.0f;
+    for ( size_t i = 0; i < npixels; i++ ) max_density = kvs::Math::Max( max_density, m_density_data[i] );
+    if ( max_density <= 0.0f ) return pixels;
+
+    kvs::ColorMap cmap( color_map );
+    cmap.setRange( 0.0f, 1.0f );
+    const float normalize = 1.0f / std::log( 1.0f + max_density );
+
+    kvs::UInt8* pixel = pixels.data();
+    for ( size_t i = 0; i < npixels; i++, pixel += 4 )
+    {
+        const kvs::Real32 density = m_density_data[i];
+        if ( density <= 0.0f ) continue;
+
+        const kvs::RGBColor color = cmap.at( std::log( 1.0f + density ) * normalize );
+        pixel[0] = color.r();
+        pixel[1] = color.g();
+        pixel[2] = color.b();
+        pixel[3] = opacity;
+    }
+
+    return pixels;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Releases the bins, histograms and density image.
+ */
+/*===========================================================================*/
+void ParallelCoordinatesDensityMap::release()
+{
+    m_table.release();
+    m_histograms.clear();
+    m_width = 0;
+    m_height = 0;
+    m_density_data.release();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Counts all the rows inside the ranges into the histograms.
+ */
+/*===========================================================================*/
+void ParallelCoordinatesDensityMap::count()
+{
+    ::CountTask task( &m_table.bins(), &m_table.flags(), NULL, m_table.resolution(), &m_histograms );
+    m_table.execute( &task, m_histograms.size() );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Adds or removes the rows whose inside range flags are changed.
+ *  @param  changed_rows [in] indices of the changed rows
+ */
+/*===========================================================================*/
+void ParallelCoordinatesDensityMap::count( const std::vector<size_t>& changed_rows )
+{
+    ::CountTask task( &m_table.bins(), &m_table.flags(), &changed_rows, m_table.resolution(), &m_histograms );
+    m_table.execute( &task, m_histograms.size() );
+}
+
+} // end of namespace kvs
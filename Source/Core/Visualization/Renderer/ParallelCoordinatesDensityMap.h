@@ -0,0 +1,82 @@
+/*****************************************************************************/
+/**
+ *  @file   ParallelCoordinatesDensityMap.h
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#ifndef KVS__PARALLEL_COORDINATES_DENSITY_MAP_H_INCLUDE
+#define KVS__PARALLEL_COORDINATES_DENSITY_MAP_H_INCLUDE
+
+#include <vector>
+#include <kvs/Type>
+#include <kvs/ValueArray>
+#include <kvs/ColorMap>
+#include <kvs/TableObject>
+#include <kvs/BinnedTable>
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Line density map of the parallel coordinates.
+ *
+ *  The rows inside the ranges are counted with the bins of the binned table
+ *  into a 2D histogram for each gap between the neighboring axes. The
+ *  histogram bin (a,b) of the gap j represents the lines from the bin a on
+ *  the axis j to the bin b on the axis j+1, so that the density image is
+ *  rasterized from the histograms in the time independent of the number of
+ *  rows. The gaps are processed in parallel by the threads.
+ */
+/*===========================================================================*/
+class ParallelCoordinatesDensityMap
+{
+public:
+
+    typedef kvs::ValueArray<kvs::UInt32> Histogram;
+
+private:
+
+    kvs::BinnedTable m_table; ///< bin indices and flags of the table
+    std::vector<Histogram> m_histograms; ///< 2D histograms for each gap
+    size_t m_width; ///< width of the density image
+    size_t m_height; ///< height of the density image
+    kvs::ValueArray<kvs::Real32> m_density_data; ///< density image (the first row is the bottom)
+
+public:
+
+    ParallelCoordinatesDensityMap();
+
+    size_t resolution() const { return m_table.resolution(); }
+    size_t numberOfThreads() const { return m_table.numberOfThreads(); }
+    size_t numberOfGaps() const { return m_histograms.size(); }
+    const Histogram& histogram( const size_t gap_index ) const { return m_histograms[ gap_index ]; }
+    size_t width() const { return m_width; }
+    size_t height() const { return m_height; }
+    const kvs::ValueArray<kvs::Real32>& densityData() const { return m_density_data; }
+
+    void setResolution( const size_t resolution );
+    void setNumberOfThreads( const size_t nthreads ) { m_table.setNumberOfThreads( nthreads ); }
+
+    bool update( const kvs::TableObject* table );
+    bool rasterize( const size_t width, const size_t height );
+    kvs::ValueArray<kvs::UInt8> colorData( const kvs::ColorMap& color_map, const kvs::UInt8 opacity = 255 ) const;
+    void release();
+
+private:
+
+    void count();
+    void count( const std::vector<size_t>& changed_rows );
+};
+
+} // end of namespace kvs
+
+#endif // KVS__PARALLEL_COORDINATES_DENSITY_MAP_H_INCLUDE
@@ -67,7 +67,9 @@ ParallelCoordinatesRenderer::ParallelCoordinatesRenderer():
     m_active_axis( 0 ),
     m_line_opacity( 255 ),
     m_line_width( 1.0f ),
-    m_color_map( 256 )
+    m_color_map( 256 ),
+    m_enable_density_mode( false ),
+    m_has_density_image( false )
 {
     m_color_map.create();
 }
@@ -95,6 +97,32 @@ void ParallelCoordinatesRenderer::disableAntiAliasing() const
     m_enable_multisample_anti_aliasing = false;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Enables density mode.
+ *  @param  resolution [in] number of bins on each axis (<= 256)
+ */
+/*===========================================================================*/
+void ParallelCoordinatesRenderer::enableDensityMode( const size_t resolution )
+{
+    m_enable_density_mode = true;
+    m_has_density_image = false;
+    m_density_map.setResolution( resolution );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Disables density mode.
+ */
+/*===========================================================================*/
+void ParallelCoordinatesRenderer::disableDensityMode()
+{
+    m_enable_density_mode = false;
+    m_has_density_image = false;
+    m_density_map.release();
+    m_density_image.release();
+}
+
 /*===========================================================================*/
 /**
  *  @brief  Render parallel coordinates.
@@ -138,6 +166,20 @@ void ParallelCoordinatesRenderer::exec( kvs::ObjectBase* object, kvs::Camera* ca
 
     ::BeginDraw();
 
+    if ( m_enable_density_mode )
+    {
+        const int x0 = m_left_margin;
+        const int x1 = camera->windowWidth() - m_right_margin;
+        const int y0 = m_top_margin;
+        const int y1 = camera->windowHeight() - m_bottom_margin;
+        this->draw_density( table, x0, x1, y0, y1 );
+
+        ::EndDraw();
+        glPopAttrib();
+        BaseClass::stopTimer();
+        return;
+    }
+
     const float color_axis_min_value = static_cast<float>( table->minValue( m_active_axis ) );
     const float color_axis_max_value = static_cast<float>( table->maxValue( m_active_axis ) );
     const kvs::AnyValueArray& color_axis_values = table->column( m_active_axis );
@@ -183,4 +225,47 @@ void ParallelCoordinatesRenderer::exec( kvs::ObjectBase* object, kvs::Camera* ca
     BaseClass::stopTimer();
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Draws the density image of the lines.
+ *  @param  table [in] pointer to the table object
+ *  @param  x0 [in] x coordinate of the first axis
+ *  @param  x1 [in] x coordinate of the last axis
+ *  @param  y0 [in] y coordinate of the max. values
+ *  @param  y1 [in] y coordinate of the min. values
+ *
+ *  The histograms are updated incrementally when the ranges are changed, and
+ *  the density image is rasterized again only when the histograms or the
+ *  plot size are changed.
+ */
+/*===========================================================================*/
+void ParallelCoordinatesRenderer::draw_density(
+    const kvs::TableObject* table,
+    const int x0,
+    const int x1,
+    const int y0,
+    const int y1 )
+{
+    if ( x1 <= x0 || y1 <= y0 ) return;
+
+    const size_t width = static_cast<size_t>( x1 - x0 + 1 );
+    const size_t height = static_cast<size_t>( y1 - y0 + 1 );
+    const bool changed = m_density_map.update( table );
+    if ( changed || width != m_density_map.width() || height != m_density_map.height() )
+    {
+        if ( !m_density_map.rasterize( width, height ) ) return;
+        m_has_density_image = false;
+    }
+
+    if ( !m_has_density_image )
+    {
+        m_density_image = m_density_map.colorData( m_color_map, m_line_opacity );
+        m_has_density_image = true;
+    }
+
+    // The first row of the image is drawn at the min. values (bottom).
+    glRasterPos2i( x0, y1 + 1 );
+    glDrawPixels( GLsizei( width ), GLsizei( height ), GL_RGBA, GL_UNSIGNED_BYTE, m_density_image.data() );
+}
+
 } // end of namespace kvs
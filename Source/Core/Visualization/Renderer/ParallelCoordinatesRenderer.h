@@ -18,6 +18,8 @@
 #include <kvs/RendererBase>
 #include <kvs/Module>
 #include <kvs/ColorMap>
+#include <kvs/ValueArray>
+#include <kvs/ParallelCoordinatesDensityMap>
 
 
 namespace kvs
@@ -30,6 +32,12 @@ class Light;
 /*===========================================================================*/
 /**
  *  @brief  Parallel coordinates renderer class.
+ *
+ *  In the density mode, the lines are not drawn one by one, but the line
+ *  density computed by kvs::ParallelCoordinatesDensityMap is drawn as an
+ *  image colored by the color map, so that the rendering time of the large
+ *  tables is independent of the number of rows. The active axis is not used
+ *  for the colors in this mode.
  */
 /*===========================================================================*/
 class ParallelCoordinatesRenderer : public kvs::RendererBase
@@ -49,6 +57,10 @@ private:
     kvs::UInt8 m_line_opacity; ///< line opacity
     kvs::Real32 m_line_width; ///< line width
     kvs::ColorMap m_color_map; ///< color map
+    bool m_enable_density_mode; ///< flag for the density mode
+    bool m_has_density_image; ///< flag for the density image up to date with the color map and the opacity
+    kvs::ParallelCoordinatesDensityMap m_density_map; ///< density map
+    kvs::ValueArray<kvs::UInt8> m_density_image; ///< RGBA density image
 
 public:
 
@@ -58,9 +70,9 @@ public:
     void setBottomMargin( const int bottom_margin ) { m_bottom_margin = bottom_margin; }
     void setLeftMargin( const int left_margin ) { m_left_margin = left_margin; }
     void setRightMargin( const int right_margin ) { m_right_margin = right_margin; }
-    void setLineOpacity( const kvs::UInt8 opacity ) { m_line_opacity = opacity; }
+    void setLineOpacity( const kvs::UInt8 opacity ) { m_line_opacity = opacity; m_has_density_image = false; }
     void setLineWidth( const kvs::Real32 width ) { m_line_width = width; }
-    void setColorMap( const kvs::ColorMap& color_map ) { m_color_map = color_map; }
+    void setColorMap( const kvs::ColorMap& color_map ) { m_color_map = color_map; m_has_density_image = false; }
     void selectAxis( const size_t index ) { m_active_axis = index; }
     int topMargin() const { return m_top_margin; }
     int bottomMargin() const { return m_bottom_margin; }
@@ -71,8 +83,16 @@ public:
     kvs::Real32 lineWidth() const { return m_line_width; }
     void enableAntiAliasing( const bool multisample = false ) const;
     void disableAntiAliasing() const;
+    void enableDensityMode( const size_t resolution = 256 );
+    void disableDensityMode();
+    bool isEnabledDensityMode() const { return m_enable_density_mode; }
+    const kvs::ParallelCoordinatesDensityMap& densityMap() const { return m_density_map; }
 
     void exec( kvs::ObjectBase* object, kvs::Camera* camera, kvs::Light* light );
+
+private:
+
+    void draw_density( const kvs::TableObject* table, const int x0, const int x1, const int y0, const int y1 );
 };
 
 } // end of namespace kvs
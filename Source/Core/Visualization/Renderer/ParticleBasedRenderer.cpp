@@ -19,6 +19,70 @@
 #include <kvs/Assert>
 
 
+namespace
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Projects the particles and stores them in the particle buffer.
+ *  @param  v [in] coordinate array (float or quantized)
+ *  @param  nv [in] number of particles
+ *  @param  t [in] combined (projection x modelview) matrix for the array
+ *  @param  w [in] half width of the window
+ *  @param  h [in] half height of the window
+ *  @param  bounds_width [in] width of the window - 1
+ *  @param  bounds_height [in] height of the window - 1
+ *  @param  buffer [in] particle buffer
+ */
+/*===========================================================================*/
+template <typename T>
+void ProjectParticles(
+    const T* v,
+    const size_t nv,
+    const float t[16],
+    const size_t w,
+    const size_t h,
+    const size_t bounds_width,
+    const size_t bounds_height,
+    kvs::ParticleBuffer* buffer )
+{
+    size_t index3 = 0;
+    for ( size_t index = 0; index < nv; index++, index3 += 3 )
+    {
+        /* Calculate the projected point position in the window coordinate system.
+         * Ex.) Camera::projectObjectToWindow().
+         */
+        const float x = static_cast<float>( v[index3] );
+        const float y = static_cast<float>( v[index3+1] );
+        const float z = static_cast<float>( v[index3+2] );
+        float p_tmp[4] = {
+            x*t[0] + y*t[4] + z*t[ 8] + t[12],
+            x*t[1] + y*t[5] + z*t[ 9] + t[13],
+            x*t[2] + y*t[6] + z*t[10] + t[14],
+            x*t[3] + y*t[7] + z*t[11] + t[15] };
+        p_tmp[3] = 1.0f / p_tmp[3];
+        p_tmp[0] *= p_tmp[3];
+        p_tmp[1] *= p_tmp[3];
+        p_tmp[2] *= p_tmp[3];
+
+        const float p_win_x = ( 1.0f + p_tmp[0] ) * w;
+        const float p_win_y = ( 1.0f + p_tmp[1] ) * h;
+        const float depth   = ( 1.0f + p_tmp[2] ) * 0.5f;
+
+        // Store the projected point in the point buffer.
+        if ( ( 0 < p_win_x ) & ( 0 < p_win_y ) )
+        {
+            if ( ( p_win_x < bounds_width ) & ( p_win_y < bounds_height ) )
+            {
+                buffer->add( p_win_x, p_win_y, depth, index );
+            }
+        }
+    }
+}
+
+} // end of namespace
+
+
 namespace kvs
 {
 
@@ -83,7 +147,7 @@ void ParticleBasedRenderer::exec(
 
     kvs::PointObject* point = kvs::PointObject::DownCast( object );
     if ( !m_ref_point ) this->attachPointObject( point );
-    if ( point->normals().size() == 0 ) BaseClass::disableShading();
+    if ( point->numberOfNormals() == 0 ) BaseClass::disableShading();
 
     BaseClass::startTimer();
     {
@@ -182,7 +246,9 @@ void ParticleBasedRenderer::project_particle(
     const kvs::Camera* camera,
     const kvs::Light* light )
 {
-    float t[16]; camera->getCombinedMatrix( &t );
+    float modelview[16]; BaseClass::getModelViewMatrix( modelview );
+    float projection[16]; BaseClass::getProjectionMatrix( projection );
+    float t[16]; camera->getCombinedMatrix( projection, modelview, &t );
     const size_t w = camera->windowWidth() / 2;
     const size_t h = camera->windowHeight() / 2;
 
@@ -193,40 +259,28 @@ void ParticleBasedRenderer::project_particle(
     m_buffer->attachShader( &BaseClass::shader() );
     m_buffer->attachPointObject( point );
 
-    // Aliases.
     const size_t nv = point->numberOfVertices();
-    const kvs::Real32* v  = point->coords().data();
-
-    size_t index3 = 0;
     const size_t bounds_width = BaseClass::windowWidth() - 1;
     const size_t bounds_height = BaseClass::windowHeight() - 1;
-    for ( size_t index = 0; index < nv; index++, index3 += 3 )
+    if ( point->hasQuantizedCoords() )
     {
-        /* Calculate the projected point position in the window coordinate system.
-         * Ex.) Camera::projectObjectToWindow().
-         */
-        float p_tmp[4] = {
-            v[index3]*t[0] + v[index3+1]*t[4] + v[index3+2]*t[ 8] + t[12],
-            v[index3]*t[1] + v[index3+1]*t[5] + v[index3+2]*t[ 9] + t[13],
-            v[index3]*t[2] + v[index3+1]*t[6] + v[index3+2]*t[10] + t[14],
-            v[index3]*t[3] + v[index3+1]*t[7] + v[index3+2]*t[11] + t[15] };
-        p_tmp[3] = 1.0f / p_tmp[3];
-        p_tmp[0] *= p_tmp[3];
-        p_tmp[1] *= p_tmp[3];
-        p_tmp[2] *= p_tmp[3];
-
-        const float p_win_x = ( 1.0f + p_tmp[0] ) * w;
-        const float p_win_y = ( 1.0f + p_tmp[1] ) * h;
-        const float depth   = ( 1.0f + p_tmp[2] ) * 0.5f;
-
-        // Store the projected point in the point buffer.
-        if ( ( 0 < p_win_x ) & ( 0 < p_win_y ) )
+        // The dequantization is folded into the combined matrix, so that the
+        // quantized coordinates are projected without being expanded.
+        const kvs::Vec3& o = point->coordOffset();
+        const kvs::Vec3& s = point->coordScale();
+        float tq[16];
+        for ( size_t i = 0; i < 4; i++ )
         {
-            if ( ( p_win_x < bounds_width ) & ( p_win_y < bounds_height ) )
-            {
-                m_buffer->add( p_win_x, p_win_y, depth, index );
-            }
+            tq[i]      = t[i] * s.x();
+            tq[i + 4]  = t[i + 4] * s.y();
+            tq[i + 8]  = t[i + 8] * s.z();
+            tq[i + 12] = t[i] * o.x() + t[i + 4] * o.y() + t[i + 8] * o.z() + t[i + 12];
         }
+        ::ProjectParticles( point->quantizedCoords().data(), nv, tq, w, h, bounds_width, bounds_height, m_buffer );
+    }
+    else
+    {
+        ::ProjectParticles( point->coords().data(), nv, t, w, h, bounds_width, bounds_height, m_buffer );
     }
 
     // Shading calculation.
@@ -215,9 +215,14 @@ const kvs::Vec4& ParticleBasedRenderer::initialViewport() const
 /*===========================================================================*/
 ParticleBasedRenderer::Engine::Engine():
     m_has_normal( false ),
+    m_has_quantized_coord( false ),
+    m_has_encoded_normal( false ),
+    m_has_color_index( false ),
     m_enable_shuffle( true ),
     m_enable_zooming( true ),
     m_random_index( 0 ),
+    m_encoded_normal_index( 0 ),
+    m_color_index_index( 0 ),
     m_initial_modelview( kvs::Mat4::Zero() ),
     m_initial_projection( kvs::Mat4::Zero() ),
     m_initial_viewport( kvs::Vec4::Zero() ),
@@ -236,8 +241,13 @@ ParticleBasedRenderer::Engine::Engine():
 /*===========================================================================*/
 ParticleBasedRenderer::Engine::Engine( const kvs::Mat4& m, const kvs::Mat4& p, const kvs::Vec4& v ):
     m_has_normal( false ),
+    m_has_quantized_coord( false ),
+    m_has_encoded_normal( false ),
+    m_has_color_index( false ),
     m_enable_shuffle( true ),
     m_random_index( 0 ),
+    m_encoded_normal_index( 0 ),
+    m_color_index_index( 0 ),
     m_initial_modelview( m ),
     m_initial_projection( p ),
     m_initial_viewport( v ),
@@ -264,6 +274,7 @@ ParticleBasedRenderer::Engine::~Engine()
 void ParticleBasedRenderer::Engine::release()
 {
     m_shader_program.release();
+    m_palette_texture.release();
     for ( size_t i = 0; i < repetitionLevel(); i++ ) m_vbo[i].release();
 }
 
@@ -278,7 +289,10 @@ void ParticleBasedRenderer::Engine::release()
 void ParticleBasedRenderer::Engine::create( kvs::ObjectBase* object, kvs::Camera* camera, kvs::Light* light )
 {
     kvs::PointObject* point = kvs::PointObject::DownCast( object );
-    m_has_normal = point->normals().size() > 0;
+    m_has_normal = point->numberOfNormals() > 0;
+    m_has_quantized_coord = point->hasQuantizedCoords();
+    m_has_encoded_normal = point->hasEncodedNormals();
+    m_has_color_index = point->hasColorIndices();
     if ( !m_has_normal ) setEnabledShading( false );
 
     // Create resources.
@@ -338,6 +352,8 @@ void ParticleBasedRenderer::Engine::setup( kvs::ObjectBase* object, kvs::Camera*
     kvs::OpenGL::Enable( GL_DEPTH_TEST );
     kvs::OpenGL::Enable( GL_VERTEX_PROGRAM_POINT_SIZE );
     m_random_index = m_shader_program.attributeLocation("random_index");
+    if ( m_has_encoded_normal ) m_encoded_normal_index = m_shader_program.attributeLocation("encoded_normal");
+    if ( m_has_color_index ) m_color_index_index = m_shader_program.attributeLocation("color_index");
 
     const kvs::Mat4 M = kvs::OpenGL::ModelViewMatrix();
     const kvs::Mat4 P = kvs::OpenGL::ProjectionMatrix();
@@ -362,6 +378,7 @@ void ParticleBasedRenderer::Engine::draw( kvs::ObjectBase* object, kvs::Camera*
     kvs::VertexBufferObject::Binder bind1( m_vbo[ repetitionCount() ] );
     kvs::ProgramObject::Binder bind2( m_shader_program );
     kvs::Texture::Binder bind3( randomTexture() );
+    if ( m_has_color_index ) kvs::Texture::Bind( m_palette_texture, 1 );
     {
         const kvs::Mat4& m0 = m_initial_modelview;
         const float scale0 = kvs::Vec3( m0[0][0], m0[1][0], m0[2][0] ).length();
@@ -384,24 +401,56 @@ void ParticleBasedRenderer::Engine::draw( kvs::ObjectBase* object, kvs::Camera*
         m_shader_program.setUniform( "random_texture", 0 );
         m_shader_program.setUniform( "random_texture_size_inv", 1.0f / randomTextureSize() );
         m_shader_program.setUniform( "screen_scale", kvs::Vec2( width * 0.5f, height * 0.5f ) );
+        if ( m_has_quantized_coord )
+        {
+            m_shader_program.setUniform( "coord_offset", point->coordOffset() );
+            m_shader_program.setUniform( "coord_scale", point->coordScale() );
+        }
+        if ( m_has_color_index )
+        {
+            const size_t npalettes = point->colorPalette().size() / 3;
+            m_shader_program.setUniform( "palette_texture", 1 );
+            m_shader_program.setUniform( "palette_size_inv", 1.0f / npalettes );
+        }
 
         const size_t nvertices = point->numberOfVertices();
         const size_t rem = nvertices % repetitionLevel();
         const size_t quo = nvertices / repetitionLevel();
         const size_t count = quo + ( repetitionCount() < rem ? 1 : 0 );
-        const size_t coord_size = count * sizeof(kvs::Real32) * 3;
-        const size_t color_size = count * sizeof(kvs::UInt8) * 3;
+        const size_t coord_size = count * ( m_has_quantized_coord ? sizeof(kvs::UInt16) : sizeof(kvs::Real32) ) * 3;
+        const size_t color_size = count * sizeof(kvs::UInt8) * ( m_has_color_index ? 1 : 3 );
 
-        // Enable coords.
+        // Enable coords. The quantized coordinates are passed as the signed
+        // shorts, which are converted to the unsigned values in the shader.
         KVS_GL_CALL( glEnableClientState( GL_VERTEX_ARRAY ) );
-        KVS_GL_CALL( glVertexPointer( 3, GL_FLOAT, 0, (GLbyte*)NULL + 0 ) );
+        if ( m_has_quantized_coord )
+        {
+            KVS_GL_CALL( glVertexPointer( 3, GL_SHORT, 0, (GLbyte*)NULL + 0 ) );
+        }
+        else
+        {
+            KVS_GL_CALL( glVertexPointer( 3, GL_FLOAT, 0, (GLbyte*)NULL + 0 ) );
+        }
 
         // Enable colors.
-        KVS_GL_CALL( glEnableClientState( GL_COLOR_ARRAY ) );
-        KVS_GL_CALL( glColorPointer( 3, GL_UNSIGNED_BYTE, 0, (GLbyte*)NULL + coord_size ) );
+        if ( m_has_color_index )
+        {
+            KVS_GL_CALL( glEnableVertexAttribArray( m_color_index_index ) );
+            KVS_GL_CALL( glVertexAttribPointer( m_color_index_index, 1, GL_UNSIGNED_BYTE, GL_FALSE, 0, (GLubyte*)NULL + coord_size ) );
+        }
+        else
+        {
+            KVS_GL_CALL( glEnableClientState( GL_COLOR_ARRAY ) );
+            KVS_GL_CALL( glColorPointer( 3, GL_UNSIGNED_BYTE, 0, (GLbyte*)NULL + coord_size ) );
+        }
 
         // Enable normals.
-        if ( m_has_normal )
+        if ( m_has_encoded_normal )
+        {
+            KVS_GL_CALL( glEnableVertexAttribArray( m_encoded_normal_index ) );
+            KVS_GL_CALL( glVertexAttribPointer( m_encoded_normal_index, 2, GL_UNSIGNED_BYTE, GL_TRUE, 0, (GLubyte*)NULL + coord_size + color_size ) );
+        }
+        else if ( m_has_normal )
         {
             KVS_GL_CALL( glEnableClientState( GL_NORMAL_ARRAY ) );
             KVS_GL_CALL( glNormalPointer( GL_FLOAT, 0, (GLbyte*)NULL + coord_size + color_size ) );
@@ -418,10 +467,21 @@ void ParticleBasedRenderer::Engine::draw( kvs::ObjectBase* object, kvs::Camera*
         KVS_GL_CALL( glDisableClientState( GL_VERTEX_ARRAY ) );
 
         // Disable colors.
-        KVS_GL_CALL( glDisableClientState( GL_COLOR_ARRAY ) );
+        if ( m_has_color_index )
+        {
+            KVS_GL_CALL( glDisableVertexAttribArray( m_color_index_index ) );
+        }
+        else
+        {
+            KVS_GL_CALL( glDisableClientState( GL_COLOR_ARRAY ) );
+        }
 
         // Disable normals.
-        if ( m_has_normal )
+        if ( m_has_encoded_normal )
+        {
+            KVS_GL_CALL( glDisableVertexAttribArray( m_encoded_normal_index ) );
+        }
+        else if ( m_has_normal )
         {
             KVS_GL_CALL( glDisableClientState( GL_NORMAL_ARRAY ) );
         }
@@ -429,6 +489,7 @@ void ParticleBasedRenderer::Engine::draw( kvs::ObjectBase* object, kvs::Camera*
         // Disable random index.
         KVS_GL_CALL( glDisableVertexAttribArray( m_random_index ) );
     }
+    if ( m_has_color_index ) kvs::Texture::Unbind( m_palette_texture, 1 );
 
 //    countRepetitions();
 }
@@ -465,6 +526,10 @@ void ParticleBasedRenderer::Engine::create_shader_program()
         frag.define("ENABLE_PARTICLE_ZOOMING");
     }
 
+    if ( m_has_quantized_coord ) vert.define("ENABLE_QUANTIZED_COORD");
+    if ( m_has_encoded_normal ) vert.define("ENABLE_ENCODED_NORMAL");
+    if ( m_has_color_index ) vert.define("ENABLE_COLOR_INDEX");
+
     m_shader_program.build( vert, frag );
     m_shader_program.bind();
     m_shader_program.setUniform( "shading.Ka", shader().Ka );
@@ -482,20 +547,39 @@ void ParticleBasedRenderer::Engine::create_shader_program()
 /*===========================================================================*/
 void ParticleBasedRenderer::Engine::create_buffer_object( const kvs::PointObject* point )
 {
-    KVS_ASSERT( point->coords().size() == point->colors().size() );
+    // The compact arrays of the point object are loaded as they are, and the
+    // quantized coordinates, the encoded normals and the color indices are
+    // decoded in the vertex shader.
+    const size_t coord_type_size = m_has_quantized_coord ? sizeof(kvs::UInt16) : sizeof(kvs::Real32);
+    const size_t color_dim = m_has_color_index ? 1 : 3;
+    const size_t normal_type_size = m_has_encoded_normal ? sizeof(kvs::UInt16) : sizeof(kvs::Real32) * 3;
 
     kvs::ValueArray<kvs::Real32> coords = point->coords();
-    kvs::ValueArray<kvs::UInt8> colors = point->colors();
+    kvs::ValueArray<kvs::UInt16> quantized_coords = point->quantizedCoords();
+    kvs::ValueArray<kvs::UInt8> colors = m_has_color_index ? point->colorIndices() : point->colors();
     kvs::ValueArray<kvs::Real32> normals = point->normals();
+    kvs::ValueArray<kvs::UInt16> encoded_normals = point->encodedNormals();
+    KVS_ASSERT( colors.size() == point->numberOfVertices() * color_dim );
     if ( m_enable_shuffle )
     {
         kvs::UInt32 seed = 12345678;
-        coords = ::ShuffleArray<3>( point->coords(), seed );
-        colors = ::ShuffleArray<3>( point->colors(), seed );
-        if ( m_has_normal )
-        {
-            normals = ::ShuffleArray<3>( point->normals(), seed );
-        }
+        if ( m_has_quantized_coord ) quantized_coords = ::ShuffleArray<3>( quantized_coords, seed );
+        else coords = ::ShuffleArray<3>( coords, seed );
+        if ( m_has_color_index ) colors = ::ShuffleArray<1>( colors, seed );
+        else colors = ::ShuffleArray<3>( colors, seed );
+        if ( m_has_encoded_normal ) encoded_normals = ::ShuffleArray<1>( encoded_normals, seed );
+        else if ( m_has_normal ) normals = ::ShuffleArray<3>( normals, seed );
+    }
+
+    if ( m_has_color_index )
+    {
+        const kvs::ValueArray<kvs::UInt8>& palette = point->colorPalette();
+        m_palette_texture.release();
+        m_palette_texture.setWrapS( GL_CLAMP_TO_EDGE );
+        m_palette_texture.setMagFilter( GL_NEAREST );
+        m_palette_texture.setMinFilter( GL_NEAREST );
+        m_palette_texture.setPixelFormat( GL_RGB8, GL_RGB, GL_UNSIGNED_BYTE );
+        m_palette_texture.create( palette.size() / 3, palette.data() );
     }
 
     if ( !m_vbo ) m_vbo = new kvs::VertexBufferObject [ repetitionLevel() ];
@@ -507,16 +591,27 @@ void ParticleBasedRenderer::Engine::create_buffer_object( const kvs::PointObject
     {
         const size_t count = quo + ( i < rem ? 1 : 0 );
         const size_t first = quo * i + kvs::Math::Min( i, rem );
-        const size_t coord_size = count * sizeof(kvs::Real32) * 3;
-        const size_t color_size = count * sizeof(kvs::UInt8) * 3;
-        const size_t normal_size = m_has_normal ? count * sizeof(kvs::Real32) * 3 : 0;
+        const size_t coord_size = count * coord_type_size * 3;
+        const size_t color_size = count * sizeof(kvs::UInt8) * color_dim;
+        const size_t normal_size = m_has_normal ? count * normal_type_size : 0;
         const size_t byte_size = coord_size + color_size + normal_size;
         m_vbo[i].create( byte_size );
 
         m_vbo[i].bind();
-        m_vbo[i].load( coord_size, coords.data() + first * 3, 0 );
-        m_vbo[i].load( color_size, colors.data() + first * 3, coord_size );
-        if ( m_has_normal )
+        if ( m_has_quantized_coord )
+        {
+            m_vbo[i].load( coord_size, quantized_coords.data() + first * 3, 0 );
+        }
+        else
+        {
+            m_vbo[i].load( coord_size, coords.data() + first * 3, 0 );
+        }
+        m_vbo[i].load( color_size, colors.data() + first * color_dim, coord_size );
+        if ( m_has_encoded_normal )
+        {
+            m_vbo[i].load( normal_size, encoded_normals.data() + first, coord_size + color_size );
+        }
+        else if ( m_has_normal )
         {
             m_vbo[i].load( normal_size, normals.data() + first * 3, coord_size + color_size );
         }
@@ -19,6 +19,7 @@
 #include <kvs/Module>
 #include <kvs/ProgramObject>
 #include <kvs/VertexBufferObject>
+#include <kvs/Texture1D>
 #include <kvs/Vector4>
 #include <kvs/Matrix44>
 #include <kvs/Deprecated>
@@ -97,15 +98,21 @@ class ParticleBasedRenderer::Engine : public kvs::StochasticRenderingEngine
 private:
 
     bool m_has_normal; ///< check flag for the normal array
+    bool m_has_quantized_coord; ///< check flag for the quantized coordinate array
+    bool m_has_encoded_normal; ///< check flag for the encoded normal array
+    bool m_has_color_index; ///< check flag for the color index array
     bool m_enable_shuffle; ///< flag for shuffling particles
     bool m_enable_zooming; ///< flag for zooming particles
     size_t m_random_index; ///< index used for refering the random texture
+    size_t m_encoded_normal_index; ///< index used for refering the encoded normal
+    size_t m_color_index_index; ///< index used for refering the color index
     kvs::Mat4 m_initial_modelview; ///< initial modelview matrix
     kvs::Mat4 m_initial_projection; ///< initial projection matrix
     kvs::Vec4 m_initial_viewport; ///< initial viewport
     float m_initial_object_depth; ///< initial object depth
     kvs::ProgramObject m_shader_program; ///< zooming shader program
     kvs::VertexBufferObject* m_vbo; ///< vertex buffer objects for each repetition
+    kvs::Texture1D m_palette_texture; ///< color palette texture
 
 public:
 
@@ -781,7 +781,7 @@ void ParticleBasedRenderer::exec(
     kvs::PointObject* point = kvs::PointObject::DownCast( object );
     if ( !m_ref_point ) this->attachPointObject( point );
 
-    if ( point->normals().size() == 0 ) BaseClass::disableShading();
+    if ( point->numberOfNormals() == 0 ) BaseClass::disableShading();
 
     BaseClass::startTimer();
     this->create_image( point, camera, light );
@@ -834,8 +834,7 @@ void ParticleBasedRenderer::attachPointObject( const kvs::PointObject* point )
 {
     m_ref_point = point;
 
-    if ( m_ref_point->normals().data() == NULL ||
-         m_ref_point->numberOfNormals() == 0 )
+    if ( m_ref_point->numberOfNormals() == 0 )
     {
         BaseClass::disableShading();
     }
@@ -1571,14 +1570,23 @@ void ParticleBasedRenderer::align_particles()
 
     const int total_vertices = m_ref_point->numberOfVertices();
 
+    kvs::PointObject expanded;
+    const kvs::PointObject* source = m_ref_point;
+    if ( m_ref_point->isCompact() )
+    {
+        expanded.shallowCopy( *m_ref_point );
+        expanded.expand();
+        source = &expanded;
+    }
+
     // Source pointers.
     /*ADD_UEMURA(begin)*/
-    kvs::Real32* src_coord  = const_cast<kvs::Real32*>(m_ref_point->coords().data());
-    kvs::Real32* src_normal = const_cast<kvs::Real32*>(m_ref_point->normals().data());
-    kvs::UInt8*  src_color  = const_cast<kvs::UInt8*>(m_ref_point->colors().data());
+    kvs::Real32* src_coord  = const_cast<kvs::Real32*>(source->coords().data());
+    kvs::Real32* src_normal = const_cast<kvs::Real32*>(source->normals().data());
+    kvs::UInt8*  src_color  = const_cast<kvs::UInt8*>(source->colors().data());
 
-    const bool has_color_array = m_ref_point->numberOfColors() == m_ref_point->numberOfVertices();
-    const bool has_normal_array = m_ref_point->numberOfNormals() == m_ref_point->numberOfVertices();
+    const bool has_color_array = source->numberOfColors() == source->numberOfVertices();
+    const bool has_normal_array = source->numberOfNormals() == source->numberOfVertices();
 
     //Shuffle source coord array
     if(m_enable_shuffle){
@@ -151,9 +151,11 @@ void ParticleBuffer::create_image_with_shading(
     kvs::ValueArray<kvs::UInt8>* color,
     kvs::ValueArray<kvs::Real32>* depth )
 {
-    const kvs::Real32* point_coords = m_ref_point_object->coords().data();
-    const kvs::UInt8* point_color = m_ref_point_object->colors().data();
-    const kvs::Real32* point_normal = m_ref_point_object->normals().data();
+    // The compact arrays of the point object are decoded for each particle.
+    const kvs::PointObject* point = m_ref_point_object;
+    const kvs::Real32* point_coords = point->hasQuantizedCoords() ? NULL : point->coords().data();
+    const kvs::UInt8* point_color = point->hasColorIndices() ? NULL : point->colors().data();
+    const kvs::Real32* point_normal = point->hasEncodedNormals() ? NULL : point->normals().data();
 
     const float inv_ssize = 1.0f / ( m_subpixel_level * m_subpixel_level );
     const float normalize_alpha = 255.0f * inv_ssize;
@@ -180,11 +182,12 @@ void ParticleBuffer::create_image_with_shading(
                     const size_t bindex = bindex_start + bx;
                     if( m_depth_buffer[bindex] > 0.0f )
                     {
-                        const size_t point_index3 = 3 * m_index_buffer[ bindex ];
+                        const size_t point_index = m_index_buffer[ bindex ];
+                        const size_t point_index3 = 3 * point_index;
 
-                        const kvs::Vector3f vertex( point_coords + point_index3 );
-                        const kvs::Vector3f normal( point_normal + point_index3 );
-                        kvs::RGBColor color( point_color + point_index3 );
+                        const kvs::Vector3f vertex = point_coords ? kvs::Vector3f( point_coords + point_index3 ) : point->coord( point_index );
+                        const kvs::Vector3f normal = point_normal ? kvs::Vector3f( point_normal + point_index3 ) : point->normal( point_index );
+                        kvs::RGBColor color = point_color ? kvs::RGBColor( point_color + point_index3 ) : point->color( point_index );
                         color = m_ref_shader->shadedColor( color, vertex, normal );
                         R += color.r();
                         G += color.g();
@@ -220,7 +223,8 @@ void ParticleBuffer::create_image_without_shading(
     kvs::ValueArray<kvs::UInt8>* color,
     kvs::ValueArray<kvs::Real32>* depth )
 {
-    const kvs::UInt8* point_color = m_ref_point_object->colors().data();
+    const kvs::PointObject* point = m_ref_point_object;
+    const kvs::UInt8* point_color = point->hasColorIndices() ? NULL : point->colors().data();
 
     const float inv_ssize = 1.0f / ( m_subpixel_level * m_subpixel_level );
     const float normalize_alpha = 255.0f * inv_ssize;
@@ -247,11 +251,12 @@ void ParticleBuffer::create_image_without_shading(
                     const size_t bindex = bindex_start + bx;
                     if( m_depth_buffer[bindex] > 0.0f )
                     {
-                        const size_t point_index3 = 3 * m_index_buffer[ bindex ];
+                        const size_t point_index = m_index_buffer[ bindex ];
+                        const kvs::RGBColor color = point_color ? kvs::RGBColor( point_color + 3 * point_index ) : point->color( point_index );
 
-                        R += point_color[ point_index3 + 0 ];
-                        G += point_color[ point_index3 + 1 ];
-                        B += point_color[ point_index3 + 2 ];
+                        R += color.r();
+                        G += color.g();
+                        B += color.b();
                         D = kvs::Math::Max( D, m_depth_buffer[ bindex ] );
                         npoints++;
                     }
@@ -14,6 +14,7 @@
 /****************************************************************************/
 #include "PointRenderer.h"
 #include "PointRenderingFunction.h"
+#include "SameArray.h"
 #include <kvs/OpenGL>
 #include <kvs/Camera>
 #include <kvs/Light>
@@ -22,6 +23,32 @@
 #include <kvs/IgnoreUnusedVariable>
 
 
+namespace
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the scale that dequantizes the quantized coordinates.
+ *  @param  point [in] pointer to the compact point object
+ *  @return coordinate step of the quantized value on each axis
+ *
+ *  The quantized coordinates are all zero on the axis of no extent, so that
+ *  the axis is scaled by one instead of zero to keep the modelview matrix
+ *  invertible for the normal vectors.
+ */
+/*===========================================================================*/
+kvs::Vec3 CoordScale( const kvs::PointObject* point )
+{
+    const kvs::Vec3& scale = point->coordScale();
+    return kvs::Vec3(
+        scale.x() > 0.0f ? scale.x() : 1.0f,
+        scale.y() > 0.0f ? scale.y() : 1.0f,
+        scale.z() > 0.0f ? scale.z() : 1.0f );
+}
+
+} // end of namespace
+
+
 namespace kvs
 {
 
@@ -33,7 +60,10 @@ namespace kvs
 PointRenderer::PointRenderer():
     m_enable_anti_aliasing( false ),
     m_enable_multisample_anti_aliasing( false ),
-    m_enable_two_side_lighting( true )
+    m_enable_two_side_lighting( true ),
+    m_enable_vertex_buffer_object( true ),
+    m_object( NULL ),
+    m_expanded_source( NULL )
 {
 }
 
@@ -65,7 +95,7 @@ void PointRenderer::exec( ObjectBase* object, Camera* camera, Light* light )
 
     glPushAttrib( GL_CURRENT_BIT | GL_ENABLE_BIT );
 
-    if ( point->normals().size() == 0 ) { BaseClass::disableShading(); }
+    if ( point->numberOfNormals() == 0 ) { BaseClass::disableShading(); }
 
     this->initialize();
 
@@ -74,7 +104,15 @@ void PointRenderer::exec( ObjectBase* object, Camera* camera, Light* light )
 #endif
 
     glEnable( GL_DEPTH_TEST );
-    ::PointRenderingFunction( point );
+    if ( m_enable_vertex_buffer_object && this->is_buffer_object_supported( point ) )
+    {
+        if ( this->is_buffer_object_updated( point ) ) { this->create_buffer_object( point ); }
+        this->draw_buffer_object( point );
+    }
+    else
+    {
+        ::PointRenderingFunction( this->expanded_object( point ) );
+    }
     glDisable( GL_DEPTH_TEST );
 
     glPopAttrib();
@@ -119,6 +157,40 @@ bool PointRenderer::isTwoSideLighting() const
     return m_enable_two_side_lighting;
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Enables the vertex buffer object based rendering.
+ *
+ *  The points with a single point size are uploaded to the GPU only once;
+ *  the points with variable sizes are rendered in immediate mode.
+ */
+/*===========================================================================*/
+void PointRenderer::enableVertexBufferObject() const
+{
+    m_enable_vertex_buffer_object = true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Disables the vertex buffer object based rendering.
+ */
+/*===========================================================================*/
+void PointRenderer::disableVertexBufferObject() const
+{
+    m_enable_vertex_buffer_object = false;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns true if the vertex buffer object based rendering is enabled.
+ *  @return true, if the vertex buffer object is enabled
+ */
+/*===========================================================================*/
+bool PointRenderer::isEnabledVertexBufferObject() const
+{
+    return m_enable_vertex_buffer_object;
+}
+
 void PointRenderer::initialize()
 {
     glShadeModel( GL_SMOOTH );
@@ -162,4 +234,220 @@ void PointRenderer::initialize()
     }
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Returns true if the point object can be drawn with the buffer object.
+ *  @param  point [in] pointer to the point object
+ *  @return true, if the point object can be stored as per-vertex arrays
+ */
+/*===========================================================================*/
+bool PointRenderer::is_buffer_object_supported( const kvs::PointObject* point ) const
+{
+    const size_t nvertices = point->numberOfVertices();
+    const size_t ncolors = point->numberOfColors();
+    const size_t nnormals = point->numberOfNormals();
+
+    // Single point size, single or vertex colors, and vertex normals.
+    return point->numberOfSizes() == 1 &&
+        ( ncolors <= 1 || ncolors == nvertices ) &&
+        ( nnormals == 0 || nnormals == nvertices );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns true if the buffer object needs to be (re-)created.
+ *  @param  point [in] pointer to the point object
+ *  @return true, if the object or its arrays have been changed
+ */
+/*===========================================================================*/
+bool PointRenderer::is_buffer_object_updated( const kvs::PointObject* point ) const
+{
+    return m_object != point ||
+        !::IsSameArray( m_coords, point->coords() ) ||
+        !::IsSameArray( m_colors, point->colors() ) ||
+        !::IsSameArray( m_normals, point->normals() ) ||
+        !::IsSameArray( m_quantized_coords, point->quantizedCoords() ) ||
+        !::IsSameArray( m_encoded_normals, point->encodedNormals() ) ||
+        !::IsSameArray( m_color_indices, point->colorIndices() );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Creates the vertex buffer object.
+ *  @param  point [in] pointer to the point object
+ *
+ *  The quantized coordinates of the compact point object are stored as the
+ *  short values, and are dequantized with the modelview matrix in
+ *  draw_buffer_object(). The normal vectors are then multiplied by the
+ *  dequantization scale, since they are transformed by the inverse transpose
+ *  of the matrix. The encoded normals and the color indices are decoded.
+ */
+/*===========================================================================*/
+void PointRenderer::create_buffer_object( const kvs::PointObject* point )
+{
+    m_object = point;
+    m_coords = point->coords();
+    m_colors = point->colors();
+    m_normals = point->normals();
+    m_quantized_coords = point->quantizedCoords();
+    m_encoded_normals = point->encodedNormals();
+    m_color_indices = point->colorIndices();
+
+    const size_t nvertices = point->numberOfVertices();
+    const size_t nnormals = point->numberOfNormals();
+    const bool is_quantized = point->hasQuantizedCoords();
+
+    // The unsigned values are shifted to the range of GL_SHORT.
+    kvs::ValueArray<kvs::Int16> quantized_coords;
+    if ( is_quantized )
+    {
+        quantized_coords.allocate( nvertices * 3 );
+        for ( size_t i = 0; i < quantized_coords.size(); i++ )
+        {
+            quantized_coords[i] = static_cast<kvs::Int16>( int( m_quantized_coords[i] ) - 32768 );
+        }
+    }
+
+    kvs::ValueArray<kvs::UInt8> colors = m_colors;
+    if ( point->hasColorIndices() )
+    {
+        kvs::ValueArray<kvs::UInt8> decoded_colors( point->numberOfColors() * 3 );
+        for ( size_t i = 0; i < point->numberOfColors(); i++ )
+        {
+            const kvs::RGBColor color = point->color( i );
+            decoded_colors[ 3 * i + 0 ] = color.r();
+            decoded_colors[ 3 * i + 1 ] = color.g();
+            decoded_colors[ 3 * i + 2 ] = color.b();
+        }
+        colors = decoded_colors;
+    }
+
+    kvs::ValueArray<kvs::Real32> normals = m_normals;
+    if ( nnormals > 0 && ( is_quantized || point->hasEncodedNormals() ) )
+    {
+        const kvs::Vec3 scale = is_quantized ? ::CoordScale( point ) : kvs::Vec3( 1.0f, 1.0f, 1.0f );
+        kvs::ValueArray<kvs::Real32> decoded_normals( nnormals * 3 );
+        for ( size_t i = 0; i < nnormals; i++ )
+        {
+            const kvs::Vec3 normal = point->normal( i ) * scale;
+            decoded_normals[ 3 * i + 0 ] = normal.x();
+            decoded_normals[ 3 * i + 1 ] = normal.y();
+            decoded_normals[ 3 * i + 2 ] = normal.z();
+        }
+        normals = decoded_normals;
+    }
+
+    // A single color is specified with glColor instead of the color array.
+    const size_t coord_size = is_quantized ? quantized_coords.byteSize() : m_coords.byteSize();
+    const void* coord_data = is_quantized ? static_cast<const void*>( quantized_coords.data() ) : m_coords.data();
+    const size_t color_size = colors.size() > 3 ? colors.byteSize() : 0;
+    const size_t normal_size = normals.byteSize();
+
+    m_vbo.release();
+    m_vbo.create( coord_size + color_size + normal_size );
+    m_vbo.bind();
+    m_vbo.load( coord_size, coord_data, 0 );
+    if ( color_size > 0 )
+    {
+        m_vbo.load( color_size, colors.data(), coord_size );
+    }
+    if ( normal_size > 0 )
+    {
+        m_vbo.load( normal_size, normals.data(), coord_size + color_size );
+    }
+    m_vbo.unbind();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Draws the point object stored in the buffer object.
+ *  @param  point [in] pointer to the point object
+ */
+/*===========================================================================*/
+void PointRenderer::draw_buffer_object( const kvs::PointObject* point )
+{
+    const size_t nvertices = point->numberOfVertices();
+    const size_t ncolors = point->numberOfColors();
+    const bool is_quantized = point->hasQuantizedCoords();
+    const size_t coord_size = nvertices * 3 * ( is_quantized ? sizeof( kvs::Int16 ) : sizeof( kvs::Real32 ) );
+    const size_t color_size = ncolors > 1 ? nvertices * 3 * sizeof( kvs::UInt8 ) : 0;
+
+    kvs::OpenGL::WithPushedClientAttrib attrib( GL_CLIENT_VERTEX_ARRAY_BIT );
+    kvs::OpenGL::WithPushedMatrix modelview( GL_MODELVIEW );
+    kvs::VertexBufferObject::Binder bind( m_vbo );
+
+    KVS_GL_CALL( glPointSize( point->size() ) );
+
+    // Enable coords.
+    KVS_GL_CALL( glEnableClientState( GL_VERTEX_ARRAY ) );
+    if ( is_quantized )
+    {
+        // coord = offset + scale * ( short value + 32768 )
+        const kvs::Vec3 scale = ::CoordScale( point );
+        const kvs::Vec3 offset = point->coordOffset() + scale * 32768.0f;
+        modelview.translate( offset.x(), offset.y(), offset.z() );
+        modelview.scale( scale.x(), scale.y(), scale.z() );
+        KVS_GL_CALL( glVertexPointer( 3, GL_SHORT, 0, (GLbyte*)NULL + 0 ) );
+    }
+    else
+    {
+        KVS_GL_CALL( glVertexPointer( 3, GL_FLOAT, 0, (GLbyte*)NULL + 0 ) );
+    }
+
+    // Enable colors.
+    if ( ncolors > 1 )
+    {
+        KVS_GL_CALL( glEnableClientState( GL_COLOR_ARRAY ) );
+        KVS_GL_CALL( glColorPointer( 3, GL_UNSIGNED_BYTE, 0, (GLbyte*)NULL + coord_size ) );
+    }
+    else if ( ncolors == 1 )
+    {
+        const kvs::RGBColor color = point->color();
+        KVS_GL_CALL( glColor3ub( color.r(), color.g(), color.b() ) );
+    }
+
+    // Enable normals.
+    if ( point->numberOfNormals() > 0 )
+    {
+        KVS_GL_CALL( glEnableClientState( GL_NORMAL_ARRAY ) );
+        KVS_GL_CALL( glNormalPointer( GL_FLOAT, 0, (GLbyte*)NULL + coord_size + color_size ) );
+    }
+
+    // Draw points.
+    KVS_GL_CALL( glDrawArrays( GL_POINTS, 0, nvertices ) );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the point object drawn in the immediate mode.
+ *  @param  point [in] pointer to the point object
+ *  @return the point object, or its expanded copy if it is compact
+ *
+ *  The compact point object is expanded once, and is expanded again only
+ *  when the object or its arrays have been changed.
+ */
+/*===========================================================================*/
+const kvs::PointObject* PointRenderer::expanded_object( const kvs::PointObject* point )
+{
+    if ( !point->isCompact() ) { return point; }
+
+    const bool is_updated = m_expanded_source != point ||
+        !::IsSameArray( m_compact_object.coords(), point->coords() ) ||
+        !::IsSameArray( m_compact_object.colors(), point->colors() ) ||
+        !::IsSameArray( m_compact_object.normals(), point->normals() ) ||
+        !::IsSameArray( m_compact_object.sizes(), point->sizes() ) ||
+        !::IsSameArray( m_compact_object.quantizedCoords(), point->quantizedCoords() ) ||
+        !::IsSameArray( m_compact_object.encodedNormals(), point->encodedNormals() ) ||
+        !::IsSameArray( m_compact_object.colorIndices(), point->colorIndices() );
+    if ( is_updated )
+    {
+        m_expanded_source = point;
+        m_compact_object.shallowCopy( *point );
+        m_expanded_object.shallowCopy( *point );
+        m_expanded_object.expand();
+    }
+
+    return &m_expanded_object;
+}
+
 } // end of namespace kvs
@@ -17,6 +17,9 @@
 
 #include <kvs/RendererBase>
 #include <kvs/Module>
+#include <kvs/ValueArray>
+#include <kvs/VertexBufferObject>
+#include <kvs/PointObject>
 
 
 namespace kvs
@@ -41,6 +44,21 @@ protected:
     mutable bool m_enable_anti_aliasing; ///< flag for anti-aliasing (AA)
     mutable bool m_enable_multisample_anti_aliasing; ///< flag for multisample anti-aliasing (MSAA)
     mutable bool m_enable_two_side_lighting; ///< flag for two-side lighting
+    mutable bool m_enable_vertex_buffer_object; ///< flag for the vertex buffer object (VBO)
+
+private:
+
+    const kvs::ObjectBase* m_object; ///< pointer to the object stored in the buffer object
+    kvs::ValueArray<kvs::Real32> m_coords; ///< coordinate array stored in the VBO
+    kvs::ValueArray<kvs::UInt8> m_colors; ///< color array stored in the VBO
+    kvs::ValueArray<kvs::Real32> m_normals; ///< normal vector array stored in the VBO
+    kvs::ValueArray<kvs::UInt16> m_quantized_coords; ///< quantized coordinate array stored in the VBO
+    kvs::ValueArray<kvs::UInt16> m_encoded_normals; ///< encoded normal array stored in the VBO
+    kvs::ValueArray<kvs::UInt8> m_color_indices; ///< color index array stored in the VBO
+    kvs::VertexBufferObject m_vbo; ///< vertex buffer object
+    const kvs::ObjectBase* m_expanded_source; ///< pointer to the compact object of the expanded copy
+    kvs::PointObject m_compact_object; ///< shallow copy of the compact object of the expanded copy
+    kvs::PointObject m_expanded_object; ///< expanded copy drawn in the immediate mode
 
 public:
 
@@ -52,12 +70,20 @@ public:
     void enableTwoSideLighting() const;
     void disableTwoSideLighting() const;
     bool isTwoSideLighting() const;
+    void enableVertexBufferObject() const;
+    void disableVertexBufferObject() const;
+    bool isEnabledVertexBufferObject() const;
 
     void exec( kvs::ObjectBase* object, kvs::Camera* camera, kvs::Light* light );
 
 private:
 
     void initialize();
+    bool is_buffer_object_supported( const kvs::PointObject* point ) const;
+    bool is_buffer_object_updated( const kvs::PointObject* point ) const;
+    void create_buffer_object( const kvs::PointObject* point );
+    void draw_buffer_object( const kvs::PointObject* point );
+    const kvs::PointObject* expanded_object( const kvs::PointObject* point );
 };
 
 } // end of namespace kvs
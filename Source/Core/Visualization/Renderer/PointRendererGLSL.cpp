@@ -221,6 +221,14 @@ void PointRenderer::create_shader_program()
 /*===========================================================================*/
 void PointRenderer::create_buffer_object( const kvs::PointObject* point )
 {
+    kvs::PointObject expanded;
+    if ( point->isCompact() )
+    {
+        expanded.shallowCopy( *point );
+        expanded.expand();
+        point = &expanded;
+    }
+
     kvs::ValueArray<kvs::Real32> coords = point->coords();
     kvs::ValueArray<kvs::UInt8> colors = ::VertexColors( point );
     kvs::ValueArray<kvs::Real32> normals = point->normals();
@@ -14,6 +14,7 @@
 /****************************************************************************/
 #include "PolygonRenderer.h"
 #include "PolygonRenderingFunction.h"
+#include "SameArray.h"
 #include <kvs/OpenGL>
 #include <kvs/Camera>
 #include <kvs/Light>
@@ -22,6 +23,77 @@
 #include <kvs/IgnoreUnusedVariable>
 
 
+namespace
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns vertex-color (RGBA) array.
+ *  @param  polygon [in] pointer to the polygon object
+ */
+/*===========================================================================*/
+kvs::ValueArray<kvs::UInt8> VertexColors( const kvs::PolygonObject* polygon )
+{
+    const size_t nvertices = polygon->numberOfVertices();
+    const bool is_single_color = polygon->colors().size() == 3;
+    const bool is_single_alpha = polygon->opacities().size() == 1;
+    const kvs::UInt8* pcolors = polygon->colors().data();
+    const kvs::UInt8* palphas = polygon->opacities().data();
+
+    kvs::ValueArray<kvs::UInt8> colors( nvertices * 4 );
+    kvs::UInt8* pdst = colors.data();
+    for ( size_t i = 0; i < nvertices; i++ )
+    {
+        const kvs::UInt8* c = is_single_color ? pcolors : pcolors + 3 * i;
+        *(pdst++) = c[0];
+        *(pdst++) = c[1];
+        *(pdst++) = c[2];
+        *(pdst++) = is_single_alpha ? palphas[0] : palphas[i];
+    }
+
+    return colors;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns vertex-normal array.
+ *  @param  polygon [in] pointer to the polygon object
+ */
+/*===========================================================================*/
+kvs::ValueArray<kvs::Real32> VertexNormals( const kvs::PolygonObject* polygon )
+{
+    if ( polygon->normals().size() == 0 )
+    {
+        return kvs::ValueArray<kvs::Real32>();
+    }
+
+    if ( polygon->normalType() == kvs::PolygonObject::VertexNormal )
+    {
+        return polygon->normals();
+    }
+
+    // Same normal vectors are assigned for each vertex of the polygon.
+    const size_t ncorners = polygon->polygonType();
+    const size_t npolygons = polygon->numberOfNormals();
+    kvs::ValueArray<kvs::Real32> normals( npolygons * ncorners * 3 );
+    const kvs::Real32* psrc = polygon->normals().data();
+    kvs::Real32* pdst = normals.data();
+    for ( size_t i = 0; i < npolygons; i++, psrc += 3 )
+    {
+        for ( size_t j = 0; j < ncorners; j++ )
+        {
+            *(pdst++) = psrc[0];
+            *(pdst++) = psrc[1];
+            *(pdst++) = psrc[2];
+        }
+    }
+
+    return normals;
+}
+
+} // end of namespace
+
+
 namespace kvs
 {
 
@@ -33,7 +105,9 @@ namespace kvs
 PolygonRenderer::PolygonRenderer():
     m_enable_anti_aliasing( false ),
     m_enable_multisample_anti_aliasing( false ),
-    m_enable_two_side_lighting( true )
+    m_enable_two_side_lighting( true ),
+    m_enable_vertex_buffer_object( true ),
+    m_object( NULL )
 {
 }
 
@@ -103,7 +177,15 @@ void PolygonRenderer::exec( kvs::ObjectBase* object, kvs::Camera* camera, kvs::L
     }
 
     glEnable( GL_DEPTH_TEST );
-    ::PolygonRenderingFunction( polygon );
+    if ( m_enable_vertex_buffer_object && this->is_buffer_object_supported( polygon ) )
+    {
+        if ( this->is_buffer_object_updated( polygon ) ) { this->create_buffer_object( polygon ); }
+        this->draw_buffer_object( polygon );
+    }
+    else
+    {
+        ::PolygonRenderingFunction( polygon );
+    }
     glDisable( GL_DEPTH_TEST );
 
     glPopAttrib();
@@ -148,6 +230,42 @@ bool PolygonRenderer::isTwoSideLighting() const
     return( m_enable_two_side_lighting );
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Enables the vertex buffer object based rendering.
+ *
+ *  The vertex arrays of the polygon object are uploaded to the GPU only once
+ *  and re-uploaded when the object or its arrays are replaced. The polygons
+ *  that cannot be represented as per-vertex arrays (e.g. polygon colors or
+ *  polygon normals with connections) are rendered in immediate mode.
+ */
+/*===========================================================================*/
+void PolygonRenderer::enableVertexBufferObject() const
+{
+    m_enable_vertex_buffer_object = true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Disables the vertex buffer object based rendering.
+ */
+/*===========================================================================*/
+void PolygonRenderer::disableVertexBufferObject() const
+{
+    m_enable_vertex_buffer_object = false;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns true if the vertex buffer object based rendering is enabled.
+ *  @return true, if the vertex buffer object is enabled
+ */
+/*===========================================================================*/
+bool PolygonRenderer::isEnabledVertexBufferObject() const
+{
+    return m_enable_vertex_buffer_object;
+}
+
 /*==========================================================================*/
 /**
  *  Initialize OpenGL status for the rendering.
@@ -181,4 +299,154 @@ void PolygonRenderer::initialize()
     kvs::Light::SetModelTwoSide( this->isTwoSideLighting() );
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Returns true if the polygon object can be drawn with the buffer objects.
+ *  @param  polygon [in] pointer to the polygon object
+ *  @return true, if the polygon object can be stored as per-vertex arrays
+ */
+/*===========================================================================*/
+bool PolygonRenderer::is_buffer_object_supported( const kvs::PolygonObject* polygon ) const
+{
+    const kvs::PolygonObject::PolygonType polygon_type = polygon->polygonType();
+    if ( polygon_type != kvs::PolygonObject::Triangle &&
+         polygon_type != kvs::PolygonObject::Quadrangle ) { return false; }
+
+    const size_t nvertices = polygon->numberOfVertices();
+    const size_t ncolors = polygon->numberOfColors();
+    const size_t nopacities = polygon->numberOfOpacities();
+    const size_t nnormals = polygon->numberOfNormals();
+    const bool has_connection = polygon->numberOfConnections() > 0;
+    const bool is_vertex_color =
+        polygon->colorType() == kvs::PolygonObject::VertexColor && ncolors == nvertices;
+
+    // Single color or vertex colors.
+    if ( ncolors != 1 && !is_vertex_color ) { return false; }
+
+    // Single opacity or vertex opacities.
+    if ( nopacities != 1 && !( is_vertex_color && nopacities == nvertices ) ) { return false; }
+
+    // Vertex normals or polygon normals without connections.
+    if ( nnormals > 0 )
+    {
+        if ( polygon->normalType() == kvs::PolygonObject::VertexNormal )
+        {
+            if ( nnormals != nvertices ) { return false; }
+        }
+        else
+        {
+            if ( has_connection || nnormals * polygon_type != nvertices ) { return false; }
+        }
+    }
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns true if the buffer objects need to be (re-)created.
+ *  @param  polygon [in] pointer to the polygon object
+ *  @return true, if the object or its arrays have been changed
+ */
+/*===========================================================================*/
+bool PolygonRenderer::is_buffer_object_updated( const kvs::PolygonObject* polygon ) const
+{
+    return m_object != polygon ||
+        !::IsSameArray( m_coords, polygon->coords() ) ||
+        !::IsSameArray( m_colors, polygon->colors() ) ||
+        !::IsSameArray( m_opacities, polygon->opacities() ) ||
+        !::IsSameArray( m_normals, polygon->normals() ) ||
+        !::IsSameArray( m_connections, polygon->connections() );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Creates the vertex and index buffer objects.
+ *  @param  polygon [in] pointer to the polygon object
+ */
+/*===========================================================================*/
+void PolygonRenderer::create_buffer_object( const kvs::PolygonObject* polygon )
+{
+    m_object = polygon;
+    m_coords = polygon->coords();
+    m_colors = polygon->colors();
+    m_opacities = polygon->opacities();
+    m_normals = polygon->normals();
+    m_connections = polygon->connections();
+
+    kvs::ValueArray<kvs::UInt8> colors = ::VertexColors( polygon );
+    kvs::ValueArray<kvs::Real32> normals = ::VertexNormals( polygon );
+
+    const size_t coord_size = m_coords.byteSize();
+    const size_t color_size = colors.byteSize();
+    const size_t normal_size = normals.byteSize();
+    const size_t byte_size = coord_size + color_size + normal_size;
+
+    m_vbo.release();
+    m_vbo.create( byte_size );
+    m_vbo.bind();
+    m_vbo.load( coord_size, m_coords.data(), 0 );
+    m_vbo.load( color_size, colors.data(), coord_size );
+    if ( normal_size > 0 )
+    {
+        m_vbo.load( normal_size, normals.data(), coord_size + color_size );
+    }
+    m_vbo.unbind();
+
+    m_ibo.release();
+    if ( m_connections.size() > 0 )
+    {
+        const size_t connection_size = m_connections.byteSize();
+        m_ibo.create( connection_size );
+        m_ibo.bind();
+        m_ibo.load( connection_size, m_connections.data(), 0 );
+        m_ibo.unbind();
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Draws the polygon object stored in the buffer objects.
+ *  @param  polygon [in] pointer to the polygon object
+ */
+/*===========================================================================*/
+void PolygonRenderer::draw_buffer_object( const kvs::PolygonObject* polygon )
+{
+    const size_t nvertices = polygon->numberOfVertices();
+    const size_t coord_size = nvertices * 3 * sizeof( kvs::Real32 );
+    const size_t color_size = nvertices * 4 * sizeof( kvs::UInt8 );
+    const bool has_normal = polygon->numberOfNormals() > 0;
+    const GLenum mode =
+        polygon->polygonType() == kvs::PolygonObject::Triangle ? GL_TRIANGLES : GL_QUADS;
+
+    kvs::OpenGL::WithPushedClientAttrib attrib( GL_CLIENT_VERTEX_ARRAY_BIT );
+    kvs::VertexBufferObject::Binder bind1( m_vbo );
+
+    // Enable coords.
+    KVS_GL_CALL( glEnableClientState( GL_VERTEX_ARRAY ) );
+    KVS_GL_CALL( glVertexPointer( 3, GL_FLOAT, 0, (GLbyte*)NULL + 0 ) );
+
+    // Enable colors.
+    KVS_GL_CALL( glEnableClientState( GL_COLOR_ARRAY ) );
+    KVS_GL_CALL( glColorPointer( 4, GL_UNSIGNED_BYTE, 0, (GLbyte*)NULL + coord_size ) );
+
+    // Enable normals.
+    if ( has_normal )
+    {
+        KVS_GL_CALL( glEnableClientState( GL_NORMAL_ARRAY ) );
+        KVS_GL_CALL( glNormalPointer( GL_FLOAT, 0, (GLbyte*)NULL + coord_size + color_size ) );
+    }
+
+    // Draw polygons.
+    if ( m_connections.size() > 0 )
+    {
+        kvs::IndexBufferObject::Binder bind2( m_ibo );
+        KVS_GL_CALL( glDrawElements( mode, m_connections.size(), GL_UNSIGNED_INT, 0 ) );
+    }
+    else
+    {
+        KVS_GL_CALL( glDrawArrays( mode, 0, nvertices ) );
+    }
+}
+
 } // end of namespace kvs
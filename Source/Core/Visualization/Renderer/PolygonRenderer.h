@@ -17,11 +17,16 @@
 
 #include <kvs/RendererBase>
 #include <kvs/Module>
+#include <kvs/ValueArray>
+#include <kvs/VertexBufferObject>
+#include <kvs/IndexBufferObject>
 
 
 namespace kvs
 {
 
+class PolygonObject;
+
 /*==========================================================================*/
 /**
  *  Polygon renderer.
@@ -37,6 +42,18 @@ protected:
     mutable bool m_enable_anti_aliasing; ///< flag for anti-aliasing (AA)
     mutable bool m_enable_multisample_anti_aliasing; ///< flag for multisample anti-aliasing (MSAA)
     mutable bool m_enable_two_side_lighting; ///< flag for two-side lighting
+    mutable bool m_enable_vertex_buffer_object; ///< flag for the vertex buffer object (VBO)
+
+private:
+
+    const kvs::ObjectBase* m_object; ///< pointer to the object stored in the buffer objects
+    kvs::ValueArray<kvs::Real32> m_coords; ///< coordinate array stored in the VBO
+    kvs::ValueArray<kvs::UInt8> m_colors; ///< color array stored in the VBO
+    kvs::ValueArray<kvs::UInt8> m_opacities; ///< opacity array stored in the VBO
+    kvs::ValueArray<kvs::Real32> m_normals; ///< normal vector array stored in the VBO
+    kvs::ValueArray<kvs::UInt32> m_connections; ///< connection array stored in the IBO
+    kvs::VertexBufferObject m_vbo; ///< vertex buffer object
+    kvs::IndexBufferObject m_ibo; ///< index buffer object
 
 public:
 
@@ -50,10 +67,17 @@ public:
     void enableTwoSideLighting() const;
     void disableTwoSideLighting() const;
     bool isTwoSideLighting() const;
+    void enableVertexBufferObject() const;
+    void disableVertexBufferObject() const;
+    bool isEnabledVertexBufferObject() const;
 
 private:
 
     void initialize();
+    bool is_buffer_object_supported( const kvs::PolygonObject* polygon ) const;
+    bool is_buffer_object_updated( const kvs::PolygonObject* polygon ) const;
+    void create_buffer_object( const kvs::PolygonObject* polygon );
+    void draw_buffer_object( const kvs::PolygonObject* polygon );
 };
 
 } // end of namespace kvs
@@ -209,7 +209,8 @@ namespace kvs
  *  @brief  Constructs a new PreIntegrationTable3D class.
  */
 /*===========================================================================*/
-PreIntegrationTable3D::PreIntegrationTable3D()
+PreIntegrationTable3D::PreIntegrationTable3D():
+    m_max_size_of_cell( 1.0f )
 {
     this->setScalarResolution( 128 );
     this->setDepthResolution( 128 );
@@ -224,7 +225,8 @@ PreIntegrationTable3D::PreIntegrationTable3D()
 /*===========================================================================*/
 PreIntegrationTable3D::PreIntegrationTable3D( const size_t scalar_resolution, const size_t depth_resolution ):
     m_scalar_resolution( scalar_resolution ),
-    m_depth_resolution( depth_resolution )
+    m_depth_resolution( depth_resolution ),
+    m_max_size_of_cell( 1.0f )
 {
 }
 
@@ -260,9 +262,82 @@ void PreIntegrationTable3D::create( const float max_size_of_cell )
     m_table.allocate( slice_size * m_depth_resolution );
     m_table.fill( 0.0f );
 
-    const float dl = max_size_of_cell / float( m_depth_resolution - 1 );
+    m_max_size_of_cell = max_size_of_cell;
+    this->compute_table( 0, m_scalar_resolution - 1 );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Updates pre-integration table for the edited transfer function.
+ *  @param  transfer_function [in] transfer function
+ *  @param  min_scalar [in] minimum scalar value
+ *  @param  max_scalar [in] maximum scalar value
+ *  @return true if the table is changed
+ *
+ *  The entry for the front and back scalars is integrated over the transfer
+ *  function between them, so that only the entries whose scalar interval
+ *  intersects the edited part of the transfer function are re-computed. The
+ *  table is created if it has not been created.
+ */
+/*===========================================================================*/
+bool PreIntegrationTable3D::update(
+    const kvs::TransferFunction& transfer_function,
+    const float min_scalar,
+    const float max_scalar )
+{
+    const kvs::ValueArray<kvs::Real32> previous = m_transfer_function;
+    this->setTransferFunction( transfer_function, min_scalar, max_scalar );
+
+    const size_t N = m_scalar_resolution;
+    const size_t slice_size = 4 * N * N;
+    if ( m_table.size() != slice_size * m_depth_resolution || previous.size() != m_transfer_function.size() )
+    {
+        this->create( m_max_size_of_cell );
+        return true;
+    }
+
+    // Find the changed entries of the serialized transfer function.
+    size_t first = N;
+    size_t last = 0;
+    for ( size_t i = 0; i < N; i++ )
+    {
+        for ( size_t j = 0; j < 4; j++ )
+        {
+            if ( !kvs::Math::Equal( previous[ 4 * i + j ], m_transfer_function[ 4 * i + j ] ) )
+            {
+                if ( first == N ) first = i;
+                last = i;
+                break;
+            }
+        }
+    }
+    if ( first == N ) return false;
+
+    // The incremental levels interpolate the neighboring entries, so that the
+    // interval is extended by one entry.
+    first = first > 0 ? first - 1 : 0;
+    last = kvs::Math::Min( last + 1, N - 1 );
+    this->compute_table( first, last );
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Computes the entries of pre-integration table.
+ *  @param  first [in] first index of the changed scalar interval
+ *  @param  last [in] last index of the changed scalar interval
+ *
+ *  The entries whose scalar interval between the front and back scalars
+ *  does not intersect [first, last] are not computed.
+ */
+/*===========================================================================*/
+void PreIntegrationTable3D::compute_table( const size_t first, const size_t last )
+{
+    const size_t slice_size = 4 * m_scalar_resolution * m_scalar_resolution;
+    const float dl = m_max_size_of_cell / float( m_depth_resolution - 1 );
     kvs::Real32* slice0 = m_table.data();
-    this->compute_exact_level( slice0, dl );
+    this->compute_exact_level( slice0, dl, first, last );
 
     float l = dl;
     for ( size_t i = 1; i < m_depth_resolution; i++ )
@@ -270,7 +345,7 @@ void PreIntegrationTable3D::create( const float max_size_of_cell )
         l += dl;
         kvs::Real32* slice = slice0 + i * slice_size;
         const kvs::Real32* slicep = slice0 + ( i - 1 ) * slice_size;
-        this->compute_incremental_level( slice, slicep, slice0, l, dl );
+        this->compute_incremental_level( slice, slicep, slice0, l, dl, first, last );
     }
 }
 
@@ -279,9 +354,15 @@ void PreIntegrationTable3D::create( const float max_size_of_cell )
  *  @brief  Computes 2D pre-integration table by numerical integration.
  *  @param  slice0 [in/out] pointer to the head of the first slice
  *  @param  dl [in] thickness of a slice
+ *  @param  first [in] first index of the scalar interval to be computed
+ *  @param  last [in] last index of the scalar interval to be computed
  */
 /*===========================================================================*/
-void PreIntegrationTable3D::compute_exact_level( float* slice0, const float dl )
+void PreIntegrationTable3D::compute_exact_level(
+    float* slice0,
+    const float dl,
+    const size_t first,
+    const size_t last )
 {
     const size_t N = m_scalar_resolution;
     const kvs::ValueArray<kvs::Real32>& TF = m_transfer_function;
@@ -289,6 +370,8 @@ void PreIntegrationTable3D::compute_exact_level( float* slice0, const float dl )
     {
         for ( size_t sf = 0; sf < N; sf++, index++ )
         {
+            if ( kvs::Math::Max( sb, sf ) < first || kvs::Math::Min( sb, sf ) > last ) continue;
+
             kvs::Vec4 c( 0.0f, 0.0f, 0.0f, 0.0f );
 
             if ( sb == sf )
@@ -336,6 +419,8 @@ void PreIntegrationTable3D::compute_exact_level( float* slice0, const float dl )
  *  @param  slice0 [in] pointer to the head of the first slice
  *  @param  l [in] thickness between the first and the current slices
  *  @param  dl [in] thickness of a slice
+ *  @param  first [in] first index of the scalar interval to be computed
+ *  @param  last [in] last index of the scalar interval to be computed
  */
 /*===========================================================================*/
 void PreIntegrationTable3D::compute_incremental_level(
@@ -343,13 +428,17 @@ void PreIntegrationTable3D::compute_incremental_level(
     const float* slicep,
     const float* slice0,
     const float l,
-    const float dl )
+    const float dl,
+    const size_t first,
+    const size_t last )
 {
     const size_t N = m_scalar_resolution;
     for ( size_t i = 0, index = 0; i < N; i++ )
     {
         for ( size_t j = 0; j < N; j++, index++ )
         {
+            if ( kvs::Math::Max( i, j ) < first || kvs::Math::Min( i, j ) > last ) continue;
+
             const float sf = ( 2.0f * j + 1.0f ) / ( 2.0f * N );
             const float sb = ( 2.0f * i + 1.0f ) / ( 2.0f * N );
             const float sp = ( ( l - dl ) * sf + ( dl * sb ) ) / l;
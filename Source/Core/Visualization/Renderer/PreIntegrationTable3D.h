@@ -42,6 +42,7 @@ private:
     kvs::ValueArray<kvs::Real32> m_table; ///< 3D pre-integration table
     size_t m_scalar_resolution; ///< resolution of the scalar axis
     size_t m_depth_resolution; ///< resolution of the depth axis
+    float m_max_size_of_cell; ///< maximum size of the cell
 
 public:
 
@@ -58,11 +59,13 @@ public:
     void setTransferFunction( const kvs::TransferFunction& transfer_function, const float min_scalar, const float max_scalar );
 
     void create( const float max_size_of_cell );
+    bool update( const kvs::TransferFunction& transfer_function, const float min_scalar, const float max_scalar );
 
 private:
 
-    void compute_exact_level( float* slice0, const float dl );
-    void compute_incremental_level( float* slice, const float* slicep, const float* slice0, const float l, const float dl );
+    void compute_table( const size_t first, const size_t last );
+    void compute_exact_level( float* slice0, const float dl, const size_t first, const size_t last );
+    void compute_incremental_level( float* slice, const float* slicep, const float* slice0, const float l, const float dl, const size_t first, const size_t last );
 };
 
 } // end of namespace kvs
@@ -14,6 +14,7 @@
 /****************************************************************************/
 #include "RayCastingRenderer.h"
 #include <cstring>
+#include <cmath>
 #include <kvs/Math>
 #include <kvs/Type>
 #include <kvs/Message>
@@ -23,6 +24,12 @@
 #include <kvs/OpenGL>
 
 
+namespace
+{
+const size_t DefaultLODNumberOfNodes = 64 * 64 * 64;
+}
+
+
 namespace kvs
 {
 
@@ -35,7 +42,8 @@ RayCastingRenderer::RayCastingRenderer():
     m_step( 0.5f ),
     m_opaque( 0.97f ),
     m_ray_width( 1 ),
-    m_enable_lod( false )
+    m_enable_lod( false ),
+    m_lod_nnodes( ::DefaultLODNumberOfNodes )
 {
     BaseClass::setShader( kvs::Shader::Lambert() );
 }
@@ -50,7 +58,8 @@ RayCastingRenderer::RayCastingRenderer( const kvs::TransferFunction& tfunc ):
     m_step( 0.5f ),
     m_opaque( 0.97f ),
     m_ray_width( 1 ),
-    m_enable_lod( false )
+    m_enable_lod( false ),
+    m_lod_nnodes( ::DefaultLODNumberOfNodes )
 {
     BaseClass::setTransferFunction( tfunc );
     BaseClass::setShader( kvs::Shader::Lambert() );
@@ -67,7 +76,8 @@ RayCastingRenderer::RayCastingRenderer( const ShadingType shader ):
     m_step( 0.5f ),
     m_opaque( 0.97f ),
     m_ray_width( 1 ),
-    m_enable_lod( false )
+    m_enable_lod( false ),
+    m_lod_nnodes( ::DefaultLODNumberOfNodes )
 {
     BaseClass::setShader( shader );
 }
@@ -96,7 +106,7 @@ void RayCastingRenderer::exec(
         const size_t npixels = BaseClass::windowWidth() * BaseClass::windowHeight();
         BaseClass::allocateColorData( npixels * 4 );
         BaseClass::allocateDepthData( npixels );
-        kvs::OpenGL::GetModelViewMatrix( m_modelview );
+        BaseClass::getModelViewMatrix( m_modelview );
     }
 
     // Initialize frame buffer.
@@ -169,28 +179,47 @@ void RayCastingRenderer::rasterize(
 
     // LOD control.
     size_t ray_width = 1;
+    bool interacting = false;
     if ( m_enable_lod )
     {
         float modelview[16];
-        kvs::OpenGL::GetModelViewMatrix( modelview );
+        BaseClass::getModelViewMatrix( modelview );
         for ( size_t i = 0; i < 16; i++ )
         {
             if ( m_modelview[i] != modelview[i] )
             {
                 ray_width = m_ray_width;
+                interacting = true;
                 break;
             }
         }
         memcpy( m_modelview, modelview, sizeof( modelview ) );
     }
 
+    // Select the pyramid level. During the interaction, a coarser level is
+    // sampled with a larger step and the opacity is corrected for the step.
+    // Only the ray width is changed for the volume without the pyramid.
+    const kvs::StructuredVolumeObject* level = volume;
+    kvs::Vec3 scale( 1.0f, 1.0f, 1.0f );
+    if ( interacting && m_lod_nnodes > 0 && kvs::VolumePyramid::IsSupported( volume ) )
+    {
+        if ( m_pyramid.sourceVolume() != volume ) m_pyramid.build( volume );
+        if ( m_pyramid.sourceVolume() == volume )
+        {
+            const size_t l = m_pyramid.selectLevel( m_lod_nnodes );
+            level = m_pyramid.level( l );
+            scale = m_pyramid.scale( l );
+        }
+    }
+    const float step_ratio = 1.0f / kvs::Math::Max( scale.x(), scale.y(), scale.z() );
+
     // Set the trilinear interpolator.
-    kvs::TrilinearInterpolator interpolator( volume );
+    kvs::TrilinearInterpolator interpolator( level );
 
     // Calculate the ray in the object coordinate system.
-    float modelview[16]; kvs::OpenGL::GetModelViewMatrix( static_cast<GLfloat*>( modelview ) );
-    float projection[16]; kvs::OpenGL::GetProjectionMatrix( static_cast<GLfloat*>( projection ) );
-    int viewport[4]; kvs::OpenGL::GetViewport( static_cast<GLint*>( viewport ) );
+    float modelview[16]; BaseClass::getModelViewMatrix( modelview );
+    float projection[16]; BaseClass::getProjectionMatrix( projection );
+    int viewport[4]; BaseClass::getViewport( viewport );
     kvs::VolumeRayIntersector ray( volume, modelview, projection, viewport );
 
     // Execute ray casting.
@@ -199,7 +228,7 @@ void RayCastingRenderer::rasterize(
     const kvs::Shader::ShadingModel& shader = BaseClass::shader();
     const kvs::ColorMap& cmap = BaseClass::transferFunction().colorMap();
     const kvs::OpacityMap& omap = BaseClass::transferFunction().opacityMap();
-    const float step = m_step;
+    const float step = m_step * step_ratio;
     const float opaque = m_opaque;
     size_t depth_index = 0;
     size_t pixel_index = 0;
@@ -224,16 +253,18 @@ void RayCastingRenderer::rasterize(
                 do
                 {
                     // Interpolation.
-                    interpolator.attachPoint( ray.point() );
+                    const kvs::Vec3 vertex = ray.point();
+                    interpolator.attachPoint( vertex * scale );
 
                     // Classification.
                     const float s = interpolator.template scalar<T>();
-                    const float opacity = omap.at(s);
+                    float opacity = omap.at(s);
                     if ( !kvs::Math::IsZero( opacity ) )
                     {
+                        if ( step_ratio != 1.0f ) opacity = 1.0f - std::pow( 1.0f - opacity, step_ratio );
+
                         // Shading.
-                        const kvs::Vec3 vertex = ray.point();
-                        const kvs::Vec3 normal = interpolator.template gradient<T>();
+                        const kvs::Vec3 normal = interpolator.template gradient<T>() * scale;
                         const kvs::RGBColor color = shader.shadedColor( cmap.at(s), vertex, normal );
 
                         // Front-to-back accumulation.
@@ -316,7 +347,7 @@ void RayCastingRenderer::rasterize(
         }
     }
 
-    kvs::OpenGL::Finish();
+    if ( !BaseClass::isHeadless() ) kvs::OpenGL::Finish();
 }
 
 template
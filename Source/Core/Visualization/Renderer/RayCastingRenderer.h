@@ -18,6 +18,7 @@
 #include <kvs/VolumeRendererBase>
 #include <kvs/TransferFunction>
 #include <kvs/StructuredVolumeObject>
+#include <kvs/VolumePyramid>
 #include <kvs/Module>
 #include <kvs/Deprecated>
 
@@ -41,6 +42,8 @@ private:
     float m_opaque; ///< opaque value for early ray termination
     size_t m_ray_width; ///< ray width
     bool m_enable_lod; ///< enable LOD rendering
+    size_t m_lod_nnodes; ///< max. number of nodes of the pyramid level used for LOD rendering
+    kvs::VolumePyramid m_pyramid; ///< volume pyramid for LOD rendering
     float m_modelview[16]; ///< modelview matrix
 
 public:
@@ -55,6 +58,8 @@ public:
     void setOpaqueValue( const float opaque ) { m_opaque = opaque; }
     void enableLODControl( const size_t ray_width = 3 ) { m_enable_lod = true; m_ray_width = ray_width; }
     void disableLODControl() { m_enable_lod = false; m_ray_width = 1; }
+    void setLODNumberOfNodes( const size_t nnodes ) { m_lod_nnodes = nnodes; }
+    size_t lodNumberOfNodes() const { return m_lod_nnodes; }
 
 private:
 
@@ -18,6 +18,9 @@
 #include <kvs/Vector3>
 #include <kvs/OpenGL>
 #include <kvs/Coordinate>
+#include <kvs/Math>
+#include <kvs/PixelUnpackBufferObject>
+#include <cstring>
 
 
 namespace
@@ -25,55 +28,242 @@ namespace
 
 /*===========================================================================*/
 /**
- *  @brief  Normalizes value array.
- *  @param  volume [in] pointer to the volume object
- *  @param  min_value [in] minimum value of the volume data
- *  @param  max_value [in] maximum value of the volume data
- *  @return normalized value array
+ *  @brief  Returns half-precision floating point value (IEEE 754 binary16).
+ *  @param  value [in] single-precision floating point value
+ *  @return half-precision value rounded to nearest even
+ */
+/*===========================================================================*/
+kvs::UInt16 FloatToHalf( const kvs::Real32 value )
+{
+    kvs::UInt32 f = 0;
+    std::memcpy( &f, &value, sizeof( f ) );
+
+    const kvs::UInt32 sign = ( f >> 16 ) & 0x8000;
+    const kvs::Int32 exponent = static_cast<kvs::Int32>( ( f >> 23 ) & 0xff ) - 127 + 15;
+    kvs::UInt32 mantissa = f & 0x007fffff;
+
+    // Infinity or NaN.
+    if ( ( ( f >> 23 ) & 0xff ) == 0xff )
+    {
+        return static_cast<kvs::UInt16>( sign | 0x7c00 | ( mantissa ? 0x0200 : 0 ) );
+    }
+
+    // Overflow.
+    if ( exponent >= 31 ) { return static_cast<kvs::UInt16>( sign | 0x7c00 ); }
+
+    // Subnormal or zero.
+    if ( exponent <= 0 )
+    {
+        if ( exponent < -10 ) { return static_cast<kvs::UInt16>( sign ); }
+        mantissa |= 0x00800000;
+        const kvs::UInt32 shift = static_cast<kvs::UInt32>( 14 - exponent );
+        const kvs::UInt32 rest = mantissa & ( ( 1u << shift ) - 1 );
+        const kvs::UInt32 halfway = 1u << ( shift - 1 );
+        kvs::UInt32 half = mantissa >> shift;
+        if ( rest > halfway || ( rest == halfway && ( half & 1 ) ) ) { half++; }
+        return static_cast<kvs::UInt16>( sign | half );
+    }
+
+    // Normal (a carry of the rounding moves up to the exponent bits).
+    kvs::UInt32 half = ( static_cast<kvs::UInt32>( exponent ) << 10 ) | ( mantissa >> 13 );
+    const kvs::UInt32 rest = mantissa & 0x1fff;
+    if ( rest > 0x1000 || ( rest == 0x1000 && ( half & 1 ) ) ) { half++; }
+    return static_cast<kvs::UInt16>( sign | half );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns single-precision floating point value.
+ *  @param  value [in] half-precision floating point value
+ *  @return single-precision value
+ */
+/*===========================================================================*/
+kvs::Real32 HalfToFloat( const kvs::UInt16 value )
+{
+    const kvs::UInt32 sign = static_cast<kvs::UInt32>( value & 0x8000 ) << 16;
+    kvs::Int32 exponent = ( value >> 10 ) & 0x1f;
+    kvs::UInt32 mantissa = value & 0x03ff;
+
+    kvs::UInt32 f = 0;
+    if ( exponent == 0x1f )
+    {
+        f = sign | 0x7f800000 | ( mantissa << 13 );
+    }
+    else if ( exponent == 0 )
+    {
+        if ( mantissa == 0 ) { f = sign; }
+        else
+        {
+            // Normalize the subnormal value.
+            exponent = 1;
+            while ( !( mantissa & 0x0400 ) ) { mantissa <<= 1; exponent--; }
+            mantissa &= 0x03ff;
+            f = sign | ( static_cast<kvs::UInt32>( exponent + 127 - 15 ) << 23 ) | ( mantissa << 13 );
+        }
+    }
+    else
+    {
+        f = sign | ( static_cast<kvs::UInt32>( exponent + 127 - 15 ) << 23 ) | ( mantissa << 13 );
+    }
+
+    kvs::Real32 result = 0.0f;
+    std::memcpy( &result, &f, sizeof( result ) );
+    return result;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Converts values to the normalized texels.
+ *  @param  src [in] pointer to the values
+ *  @param  nvalues [in] number of values
+ *  @param  min_value [in] value mapped to 0
+ *  @param  max_value [in] value mapped to 1
+ *  @param  format [in] texture format
+ *  @param  dst [out] pointer to the texels
+ *  @return max. quantization error in the normalized range
  */
 /*===========================================================================*/
 template <typename T>
-kvs::AnyValueArray NormalizeValues(
-    const kvs::StructuredVolumeObject* volume,
+kvs::Real32 NormalizeValues(
+    const T* src,
+    const size_t nvalues,
     const kvs::Real32 min_value,
-    const kvs::Real32 max_value )
+    const kvs::Real32 max_value,
+    const kvs::glsl::RayCastingRenderer::TextureFormat format,
+    void* dst )
 {
     const kvs::Real32 scale = 1.0f / ( max_value - min_value );
-    const size_t nnodes = volume->numberOfNodes();
-    const T* src = static_cast<const T*>( volume->values().data() );
-
-    kvs::ValueArray<kvs::Real32> data( nnodes );
-    kvs::Real32* dst = data.data();
-    for ( size_t i = 0; i < nnodes; i++ )
+    kvs::Real32 error = 0.0f;
+    switch ( format )
+    {
+    case kvs::glsl::RayCastingRenderer::UInt16Texture:
+    {
+        kvs::UInt16* texel = static_cast<kvs::UInt16*>( dst );
+        for ( size_t i = 0; i < nvalues; i++ )
+        {
+            kvs::Real32 t = static_cast<kvs::Real32>( ( src[i] - min_value ) * scale );
+            t = kvs::Math::Min( kvs::Math::Max( t, 0.0f ), 1.0f );
+            const kvs::UInt16 q = static_cast<kvs::UInt16>( t * 65535.0f + 0.5f );
+            error = kvs::Math::Max( error, kvs::Math::Abs( t - q / 65535.0f ) );
+            texel[i] = q;
+        }
+        break;
+    }
+    case kvs::glsl::RayCastingRenderer::HalfFloatTexture:
     {
-        *(dst++) = static_cast<kvs::Real32>(( *(src++) - min_value ) * scale);
+        kvs::UInt16* texel = static_cast<kvs::UInt16*>( dst );
+        for ( size_t i = 0; i < nvalues; i++ )
+        {
+            const kvs::Real32 t = static_cast<kvs::Real32>( ( src[i] - min_value ) * scale );
+            const kvs::UInt16 h = ::FloatToHalf( t );
+            error = kvs::Math::Max( error, kvs::Math::Abs( t - ::HalfToFloat( h ) ) );
+            texel[i] = h;
+        }
+        break;
+    }
+    default:
+    {
+        kvs::Real32* texel = static_cast<kvs::Real32*>( dst );
+        for ( size_t i = 0; i < nvalues; i++ )
+        {
+            texel[i] = static_cast<kvs::Real32>( ( src[i] - min_value ) * scale );
+        }
+        break;
+    }
     }
 
-    return kvs::AnyValueArray( data );
+    return error;
 }
 
 /*===========================================================================*/
 /**
- *  @brief  Returns unsigned value array converted from signed value array.
- *  @param  volume [in] pointer to the volume object
- *  @return unsigned value array
+ *  @brief  Converts a part of the value array to the normalized texels.
+ *  @param  values [in] value array
+ *  @param  offset [in] index of the first value
+ *  @param  nvalues [in] number of values
+ *  @param  min_value [in] value mapped to 0
+ *  @param  max_value [in] value mapped to 1
+ *  @param  format [in] texture format
+ *  @param  dst [out] pointer to the texels
+ *  @return max. quantization error in the normalized range
  */
 /*===========================================================================*/
-template <typename DstType, typename SrcType>
-kvs::AnyValueArray SignedToUnsigned( const kvs::StructuredVolumeObject* volume )
+kvs::Real32 NormalizeValues(
+    const kvs::AnyValueArray& values,
+    const size_t offset,
+    const size_t nvalues,
+    const kvs::Real32 min_value,
+    const kvs::Real32 max_value,
+    const kvs::glsl::RayCastingRenderer::TextureFormat format,
+    void* dst )
 {
-    const SrcType min = kvs::Value<SrcType>::Min();
-    const size_t nvalues = volume->values().size();
-    const SrcType* src = static_cast<const SrcType*>( volume->values().data() );
-
-    kvs::ValueArray<DstType> data( nvalues );
-    DstType* dst = data.data();
-    for ( size_t i = 0; i < nvalues; i++ )
+    const std::type_info& type = values.typeInfo()->type();
+    if ( type == typeid( kvs::UInt32 ) )
     {
-        *(dst++) = static_cast<DstType>( *(src++) - min );
+        const kvs::UInt32* src = static_cast<const kvs::UInt32*>( values.data() ) + offset;
+        return ::NormalizeValues( src, nvalues, min_value, max_value, format, dst );
+    }
+    else if ( type == typeid( kvs::Int32 ) )
+    {
+        const kvs::Int32* src = static_cast<const kvs::Int32*>( values.data() ) + offset;
+        return ::NormalizeValues( src, nvalues, min_value, max_value, format, dst );
+    }
+    else if ( type == typeid( kvs::Real32 ) )
+    {
+        const kvs::Real32* src = static_cast<const kvs::Real32*>( values.data() ) + offset;
+        return ::NormalizeValues( src, nvalues, min_value, max_value, format, dst );
+    }
+    else if ( type == typeid( kvs::Real64 ) )
+    {
+        const kvs::Real64* src = static_cast<const kvs::Real64*>( values.data() ) + offset;
+        return ::NormalizeValues( src, nvalues, min_value, max_value, format, dst );
     }
 
-    return kvs::AnyValueArray( data );
+    return 0.0f;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Copies a part of the 8/16-bit integer value array to the texels.
+ *  @param  values [in] value array
+ *  @param  offset [in] index of the first value
+ *  @param  nvalues [in] number of values
+ *  @param  dst [out] pointer to the texels
+ *
+ *  Signed values are shifted into the unsigned range of the same width.
+ */
+/*===========================================================================*/
+void CopyValues(
+    const kvs::AnyValueArray& values,
+    const size_t offset,
+    const size_t nvalues,
+    void* dst )
+{
+    const std::type_info& type = values.typeInfo()->type();
+    if ( type == typeid( kvs::Int8 ) )
+    {
+        const kvs::Int8* src = static_cast<const kvs::Int8*>( values.data() ) + offset;
+        kvs::UInt8* texel = static_cast<kvs::UInt8*>( dst );
+        for ( size_t i = 0; i < nvalues; i++ )
+        {
+            texel[i] = static_cast<kvs::UInt8>( src[i] + 128 );
+        }
+    }
+    else if ( type == typeid( kvs::Int16 ) )
+    {
+        const kvs::Int16* src = static_cast<const kvs::Int16*>( values.data() ) + offset;
+        kvs::UInt16* texel = static_cast<kvs::UInt16*>( dst );
+        for ( size_t i = 0; i < nvalues; i++ )
+        {
+            texel[i] = static_cast<kvs::UInt16>( src[i] + 32768 );
+        }
+    }
+    else
+    {
+        const size_t size = values.byteSize() / values.size();
+        const kvs::UInt8* src = static_cast<const kvs::UInt8*>( values.data() ) + offset * size;
+        std::memcpy( dst, src, nvalues * size );
+    }
 }
 
 } // end of namespace
@@ -96,7 +286,10 @@ RayCastingRenderer::RayCastingRenderer():
     m_draw_volume( true ),
     m_enable_jittering( false ),
     m_step( 0.5f ),
-    m_opaque( 1.0f )
+    m_opaque( 1.0f ),
+    m_texture_format( FloatTexture ),
+    m_brick_depth( 0 ),
+    m_quantization_error( 0.0f )
 {
     BaseClass::setShader( kvs::Shader::Lambert() );
 }
@@ -113,7 +306,10 @@ RayCastingRenderer::RayCastingRenderer( const kvs::TransferFunction& tfunc ):
     m_draw_volume( true ),
     m_enable_jittering( false ),
     m_step( 0.5f ),
-    m_opaque( 1.0f )
+    m_opaque( 1.0f ),
+    m_texture_format( FloatTexture ),
+    m_brick_depth( 0 ),
+    m_quantization_error( 0.0f )
 {
     BaseClass::setTransferFunction( tfunc );
     BaseClass::setShader( kvs::Shader::Lambert() );
@@ -132,7 +328,10 @@ RayCastingRenderer::RayCastingRenderer( const ShadingType shader ):
     m_draw_volume( true ),
     m_enable_jittering( false ),
     m_step( 0.5f ),
-    m_opaque( 1.0f )
+    m_opaque( 1.0f ),
+    m_texture_format( FloatTexture ),
+    m_brick_depth( 0 ),
+    m_quantization_error( 0.0f )
 {
     BaseClass::setShader( shader );
 }
@@ -558,95 +757,84 @@ void RayCastingRenderer::initialize_transfer_function_texture()
 void RayCastingRenderer::initialize_volume_texture( const kvs::StructuredVolumeObject* volume )
 {
     m_volume_texture.release();
+    m_quantization_error = 0.0f;
 
     const size_t width = volume->resolution().x();
     const size_t height = volume->resolution().y();
     const size_t depth = volume->resolution().z();
 
+    // 8/16-bit integer data are stored in the texture at their native width
+    // (signed values are shifted into the unsigned range). The other data are
+    // normalized into [0,1] and stored in the specified texture format.
     GLenum data_format = 0;
     GLenum data_type = 0;
-    kvs::AnyValueArray data_value;
+    size_t texel_size = 0;
+    bool is_native = true;
+    bool is_signed = false;
+    kvs::Real32 min_value = 0.0f;
+    kvs::Real32 max_value = 1.0f;
     const std::type_info& type = volume->values().typeInfo()->type();
     if ( type == typeid( kvs::UInt8 ) )
     {
         data_format = GL_ALPHA8;
         data_type = GL_UNSIGNED_BYTE;
-        data_value = volume->values();
+        texel_size = sizeof( kvs::UInt8 );
     }
     else if ( type == typeid( kvs::UInt16 ) )
     {
         data_format = GL_ALPHA16;
         data_type = GL_UNSIGNED_SHORT;
-        data_value = volume->values();
+        texel_size = sizeof( kvs::UInt16 );
     }
     else if ( type == typeid( kvs::Int8 ) )
     {
         data_format = GL_ALPHA8;
         data_type = GL_UNSIGNED_BYTE;
-        data_value = ::SignedToUnsigned<kvs::UInt8,kvs::Int8>( volume );
+        texel_size = sizeof( kvs::Int8 );
+        is_signed = true;
     }
     else if ( type == typeid( kvs::Int16 ) )
     {
         data_format = GL_ALPHA16;
         data_type = GL_UNSIGNED_SHORT;
-        data_value = ::SignedToUnsigned<kvs::UInt16,kvs::Int16>( volume );
-    }
-    else if ( type == typeid( kvs::UInt32 ) )
-    {
-        data_format = GL_ALPHA;
-        data_type = GL_FLOAT;
-        kvs::Real32 min_value = static_cast<kvs::Real32>( volume->minValue() );
-        kvs::Real32 max_value = static_cast<kvs::Real32>( volume->maxValue() );
-        if ( BaseClass::transferFunction().hasRange() )
-        {
-            min_value = BaseClass::transferFunction().colorMap().minValue();
-            max_value = BaseClass::transferFunction().colorMap().maxValue();
-        }
-        data_value = ::NormalizeValues<kvs::UInt32>( volume, min_value, max_value );
-    }
-    else if ( type == typeid( kvs::Int32 ) )
-    {
-        data_format = GL_ALPHA;
-        data_type = GL_FLOAT;
-        kvs::Real32 min_value = static_cast<kvs::Real32>( volume->minValue() );
-        kvs::Real32 max_value = static_cast<kvs::Real32>( volume->maxValue() );
-        if ( BaseClass::transferFunction().hasRange() )
-        {
-            min_value = BaseClass::transferFunction().colorMap().minValue();
-            max_value = BaseClass::transferFunction().colorMap().maxValue();
-        }
-        data_value = ::NormalizeValues<kvs::Int32>( volume, min_value, max_value );
+        texel_size = sizeof( kvs::Int16 );
+        is_signed = true;
     }
-    else if ( type == typeid( kvs::Real32 ) )
+    else if ( type == typeid( kvs::UInt32 ) || type == typeid( kvs::Int32 ) ||
+              type == typeid( kvs::Real32 ) || type == typeid( kvs::Real64 ) )
     {
-        data_format = GL_ALPHA;
-        data_type = GL_FLOAT;
-        kvs::Real32 min_value = static_cast<kvs::Real32>( volume->minValue() );
-        kvs::Real32 max_value = static_cast<kvs::Real32>( volume->maxValue() );
-        if ( BaseClass::transferFunction().hasRange() )
+        switch ( m_texture_format )
         {
-            min_value = BaseClass::transferFunction().colorMap().minValue();
-            max_value = BaseClass::transferFunction().colorMap().maxValue();
+        case UInt16Texture:
+            data_format = GL_ALPHA16;
+            data_type = GL_UNSIGNED_SHORT;
+            texel_size = sizeof( kvs::UInt16 );
+            break;
+        case HalfFloatTexture:
+            data_format = GL_ALPHA16F_ARB;
+            data_type = GL_HALF_FLOAT_ARB;
+            texel_size = sizeof( kvs::UInt16 );
+            break;
+        default:
+            data_format = GL_ALPHA32F_ARB;
+            data_type = GL_FLOAT;
+            texel_size = sizeof( kvs::Real32 );
+            break;
         }
-        data_value = ::NormalizeValues<kvs::Real32>( volume, min_value, max_value );
-    }
-    else if ( type == typeid( kvs::Real64 ) )
-    {
-        data_format = GL_ALPHA;
-        data_type = GL_FLOAT;
-        kvs::Real32 min_value = static_cast<kvs::Real32>( volume->minValue() );
-        kvs::Real32 max_value = static_cast<kvs::Real32>( volume->maxValue() );
+        is_native = false;
+        min_value = static_cast<kvs::Real32>( volume->minValue() );
+        max_value = static_cast<kvs::Real32>( volume->maxValue() );
         if ( BaseClass::transferFunction().hasRange() )
         {
             min_value = BaseClass::transferFunction().colorMap().minValue();
             max_value = BaseClass::transferFunction().colorMap().maxValue();
         }
-        data_value = ::NormalizeValues<kvs::Real64>( volume, min_value, max_value );
     }
     else
     {
         kvsMessageError( "Not supported data type '%s'.",
                          volume->values().typeInfo()->typeName() );
+        return;
     }
 
     m_volume_texture.setPixelFormat( data_format, GL_ALPHA, data_type );
@@ -655,7 +843,68 @@ void RayCastingRenderer::initialize_volume_texture( const kvs::StructuredVolumeO
     m_volume_texture.setWrapR( GL_CLAMP_TO_BORDER );
     m_volume_texture.setMagFilter( GL_LINEAR );
     m_volume_texture.setMinFilter( GL_LINEAR );
-    m_volume_texture.create( width, height, depth, data_value.data() );
+
+    kvs::Real32 error = 0.0f;
+    const kvs::AnyValueArray& values = volume->values();
+    if ( m_brick_depth == 0 )
+    {
+        if ( is_native && !is_signed )
+        {
+            m_volume_texture.create( width, height, depth, values.data() );
+        }
+        else
+        {
+            const size_t nvalues = width * height * depth;
+            kvs::ValueArray<kvs::UInt8> data( nvalues * texel_size );
+            if ( is_native ) { ::CopyValues( values, 0, nvalues, data.data() ); }
+            else { error = ::NormalizeValues( values, 0, nvalues, min_value, max_value, m_texture_format, data.data() ); }
+            m_volume_texture.create( width, height, depth, data.data() );
+        }
+    }
+    else
+    {
+        // The texture is allocated first, and then the bricks of the slices
+        // are converted into the mapped pixel unpack buffer and streamed to
+        // the texture, so that no converted copy of the whole volume is needed.
+        m_volume_texture.create( width, height, depth );
+
+        const size_t brick_depth = kvs::Math::Min( m_brick_depth, depth );
+        const size_t slice_size = width * height;
+        kvs::PixelUnpackBufferObject buffer;
+        buffer.setUsage( GL_STREAM_DRAW );
+        buffer.create( slice_size * brick_depth * texel_size );
+
+        kvs::Texture::GuardedBinder binder1( m_volume_texture );
+        kvs::BufferObject::GuardedBinder binder2( buffer );
+        for ( size_t z = 0; z < depth; z += brick_depth )
+        {
+            const size_t nslices = kvs::Math::Min( brick_depth, depth - z );
+            const size_t offset = z * slice_size;
+            const size_t nvalues = nslices * slice_size;
+
+            void* data = buffer.map( kvs::BufferObject::WriteOnly );
+            if ( !data )
+            {
+                kvsMessageError( "Cannot map the pixel unpack buffer." );
+                break;
+            }
+
+            if ( is_native )
+            {
+                ::CopyValues( values, offset, nvalues, data );
+            }
+            else
+            {
+                const kvs::Real32 e = ::NormalizeValues( values, offset, nvalues, min_value, max_value, m_texture_format, data );
+                error = kvs::Math::Max( error, e );
+            }
+            buffer.unmap();
+
+            m_volume_texture.load( width, height, nslices, NULL, 0, 0, z );
+        }
+    }
+
+    m_quantization_error = error * ( max_value - min_value );
 }
 
 /*===========================================================================*/
@@ -55,6 +55,13 @@ public:
         Volume
     };
 
+    enum TextureFormat
+    {
+        FloatTexture, ///< 32-bit floating point texture
+        UInt16Texture, ///< 16-bit normalized integer texture
+        HalfFloatTexture ///< 16-bit floating point texture
+    };
+
 private:
 
     bool m_draw_front_face; ///< frag for drawing front face
@@ -63,6 +70,9 @@ private:
     bool m_enable_jittering; ///< frag for stochastic jittering
     float m_step; ///< sampling step
     float m_opaque; ///< opaque value for early ray termination
+    TextureFormat m_texture_format; ///< texture format for 32/64-bit data
+    size_t m_brick_depth; ///< number of slices per brick for streaming (0: disabled)
+    kvs::Real32 m_quantization_error; ///< max. quantization error of the volume texture
     kvs::Texture1D m_transfer_function_texture; ///< transfer function texture
     kvs::Texture2D m_jittering_texture; ///< texture for stochastic jittering
     kvs::Texture2D m_entry_texture; ///< entry point texture
@@ -89,6 +99,12 @@ public:
     void setOpaqueValue( const float opaque ) { m_opaque = opaque; }
     void enableJittering() { m_enable_jittering = true; }
     void disableJittering() { m_enable_jittering = false; }
+    void setTextureFormat( const TextureFormat format ) { m_texture_format = format; }
+    void enableBrickedStreaming( const size_t nslices = 16 ) { m_brick_depth = nslices; }
+    void disableBrickedStreaming() { m_brick_depth = 0; }
+    TextureFormat textureFormat() const { return m_texture_format; }
+    bool isEnabledBrickedStreaming() const { return m_brick_depth > 0; }
+    kvs::Real32 quantizationError() const { return m_quantization_error; }
 
 private:
 
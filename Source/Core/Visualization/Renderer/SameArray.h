@@ -0,0 +1,45 @@
+/*****************************************************************************/
+/**
+ *  @file   SameArray.h
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#ifndef KVS__SAME_ARRAY_H_INCLUDE
+#define KVS__SAME_ARRAY_H_INCLUDE
+
+#include <kvs/ValueArray>
+
+
+namespace
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns true if the two arrays refer to the same memory block.
+ *  @param  a [in] array a
+ *  @param  b [in] array b
+ *  @return true, if the arrays are the same
+ *
+ *  The renderers keep shallow copies of the arrays stored in the buffer
+ *  objects, so that the memory blocks cannot be reused for other arrays
+ *  while they are compared. Only the memory blocks are compared; the values
+ *  changed in place in the same block are not detected, and the buffer
+ *  objects must be re-created explicitly for them.
+ */
+/*===========================================================================*/
+template <typename T>
+bool IsSameArray( const kvs::ValueArray<T>& a, const kvs::ValueArray<T>& b )
+{
+    return a.data() == b.data() && a.size() == b.size();
+}
+
+} // end of namespace
+
+#endif // KVS__SAME_ARRAY_H_INCLUDE
@@ -0,0 +1,411 @@
+/*****************************************************************************/
+/**
+ *  @file   ScatterPlotMatrixDensityMap.cpp
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#include "ScatterPlotMatrixDensityMap.h"
+#include <cmath>
+#include <kvs/Math>
+#include <kvs/Assert>
+
+
+namespace
+{
+
+const size_t BlockSize = 16384; // number of rows counted at once for all the pairs
+
+/*===========================================================================*/
+/**
+ *  @brief  Task that counts the rows into the histograms of the pairs.
+ */
+/*===========================================================================*/
+class CountTask : public kvs::BinnedTable::Task
+{
+private:
+
+    const std::vector<kvs::BinnedTable::Bins>* m_bins; ///< bin indices for each column
+    const kvs::TableObject::InsideRangeFlags* m_flags; ///< inside range flags
+    bool m_incremental; ///< if true, the rows are added (flag = 1) or removed (flag = 0)
+    size_t m_nbins; ///< number of bins
+    std::vector<kvs::ScatterPlotMatrixDensityMap::Histogram>* m_histograms; ///< histograms for each pair
+
+public:
+
+    CountTask(
+        const std::vector<kvs::BinnedTable::Bins>* bins,
+        const kvs::TableObject::InsideRangeFlags* flags,
+        const bool incremental,
+        const size_t nbins,
+        std::vector<kvs::ScatterPlotMatrixDensityMap::Histogram>* histograms ):
+        m_bins( bins ),
+        m_flags( flags ),
+        m_incremental( incremental ),
+        m_nbins( nbins ),
+        m_histograms( histograms ) {}
+
+    void run( const size_t thread_index, const size_t nthreads )
+    {
+        // Each thread counts the pairs (i,j) assigned in the row-major order
+        // of the upper triangle.
+        std::vector<size_t> pairs;
+        const size_t ncolumns = m_bins->size();
+        for ( size_t i = 0, p = 0; i < ncolumns; i++ )
+        {
+            for ( size_t j = i + 1; j < ncolumns; j++, p++ )
+            {
+                if ( p % nthreads != thread_index ) continue;
+                pairs.push_back( p );
+                pairs.push_back( i );
+                pairs.push_back( j );
+            }
+        }
+        if ( pairs.empty() ) return;
+
+        if ( !m_incremental )
+        {
+            for ( size_t k = 0; k < pairs.size(); k += 3 ) (*m_histograms)[ pairs[k] ].fill( 0 );
+        }
+
+        // The rows are counted block by block so that the bins of the block
+        // stay in the cache while all the pairs are counted.
+        const kvs::UInt8* flags = &(*m_flags)[0];
+        const size_t nrows = m_flags->size();
+        std::vector<kvs::UInt32> rows( ::BlockSize );
+        for ( size_t begin = 0; begin < nrows; begin += ::BlockSize )
+        {
+            const size_t end = kvs::Math::Min( begin + ::BlockSize, nrows );
+            size_t nrows_inside = 0;
+            for ( size_t r = begin; r < end; r++ )
+            {
+                if ( flags[r] ) rows[ nrows_inside++ ] = static_cast<kvs::UInt32>( r - begin );
+            }
+            for ( size_t k = 0; nrows_inside > 0 && k < pairs.size(); k += 3 )
+            {
+                const kvs::UInt8* a = (*m_bins)[ pairs[k+1] ].data() + begin;
+                const kvs::UInt8* b = (*m_bins)[ pairs[k+2] ].data() + begin;
+                kvs::UInt32* histogram = (*m_histograms)[ pairs[k] ].data();
+                for ( size_t r = 0; r < nrows_inside; r++ )
+                {
+                    const size_t row = rows[r];
+                    histogram[ a[row] * m_nbins + b[row] ]++;
+                }
+            }
+            if ( !m_incremental ) continue;
+
+            // The rows whose flags are 0 are removed.
+            size_t nrows_outside = 0;
+            for ( size_t r = begin; r < end; r++ )
+            {
+                if ( !flags[r] ) rows[ nrows_outside++ ] = static_cast<kvs::UInt32>( r - begin );
+            }
+            for ( size_t k = 0; k < pairs.size(); k += 3 )
+            {
+                const kvs::UInt8* a = (*m_bins)[ pairs[k+1] ].data() + begin;
+                const kvs::UInt8* b = (*m_bins)[ pairs[k+2] ].data() + begin;
+                kvs::UInt32* histogram = (*m_histograms)[ pairs[k] ].data();
+                for ( size_t r = 0; r < nrows_outside; r++ )
+                {
+                    const size_t row = rows[r];
+                    histogram[ a[row] * m_nbins + b[row] ]--;
+                }
+            }
+        }
+    }
+};
+
+/*===========================================================================*/
+/**
+ *  @brief  Task that colors the histograms of the pairs.
+ */
+/*===========================================================================*/
+class ColorTask : public kvs::BinnedTable::Task
+{
+private:
+
+    const kvs::ScatterPlotMatrixDensityMap* m_map; ///< density map
+    const kvs::ColorMap* m_color_map; ///< color map
+    kvs::UInt8 m_opacity; ///< opacity
+    std::vector< kvs::ValueArray<kvs::UInt8> >* m_images; ///< images for each panel
+
+public:
+
+    ColorTask(
+        const kvs::ScatterPlotMatrixDensityMap* map,
+        const kvs::ColorMap* color_map,
+        const kvs::UInt8 opacity,
+        std::vector< kvs::ValueArray<kvs::UInt8> >* images ):
+        m_map( map ),
+        m_color_map( color_map ),
+        m_opacity( opacity ),
+        m_images( images ) {}
+
+    void run( const size_t thread_index, const size_t nthreads )
+    {
+        // The panel (j,i) is the transposed image of the panel (i,j).
+        const size_t ncolumns = m_map->numberOfColumns();
+        const size_t r = m_map->resolution();
+        for ( size_t i = 0, p = 0; i < ncolumns; i++ )
+        {
+            for ( size_t j = i + 1; j < ncolumns; j++, p++ )
+            {
+                if ( p % nthreads != thread_index ) continue;
+
+                const kvs::ValueArray<kvs::UInt8> image = m_map->colorData( i, j, *m_color_map, m_opacity );
+                kvs::ValueArray<kvs::UInt8> transposed( image.size() );
+                const kvs::UInt32* src = reinterpret_cast<const kvs::UInt32*>( image.data() );
+                kvs::UInt32* dst = reinterpret_cast<kvs::UInt32*>( transposed.data() );
+                for ( size_t y = 0; y < r; y++ )
+                {
+                    for ( size_t x = 0; x < r; x++ ) dst[ x * r + y ] = src[ y * r + x ];
+                }
+
+                (*m_images)[ i * ncolumns + j ] = image;
+                (*m_images)[ j * ncolumns + i ] = transposed;
+            }
+        }
+    }
+};
+
+} // end of namespace
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new ScatterPlotMatrixDensityMap class.
+ */
+/*===========================================================================*/
+ScatterPlotMatrixDensityMap::ScatterPlotMatrixDensityMap():
+    m_table( 64 )
+{
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the index of the histogram for the panel.
+ *  @param  x_index [in] column index of the horizontal axis
+ *  @param  y_index [in] column index of the vertical axis
+ *  @return pair index
+ */
+/*===========================================================================*/
+size_t ScatterPlotMatrixDensityMap::pairIndex( const size_t x_index, const size_t y_index ) const
+{
+    KVS_ASSERT( x_index != y_index );
+    const size_t i = kvs::Math::Min( x_index, y_index );
+    const size_t j = kvs::Math::Max( x_index, y_index );
+    const size_t n = m_table.numberOfColumns();
+    return i * ( 2 * n - i - 1 ) / 2 + ( j - i - 1 );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sets the number of bins on each axis.
+ *  @param  resolution [in] number of bins (2 - 256)
+ *
+ *  The histograms need (number of pairs) x resolution^2 x 4 bytes.
+ */
+/*===========================================================================*/
+void ScatterPlotMatrixDensityMap::setResolution( const size_t resolution )
+{
+    const size_t old_resolution = m_table.resolution();
+    m_table.setResolution( resolution );
+    if ( m_table.resolution() != old_resolution ) this->release();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Updates the histograms with the table object.
+ *  @param  table [in] pointer to the table object
+ *  @return true if the histograms are changed
+ *
+ *  Only the rows whose inside range flags are changed since the last update
+ *  are added to or removed from the histograms, unless the bins are changed
+ *  or many rows are changed (see kvs::BinnedTable::update).
+ */
+/*===========================================================================*/
+bool ScatterPlotMatrixDensityMap::update( const kvs::TableObject* table )
+{
+    switch ( m_table.update( table ) )
+    {
+    case kvs::BinnedTable::Rebinned:
+    {
+        const size_t ncolumns = m_table.numberOfColumns();
+        const size_t size = m_table.resolution() * m_table.resolution();
+        m_histograms.resize( ncolumns * ( ncolumns - 1 ) / 2 );
+        for ( size_t i = 0; i < m_histograms.size(); i++ ) m_histograms[i].allocate( size );
+        this->count();
+        return true;
+    }
+    case kvs::BinnedTable::AllRowsChanged:
+        this->count();
+        return true;
+    case kvs::BinnedTable::RowsChanged:
+        this->count( m_table.changedRows() );
+        return true;
+    case kvs::BinnedTable::Unchanged:
+        return false;
+    default:
+        this->release();
+        return false;
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the number of rows in the bin of the panel.
+ *  @param  x_index [in] column index of the horizontal axis
+ *  @param  y_index [in] column index of the vertical axis
+ *  @param  x_bin [in] bin index on the horizontal axis
+ *  @param  y_bin [in] bin index on the vertical axis
+ *  @return number of rows
+ */
+/*===========================================================================*/
+kvs::UInt32 ScatterPlotMatrixDensityMap::count(
+    const size_t x_index,
+    const size_t y_index,
+    const size_t x_bin,
+    const size_t y_bin ) const
+{
+    const Histogram& histogram = m_histograms[ this->pairIndex( x_index, y_index ) ];
+    return x_index < y_index ?
+        histogram[ x_bin * m_table.resolution() + y_bin ] :
+        histogram[ y_bin * m_table.resolution() + x_bin ];
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the RGBA image of the panel colored by the color map.
+ *  @param  x_index [in] column index of the horizontal axis
+ *  @param  y_index [in] column index of the vertical axis
+ *  @param  color_map [in] color map
+ *  @param  opacity [in] opacity of the non-empty bins
+ *  @return RGBA pixels of resolution x resolution (the first row is the bottom)
+ *
+ *  The counts are normalized logarithmically to [0,1] by the max. count of
+ *  the panel, which is mapped to the whole range of the color map. The empty
+ *  bins are transparent.
+ */
+/*===========================================================================*/
+kvs::ValueArray<kvs::UInt8> ScatterPlotMatrixDensityMap::colorData(
+    const size_t x_index,
+    const size_t y_index,
+    const kvs::ColorMap& color_map,
+    const kvs::UInt8 opacity ) const
+{
+    const size_t r = m_table.resolution();
+    kvs::ValueArray<kvs::UInt8> pixels( r * r * 4 );
+    pixels.fill( 0 );
+
+    const Histogram& histogram = m_histograms[ this->pairIndex( x_index, y_index ) ];
+    kvs::UInt32 max_count = 0;
+    for ( size_t i = 0; i < histogram.size(); i++ ) max_count = kvs::Math::Max( max_count, histogram[i] );
+    if ( max_count == 0 ) return pixels;
+
+    kvs::ColorMap cmap( color_map );
+    cmap.setRange( 0.0f, 1.0f );
+    const float normalize = 1.0f / std::log( 1.0f + max_count );
+
+    // The histogram of the pair (i,j) is indexed by [bin_i][bin_j].
+    const size_t x_stride = x_index < y_index ? r : 1;
+    const size_t y_stride = x_index < y_index ? 1 : r;
+    kvs::UInt8* pixel = pixels.data();
+    for ( size_t y = 0; y < r; y++ )
+    {
+        for ( size_t x = 0; x < r; x++, pixel += 4 )
+        {
+            const kvs::UInt32 count = histogram[ x * x_stride + y * y_stride ];
+            if ( count == 0 ) continue;
+
+            const kvs::RGBColor color = cmap.at( std::log( 1.0f + count ) * normalize );
+            pixel[0] = color.r();
+            pixel[1] = color.g();
+            pixel[2] = color.b();
+            pixel[3] = opacity;
+        }
+    }
+
+    return pixels;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the RGBA images of all the panels colored in parallel.
+ *  @param  color_map [in] color map
+ *  @param  opacity [in] opacity of the non-empty bins
+ *  @return images indexed by x_index * number of columns + y_index (empty for the diagonal panels)
+ */
+/*===========================================================================*/
+std::vector< kvs::ValueArray<kvs::UInt8> > ScatterPlotMatrixDensityMap::colorData(
+    const kvs::ColorMap& color_map,
+    const kvs::UInt8 opacity ) const
+{
+    const size_t ncolumns = m_table.numberOfColumns();
+    std::vector< kvs::ValueArray<kvs::UInt8> > images( ncolumns * ncolumns );
+
+    ::ColorTask task( this, &color_map, opacity, &images );
+    m_table.execute( &task, m_histograms.size() );
+
+    return images;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Releases the bins and histograms.
+ */
+/*===========================================================================*/
+void ScatterPlotMatrixDensityMap::release()
+{
+    m_table.release();
+    m_histograms.clear();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Counts all the rows inside the ranges into the histograms.
+ */
+/*===========================================================================*/
+void ScatterPlotMatrixDensityMap::count()
+{
+    ::CountTask task( &m_table.bins(), &m_table.flags(), false, m_table.resolution(), &m_histograms );
+    m_table.execute( &task, m_histograms.size() );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Adds or removes the rows whose inside range flags are changed.
+ *  @param  changed_rows [in] indices of the changed rows
+ */
+/*===========================================================================*/
+void ScatterPlotMatrixDensityMap::count( const std::vector<size_t>& changed_rows )
+{
+    // The bins of the changed rows are gathered into the compact columns, so
+    // that all the pairs are counted without the random access to the rows.
+    const kvs::TableObject::InsideRangeFlags& flags = m_table.flags();
+    const std::vector<kvs::BinnedTable::Bins>& bins = m_table.bins();
+    const size_t nrows = changed_rows.size();
+    const size_t ncolumns = bins.size();
+    kvs::TableObject::InsideRangeFlags changed_flags( nrows );
+    std::vector<kvs::BinnedTable::Bins> changed_bins( ncolumns );
+    for ( size_t i = 0; i < ncolumns; i++ ) changed_bins[i].allocate( nrows );
+    for ( size_t k = 0; k < nrows; k++ )
+    {
+        const size_t row = changed_rows[k];
+        changed_flags[k] = flags[ row ];
+        for ( size_t i = 0; i < ncolumns; i++ ) changed_bins[i][k] = bins[i][ row ];
+    }
+
+    ::CountTask task( &changed_bins, &changed_flags, true, m_table.resolution(), &m_histograms );
+    m_table.execute( &task, m_histograms.size() );
+}
+
+} // end of namespace kvs
@@ -0,0 +1,84 @@
+/*****************************************************************************/
+/**
+ *  @file   ScatterPlotMatrixDensityMap.h
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#ifndef KVS__SCATTER_PLOT_MATRIX_DENSITY_MAP_H_INCLUDE
+#define KVS__SCATTER_PLOT_MATRIX_DENSITY_MAP_H_INCLUDE
+
+#include <vector>
+#include <kvs/Type>
+#include <kvs/ValueArray>
+#include <kvs/ColorMap>
+#include <kvs/TableObject>
+#include <kvs/BinnedTable>
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Point density map of the scatter plot matrix.
+ *
+ *  The rows inside the ranges are counted with the bins of the binned table
+ *  into a 2D histogram for each pair of the columns. The histograms of all
+ *  the pairs are counted in one pass over the blocks of the rows by the
+ *  threads, each of which has its own pairs.
+ *
+ *  The histogram of the pair (i,j) (i < j) is stored for the panel whose
+ *  horizontal axis is the column i, and is transposed for the panel (j,i).
+ */
+/*===========================================================================*/
+class ScatterPlotMatrixDensityMap
+{
+public:
+
+    typedef kvs::ValueArray<kvs::UInt32> Histogram;
+
+private:
+
+    kvs::BinnedTable m_table; ///< bin indices and flags of the table
+    std::vector<Histogram> m_histograms; ///< 2D histograms for each pair of the columns
+
+public:
+
+    ScatterPlotMatrixDensityMap();
+
+    size_t resolution() const { return m_table.resolution(); }
+    size_t numberOfThreads() const { return m_table.numberOfThreads(); }
+    size_t numberOfColumns() const { return m_table.numberOfColumns(); }
+    size_t numberOfPairs() const { return m_histograms.size(); }
+    const Histogram& histogram( const size_t pair_index ) const { return m_histograms[ pair_index ]; }
+    size_t pairIndex( const size_t x_index, const size_t y_index ) const;
+
+    void setResolution( const size_t resolution );
+    void setNumberOfThreads( const size_t nthreads ) { m_table.setNumberOfThreads( nthreads ); }
+
+    bool update( const kvs::TableObject* table );
+    kvs::UInt32 count( const size_t x_index, const size_t y_index, const size_t x_bin, const size_t y_bin ) const;
+    kvs::ValueArray<kvs::UInt8> colorData(
+        const size_t x_index,
+        const size_t y_index,
+        const kvs::ColorMap& color_map,
+        const kvs::UInt8 opacity = 255 ) const;
+    std::vector< kvs::ValueArray<kvs::UInt8> > colorData( const kvs::ColorMap& color_map, const kvs::UInt8 opacity = 255 ) const;
+    void release();
+
+private:
+
+    void count();
+    void count( const std::vector<size_t>& changed_rows );
+};
+
+} // end of namespace kvs
+
+#endif // KVS__SCATTER_PLOT_MATRIX_DENSITY_MAP_H_INCLUDE
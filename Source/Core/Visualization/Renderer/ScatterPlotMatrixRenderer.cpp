@@ -65,11 +65,39 @@ ScatterPlotMatrixRenderer::ScatterPlotMatrixRenderer():
     m_active_axis( -1 ),
     m_point_opacity( 255 ),
     m_point_size( 1.0f ),
-    m_background_color( 0, 0, 0, 0.0f )
+    m_background_color( 0, 0, 0, 0.0f ),
+    m_enable_density_mode( false ),
+    m_has_density_images( false )
 {
     m_color_map.create();
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Enables density mode.
+ *  @param  resolution [in] number of bins on each axis (<= 256)
+ */
+/*===========================================================================*/
+void ScatterPlotMatrixRenderer::enableDensityMode( const size_t resolution )
+{
+    m_enable_density_mode = true;
+    m_has_density_images = false;
+    m_density_map.setResolution( resolution );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Disables density mode.
+ */
+/*===========================================================================*/
+void ScatterPlotMatrixRenderer::disableDensityMode()
+{
+    m_enable_density_mode = false;
+    m_has_density_images = false;
+    m_density_map.release();
+    m_density_images.clear();
+}
+
 /*===========================================================================*/
 /**
  *  @brief  Render scatter plot matrix.
@@ -93,7 +121,9 @@ void ScatterPlotMatrixRenderer::exec( kvs::ObjectBase* object, kvs::Camera* came
 
     ::BeginDraw();
 
-    if ( m_active_axis >= 0 )
+    if ( m_enable_density_mode ) this->update_density_images( table );
+
+    if ( !m_enable_density_mode && m_active_axis >= 0 )
     {
         const float color_axis_min_value = static_cast<float>( table->minValue( m_active_axis ) );
         const float color_axis_max_value = static_cast<float>( table->maxValue( m_active_axis ) );
@@ -138,6 +168,18 @@ void ScatterPlotMatrixRenderer::exec( kvs::ObjectBase* object, kvs::Camera* came
             const size_t y_index = ncolumns - i - 1;
             if ( x_index == y_index ) continue;
 
+            if ( m_enable_density_mode )
+            {
+                // The first row of the image is drawn at the min. value (bottom).
+                const size_t resolution = m_density_map.resolution();
+                const kvs::ValueArray<kvs::UInt8>& image = m_density_images[ x_index * ncolumns + y_index ];
+                if ( image.size() == 0 ) continue;
+                glPixelZoom( ( x1 - x0 ) / resolution, ( y1 - y0 ) / resolution );
+                glRasterPos2f( x0, y1 );
+                glDrawPixels( GLsizei( resolution ), GLsizei( resolution ), GL_RGBA, GL_UNSIGNED_BYTE, image.data() );
+                continue;
+            }
+
             // X and Y values.
             const kvs::AnyValueArray& x_values = table->column(x_index);
             const kvs::AnyValueArray& y_values = table->column(y_index);
@@ -201,4 +243,23 @@ void ScatterPlotMatrixRenderer::exec( kvs::ObjectBase* object, kvs::Camera* came
     BaseClass::stopTimer();
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Updates the density images of the panels.
+ *  @param  table [in] pointer to the table object
+ *
+ *  The histograms are updated incrementally when the ranges are changed, and
+ *  the images are colored again only when the histograms, the color map or
+ *  the opacity are changed.
+ */
+/*===========================================================================*/
+void ScatterPlotMatrixRenderer::update_density_images( const kvs::TableObject* table )
+{
+    const bool changed = m_density_map.update( table );
+    if ( !changed && m_has_density_images ) return;
+
+    m_density_images = m_density_map.colorData( m_color_map, m_point_opacity );
+    m_has_density_images = true;
+}
+
 } // end of namespace kvs
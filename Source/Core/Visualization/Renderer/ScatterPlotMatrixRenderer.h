@@ -20,6 +20,9 @@
 #include <kvs/RGBColor>
 #include <kvs/RGBAColor>
 #include <kvs/ColorMap>
+#include <kvs/ValueArray>
+#include <kvs/ScatterPlotMatrixDensityMap>
+#include <vector>
 
 
 namespace kvs
@@ -32,6 +35,12 @@ class Light;
 /*===========================================================================*/
 /**
  *  @brief  ScatterPlotMatrixRenderer class.
+ *
+ *  In the density mode, the points are not drawn one by one, but the 2D
+ *  histograms computed by kvs::ScatterPlotMatrixDensityMap are drawn as the
+ *  images colored by the color map, so that the rendering time of the large
+ *  tables is independent of the number of rows. The point color and the
+ *  active axis are not used in this mode.
  */
 /*===========================================================================*/
 class ScatterPlotMatrixRenderer : public kvs::RendererBase
@@ -52,6 +61,10 @@ protected:
     kvs::Real32 m_point_size; ///< point size
     kvs::ColorMap m_color_map; ///< color map
     kvs::RGBAColor m_background_color; ///< background color
+    bool m_enable_density_mode; ///< flag for the density mode
+    bool m_has_density_images; ///< flag for the density images up to date with the color map
+    kvs::ScatterPlotMatrixDensityMap m_density_map; ///< density map
+    std::vector< kvs::ValueArray<kvs::UInt8> > m_density_images; ///< RGBA density images for each panel
 
 public:
 
@@ -63,9 +76,9 @@ public:
     void setRightMargin( const int right_margin ) { m_right_margin = right_margin; }
     void setMargin( const int margin ) { m_margin = margin; }
     void setPointColor( const kvs::RGBColor point_color ) { m_active_axis = -1; m_point_color = point_color; }
-    void setPointOpacity( const kvs::UInt8 point_opacity ) { m_point_opacity = point_opacity; }
+    void setPointOpacity( const kvs::UInt8 point_opacity ) { m_point_opacity = point_opacity; m_has_density_images = false; }
     void setPointSize( const kvs::Real32 point_size ){ m_point_size = point_size; }
-    void setColorMap( const kvs::ColorMap& color_map ) { m_color_map = color_map;}
+    void setColorMap( const kvs::ColorMap& color_map ) { m_color_map = color_map; m_has_density_images = false; }
     void setBackgroundColor( const kvs::RGBAColor background_color ) { m_background_color = background_color; }
     void selectAxis( const int index ) { m_active_axis = index; }
 
@@ -79,8 +92,16 @@ public:
     kvs::Real32 pointSize() const { return m_point_size; }
     const kvs::ColorMap& colorMap() const { return m_color_map; }
     const kvs::RGBAColor& backgroundColor() const { return m_background_color; }
+    void enableDensityMode( const size_t resolution = 64 );
+    void disableDensityMode();
+    bool isEnabledDensityMode() const { return m_enable_density_mode; }
+    const kvs::ScatterPlotMatrixDensityMap& densityMap() const { return m_density_map; }
 
     void exec( kvs::ObjectBase* object, kvs::Camera* camera, kvs::Light* light );
+
+protected:
+
+    void update_density_images( const kvs::TableObject* table );
 };
 
 } // end of namespace kvs
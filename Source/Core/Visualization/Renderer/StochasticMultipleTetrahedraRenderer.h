@@ -96,8 +96,11 @@ public:
 
     void setTransferFunction( const kvs::TransferFunction& transfer_function, const size_t index )
     {
+        // The table is re-created only if the transfer function is edited.
+        float lower = 0.0f;
+        float upper = 0.0f;
+        if ( transfer_function.changedRange( m_transfer_function[index], &lower, &upper ) ) m_transfer_function_changed[index] = true;
         m_transfer_function[index] = transfer_function;
-        m_transfer_function_changed[index] = true;
     }
 
     void setExtraTexture( const kvs::Texture2D& extra_texture ) { m_extra_texture = extra_texture; }
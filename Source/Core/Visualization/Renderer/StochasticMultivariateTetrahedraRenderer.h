@@ -85,8 +85,11 @@ public:
     void hideComponent( const size_t index ) { m_show_component[index] = false; }
     void setTransferFunction( const kvs::TransferFunction& transfer_function, const size_t index )
     {
+        // The table is re-created only if the transfer function is edited.
+        float lower = 0.0f;
+        float upper = 0.0f;
+        if ( transfer_function.changedRange( m_transfer_function[index], &lower, &upper ) ) m_transfer_function_changed[index] = true;
         m_transfer_function[index] = transfer_function;
-        m_transfer_function_changed[index] = true;
     }
 
 private:
@@ -281,6 +281,14 @@ void StochasticPointRenderer::Engine::create_shader_program()
 /*===========================================================================*/
 void StochasticPointRenderer::Engine::create_buffer_object( const kvs::PointObject* point )
 {
+    kvs::PointObject expanded;
+    if ( point->isCompact() )
+    {
+        expanded.shallowCopy( *point );
+        expanded.expand();
+        point = &expanded;
+    }
+
     const size_t nvertices = point->numberOfVertices();
     kvs::ValueArray<kvs::UInt16> indices( nvertices * 2 );
     for ( size_t i = 0; i < nvertices; i++ )
@@ -35,6 +35,7 @@ StochasticRendererBase::StochasticRendererBase( kvs::StochasticRenderingEngine*
     m_coarse_level( 1 ),
     m_enable_lod( false ),
     m_enable_refinement( false ),
+    m_object_changed( false ),
     m_shader( new kvs::Shader::Lambert() ),
     m_engine( engine )
 {
@@ -92,9 +93,12 @@ void StochasticRendererBase::exec( kvs::ObjectBase* object, kvs::Camera* camera,
         m_engine->update( object, camera, light );
     }
 
-    const bool object_changed = m_engine->object() != object;
+    // The object may be changed in place, e.g. the particles regenerated by
+    // kvs::CellByCellMetropolisSampling::update for an edited transfer function.
+    const bool object_changed = m_object_changed || m_engine->object() != object;
     if ( object_changed )
     {
+        m_object_changed = false;
         m_ensemble_buffer.clear();
         m_engine->release();
         m_engine->setShader( &shader() );
@@ -104,6 +108,7 @@ void StochasticRendererBase::exec( kvs::ObjectBase* object, kvs::Camera* camera,
 
     // LOD control.
     size_t repetitions = m_repetition_level;
+    bool coarse_rendering = false;
     kvs::Vec3 light_position = light->position();
     kvs::Mat4 modelview = kvs::OpenGL::ModelViewMatrix();
     if ( m_light_position != light_position || m_modelview != modelview )
@@ -111,14 +116,21 @@ void StochasticRendererBase::exec( kvs::ObjectBase* object, kvs::Camera* camera,
         if ( m_enable_lod )
         {
             repetitions = m_coarse_level;
+            coarse_rendering = true;
         }
         m_light_position = light_position;
         m_modelview = modelview;
         m_ensemble_buffer.clear();
     }
 
+    // The ensembles rendered during the interaction may come from a coarser
+    // representation of the object, so the refinement restarts after it.
+    const bool refined = m_engine->isEnabledCoarseRendering() && !coarse_rendering;
+    if ( refined ) m_ensemble_buffer.clear();
+    m_engine->setEnabledCoarseRendering( coarse_rendering );
+
     // Setup engine.
-    const bool reset_count = !m_enable_refinement;
+    const bool reset_count = !m_enable_refinement || refined;
     if ( reset_count ) m_engine->resetRepetitions();
     m_engine->setup( object, camera, light );
 
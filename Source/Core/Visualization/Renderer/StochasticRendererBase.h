@@ -49,6 +49,7 @@ private:
     size_t m_coarse_level; ///< repetition level for the coarse rendering (LOD)
     bool m_enable_lod; ///< flag for LOD rendering
     bool m_enable_refinement; ///< flag for progressive refinement rendering
+    bool m_object_changed; ///< flag for the object changed in place
     kvs::Mat4 m_modelview; ///< modelview matrix used for LOD control
     kvs::Vec3 m_light_position; ///< light position used for LOD control
     kvs::EnsembleAverageBuffer m_ensemble_buffer; ///< ensemble averaging buffer
@@ -73,6 +74,7 @@ public:
     void enableRefinement() { this->setEnabledRefinement( true ); }
     void disableLODControl() { this->setEnabledLODControl( false ); }
     void disableRefinement() { this->setEnabledRefinement( false ); }
+    void setObjectChanged() { m_object_changed = true; }
     const kvs::Shader::ShadingModel& shader() const { return *m_shader; }
     const kvs::StochasticRenderingEngine& engine() const { return *m_engine; }
     template <typename ShadingType>
@@ -29,6 +29,7 @@ StochasticRenderingEngine::StochasticRenderingEngine():
     m_object( NULL ),
     m_shader( NULL ),
     m_enable_shading( true ),
+    m_enable_coarse_rendering( false ),
     m_repetition_level( 1 ),
     m_repetition_count( 0 ),
     m_random_texture_size( 512 )
@@ -42,6 +42,7 @@ private:
     const kvs::ObjectBase* m_object; ///< pointer to the object
     const kvs::Shader::ShadingModel* m_shader; ///< pointer to the shader
     bool m_enable_shading; ///< shading flag
+    bool m_enable_coarse_rendering; ///< coarse rendering flag (set during the interaction with LOD control)
     size_t m_repetition_level; ///< repetition level
     size_t m_repetition_count; ///< repetition count
     size_t m_random_texture_size; ///< size of the random texture
@@ -55,10 +56,12 @@ public:
 
     void setShader( const kvs::Shader::ShadingModel* shader ) { m_shader = shader; }
     void setEnabledShading( const bool enable ) { m_enable_shading = enable; }
+    void setEnabledCoarseRendering( const bool enable ) { m_enable_coarse_rendering = enable; }
     void setRepetitionLevel( const size_t repetition_level ) { m_repetition_level = repetition_level; }
     void setRandomTextureSize( const size_t size ) { m_random_texture_size = size; }
     void setDepthTexture( const kvs::Texture2D& depth_texture ) { m_depth_texture = depth_texture; }
     bool isEnabledShading() const { return m_enable_shading; }
+    bool isEnabledCoarseRendering() const { return m_enable_coarse_rendering; }
     size_t repetitionLevel() const { return m_repetition_level; }
     size_t repetitionCount() const { return m_repetition_count; }
     size_t randomTextureSize() const { return m_random_texture_size; }
@@ -24,7 +24,6 @@
 #include <kvs/Xorshift128>
 #include <kvs/TetrahedralCell>
 #include <kvs/ProjectedTetrahedraTable>
-#include <kvs/PreIntegrationTable3D>
 
 
 namespace
@@ -500,11 +499,19 @@ void StochasticTetrahedraRenderer::Engine::create_preintegration_texture()
     const float max_size_of_cell = 1.0f;
     const size_t dim_scalar = 128;
     const size_t dim_depth = 128;
-    kvs::PreIntegrationTable3D table;
-    table.setScalarResolution( dim_scalar );
-    table.setDepthResolution( dim_depth );
-    table.setTransferFunction( m_transfer_function, 0.0f, 1.0f );
-    table.create( max_size_of_cell );
+    kvs::PreIntegrationTable3D& table = m_preintegration_table;
+    if ( table.table().size() == 0 )
+    {
+        table.setScalarResolution( dim_scalar );
+        table.setDepthResolution( dim_depth );
+        table.setTransferFunction( m_transfer_function, 0.0f, 1.0f );
+        table.create( max_size_of_cell );
+    }
+    else
+    {
+        // Only the entries affected by the edited part are re-computed.
+        table.update( m_transfer_function, 0.0f, 1.0f );
+    }
 
     m_preintegration_texture.setWrapS( GL_CLAMP_TO_EDGE );
     m_preintegration_texture.setWrapT( GL_CLAMP_TO_EDGE );
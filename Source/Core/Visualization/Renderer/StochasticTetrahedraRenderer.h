@@ -18,6 +18,7 @@
 #include <kvs/Module>
 #include <kvs/TransferFunction>
 #include <kvs/Texture3D>
+#include <kvs/PreIntegrationTable3D>
 #include <kvs/ProgramObject>
 #include <kvs/VertexBufferObject>
 #include <kvs/IndexBufferObject>
@@ -63,6 +64,7 @@ private:
     size_t m_value; ///< index used for refering the values
     bool m_transfer_function_changed; ///< flag for changin transfer function
     kvs::TransferFunction m_transfer_function; ///< transfer function
+    kvs::PreIntegrationTable3D m_preintegration_table; ///< pre-integration table
     kvs::Texture3D m_preintegration_texture; ///< pre-integration texture
     kvs::Texture2D m_decomposition_texture; ///< texture for the tetrahedral decomposition
     kvs::ProgramObject m_shader_program; ///< shader program
@@ -80,8 +82,11 @@ public:
 
     void setTransferFunction( const kvs::TransferFunction& transfer_function )
     {
+        // The table is re-created only if the transfer function is edited.
+        float lower = 0.0f;
+        float upper = 0.0f;
+        if ( transfer_function.changedRange( m_transfer_function, &lower, &upper ) ) m_transfer_function_changed = true;
         m_transfer_function = transfer_function;
-        m_transfer_function_changed = true;
     }
 
 private:
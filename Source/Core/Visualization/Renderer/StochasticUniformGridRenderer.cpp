@@ -27,11 +27,14 @@
 #include <kvs/Assert>
 #include <kvs/Message>
 #include <kvs/Xorshift128>
+#include <kvs/VolumePyramid>
 
 
 namespace
 {
 
+const size_t DefaultLODNumberOfNodes = 64 * 64 * 64;
+
 /*===========================================================================*/
 /**
  *  @brief  Returns a random number as integer value.
@@ -125,6 +128,21 @@ void StochasticUniformGridRenderer::setSamplingStep( const float step )
     static_cast<Engine&>( engine() ).setSamplingStep( step );
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Sets the max. number of nodes of the volume used for LOD rendering.
+ *  @param  nnodes [in] max. number of nodes (0: full resolution)
+ *
+ *  While the view is changing with the LOD control enabled, the volume is
+ *  sampled from the finest pyramid level within the number of nodes. The
+ *  number must be set before the first rendering.
+ */
+/*===========================================================================*/
+void StochasticUniformGridRenderer::setLODNumberOfNodes( const size_t nnodes )
+{
+    static_cast<Engine&>( engine() ).setLODNumberOfNodes( nnodes );
+}
+
 /*===========================================================================*/
 /**
  *  @brief  Sets a transfer function.
@@ -144,7 +162,8 @@ void StochasticUniformGridRenderer::setTransferFunction( const kvs::TransferFunc
 StochasticUniformGridRenderer::Engine::Engine():
     m_random_index( 0 ),
     m_step( 0.5f ),
-    m_transfer_function_changed( true )
+    m_transfer_function_changed( true ),
+    m_lod_nnodes( ::DefaultLODNumberOfNodes )
 {
 }
 
@@ -159,6 +178,7 @@ void StochasticUniformGridRenderer::Engine::release()
     m_entry_texture.release();
     m_exit_texture.release();
     m_volume_texture.release();
+    m_coarse_volume_texture.release();
     m_entry_exit_framebuffer.release();
     m_bounding_cube_buffer.release();
     m_ray_casting_shader.release();
@@ -218,6 +238,16 @@ void StochasticUniformGridRenderer::Engine::setup( kvs::ObjectBase* object, kvs:
         this->create_transfer_function_texture();
     }
 
+    // The coarse volume data is created when it is used for the first time.
+    if ( isEnabledCoarseRendering() && !m_coarse_volume_texture.isCreated() )
+    {
+        const kvs::StructuredVolumeObject* volume = kvs::StructuredVolumeObject::DownCast( object );
+        if ( m_lod_nnodes > 0 && volume->numberOfNodes() > m_lod_nnodes )
+        {
+            this->create_coarse_volume_texture( volume );
+        }
+    }
+
     const kvs::Mat4 PM = kvs::OpenGL::ProjectionMatrix() * kvs::OpenGL::ModelViewMatrix();
     const kvs::Mat4 PM_inverse = PM.inverted();
     m_ray_casting_shader.bind();
@@ -263,7 +293,13 @@ void StochasticUniformGridRenderer::Engine::setup( kvs::ObjectBase* object, kvs:
 /*===========================================================================*/
 void StochasticUniformGridRenderer::Engine::draw( kvs::ObjectBase* object, kvs::Camera* camera, kvs::Light* light )
 {
-    kvs::Texture::Binder unit0( m_volume_texture, 0 );
+    const bool coarse = isEnabledCoarseRendering() && m_coarse_volume_texture.isCreated();
+    const kvs::StructuredVolumeObject* volume = kvs::StructuredVolumeObject::DownCast( object );
+    const kvs::Vec3ui& r = volume->resolution();
+    const kvs::Vec3 sampling_scale = coarse ? m_coarse_scale : kvs::Vec3( 1.0f, 1.0f, 1.0f );
+    const kvs::Vec3 sampling_resolution = coarse ? m_coarse_resolution : kvs::Vec3( r.x(), r.y(), r.z() );
+
+    kvs::Texture::Binder unit0( coarse ? m_coarse_volume_texture : m_volume_texture, 0 );
     kvs::Texture::Binder unit1( m_exit_texture, 1 );
     kvs::Texture::Binder unit2( m_entry_texture, 2 );
     kvs::Texture::Binder unit3( m_transfer_function_texture, 3 );
@@ -287,6 +323,8 @@ void StochasticUniformGridRenderer::Engine::draw( kvs::ObjectBase* object, kvs::
     m_ray_casting_shader.setUniform( "to_ze2", to_ze2 );
     m_ray_casting_shader.setUniform( "light_position", light_position );
     m_ray_casting_shader.setUniform( "camera_position", camera_position );
+    m_ray_casting_shader.setUniform( "sampling_scale", sampling_scale );
+    m_ray_casting_shader.setUniform( "sampling_resolution", sampling_resolution );
 
     const size_t size = randomTextureSize();
     const int count = repetitionCount() * ::RandomNumber();
@@ -428,6 +466,43 @@ void StochasticUniformGridRenderer::Engine::create_volume_texture( const kvs::St
         return;
     }
 
+    this->load_volume_texture( volume, volume, m_volume_texture );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Create coarse volume texture object used for LOD rendering.
+ *  @param  volume [in] pointer to the structured volume object
+ */
+/*===========================================================================*/
+void StochasticUniformGridRenderer::Engine::create_coarse_volume_texture( const kvs::StructuredVolumeObject* volume )
+{
+    if ( !kvs::VolumePyramid::IsSupported( volume ) ) return;
+
+    const kvs::VolumePyramid pyramid( volume );
+    const size_t level = pyramid.selectLevel( m_lod_nnodes );
+    if ( level > 0 )
+    {
+        const kvs::Vec3ui& r = pyramid.level( level )->resolution();
+        m_coarse_scale = pyramid.scale( level );
+        m_coarse_resolution.set( r.x(), r.y(), r.z() );
+        this->load_volume_texture( volume, pyramid.level( level ), m_coarse_volume_texture );
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Loads the volume data to the 3D texture.
+ *  @param  volume [in] pointer to the structured volume object
+ *  @param  level [in] pointer to the volume (or its pyramid level) to be loaded
+ *  @param  texture [out] 3D texture
+ */
+/*===========================================================================*/
+void StochasticUniformGridRenderer::Engine::load_volume_texture(
+    const kvs::StructuredVolumeObject* volume,
+    const kvs::StructuredVolumeObject* level,
+    kvs::Texture3D& texture )
+{
     GLenum data_format = 0;
     GLenum data_type = 0;
     kvs::AnyValueArray data_value;
@@ -437,28 +512,28 @@ void StochasticUniformGridRenderer::Engine::create_volume_texture( const kvs::St
     {
         data_format = GL_ALPHA8;
         data_type = GL_UNSIGNED_BYTE;
-        data_value = volume->values();
+        data_value = level->values();
         break;
     }
     case kvs::Type::TypeUInt16:
     {
         data_format = GL_ALPHA16;
         data_type = GL_UNSIGNED_SHORT;
-        data_value = volume->values();
+        data_value = level->values();
         break;
     }
     case kvs::Type::TypeInt8:
     {
         data_format = GL_ALPHA8;
         data_type = GL_UNSIGNED_BYTE;
-        data_value = ::SignedToUnsigned<kvs::UInt8,kvs::Int8>( volume );
+        data_value = ::SignedToUnsigned<kvs::UInt8,kvs::Int8>( level );
         break;
     }
     case kvs::Type::TypeInt16:
     {
         data_format = GL_ALPHA16;
         data_type = GL_UNSIGNED_SHORT;
-        data_value = ::SignedToUnsigned<kvs::UInt16,kvs::Int16>( volume );
+        data_value = ::SignedToUnsigned<kvs::UInt16,kvs::Int16>( level );
         break;
     }
     case kvs::Type::TypeUInt32:
@@ -472,7 +547,7 @@ void StochasticUniformGridRenderer::Engine::create_volume_texture( const kvs::St
             min_value = m_transfer_function.colorMap().minValue();
             max_value = m_transfer_function.colorMap().maxValue();
         }
-        data_value = ::NormalizeValues<kvs::UInt32>( volume, min_value, max_value );
+        data_value = ::NormalizeValues<kvs::UInt32>( level, min_value, max_value );
         break;
     }
     case kvs::Type::TypeInt32:
@@ -486,7 +561,7 @@ void StochasticUniformGridRenderer::Engine::create_volume_texture( const kvs::St
             min_value = m_transfer_function.colorMap().minValue();
             max_value = m_transfer_function.colorMap().maxValue();
         }
-        data_value = ::NormalizeValues<kvs::Int32>( volume, min_value, max_value );
+        data_value = ::NormalizeValues<kvs::Int32>( level, min_value, max_value );
         break;
     }
     case kvs::Type::TypeReal32:
@@ -500,7 +575,7 @@ void StochasticUniformGridRenderer::Engine::create_volume_texture( const kvs::St
             min_value = m_transfer_function.colorMap().minValue();
             max_value = m_transfer_function.colorMap().maxValue();
         }
-        data_value = ::NormalizeValues<kvs::Real32>( volume, min_value, max_value );
+        data_value = ::NormalizeValues<kvs::Real32>( level, min_value, max_value );
         break;
     }
     case kvs::Type::TypeReal64:
@@ -514,7 +589,7 @@ void StochasticUniformGridRenderer::Engine::create_volume_texture( const kvs::St
             min_value = m_transfer_function.colorMap().minValue();
             max_value = m_transfer_function.colorMap().maxValue();
         }
-        data_value = ::NormalizeValues<kvs::Real64>( volume, min_value, max_value );
+        data_value = ::NormalizeValues<kvs::Real64>( level, min_value, max_value );
         break;
     }
     default:
@@ -524,16 +599,16 @@ void StochasticUniformGridRenderer::Engine::create_volume_texture( const kvs::St
     }
     }
 
-    const size_t width = volume->resolution().x();
-    const size_t height = volume->resolution().y();
-    const size_t depth = volume->resolution().z();
-    m_volume_texture.setPixelFormat( data_format, GL_ALPHA, data_type );
-    m_volume_texture.setWrapS( GL_CLAMP_TO_BORDER );
-    m_volume_texture.setWrapT( GL_CLAMP_TO_BORDER );
-    m_volume_texture.setWrapR( GL_CLAMP_TO_BORDER );
-    m_volume_texture.setMagFilter( GL_LINEAR );
-    m_volume_texture.setMinFilter( GL_LINEAR );
-    m_volume_texture.create( width, height, depth, data_value.data() );
+    const size_t width = level->resolution().x();
+    const size_t height = level->resolution().y();
+    const size_t depth = level->resolution().z();
+    texture.setPixelFormat( data_format, GL_ALPHA, data_type );
+    texture.setWrapS( GL_CLAMP_TO_BORDER );
+    texture.setWrapT( GL_CLAMP_TO_BORDER );
+    texture.setWrapR( GL_CLAMP_TO_BORDER );
+    texture.setMagFilter( GL_LINEAR );
+    texture.setMinFilter( GL_LINEAR );
+    texture.create( width, height, depth, data_value.data() );
 }
 
 /*===========================================================================*/
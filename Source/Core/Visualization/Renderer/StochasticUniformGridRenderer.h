@@ -50,6 +50,7 @@ public:
     StochasticUniformGridRenderer();
     void setSamplingStep( const float step );
     void setTransferFunction( const kvs::TransferFunction& transfer_function );
+    void setLODNumberOfNodes( const size_t nnodes );
 };
 
 /*===========================================================================*/
@@ -69,6 +70,10 @@ private:
     kvs::Texture2D m_entry_texture; ///< entry point texture
     kvs::Texture2D m_exit_texture; ///< exit point texture
     kvs::Texture3D m_volume_texture; ///< volume data (3D texture)
+    size_t m_lod_nnodes; ///< max. number of nodes of the pyramid level used for LOD rendering
+    kvs::Texture3D m_coarse_volume_texture; ///< coarse volume data for LOD rendering (3D texture)
+    kvs::Vec3 m_coarse_scale; ///< index scale of the coarse volume data
+    kvs::Vec3 m_coarse_resolution; ///< resolution of the coarse volume data
     kvs::FrameBufferObject m_entry_exit_framebuffer; ///< framebuffer object for entry/exit point texture
     kvs::VertexBufferObject m_bounding_cube_buffer; ///< bounding cube (VBO)
     kvs::ProgramObject m_ray_casting_shader; ///< ray casting shader
@@ -84,16 +89,25 @@ public:
     void draw( kvs::ObjectBase* object, kvs::Camera* camera, kvs::Light* light );
 
     void setSamplingStep( const float step ) { m_step = step; }
+    void setLODNumberOfNodes( const size_t nnodes ) { m_lod_nnodes = nnodes; }
     void setTransferFunction( const kvs::TransferFunction& transfer_function )
     {
+        // The texture is re-created only if the transfer function is edited.
+        float lower = 0.0f;
+        float upper = 0.0f;
+        if ( transfer_function.changedRange( m_transfer_function, &lower, &upper ) ) m_transfer_function_changed = true;
         m_transfer_function = transfer_function;
-        m_transfer_function_changed = true;
     }
 
 private:
 
     void create_shader_program( const kvs::StructuredVolumeObject* volume );
     void create_volume_texture( const kvs::StructuredVolumeObject* volume );
+    void create_coarse_volume_texture( const kvs::StructuredVolumeObject* volume );
+    void load_volume_texture(
+        const kvs::StructuredVolumeObject* volume,
+        const kvs::StructuredVolumeObject* level,
+        kvs::Texture3D& texture );
     void create_transfer_function_texture();
     void create_bounding_cube_buffer( const kvs::StructuredVolumeObject* volume );
     void create_framebuffer( const size_t width, const size_t height );
@@ -13,6 +13,7 @@
  */
 /****************************************************************************/
 #include "VolumeRendererBase.h"
+#include <cstring>
 #include <kvs/Camera>
 #include <kvs/Math>
 #include <kvs/OpenGL>
@@ -29,7 +30,8 @@ namespace kvs
 VolumeRendererBase::VolumeRendererBase():
     m_width( 0 ),
     m_height( 0 ),
-    m_shader( NULL )
+    m_shader( NULL ),
+    m_host_frame_buffer( NULL )
 {
     m_depth_buffer.setFormat( GL_DEPTH_COMPONENT );
     m_depth_buffer.setType( GL_FLOAT );
@@ -92,6 +94,57 @@ void VolumeRendererBase::fillColorData( const kvs::UInt8 value )
     m_color_data.fill( value );
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Returns the modelview matrix for the rendering.
+ *  @param  modelview [out] modelview matrix
+ */
+/*===========================================================================*/
+void VolumeRendererBase::getModelViewMatrix( float modelview[16] ) const
+{
+    if ( m_host_frame_buffer )
+    {
+        memcpy( modelview, m_host_frame_buffer->modelViewMatrix(), sizeof( float ) * 16 );
+        return;
+    }
+
+    kvs::OpenGL::GetModelViewMatrix( static_cast<GLfloat*>( modelview ) );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the projection matrix for the rendering.
+ *  @param  projection [out] projection matrix
+ */
+/*===========================================================================*/
+void VolumeRendererBase::getProjectionMatrix( float projection[16] ) const
+{
+    if ( m_host_frame_buffer )
+    {
+        memcpy( projection, m_host_frame_buffer->projectionMatrix(), sizeof( float ) * 16 );
+        return;
+    }
+
+    kvs::OpenGL::GetProjectionMatrix( static_cast<GLfloat*>( projection ) );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Returns the viewport for the rendering.
+ *  @param  viewport [out] viewport
+ */
+/*===========================================================================*/
+void VolumeRendererBase::getViewport( int viewport[4] ) const
+{
+    if ( m_host_frame_buffer )
+    {
+        m_host_frame_buffer->getViewport( viewport );
+        return;
+    }
+
+    kvs::OpenGL::GetViewport( static_cast<GLint*>( viewport ) );
+}
+
 /*===========================================================================*/
 /**
  *  @brief  Reads color and depth buffers.
@@ -99,6 +152,12 @@ void VolumeRendererBase::fillColorData( const kvs::UInt8 value )
 /*===========================================================================*/
 void VolumeRendererBase::readImage()
 {
+    if ( m_host_frame_buffer )
+    {
+        m_host_frame_buffer->readPixels( m_color_data.data(), m_depth_data.data() );
+        return;
+    }
+
     m_depth_buffer.readPixels( 0, 0, m_width, m_height, m_depth_data.data() );
     m_color_buffer.readPixels( 0, 0, m_width, m_height, m_color_data.data() );
 }
@@ -110,6 +169,12 @@ void VolumeRendererBase::readImage()
 /*==========================================================================*/
 void VolumeRendererBase::drawImage()
 {
+    if ( m_host_frame_buffer )
+    {
+        m_host_frame_buffer->drawPixels( m_color_data.data(), m_depth_data.data() );
+        return;
+    }
+
     GLint viewport[4];
     kvs::OpenGL::GetViewport( viewport );
 
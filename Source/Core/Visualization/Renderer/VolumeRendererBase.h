@@ -21,6 +21,7 @@
 #include <kvs/FrameBuffer>
 #include <kvs/ValueArray>
 #include <kvs/Shader>
+#include <kvs/HostFrameBuffer>
 
 
 namespace kvs
@@ -45,6 +46,7 @@ private:
     kvs::FrameBuffer m_color_buffer; ///< color (RGBA) buffer
     kvs::TransferFunction m_tfunc; ///< transfer function
     kvs::Shader::ShadingModel* m_shader; ///< shading method
+    kvs::HostFrameBuffer* m_host_frame_buffer; ///< frame buffer in the host memory (NULL: OpenGL)
 
 public:
 
@@ -62,6 +64,9 @@ public:
     void setShader( const ShadingType shader );
     void setTransferFunction( const kvs::TransferFunction& tfunc ) { m_tfunc = tfunc; }
     const kvs::TransferFunction& transferFunction() const { return m_tfunc; }
+    void attachHostFrameBuffer( kvs::HostFrameBuffer* frame_buffer ) { m_host_frame_buffer = frame_buffer; }
+    kvs::HostFrameBuffer* hostFrameBuffer() const { return m_host_frame_buffer; }
+    bool isHeadless() const { return m_host_frame_buffer != NULL; }
 
 protected:
 
@@ -74,6 +79,9 @@ protected:
     void allocateColorData( const size_t size );
     void fillDepthData( const kvs::Real32 value );
     void fillColorData( const kvs::UInt8 value );
+    void getModelViewMatrix( float modelview[16] ) const;
+    void getProjectionMatrix( float projection[16] ) const;
+    void getViewport( int viewport[4] ) const;
     void readImage();
     void drawImage();
 };
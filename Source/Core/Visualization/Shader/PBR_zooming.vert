@@ -19,6 +19,21 @@ uniform sampler2D random_texture;
 uniform float random_texture_size_inv;
 attribute vec2 random_index;
 
+#if defined( ENABLE_QUANTIZED_COORD )
+uniform vec3 coord_offset; // coordinate of the quantized value 0
+uniform vec3 coord_scale; // coordinate step of the quantized value
+#endif
+
+#if defined( ENABLE_ENCODED_NORMAL )
+attribute vec2 encoded_normal; // octahedral-encoded normal vector in [0,1]
+#endif
+
+#if defined( ENABLE_COLOR_INDEX )
+uniform sampler1D palette_texture;
+uniform float palette_size_inv;
+attribute float color_index;
+#endif
+
 const float CIRCLE_THRESHOLD = 3.0;
 const float CIRCLE_SCALE = 0.564189583547756; // 1.0 / sqrt(PI)
 
@@ -94,6 +109,42 @@ float zooming( in vec4 p )
     return s;
 }
 
+#if defined( ENABLE_QUANTIZED_COORD )
+/*===========================================================================*/
+/**
+ *  @brief  Returns the vertex position from the quantized coordinate.
+ *  @param  q [in] quantized coordinate passed as signed short
+ *  @return vertex position
+ */
+/*===========================================================================*/
+vec4 dequantize( in vec4 q )
+{
+    vec3 u = q.xyz + 65536.0 * vec3( lessThan( q.xyz, vec3( 0.0 ) ) );
+    return vec4( coord_offset + u * coord_scale, 1.0 );
+}
+#endif
+
+#if defined( ENABLE_ENCODED_NORMAL )
+/*===========================================================================*/
+/**
+ *  @brief  Returns the normal vector from the octahedral-encoded normal.
+ *  @param  e [in] encoded normal vector in [0,1]
+ *  @return normal vector
+ */
+/*===========================================================================*/
+vec3 decode_normal( in vec2 e )
+{
+    vec2 f = e * 2.0 - 1.0;
+    vec3 n = vec3( f, 1.0 - abs( f.x ) - abs( f.y ) );
+    if ( n.z < 0.0 )
+    {
+        vec2 s = vec2( f.x >= 0.0 ? 1.0 : -1.0, f.y >= 0.0 ? 1.0 : -1.0 );
+        n.xy = ( 1.0 - abs( f.yx ) ) * s;
+    }
+    return normalize( n );
+}
+#endif
+
 /*===========================================================================*/
 /**
  *  @brief  Calculates a size of the particle in pixel.
@@ -101,8 +152,18 @@ float zooming( in vec4 p )
 /*===========================================================================*/
 void main()
 {
+#if defined( ENABLE_QUANTIZED_COORD )
+    vec4 vertex = dequantize( gl_Vertex );
+#else
+    vec4 vertex = gl_Vertex;
+#endif
+
+#if defined( ENABLE_COLOR_INDEX )
+    gl_FrontColor = vec4( texture1D( palette_texture, ( color_index + 0.5 ) * palette_size_inv ).rgb, 1.0 );
+#else
     gl_FrontColor = gl_Color;
-    gl_Position = ProjectionMatrix * ModelViewMatrix * gl_Vertex;
+#endif
+    gl_Position = ProjectionMatrix * ModelViewMatrix * vertex;
 
 #if defined( ENABLE_PARTICLE_ZOOMING )
     gl_PointSize = zooming( gl_Position );
@@ -110,6 +171,10 @@ void main()
     gl_PointSize = 1.0;
 #endif
 
+#if defined( ENABLE_ENCODED_NORMAL )
+    normal = decode_normal( encoded_normal );
+#else
     normal = gl_Normal.xyz;
-    position = vec3( gl_ModelViewMatrix * gl_Vertex );
+#endif
+    position = vec3( gl_ModelViewMatrix * vertex );
 }
@@ -31,6 +31,8 @@ uniform vec3 light_position; // light position in the object coordinate
 uniform vec3 camera_position; // camera position in the object coordinate
 uniform VolumeParameter volume; // volume parameter
 uniform sampler3D volume_data; // volume data
+uniform vec3 sampling_scale; // scale from the volume index to the index of the sampled data
+uniform vec3 sampling_resolution; // resolution of the sampled data
 uniform ShadingParameter shading; // shading parameter
 uniform TransferFunctionParameter transfer_function; // transfer function
 uniform sampler1D transfer_function_data; // 1D transfer function data
@@ -170,7 +172,10 @@ void main()
         //            = vec3( P + vec3(0.5) ) / R;
         //
         // where, I: volume index, P: sampling point, R: volume resolution.
-        vec3 volume_index = vec3( ( position + vec3(0.5) ) / volume.resolution );
+        //
+        // During the LOD rendering, the coarse data is sampled at the
+        // point P scaled by sampling_scale.
+        vec3 volume_index = vec3( ( position * sampling_scale + vec3(0.5) ) / sampling_resolution );
         vec4 value = LookupTexture3D( volume_data, volume_index );
         float scalar = mix( volume.min_range, volume.max_range, value.w );
 
@@ -186,7 +191,7 @@ void main()
         if ( R <= accum_alpha )
         {
             // Get the normal vector in object coordinate.
-            vec3 offset_index = vec3( volume.resolution_reciprocal );
+            vec3 offset_index = vec3( 1.0 ) / sampling_resolution;
             vec3 normal = VolumeGradient( volume_data, volume_index, offset_index );
 
             // Light vector (L) and normal vector (N) in camera coordinate.
@@ -0,0 +1,296 @@
+/*****************************************************************************/
+/**
+ *  @file   HeadlessScene.cpp
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#include "HeadlessScene.h"
+#include <kvs/Camera>
+#include <kvs/Light>
+#include <kvs/ObjectManager>
+#include <kvs/ObjectBase>
+#include <kvs/Xform>
+#include <kvs/VolumeObjectBase>
+#include <kvs/VolumeRendererBase>
+#include <kvs/Math>
+#include <kvs/Message>
+#include <kvs/Thread>
+
+
+namespace
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Painter class that renders a range of the views with a scene.
+ */
+/*===========================================================================*/
+class Painter : public kvs::Thread
+{
+private:
+
+    kvs::HeadlessScene* m_scene; ///< scene used by the thread
+    const std::vector<kvs::Camera>* m_cameras; ///< cameras of the views
+    std::vector<kvs::ColorImage>* m_images; ///< rendering images
+    size_t m_begin; ///< first view
+    size_t m_end; ///< last view + 1
+
+public:
+
+    Painter():
+        m_scene( NULL ),
+        m_cameras( NULL ),
+        m_images( NULL ),
+        m_begin( 0 ),
+        m_end( 0 ) {}
+
+    void init(
+        kvs::HeadlessScene* scene,
+        const std::vector<kvs::Camera>* cameras,
+        std::vector<kvs::ColorImage>* images,
+        const size_t begin,
+        const size_t end )
+    {
+        m_scene = scene;
+        m_cameras = cameras;
+        m_images = images;
+        m_begin = begin;
+        m_end = end;
+    }
+
+    void run()
+    {
+        for ( size_t i = m_begin; i < m_end; i++ )
+        {
+            (*m_images)[i] = m_scene->render( (*m_cameras)[i] );
+        }
+    }
+};
+
+} // end of namespace
+
+
+namespace kvs
+{
+
+/*===========================================================================*/
+/**
+ *  @brief  Renders the views in parallel.
+ *  @param  scenes [in] scenes, each of which is used by a thread
+ *  @param  cameras [in] cameras of the views
+ *  @param  images [out] rendering image of each view
+ *  @return true if the views are rendered successfully
+ *
+ *  The scenes must have the same objects with the renderers of their own,
+ *  since a renderer keeps the intermediate buffers of the view.
+ */
+/*===========================================================================*/
+bool HeadlessScene::Render(
+    const std::vector<kvs::HeadlessScene*>& scenes,
+    const std::vector<kvs::Camera>& cameras,
+    std::vector<kvs::ColorImage>* images )
+{
+    if ( scenes.empty() )
+    {
+        kvsMessageError("No scene is specified.");
+        return false;
+    }
+
+    images->resize( cameras.size() );
+    if ( cameras.empty() ) return true;
+
+    const size_t nthreads = kvs::Math::Min( scenes.size(), cameras.size() );
+    std::vector< ::Painter > painters( nthreads );
+    for ( size_t i = 0; i < nthreads; i++ )
+    {
+        const size_t begin = cameras.size() * i / nthreads;
+        const size_t end = cameras.size() * ( i + 1 ) / nthreads;
+        painters[i].init( scenes[i], &cameras, images, begin, end );
+    }
+    for ( size_t i = 1; i < nthreads; i++ ) { if ( !painters[i].start() ) { painters[i].run(); } }
+    painters[0].run();
+    for ( size_t i = 1; i < nthreads; i++ ) { if ( painters[i].isRunning() ) { painters[i].wait(); } }
+
+    return true;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Constructs a new HeadlessScene class.
+ *  @param  width [in] width of the rendering image
+ *  @param  height [in] height of the rendering image
+ */
+/*===========================================================================*/
+HeadlessScene::HeadlessScene( const size_t width, const size_t height ):
+    m_background_color( 212, 221, 229 )
+{
+    m_camera = new kvs::Camera();
+    m_light = new kvs::Light();
+    m_object_manager = new kvs::ObjectManager();
+    this->setWindowSize( width, height );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Destroys the HeadlessScene class.
+ */
+/*===========================================================================*/
+HeadlessScene::~HeadlessScene()
+{
+    // The shared objects may have been deleted by the other scene, so that
+    // they are released from the object manager without any access.
+    for ( size_t i = 0; i < m_entries.size(); i++ )
+    {
+        if ( m_entries[i].delete_object ) delete m_object_manager->object( m_entries[i].object_id );
+        delete m_entries[i].renderer;
+    }
+    m_object_manager->erase( false );
+
+    delete m_camera;
+    delete m_light;
+    delete m_object_manager;
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Registers an object with a renderer.
+ *  @param  object [in] pointer to the object (deleted by the scene)
+ *  @param  renderer [in] pointer to the renderer (deleted by the scene)
+ *  @return object ID
+ */
+/*===========================================================================*/
+int HeadlessScene::registerObject( kvs::ObjectBase* object, kvs::VolumeRendererBase* renderer )
+{
+    return this->insert_object( object, renderer, false );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Registers an object, which is registered to another scene, with a renderer.
+ *  @param  object [in] pointer to the object (not deleted by the scene)
+ *  @param  renderer [in] pointer to the renderer (deleted by the scene)
+ *  @return object ID
+ *
+ *  The object xform, which has been normalized by the other scene, is kept
+ *  as it is. The object must not be deleted until the scene is rendered.
+ */
+/*===========================================================================*/
+int HeadlessScene::shareObject( kvs::ObjectBase* object, kvs::VolumeRendererBase* renderer )
+{
+    return this->insert_object( object, renderer, true );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Sets the size of the rendering image.
+ *  @param  width [in] width of the rendering image
+ *  @param  height [in] height of the rendering image
+ */
+/*===========================================================================*/
+void HeadlessScene::setWindowSize( const size_t width, const size_t height )
+{
+    m_camera->setWindowSize( width, height );
+    m_frame_buffer.create( width, height );
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Renders the registered objects into the frame buffer.
+ */
+/*===========================================================================*/
+void HeadlessScene::paint()
+{
+    m_frame_buffer.create( m_camera->windowWidth(), m_camera->windowHeight() );
+    m_frame_buffer.clear( m_background_color );
+
+    for ( size_t i = 0; i < m_entries.size(); i++ )
+    {
+        kvs::ObjectBase* object = m_object_manager->object( m_entries[i].object_id );
+        if ( object->isShown() )
+        {
+            m_frame_buffer.setMatrices( m_camera, object );
+            m_entries[i].renderer->attachHostFrameBuffer( &m_frame_buffer );
+            m_entries[i].renderer->exec( object, m_camera, m_light );
+        }
+    }
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Renders the registered objects with the given camera.
+ *  @param  camera [in] camera
+ *  @return rendering image
+ */
+/*===========================================================================*/
+kvs::ColorImage HeadlessScene::render( const kvs::Camera& camera )
+{
+    *m_camera = camera;
+    this->paint();
+    return this->snapshot();
+}
+
+/*===========================================================================*/
+/**
+ *  @brief  Inserts an object with a renderer.
+ *  @param  object [in] pointer to the object
+ *  @param  renderer [in] pointer to the renderer
+ *  @param  shared [in] if true, the object is registered to another scene
+ *  @return object ID
+ */
+/*===========================================================================*/
+int HeadlessScene::insert_object(
+    kvs::ObjectBase* object,
+    kvs::VolumeRendererBase* renderer,
+    const bool shared )
+{
+    if ( !renderer )
+    {
+        kvsMessageError("The renderer is not specified.");
+        return -1;
+    }
+
+    // The min/max values are calculated here rather than in the renderer,
+    // so that the object is not modified while rendering.
+    if ( !object->hasMinMaxObjectCoords() ) object->updateMinMaxCoords();
+    if ( object->objectType() == kvs::ObjectBase::Volume )
+    {
+        const kvs::VolumeObjectBase* volume = static_cast<const kvs::VolumeObjectBase*>( object );
+        if ( !volume->hasMinMaxValues() ) volume->updateMinMaxValues();
+    }
+
+    Entry entry;
+    entry.object_id = -1;
+    entry.renderer = renderer;
+    entry.delete_object = !shared;
+
+    // The object manager applies the normalization to the xforms of all the
+    // registered objects, but the xforms of the shared objects have been
+    // normalized by the other scene.
+    std::vector<kvs::ObjectBase*> objects;
+    std::vector<kvs::Xform> xforms;
+    if ( shared ) { objects.push_back( object ); xforms.push_back( object->xform() ); }
+    for ( size_t i = 0; i < m_entries.size(); i++ )
+    {
+        if ( m_entries[i].delete_object ) continue;
+        kvs::ObjectBase* shared_object = m_object_manager->object( m_entries[i].object_id );
+        objects.push_back( shared_object );
+        xforms.push_back( shared_object->xform() );
+    }
+
+    entry.object_id = m_object_manager->insert( object );
+    m_entries.push_back( entry );
+    for ( size_t i = 0; i < objects.size(); i++ ) { objects[i]->setXform( xforms[i] ); }
+
+    renderer->attachHostFrameBuffer( &m_frame_buffer );
+
+    return entry.object_id;
+}
+
+} // end of namespace kvs
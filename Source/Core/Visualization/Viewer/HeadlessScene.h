@@ -0,0 +1,105 @@
+/*****************************************************************************/
+/**
+ *  @file   HeadlessScene.h
+ */
+/*----------------------------------------------------------------------------
+ *
+ *  Copyright (c) Visualization Laboratory, Kyoto University.
+ *  All rights reserved.
+ *  See http://www.viz.media.kyoto-u.ac.jp/kvs/copyright/ for details.
+ *
+ *  $Id$
+ */
+/*****************************************************************************/
+#ifndef KVS__HEADLESS_SCENE_H_INCLUDE
+#define KVS__HEADLESS_SCENE_H_INCLUDE
+
+#include <vector>
+#include <kvs/RGBColor>
+#include <kvs/RGBAColor>
+#include <kvs/ColorImage>
+#include <kvs/HostFrameBuffer>
+#include <kvs/Noncopyable>
+
+
+namespace kvs
+{
+
+class Camera;
+class Light;
+class ObjectManager;
+class ObjectBase;
+class VolumeRendererBase;
+
+/*===========================================================================*/
+/**
+ *  @brief  Scene class for the rendering without OpenGL.
+ *
+ *  The objects are rendered by the CPU volume renderers (e.g.
+ *  kvs::RayCastingRenderer and kvs::ParticleBasedRenderer) into a frame
+ *  buffer in the host memory, so that no window or OpenGL context is
+ *  required. The matrices are calculated from the camera and the object
+ *  xforms in the same way as kvs::Scene.
+ *
+ *  A scene renders a single view at a time. Many views (e.g. the frames of
+ *  a movie) are rendered in parallel by Render() with a scene per thread;
+ *  the objects registered to a scene can be shared by the other scenes with
+ *  shareObject(), since the objects are only read while rendering.
+ */
+/*===========================================================================*/
+class HeadlessScene : private kvs::Noncopyable
+{
+private:
+
+    struct Entry
+    {
+        int object_id; ///< object ID in the object manager
+        kvs::VolumeRendererBase* renderer; ///< renderer (owned by the scene)
+        bool delete_object; ///< flag for deleting the object
+    };
+
+    kvs::Camera* m_camera; ///< camera
+    kvs::Light* m_light; ///< light
+    kvs::ObjectManager* m_object_manager; ///< object manager
+    std::vector<Entry> m_entries; ///< registered objects and renderers
+    kvs::RGBAColor m_background_color; ///< background color
+    kvs::HostFrameBuffer m_frame_buffer; ///< frame buffer
+
+public:
+
+    static bool Render(
+        const std::vector<kvs::HeadlessScene*>& scenes,
+        const std::vector<kvs::Camera>& cameras,
+        std::vector<kvs::ColorImage>* images );
+
+public:
+
+    HeadlessScene( const size_t width = 512, const size_t height = 512 );
+    ~HeadlessScene();
+
+    int registerObject( kvs::ObjectBase* object, kvs::VolumeRendererBase* renderer );
+    int shareObject( kvs::ObjectBase* object, kvs::VolumeRendererBase* renderer );
+
+    kvs::Camera* camera() { return m_camera; }
+    kvs::Light* light() { return m_light; }
+    kvs::ObjectManager* objectManager() { return m_object_manager; }
+    const kvs::HostFrameBuffer& frameBuffer() const { return m_frame_buffer; }
+    const kvs::RGBColor& backgroundColor() const { return m_background_color; }
+    size_t numberOfObjects() const { return m_entries.size(); }
+
+    void setBackgroundColor( const kvs::RGBColor& color ) { m_background_color = kvs::RGBAColor( color ); }
+    void setBackgroundColor( const kvs::RGBAColor& color ) { m_background_color = color; }
+    void setWindowSize( const size_t width, const size_t height );
+
+    void paint();
+    kvs::ColorImage snapshot() const { return m_frame_buffer.colorImage(); }
+    kvs::ColorImage render( const kvs::Camera& camera );
+
+private:
+
+    int insert_object( kvs::ObjectBase* object, kvs::VolumeRendererBase* renderer, const bool shared );
+};
+
+} // end of namespace kvs
+
+#endif // KVS__HEADLESS_SCENE_H_INCLUDE
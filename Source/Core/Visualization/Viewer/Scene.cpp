@@ -24,6 +24,7 @@
 #include <kvs/ObjectBase>
 #include <kvs/RendererBase>
 #include <kvs/VisualizationPipeline>
+#include <kvs/PipelineTask>
 #include <kvs/Coordinate>
 
 
@@ -176,6 +177,30 @@ void Scene::replaceObject( std::string object_name, kvs::ObjectBase* object, boo
     m_object_manager->change( object_name, object, delete_object );
 }
 
+/*===========================================================================*/
+/**
+ *  @brief  Replaces the object specified by the given object ID with the latest result of the task.
+ *  @param  object_id [in] object ID
+ *  @param  task [in] pointer to the pipeline task
+ *  @param  delete_object [in] if true, the registered object will be deleted
+ *  @return true, if the object is replaced
+ *
+ *  This method is called from the event loop (e.g. the timer event) to show
+ *  the result of the task executed in the background, so that the coarse
+ *  result is replaced with the finer one when it arrives. The renderer which
+ *  keeps the data of the object (e.g. kvs::StochasticRendererBase) has to be
+ *  notified of the change by the caller.
+ */
+/*===========================================================================*/
+bool Scene::replaceObject( int object_id, kvs::PipelineTask* task, bool delete_object )
+{
+    kvs::ObjectBase* object = task->takeResult();
+    if ( !object ) return false;
+
+    this->replaceObject( object_id, object, delete_object );
+    return true;
+}
+
 /*===========================================================================*/
 /**
  *  @brief  Replaces the renderer specified by the given renderer ID with the input renderer.
@@ -30,6 +30,7 @@ class RendererManager;
 class IDManager;
 class ObjectBase;
 class RendererBase;
+class PipelineTask;
 
 /*===========================================================================*/
 /**
@@ -71,6 +72,7 @@ public:
     void removeObject( std::string object_name, bool delete_object = true, bool delete_renderer = true );
     void replaceObject( int object_id, kvs::ObjectBase* object, bool delete_object = true );
     void replaceObject( std::string object_name, kvs::ObjectBase* object, bool delete_object = true );
+    bool replaceObject( int object_id, kvs::PipelineTask* task, bool delete_object = true );
     void replaceRenderer( int renderer_id, kvs::RendererBase* renderer, bool delete_renderer = true );
     void replaceRenderer( std::string renderer_name, kvs::RendererBase* renderer, bool delete_renderer = true );
 